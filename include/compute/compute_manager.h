@@ -11,6 +11,18 @@
 #include <array>
 #include <bitset>
 #include <future>
+#include <queue>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <type_traits>
+#include <exception>
+
+#include "core/optimization/simd_ops.h"
+#include "core/drivers/conv_ops.h"
+#include "core/drivers/gemm_ops.h"
+#include "core/drivers/quant_ops.h"
+#include "compute/vector_expr.h"
 
 namespace compute {
 
@@ -18,6 +30,10 @@ namespace compute {
 constexpr size_t MAX_THREADS = 256;
 constexpr size_t DEFAULT_BATCH_SIZE = 1024;
 constexpr size_t SIMD_WIDTH = 16;
+constexpr size_t CACHE_LINE_SIZE = 64;
+// Число кусков на участника при автоматическом выборе гранулы: запас для
+// выравнивания нагрузки, когда куски обрабатываются с разной скоростью
+constexpr size_t CHUNKS_PER_THREAD = 8;
 
 // Типы операций
 enum class OperationType {
@@ -36,15 +52,30 @@ enum class OperationType {
     Custom
 };
 
-// Структура для статистики вычислений
+// Снимок статистики вычислений (см. ComputeManager::getStats)
 struct ComputeStats {
-    std::atomic<uint64_t> totalOperations{0};
-    std::atomic<uint64_t> simdOperations{0};
-    std::atomic<uint64_t> scalarOperations{0};
-    std::atomic<uint64_t> batchOperations{0};
-    std::atomic<uint64_t> parallelOperations{0};
+    uint64_t totalOperations = 0;
+    uint64_t simdOperations = 0;
+    uint64_t scalarOperations = 0;
+    uint64_t batchOperations = 0;
+    uint64_t parallelOperations = 0;
     std::chrono::steady_clock::time_point startTime;
-    std::array<std::atomic<uint64_t>, MAX_THREADS> threadUtilization{};
+    // Операции по слотам потоков. Слот выдаётся потоку при первой операции и
+    // освобождается при его завершении; последний слот общий для потоков сверх
+    // MAX_THREADS - 1
+    std::array<uint64_t, MAX_THREADS> threadUtilization{};
+};
+
+// Флаг отмены параллельного алгоритма. Проверяется перед каждым куском:
+// уже начатые куски дорабатываются, новые не берутся.
+class CancellationToken {
+public:
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    void reset() { cancelled_.store(false, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled_{false};
 };
 
 // Класс для управления вычислениями
@@ -78,26 +109,98 @@ public:
     template<typename T>
     T dotProduct(const T* vec1, const T* vec2, size_t count);
     
+    // dst[rows1 x cols2] = op(mat1)[rows1 x cols1] * op(mat2)[cols1 x cols2];
+    // при transpose* соответствующая матрица хранится транспонированной
     template<typename T>
     void matrixMultiply(T* dst, const T* mat1, const T* mat2, 
-                       size_t rows1, size_t cols1, size_t cols2);
+                       size_t rows1, size_t cols1, size_t cols2,
+                       bool transpose1 = false, bool transpose2 = false);
     
+    // dst[i] = sum_j src[i + j] * kernel[j], i < srcSize - kernelSize + 1;
+    // для float — через convolutionBatch
     template<typename T>
     void convolution(T* dst, const T* src, const T* kernel,
                     size_t srcSize, size_t kernelSize);
+
+    // Свёртки float (core/drivers/conv_ops.h): прямая, Винограда для 3x3 или
+    // через БПФ — по оценке стоимости либо явно (CORE_CONV_*). Выход без выхода
+    // за границы, как у convolution. false — неверные размеры или нехватка памяти.
+    bool convolution2D(float* dst, const float* src, size_t width, size_t height,
+                       const float* kernel, size_t kernelWidth, size_t kernelHeight,
+                       int algorithm = CORE_CONV_AUTO);
+
+    // count сигналов длины srcSize подряд, общее ядро; выходы тоже подряд
+    bool convolutionBatch(float* dst, const float* src, size_t count, size_t srcSize,
+                          const float* kernel, size_t kernelSize, int algorithm = CORE_CONV_AUTO);
+
+    // dst[o] = sum_i convolution2D(src[i], kernels[o][i]); плоскости подряд,
+    // ядра outChannels x inChannels x kernelHeight x kernelWidth
+    bool convolutionMultiChannel(float* dst, const float* src, size_t inChannels, size_t outChannels,
+                                 size_t width, size_t height, const float* kernels,
+                                 size_t kernelWidth, size_t kernelHeight, int algorithm = CORE_CONV_AUTO);
+
+    // Квантованные ядра (core/drivers/quant_ops.h): int8 накапливается в int32,
+    // bfloat16 — во float. Перегрузки выбираются вместо шаблонов выше.
+    int32_t dotProduct(const int8_t* vec1, const int8_t* vec2, size_t count);
+    float dotProduct(const core_bf16_t* vec1, const core_bf16_t* vec2, size_t count);
+    void convolution(int32_t* dst, const int8_t* src, const int8_t* kernel,
+                     size_t srcSize, size_t kernelSize);
+    void convolution(float* dst, const core_bf16_t* src, const core_bf16_t* kernel,
+                     size_t srcSize, size_t kernelSize);
+
+    // Симметричное квантование float <-> int8 с шагом scale и преобразования bfloat16
+    void quantize(int8_t* dst, const float* src, size_t count, float scale);
+    void dequantize(float* dst, const int8_t* src, size_t count, float scale);
+    void convert(core_bf16_t* dst, const float* src, size_t count);
+    void convert(float* dst, const core_bf16_t* src, size_t count);
+
+    // Ленивые выражения (compute/vector_expr.h): вся цепочка операций
+    // вычисляется за один проход по памяти, куски делятся между потоками пула.
+    //   manager.sum(vec(a, n) * vec(b, n) + vec(c, n))
+    // dst может совпадать с листом выражения, но не перекрываться со сдвигом.
+    template<typename T, typename E>
+    void evaluate(T* dst, const expr::Expr<E>& e);
+
+    template<typename E>
+    typename E::value_type sum(const expr::Expr<E>& e);
     
-    // Параллельные операции
+    // Параллельные операции. Диапазон [begin, end) делится на куски по grain
+    // индексов (0 — автоматически: не меньше batchSize и около CHUNKS_PER_THREAD
+    // кусков на поток), куски разбираются потоками пула и вызывающим потоком.
+    // Вложенные вызовы из тела безопасны: вызывающий сам выполняет свои куски и
+    // не ждёт свободных воркеров. Исключение из тела отменяет оставшиеся куски
+    // и пробрасывается в вызывающий поток.
+
+    // body(chunkBegin, chunkEnd); false, если вызов был отменён через cancel
+    template<typename F>
+    bool parallelForRange(size_t begin, size_t end, F&& body, size_t grain = 0,
+                          const CancellationToken* cancel = nullptr);
+
+    // partial = body(chunkBegin, chunkEnd, partial) внутри потока, затем частичные
+    // результаты потоков сворачиваются combine, начиная с identity. Какие куски
+    // попадут в один частичный результат, заранее неизвестно, поэтому combine
+    // должен быть ассоциативным и коммутативным, а identity — нейтральным.
+    // При отмене возвращается свёртка только обработанных кусков.
+    template<typename T, typename Body, typename Combine>
+    T parallelReduceRange(size_t begin, size_t end, T identity, Body&& body, Combine&& combine,
+                          size_t grain = 0, const CancellationToken* cancel = nullptr);
+
+    // func(data[i]) для каждого элемента
     template<typename T, typename F>
     void parallelFor(T* data, size_t count, F&& func);
-    
+
+    // Свёртка init и всех элементов через func (ассоциативную и коммутативную),
+    // T() — нейтральный элемент
     template<typename T, typename F>
-    void parallelReduce(T* data, size_t count, F&& func, T init);
+    T parallelReduce(const T* data, size_t count, F&& func, T init);
     
     // Асинхронные операции
     template<typename T, typename F>
     std::future<void> asyncCompute(T* data, size_t count, F&& func);
     
-    // Получение статистики
+    // Получение статистики. Счётчики ведутся отдельно в каждом потоке и
+    // суммируются только здесь; со сборкой -DCOMPUTE_DISABLE_STATS они не
+    // ведутся вовсе и getStats возвращает нули.
     ComputeStats getStats() const;
     void resetStats();
     
@@ -128,6 +231,52 @@ private:
     void cleanupThreadPool();
     void workerThread();
     void updateStats(OperationType type, size_t count, bool simd);
+
+    // Счётчики одного слота потока на отдельной кэш-линии. Пишет только владелец
+    // слота — обычными load/store без lock-префикса; общий слот обновляется
+    // атомарным сложением.
+    struct alignas(CACHE_LINE_SIZE) StatsShard {
+        std::atomic<uint64_t> totalOperations{0};
+        std::atomic<uint64_t> simdOperations{0};
+        std::atomic<uint64_t> scalarOperations{0};
+        std::atomic<uint64_t> parallelOperations{0};
+    };
+    static constexpr size_t SHARED_STATS_SLOT = MAX_THREADS - 1;
+
+    // Слот текущего потока: занимается при первом вызове, освобождается при выходе потока
+    struct StatsSlot {
+        StatsSlot();
+        ~StatsSlot();
+        size_t index;
+    };
+    static size_t statsSlot();
+    static void bumpCounter(std::atomic<uint64_t>& counter, uint64_t delta, bool shared);
+    ComputeStats collectStats() const;
+
+    // Выполняет task(i) для i из [0, numTasks) на пуле; вызывающий поток участвует
+    // в обработке, поэтому вызов не блокируется, даже если все воркеры заняты
+    void runParallel(size_t numTasks, const std::function<void(size_t)>& task);
+    static void executorParallelFor(void* ctx, size_t numTasks,
+                                    void (*task)(void* arg, size_t index), void* arg);
+
+    // Разбиение диапазона: куски по grain индексов, numSlots участников
+    struct ChunkPlan {
+        size_t grain;
+        size_t numChunks;
+        size_t numSlots;
+    };
+    ChunkPlan planChunks(size_t count, size_t grain) const;
+
+    // Раздаёт куски плана участникам: body(slot, chunkBegin, chunkEnd), где slot
+    // из [0, numSlots) закреплён за одним потоком на время вызова
+    bool runChunks(size_t begin, size_t end, const ChunkPlan& plan, const CancellationToken* cancel,
+                   const std::function<void(size_t slot, size_t chunkBegin, size_t chunkEnd)>& body);
+
+    // Частичный результат потока на отдельной кэш-линии
+    template<typename T>
+    struct alignas(CACHE_LINE_SIZE) PaddedPartial {
+        T value;
+    };
     
     // SIMD оптимизации
     template<typename T>
@@ -146,10 +295,38 @@ private:
     std::mutex mutex_;
     std::atomic<size_t> threadCount_{std::thread::hardware_concurrency()};
     std::atomic<size_t> batchSize_{DEFAULT_BATCH_SIZE};
-    ComputeStats stats_;
+    std::array<StatsShard, MAX_THREADS> statsShards_;
+    mutable std::mutex statsMutex_;
+    ComputeStats statsBaseline_;
     bool initialized_{false};
 };
 
+inline size_t ComputeManager::statsSlot() {
+    thread_local const StatsSlot slot;
+    return slot.index;
+}
+
+inline void ComputeManager::bumpCounter(std::atomic<uint64_t>& counter, uint64_t delta, bool shared) {
+    if (shared) {
+        counter.fetch_add(delta, std::memory_order_relaxed);
+    } else {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+}
+
+inline void ComputeManager::updateStats(OperationType, size_t count, bool simd) {
+#ifndef COMPUTE_DISABLE_STATS
+    const size_t slot = statsSlot();
+    StatsShard& shard = statsShards_[slot];
+    const bool shared = slot == SHARED_STATS_SLOT;
+    bumpCounter(shard.totalOperations, count, shared);
+    bumpCounter(simd ? shard.simdOperations : shard.scalarOperations, count, shared);
+#else
+    (void)count;
+    (void)simd;
+#endif
+}
+
 // Реализация шаблонных методов
 template<typename T>
 void ComputeManager::add(T* dst, const T* src1, const T* src2, size_t count) {
@@ -169,11 +346,10 @@ template<typename T>
 void ComputeManager::subtract(T* dst, const T* src1, const T* src2, size_t count) {
     if (!dst || !src1 || !src2 || count == 0) return;
 
-    if (count >= SIMD_WIDTH && std::is_arithmetic<T>::value) {
-        // TODO: Реализовать SIMD вычитание
-        for (size_t i = 0; i < count; ++i) {
-            dst[i] = src1[i] - src2[i];
-        }
+    if constexpr (std::is_same_v<T, float>) {
+        core_vector_sub_f32(dst, src1, src2, count);
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+        core_vector_sub_i32(dst, src1, src2, count);
     } else {
         for (size_t i = 0; i < count; ++i) {
             dst[i] = src1[i] - src2[i];
@@ -239,93 +415,140 @@ T ComputeManager::dotProduct(const T* vec1, const T* vec2, size_t count) {
 
 template<typename T>
 void ComputeManager::matrixMultiply(T* dst, const T* mat1, const T* mat2,
-                                  size_t rows1, size_t cols1, size_t cols2) {
+                                  size_t rows1, size_t cols1, size_t cols2,
+                                  bool transpose1, bool transpose2) {
     if (!dst || !mat1 || !mat2 || rows1 == 0 || cols1 == 0 || cols2 == 0) return;
 
-    // TODO: Реализовать оптимизированное умножение матриц
+    if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+        // Упакованный блочный GEMM, макроблоки распределяются по пулу потоков
+        core_gemm_executor_t executor{&ComputeManager::executorParallelFor, this, threadCount_.load()};
+        const int transA = transpose1 ? CORE_GEMM_TRANS : CORE_GEMM_NO_TRANS;
+        const int transB = transpose2 ? CORE_GEMM_TRANS : CORE_GEMM_NO_TRANS;
+        const size_t lda = transpose1 ? rows1 : cols1;
+        const size_t ldb = transpose2 ? cols1 : cols2;
+        if constexpr (std::is_same_v<T, float>) {
+            core_gemm_f32(transA, transB, rows1, cols2, cols1, 1.0f, mat1, lda, mat2, ldb, 0.0f, dst, cols2, &executor);
+        } else {
+            core_gemm_f64(transA, transB, rows1, cols2, cols1, 1.0, mat1, lda, mat2, ldb, 0.0, dst, cols2, &executor);
+        }
+        updateStats(OperationType::MatrixMultiply, rows1 * cols1 * cols2, true);
+        return;
+    }
+
+    // Прочие типы: порядок i-k-j, внутренний цикл идёт по строкам dst и mat2
+    for (size_t i = 0; i < rows1 * cols2; ++i) {
+        dst[i] = T();
+    }
     for (size_t i = 0; i < rows1; ++i) {
-        for (size_t j = 0; j < cols2; ++j) {
-            T sum = T();
-            for (size_t k = 0; k < cols1; ++k) {
-                sum += mat1[i * cols1 + k] * mat2[k * cols2 + j];
+        for (size_t k = 0; k < cols1; ++k) {
+            const T a = transpose1 ? mat1[k * rows1 + i] : mat1[i * cols1 + k];
+            for (size_t j = 0; j < cols2; ++j) {
+                dst[i * cols2 + j] += a * (transpose2 ? mat2[j * cols1 + k] : mat2[k * cols2 + j]);
             }
-            dst[i * cols2 + j] = sum;
         }
     }
+    updateStats(OperationType::MatrixMultiply, rows1 * cols1 * cols2, false);
 }
 
 template<typename T>
 void ComputeManager::convolution(T* dst, const T* src, const T* kernel,
                                size_t srcSize, size_t kernelSize) {
-    if (!dst || !src || !kernel || srcSize == 0 || kernelSize == 0) return;
+    if (!dst || !src || !kernel || kernelSize == 0 || kernelSize > srcSize) return;
+
+    if constexpr (std::is_same_v<T, float>) {
+        if (convolutionBatch(dst, src, 1, srcSize, kernel, kernelSize)) return;
+    }
 
-    // TODO: Реализовать оптимизированную свертку
-    for (size_t i = 0; i < srcSize - kernelSize + 1; ++i) {
+    const size_t outSize = srcSize - kernelSize + 1;
+    for (size_t i = 0; i < outSize; ++i) {
         T sum = T();
         for (size_t j = 0; j < kernelSize; ++j) {
             sum += src[i + j] * kernel[j];
         }
         dst[i] = sum;
     }
+    updateStats(OperationType::Convolution, outSize * kernelSize, false);
+}
+
+template<typename T, typename E>
+void ComputeManager::evaluate(T* dst, const expr::Expr<E>& e) {
+    const size_t count = e.self().size();
+    if (!dst || count == 0 || count == expr::kBroadcast) return;
+
+    parallelForRange(0, count, [dst, &e](size_t chunkBegin, size_t chunkEnd) {
+        expr::evaluateRange(dst, e, chunkBegin, chunkEnd);
+    });
+    updateStats(OperationType::Add, count, true);
+}
+
+template<typename E>
+typename E::value_type ComputeManager::sum(const expr::Expr<E>& e) {
+    using T = typename E::value_type;
+    const size_t count = e.self().size();
+    if (count == 0 || count == expr::kBroadcast) return T();
+
+    T result = parallelReduceRange(0, count, T(),
+        [&e](size_t chunkBegin, size_t chunkEnd, T acc) {
+            return acc + expr::sumRange(e, chunkBegin, chunkEnd);
+        },
+        [](T a, T b) { return a + b; });
+    updateStats(OperationType::Sum, count, true);
+    return result;
+}
+
+template<typename F>
+bool ComputeManager::parallelForRange(size_t begin, size_t end, F&& body, size_t grain,
+                                      const CancellationToken* cancel) {
+    if (end <= begin) return true;
+
+    const ChunkPlan plan = planChunks(end - begin, grain);
+    return runChunks(begin, end, plan, cancel, [&body](size_t, size_t chunkBegin, size_t chunkEnd) {
+        body(chunkBegin, chunkEnd);
+    });
+}
+
+template<typename T, typename Body, typename Combine>
+T ComputeManager::parallelReduceRange(size_t begin, size_t end, T identity, Body&& body, Combine&& combine,
+                                      size_t grain, const CancellationToken* cancel) {
+    if (end <= begin) return identity;
+
+    const ChunkPlan plan = planChunks(end - begin, grain);
+    std::vector<PaddedPartial<T>> partials(plan.numSlots, PaddedPartial<T>{identity});
+    runChunks(begin, end, plan, cancel, [&partials, &body](size_t slot, size_t chunkBegin, size_t chunkEnd) {
+        partials[slot].value = body(chunkBegin, chunkEnd, std::move(partials[slot].value));
+    });
+
+    T result = std::move(identity);
+    for (auto& partial : partials) {
+        result = combine(std::move(result), std::move(partial.value));
+    }
+    return result;
 }
 
 template<typename T, typename F>
 void ComputeManager::parallelFor(T* data, size_t count, F&& func) {
     if (!data || count == 0) return;
 
-    size_t batchSize = std::min(batchSize_, count);
-    size_t numBatches = (count + batchSize - 1) / batchSize;
-    
-    std::vector<std::future<void>> futures;
-    futures.reserve(numBatches);
-    
-    for (size_t i = 0; i < numBatches; ++i) {
-        size_t start = i * batchSize;
-        size_t end = std::min(start + batchSize, count);
-        
-        futures.push_back(asyncCompute(data, end - start,
-            [&func, data, start](T* batchData, size_t batchCount) {
-                for (size_t j = 0; j < batchCount; ++j) {
-                    func(data[start + j]);
-                }
-            }));
-    }
-    
-    for (auto& future : futures) {
-        future.wait();
-    }
+    parallelForRange(0, count, [data, &func](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+            func(data[i]);
+        }
+    });
 }
 
 template<typename T, typename F>
-void ComputeManager::parallelReduce(T* data, size_t count, F&& func, T init) {
-    if (!data || count == 0) return;
+T ComputeManager::parallelReduce(const T* data, size_t count, F&& func, T init) {
+    if (!data || count == 0) return init;
 
-    size_t batchSize = std::min(batchSize_, count);
-    size_t numBatches = (count + batchSize - 1) / batchSize;
-    
-    std::vector<std::future<T>> futures;
-    futures.reserve(numBatches);
-    
-    for (size_t i = 0; i < numBatches; ++i) {
-        size_t start = i * batchSize;
-        size_t end = std::min(start + batchSize, count);
-        
-        futures.push_back(std::async(std::launch::async,
-            [&func, data, start, end]() {
-                T result = T();
-                for (size_t j = start; j < end; ++j) {
-                    result = func(result, data[j]);
-                }
-                return result;
-            }));
-    }
-    
-    T result = init;
-    for (auto& future : futures) {
-        result = func(result, future.get());
-    }
-    
-    data[0] = result;
+    T partial = parallelReduceRange(0, count, T(),
+        [data, &func](size_t chunkBegin, size_t chunkEnd, T acc) {
+            for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+                acc = func(std::move(acc), data[i]);
+            }
+            return acc;
+        },
+        func);
+    return func(std::move(init), std::move(partial));
 }
 
 template<typename T, typename F>
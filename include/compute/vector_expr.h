@@ -0,0 +1,596 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Ленивые векторные выражения: a * b + c строит дерево узлов-представлений без
+// вычислений, а evaluate/sum проходят по памяти один раз, вычисляя всё дерево
+// в регистрах SIMD. Листья не владеют данными — массивы должны жить, пока
+// используется выражение.
+//
+//   using namespace compute::expr;
+//   auto a = vec(x, n), b = vec(y, n);
+//   float s = sum(a * b + 1.0f);       // один проход, без временных массивов
+//   evaluate(out, max(a - b, 0.0f));   // out может совпадать с x или y
+
+namespace compute {
+namespace expr {
+
+// Пакет из width элементов в регистре; для типов без специализации — один элемент
+template<typename T>
+struct Packet {
+    static constexpr size_t width = 1;
+    T v;
+
+    static Packet load(const T* p) { return {*p}; }
+    void store(T* p) const { *p = v; }
+    static Packet set1(T x) { return {x}; }
+    static Packet zero() { return {T()}; }
+    friend Packet operator+(Packet a, Packet b) { return {a.v + b.v}; }
+    friend Packet operator-(Packet a, Packet b) { return {a.v - b.v}; }
+    friend Packet operator*(Packet a, Packet b) { return {a.v * b.v}; }
+    friend Packet operator/(Packet a, Packet b) { return {a.v / b.v}; }
+    static Packet min(Packet a, Packet b) { return {std::min(a.v, b.v)}; }
+    static Packet max(Packet a, Packet b) { return {std::max(a.v, b.v)}; }
+    static Packet abs(Packet a) { return {a.v < T() ? T() - a.v : a.v}; }
+    static Packet fma(Packet a, Packet b, Packet c) { return {a.v * b.v + c.v}; }
+    static T hsum(Packet a) { return a.v; }
+    static T hmin(Packet a) { return a.v; }
+    static T hmax(Packet a) { return a.v; }
+};
+
+#if defined(__AVX512F__)
+
+template<>
+struct Packet<float> {
+    static constexpr size_t width = 16;
+    __m512 v;
+
+    static Packet load(const float* p) { return {_mm512_loadu_ps(p)}; }
+    void store(float* p) const { _mm512_storeu_ps(p, v); }
+    static Packet set1(float x) { return {_mm512_set1_ps(x)}; }
+    static Packet zero() { return {_mm512_setzero_ps()}; }
+    friend Packet operator+(Packet a, Packet b) { return {_mm512_add_ps(a.v, b.v)}; }
+    friend Packet operator-(Packet a, Packet b) { return {_mm512_sub_ps(a.v, b.v)}; }
+    friend Packet operator*(Packet a, Packet b) { return {_mm512_mul_ps(a.v, b.v)}; }
+    friend Packet operator/(Packet a, Packet b) { return {_mm512_div_ps(a.v, b.v)}; }
+    static Packet min(Packet a, Packet b) { return {_mm512_maskz_min_ps(0xFFFF, b.v, a.v)}; }
+    static Packet max(Packet a, Packet b) { return {_mm512_maskz_max_ps(0xFFFF, b.v, a.v)}; }
+    static Packet abs(Packet a) { return {_mm512_abs_ps(a.v)}; }
+    static Packet fma(Packet a, Packet b, Packet c) { return {_mm512_fmadd_ps(a.v, b.v, c.v)}; }
+    static float hsum(Packet a) {
+        __m256 x = _mm256_add_ps(low(a.v), high(a.v));
+        __m128 y = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+        y = _mm_add_ps(y, _mm_movehl_ps(y, y));
+        return _mm_cvtss_f32(_mm_add_ss(y, _mm_movehdup_ps(y)));
+    }
+    static float hmin(Packet a) {
+        __m256 x = _mm256_min_ps(low(a.v), high(a.v));
+        __m128 y = _mm_min_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+        y = _mm_min_ps(y, _mm_movehl_ps(y, y));
+        return _mm_cvtss_f32(_mm_min_ss(y, _mm_movehdup_ps(y)));
+    }
+    static float hmax(Packet a) {
+        __m256 x = _mm256_max_ps(low(a.v), high(a.v));
+        __m128 y = _mm_max_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+        y = _mm_max_ps(y, _mm_movehl_ps(y, y));
+        return _mm_cvtss_f32(_mm_max_ss(y, _mm_movehdup_ps(y)));
+    }
+
+private:
+    // GCC 12 реализует extract/cast/min/max через _mm512_undefined_*, что даёт
+    // ложный -Wuninitialized в редукциях; берём maskz-формы с нулевым фоном.
+    static __m256 low(__m512 v) {
+        return _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, _mm512_castps_pd(v), 0));
+    }
+    static __m256 high(__m512 v) {
+        return _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, _mm512_castps_pd(v), 1));
+    }
+};
+
+template<>
+struct Packet<double> {
+    static constexpr size_t width = 8;
+    __m512d v;
+
+    static Packet load(const double* p) { return {_mm512_loadu_pd(p)}; }
+    void store(double* p) const { _mm512_storeu_pd(p, v); }
+    static Packet set1(double x) { return {_mm512_set1_pd(x)}; }
+    static Packet zero() { return {_mm512_setzero_pd()}; }
+    friend Packet operator+(Packet a, Packet b) { return {_mm512_add_pd(a.v, b.v)}; }
+    friend Packet operator-(Packet a, Packet b) { return {_mm512_sub_pd(a.v, b.v)}; }
+    friend Packet operator*(Packet a, Packet b) { return {_mm512_mul_pd(a.v, b.v)}; }
+    friend Packet operator/(Packet a, Packet b) { return {_mm512_div_pd(a.v, b.v)}; }
+    static Packet min(Packet a, Packet b) { return {_mm512_maskz_min_pd(0xFF, b.v, a.v)}; }
+    static Packet max(Packet a, Packet b) { return {_mm512_maskz_max_pd(0xFF, b.v, a.v)}; }
+    static Packet abs(Packet a) { return {_mm512_abs_pd(a.v)}; }
+    static Packet fma(Packet a, Packet b, Packet c) { return {_mm512_fmadd_pd(a.v, b.v, c.v)}; }
+    static double hsum(Packet a) {
+        __m256d x = _mm256_add_pd(low(a.v), high(a.v));
+        __m128d y = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(y, _mm_unpackhi_pd(y, y)));
+    }
+    static double hmin(Packet a) {
+        __m256d x = _mm256_min_pd(low(a.v), high(a.v));
+        __m128d y = _mm_min_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+        return _mm_cvtsd_f64(_mm_min_sd(y, _mm_unpackhi_pd(y, y)));
+    }
+    static double hmax(Packet a) {
+        __m256d x = _mm256_max_pd(low(a.v), high(a.v));
+        __m128d y = _mm_max_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+        return _mm_cvtsd_f64(_mm_max_sd(y, _mm_unpackhi_pd(y, y)));
+    }
+
+private:
+    static __m256d low(__m512d v) { return _mm512_maskz_extractf64x4_pd(0xF, v, 0); }
+    static __m256d high(__m512d v) { return _mm512_maskz_extractf64x4_pd(0xF, v, 1); }
+};
+
+#elif defined(__AVX2__)
+
+template<>
+struct Packet<float> {
+    static constexpr size_t width = 8;
+    __m256 v;
+
+    static Packet load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+    static Packet set1(float x) { return {_mm256_set1_ps(x)}; }
+    static Packet zero() { return {_mm256_setzero_ps()}; }
+    friend Packet operator+(Packet a, Packet b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend Packet operator-(Packet a, Packet b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend Packet operator*(Packet a, Packet b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    friend Packet operator/(Packet a, Packet b) { return {_mm256_div_ps(a.v, b.v)}; }
+    static Packet min(Packet a, Packet b) { return {_mm256_min_ps(b.v, a.v)}; }
+    static Packet max(Packet a, Packet b) { return {_mm256_max_ps(b.v, a.v)}; }
+    static Packet abs(Packet a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+#if defined(__FMA__)
+    static Packet fma(Packet a, Packet b, Packet c) { return {_mm256_fmadd_ps(a.v, b.v, c.v)}; }
+#else
+    static Packet fma(Packet a, Packet b, Packet c) { return a * b + c; }
+#endif
+    static float hsum(Packet a) {
+        __m128 x = _mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+        x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+        return _mm_cvtss_f32(_mm_add_ss(x, _mm_movehdup_ps(x)));
+    }
+    static float hmin(Packet a) {
+        __m128 x = _mm_min_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+        x = _mm_min_ps(x, _mm_movehl_ps(x, x));
+        return _mm_cvtss_f32(_mm_min_ss(x, _mm_movehdup_ps(x)));
+    }
+    static float hmax(Packet a) {
+        __m128 x = _mm_max_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+        x = _mm_max_ps(x, _mm_movehl_ps(x, x));
+        return _mm_cvtss_f32(_mm_max_ss(x, _mm_movehdup_ps(x)));
+    }
+};
+
+template<>
+struct Packet<double> {
+    static constexpr size_t width = 4;
+    __m256d v;
+
+    static Packet load(const double* p) { return {_mm256_loadu_pd(p)}; }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+    static Packet set1(double x) { return {_mm256_set1_pd(x)}; }
+    static Packet zero() { return {_mm256_setzero_pd()}; }
+    friend Packet operator+(Packet a, Packet b) { return {_mm256_add_pd(a.v, b.v)}; }
+    friend Packet operator-(Packet a, Packet b) { return {_mm256_sub_pd(a.v, b.v)}; }
+    friend Packet operator*(Packet a, Packet b) { return {_mm256_mul_pd(a.v, b.v)}; }
+    friend Packet operator/(Packet a, Packet b) { return {_mm256_div_pd(a.v, b.v)}; }
+    static Packet min(Packet a, Packet b) { return {_mm256_min_pd(b.v, a.v)}; }
+    static Packet max(Packet a, Packet b) { return {_mm256_max_pd(b.v, a.v)}; }
+    static Packet abs(Packet a) { return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)}; }
+#if defined(__FMA__)
+    static Packet fma(Packet a, Packet b, Packet c) { return {_mm256_fmadd_pd(a.v, b.v, c.v)}; }
+#else
+    static Packet fma(Packet a, Packet b, Packet c) { return a * b + c; }
+#endif
+    static double hsum(Packet a) {
+        __m128d x = _mm_add_pd(_mm256_castpd256_pd128(a.v), _mm256_extractf128_pd(a.v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x)));
+    }
+    static double hmin(Packet a) {
+        __m128d x = _mm_min_pd(_mm256_castpd256_pd128(a.v), _mm256_extractf128_pd(a.v, 1));
+        return _mm_cvtsd_f64(_mm_min_sd(x, _mm_unpackhi_pd(x, x)));
+    }
+    static double hmax(Packet a) {
+        __m128d x = _mm_max_pd(_mm256_castpd256_pd128(a.v), _mm256_extractf128_pd(a.v, 1));
+        return _mm_cvtsd_f64(_mm_max_sd(x, _mm_unpackhi_pd(x, x)));
+    }
+};
+
+#elif defined(__SSE4_2__)
+
+template<>
+struct Packet<float> {
+    static constexpr size_t width = 4;
+    __m128 v;
+
+    static Packet load(const float* p) { return {_mm_loadu_ps(p)}; }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+    static Packet set1(float x) { return {_mm_set1_ps(x)}; }
+    static Packet zero() { return {_mm_setzero_ps()}; }
+    friend Packet operator+(Packet a, Packet b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend Packet operator-(Packet a, Packet b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend Packet operator*(Packet a, Packet b) { return {_mm_mul_ps(a.v, b.v)}; }
+    friend Packet operator/(Packet a, Packet b) { return {_mm_div_ps(a.v, b.v)}; }
+    static Packet min(Packet a, Packet b) { return {_mm_min_ps(b.v, a.v)}; }
+    static Packet max(Packet a, Packet b) { return {_mm_max_ps(b.v, a.v)}; }
+    static Packet abs(Packet a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+#if defined(__FMA__)
+    static Packet fma(Packet a, Packet b, Packet c) { return {_mm_fmadd_ps(a.v, b.v, c.v)}; }
+#else
+    static Packet fma(Packet a, Packet b, Packet c) { return a * b + c; }
+#endif
+    static float hsum(Packet a) {
+        __m128 x = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_add_ss(x, _mm_movehdup_ps(x)));
+    }
+    static float hmin(Packet a) {
+        __m128 x = _mm_min_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_min_ss(x, _mm_movehdup_ps(x)));
+    }
+    static float hmax(Packet a) {
+        __m128 x = _mm_max_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_max_ss(x, _mm_movehdup_ps(x)));
+    }
+};
+
+template<>
+struct Packet<double> {
+    static constexpr size_t width = 2;
+    __m128d v;
+
+    static Packet load(const double* p) { return {_mm_loadu_pd(p)}; }
+    void store(double* p) const { _mm_storeu_pd(p, v); }
+    static Packet set1(double x) { return {_mm_set1_pd(x)}; }
+    static Packet zero() { return {_mm_setzero_pd()}; }
+    friend Packet operator+(Packet a, Packet b) { return {_mm_add_pd(a.v, b.v)}; }
+    friend Packet operator-(Packet a, Packet b) { return {_mm_sub_pd(a.v, b.v)}; }
+    friend Packet operator*(Packet a, Packet b) { return {_mm_mul_pd(a.v, b.v)}; }
+    friend Packet operator/(Packet a, Packet b) { return {_mm_div_pd(a.v, b.v)}; }
+    static Packet min(Packet a, Packet b) { return {_mm_min_pd(b.v, a.v)}; }
+    static Packet max(Packet a, Packet b) { return {_mm_max_pd(b.v, a.v)}; }
+    static Packet abs(Packet a) { return {_mm_andnot_pd(_mm_set1_pd(-0.0), a.v)}; }
+#if defined(__FMA__)
+    static Packet fma(Packet a, Packet b, Packet c) { return {_mm_fmadd_pd(a.v, b.v, c.v)}; }
+#else
+    static Packet fma(Packet a, Packet b, Packet c) { return a * b + c; }
+#endif
+    static double hsum(Packet a) { return _mm_cvtsd_f64(_mm_add_sd(a.v, _mm_unpackhi_pd(a.v, a.v))); }
+    static double hmin(Packet a) { return _mm_cvtsd_f64(_mm_min_sd(a.v, _mm_unpackhi_pd(a.v, a.v))); }
+    static double hmax(Packet a) { return _mm_cvtsd_f64(_mm_max_sd(a.v, _mm_unpackhi_pd(a.v, a.v))); }
+};
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+template<>
+struct Packet<float> {
+    static constexpr size_t width = 4;
+    float32x4_t v;
+
+    static Packet load(const float* p) { return {vld1q_f32(p)}; }
+    void store(float* p) const { vst1q_f32(p, v); }
+    static Packet set1(float x) { return {vdupq_n_f32(x)}; }
+    static Packet zero() { return {vdupq_n_f32(0.0f)}; }
+    friend Packet operator+(Packet a, Packet b) { return {vaddq_f32(a.v, b.v)}; }
+    friend Packet operator-(Packet a, Packet b) { return {vsubq_f32(a.v, b.v)}; }
+    friend Packet operator*(Packet a, Packet b) { return {vmulq_f32(a.v, b.v)}; }
+    friend Packet operator/(Packet a, Packet b) { return {vdivq_f32(a.v, b.v)}; }
+    static Packet min(Packet a, Packet b) { return {vminq_f32(a.v, b.v)}; }
+    static Packet max(Packet a, Packet b) { return {vmaxq_f32(a.v, b.v)}; }
+    static Packet abs(Packet a) { return {vabsq_f32(a.v)}; }
+    static Packet fma(Packet a, Packet b, Packet c) { return {vfmaq_f32(c.v, a.v, b.v)}; }
+    static float hsum(Packet a) { return vaddvq_f32(a.v); }
+    static float hmin(Packet a) { return vminvq_f32(a.v); }
+    static float hmax(Packet a) { return vmaxvq_f32(a.v); }
+};
+
+template<>
+struct Packet<double> {
+    static constexpr size_t width = 2;
+    float64x2_t v;
+
+    static Packet load(const double* p) { return {vld1q_f64(p)}; }
+    void store(double* p) const { vst1q_f64(p, v); }
+    static Packet set1(double x) { return {vdupq_n_f64(x)}; }
+    static Packet zero() { return {vdupq_n_f64(0.0)}; }
+    friend Packet operator+(Packet a, Packet b) { return {vaddq_f64(a.v, b.v)}; }
+    friend Packet operator-(Packet a, Packet b) { return {vsubq_f64(a.v, b.v)}; }
+    friend Packet operator*(Packet a, Packet b) { return {vmulq_f64(a.v, b.v)}; }
+    friend Packet operator/(Packet a, Packet b) { return {vdivq_f64(a.v, b.v)}; }
+    static Packet min(Packet a, Packet b) { return {vminq_f64(a.v, b.v)}; }
+    static Packet max(Packet a, Packet b) { return {vmaxq_f64(a.v, b.v)}; }
+    static Packet abs(Packet a) { return {vabsq_f64(a.v)}; }
+    static Packet fma(Packet a, Packet b, Packet c) { return {vfmaq_f64(c.v, a.v, b.v)}; }
+    static double hsum(Packet a) { return vaddvq_f64(a.v); }
+    static double hmin(Packet a) { return vminvq_f64(a.v); }
+    static double hmax(Packet a) { return vmaxvq_f64(a.v); }
+};
+
+#endif
+
+// a * b + c сворачивается в одну инструкцию FMA там, где она есть аппаратно;
+// скалярный хвост использует std::fma, чтобы результат не зависел от позиции
+#if defined(__FMA__) || defined(__AVX512F__) || (defined(__ARM_NEON) && defined(__aarch64__))
+constexpr bool kFusedMultiplyAdd = true;
+#else
+constexpr bool kFusedMultiplyAdd = false;
+#endif
+
+// Размер листа-скаляра: подходит к выражению любой длины
+constexpr size_t kBroadcast = static_cast<size_t>(-1);
+
+// Базовый класс узлов; операторы ниже принимают только выражения
+template<typename E>
+struct Expr {
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+template<typename T>
+class Vector : public Expr<Vector<T>> {
+public:
+    using value_type = T;
+
+    Vector(const T* data, size_t size) : data_(data), size_(size) {}
+
+    size_t size() const { return size_; }
+    T eval(size_t i) const { return data_[i]; }
+    Packet<T> packet(size_t i) const { return Packet<T>::load(data_ + i); }
+
+private:
+    const T* data_;
+    size_t size_;
+};
+
+template<typename T>
+class Scalar : public Expr<Scalar<T>> {
+public:
+    using value_type = T;
+
+    explicit Scalar(T value) : value_(value) {}
+
+    size_t size() const { return kBroadcast; }
+    T eval(size_t) const { return value_; }
+    Packet<T> packet(size_t) const { return Packet<T>::set1(value_); }
+
+private:
+    T value_;
+};
+
+struct AddOp {
+    template<typename V> static V apply(const V& a, const V& b) { return a + b; }
+};
+struct SubOp {
+    template<typename V> static V apply(const V& a, const V& b) { return a - b; }
+};
+struct MulOp {
+    template<typename V> static V apply(const V& a, const V& b) { return a * b; }
+};
+struct DivOp {
+    template<typename V> static V apply(const V& a, const V& b) { return a / b; }
+};
+struct MinOp {
+    template<typename T> static T apply(const T& a, const T& b) { return std::min(a, b); }
+    template<typename T> static Packet<T> apply(const Packet<T>& a, const Packet<T>& b) { return Packet<T>::min(a, b); }
+};
+struct MaxOp {
+    template<typename T> static T apply(const T& a, const T& b) { return std::max(a, b); }
+    template<typename T> static Packet<T> apply(const Packet<T>& a, const Packet<T>& b) { return Packet<T>::max(a, b); }
+};
+struct AbsOp {
+    template<typename T> static T apply(const T& a) { return a < T() ? T() - a : a; }
+    template<typename T> static Packet<T> apply(const Packet<T>& a) { return Packet<T>::abs(a); }
+};
+struct NegOp {
+    template<typename T> static T apply(const T& a) { return T() - a; }
+    template<typename T> static Packet<T> apply(const Packet<T>& a) { return Packet<T>::zero() - a; }
+};
+
+template<typename Op, typename L, typename R>
+class Binary : public Expr<Binary<Op, L, R>> {
+public:
+    using value_type = typename L::value_type;
+    static_assert(std::is_same_v<value_type, typename R::value_type>, "operands must have the same element type");
+
+    Binary(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {
+        if (lhs.size() != kBroadcast && rhs.size() != kBroadcast && lhs.size() != rhs.size()) {
+            throw std::invalid_argument("vector expression operands differ in size");
+        }
+    }
+
+    size_t size() const { return lhs_.size() != kBroadcast ? lhs_.size() : rhs_.size(); }
+    const L& lhs() const { return lhs_; }
+    const R& rhs() const { return rhs_; }
+
+    value_type eval(size_t i) const {
+        if constexpr (isFusedAdd()) {
+            return std::fma(lhs_.lhs().eval(i), lhs_.rhs().eval(i), rhs_.eval(i));
+        } else {
+            return Op::apply(lhs_.eval(i), rhs_.eval(i));
+        }
+    }
+
+    Packet<value_type> packet(size_t i) const {
+        if constexpr (isFusedAdd()) {
+            return Packet<value_type>::fma(lhs_.lhs().packet(i), lhs_.rhs().packet(i), rhs_.packet(i));
+        } else {
+            return Op::apply(lhs_.packet(i), rhs_.packet(i));
+        }
+    }
+
+private:
+    template<typename E> struct IsMul : std::false_type {};
+    template<typename A, typename B> struct IsMul<Binary<MulOp, A, B>> : std::true_type {};
+
+    static constexpr bool isFusedAdd() {
+        return kFusedMultiplyAdd && std::is_floating_point_v<value_type> &&
+               std::is_same_v<Op, AddOp> && IsMul<L>::value;
+    }
+
+    L lhs_;
+    R rhs_;
+};
+
+template<typename Op, typename A>
+class Unary : public Expr<Unary<Op, A>> {
+public:
+    using value_type = typename A::value_type;
+
+    explicit Unary(const A& arg) : arg_(arg) {}
+
+    size_t size() const { return arg_.size(); }
+    value_type eval(size_t i) const { return Op::apply(arg_.eval(i)); }
+    Packet<value_type> packet(size_t i) const { return Op::apply(arg_.packet(i)); }
+
+private:
+    A arg_;
+};
+
+template<typename T>
+Vector<T> vec(const T* data, size_t size) { return Vector<T>(data, size); }
+
+template<typename T>
+Vector<T> vec(const std::vector<T>& data) { return Vector<T>(data.data(), data.size()); }
+
+// Бинарные операции над парой выражений и выражением со скаляром того же типа
+#define COMPUTE_EXPR_BINARY(name, Op)                                                              \
+    template<typename L, typename R>                                                               \
+    Binary<Op, L, R> name(const Expr<L>& l, const Expr<R>& r) {                                    \
+        return Binary<Op, L, R>(l.self(), r.self());                                               \
+    }                                                                                              \
+    template<typename L, typename S, typename = std::enable_if_t<std::is_arithmetic_v<S>>>        \
+    Binary<Op, L, Scalar<typename L::value_type>> name(const Expr<L>& l, S s) {                    \
+        return {l.self(), Scalar<typename L::value_type>(static_cast<typename L::value_type>(s))}; \
+    }                                                                                              \
+    template<typename S, typename R, typename = std::enable_if_t<std::is_arithmetic_v<S>>>        \
+    Binary<Op, Scalar<typename R::value_type>, R> name(S s, const Expr<R>& r) {                    \
+        return {Scalar<typename R::value_type>(static_cast<typename R::value_type>(s)), r.self()}; \
+    }
+
+COMPUTE_EXPR_BINARY(operator+, AddOp)
+COMPUTE_EXPR_BINARY(operator-, SubOp)
+COMPUTE_EXPR_BINARY(operator*, MulOp)
+COMPUTE_EXPR_BINARY(operator/, DivOp)
+COMPUTE_EXPR_BINARY(min, MinOp)
+COMPUTE_EXPR_BINARY(max, MaxOp)
+
+#undef COMPUTE_EXPR_BINARY
+
+template<typename A>
+Unary<AbsOp, A> abs(const Expr<A>& a) { return Unary<AbsOp, A>(a.self()); }
+
+template<typename A>
+Unary<NegOp, A> operator-(const Expr<A>& a) { return Unary<NegOp, A>(a.self()); }
+
+// Проходы по диапазону [begin, end) — основа для evaluate/sum и для
+// параллельных вариантов ComputeManager, которые делят диапазон на куски
+
+template<typename T, typename E>
+void evaluateRange(T* dst, const Expr<E>& e, size_t begin, size_t end) {
+    using P = Packet<typename E::value_type>;
+    const E& x = e.self();
+    size_t i = begin;
+    for (; i + P::width <= end; i += P::width) {
+        x.packet(i).store(dst + i);
+    }
+    for (; i < end; ++i) {
+        dst[i] = x.eval(i);
+    }
+}
+
+template<typename E>
+typename E::value_type sumRange(const Expr<E>& e, size_t begin, size_t end) {
+    using T = typename E::value_type;
+    using P = Packet<T>;
+    const E& x = e.self();
+    // Два аккумулятора скрывают задержку сложения
+    P acc0 = P::zero(), acc1 = P::zero();
+    size_t i = begin;
+    for (; i + 2 * P::width <= end; i += 2 * P::width) {
+        acc0 = acc0 + x.packet(i);
+        acc1 = acc1 + x.packet(i + P::width);
+    }
+    for (; i + P::width <= end; i += P::width) {
+        acc0 = acc0 + x.packet(i);
+    }
+    T result = P::hsum(acc0 + acc1);
+    for (; i < end; ++i) {
+        result += x.eval(i);
+    }
+    return result;
+}
+
+template<typename E>
+typename E::value_type minRange(const Expr<E>& e, size_t begin, size_t end) {
+    using T = typename E::value_type;
+    using P = Packet<T>;
+    const E& x = e.self();
+    P acc = P::set1(std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                           : std::numeric_limits<T>::max());
+    size_t i = begin;
+    for (; i + P::width <= end; i += P::width) {
+        acc = P::min(acc, x.packet(i));
+    }
+    T result = P::hmin(acc);
+    for (; i < end; ++i) {
+        result = std::min(result, x.eval(i));
+    }
+    return result;
+}
+
+template<typename E>
+typename E::value_type maxRange(const Expr<E>& e, size_t begin, size_t end) {
+    using T = typename E::value_type;
+    using P = Packet<T>;
+    const E& x = e.self();
+    P acc = P::set1(std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                           : std::numeric_limits<T>::lowest());
+    size_t i = begin;
+    for (; i + P::width <= end; i += P::width) {
+        acc = P::max(acc, x.packet(i));
+    }
+    T result = P::hmax(acc);
+    for (; i < end; ++i) {
+        result = std::max(result, x.eval(i));
+    }
+    return result;
+}
+
+// Записывает выражение в dst за один проход. dst может совпадать с листом
+// выражения, но не должен перекрываться с ним со сдвигом.
+template<typename T, typename E>
+void evaluate(T* dst, const Expr<E>& e) {
+    if (e.self().size() != kBroadcast) {
+        evaluateRange(dst, e, 0, e.self().size());
+    }
+}
+
+template<typename E>
+typename E::value_type sum(const Expr<E>& e) { return sumRange(e, 0, e.self().size()); }
+
+template<typename L, typename R>
+typename L::value_type dot(const Expr<L>& a, const Expr<R>& b) { return sum(a * b); }
+
+// Для пустого выражения — +inf / -inf (или пределы типа для целых)
+template<typename E>
+typename E::value_type reduceMin(const Expr<E>& e) { return minRange(e, 0, e.self().size()); }
+
+template<typename E>
+typename E::value_type reduceMax(const Expr<E>& e) { return maxRange(e, 0, e.self().size()); }
+
+} // namespace expr
+} // namespace compute
@@ -13,6 +13,7 @@
 #include "jit_compiler/jit_compiler.h"
 #include "lockfree_structures.h"
 #include "integration.h"
+#include "drivers/topology_ops.h"
 
 #include <boost/asio/thread_pool.hpp>
 #include <boost/asio/experimental/parallel_group.hpp>
@@ -393,15 +394,28 @@ inline void* core::DistributedCloudEngine::ResourceHandle::allocate_memory(size_
 }
 
 inline void core::DistributedCloudEngine::optimize_for_numa_architecture() {
-    if (numa_available() == -1) return;
+    const core_topology_t* topology = core_topology_system();
+    if (!topology || topology->num_nodes < 2) return;
 
     for (auto& thread : io_pool_) {
+        // Узел определяется по CPU, на которые поток уже допущен, а не по его
+        // pthread_t: поток расширяется на все разрешённые CPU этого узла
         cpu_set_t cpuset;
         CPU_ZERO(&cpuset);
-        int numa_node = numa_node_of_cpu(thread.native_handle());
-        for (int i = 0; i < numa_num_configured_cpus(); i++) {
-            if (numa_node_of_cpu(i) == numa_node) {
-                CPU_SET(i, &cpuset);
+        if (pthread_getaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset) != 0) continue;
+        int numa_node = -1;
+        for (size_t i = 0; i < topology->num_cpus && numa_node < 0; i++) {
+            if (topology->cpus[i].cpu < CPU_SETSIZE && CPU_ISSET(topology->cpus[i].cpu, &cpuset)) {
+                numa_node = topology->cpus[i].node;
+            }
+        }
+        if (numa_node < 0) continue;
+
+        CPU_ZERO(&cpuset);
+        for (size_t i = 0; i < topology->num_cpus; i++) {
+            const core_cpu_desc_t& cpu = topology->cpus[i];
+            if (cpu.node == numa_node && cpu.allowed && cpu.cpu < CPU_SETSIZE) {
+                CPU_SET(cpu.cpu, &cpuset);
             }
         }
         pthread_setaffinity_np(thread.native_handle(),
@@ -409,8 +423,7 @@ inline void core::DistributedCloudEngine::optimize_for_numa_architecture() {
     }
 
     if (config_.caching_config.enable_nvm_cache) {
-        memory_manager_.configure_numa_allocation(
-            numa_num_configured_nodes());
+        memory_manager_.configure_numa_allocation(topology->num_nodes);
     }
 }
 
@@ -6,6 +6,7 @@
 #include <mutex>
 #include <atomic>
 #include <unordered_map>
+#include <array>
 #include "core/MultiCoreEngine.h"
 #include "core/blockchain/MultiCoreBlockchain.h"
 #include "core/NetworkManager.h"
@@ -48,9 +49,18 @@ public:
     size_t submit_task(const Task& task);
     void cancel_task(size_t task_id);
     TaskStatus get_task_status(size_t task_id) const;
+    // Core the task is routed to, or -1 for an unknown ID
+    size_t get_task_core(size_t task_id) const;
     void update_task_metrics(size_t task_id, const TaskMetrics& metrics);
-
-    // Core management
+    // Records the task's final status and releases its slot in its core's
+    // queue depth. Compute tasks report here from the engine worker that ran
+    // them; only they hold a slot, since the other managers place tasks on
+    // their own cores. Later calls for the same task are ignored.
+    void complete_task(size_t task_id, TaskStatus status);
+
+    // Core management. Routing picks the less loaded of two random healthy
+    // cores, so it is O(1) and concurrent submitters do not all pile onto
+    // the same "least loaded" core between metric updates.
     size_t find_least_loaded_core() const;
     void update_core_metrics(size_t core_id, const CoreMetrics& metrics);
     bool is_core_healthy(size_t core_id) const;
@@ -74,16 +84,69 @@ private:
     mutable std::mutex state_mutex_;
     std::condition_variable state_cv_;
 
-    // Task management
-    std::unordered_map<size_t, Task> tasks_;
-    std::unordered_map<size_t, TaskStatus> task_status_;
-    std::unordered_map<size_t, TaskMetrics> task_metrics_;
-    mutable std::mutex task_mutex_;
+    // Task management. IDs come from one atomic counter and are never reused;
+    // the registry is sharded by ID so concurrent submissions land on
+    // different shards and each shard lock is held only for a row update.
+    // Rows hold live tasks only: a completed, cancelled or failed task leaves
+    // its final status in a small per-shard ring and its row is compacted away.
+    static constexpr size_t kTaskShards = 64;
+    static constexpr size_t kTaskTombstones = 256;
+
+    struct Tombstone {
+        size_t id = 0;   // 0 is never issued
+        TaskStatus status;
+    };
+
+    struct alignas(64) TaskShard {
+        mutable std::mutex mutex;
+        std::unordered_map<size_t, uint32_t> rows;   // task ID -> row
+        // Struct of arrays: status scans touch only the status column
+        std::vector<size_t> ids;
+        std::vector<TaskStatus> status;
+        std::vector<size_t> assigned_core;
+        std::vector<TaskMetrics> metrics;
+        std::vector<TaskType> types;
+        std::vector<uint8_t> queued;   // still counted in its core's depth
+        std::array<Tombstone, kTaskTombstones> finished{};
+        size_t next_finished = 0;
+
+        // Moves the task's final status to the ring and fills its row with the last one
+        void retire(uint32_t row, TaskStatus final_status);
+    };
+
+    std::atomic<size_t> next_task_id_{1};
+    std::array<TaskShard, kTaskShards> task_shards_;
+
+    TaskShard& task_shard(size_t task_id) { return task_shards_[task_id % kTaskShards]; }
+    const TaskShard& task_shard(size_t task_id) const { return task_shards_[task_id % kTaskShards]; }
+    void dispatch_task(size_t task_id, const Task& task);
 
     // Core metrics
     std::unordered_map<size_t, CoreMetrics> core_metrics_;
     mutable std::mutex metrics_mutex_;
 
+    // Routing state, read without locks on every submission. depth counts
+    // tasks routed to the core that have not completed or been cancelled;
+    // score is an EWMA of the cpu/memory/network load reported for the core
+    // and for the tasks running on it.
+    static constexpr size_t kMaxCores = 1024;
+    static constexpr double kLoadEwmaAlpha = 0.3;
+
+    struct alignas(64) CoreSlot {
+        std::atomic<int64_t> depth{0};
+        std::atomic<double> score{0.0};
+        std::atomic<bool> scored{false};
+        std::atomic<bool> healthy{false};
+    };
+
+    std::unique_ptr<CoreSlot[]> core_slots_;
+    std::atomic<size_t> core_span_{0};   // highest registered core ID + 1
+
+    static double load_of(const TaskMetrics& metrics);
+    void record_core_load(size_t core_id, double load);
+    void release_core_slot(size_t core_id);
+    double routing_cost(size_t core_id) const;
+
     // Internal methods
     void monitor_cores();
     void handle_core_failure(size_t core_id);
@@ -8,12 +8,18 @@
 #include "drivers/math_ops.h"
 #include "drivers/blockchain_ops.h"
 #include "drivers/compute_ops.h"
+#include "drivers/topology_ops.h"
+#include "drivers/task_queue_ops.h"
+#include "async/task.h"
+#include "async/io.h"
 #include <vector>
 #include <memory>
 #include <atomic>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <functional>
+#include <string>
 
 namespace core {
 
@@ -21,13 +27,14 @@ class MultiCoreEngine {
 public:
     struct CoreConfig {
         size_t core_id;
-        size_t numa_node;
-        bool enable_hyperthreading;
+        size_t numa_node;              // static_cast<size_t>(-1): any node
+        bool enable_hyperthreading;    // may share a physical core via SMT
         size_t cache_size;
         size_t memory_limit;
         bool enable_simd;
         bool enable_gpu;
         bool enable_fpga;
+        bool latency_critical = false; // whole physical core, SMT siblings left idle
     };
 
     struct SystemMetrics {
@@ -56,7 +63,18 @@ public:
     void rebalance_resources();
 
     // Task Management
-    void submit_task(size_t core_id, const Task& task);
+    // sched_class is CORE_SCHED_LATENCY, CORE_SCHED_NORMAL or CORE_SCHED_BATCH;
+    // deadline_ns is absolute on core_task_now_ns() and orders latency tasks
+    void submit_task(size_t core_id, const Task& task,
+                     int sched_class = CORE_SCHED_NORMAL, uint64_t deadline_ns = 0);
+    // Same, and calls on_done on the worker once the task has run, also when
+    // it threw; callers use it to release what they reserved for the task
+    void submit_task(size_t core_id, const Task& task, std::function<void()> on_done,
+                     int sched_class = CORE_SCHED_NORMAL, uint64_t deadline_ns = 0);
+    // Never waits on the target core: a full queue spills to the least loaded
+    // core; false only when every queue is full or the engine is not started
+    bool submit_task(size_t core_id, void (*run)(void*), void* arg,
+                     int sched_class = CORE_SCHED_NORMAL, uint64_t deadline_ns = 0);
     void cancel_task(size_t core_id, const TaskId& task_id);
     TaskStatus get_task_status(size_t core_id, const TaskId& task_id);
 
@@ -71,23 +89,46 @@ public:
     void enable_monitoring(bool enable);
     void set_metrics_callback(std::function<void(const SystemMetrics&)> callback);
 
+    // Coroutines: co_await async::schedule(executor(core_id)) moves a coroutine
+    // onto a core; I/O awaitables on reactor() resume it back on that core
+    async::Executor executor(size_t core_id, int sched_class = CORE_SCHED_NORMAL);
+    async::Reactor& reactor();
+
+    // Scheduling classes: the config applies to queues created by the next start()
+    void set_scheduling_config(const core_sched_config_t& config);
+    core_sched_stats_t get_scheduling_stats() const;
+
+    // Worker Placement (planned from the CPU topology in start())
+    std::vector<core_placement_t> get_core_placement() const;
+    std::string describe_core_placement() const;
+
     // Hardware Acceleration
     void enable_hardware_acceleration(size_t core_id, bool enable);
     void configure_accelerator(size_t core_id, const AcceleratorConfig& config);
     void calibrate_hardware();
 
 private:
+    struct CoreExecutor {
+        MultiCoreEngine* engine = nullptr;
+        size_t core_id = 0;
+        int sched_class = CORE_SCHED_NORMAL;
+    };
+
     struct Core {
         std::unique_ptr<CoreEngine> engine;
         std::thread worker;
         std::atomic<bool> running{false};
         std::atomic<bool> paused{false};
-        std::mutex mutex;
-        std::condition_variable cv;
-        TaskQueue task_queue;
+        std::atomic<bool> idle{false};      // parked, may be woken to steal
+        core_task_sched_t* task_sched = nullptr;  // lock-free class queues, on the core's node
+        CoreExecutor executors[CORE_SCHED_CLASSES];
         ResourceManager resource_manager;
         CacheManager cache_manager;
         AcceleratorManager accelerator_manager;
+        // Worker CPU and node; local_memory is allocated on that node
+        core_placement_t placement{-1, -1, 0, 0, 0};
+        void* local_memory = nullptr;
+        size_t local_memory_size = 0;
     };
 
     // Core Management
@@ -96,6 +137,8 @@ private:
     std::atomic<bool> system_running_{false};
     std::mutex system_mutex_;
     std::condition_variable system_cv_;
+    core_sched_config_t sched_config_;
+    std::unique_ptr<async::Reactor> reactor_;
 
     // Blockchain
     std::unique_ptr<MultiCoreBlockchain> blockchain_;
@@ -109,6 +152,10 @@ private:
     // Internal Methods
     void initialize_core(size_t core_id);
     void worker_thread(size_t core_id);
+    void run_tasks(size_t core_id, const core_task_t* tasks, size_t count);
+    size_t steal_work(size_t core_id, core_task_t* tasks);
+    size_t find_least_loaded_core() const;
+    static void post_coroutine(void* ctx, std::coroutine_handle<> handle);
     void monitor_system();
     void handle_core_failure(size_t core_id);
     void redistribute_tasks();
@@ -116,6 +163,7 @@ private:
     void cleanup_core(size_t core_id);
     void sync_cores();
     void optimize_core_performance(size_t core_id);
+    void plan_core_placement();
     void configure_core_affinity(size_t core_id);
     void setup_inter_core_communication();
     void initialize_hardware_acceleration(size_t core_id);
@@ -6,9 +6,17 @@
 #include <mutex>
 #include <atomic>
 #include <unordered_map>
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <string>
+#include <thread>
 #include <functional>
 #include "core/Task.h"
+#include "core/drivers/conn_pool_ops.h"
+#include "core/drivers/event_loop_ops.h"
+#include "core/drivers/net_conn_ops.h"
+#include "core/drivers/topology_ops.h"
 
 namespace core {
 
@@ -30,7 +38,37 @@ public:
         size_t timeout_ms;
     };
 
+    // Connections are pooled per host:port. Disconnecting hands the socket
+    // back to the pool instead of closing it; the next connect to the same
+    // endpoint reuses it after checking that the peer has not closed it.
+    struct PoolConfig {
+        size_t max_per_host{64};        // open sockets per endpoint, in use or idle
+        size_t max_idle_per_host{16};
+        std::chrono::milliseconds idle_timeout{60000};
+        std::chrono::seconds keepalive_idle{30};   // 0 disables TCP keep-alive
+    };
+
+    // Connection I/O runs on per-core reactors: one event loop thread per
+    // core owns its connections and does every read and the tail of every
+    // write, so a single thread services tens of thousands of sockets. Sends
+    // write straight to the socket and queue only what does not fit; once a
+    // connection's queue reaches send_high_watermark, send refuses more data
+    // until the reactor drains it.
+    struct ReactorConfig {
+        size_t reactors{0};                     // 0 = one per physical core
+        bool use_io_uring{false};               // falls back to epoll if the kernel lacks it
+        size_t send_high_watermark{1 << 20};
+        size_t send_low_watermark{256 << 10};
+    };
+
+    // Called on the reactor thread that owns the connection; core_id is that
+    // reactor's index, which is also the NetworkCore the connection belongs
+    // to. data is only valid during the call.
+    using DataHandler = std::function<void(size_t core_id, size_t connection_id, const void* data, size_t size)>;
+
     NetworkManager();
+    explicit NetworkManager(const PoolConfig& pool_config);
+    NetworkManager(const PoolConfig& pool_config, const ReactorConfig& reactor_config);
     ~NetworkManager();
 
     // Core management
@@ -46,12 +84,29 @@ public:
     void pause_core(size_t core_id);
     void resume_core(size_t core_id);
 
-    // Network operations
+    // Network operations. connect waits up to config.timeout_ms for a free
+    // slot when the endpoint is at max_per_host. send never blocks: it
+    // returns 0 when the connection is gone or its send queue is full.
+    // receive returns buffered inbound bytes (0 if none yet) unless a data
+    // handler consumes them; set the handler before connecting.
     size_t connect(const ConnectionConfig& config);
     void disconnect(size_t connection_id);
     size_t send(size_t connection_id, const void* data, size_t size);
     size_t receive(size_t connection_id, void* buffer, size_t size);
+    // Fan-out: the payload is copied once into a shared immutable buffer
+    // and every reactor sends it to its own connections in parallel; queues
+    // hold references to it rather than copies. Connections whose send
+    // queue is full miss the message, as with send. gossip sends to
+    // `fanout` connections picked at random, for protocols that relay
+    // between peers instead of flooding every link.
     void broadcast(const void* data, size_t size);
+    void gossip(const void* data, size_t size, size_t fanout);
+    // Called on the reactor that owns the connection. Set it before start()
+    // or after stop(); throws while the reactors are running.
+    void set_data_handler(DataHandler handler);
+    size_t get_reactor_count() const { return reactors_.size(); }
+    size_t get_pool_size() const;   // connections currently handed out
+    core_conn_pool_stats_t get_pool_stats() const;
 
     // Task management
     size_t submit_task(size_t task_id, const Task& task);
@@ -81,9 +136,70 @@ private:
     mutable std::mutex state_mutex_;
     std::condition_variable state_cv_;
 
-    // Connection management
-    std::unordered_map<size_t, std::unique_ptr<class Connection>> connections_;
-    mutable std::mutex connection_mutex_;
+    // Per-core reactor: an event loop and the thread that runs it
+    struct Reactor {
+        core_event_loop_t* loop{nullptr};
+        std::thread thread;
+        core_placement_t placement{-1, -1, -1, 0, 1};
+    };
+
+    // State the reactor needs until the connection's on_close: the inbound
+    // buffer and the pooled socket, which goes back to the pool only after
+    // the reactor has let go of it. Keeps itself alive through `self`.
+    struct ConnectionState {
+        NetworkManager* owner{nullptr};
+        size_t id{0};
+        size_t core_id{0};
+        core_conn_pool_t* pool{nullptr};
+        core_pooled_conn_t* pooled{nullptr};
+        std::shared_ptr<ConnectionState> self;
+        std::atomic<bool> reusable{true};   // cleared when recovery fails
+        std::atomic<bool> closing{false};   // we asked for the close
+        std::atomic<bool> abort{false};     // close without flushing the send queue
+        std::atomic<bool> closed{false};    // on_close has run
+        std::mutex inbound_mutex;
+        std::string inbound;
+        size_t inbound_offset{0};
+
+        static void on_data(void* ctx, const void* data, size_t size);
+        static void on_close(void* ctx, int error);
+    };
+
+    // Connection registry. Shards and in-flight I/O hold entries; the last
+    // reference asks the reactor to flush and close, and the reactor hands
+    // the socket back to the pool from on_close. The registry is sharded by
+    // ID; a shard lock is held only to copy the entry out, never across I/O.
+    struct ConnectionEntry {
+        ConnectionEntry(std::shared_ptr<ConnectionState> state, const ConnectionConfig& config);
+        ~ConnectionEntry();
+
+        std::shared_ptr<ConnectionState> state;
+        core_net_conn_t* net{nullptr};
+        std::unique_ptr<class Connection> connection;
+    };
+
+    // One reactor's share of a broadcast
+    struct FanOut {
+        core_net_payload_t* payload{nullptr};
+        std::vector<std::shared_ptr<ConnectionEntry>> entries;
+        ~FanOut() { core_net_payload_release(payload); }
+    };
+
+    static constexpr size_t kConnectionShards = 64;
+
+    struct alignas(64) ConnectionShard {
+        std::mutex mutex;
+        std::unordered_map<size_t, std::shared_ptr<ConnectionEntry>> connections;
+    };
+
+    core_conn_pool_t* pool_{nullptr};
+    ReactorConfig reactor_config_;
+    std::vector<std::unique_ptr<Reactor>> reactors_;
+    uint64_t monitor_timer_{0};   // reactor 0's thread only
+    DataHandler data_handler_;
+    std::array<ConnectionShard, kConnectionShards> connection_shards_;
+    std::atomic<size_t> next_connection_id_{1};
+    std::atomic<size_t> connections_in_use_{0};
 
     // Task management
     std::unordered_map<size_t, Task> tasks_;
@@ -95,6 +211,17 @@ private:
     mutable std::mutex metrics_mutex_;
 
     // Internal methods
+    ConnectionShard& connection_shard(size_t connection_id) {
+        return connection_shards_[connection_id % kConnectionShards];
+    }
+    std::shared_ptr<ConnectionEntry> find_connection(size_t connection_id);
+    std::vector<std::pair<size_t, std::shared_ptr<ConnectionEntry>>> snapshot_connections();
+    void create_reactors();
+    void release_all_connections();
+    void fan_out(std::vector<std::pair<size_t, std::shared_ptr<ConnectionEntry>>> entries,
+                 const void* data, size_t size);
+    static void run_fan_out(void* ctx);
+    static void monitor_tick(void* ctx);
     void monitor_connections();
     void handle_connection_failure(size_t connection_id);
     void optimize_connection(size_t connection_id);
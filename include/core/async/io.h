@@ -0,0 +1,376 @@
+#pragma once
+
+#include "core/async/task.h"
+#include "core/drivers/event_loop_ops.h"
+#include "core/drivers/task_queue_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+// Ожидаемые операции ввода-вывода и таймеры поверх реактора
+// (core_event_loop_t). Результат операции — как у системного вызова, но
+// ошибка возвращается как -errno: 0 у чтения — конец потока.
+//
+//   Reactor reactor;
+//   reactor.start();                                   // свой поток
+//   Socket conn(reactor, fd);                          // fd переводится в O_NONBLOCK
+//   ssize_t n = co_await conn.read(buf, sizeof(buf));
+//   co_await sleep_for(reactor, std::chrono::milliseconds(5));
+//   ssize_t m = co_await read_file(reactor, file_fd, buf, sizeof(buf), 0);
+//
+// Сопрограмма продолжается на исполнителе, текущем в момент ожидания
+// (current_executor); если его нет — в потоке реактора. Операцию можно
+// начинать из любого потока; на одном сокете одновременно — не больше одного
+// чтения и одной записи.
+
+namespace core {
+namespace async {
+
+class Reactor {
+public:
+    // backend — CORE_EV_BACKEND_EPOLL или CORE_EV_BACKEND_IO_URING
+    explicit Reactor(int backend = CORE_EV_BACKEND_EPOLL) {
+        if (core_event_loop_create_with(backend, &loop_) != CORE_SUCCESS) {
+            throw std::runtime_error("Failed to create event loop");
+        }
+    }
+    ~Reactor() {
+        stop();
+        core_event_loop_destroy(loop_);
+    }
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    // Крутит цикл в вызывающем потоке до stop()
+    void run() {
+        ExecutorScope scope(executor());
+        core_event_loop_run(loop_);
+    }
+    void start() {
+        if (!thread_.joinable()) thread_ = std::thread([this] { run(); });
+    }
+    void stop() {
+        core_event_loop_stop(loop_);
+        if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) thread_.join();
+    }
+
+    Executor executor() noexcept { return Executor{&Reactor::post_handle, this}; }
+    core_event_loop_t* loop() const noexcept { return loop_; }
+    bool in_loop_thread() const noexcept { return core_event_loop_in_loop_thread(loop_) != 0; }
+
+    // Возобновление после события: на запомненном исполнителе, а если он
+    // пуст или это сам реактор — сразу, без лишнего прохода через очередь
+    void resume(const Executor& executor, std::coroutine_handle<> handle) {
+        if (!executor || (executor.ctx == this && in_loop_thread())) {
+            handle.resume();
+        } else {
+            executor.post(executor.ctx, handle);
+        }
+    }
+
+    // fn(ctx) в потоке цикла; сразу, если уже в нём
+    void run_in_loop(core_event_fn fn, void* ctx) {
+        if (in_loop_thread()) {
+            fn(ctx);
+        } else if (core_event_loop_post(loop_, fn, ctx) != CORE_SUCCESS) {
+            throw std::bad_alloc();
+        }
+    }
+
+private:
+    static void resume_address(void* address) { std::coroutine_handle<>::from_address(address).resume(); }
+    static void post_handle(void* ctx, std::coroutine_handle<> handle) {
+        auto* self = static_cast<Reactor*>(ctx);
+        if (core_event_loop_post(self->loop_, &Reactor::resume_address, handle.address()) != CORE_SUCCESS) {
+            throw std::bad_alloc();
+        }
+    }
+
+    core_event_loop_t* loop_ = nullptr;
+    std::thread thread_;
+};
+
+// Таймер: сопрограмма спит до срока по core_task_now_ns
+inline auto sleep_until(Reactor& reactor, uint64_t deadline_ns) {
+    struct awaiter {
+        Reactor& reactor;
+        uint64_t deadline_ns;
+        Executor executor;
+        std::coroutine_handle<> handle;
+
+        bool await_ready() const noexcept { return deadline_ns <= core_task_now_ns(); }
+        void await_suspend(std::coroutine_handle<> h) {
+            handle = h;
+            executor = current_executor;
+            reactor.run_in_loop(&awaiter::arm, this);
+        }
+        void await_resume() const noexcept {}
+
+        static void arm(void* ctx) {
+            auto* self = static_cast<awaiter*>(ctx);
+            if (core_event_loop_add_timer(self->reactor.loop(), self->deadline_ns, &awaiter::fire, self, nullptr) !=
+                CORE_SUCCESS) {
+                fire(self);   // без памяти под таймер — просыпаемся сразу
+            }
+        }
+        static void fire(void* ctx) {
+            auto* self = static_cast<awaiter*>(ctx);
+            self->reactor.resume(self->executor, self->handle);
+        }
+    };
+    return awaiter{reactor, deadline_ns, {}, {}};
+}
+
+template<typename Rep, typename Period>
+auto sleep_for(Reactor& reactor, std::chrono::duration<Rep, Period> duration) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    return sleep_until(reactor, core_task_now_ns() + static_cast<uint64_t>(ns > 0 ? ns : 0));
+}
+
+namespace detail {
+
+// Блокирующая операция с файлом во вспомогательном потоке реактора
+template<typename Op>
+auto offload_io(Reactor& reactor, Op op) {
+    struct awaiter {
+        Reactor& reactor;
+        Op op;
+        ssize_t result = 0;
+        Executor executor;
+        std::coroutine_handle<> handle;
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) {
+            handle = h;
+            executor = current_executor;
+            if (core_event_loop_offload(reactor.loop(), &awaiter::work, &awaiter::done, this) != CORE_SUCCESS) {
+                result = -ENOMEM;
+                return false;
+            }
+            return true;
+        }
+        ssize_t await_resume() const noexcept { return result; }
+
+        static void work(void* ctx) {
+            auto* self = static_cast<awaiter*>(ctx);
+            self->result = self->op();
+        }
+        static void done(void* ctx) {
+            auto* self = static_cast<awaiter*>(ctx);
+            self->reactor.resume(self->executor, self->handle);
+        }
+    };
+    return awaiter{reactor, std::move(op), 0, {}, {}};
+}
+
+inline ssize_t result_or_errno(ssize_t r) { return r < 0 ? -errno : r; }
+
+} // namespace detail
+
+inline auto read_file(Reactor& reactor, int fd, void* buf, size_t len, off_t offset) {
+    return detail::offload_io(reactor, [=] { return detail::result_or_errno(::pread(fd, buf, len, offset)); });
+}
+
+inline auto write_file(Reactor& reactor, int fd, const void* buf, size_t len, off_t offset) {
+    return detail::offload_io(reactor, [=] { return detail::result_or_errno(::pwrite(fd, buf, len, offset)); });
+}
+
+// Неблокирующий сокет в реакторе. Готовность по фронту на каждое
+// направление — маленький автомат IDLE/READY/WAITING: событие без ожидающего
+// оставляет READY, и следующая операция повторяет вызов вместо сна, так что
+// фронт, пришедший между EAGAIN и постановкой на ожидание, не теряется.
+// Повтор после пробуждения делает поток реактора, а сопрограмма возобновляется
+// уже с готовым результатом.
+class Socket {
+public:
+    Socket(Reactor& reactor, int fd) : state_(std::make_unique<State>()) {
+        state_->reactor = &reactor;
+        state_->fd = fd;
+        int flags = ::fcntl(fd, F_GETFL, 0);
+        if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0 ||
+            core_event_loop_add_fd(reactor.loop(), fd, &Socket::on_event, state_.get(), &state_->watch) !=
+                CORE_SUCCESS) {
+            throw std::runtime_error("Failed to register socket with reactor");
+        }
+    }
+    Socket(Socket&&) noexcept = default;
+    Socket& operator=(Socket&& other) noexcept {
+        if (this != &other) {
+            close();
+            state_ = std::move(other.state_);
+        }
+        return *this;
+    }
+    ~Socket() { close(); }
+
+    int fd() const noexcept { return state_ ? state_->fd : -1; }
+
+    // Ожидающих операций на сокете к этому моменту быть не должно. Состояние
+    // освобождает цикл: события, уже выбранные им, ещё могут до него дойти
+    void close() noexcept {
+        if (!state_) return;
+        core_event_loop_t* loop = state_->reactor->loop();
+        core_event_loop_remove_fd(loop, state_->watch);
+        ::close(state_->fd);
+        state_->fd = -1;
+        if (core_event_loop_post(loop, &Socket::release, state_.get()) == CORE_SUCCESS) {
+            state_.release();
+        }
+    }
+
+    auto read(void* buf, size_t len) {
+        return Op<ReadOp>{state_.get(), kRead, ReadOp{buf, len}};
+    }
+    // Частичная запись возможна — см. write_all
+    auto write(const void* buf, size_t len) {
+        return Op<WriteOp>{state_.get(), kWrite, WriteOp{buf, len}};
+    }
+    // Принятое соединение (уже неблокирующее) или -errno
+    auto accept() {
+        return Op<AcceptOp>{state_.get(), kRead, AcceptOp{}};
+    }
+    auto connect(const sockaddr* addr, socklen_t addrlen) {
+        return Op<ConnectOp>{state_.get(), kWrite, ConnectOp{addr, addrlen}};
+    }
+
+    task<ssize_t> write_all(const void* buf, size_t len) {
+        const char* p = static_cast<const char*>(buf);
+        size_t done = 0;
+        while (done < len) {
+            ssize_t n = co_await write(p + done, len - done);
+            if (n < 0) co_return n;
+            done += static_cast<size_t>(n);
+        }
+        co_return static_cast<ssize_t>(done);
+    }
+
+private:
+    enum { kRead = 0, kWrite = 1 };
+    enum { kIdle = 0, kReady = 1, kWaiting = 2 };
+
+    struct Wait {
+        ssize_t (*attempt)(Wait* self, int fd);
+        ssize_t result = 0;
+        Executor executor;
+        std::coroutine_handle<> handle;
+    };
+
+    struct State {
+        Reactor* reactor = nullptr;
+        int fd = -1;
+        core_event_watch_t* watch = nullptr;
+        std::atomic<int> readiness[2] = {kIdle, kIdle};
+        Wait* waiter[2] = {nullptr, nullptr};
+    };
+
+    // true — ожидающий поставлен и будет завершён событием; false — операция
+    // завершилась сейчас, результат в w->result
+    static bool park(State* s, int dir, Wait* w) {
+        s->waiter[dir] = w;
+        for (;;) {
+            int expected = kIdle;
+            if (s->readiness[dir].compare_exchange_strong(expected, kWaiting, std::memory_order_acq_rel,
+                                                          std::memory_order_acquire)) {
+                return true;
+            }
+            s->readiness[dir].exchange(kIdle, std::memory_order_acquire);
+            w->result = w->attempt(w, s->fd);
+            if (w->result != -EAGAIN && w->result != -EWOULDBLOCK) return false;
+        }
+    }
+
+    static void on_ready(State* s, int dir) {
+        if (s->readiness[dir].exchange(kReady, std::memory_order_acq_rel) != kWaiting) return;
+        Wait* w = s->waiter[dir];
+        if (!park(s, dir, w)) s->reactor->resume(w->executor, w->handle);
+    }
+
+    static void release(void* ctx) { delete static_cast<State*>(ctx); }
+
+    static void on_event(void* ctx, uint32_t events) {
+        auto* s = static_cast<State*>(ctx);
+        if (events & CORE_EV_READ) on_ready(s, kRead);
+        if (events & CORE_EV_WRITE) on_ready(s, kWrite);
+    }
+
+    template<typename Impl>
+    struct Op : Wait {
+        State* state;
+        int dir;
+        Impl impl;
+
+        Op(State* s, int d, Impl i) : Wait{&Op::attempt_impl, 0, {}, {}}, state(s), dir(d), impl(i) {}
+
+        static ssize_t attempt_impl(Wait* self, int fd) { return static_cast<Op*>(self)->impl(fd); }
+
+        bool await_ready() {
+            result = impl(state->fd);
+            return result != -EAGAIN && result != -EWOULDBLOCK;
+        }
+        bool await_suspend(std::coroutine_handle<> h) {
+            handle = h;
+            executor = current_executor;
+            return park(state, dir, this);
+        }
+        ssize_t await_resume() const noexcept { return result; }
+    };
+
+    struct ReadOp {
+        void* buf;
+        size_t len;
+        ssize_t operator()(int fd) const { return detail::result_or_errno(::recv(fd, buf, len, 0)); }
+    };
+    struct WriteOp {
+        const void* buf;
+        size_t len;
+        ssize_t operator()(int fd) const {
+            return detail::result_or_errno(::send(fd, buf, len, MSG_NOSIGNAL));
+        }
+    };
+    struct AcceptOp {
+        ssize_t operator()(int fd) const {
+            return detail::result_or_errno(::accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC));
+        }
+    };
+    // Первый вызов начинает соединение, следующие проверяют его: готовность
+    // на запись бывает и у ещё не соединённого сокета, поэтому успех — только
+    // когда у сокета появился адрес второй стороны
+    struct ConnectOp {
+        const sockaddr* addr;
+        socklen_t addrlen;
+        bool started = false;
+        ssize_t operator()(int fd) {
+            if (!started) {
+                started = true;
+                if (::connect(fd, addr, addrlen) == 0) return 0;
+                return errno == EINPROGRESS ? -EAGAIN : -errno;
+            }
+            int error = 0;
+            socklen_t size = sizeof(error);
+            if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &size) < 0) return -errno;
+            if (error != 0) return -error;
+            sockaddr_storage peer;
+            socklen_t peer_len = sizeof(peer);
+            if (::getpeername(fd, reinterpret_cast<sockaddr*>(&peer), &peer_len) == 0) return 0;
+            return errno == ENOTCONN ? -EAGAIN : -errno;
+        }
+    };
+
+    std::unique_ptr<State> state_;
+};
+
+} // namespace async
+} // namespace core
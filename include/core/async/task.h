@@ -0,0 +1,405 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Сопрограммы поверх движков: task<T> — ленивая задача, которая начинает
+// исполняться при co_await и по завершении передаёт управление ожидающему
+// без рекурсии (симметричная передача). Где продолжится сопрограмма после
+// ожидания ввода-вывода или таймера, решает исполнитель (Executor), текущий
+// в момент ожидания: реактор, ядро MultiCoreEngine или любой другой.
+//
+//   core::async::task<size_t> handle(Socket& s) {
+//       char buf[4096];
+//       ssize_t n = co_await s.read(buf, sizeof(buf));
+//       co_await core::async::schedule(engine.executor(core_id));  // на ядро
+//       co_return process(buf, n);
+//   }
+//   auto [a, b] = co_await when_all(handle(s1), handle(s2));
+//
+// Ожидающий у задачи один; задача, которую ни разу не ждали, уничтожается
+// вместе с объектом task, так и не начавшись.
+
+namespace core {
+namespace async {
+
+// Куда возобновлять сопрограмму: post ставит handle.resume() в очередь своего
+// исполнителя. Пустой исполнитель возобновляет на месте.
+struct Executor {
+    void (*post)(void* ctx, std::coroutine_handle<> handle) = nullptr;
+    void* ctx = nullptr;
+
+    explicit operator bool() const noexcept { return post != nullptr; }
+    void resume(std::coroutine_handle<> handle) const {
+        if (post) {
+            post(ctx, handle);
+        } else {
+            handle.resume();
+        }
+    }
+    friend bool operator==(const Executor& a, const Executor& b) noexcept {
+        return a.post == b.post && a.ctx == b.ctx;
+    }
+};
+
+// Исполнитель потока, в котором идёт код; его выставляют реактор и рабочие
+// потоки MultiCoreEngine, ожидающие операции запоминают его
+inline thread_local Executor current_executor{};
+
+// Выставляет current_executor на время области видимости
+class ExecutorScope {
+public:
+    explicit ExecutorScope(Executor executor) noexcept : saved_(current_executor) {
+        current_executor = executor;
+    }
+    ~ExecutorScope() { current_executor = saved_; }
+    ExecutorScope(const ExecutorScope&) = delete;
+    ExecutorScope& operator=(const ExecutorScope&) = delete;
+
+private:
+    Executor saved_;
+};
+
+template<typename T = void>
+class task;
+
+namespace detail {
+
+template<typename T>
+struct promise_result {
+    std::variant<std::monostate, T, std::exception_ptr> result;
+
+    template<typename U>
+    void return_value(U&& value) {
+        result.template emplace<1>(std::forward<U>(value));
+    }
+    void unhandled_exception() noexcept { result.template emplace<2>(std::current_exception()); }
+    T take() {
+        if (result.index() == 2) std::rethrow_exception(std::get<2>(result));
+        return std::move(std::get<1>(result));
+    }
+};
+
+template<>
+struct promise_result<void> {
+    std::exception_ptr error;
+
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+    void take() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+template<typename T>
+struct task_promise : promise_result<T> {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+
+    task<T> get_return_object() noexcept;
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct final_awaiter {
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<task_promise> h) noexcept {
+            return h.promise().continuation;
+        }
+        void await_resume() const noexcept {}
+    };
+    final_awaiter final_suspend() noexcept { return {}; }
+};
+
+// Сопрограмма без владельца: стартует сразу и уничтожает себя по завершении
+struct detached {
+    struct promise_type {
+        detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+// void в кортежах и векторах результатов
+template<typename T>
+using result_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+} // namespace detail
+
+template<typename T>
+class [[nodiscard]] task {
+public:
+    using promise_type = detail::task_promise<T>;
+    using value_type = T;
+
+    task() noexcept = default;
+    explicit task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+    task(task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    task& operator=(task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+    ~task() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool valid() const noexcept { return static_cast<bool>(handle_); }
+    bool done() const noexcept { return !handle_ || handle_.done(); }
+
+    auto operator co_await() && noexcept {
+        struct awaiter {
+            std::coroutine_handle<promise_type> handle;
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> waiter) noexcept {
+                handle.promise().continuation = waiter;
+                return handle;
+            }
+            T await_resume() { return handle.promise().take(); }
+        };
+        return awaiter{handle_};
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template<typename T>
+task<T> detail::task_promise<T>::get_return_object() noexcept {
+    return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+// Переход на исполнителя: всё после co_await schedule(e) идёт там
+inline auto schedule(Executor executor) noexcept {
+    struct awaiter {
+        Executor executor;
+        bool await_ready() const noexcept { return !executor; }
+        void await_suspend(std::coroutine_handle<> handle) const { executor.post(executor.ctx, handle); }
+        void await_resume() const noexcept {}
+    };
+    return awaiter{executor};
+}
+
+// Запуск без ожидания: задача исполняется до первой приостановки в текущем
+// потоке (или сразу на исполнителе executor) и освобождается по завершении.
+// Исключение из неё завершает процесс, как исключение из std::thread.
+inline void spawn(task<void> t, Executor executor = {}) {
+    [](task<void> t, Executor executor) -> detail::detached {
+        co_await schedule(executor);
+        co_await std::move(t);
+    }(std::move(t), executor);
+}
+
+// Блокирует вызывающий поток (не сопрограмму) до завершения задачи
+template<typename T>
+T sync_wait(task<T> t) {
+    // Сигнал под мьютексом: ожидающий не выйдет, пока завершившая сторона
+    // ещё держит ссылки на его стек
+    struct Completion {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done = false;
+        std::optional<detail::result_t<T>> value;
+        std::exception_ptr error;
+    } completion;
+    [](task<T> t, Completion& c) -> detail::detached {
+        std::optional<detail::result_t<T>> value;
+        std::exception_ptr error;
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(t);
+                value.emplace();
+            } else {
+                value.emplace(co_await std::move(t));
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(c.mutex);
+        c.value = std::move(value);
+        c.error = error;
+        c.done = true;
+        c.cv.notify_one();
+    }(std::move(t), completion);
+    std::unique_lock<std::mutex> lock(completion.mutex);
+    completion.cv.wait(lock, [&] { return completion.done; });
+    if (completion.error) std::rethrow_exception(completion.error);
+    if constexpr (!std::is_void_v<T>) return std::move(*completion.value);
+}
+
+namespace detail {
+
+// Общее ожидание для when_all: счётчик на единицу больше числа задач, эту
+// единицу снимает сам await_suspend после запуска всех — задача, завершившаяся
+// синхронно, не возобновит ожидающего раньше времени
+struct when_all_latch {
+    std::atomic<size_t> remaining;
+    std::coroutine_handle<> waiter;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    explicit when_all_latch(size_t count) : remaining(count + 1) {}
+    void fail(std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::move(e);
+    }
+    void arrive() {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) waiter.resume();
+    }
+};
+
+template<typename T>
+detached when_all_child(when_all_latch& latch, task<T>& t, std::optional<result_t<T>>& slot) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(t);
+            slot.emplace();
+        } else {
+            slot.emplace(co_await std::move(t));
+        }
+    } catch (...) {
+        latch.fail(std::current_exception());
+    }
+    latch.arrive();
+}
+
+template<typename Start>
+auto when_all_wait(when_all_latch& latch, Start start) {
+    struct awaiter {
+        when_all_latch& latch;
+        Start start;
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle) {
+            latch.waiter = handle;
+            start();
+            return latch.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+        void await_resume() const {
+            if (latch.error) std::rethrow_exception(latch.error);
+        }
+    };
+    return awaiter{latch, std::move(start)};
+}
+
+} // namespace detail
+
+// Все задачи сразу; результат — кортеж (void → std::monostate). Первое
+// исключение пробрасывается, но только после завершения всех задач.
+template<typename... Ts>
+task<std::tuple<detail::result_t<Ts>...>> when_all(task<Ts>... tasks) {
+    detail::when_all_latch latch(sizeof...(Ts));
+    std::tuple<std::optional<detail::result_t<Ts>>...> slots;
+    std::tuple<task<Ts>...> owned(std::move(tasks)...);
+    co_await detail::when_all_wait(latch, [&] {
+        std::apply([&](auto&... t) {
+            std::apply([&](auto&... slot) { (detail::when_all_child(latch, t, slot), ...); }, slots);
+        }, owned);
+    });
+    co_return std::apply([](auto&... slot) { return std::make_tuple(std::move(*slot)...); }, slots);
+}
+
+template<typename T>
+task<std::vector<detail::result_t<T>>> when_all(std::vector<task<T>> tasks) {
+    detail::when_all_latch latch(tasks.size());
+    std::vector<std::optional<detail::result_t<T>>> slots(tasks.size());
+    co_await detail::when_all_wait(latch, [&] {
+        for (size_t i = 0; i < tasks.size(); ++i) detail::when_all_child(latch, tasks[i], slots[i]);
+    });
+    std::vector<detail::result_t<T>> results;
+    results.reserve(slots.size());
+    for (auto& slot : slots) results.push_back(std::move(*slot));
+    co_return results;
+}
+
+template<typename T>
+struct when_any_result {
+    size_t index;
+    detail::result_t<T> value;
+};
+
+namespace detail {
+
+// Состояние when_any живёт, пока не завершится последняя задача: проигравшие
+// доигрывают уже после того, как ожидающий продолжил работу
+template<typename T>
+struct when_any_state {
+    std::vector<task<T>> tasks;
+    std::atomic<bool> decided{false};
+    std::atomic<int> resume_votes{2};   // победитель и сам await_suspend
+    std::coroutine_handle<> waiter;
+    size_t index = 0;
+    std::optional<result_t<T>> value;
+    std::exception_ptr error;
+
+    void vote() {
+        if (resume_votes.fetch_sub(1, std::memory_order_acq_rel) == 1) waiter.resume();
+    }
+};
+
+template<typename T>
+detached when_any_child(std::shared_ptr<when_any_state<T>> state, size_t i) {
+    std::optional<result_t<T>> value;
+    std::exception_ptr error;
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(state->tasks[i]);
+            value.emplace();
+        } else {
+            value.emplace(co_await std::move(state->tasks[i]));
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    if (!state->decided.exchange(true, std::memory_order_acq_rel)) {
+        state->index = i;
+        state->value = std::move(value);
+        state->error = error;
+        state->vote();
+    }
+}
+
+} // namespace detail
+
+// Первая завершившаяся задача: её номер и результат (или исключение).
+// Остальные не отменяются — они доработают сами, результаты отбрасываются.
+template<typename T>
+task<when_any_result<T>> when_any(std::vector<task<T>> tasks) {
+    if (tasks.empty()) throw std::invalid_argument("when_any of no tasks");
+    auto state = std::make_shared<detail::when_any_state<T>>();
+    state->tasks = std::move(tasks);
+
+    struct awaiter {
+        const std::shared_ptr<detail::when_any_state<T>>& state;
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle) {
+            state->waiter = handle;
+            for (size_t i = 0; i < state->tasks.size(); ++i) {
+                if (state->decided.load(std::memory_order_acquire)) break;
+                detail::when_any_child(state, i);
+            }
+            return state->resume_votes.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+        void await_resume() const {}
+    };
+    co_await awaiter{state};
+    if (state->error) std::rethrow_exception(state->error);
+    co_return when_any_result<T>{state->index, std::move(*state->value)};
+}
+
+} // namespace async
+} // namespace core
@@ -12,9 +12,12 @@
 #include <future>
 #include <chrono>
 #include <bitset>
+#include <type_traits>
 #include <immintrin.h>
 #include <arm_neon.h>
 
+#include "core/optimization/simd_ops.h"
+
 namespace core {
 
 // Cache line size for alignment
@@ -157,34 +160,54 @@ private:
 };
 
 // SIMD-optimized operations
+// Thin typed front-end over the C kernels in core/optimization/simd_ops.h,
+// which handle remainders with masked tails; other types use scalar loops.
 class SIMDOperations {
 public:
     template<typename T>
     static void vector_add(T* dst, const T* src1, const T* src2, size_t count) {
-#ifdef __AVX2__
         if constexpr (std::is_same_v<T, float>) {
-            for (size_t i = 0; i < count; i += 8) {
-                __m256 a = _mm256_loadu_ps(&src1[i]);
-                __m256 b = _mm256_loadu_ps(&src2[i]);
-                __m256 c = _mm256_add_ps(a, b);
-                _mm256_storeu_ps(&dst[i], c);
-            }
+            core_vector_add_f32(dst, src1, src2, count);
+        } else if constexpr (std::is_same_v<T, int32_t>) {
+            core_vector_add_i32(dst, src1, src2, count);
+        } else {
+            for (size_t i = 0; i < count; ++i) dst[i] = src1[i] + src2[i];
         }
-#elif defined(__ARM_NEON)
+    }
+
+    template<typename T>
+    static void vector_sub(T* dst, const T* src1, const T* src2, size_t count) {
         if constexpr (std::is_same_v<T, float>) {
-            for (size_t i = 0; i < count; i += 4) {
-                float32x4_t a = vld1q_f32(&src1[i]);
-                float32x4_t b = vld1q_f32(&src2[i]);
-                float32x4_t c = vaddq_f32(a, b);
-                vst1q_f32(&dst[i], c);
-            }
+            core_vector_sub_f32(dst, src1, src2, count);
+        } else if constexpr (std::is_same_v<T, int32_t>) {
+            core_vector_sub_i32(dst, src1, src2, count);
+        } else {
+            for (size_t i = 0; i < count; ++i) dst[i] = src1[i] - src2[i];
         }
-#endif
     }
 
-    // Add more SIMD-optimized operations here
-};
+    template<typename T>
+    static void vector_mul(T* dst, const T* src1, const T* src2, size_t count) {
+        if constexpr (std::is_same_v<T, float>) {
+            core_vector_mul_f32(dst, src1, src2, count);
+        } else if constexpr (std::is_same_v<T, int32_t>) {
+            core_vector_mul_i32(dst, src1, src2, count);
+        } else {
+            for (size_t i = 0; i < count; ++i) dst[i] = src1[i] * src2[i];
+        }
+    }
 
+    template<typename T>
+    static T vector_sum(const T* src, size_t count) {
+        if constexpr (std::is_same_v<T, float>) {
+            return core_vector_sum_f32(src, count);
+        } else {
+            T result = T();
+            for (size_t i = 0; i < count; ++i) result += src[i];
+            return result;
+        }
+    }
+};
 // Core optimizer class
 class CoreOptimizer {
 public:
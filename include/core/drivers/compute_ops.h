@@ -20,7 +20,8 @@ float core_compute_vector_length(const float* vector, size_t size);
 // Оптимизированные матричные операции
 void core_compute_matrix_add(const float* a, const float* b, float* result, size_t rows, size_t cols);
 void core_compute_matrix_sub(const float* a, const float* b, float* result, size_t rows, size_t cols);
-void core_compute_matrix_mul(const float* a, const float* b, float* result,
+// Возвращает статус core_gemm_f32 (CORE_SUCCESS, CORE_ERR_INVALID или CORE_ERR_NOMEM)
+int core_compute_matrix_mul(const float* a, const float* b, float* result,
                            size_t a_rows, size_t a_cols, size_t b_cols);
 void core_compute_matrix_transpose(const float* matrix, float* result, size_t rows, size_t cols);
 void core_compute_matrix_inverse(const float* matrix, float* result, size_t size);
@@ -66,7 +67,10 @@ void core_compute_bilateral_filter(const float* input, float* output, size_t wid
 void core_compute_median_filter(const float* input, float* output, size_t width, size_t height,
                               size_t kernel_size);
 
-// Оптимизированные операции с преобразованиями
+// Оптимизированные операции с преобразованиями.
+// fft/ifft: size комплексных точек (re, im), т.е. 2*size float'ов; ifft нормирована на 1/size.
+// dct — ДКП-II без нормировки, idct — его точное обращение (ДКП-III).
+// Пакетные и вещественные варианты — в fft_ops.h.
 void core_compute_fft(const float* input, float* output, size_t size);
 void core_compute_ifft(const float* input, float* output, size_t size);
 void core_compute_dct(const float* input, float* output, size_t size);
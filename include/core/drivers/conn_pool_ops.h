@@ -0,0 +1,70 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Пул TCP-соединений по конечным точкам (host:port). Освобождённое
+// соединение не закрывается, а ждёт следующего запроса к той же точке:
+// сначала в кэше потока (ячейки без блокировок, поток берёт своё же
+// соединение обратно одной атомарной операцией), затем в общем списке
+// точки под её мьютексом и в кэшах других потоков. Перед выдачей простаивавшее соединение
+// проверяется: не истёк ли срок простоя и не закрыла ли его вторая сторона.
+// Число открытых соединений к одной точке ограничено; запрос сверх предела
+// ждёт освобождения до своего таймаута.
+typedef struct core_conn_pool core_conn_pool_t;
+typedef struct core_pooled_conn core_pooled_conn_t;
+
+typedef struct {
+    uint32_t max_per_host;          // открытых соединений к точке, включая выданные
+    uint32_t max_idle_per_host;     // простаивающих в общем списке точки
+    uint64_t idle_timeout_ns;       // простоявшее дольше закрывается
+    uint64_t connect_timeout_ns;    // connect и ожидание места, если запрос не задал свой
+    uint32_t keepalive_idle_s;      // TCP keep-alive: тишина до первой пробы (0 — выключен)
+    uint32_t keepalive_interval_s;  // между пробами
+    uint32_t keepalive_probes;      // неотвеченных проб до разрыва
+} core_conn_pool_config_t;
+
+typedef struct {
+    uint64_t connects;              // установлено новых соединений
+    uint64_t reuses;                // выдано простаивавших
+    uint64_t validation_failures;   // отброшено проверкой при выдаче
+    uint64_t reaped;                // закрыто уборкой
+    uint64_t open;                  // открыто сейчас, включая выданные
+    uint64_t idle;                  // из них простаивают в пуле
+} core_conn_pool_stats_t;
+
+// 64 на точку, 16 простаивающих, простой 60 с, connect 3 с, keep-alive 30/10/3
+void core_conn_pool_default_config(core_conn_pool_config_t* config);
+
+// Нулевые поля config заменяются значениями по умолчанию
+int core_conn_pool_create(const core_conn_pool_config_t* config, core_conn_pool_t** pool);
+// Закрывает простаивающие соединения. Выданные должны быть возвращены раньше.
+void core_conn_pool_destroy(core_conn_pool_t* pool);
+
+// Соединение с host:port — из пула или новое (в блокирующем режиме, с
+// TCP_NODELAY и keep-alive). host — адрес или имя; имя разрешается один раз
+// при первом обращении к точке. timeout_ns == 0 — connect_timeout_ns.
+// CORE_ERR_NOTFOUND — адрес не разрешился, CORE_ERR_INTERNAL — connect не
+// удался, CORE_ERR_NOMEM — предел точки не освободился за таймаут.
+int core_conn_pool_acquire(core_conn_pool_t* pool, const char* host, uint16_t port, uint64_t timeout_ns,
+                           core_pooled_conn_t** conn);
+// Возврат в пул. reusable == 0 (ошибка ввода-вывода, недочитанный ответ) —
+// соединение закрывается. Режим сокета пул не восстанавливает.
+void core_conn_pool_release(core_conn_pool_t* pool, core_pooled_conn_t* conn, int reusable);
+
+int core_pooled_conn_fd(const core_pooled_conn_t* conn);
+// 1, если соединение простаивало в пуле, 0 — только что установлено
+int core_pooled_conn_reused(const core_pooled_conn_t* conn);
+
+// Закрывает простоявшие дольше idle_timeout_ns и закрытые второй стороной.
+// Возвращает число закрытых. Вызывается периодически из любого потока.
+size_t core_conn_pool_reap(core_conn_pool_t* pool);
+
+void core_conn_pool_stats(const core_conn_pool_t* pool, core_conn_pool_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
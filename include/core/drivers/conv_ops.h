@@ -0,0 +1,61 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "core/drivers/parallel_ops.h"
+
+// Свёртки float без выхода за границы ("valid"), в том же смысле, что и
+// ComputeManager::convolution: out[y][x] = sum in[y + r][x + c] * kernel[r][c],
+// выход (height - kernel_h + 1) x (width - kernel_w + 1). Ядро не отражается.
+//
+// Алгоритмы:
+//   прямой     — векторизованный по выходам цикл, для малых ядер;
+//   Винограда  — F(2x2, 3x3) только для ядер 3x3: преобразованные тайлы
+//                перемножаются GEMM'ом по каналам, выгоден при многих каналах;
+//   БПФ        — overlap-save по строкам: спектры отрезков строк входа
+//                умножаются на спектры строк ядра и суммируются по строкам ядра
+//                и входным каналам, одно обратное БПФ на отрезок выхода.
+//                Планы берутся из общего кэша fft_ops. Для больших ядер.
+// CORE_CONV_AUTO выбирает алгоритм по оценке стоимости (core_conv_select).
+//
+// Работа делится на задачи исполнителя (NULL — в вызывающем потоке).
+// in и out не должны перекрываться. Возвращают CORE_SUCCESS, CORE_ERR_INVALID
+// (в том числе ядро больше входа или Винограда не для 3x3) или CORE_ERR_NOMEM.
+#define CORE_CONV_AUTO     0
+#define CORE_CONV_DIRECT   1
+#define CORE_CONV_WINOGRAD 2
+#define CORE_CONV_FFT      3
+
+// Алгоритм с наименьшей оценкой стоимости для данной формы задачи
+int core_conv_select(size_t width, size_t height, size_t kernel_w, size_t kernel_h,
+                     size_t in_channels, size_t out_channels);
+
+// Одномерная свёртка: in_size - kernel_size + 1 выходов
+int core_conv1d_f32(const float* in, size_t in_size, const float* kernel, size_t kernel_size,
+                    float* out, int algorithm, const core_executor_t* executor);
+
+// count сигналов с одним ядром; in_dist/out_dist — расстояние между соседними
+// сигналами во float'ах. Спектр ядра при БПФ считается один раз на пакет.
+int core_conv1d_f32_batch(size_t count, const float* in, size_t in_dist, size_t in_size,
+                          const float* kernel, size_t kernel_size, float* out, size_t out_dist,
+                          int algorithm, const core_executor_t* executor);
+
+// Двумерная свёртка одного канала; in_stride/out_stride — шаг строки в элементах
+int core_conv2d_f32(const float* in, size_t in_stride, size_t width, size_t height,
+                    const float* kernel, size_t kernel_w, size_t kernel_h,
+                    float* out, size_t out_stride, int algorithm, const core_executor_t* executor);
+
+// Многоканальная: out[o] = sum_i conv2d(in[i], kernels[o][i]). Плоскости лежат
+// подряд без выравнивания строк: вход in_channels x height x width, выход
+// out_channels x (height - kernel_h + 1) x (width - kernel_w + 1), ядра
+// out_channels x in_channels x kernel_h x kernel_w.
+int core_conv2d_f32_multi(const float* in, size_t in_channels, size_t width, size_t height,
+                          const float* kernels, size_t kernel_w, size_t kernel_h,
+                          float* out, size_t out_channels, int algorithm,
+                          const core_executor_t* executor);
+
+#ifdef __cplusplus
+}
+#endif
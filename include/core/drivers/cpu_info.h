@@ -4,6 +4,7 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include "core/cache/cache_types.h"
 
 // CPU feature flags
 #define CORE_CPU_X86_64 1
@@ -13,6 +14,10 @@ int core_cpu_arch(); // Возвращает CORE_CPU_X86_64 или CORE_CPU_ARM
 int core_cpu_has_avx2();
 int core_cpu_has_neon();
 
+// Конфигурация кэшей данных (L1d, L2, L3) из /sys/devices/system/cpu/cpu0/cache,
+// с откатом на sysconf и типичные значения. Результат кэшируется после первого вызова.
+int core_cpu_cache_config(core_cache_config_t* config);
+
 #ifdef __cplusplus
 }
 #endif 
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Цикл событий (реактор): готовность дескрипторов через epoll в режиме по
+// фронту, таймеры на двоичной куче и очередь функций от других потоков.
+// Цикл крутит один поток (core_event_loop_run/run_once); обратные вызовы
+// исполняются в нём. Блокирующая работа (файлы) уходит в небольшой пул
+// вспомогательных потоков, а её завершение возвращается в цикл.
+typedef struct core_event_loop core_event_loop_t;
+typedef struct core_event_watch core_event_watch_t;
+
+#define CORE_EV_READ  0x1u
+#define CORE_EV_WRITE 0x2u
+#define CORE_EV_ERROR 0x4u   // ошибка или закрытие второй стороной
+
+typedef void (*core_event_cb)(void* ctx, uint32_t events);
+typedef void (*core_event_fn)(void* ctx);
+
+// Механизм ожидания готовности. io_uring — многоразовые POLL_ADD на кольце
+// вместо epoll_ctl/epoll_wait: подписка и ожидание без отдельного
+// дескриптора epoll, семантика та же (по фронту). Требует ядра 5.13+;
+// иначе CORE_ERR_UNSUPPORTED.
+#define CORE_EV_BACKEND_EPOLL    0
+#define CORE_EV_BACKEND_IO_URING 1
+
+int core_event_loop_create(core_event_loop_t** loop);   // epoll
+int core_event_loop_create_with(int backend, core_event_loop_t** loop);
+int core_event_loop_backend(const core_event_loop_t* loop);
+// Дожидается вспомогательных потоков; невыполненные функции из очереди
+// исполняются, незапущенные таймеры отбрасываются
+void core_event_loop_destroy(core_event_loop_t* loop);
+
+// Подписка на готовность fd на чтение и запись сразу (по фронту): cb
+// вызывается в потоке цикла при каждом новом фронте. Из любого потока.
+int core_event_loop_add_fd(core_event_loop_t* loop, int fd, core_event_cb cb, void* ctx,
+                           core_event_watch_t** watch);
+// Из любого потока. После возврата новых вызовов cb не будет; память
+// подписки освобождается циклом позже. fd не закрывается.
+void core_event_loop_remove_fd(core_event_loop_t* loop, core_event_watch_t* watch);
+
+// Таймер на абсолютный срок по core_task_now_ns. Только из потока цикла
+// (из других — через core_event_loop_post). id для отмены уникален.
+int core_event_loop_add_timer(core_event_loop_t* loop, uint64_t deadline_ns, core_event_fn fn, void* ctx,
+                              uint64_t* timer_id);
+// CORE_ERR_NOTFOUND, если таймер уже сработал или отменён
+int core_event_loop_cancel_timer(core_event_loop_t* loop, uint64_t timer_id);
+
+// Исполнить fn(ctx) в потоке цикла. Из любого потока, без блокировок;
+// будит цикл, если он спит.
+int core_event_loop_post(core_event_loop_t* loop, core_event_fn fn, void* ctx);
+
+// work(ctx) во вспомогательном потоке, затем done(ctx) в потоке цикла
+int core_event_loop_offload(core_event_loop_t* loop, core_event_fn work, core_event_fn done, void* ctx);
+
+// Одна итерация: ждёт событий не дольше timeout_ns (отрицательный — без
+// ограничения, кроме ближайшего таймера), затем исполняет готовые обратные
+// вызовы, функции из очереди и наступившие таймеры. Возвращает их число.
+size_t core_event_loop_run_once(core_event_loop_t* loop, int64_t timeout_ns);
+// Итерации до core_event_loop_stop (из любого потока)
+void core_event_loop_run(core_event_loop_t* loop);
+void core_event_loop_stop(core_event_loop_t* loop);
+
+// Ненулевое, если вызвано из потока, который сейчас крутит цикл
+int core_event_loop_in_loop_thread(const core_event_loop_t* loop);
+
+#ifdef __cplusplus
+}
+#endif
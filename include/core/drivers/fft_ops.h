@@ -0,0 +1,54 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+// Виды планов
+#define CORE_FFT_C2C 0  // комплексное -> комплексное, n точек
+#define CORE_FFT_R2C 1  // вещественное n -> n/2+1 комплексных бинов (и обратно)
+#define CORE_FFT_DCT 2  // ДКП-II (прямое) / ДКП-III (обратное), n точек
+
+// Направление
+#define CORE_FFT_FORWARD 0
+#define CORE_FFT_INVERSE 1
+
+// Комплексные данные хранятся чередованием (re, im). Прямые преобразования
+// не нормируются: X[k] = sum x[j] * exp(-2*pi*i*j*k/n), ДКП-II:
+// X[k] = sum x[j] * cos(pi*k*(2j+1)/(2n)). Обратные — точные обращения прямых
+// (с множителем 1/n). Все функции допускают in == out.
+//
+// План неизменяем после создания и может одновременно использоваться из
+// нескольких потоков; рабочая память выделяется на вызов (на весь пакет).
+typedef struct core_fft_plan core_fft_plan_t;
+
+// Длины с множителями 2, 3, 5 раскладываются в смешанные ступени radix-4/2/3/5,
+// прочие считаются через алгоритм Блюстейна. NULL — при n == 0 или нехватке памяти.
+core_fft_plan_t* core_fft_plan_create(int kind, size_t n);
+void core_fft_plan_destroy(core_fft_plan_t* plan);
+
+// План из общего кэша (по виду и длине); живёт до конца процесса, удалять нельзя.
+const core_fft_plan_t* core_fft_plan_cached(int kind, size_t n);
+size_t core_fft_plan_length(const core_fft_plan_t* plan);
+
+// Одиночные преобразования. Возвращают CORE_SUCCESS, CORE_ERR_INVALID или CORE_ERR_NOMEM.
+int core_fft_c2c(const core_fft_plan_t* plan, const float* in, float* out, int direction);
+int core_fft_r2c(const core_fft_plan_t* plan, const float* in, float* out);
+int core_fft_c2r(const core_fft_plan_t* plan, const float* in, float* out);
+int core_fft_dct(const core_fft_plan_t* plan, const float* in, float* out, int direction);
+
+// Пакетные варианты: count преобразований, in_dist/out_dist — расстояние между
+// соседними преобразованиями во float'ах.
+int core_fft_c2c_batch(const core_fft_plan_t* plan, size_t count, const float* in, size_t in_dist,
+                       float* out, size_t out_dist, int direction);
+int core_fft_r2c_batch(const core_fft_plan_t* plan, size_t count, const float* in, size_t in_dist,
+                       float* out, size_t out_dist);
+int core_fft_c2r_batch(const core_fft_plan_t* plan, size_t count, const float* in, size_t in_dist,
+                       float* out, size_t out_dist);
+int core_fft_dct_batch(const core_fft_plan_t* plan, size_t count, const float* in, size_t in_dist,
+                       float* out, size_t out_dist, int direction);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "core/drivers/parallel_ops.h"
+
+// Фильтры одноканальных float-изображений, хранящихся построчно; in_stride и
+// out_stride — шаг строки в элементах (>= width). За границей изображения
+// повторяются крайние пиксели. Работа делится на полосы строк, которые раздаются
+// исполнителю (NULL — в вызывающем потоке). in и out не должны перекрываться.
+// Возвращают CORE_SUCCESS, CORE_ERR_INVALID или CORE_ERR_NOMEM.
+
+// Раздельный гауссов фильтр с радиусом ceil(3*sigma); sigma <= 0 — копирование.
+int core_filter_gaussian(const float* in, size_t in_stride, float* out, size_t out_stride,
+                         size_t width, size_t height, float sigma, const core_executor_t* executor);
+
+// Билатеральный фильтр: круглое окно радиуса ceil(2*sigma_space), веса по
+// яркости берутся из таблицы на 4*sigma_color (дальше вес 0).
+int core_filter_bilateral(const float* in, size_t in_stride, float* out, size_t out_stride,
+                          size_t width, size_t height, float sigma_space, float sigma_color,
+                          const core_executor_t* executor);
+
+// Медиана в окне kernel_size x kernel_size (чётный размер округляется вверх, не больше 255).
+// До 7x7 — точная, сетью сравнений по SIMD-регистрам; для больших окон — гистограммная
+// за O(1) на пиксель по 256 уровням диапазона [min, max] изображения, так что результат
+// отличается от точной медианы не более чем на (max - min) / 510.
+int core_filter_median(const float* in, size_t in_stride, float* out, size_t out_stride,
+                       size_t width, size_t height, size_t kernel_size, const core_executor_t* executor);
+
+#ifdef __cplusplus
+}
+#endif
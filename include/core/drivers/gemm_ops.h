@@ -0,0 +1,45 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "core/drivers/parallel_ops.h"
+
+// Транспонирование операндов
+#define CORE_GEMM_NO_TRANS 0
+#define CORE_GEMM_TRANS    1
+
+// Параметры блочного разбиения: панель B (kc x nr) живёт в L1, блок A (mc x kc) —
+// в L2, панель B (kc x nc) — в L3. mr x nr — размер регистрового микроблока.
+typedef struct {
+    size_t mc;
+    size_t kc;
+    size_t nc;
+    size_t mr;
+    size_t nr;
+} core_gemm_blocking_t;
+
+// Исполнитель для параллельной обработки макроблоков (см. parallel_ops.h)
+typedef core_executor_t core_gemm_executor_t;
+
+// C = alpha * op(A) * op(B) + beta * C, все матрицы хранятся построчно.
+// op(A) — m x k, op(B) — k x n, C — m x n; lda/ldb/ldc — шаги строк хранимых матриц.
+// executor == NULL означает однопоточное выполнение.
+// Возвращает CORE_SUCCESS, CORE_ERR_INVALID или CORE_ERR_NOMEM.
+int core_gemm_f32(int trans_a, int trans_b, size_t m, size_t n, size_t k,
+                  float alpha, const float* a, size_t lda, const float* b, size_t ldb,
+                  float beta, float* c, size_t ldc, const core_gemm_executor_t* executor);
+int core_gemm_f64(int trans_a, int trans_b, size_t m, size_t n, size_t k,
+                  double alpha, const double* a, size_t lda, const double* b, size_t ldb,
+                  double beta, double* c, size_t ldc, const core_gemm_executor_t* executor);
+
+// Текущее разбиение для элементов размера elem_size (4 или 8). По умолчанию
+// выводится из core_cpu_cache_config; set с NULL возвращает автоматический выбор.
+void core_gemm_get_blocking(size_t elem_size, core_gemm_blocking_t* blocking);
+void core_gemm_set_blocking(const core_gemm_blocking_t* blocking);
+
+#ifdef __cplusplus
+}
+#endif
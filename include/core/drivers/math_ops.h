@@ -3,19 +3,39 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 
-// Оптимизированные математические операции
+// Трансцендентные функции для float: редукция аргумента и минимаксные полиномы,
+// одна реализация на AVX-512 / AVX2 / SSE4.2 / NEON (aarch64) и скалярный путь.
+// Скалярные core_fast_* считают тот же полином, что и векторные core_vector_*.
+// Погрешность — максимум по плотному перебору, в ULP от правильно округлённого
+// результата (проверяется в tests/core/math_ops_tests.cpp):
+//   sin, cos  <= 2.5 ULP при |x| <= 8192; дальше точность редукции падает
+//   exp       <= 1.5 ULP; переполнение в +inf, денормализованные результаты сохраняются
+//   log       <= 1 ULP; log(0) = -inf, log(x < 0) = NaN
+//   tanh      <= 2 ULP
+//   sigmoid   <= 3 ULP
+//   rsqrt     <= 3.5 ULP (аппаратная оценка и шаг Ньютона); sqrt точен
+// NaN на входе дают NaN. dst может совпадать с src.
 float core_fast_sin(float x);
 float core_fast_cos(float x);
 float core_fast_sqrt(float x);
 float core_fast_rsqrt(float x); // Быстрое обратное значение квадратного корня
+float core_fast_exp(float x);
+float core_fast_log(float x);
+float core_fast_tanh(float x);
+float core_fast_sigmoid(float x); // 1 / (1 + exp(-x))
 
 // Векторные математические операции
 void core_vector_sin(float* dst, const float* src, size_t n);
 void core_vector_cos(float* dst, const float* src, size_t n);
 void core_vector_sqrt(float* dst, const float* src, size_t n);
 void core_vector_rsqrt(float* dst, const float* src, size_t n);
+void core_vector_exp(float* dst, const float* src, size_t n);
+void core_vector_log(float* dst, const float* src, size_t n);
+void core_vector_tanh(float* dst, const float* src, size_t n);
+void core_vector_sigmoid(float* dst, const float* src, size_t n);
 
 // Матричные операции
 void core_matrix_multiply_4x4(float* dst, const float* a, const float* b);
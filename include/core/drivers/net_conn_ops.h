@@ -0,0 +1,67 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/drivers/event_loop_ops.h"
+
+// Потоковое соединение в цикле событий: неблокирующие чтение и запись по
+// фронту готовности, очередь отправки с водяными знаками. Чтение и все
+// обратные вызовы — в потоке цикла; отправка и закрытие — из любого потока.
+// Отправка сначала пишет прямо в сокет и ставит в очередь только то, что не
+// поместилось; очередь дописывается по готовности на запись одним writev.
+// Соединение не владеет fd: после on_close дескриптор остаётся открытым.
+typedef struct core_net_conn core_net_conn_t;
+
+typedef struct {
+    // Принятые данные; буфер действителен только на время вызова
+    void (*on_data)(void* ctx, const void* data, size_t size);
+    // Очередь отправки опустилась до low_watermark после отказа CORE_ERR_NOMEM
+    void (*on_drain)(void* ctx);
+    // Последний вызов: error — errno, 0 — закрыто штатно или второй стороной
+    void (*on_close)(void* ctx, int error);
+} core_net_handlers_t;
+
+typedef struct {
+    size_t high_watermark;   // отправка отказывает, пока в очереди не меньше (0 — 1 МиБ)
+    size_t low_watermark;    // порог on_drain (0 — четверть high_watermark)
+    size_t read_budget;      // байт за одно событие; остаток — следующей итерацией (0 — 256 КиБ)
+} core_net_conn_config_t;
+
+// fd — потоковый сокет, переводится в O_NONBLOCK. Из любого потока; config может быть NULL.
+int core_net_conn_open(core_event_loop_t* loop, int fd, const core_net_conn_config_t* config,
+                       const core_net_handlers_t* handlers, void* ctx, core_net_conn_t** conn);
+
+// Копирует данные в сокет или в очередь. CORE_ERR_NOMEM — в очереди уже
+// high_watermark байт, данные не приняты: дождитесь on_drain.
+// CORE_ERR_NOTFOUND — соединение закрывается, CORE_ERR_INTERNAL — ошибка
+// сокета (соединение закрывается с ней).
+int core_net_conn_send(core_net_conn_t* conn, const void* data, size_t size);
+
+// Неизменяемый буфер со счётчиком ссылок для рассылки одних и тех же
+// данных многим соединениям: копируется один раз при создании, очереди
+// соединений ссылаются на него, а не копируют свой остаток.
+typedef struct core_net_payload core_net_payload_t;
+
+int core_net_payload_create(const void* data, size_t size, core_net_payload_t** payload);
+void core_net_payload_retain(core_net_payload_t* payload);
+void core_net_payload_release(core_net_payload_t* payload);
+const void* core_net_payload_data(const core_net_payload_t* payload);
+size_t core_net_payload_size(const core_net_payload_t* payload);
+
+// Как core_net_conn_send, но неотправленный остаток держит ссылку на payload
+int core_net_conn_send_payload(core_net_conn_t* conn, core_net_payload_t* payload);
+
+// Байт в очереди отправки
+size_t core_net_conn_queued(const core_net_conn_t* conn);
+
+// flush != 0 — закрыть после отправки очереди, иначе сразу. on_close
+// приходит в любом случае; после вызова conn использовать нельзя.
+void core_net_conn_close(core_net_conn_t* conn, int flush);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,7 +3,14 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#endif
 
 // Оптимизированные сетевые операции
 int core_network_init();
@@ -25,6 +32,62 @@ ssize_t core_socket_sendto(int socket, const void* buf, size_t len, int flags,
 ssize_t core_socket_recvfrom(int socket, void* buf, size_t len, int flags,
                             struct sockaddr* src_addr, socklen_t* addrlen);
 
+// Пакетный ввод-вывод датаграмм: пачка сообщений за одно обращение к ядру
+// (sendmmsg/recvmmsg). Пачка длиннее CORE_SOCKET_BATCH_MAX уходит
+// несколькими вызовами. Возвращают число отправленных/принятых сообщений
+// или -1 с errno, если не прошло ни одно.
+#define CORE_SOCKET_BATCH_MAX 64
+
+typedef struct {
+    void* buf;                      // данные; при приёме — буфер
+    size_t len;                     // длина данных; при приёме — размер буфера
+    struct sockaddr_storage addr;   // получатель или отправитель
+    socklen_t addrlen;              // 0 при отправке — адрес подключённого сокета
+    size_t received;                // принято байт
+    uint16_t segment_size;          // GSO/GRO: размер датаграмм в склеенном буфере, 0 — одна датаграмма
+    int flags;                      // флаги принятого сообщения (MSG_TRUNC и т. п.)
+} core_dgram_t;
+
+int core_socket_sendmmsg(int socket, core_dgram_t* msgs, size_t count, int flags);
+// Ждёт (если сокет блокирующий) только первую пачку, остальное — без ожидания
+int core_socket_recvmmsg(int socket, core_dgram_t* msgs, size_t count, int flags);
+
+// UDP GSO: при отправке с segment_size ядро само режет буфер на датаграммы
+// этого размера (последняя короче) — до 64 датаграмм и 64 КиБ за раз.
+// UDP GRO: при приёме подряд пришедшие датаграммы одного потока склеиваются
+// в один буфер, segment_size сообщает размер каждой. 0 или -1 (ядро без
+// поддержки — отправляйте и принимайте по одной датаграмме).
+int core_socket_gso_supported(int socket);
+int core_socket_enable_gro(int socket);
+
+// MSG_ZEROCOPY для больших отправок по TCP: страницы буфера передаются
+// ядру без копирования, поэтому буфер нельзя менять или освобождать, пока
+// отправка не завершена. Завершения приходят в очередь ошибок сокета
+// (готовность POLLERR) и разбираются core_zerocopy_reap. Отправки короче
+// CORE_ZEROCOPY_MIN копируются как обычно — так дешевле.
+#define CORE_ZEROCOPY_MIN (16u << 10)
+#define CORE_ZEROCOPY_WINDOW 1024   // незавершённых отправок на сокет
+
+typedef struct {
+    int socket;
+    uint32_t next_id;     // номер следующей отправки; ядро нумерует так же
+    uint32_t base;        // все отправки с номером меньше base завершены
+    uint64_t done[CORE_ZEROCOPY_WINDOW / 64];   // завершённые в окне над base
+    uint64_t copied;      // завершений, где ядро всё-таки скопировало данные
+} core_zerocopy_t;
+
+// Включает SO_ZEROCOPY; вызывается до первой отправки с MSG_ZEROCOPY на
+// этом сокете. -1, если ядро или сокет не поддерживают.
+int core_zerocopy_init(core_zerocopy_t* zc, int socket);
+// Как core_socket_send; *id — номер отправки для core_zerocopy_done (у
+// скопированной отправки он уже завершён). -1 с ENOBUFS — окно
+// незавершённых отправок заполнено: сначала core_zerocopy_reap.
+ssize_t core_zerocopy_send(core_zerocopy_t* zc, const void* buf, size_t len, int flags, uint32_t* id);
+// Разбирает уведомления без ожидания; возвращает число завершённых отправок
+int core_zerocopy_reap(core_zerocopy_t* zc);
+// Ненулевое, если буфер отправки id снова принадлежит вызывающему
+int core_zerocopy_done(const core_zerocopy_t* zc, uint32_t id);
+
 // Операции с буферами
 int core_socket_set_buffer_size(int socket, int rcvbuf, int sndbuf);
 int core_socket_get_buffer_size(int socket, int* rcvbuf, int* sndbuf);
@@ -0,0 +1,77 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Приём и отправка сырых кадров Ethernet через ядро, без DPDK и без
+// отдельной сетевой карты. Два механизма:
+//  - AF_XDP: кадры попадают в общую с ядром область UMEM через кольца
+//    fill/rx/tx/completion; на картах с поддержкой — без копирования
+//    (XDP_ZEROCOPY), иначе ядро копирует кадр в UMEM. На интерфейс ставится
+//    своя XDP-программа, перенаправляющая очередь в сокет;
+//  - AF_PACKET с кольцом TPACKET_V3: ядро складывает кадры в отображённые
+//    блоки, и пользователь забирает блок целиком. Работает везде, где
+//    есть packet-сокеты; запасной вариант для AF_XDP.
+// Оба требуют CAP_NET_RAW, AF_XDP — ещё CAP_NET_ADMIN и CAP_BPF.
+#define CORE_PACKET_IO_AUTO 0        // AF_XDP, при неудаче — AF_PACKET
+#define CORE_PACKET_IO_AF_XDP 1
+#define CORE_PACKET_IO_AF_PACKET 2
+
+typedef struct core_packet_io core_packet_io_t;
+
+typedef struct {
+    uint32_t queue_id;      // очередь интерфейса для AF_XDP
+    uint32_t frame_size;    // байт на кадр (0 — 2048); AF_XDP — степень двойки 2048..4096
+    uint32_t frame_count;   // кадров в UMEM или кольце (0 — 4096)
+    int copy_mode;          // AF_XDP: не пробовать XDP_ZEROCOPY
+    int promiscuous;        // принимать кадры для чужих MAC, пока открыт
+} core_packet_io_config_t;
+
+// Принятый кадр начиная с заголовка Ethernet
+typedef struct {
+    const void* data;
+    uint32_t len;
+} core_packet_t;
+
+typedef struct {
+    uint64_t rx_packets;
+    uint64_t rx_bytes;
+    uint64_t rx_dropped;    // отброшено ядром: кольцо было заполнено
+    uint64_t tx_packets;
+} core_packet_io_stats_t;
+
+// config может быть NULL. CORE_ERR_NOTFOUND — нет интерфейса,
+// CORE_ERR_UNSUPPORTED — механизм недоступен (ядро, права, на интерфейсе
+// уже стоит чужая XDP-программа).
+int core_packet_io_open(const char* ifname, int backend, const core_packet_io_config_t* config,
+                        core_packet_io_t** io);
+void core_packet_io_close(core_packet_io_t* io);
+
+// Выбранный механизм и работает ли AF_XDP без копирования
+int core_packet_io_backend(const core_packet_io_t* io);
+int core_packet_io_zero_copy(const core_packet_io_t* io);
+// Дескриптор для poll/epoll: готов на чтение, когда есть кадры
+int core_packet_io_fd(const core_packet_io_t* io);
+
+// Ждёт кадры до timeout_ms (-1 — без ограничения): 1 — есть, 0 — таймаут,
+// -1 — ошибка с errno.
+int core_packet_io_wait(core_packet_io_t* io, int timeout_ms);
+
+// Забирает до max кадров без ожидания. Кадры лежат прямо в общей с ядром
+// памяти и действительны до следующего вызова: тогда их место
+// возвращается ядру. Вызывается из одного потока.
+size_t core_packet_io_rx_burst(core_packet_io_t* io, core_packet_t* pkts, size_t max);
+
+// Отправляет кадр с заголовком Ethernet. CORE_ERR_NOMEM — все кадры
+// отправки ещё у ядра, повторите позже. Из одного потока, может быть
+// не тем, что принимает.
+int core_packet_io_send(core_packet_io_t* io, const void* frame, size_t len);
+
+void core_packet_io_stats(core_packet_io_t* io, core_packet_io_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
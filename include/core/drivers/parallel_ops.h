@@ -0,0 +1,28 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+// Исполнитель для параллельных ядер. parallel_for обязан вызвать task(arg, i)
+// для каждого i из [0, num_tasks) и вернуться только после завершения всех.
+typedef struct {
+    void (*parallel_for)(void* ctx, size_t num_tasks, void (*task)(void* arg, size_t index), void* arg);
+    void* ctx;
+    size_t num_threads;
+} core_executor_t;
+
+// Общий пул pthread на (число ядер - 1) рабочих, создаётся при первом вызове.
+// Вызывающий поток тоже разбирает задачи; вложенные вызовы из задач и
+// одновременные вызовы из других потоков не ждут пул, а выполняются последовательно.
+const core_executor_t* core_default_executor(void);
+
+// Выполняет task(arg, i) для i из [0, num_tasks); executor == NULL или
+// num_threads <= 1 — последовательно в вызывающем потоке.
+void core_parallel_for(const core_executor_t* executor, size_t num_tasks,
+                       void (*task)(void* arg, size_t index), void* arg);
+
+#ifdef __cplusplus
+}
+#endif
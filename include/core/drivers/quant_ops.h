@@ -0,0 +1,63 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Целочисленные и квантованные ядра: типизированная арифметика int8/int16/int64,
+// скалярное произведение и свёртка int8 (VNNI на x86, sdot на ARM), bfloat16.
+// Набор инструкций выбирается при компиляции, как в simd_ops.h; int8/int16 на
+// AVX-512 требуют AVX-512BW, без него используется путь AVX2.
+
+// bfloat16: старшие 16 бит float. Отдельная структура, чтобы не путать с int16
+typedef struct core_bf16 {
+    uint16_t bits;
+} core_bf16_t;
+
+// Поэлементные операции по модулю 2^N, как у скалярного цикла над этим типом
+void core_vector_add_i8(int8_t* dst, const int8_t* src1, const int8_t* src2, size_t n);
+void core_vector_add_i16(int16_t* dst, const int16_t* src1, const int16_t* src2, size_t n);
+void core_vector_add_i64(int64_t* dst, const int64_t* src1, const int64_t* src2, size_t n);
+void core_vector_mul_i8(int8_t* dst, const int8_t* src1, const int8_t* src2, size_t n);
+void core_vector_mul_i16(int16_t* dst, const int16_t* src1, const int16_t* src2, size_t n);
+void core_vector_mul_i64(int64_t* dst, const int64_t* src1, const int64_t* src2, size_t n);
+
+// Суммы без переполнения (для int64 — по модулю 2^64)
+int64_t core_vector_sum_i8(const int8_t* src, size_t n);
+int64_t core_vector_sum_i16(const int16_t* src, size_t n);
+int64_t core_vector_sum_i64(const int64_t* src, size_t n);
+
+// Скалярные произведения. int8 накапливается в int32, как в квантованных
+// моделях: результат точен, пока n * 128 * 128 < 2^31 (n <= 131071).
+// int16 накапливается в int64 и точен для значений из [-32767, 32767].
+// int64 — по модулю 2^64.
+int32_t core_vector_dot_i8(const int8_t* src1, const int8_t* src2, size_t n);
+int64_t core_vector_dot_i16(const int16_t* src1, const int16_t* src2, size_t n);
+int64_t core_vector_dot_i64(const int64_t* src1, const int64_t* src2, size_t n);
+
+// Симметричное квантование: dst = round(src * (1 / scale)) в [-127, 127],
+// округление к ближайшему чётному, NaN -> 0
+void core_vector_quantize_i8(int8_t* dst, const float* src, size_t n, float scale);
+void core_vector_dequantize_i8(float* dst, const int8_t* src, size_t n, float scale);
+
+// Свёртка без выхода за границы: dst[i] = sum_j src[i + j] * kernel[j],
+// i < src_size - kernel_size + 1. Ничего не делает при kernel_size > src_size.
+void core_convolve_i8(int32_t* dst, const int8_t* src, size_t src_size,
+                      const int8_t* kernel, size_t kernel_size);
+
+// float <-> bfloat16. Округление к ближайшему чётному, NaN остаётся NaN,
+// денормализованные числа сохраняются
+void core_vector_f32_to_bf16(core_bf16_t* dst, const float* src, size_t n);
+void core_vector_bf16_to_f32(float* dst, const core_bf16_t* src, size_t n);
+
+// Накопление во float. С AVX-512 BF16 используется VDPBF16PS, который считает
+// денормализованные входы нулями
+float core_vector_dot_bf16(const core_bf16_t* src1, const core_bf16_t* src2, size_t n);
+void core_convolve_bf16(float* dst, const core_bf16_t* src, size_t src_size,
+                        const core_bf16_t* kernel, size_t kernel_size);
+
+#ifdef __cplusplus
+}
+#endif
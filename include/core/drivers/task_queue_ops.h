@@ -0,0 +1,120 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Очередь задач одного рабочего потока: ограниченное кольцо без блокировок
+// (ячейки с номерами последовательности), в которое пишут любые потоки, а
+// читают владелец и потоки, ворующие работу. Ни постановка, ни выборка не
+// берут мьютексов; задача исполняется уже после того, как покинула очередь.
+typedef struct {
+    void (*run)(void* arg);
+    void* arg;
+} core_task_t;
+
+typedef struct core_task_queue core_task_queue_t;
+
+// capacity округляется вверх до степени двойки (не меньше 2). Кольцо
+// выделяется на NUMA-узле node (CORE_PLACE_ANY_NODE — без привязки).
+// Возвращает CORE_SUCCESS, CORE_ERR_INVALID или CORE_ERR_NOMEM.
+int core_task_queue_create(size_t capacity, int node, core_task_queue_t** queue);
+void core_task_queue_destroy(core_task_queue_t* queue);
+
+// Постановка из любого потока. CORE_ERR_NOMEM, если очередь заполнена —
+// вызывающий не ждёт освобождения места. Будит запаркованного владельца.
+int core_task_queue_push(core_task_queue_t* queue, core_task_t task);
+
+// Забирает до max задач в порядке постановки одной операцией над головой
+// очереди. Возвращает число забранных.
+size_t core_task_queue_pop_batch(core_task_queue_t* queue, core_task_t* tasks, size_t max);
+
+// Кража: до половины (округляя вверх) текущего содержимого, не больше max
+size_t core_task_queue_steal(core_task_queue_t* victim, core_task_t* tasks, size_t max);
+
+// Приблизительное число задач (точное при отсутствии одновременных операций)
+size_t core_task_queue_size(const core_task_queue_t* queue);
+
+// Ожидание владельцем: засыпает, только если очередь пуста, и просыпается
+// при постановке, core_task_queue_wake или по таймауту (timeout_ns == 0 —
+// без таймаута). Один ожидающий на очередь.
+void core_task_queue_park(core_task_queue_t* queue, uint64_t timeout_ns);
+void core_task_queue_wake(core_task_queue_t* queue);
+
+// Планировщик ядра: по очереди на класс задач и порядок выдачи владельцу.
+//   latency — строгий приоритет, внутри класса — ближайший срок первым (EDF);
+//             задачи без срока идут после задач со сроком в порядке постановки;
+//   normal, batch — делят остаток взвешенно (deficit round robin по числу задач).
+// Защита от голодания: непустой класс normal/batch, не обслуженный дольше
+// max_wait_ns, получает пакет раньше latency. Воры забирают задачи из колец
+// классов в порядке latency, normal, batch; задачи latency, уже переложенные
+// владельцем в очередь по сроку, остаются у него.
+#define CORE_SCHED_LATENCY 0
+#define CORE_SCHED_NORMAL  1
+#define CORE_SCHED_BATCH   2
+#define CORE_SCHED_CLASSES 3
+
+typedef struct {
+    uint32_t weights[CORE_SCHED_CLASSES];      // доли normal и batch; для latency не используется
+    uint64_t max_wait_ns[CORE_SCHED_CLASSES];  // порог голодания; 0 — без защиты
+} core_sched_config_t;
+
+// Гистограммы задержки в очереди (от постановки до выдачи на исполнение):
+// корзина i считает задержки из [2^(i-1), 2^i) нс, корзина 0 — нулевые,
+// последняя — всё, что больше.
+#define CORE_SCHED_HIST_BUCKETS 36
+
+typedef struct {
+    uint64_t dispatched[CORE_SCHED_CLASSES];
+    uint64_t delay_sum_ns[CORE_SCHED_CLASSES];
+    uint64_t delay_max_ns[CORE_SCHED_CLASSES];
+    uint64_t delay_hist[CORE_SCHED_CLASSES][CORE_SCHED_HIST_BUCKETS];
+    uint64_t deadline_misses;   // задачи latency, выданные после своего срока
+    uint64_t starvation_boosts; // пакеты normal/batch, выданные раньше latency
+} core_sched_stats_t;
+
+typedef struct core_task_sched core_task_sched_t;
+
+// Монотонное время в наносекундах — шкала сроков планировщика
+uint64_t core_task_now_ns(void);
+
+// Настройки по умолчанию: веса normal:batch = 4:1, голодание 20 мс / 100 мс
+void core_sched_default_config(core_sched_config_t* config);
+
+// capacity — ёмкость кольца каждого класса; config == NULL — по умолчанию
+int core_task_sched_create(const core_sched_config_t* config, size_t capacity, int node,
+                           core_task_sched_t** sched);
+void core_task_sched_destroy(core_task_sched_t* sched);
+
+// Постановка из любого потока. deadline_ns — абсолютный срок по
+// core_task_now_ns (0 — без срока), учитывается только для latency.
+// CORE_ERR_NOMEM, если кольцо класса заполнено.
+int core_task_sched_push(core_task_sched_t* sched, int sched_class, core_task_t task, uint64_t deadline_ns);
+
+// Следующие до max задач одного класса по политике выше; только владелец
+size_t core_task_sched_next(core_task_sched_t* sched, core_task_t* tasks, size_t max);
+
+// Кража до половины кольца первого непустого класса
+size_t core_task_sched_steal(core_task_sched_t* victim, core_task_t* tasks, size_t max);
+
+// Кража для переноса на другое ядро: то же, что core_task_sched_steal, но
+// возвращает класс забранных задач и их сроки (deadlines может быть NULL),
+// чтобы поставить их заново с прежним приоритетом. Выдачей не считается и
+// в статистику не попадает.
+size_t core_task_sched_steal_class(core_task_sched_t* victim, core_task_t* tasks, uint64_t* deadlines,
+                                   size_t max, int* sched_class);
+
+// Приблизительное число ожидающих задач всех классов
+size_t core_task_sched_size(const core_task_sched_t* sched);
+
+void core_task_sched_park(core_task_sched_t* sched, uint64_t timeout_ns);
+void core_task_sched_wake(core_task_sched_t* sched);
+
+// Снимок счётчиков; accumulate != 0 — прибавить к *stats, иначе перезаписать
+void core_task_sched_stats(const core_task_sched_t* sched, core_sched_stats_t* stats, int accumulate);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+// Топология процессора из sysfs: логические CPU, физические ядра (пара
+// physical_package_id + core_id), SMT-соседи и NUMA-узлы
+// (devices/system/node/nodeN/cpulist). Без NUMA в sysfs все CPU относятся к узлу 0,
+// без topology/* каждый CPU считается отдельным физическим ядром.
+typedef struct {
+    int cpu;        // номер логического CPU
+    int core;       // плотный индекс физического ядра, 0..num_cores-1
+    int package;    // physical_package_id
+    int node;       // NUMA-узел
+    int smt_index;  // порядковый номер среди SMT-соседей (0 — первый поток ядра)
+    int allowed;    // CPU входит в маску affinity процесса
+} core_cpu_desc_t;
+
+typedef struct {
+    core_cpu_desc_t* cpus;    // по возрастанию cpu
+    size_t num_cpus;
+    size_t num_cores;
+    size_t num_packages;
+    size_t num_nodes;         // наибольший номер узла + 1
+    size_t threads_per_core;  // максимум SMT-потоков на физическое ядро
+} core_topology_t;
+
+// Разбор дерева sysfs с корнем sysfs_root (NULL — "/sys"). Маска affinity процесса
+// учитывается только для настоящего /sys, в подставленном дереве разрешены все CPU.
+// Возвращает CORE_SUCCESS, CORE_ERR_NOTFOUND (нет ни одного CPU), CORE_ERR_INVALID
+// или CORE_ERR_NOMEM. Результат освобождается core_topology_free.
+int core_topology_detect(const char* sysfs_root, core_topology_t* topology);
+void core_topology_free(core_topology_t* topology);
+
+// Топология этой машины, разбирается один раз; NULL, если sysfs недоступен
+const core_topology_t* core_topology_system();
+
+// Запрос на размещение одного рабочего потока
+#define CORE_PLACE_ANY_NODE (-1)
+
+typedef struct {
+    int numa_node;         // желаемый узел или CORE_PLACE_ANY_NODE
+    int latency_critical;  // занимает физическое ядро целиком, SMT-соседи остаются пустыми
+    int allow_smt;         // может делить физическое ядро с другим потоком через SMT
+} core_place_request_t;
+
+typedef struct {
+    int cpu;        // логический CPU для привязки
+    int core;       // физическое ядро
+    int node;       // узел, на котором выделять очереди и кэши потока
+    int exclusive;  // ни один другой поток плана не делит с ним физическое ядро
+    int fallback;   // желаемый узел не выполнен или ядро пришлось переподписать
+} core_placement_t;
+
+// План размещения count потоков. Сначала размещаются latency-critical запросы,
+// затем остальные. Поток получает свободное физическое ядро своего узла
+// (без узла — узла с наибольшим числом свободных ядер); если их нет, поток с
+// allow_smt занимает свободный SMT-поток ядра, не отданного latency-critical;
+// затем то же на других узлах, и лишь потом наименее загруженное ядро своего
+// узла (переподписка, fallback). Детерминирован для данной топологии.
+int core_topology_place(const core_topology_t* topology, const core_place_request_t* requests,
+                        size_t count, core_placement_t* placements);
+
+// Привязка вызывающего потока к CPU и предпочтение узла этого CPU для его
+// новых страниц (set_mempolicy MPOL_PREFERRED, если ядро ОС поддерживает NUMA)
+int core_topology_bind_current(const core_topology_t* topology, int cpu);
+
+// Память на узле: mmap + mbind(MPOL_PREFERRED), страницы выделяются при первом
+// касании. Без NUMA — обычная анонимная память. Размер округляется до страницы.
+void* core_topology_alloc_on_node(size_t size, int node);
+void core_topology_free_on_node(void* ptr, size_t size);
+
+// Строка отчёта о плане вида "worker 0: cpu 2 core 1 node 0 exclusive\n".
+// Возвращает длину полного отчёта (как snprintf).
+size_t core_topology_format_placement(const core_placement_t* placements, size_t count,
+                                      char* buffer, size_t buffer_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,10 +6,72 @@ extern "C" {
 #include <stddef.h>
 #include <stdint.h>
 
-// SIMD/AVX/NEON ускоренные операции
+// SIMD/AVX/NEON ускоренные операции.
+// Набор инструкций выбирается при компиляции: AVX-512F, AVX2, SSE4.2, NEON
+// или скалярный код. Хвосты (n не кратно ширине вектора) обрабатываются
+// маскированными загрузками/записями, за пределы буферов ядра не читают.
+
+// Используемый набор инструкций
+#define CORE_SIMD_ISA_SCALAR 0
+#define CORE_SIMD_ISA_SSE42  1
+#define CORE_SIMD_ISA_AVX2   2
+#define CORE_SIMD_ISA_AVX512 3
+#define CORE_SIMD_ISA_NEON   4
+
+// Предикаты сравнения для core_vector_cmp_*
+#define CORE_CMP_EQ 0
+#define CORE_CMP_NE 1
+#define CORE_CMP_LT 2
+#define CORE_CMP_LE 3
+#define CORE_CMP_GT 4
+#define CORE_CMP_GE 5
+
+int core_simd_isa();
+const char* core_simd_isa_name();
+size_t core_simd_width_f32(); // Число float в одном векторном регистре
+
+// Поэлементные операции (dst может совпадать с одним из источников)
 void core_vector_add_f32(float* dst, const float* src1, const float* src2, size_t n);
+void core_vector_sub_f32(float* dst, const float* src1, const float* src2, size_t n);
+void core_vector_mul_f32(float* dst, const float* src1, const float* src2, size_t n);
+void core_vector_min_f32(float* dst, const float* src1, const float* src2, size_t n);
+void core_vector_max_f32(float* dst, const float* src1, const float* src2, size_t n);
+void core_vector_fma_f32(float* dst, const float* a, const float* b, const float* c, size_t n); // dst = a * b + c
+void core_vector_abs_f32(float* dst, const float* src, size_t n);
+
 void core_vector_add_i32(int32_t* dst, const int32_t* src1, const int32_t* src2, size_t n);
+void core_vector_sub_i32(int32_t* dst, const int32_t* src1, const int32_t* src2, size_t n);
+void core_vector_mul_i32(int32_t* dst, const int32_t* src1, const int32_t* src2, size_t n);
+void core_vector_min_i32(int32_t* dst, const int32_t* src1, const int32_t* src2, size_t n);
+void core_vector_max_i32(int32_t* dst, const int32_t* src1, const int32_t* src2, size_t n);
+void core_vector_abs_i32(int32_t* dst, const int32_t* src, size_t n);
+
+// Редукции. Для n == 0: сумма 0, min/max возвращают +inf/-inf (INT32_MAX/INT32_MIN),
+// argmax возвращает 0. argmax возвращает индекс первого максимального элемента.
+float core_vector_sum_f32(const float* src, size_t n);
+float core_vector_reduce_min_f32(const float* src, size_t n);
+float core_vector_reduce_max_f32(const float* src, size_t n);
+size_t core_vector_argmax_f32(const float* src, size_t n);
+int64_t core_vector_sum_i32(const int32_t* src, size_t n); // Накопление в 64 бита, без переполнения
+int32_t core_vector_reduce_min_i32(const int32_t* src, size_t n);
+int32_t core_vector_reduce_max_i32(const int32_t* src, size_t n);
+
+// Сравнения в битовую маску: бит i слова mask[i / 64] выставлен, если
+// предикат op истинен для элемента i. Маска должна вмещать (n + 63) / 64 слов,
+// неиспользуемые старшие биты последнего слова обнуляются.
+void core_vector_cmp_f32(uint64_t* mask, const float* src1, const float* src2, size_t n, int op);
+void core_vector_cmp_scalar_f32(uint64_t* mask, const float* src, float value, size_t n, int op);
+size_t core_mask_popcount(const uint64_t* mask, size_t n);
+
+// Gather/scatter по 32-битным индексам: dst[i] = base[idx[i]], base[idx[i]] = src[i].
+// При повторяющихся индексах в scatter побеждает последний элемент.
+void core_vector_gather_f32(float* dst, const float* base, const int32_t* idx, size_t n);
+void core_vector_scatter_f32(float* base, const int32_t* idx, const float* src, size_t n);
+
+// Включающие префиксные суммы: dst[i] = src[0] + ... + src[i]
+void core_vector_prefix_sum_f32(float* dst, const float* src, size_t n);
+void core_vector_prefix_sum_i32(int32_t* dst, const int32_t* src, size_t n);
 
 #ifdef __cplusplus
 }
-#endif 
\ No newline at end of file
+#endif
@@ -22,16 +22,37 @@ enum class Algorithm {
     CONSISTENT_HASH
 };
 
+// Point-in-time copy of a server's counters
 struct ServerStats {
-    std::atomic<uint64_t> active_connections{0};
-    std::atomic<uint64_t> total_requests{0};
-    std::atomic<uint64_t> failed_requests{0};
+    uint64_t active_connections{0};
+    uint64_t total_requests{0};
+    uint64_t failed_requests{0};
     std::chrono::steady_clock::time_point last_health_check;
-    double response_time_ms{0.0};
+    double response_time_ms{0.0};   // peak-EWMA latency
     bool is_healthy{true};
+    bool is_ejected{false};
+    uint32_t ejection_count{0};
     uint32_t weight{1};
 };
 
+// Passive outlier detection on reported responses. A server is ejected
+// after consecutive_failures failures in a row, or when its success rate
+// over an interval falls more than success_rate_stdev_factor standard
+// deviations below the mean of servers with enough traffic. Ejection
+// lasts base_ejection_time times the server's ejection count; afterwards
+// its share of traffic ramps back up over readmission_ramp.
+struct OutlierDetectionConfig {
+    uint32_t consecutive_failures{5};
+    std::chrono::milliseconds interval{1000};
+    std::chrono::milliseconds base_ejection_time{30000};
+    uint32_t max_ejection_multiplier{10};
+    uint32_t max_ejection_percent{50};
+    uint32_t success_rate_min_hosts{3};
+    uint32_t success_rate_request_volume{100};
+    double success_rate_stdev_factor{1.9};
+    std::chrono::milliseconds readmission_ramp{10000};
+};
+
 struct ServerConfig {
     std::string address;
     uint16_t port;
@@ -50,50 +71,161 @@ public:
     void add_server(const ServerConfig& config);
     void remove_server(const std::string& address);
     void update_server_weight(const std::string& address, uint32_t weight);
-    
-    // Request Handling
+
+    // Request Handling. Selection never takes servers_mutex_: it reads an
+    // immutable snapshot of the server set, and every algorithm is O(1) in
+    // the number of servers. The selected server counts the request as in
+    // flight until report_server_response.
     std::string get_next_server();
-    void report_server_response(const std::string& address, bool success, 
+    // IP_HASH and CONSISTENT_HASH route by key (the client address for
+    // IP_HASH) through a Maglev table; CONSISTENT_HASH also caps any server
+    // at (1 + kHashLoadSlack) times its weighted share of in-flight requests
+    // and passes the overflow to the key's next choices. Other algorithms
+    // ignore the key; without one, hash algorithms fall back to round robin.
+    std::string get_next_server(const std::string& key);
+    void report_server_response(const std::string& address, bool success,
                               std::chrono::milliseconds response_time);
-    
-    // Health Checks
+    void set_outlier_detection(const OutlierDetectionConfig& config);
+
+    // Health Checks. Active checks run on one event-loop thread: every
+    // server gets a non-blocking TCP connect probe each
+    // health_check_interval (jittered by 10%, first probe at a random
+    // offset) that fails after its timeout, so a slow server delays only
+    // its own probe. Responses reported through report_server_response
+    // count toward the same state: kUnhealthyThreshold failures in a row
+    // take a server out of rotation, kHealthyThreshold successes bring it
+    // back. Stopping the checks returns every server to rotation.
     void start_health_checks();
     void stop_health_checks();
-    
+
     // Statistics
     ServerStats get_server_stats(const std::string& address) const;
     std::vector<std::pair<std::string, ServerStats>> get_all_stats() const;
 
 private:
+    // Live state of one backend. Shared by every snapshot that contains it,
+    // so counters survive republishing.
     struct Server {
+        explicit Server(const ServerConfig& config);
+
         ServerConfig config;
-        ServerStats stats;
-        std::chrono::steady_clock::time_point last_used;
+        uint64_t maglev_offset_hash;   // Maglev permutation seeds from the address
+        uint64_t maglev_skip_hash;
+        std::atomic<uint32_t> weight;
+        std::atomic<bool> healthy{true};
+        std::atomic<int64_t> last_health_check_ns;
+        std::atomic<uint32_t> health_failures{0};    // streaks, active and passive
+        std::atomic<uint32_t> health_successes{0};
+        // Outlier state; changes of ejected are made under servers_mutex_
+        std::atomic<bool> ejected{false};
+        std::atomic<uint32_t> ejection_count{0};
+        std::atomic<int64_t> ejected_until_ns{0};
+        std::atomic<int64_t> readmitted_ns{0};   // 0 once fully re-admitted
+        // Written on every request: kept off the line with the fields above
+        alignas(64) std::atomic<uint64_t> active_connections{0};
+        std::atomic<uint64_t> total_requests{0};
+        std::atomic<uint64_t> failed_requests{0};
+        // Peak-EWMA: jumps to any slower sample, decays towards faster ones
+        // with time constant kLatencyDecay
+        std::atomic<double> response_time_ms{0.0};
+        std::atomic<int64_t> latency_stamp_ns{0};
+        std::atomic<uint32_t> consecutive_failures{0};
+        std::atomic<uint64_t> interval_requests{0};
+        std::atomic<uint64_t> interval_failures{0};
+    };
+
+    // Immutable once published (RCU style). Writers build a new one under
+    // servers_mutex_, swap it into snapshot_ under snapshot_mutex_ and bump
+    // snapshot_version_. Readers keep a per-thread reference that holds a
+    // retired snapshot alive, check only the version on the hot path, and
+    // take snapshot_mutex_ just to copy the pointer after a version change.
+    struct Snapshot {
+        uint64_t version{0};
+        std::vector<std::shared_ptr<Server>> servers;
+        std::unordered_map<std::string, uint32_t> index;   // address -> servers[]
+        std::vector<uint32_t> routable;                    // healthy servers[]
+        // Walker/Vose alias table over routable, by weight: slot i keeps
+        // routable[i] when a 32-bit coin is below alias_threshold[i]
+        std::vector<uint64_t> alias_threshold;
+        std::vector<uint32_t> alias;
+        std::vector<uint8_t> is_routable;                  // by servers[]
+        // Maglev lookup table: hash slot -> servers[] index, over every
+        // server in or out of rotation; lookups skip the ones that are out.
+        // Built only for the hash algorithms and shared by the snapshots
+        // until servers or weights change; a prime size of at least 100
+        // slots per server keeps shares close to the weights.
+        std::shared_ptr<const std::vector<uint32_t>> maglev;
+        uint64_t total_weight{0};
     };
 
+    static constexpr double kHashLoadSlack = 0.25;
+    static constexpr std::chrono::nanoseconds kLatencyDecay = std::chrono::seconds(10);
+    static constexpr double kMinRampShare = 0.1;
+    static constexpr int kMaxRampRedraws = 3;
+    static constexpr uint32_t kUnhealthyThreshold = 3;
+    static constexpr uint32_t kHealthyThreshold = 2;
+    static constexpr size_t kMaxHashProbes = 64;
+
     Algorithm algorithm_;
-    std::unordered_map<std::string, Server> servers_;
+    const uint64_t instance_id_;
+    std::unordered_map<std::string, std::shared_ptr<Server>> servers_;
     mutable std::mutex servers_mutex_;
+    std::shared_ptr<const Snapshot> snapshot_;   // written under both mutexes
+    mutable std::mutex snapshot_mutex_;
+    std::atomic<uint64_t> snapshot_version_{0};
     std::atomic<size_t> current_server_index_{0};
-    std::atomic<bool> health_checks_running_{false};
-    
+    std::atomic<uint64_t> in_flight_{0};   // sum of active_connections
+
+    class HealthChecker;
+    std::unique_ptr<HealthChecker> health_checker_;
+    std::mutex health_mutex_;   // guards health_checker_; taken before servers_mutex_
+    std::atomic<bool> health_checks_active_{false};
+
+    // Outlier detection. The config is guarded by servers_mutex_; the report
+    // path reads the copies kept in atomics.
+    OutlierDetectionConfig outlier_config_;
+    std::atomic<uint32_t> consecutive_failure_limit_;
+    std::atomic<int64_t> outlier_interval_ns_;
+    std::atomic<int64_t> readmission_ramp_ns_;
+    std::atomic<int64_t> next_outlier_sweep_ns_{0};
+
+    // Snapshot publishing
+    // Caller holds servers_mutex_. Health and ejection changes pass false:
+    // they reuse the Maglev table, so report threads never rebuild it.
+    void publish_snapshot(bool rebuild_maglev);
+    const Snapshot& acquire_snapshot() const;
+    static void build_alias_table(Snapshot& snapshot);
+    static void build_maglev_table(Snapshot& snapshot);
+
     // Algorithm-specific implementations
-    std::string get_next_server_round_robin();
-    std::string get_next_server_least_connections();
-    std::string get_next_server_weighted_round_robin();
-    std::string get_next_server_least_response_time();
-    std::string get_next_server_ip_hash(const std::string& client_ip);
-    std::string get_next_server_consistent_hash(const std::string& key);
-    
+    static void pick_two(const Snapshot& snapshot, Server*& a, Server*& b);
+    Server* pick_round_robin(const Snapshot& snapshot);
+    Server* pick_least_connections(const Snapshot& snapshot);
+    Server* pick_weighted(const Snapshot& snapshot);
+    Server* pick_least_response_time(const Snapshot& snapshot);
+    Server* pick_ip_hash(const Snapshot& snapshot, uint64_t hash);
+    Server* pick_consistent_hash(const Snapshot& snapshot, uint64_t hash);
+    Server* pick_keyless(const Snapshot& snapshot);
+    std::string select(Server* server);
+    bool admit(Server& server) const;
+    static double latency_cost(const Server& server);
+
     // Health check implementation
-    void health_check_worker();
-    bool check_server_health(const Server& server);
-    
+    void record_health(Server& server, bool ok, bool passive);
+    void set_server_health(Server& server, bool healthy);
+    bool is_current(const Server& server) const;
+
     // Helper functions
-    void update_server_stats(const std::string& address, bool success, 
+    void update_server_stats(Server& server, bool success,
                            std::chrono::milliseconds response_time);
-    void remove_unhealthy_server(const std::string& address);
+    void retire_server(Server& server);
+    void record_latency(Server& server, int64_t now, std::chrono::milliseconds response_time);
+
+    // Outlier detection
+    void eject_server(Server& server, int64_t now);   // caller holds servers_mutex_
+    void sweep_outliers(int64_t now);
+    static ServerStats stats_of(const Server& server);
 };
 
 } // namespace loadbalancer
-} // namespace core 
\ No newline at end of file
+} // namespace core
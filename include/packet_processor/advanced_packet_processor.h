@@ -3,7 +3,9 @@
 #include "architecture.h"
 
 #include <boost/asio.hpp>
+#include <functional>
 #include <memory>
+#include <string>
 
 namespace core {
 
@@ -16,18 +18,47 @@ namespace core {
 		    uint32_t source_ip;
 	    };
 
-    	class AdvancedPacketProcessor {
+	    // Source of raw Ethernet frames for the processor. receive_burst hands out
+	    // up to max frames (data and size only) that stay valid until the next
+	    // call; the processor calls it and wait from its processing thread only.
+	    class PacketIoBackend {
+	    public:
+		    virtual ~PacketIoBackend() = default;
+		    virtual const char* name() const = 0;
+		    virtual size_t receive_burst(PacketBuffer* packets, size_t max) = 0;
+		    // Blocks up to timeout_ms for frames; false on timeout
+		    virtual bool wait(int timeout_ms) = 0;
+	    };
+
+	    // Auto takes AF_XDP (zero-copy where the driver supports it) and falls
+	    // back to an AF_PACKET TPACKET_V3 ring when the kernel, the driver or our
+	    // privileges rule it out. Dpdk needs a USE_DPDK build and a bound port.
+	    enum class PacketIoKind { Auto, AfXdp, AfPacket, Dpdk };
+
+	    std::unique_ptr<PacketIoBackend> make_packet_io_backend(const std::string& interface,
+	                                                            PacketIoKind kind, size_t ring_size);
+
+	    class AdvancedPacketProcessor {
 	    private:
 		    struct Impl;
 		    std::unique_ptr<Impl> impl_;
-    	public:
-	    	explicit AdvancedPacketProcessor(size_t ring_size);
+	    public:
+		    // ring_size: frames in the receive ring of the backends created here
+		    explicit AdvancedPacketProcessor(size_t ring_size);
+		    ~AdvancedPacketProcessor();
+		    // Starts the processing thread; every backend feeds the same handlers
 		    void process_packets();
+		    void stop_processing();
 		    void register_handler(uint16_t protocol,
-			std::is_function<void(PacketBuffer&&)>handler);
+		    	std::function<void(PacketBuffer&&)> handler);
 		    void enable_rdma(bool enable);
+		    // Replace the backend; only while processing is stopped
+		    void configure_interface(const std::string& interface,
+		    	PacketIoKind kind = PacketIoKind::Auto);
 		    void configure_dpdk(const std::string& interface);
-    	};
+		    void set_backend(std::unique_ptr<PacketIoBackend> backend);
+		    const char* backend_name() const;
+	    };
 
 	    struct QuicConfig {
 		    uint16_t max_streams;
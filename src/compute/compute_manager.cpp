@@ -1,10 +1,12 @@
 #include "compute/compute_manager.h"
+#include "core/error_handling/core_errors.h"
 #include <iostream>
 #include <algorithm>
 #include <thread>
 #include <queue>
 #include <condition_variable>
 #include <chrono>
+#include <memory>
 
 #ifdef __x86_64__
 #include <immintrin.h>
@@ -36,7 +38,7 @@ void ComputeManager::initialize() {
     if (initialized_) return;
 
     initializeThreadPool();
-    stats_.startTime = std::chrono::steady_clock::now();
+    resetStats();
     initialized_ = true;
 }
 
@@ -113,22 +115,188 @@ void ComputeManager::workerThread() {
     }
 }
 
-void ComputeManager::updateStats(OperationType type, size_t count, bool simd) {
-    stats_.totalOperations += count;
-    if (simd) {
-        stats_.simdOperations += count;
+namespace {
+
+// Раздача слотов статистики потокам. Освобождённый слот переходит к новому
+// потоку вместе с накопленными счётчиками, поэтому суммы не теряются.
+// Реестр не разрушается: thread_local слоты освобождаются и при выходе из процесса.
+class StatsSlotRegistry {
+public:
+    static StatsSlotRegistry& instance() {
+        static StatsSlotRegistry* registry = new StatsSlotRegistry();
+        return *registry;
+    }
+
+    size_t acquire(size_t sharedSlot) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            size_t slot = free_.back();
+            free_.pop_back();
+            return slot;
+        }
+        return next_ < sharedSlot ? next_++ : sharedSlot;
+    }
+
+    void release(size_t slot, size_t sharedSlot) {
+        if (slot == sharedSlot) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(slot);
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<size_t> free_;
+    size_t next_ = 0;
+};
+
+} // namespace
+
+ComputeManager::StatsSlot::StatsSlot()
+    : index(StatsSlotRegistry::instance().acquire(SHARED_STATS_SLOT)) {}
+
+ComputeManager::StatsSlot::~StatsSlot() {
+    StatsSlotRegistry::instance().release(index, SHARED_STATS_SLOT);
+}
+
+void ComputeManager::runParallel(size_t numTasks, const std::function<void(size_t)>& task) {
+    if (numTasks == 0) return;
+
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto state = std::make_shared<State>();
+
+    // Помощники, стартовавшие после завершения всех задач, сразу выходят и
+    // не обращаются к task; вызывающий ждёт все захваченные задачи
+    auto drain = [state, numTasks, &task]() {
+        for (size_t i = state->next++; i < numTasks; i = state->next++) {
+            task(i);
+            if (++state->done == numTasks) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->cv.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = 0;
+    if (threadPool_) {
+        std::lock_guard<std::mutex> lock(threadPool_->mutex);
+        helpers = std::min(threadPool_->threads.size(), numTasks - 1);
+        for (size_t i = 0; i < helpers; ++i) {
+            threadPool_->tasks.push(drain);
+        }
+    }
+    if (helpers > 0) {
+        threadPool_->condition.notify_all();
+    }
+
+    drain();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&state, numTasks] { return state->done == numTasks; });
+}
+
+void ComputeManager::executorParallelFor(void* ctx, size_t numTasks,
+                                         void (*task)(void* arg, size_t index), void* arg) {
+    static_cast<ComputeManager*>(ctx)->runParallel(numTasks, [task, arg](size_t index) {
+        task(arg, index);
+    });
+}
+
+ComputeManager::ChunkPlan ComputeManager::planChunks(size_t count, size_t grain) const {
+    const size_t threads = std::max<size_t>(1, threadCount_.load());
+    if (grain == 0) {
+        const size_t target = threads * CHUNKS_PER_THREAD;
+        grain = std::max(batchSize_.load(), (count + target - 1) / target);
+    }
+    ChunkPlan plan;
+    plan.grain = std::min(grain, count);
+    plan.numChunks = (count + plan.grain - 1) / plan.grain;
+    plan.numSlots = std::min(threads, plan.numChunks);
+    return plan;
+}
+
+bool ComputeManager::runChunks(size_t begin, size_t end, const ChunkPlan& plan, const CancellationToken* cancel,
+                               const std::function<void(size_t slot, size_t chunkBegin, size_t chunkEnd)>& body) {
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto participant = [&](size_t slot) {
+        for (size_t chunk = nextChunk++; chunk < plan.numChunks; chunk = nextChunk++) {
+            if (failed.load(std::memory_order_relaxed) || (cancel && cancel->isCancelled())) {
+                return;
+            }
+            const size_t chunkBegin = begin + chunk * plan.grain;
+            try {
+                body(slot, chunkBegin, std::min(chunkBegin + plan.grain, end));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    };
+
+    if (plan.numSlots <= 1) {
+        participant(0);
     } else {
-        stats_.scalarOperations += count;
+        runParallel(plan.numSlots, participant);
     }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+#ifndef COMPUTE_DISABLE_STATS
+    const size_t slot = statsSlot();
+    bumpCounter(statsShards_[slot].parallelOperations, 1, slot == SHARED_STATS_SLOT);
+#endif
+    return !(cancel && cancel->isCancelled());
+}
+
+ComputeStats ComputeManager::collectStats() const {
+    ComputeStats stats;
+#ifndef COMPUTE_DISABLE_STATS
+    for (size_t i = 0; i < MAX_THREADS; ++i) {
+        const StatsShard& shard = statsShards_[i];
+        const uint64_t total = shard.totalOperations.load(std::memory_order_relaxed);
+        stats.totalOperations += total;
+        stats.simdOperations += shard.simdOperations.load(std::memory_order_relaxed);
+        stats.scalarOperations += shard.scalarOperations.load(std::memory_order_relaxed);
+        stats.parallelOperations += shard.parallelOperations.load(std::memory_order_relaxed);
+        stats.threadUtilization[i] = total;
+    }
+#endif
+    return stats;
 }
 
 ComputeStats ComputeManager::getStats() const {
-    return stats_;
+    // Счётчики только растут, поэтому разность с базой, снятой в resetStats
+    // под той же блокировкой, не отрицательна даже при одновременных обновлениях
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    ComputeStats stats = collectStats();
+    stats.totalOperations -= statsBaseline_.totalOperations;
+    stats.simdOperations -= statsBaseline_.simdOperations;
+    stats.scalarOperations -= statsBaseline_.scalarOperations;
+    stats.parallelOperations -= statsBaseline_.parallelOperations;
+    for (size_t i = 0; i < MAX_THREADS; ++i) {
+        stats.threadUtilization[i] -= statsBaseline_.threadUtilization[i];
+    }
+    stats.startTime = statsBaseline_.startTime;
+    return stats;
 }
 
 void ComputeManager::resetStats() {
-    stats_ = ComputeStats();
-    stats_.startTime = std::chrono::steady_clock::now();
+    // Слоты пишут без блокировок, поэтому обнулять их нельзя — запоминаем базу
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    statsBaseline_ = collectStats();
+    statsBaseline_.startTime = std::chrono::steady_clock::now();
 }
 
 size_t ComputeManager::getThreadCount() const {
@@ -165,6 +333,142 @@ bool ComputeManager::isNEONAvailable() const {
 #endif
 }
 
+bool ComputeManager::convolution2D(float* dst, const float* src, size_t width, size_t height,
+                                   const float* kernel, size_t kernelWidth, size_t kernelHeight,
+                                   int algorithm) {
+    return convolutionMultiChannel(dst, src, 1, 1, width, height, kernel, kernelWidth, kernelHeight, algorithm);
+}
+
+bool ComputeManager::convolutionBatch(float* dst, const float* src, size_t count, size_t srcSize,
+                                      const float* kernel, size_t kernelSize, int algorithm) {
+    if (kernelSize == 0 || kernelSize > srcSize) return false;
+    const size_t outSize = srcSize - kernelSize + 1;
+    core_executor_t executor{&ComputeManager::executorParallelFor, this, threadCount_.load()};
+    if (core_conv1d_f32_batch(count, src, srcSize, srcSize, kernel, kernelSize, dst, outSize,
+                              algorithm, &executor) != CORE_SUCCESS) {
+        return false;
+    }
+    updateStats(OperationType::Convolution, count * outSize * kernelSize, true);
+    return true;
+}
+
+bool ComputeManager::convolutionMultiChannel(float* dst, const float* src, size_t inChannels, size_t outChannels,
+                                             size_t width, size_t height, const float* kernels,
+                                             size_t kernelWidth, size_t kernelHeight, int algorithm) {
+    core_executor_t executor{&ComputeManager::executorParallelFor, this, threadCount_.load()};
+    if (core_conv2d_f32_multi(src, inChannels, width, height, kernels, kernelWidth, kernelHeight,
+                              dst, outChannels, algorithm, &executor) != CORE_SUCCESS) {
+        return false;
+    }
+    // Операции — умножения-сложения прямого алгоритма, независимо от выбранного
+    updateStats(OperationType::Convolution,
+                outChannels * inChannels * (width - kernelWidth + 1) * (height - kernelHeight + 1) *
+                kernelWidth * kernelHeight, true);
+    return true;
+}
+
+int32_t ComputeManager::dotProduct(const int8_t* vec1, const int8_t* vec2, size_t count) {
+    if (!vec1 || !vec2 || count == 0) return 0;
+    updateStats(OperationType::DotProduct, count, true);
+    return core_vector_dot_i8(vec1, vec2, count);
+}
+
+float ComputeManager::dotProduct(const core_bf16_t* vec1, const core_bf16_t* vec2, size_t count) {
+    if (!vec1 || !vec2 || count == 0) return 0.0f;
+    updateStats(OperationType::DotProduct, count, true);
+    return core_vector_dot_bf16(vec1, vec2, count);
+}
+
+void ComputeManager::convolution(int32_t* dst, const int8_t* src, const int8_t* kernel,
+                                 size_t srcSize, size_t kernelSize) {
+    if (!dst || !src || !kernel || kernelSize == 0 || kernelSize > srcSize) return;
+    core_convolve_i8(dst, src, srcSize, kernel, kernelSize);
+    updateStats(OperationType::Convolution, (srcSize - kernelSize + 1) * kernelSize, true);
+}
+
+void ComputeManager::convolution(float* dst, const core_bf16_t* src, const core_bf16_t* kernel,
+                                 size_t srcSize, size_t kernelSize) {
+    if (!dst || !src || !kernel || kernelSize == 0 || kernelSize > srcSize) return;
+    core_convolve_bf16(dst, src, srcSize, kernel, kernelSize);
+    updateStats(OperationType::Convolution, (srcSize - kernelSize + 1) * kernelSize, true);
+}
+
+void ComputeManager::quantize(int8_t* dst, const float* src, size_t count, float scale) {
+    if (!dst || !src || count == 0) return;
+    core_vector_quantize_i8(dst, src, count, scale);
+    updateStats(OperationType::Custom, count, true);
+}
+
+void ComputeManager::dequantize(float* dst, const int8_t* src, size_t count, float scale) {
+    if (!dst || !src || count == 0) return;
+    core_vector_dequantize_i8(dst, src, count, scale);
+    updateStats(OperationType::Custom, count, true);
+}
+
+void ComputeManager::convert(core_bf16_t* dst, const float* src, size_t count) {
+    if (!dst || !src || count == 0) return;
+    core_vector_f32_to_bf16(dst, src, count);
+    updateStats(OperationType::Custom, count, true);
+}
+
+void ComputeManager::convert(float* dst, const core_bf16_t* src, size_t count) {
+    if (!dst || !src || count == 0) return;
+    core_vector_bf16_to_f32(dst, src, count);
+    updateStats(OperationType::Custom, count, true);
+}
+
+namespace {
+
+// Целочисленные ядра по ширине типа (core_vector_*_i8/i16/i32/i64). Арифметика
+// по модулю 2^N совпадает со скалярным циклом, в том числе для беззнаковых типов
+template<size_t Bytes> struct SizedInt;
+template<> struct SizedInt<1> { using type = int8_t; };
+template<> struct SizedInt<2> { using type = int16_t; };
+template<> struct SizedInt<4> { using type = int32_t; };
+template<> struct SizedInt<8> { using type = int64_t; };
+
+template<typename T>
+auto asSized(T* p) { return reinterpret_cast<typename SizedInt<sizeof(T)>::type*>(p); }
+
+template<typename T>
+auto asSized(const T* p) { return reinterpret_cast<const typename SizedInt<sizeof(T)>::type*>(p); }
+
+template<typename T>
+void integerAdd(T* dst, const T* src1, const T* src2, size_t count) {
+    if constexpr (sizeof(T) == 1) core_vector_add_i8(asSized(dst), asSized(src1), asSized(src2), count);
+    else if constexpr (sizeof(T) == 2) core_vector_add_i16(asSized(dst), asSized(src1), asSized(src2), count);
+    else if constexpr (sizeof(T) == 4) core_vector_add_i32(asSized(dst), asSized(src1), asSized(src2), count);
+    else core_vector_add_i64(asSized(dst), asSized(src1), asSized(src2), count);
+}
+
+template<typename T>
+void integerMultiply(T* dst, const T* src1, const T* src2, size_t count) {
+    if constexpr (sizeof(T) == 1) core_vector_mul_i8(asSized(dst), asSized(src1), asSized(src2), count);
+    else if constexpr (sizeof(T) == 2) core_vector_mul_i16(asSized(dst), asSized(src1), asSized(src2), count);
+    else if constexpr (sizeof(T) == 4) core_vector_mul_i32(asSized(dst), asSized(src1), asSized(src2), count);
+    else core_vector_mul_i64(asSized(dst), asSized(src1), asSized(src2), count);
+}
+
+// Точные суммы и произведения, усечённые до T, равны сумме по модулю 2^N
+template<typename T>
+T integerSum(const T* data, size_t count) {
+    if constexpr (sizeof(T) == 1) return static_cast<T>(core_vector_sum_i8(asSized(data), count));
+    else if constexpr (sizeof(T) == 2) return static_cast<T>(core_vector_sum_i16(asSized(data), count));
+    else if constexpr (sizeof(T) == 4) return static_cast<T>(core_vector_sum_i32(asSized(data), count));
+    else return static_cast<T>(core_vector_sum_i64(asSized(data), count));
+}
+
+// 32-битные типы считаются в ветвях ниже
+template<typename T>
+T integerDot(const T* vec1, const T* vec2, size_t count) {
+    static_assert(sizeof(T) != 4);
+    if constexpr (sizeof(T) == 1) return static_cast<T>(core_vector_dot_i8(asSized(vec1), asSized(vec2), count));
+    else if constexpr (sizeof(T) == 2) return static_cast<T>(core_vector_dot_i16(asSized(vec1), asSized(vec2), count));
+    else return static_cast<T>(core_vector_dot_i64(asSized(vec1), asSized(vec2), count));
+}
+
+} // namespace
+
 // SIMD оптимизации для x86_64
 #ifdef __x86_64__
 
@@ -193,16 +497,7 @@ void ComputeManager::simdAdd(T* dst, const T* src1, const T* src2, size_t count)
             dst[i] = src1[i] + src2[i];
         }
     } else if constexpr (std::is_integral_v<T>) {
-        size_t i = 0;
-        for (; i + 16 <= count; i += 16) {
-            __m256i a = _mm256_loadu_si256((__m256i*)&src1[i]);
-            __m256i b = _mm256_loadu_si256((__m256i*)&src2[i]);
-            __m256i c = _mm256_add_epi32(a, b);
-            _mm256_storeu_si256((__m256i*)&dst[i], c);
-        }
-        for (; i < count; ++i) {
-            dst[i] = src1[i] + src2[i];
-        }
+        integerAdd(dst, src1, src2, count);
     }
 }
 
@@ -231,16 +526,7 @@ void ComputeManager::simdMultiply(T* dst, const T* src1, const T* src2, size_t c
             dst[i] = src1[i] * src2[i];
         }
     } else if constexpr (std::is_integral_v<T>) {
-        size_t i = 0;
-        for (; i + 8 <= count; i += 8) {
-            __m256i a = _mm256_loadu_si256((__m256i*)&src1[i]);
-            __m256i b = _mm256_loadu_si256((__m256i*)&src2[i]);
-            __m256i c = _mm256_mullo_epi32(a, b);
-            _mm256_storeu_si256((__m256i*)&dst[i], c);
-        }
-        for (; i < count; ++i) {
-            dst[i] = src1[i] * src2[i];
-        }
+        integerMultiply(dst, src1, src2, count);
     }
 }
 
@@ -281,22 +567,7 @@ T ComputeManager::simdSum(const T* data, size_t count) {
         }
         return result;
     } else if constexpr (std::is_integral_v<T>) {
-        __m256i sum = _mm256_setzero_si256();
-        size_t i = 0;
-        for (; i + 8 <= count; i += 8) {
-            __m256i a = _mm256_loadu_si256((__m256i*)&data[i]);
-            sum = _mm256_add_epi32(sum, a);
-        }
-        T result = 0;
-        for (; i < count; ++i) {
-            result += data[i];
-        }
-        int32_t temp[8];
-        _mm256_storeu_si256((__m256i*)temp, sum);
-        for (int j = 0; j < 8; ++j) {
-            result += temp[j];
-        }
-        return result;
+        return integerSum(data, count);
     }
     return T();
 }
@@ -341,6 +612,8 @@ T ComputeManager::simdDotProduct(const T* vec1, const T* vec2, size_t count) {
             result += temp[j];
         }
         return result;
+    } else if constexpr (std::is_integral_v<T> && sizeof(T) != 4) {
+        return integerDot(vec1, vec2, count);
     } else if constexpr (std::is_integral_v<T>) {
         __m256i sum = _mm256_setzero_si256();
         size_t i = 0;
@@ -392,16 +665,7 @@ void ComputeManager::simdAdd(T* dst, const T* src1, const T* src2, size_t count)
             dst[i] = src1[i] + src2[i];
         }
     } else if constexpr (std::is_integral_v<T>) {
-        size_t i = 0;
-        for (; i + 4 <= count; i += 4) {
-            int32x4_t a = vld1q_s32((int32_t*)&src1[i]);
-            int32x4_t b = vld1q_s32((int32_t*)&src2[i]);
-            int32x4_t c = vaddq_s32(a, b);
-            vst1q_s32((int32_t*)&dst[i], c);
-        }
-        for (; i < count; ++i) {
-            dst[i] = src1[i] + src2[i];
-        }
+        integerAdd(dst, src1, src2, count);
     }
 }
 
@@ -430,16 +694,7 @@ void ComputeManager::simdMultiply(T* dst, const T* src1, const T* src2, size_t c
             dst[i] = src1[i] * src2[i];
         }
     } else if constexpr (std::is_integral_v<T>) {
-        size_t i = 0;
-        for (; i + 4 <= count; i += 4) {
-            int32x4_t a = vld1q_s32((int32_t*)&src1[i]);
-            int32x4_t b = vld1q_s32((int32_t*)&src2[i]);
-            int32x4_t c = vmulq_s32(a, b);
-            vst1q_s32((int32_t*)&dst[i], c);
-        }
-        for (; i < count; ++i) {
-            dst[i] = src1[i] * src2[i];
-        }
+        integerMultiply(dst, src1, src2, count);
     }
 }
 
@@ -480,22 +735,7 @@ T ComputeManager::simdSum(const T* data, size_t count) {
         }
         return result;
     } else if constexpr (std::is_integral_v<T>) {
-        int32x4_t sum = vdupq_n_s32(0);
-        size_t i = 0;
-        for (; i + 4 <= count; i += 4) {
-            int32x4_t a = vld1q_s32((int32_t*)&data[i]);
-            sum = vaddq_s32(sum, a);
-        }
-        T result = 0;
-        for (; i < count; ++i) {
-            result += data[i];
-        }
-        int32_t temp[4];
-        vst1q_s32(temp, sum);
-        for (int j = 0; j < 4; ++j) {
-            result += temp[j];
-        }
-        return result;
+        return integerSum(data, count);
     }
     return T();
 }
@@ -540,6 +780,8 @@ T ComputeManager::simdDotProduct(const T* vec1, const T* vec2, size_t count) {
             result += temp[j];
         }
         return result;
+    } else if constexpr (std::is_integral_v<T> && sizeof(T) != 4) {
+        return integerDot(vec1, vec2, count);
     } else if constexpr (std::is_integral_v<T>) {
         int32x4_t sum = vdupq_n_s32(0);
         size_t i = 0;
@@ -600,4 +842,25 @@ T ComputeManager::simdDotProduct(const T* vec1, const T* vec2, size_t count) {
 
 #endif
 
-} // namespace compute 
\ No newline at end of file
+// Шаблоны SIMD-ядер определены в этом файле, поэтому инстанцируются здесь для
+// типов, которые поддерживают ветви выше
+#define COMPUTE_INSTANTIATE_SIMD(T)                                                      \
+    template void ComputeManager::simdAdd<T>(T*, const T*, const T*, size_t);            \
+    template void ComputeManager::simdMultiply<T>(T*, const T*, const T*, size_t);       \
+    template T ComputeManager::simdSum<T>(const T*, size_t);                             \
+    template T ComputeManager::simdDotProduct<T>(const T*, const T*, size_t);
+
+COMPUTE_INSTANTIATE_SIMD(float)
+COMPUTE_INSTANTIATE_SIMD(double)
+COMPUTE_INSTANTIATE_SIMD(int8_t)
+COMPUTE_INSTANTIATE_SIMD(uint8_t)
+COMPUTE_INSTANTIATE_SIMD(int16_t)
+COMPUTE_INSTANTIATE_SIMD(uint16_t)
+COMPUTE_INSTANTIATE_SIMD(int32_t)
+COMPUTE_INSTANTIATE_SIMD(uint32_t)
+COMPUTE_INSTANTIATE_SIMD(int64_t)
+COMPUTE_INSTANTIATE_SIMD(uint64_t)
+
+#undef COMPUTE_INSTANTIATE_SIMD
+
+} // namespace compute
@@ -4,16 +4,33 @@
 #include <thread>
 #include <sstream>
 #include <iomanip>
+#include <functional>
+#include <limits>
 
 namespace core {
 
+namespace {
+
+// xorshift64* per thread: routing must not contend on a shared generator
+uint64_t next_random() {
+    thread_local uint64_t state =
+        (std::hash<std::thread::id>{}(std::this_thread::get_id()) ^ 0x9E3779B97F4A7C15ull) | 1;
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1Dull;
+}
+
+} // namespace
+
 LoadBalancer::LoadBalancer()
     : compute_engine_(nullptr)
     , blockchain_engine_(nullptr)
     , network_manager_(nullptr)
     , storage_manager_(nullptr)
     , running_(false)
-    , paused_(false) {
+    , paused_(false)
+    , core_slots_(std::make_unique<CoreSlot[]>(kMaxCores)) {
 }
 
 LoadBalancer::~LoadBalancer() {
@@ -68,87 +85,246 @@ void LoadBalancer::set_storage_manager(StorageManager* manager) {
 }
 
 size_t LoadBalancer::submit_task(const Task& task) {
-    std::lock_guard<std::mutex> lock(task_mutex_);
-    
-    // Find least loaded core
+    // Core choice and the downstream submit run outside the registry locks
     size_t target_core = find_least_loaded_core();
     if (target_core == static_cast<size_t>(-1)) {
         throw std::runtime_error("No available cores for task submission");
     }
 
-    // Generate task ID
-    size_t task_id = tasks_.size() + 1;
-    
-    // Store task
-    tasks_[task_id] = task;
-    task_status_[task_id] = TaskStatus::PENDING;
-    task_metrics_[task_id] = TaskMetrics{};
+    size_t task_id = next_task_id_.fetch_add(1, std::memory_order_relaxed);
+    Task assigned = task;
+    assigned.assigned_core = target_core;
+    const bool queued = task.type == TaskType::COMPUTE;
+    {
+        auto& shard = task_shard(task_id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.rows.emplace(task_id, static_cast<uint32_t>(shard.ids.size()));
+        shard.ids.push_back(task_id);
+        shard.status.push_back(TaskStatus::PENDING);
+        shard.assigned_core.push_back(target_core);
+        shard.metrics.push_back(TaskMetrics{});
+        shard.types.push_back(task.type);
+        shard.queued.push_back(queued);
+    }
+    if (queued) {
+        core_slots_[target_core].depth.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    try {
+        dispatch_task(task_id, assigned);
+    } catch (...) {
+        // Rejected downstream (every engine queue full): nothing will report
+        // completion, so the row and its depth slot are settled here
+        complete_task(task_id, TaskStatus::FAILED);
+        throw;
+    }
+    return task_id;
+}
 
-    // Submit to appropriate engine
+void LoadBalancer::dispatch_task(size_t task_id, const Task& task) {
     if (task.type == TaskType::COMPUTE) {
-        compute_engine_->submit_task(task_id, task);
-    } else if (task.type == TaskType::BLOCKCHAIN) {
+        if (!compute_engine_) {
+            complete_task(task_id, TaskStatus::FAILED);
+            return;
+        }
+        // The worker releases the depth slot when the task is done
+        compute_engine_->submit_task(task.assigned_core, task, [this, task_id] {
+            complete_task(task_id, TaskStatus::COMPLETED);
+        });
+    } else if (task.type == TaskType::BLOCKCHAIN && blockchain_engine_) {
         blockchain_engine_->submit_task(task_id, task);
-    } else if (task.type == TaskType::NETWORK) {
+    } else if (task.type == TaskType::NETWORK && network_manager_) {
         network_manager_->submit_task(task_id, task);
-    } else if (task.type == TaskType::STORAGE) {
+    } else if (task.type == TaskType::STORAGE && storage_manager_) {
         storage_manager_->submit_task(task_id, task);
     }
-
-    return task_id;
 }
 
 void LoadBalancer::cancel_task(size_t task_id) {
-    std::lock_guard<std::mutex> lock(task_mutex_);
-    
-    auto it = tasks_.find(task_id);
-    if (it == tasks_.end()) {
-        return;
+    TaskType type;
+    size_t core_id;
+    bool queued;
+    {
+        auto& shard = task_shard(task_id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.rows.find(task_id);
+        if (it == shard.rows.end()) {
+            return;
+        }
+        type = shard.types[it->second];
+        core_id = shard.assigned_core[it->second];
+        queued = shard.queued[it->second];
+        shard.retire(it->second, TaskStatus::CANCELLED);
+    }
+    if (queued) {
+        release_core_slot(core_id);
     }
 
-    // Cancel task in appropriate engine
-    if (it->second.type == TaskType::COMPUTE) {
-        compute_engine_->cancel_task(task_id);
-    } else if (it->second.type == TaskType::BLOCKCHAIN) {
+    // Cancel task in appropriate engine. MultiCoreEngine tasks are not
+    // addressable by our ID once queued; one that still runs finds its row
+    // gone when it completes and releases nothing.
+    if (type == TaskType::BLOCKCHAIN && blockchain_engine_) {
         blockchain_engine_->cancel_task(task_id);
-    } else if (it->second.type == TaskType::NETWORK) {
+    } else if (type == TaskType::NETWORK && network_manager_) {
         network_manager_->cancel_task(task_id);
-    } else if (it->second.type == TaskType::STORAGE) {
+    } else if (type == TaskType::STORAGE && storage_manager_) {
         storage_manager_->cancel_task(task_id);
     }
-
-    // Update status
-    task_status_[task_id] = TaskStatus::CANCELLED;
 }
 
 TaskStatus LoadBalancer::get_task_status(size_t task_id) const {
-    std::lock_guard<std::mutex> lock(task_mutex_);
-    auto it = task_status_.find(task_id);
-    return it != task_status_.end() ? it->second : TaskStatus::UNKNOWN;
+    const auto& shard = task_shard(task_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.rows.find(task_id);
+    if (it != shard.rows.end()) {
+        return shard.status[it->second];
+    }
+    for (const auto& tombstone : shard.finished) {
+        if (tombstone.id == task_id && task_id != 0) {
+            return tombstone.status;
+        }
+    }
+    return TaskStatus::UNKNOWN;
+}
+
+size_t LoadBalancer::get_task_core(size_t task_id) const {
+    const auto& shard = task_shard(task_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.rows.find(task_id);
+    return it != shard.rows.end() ? shard.assigned_core[it->second] : static_cast<size_t>(-1);
 }
 
 void LoadBalancer::update_task_metrics(size_t task_id, const TaskMetrics& metrics) {
-    std::lock_guard<std::mutex> lock(task_mutex_);
-    task_metrics_[task_id] = metrics;
+    size_t core_id;
+    {
+        auto& shard = task_shard(task_id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.rows.find(task_id);
+        if (it == shard.rows.end()) {
+            return;
+        }
+        shard.metrics[it->second] = metrics;
+        core_id = shard.assigned_core[it->second];
+    }
+
+    // Task samples arrive far more often than core samples and keep the
+    // core's score current between monitor passes
+    record_core_load(core_id, load_of(metrics));
 }
 
-size_t LoadBalancer::find_least_loaded_core() const {
-    std::lock_guard<std::mutex> lock(metrics_mutex_);
-    
-    size_t least_loaded_core = static_cast<size_t>(-1);
-    double min_load = std::numeric_limits<double>::max();
+void LoadBalancer::complete_task(size_t task_id, TaskStatus status) {
+    size_t core_id;
+    bool queued;
+    {
+        auto& shard = task_shard(task_id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.rows.find(task_id);
+        if (it == shard.rows.end()) {
+            return;
+        }
+        core_id = shard.assigned_core[it->second];
+        queued = shard.queued[it->second];
+        shard.retire(it->second, status);
+    }
+    if (queued) {
+        release_core_slot(core_id);
+    }
+}
 
-    for (const auto& [core_id, metrics] : core_metrics_) {
-        if (!metrics.is_healthy) {
-            continue;
+void LoadBalancer::TaskShard::retire(uint32_t row, TaskStatus final_status) {
+    finished[next_finished++ % kTaskTombstones] = Tombstone{ids[row], final_status};
+    rows.erase(ids[row]);
+
+    const uint32_t last = static_cast<uint32_t>(ids.size() - 1);
+    if (row != last) {
+        ids[row] = ids[last];
+        status[row] = status[last];
+        assigned_core[row] = assigned_core[last];
+        metrics[row] = metrics[last];
+        types[row] = types[last];
+        queued[row] = queued[last];
+        rows[ids[row]] = row;
+    }
+    ids.pop_back();
+    status.pop_back();
+    assigned_core.pop_back();
+    metrics.pop_back();
+    types.pop_back();
+    queued.pop_back();
+}
+
+double LoadBalancer::load_of(const TaskMetrics& metrics) {
+    return metrics.cpu_usage * 0.4 +
+           metrics.memory_usage * 0.3 +
+           metrics.network_usage * 0.3;
+}
+
+void LoadBalancer::record_core_load(size_t core_id, double load) {
+    if (core_id >= kMaxCores) {
+        return;
+    }
+
+    CoreSlot& slot = core_slots_[core_id];
+    if (!slot.scored.exchange(true, std::memory_order_relaxed)) {
+        slot.score.store(load, std::memory_order_relaxed);
+        return;
+    }
+
+    double prev = slot.score.load(std::memory_order_relaxed);
+    while (!slot.score.compare_exchange_weak(prev, prev + kLoadEwmaAlpha * (load - prev),
+                                             std::memory_order_relaxed)) {
+    }
+}
+
+void LoadBalancer::release_core_slot(size_t core_id) {
+    if (core_id < kMaxCores) {
+        core_slots_[core_id].depth.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+double LoadBalancer::routing_cost(size_t core_id) const {
+    const CoreSlot& slot = core_slots_[core_id];
+    int64_t depth = std::max<int64_t>(slot.depth.load(std::memory_order_relaxed), 0);
+    // Queue depth is the live signal; the load score scales it so that a
+    // core busy with heavy tasks looks deeper than one with light tasks
+    return static_cast<double>(depth + 1) * (1.0 + slot.score.load(std::memory_order_relaxed));
+}
+
+size_t LoadBalancer::find_least_loaded_core() const {
+    size_t span = core_span_.load(std::memory_order_acquire);
+    if (span == 0) {
+        return static_cast<size_t>(-1);
+    }
+
+    // Two distinct healthy samples. A few misses are retried; running out
+    // of attempts means most cores are down and a full scan is cheap
+    // compared to what is failing.
+    size_t picks[2];
+    size_t found = 0;
+    for (int attempt = 0; attempt < 8 && found < 2; ++attempt) {
+        size_t core_id = next_random() % span;
+        if (core_slots_[core_id].healthy.load(std::memory_order_relaxed) &&
+            (found == 0 || picks[0] != core_id)) {
+            picks[found++] = core_id;
         }
+    }
 
-        double load = metrics.metrics.cpu_usage * 0.4 +
-                     metrics.metrics.memory_usage * 0.3 +
-                     metrics.metrics.network_usage * 0.3;
+    if (found == 2) {
+        return routing_cost(picks[1]) < routing_cost(picks[0]) ? picks[1] : picks[0];
+    }
+    if (found == 1 && span == 1) {
+        return picks[0];
+    }
 
-        if (load < min_load) {
-            min_load = load;
+    size_t least_loaded_core = static_cast<size_t>(-1);
+    double min_cost = std::numeric_limits<double>::max();
+    for (size_t core_id = 0; core_id < span; ++core_id) {
+        if (!core_slots_[core_id].healthy.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        double cost = routing_cost(core_id);
+        if (cost < min_cost) {
+            min_cost = cost;
             least_loaded_core = core_id;
         }
     }
@@ -157,23 +333,51 @@ size_t LoadBalancer::find_least_loaded_core() const {
 }
 
 void LoadBalancer::update_core_metrics(size_t core_id, const CoreMetrics& metrics) {
-    std::lock_guard<std::mutex> lock(metrics_mutex_);
-    core_metrics_[core_id] = metrics;
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        core_metrics_[core_id] = metrics;
+    }
+
+    if (core_id >= kMaxCores) {
+        return;
+    }
+    record_core_load(core_id, load_of(metrics.metrics));
+    core_slots_[core_id].healthy.store(metrics.is_healthy, std::memory_order_relaxed);
+
+    // Publish the core to routing after its slot is initialised
+    size_t span = core_span_.load(std::memory_order_relaxed);
+    while (span <= core_id &&
+           !core_span_.compare_exchange_weak(span, core_id + 1, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+    }
 }
 
 bool LoadBalancer::is_core_healthy(size_t core_id) const {
+    if (core_id < kMaxCores) {
+        return core_id < core_span_.load(std::memory_order_acquire) &&
+               core_slots_[core_id].healthy.load(std::memory_order_relaxed);
+    }
     std::lock_guard<std::mutex> lock(metrics_mutex_);
     auto it = core_metrics_.find(core_id);
     return it != core_metrics_.end() && it->second.is_healthy;
 }
 
 void LoadBalancer::mark_core_unhealthy(size_t core_id) {
-    std::lock_guard<std::mutex> lock(metrics_mutex_);
-    auto it = core_metrics_.find(core_id);
-    if (it != core_metrics_.end()) {
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        auto it = core_metrics_.find(core_id);
+        if (it == core_metrics_.end()) {
+            return;
+        }
         it->second.is_healthy = false;
-        handle_core_failure(core_id);
     }
+
+    // Only the caller that takes the core out of routing runs the failure
+    // handling; handle_core_failure comes back here and stops at this check
+    if (core_id < kMaxCores && !core_slots_[core_id].healthy.exchange(false, std::memory_order_relaxed)) {
+        return;
+    }
+    handle_core_failure(core_id);
 }
 
 void LoadBalancer::adjust_resources(size_t core_id) {
@@ -307,33 +511,28 @@ void LoadBalancer::handle_core_failure(size_t core_id) {
 }
 
 void LoadBalancer::redistribute_tasks(size_t failed_core_id) {
-    std::lock_guard<std::mutex> lock(task_mutex_);
-    
-    // Find tasks assigned to failed core
-    std::vector<size_t> failed_tasks;
-    for (const auto& [task_id, task] : tasks_) {
-        if (task.assigned_core == failed_core_id) {
-            failed_tasks.push_back(task_id);
-        }
+    // Only compute tasks hold a depth slot, and they are already in the
+    // engine's queues: MultiCoreEngine moves them off a failed core itself and
+    // work stealing drains an overloaded one, so dispatching them again here
+    // would run them twice. What is left for a failed core is the accounting:
+    // its slots follow the tasks to the cores routing now prefers.
+    if (is_core_healthy(failed_core_id)) {
+        return;
     }
 
-    // Redistribute tasks to healthy cores
-    for (size_t task_id : failed_tasks) {
-        size_t target_core = find_least_loaded_core();
-        if (target_core != static_cast<size_t>(-1)) {
-            // Update task assignment
-            tasks_[task_id].assigned_core = target_core;
-            
-            // Resubmit task
-            if (tasks_[task_id].type == TaskType::COMPUTE) {
-                compute_engine_->submit_task(task_id, tasks_[task_id]);
-            } else if (tasks_[task_id].type == TaskType::BLOCKCHAIN) {
-                blockchain_engine_->submit_task(task_id, tasks_[task_id]);
-            } else if (tasks_[task_id].type == TaskType::NETWORK) {
-                network_manager_->submit_task(task_id, tasks_[task_id]);
-            } else if (tasks_[task_id].type == TaskType::STORAGE) {
-                storage_manager_->submit_task(task_id, tasks_[task_id]);
+    for (auto& shard : task_shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (size_t row = 0; row < shard.ids.size(); ++row) {
+            if (shard.assigned_core[row] != failed_core_id || !shard.queued[row]) {
+                continue;
+            }
+            size_t target_core = find_least_loaded_core();
+            if (target_core == static_cast<size_t>(-1)) {
+                return;
             }
+            shard.assigned_core[row] = target_core;
+            release_core_slot(failed_core_id);
+            core_slots_[target_core].depth.fetch_add(1, std::memory_order_relaxed);
         }
     }
 }
@@ -4,17 +4,79 @@
 #include "drivers/math_ops.h"
 #include "drivers/blockchain_ops.h"
 #include "drivers/compute_ops.h"
+#include "drivers/topology_ops.h"
+#include "drivers/task_queue_ops.h"
+#include "core/error_handling/core_errors.h"
 #include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <thread>
 #include <sstream>
 #include <iomanip>
+#include <stdexcept>
 
 namespace core {
 
+namespace {
+
+// Per-core, per-class queue depth; a full queue spills to the least loaded core
+constexpr size_t kTaskQueueCapacity = 4096;
+// Tasks taken from a queue (own or victim) per dequeue
+constexpr size_t kTaskBatch = 32;
+// Idle spinning before parking adapts between these bounds
+constexpr unsigned kMinIdleSpins = 64;
+constexpr unsigned kMaxIdleSpins = 16384;
+// Wakeups sooner than this mean spinning longer would have caught the work
+constexpr auto kShortPark = std::chrono::microseconds(50);
+// Parked workers still look for work to steal this often
+constexpr uint64_t kParkTimeoutNs = 2000000;
+constexpr auto kPausePoll = std::chrono::milliseconds(1);
+constexpr auto kMaintenanceInterval = std::chrono::milliseconds(100);
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+void run_engine_task(void* arg) {
+    std::unique_ptr<Task> task(static_cast<Task*>(arg));
+    task->execute();
+}
+
+struct TrackedTask {
+    Task task;
+    std::function<void()> on_done;
+};
+
+void run_tracked_task(void* arg) {
+    std::unique_ptr<TrackedTask> tracked(static_cast<TrackedTask*>(arg));
+    try {
+        tracked->task.execute();
+    } catch (...) {
+        tracked->on_done();
+        throw;
+    }
+    tracked->on_done();
+}
+
+void resume_coroutine(void* address) {
+    std::coroutine_handle<>::from_address(address).resume();
+}
+
+} // namespace
+
 MultiCoreEngine::MultiCoreEngine(const std::vector<CoreConfig>& configs)
     : configs_(configs) {
     cores_.resize(configs.size());
+    core_sched_default_config(&sched_config_);
+    for (size_t i = 0; i < cores_.size(); ++i) {
+        for (int c = 0; c < CORE_SCHED_CLASSES; ++c) {
+            cores_[i].executors[c] = CoreExecutor{this, i, c};
+        }
+    }
 }
 
 MultiCoreEngine::~MultiCoreEngine() {
@@ -34,10 +96,21 @@ void MultiCoreEngine::start() {
         return;
     }
 
+    plan_core_placement();
+    if (!reactor_) {
+        reactor_ = std::make_unique<async::Reactor>();
+    }
+    reactor_->start();
+    for (size_t i = 0; i < cores_.size(); ++i) {
+        if (!cores_[i].task_sched &&
+            core_task_sched_create(&sched_config_, kTaskQueueCapacity, cores_[i].placement.node,
+                                   &cores_[i].task_sched) != CORE_SUCCESS) {
+            throw std::runtime_error("Failed to allocate core task queue");
+        }
+    }
     for (size_t i = 0; i < cores_.size(); ++i) {
         cores_[i].running = true;
         cores_[i].worker = std::thread(&MultiCoreEngine::worker_thread, this, i);
-        configure_core_affinity(i);
     }
 
     if (monitoring_enabled_) {
@@ -50,12 +123,39 @@ void MultiCoreEngine::stop() {
         return;
     }
 
+    // Completions stop first: coroutines still waiting on I/O are abandoned,
+    // and nothing resumes onto a core whose queue is being drained
+    if (reactor_) {
+        reactor_->stop();
+    }
     for (auto& core : cores_) {
         core.running = false;
-        core.cv.notify_all();
+        core_task_sched_wake(core.task_sched);
+    }
+    for (auto& core : cores_) {
         if (core.worker.joinable()) {
             core.worker.join();
         }
+        core_topology_free_on_node(core.local_memory, core.local_memory_size);
+        core.local_memory = nullptr;
+        core.local_memory_size = 0;
+    }
+
+    // Tasks queued by tasks of already stopped workers run here; queues are
+    // released only when all of them are empty
+    core_task_t batch[kTaskBatch];
+    for (bool drained = false; !drained;) {
+        drained = true;
+        for (size_t i = 0; i < cores_.size(); ++i) {
+            while (size_t n = core_task_sched_next(cores_[i].task_sched, batch, kTaskBatch)) {
+                run_tasks(i, batch, n);
+                drained = false;
+            }
+        }
+    }
+    for (auto& core : cores_) {
+        core_task_sched_destroy(core.task_sched);
+        core.task_sched = nullptr;
     }
 
     if (monitoring_thread_.joinable()) {
@@ -74,7 +174,7 @@ void MultiCoreEngine::resume() {
     std::lock_guard<std::mutex> lock(system_mutex_);
     for (auto& core : cores_) {
         core.paused = false;
-        core.cv.notify_all();
+        core_task_sched_wake(core.task_sched);
     }
 }
 
@@ -94,51 +194,252 @@ void MultiCoreEngine::initialize_core(size_t core_id) {
         core.accelerator_manager.initialize_fpga();
     }
 
-    // Setup memory and cache
-    core.cache_manager.initialize(config.cache_size);
+    // Cache is set up by the worker itself on its NUMA node (configure_core_affinity)
     core.resource_manager.set_memory_limit(config.memory_limit);
 
     // Configure SIMD if enabled
     if (config.enable_simd) {
         core.engine->enable_simd_optimizations();
     }
+}
+
+void MultiCoreEngine::plan_core_placement() {
+    std::vector<core_place_request_t> requests(configs_.size());
+    for (size_t i = 0; i < configs_.size(); ++i) {
+        const auto& config = configs_[i];
+        requests[i].numa_node = config.numa_node == static_cast<size_t>(-1)
+            ? CORE_PLACE_ANY_NODE : static_cast<int>(config.numa_node);
+        requests[i].latency_critical = config.latency_critical;
+        requests[i].allow_smt = config.enable_hyperthreading;
+    }
 
-    // Setup NUMA if available
-    if (config.numa_node != static_cast<size_t>(-1)) {
-        core.engine->bind_to_numa_node(config.numa_node);
+    std::vector<core_placement_t> placements(configs_.size());
+    const core_topology_t* topology = core_topology_system();
+    if (!topology ||
+        core_topology_place(topology, requests.data(), requests.size(), placements.data()) != CORE_SUCCESS) {
+        // Unknown topology: workers stay unpinned and use ordinary memory
+        for (auto& placement : placements) placement = core_placement_t{-1, -1, -1, 0, 1};
+    }
+    for (size_t i = 0; i < cores_.size(); ++i) {
+        cores_[i].placement = placements[i];
     }
 }
 
+void MultiCoreEngine::configure_core_affinity(size_t core_id) {
+    auto& core = cores_[core_id];
+    const auto& config = configs_[core_id];
+
+    // Called from the worker itself: the binding also makes the CPU's node the
+    // preferred one for this thread, so the cache and queue buffers it allocates
+    // from here on land on local memory
+    if (core.placement.cpu >= 0) {
+        core_topology_bind_current(core_topology_system(), core.placement.cpu);
+    }
+    if (config.cache_size > 0) {
+        core.local_memory = core_topology_alloc_on_node(config.cache_size, core.placement.node);
+        if (core.local_memory) {
+            // First touch from the bound CPU commits the pages on its node
+            std::memset(core.local_memory, 0, config.cache_size);
+            core.local_memory_size = config.cache_size;
+        }
+    }
+    core.cache_manager.initialize(config.cache_size);
+}
+
+std::vector<core_placement_t> MultiCoreEngine::get_core_placement() const {
+    std::vector<core_placement_t> placements;
+    placements.reserve(cores_.size());
+    for (const auto& core : cores_) {
+        placements.push_back(core.placement);
+    }
+    return placements;
+}
+
+std::string MultiCoreEngine::describe_core_placement() const {
+    auto placements = get_core_placement();
+    std::string report(core_topology_format_placement(placements.data(), placements.size(), nullptr, 0), '\0');
+    core_topology_format_placement(placements.data(), placements.size(), report.data(), report.size() + 1);
+    return report;
+}
+
 void MultiCoreEngine::worker_thread(size_t core_id) {
     auto& core = cores_[core_id];
-    
+    configure_core_affinity(core_id);
+    // Coroutines suspended here resume on this core
+    async::ExecutorScope executor_scope(executor(core_id));
+
+    // Tasks run outside any lock: a batch leaves the queue in one CAS, so
+    // submitters never wait for the task this core is running. Each batch is
+    // from one class, so a latency task waits for at most one batch
+    core_task_t batch[kTaskBatch];
+    unsigned spin_limit = kMinIdleSpins;
+    unsigned spins = 0;
+    auto next_maintenance = std::chrono::steady_clock::now() + kMaintenanceInterval;
+
     while (core.running) {
-        std::unique_lock<std::mutex> lock(core.mutex);
-        core.cv.wait(lock, [&core] { 
-            return !core.running || (!core.paused && !core.task_queue.empty()); 
-        });
+        if (core.paused) {
+            std::this_thread::sleep_for(kPausePoll);
+            continue;
+        }
 
-        if (!core.running) {
-            break;
+        size_t n = core_task_sched_next(core.task_sched, batch, kTaskBatch);
+        if (n == 0) {
+            n = steal_work(core_id, batch);
+        }
+        if (n > 0) {
+            run_tasks(core_id, batch, n);
+            spins = 0;
+            continue;
         }
 
-        if (core.paused) {
+        // Housekeeping only when idle and at most once per interval
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_maintenance) {
+            optimize_core_performance(core_id);
+            next_maintenance = now + kMaintenanceInterval;
+        }
+
+        if (++spins < spin_limit) {
+            cpu_relax();
             continue;
         }
 
-        // Process tasks
-        while (!core.task_queue.empty()) {
-            auto task = core.task_queue.pop();
-            try {
-                task->execute();
-            } catch (const std::exception& e) {
-                handle_core_exception(core_id, e);
+        // Spin-then-park: work that arrives right after parking means the spin
+        // was too short, a full timeout means it was too long
+        core.idle.store(true);
+        auto parked_at = std::chrono::steady_clock::now();
+        core_task_sched_park(core.task_sched, kParkTimeoutNs);
+        core.idle.store(false);
+        if (std::chrono::steady_clock::now() - parked_at < kShortPark) {
+            spin_limit = std::min(spin_limit * 2, kMaxIdleSpins);
+        } else {
+            spin_limit = std::max(spin_limit / 2, kMinIdleSpins);
+        }
+        spins = 0;
+    }
+
+    // Own queue is drained before the worker exits
+    while (size_t n = core_task_sched_next(core.task_sched, batch, kTaskBatch)) {
+        run_tasks(core_id, batch, n);
+    }
+}
+
+void MultiCoreEngine::run_tasks(size_t core_id, const core_task_t* tasks, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        try {
+            tasks[i].run(tasks[i].arg);
+        } catch (const std::exception& e) {
+            handle_core_exception(core_id, e);
+        }
+    }
+}
+
+size_t MultiCoreEngine::steal_work(size_t core_id, core_task_t* tasks) {
+    // Victims on the same NUMA node first, then the rest, starting after this core
+    const int node = cores_[core_id].placement.node;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t k = 1; k < cores_.size(); ++k) {
+            auto& victim = cores_[(core_id + k) % cores_.size()];
+            if ((victim.placement.node == node) != (pass == 0)) continue;
+            if (core_task_sched_size(victim.task_sched) == 0) continue;
+            if (size_t n = core_task_sched_steal(victim.task_sched, tasks, kTaskBatch)) {
+                return n;
             }
         }
+    }
+    return 0;
+}
 
-        // Optimize performance
-        optimize_core_performance(core_id);
+bool MultiCoreEngine::submit_task(size_t core_id, void (*run)(void*), void* arg,
+                                  int sched_class, uint64_t deadline_ns) {
+    if (core_id >= cores_.size() || !cores_[core_id].task_sched || !run ||
+        sched_class < 0 || sched_class >= CORE_SCHED_CLASSES) {
+        return false;
+    }
+    const core_task_t task{run, arg};
+    if (core_task_sched_push(cores_[core_id].task_sched, sched_class, task, deadline_ns) != CORE_SUCCESS) {
+        // Full queue: spill to the least loaded core instead of waiting
+        size_t target = find_least_loaded_core();
+        if (target == static_cast<size_t>(-1) ||
+            core_task_sched_push(cores_[target].task_sched, sched_class, task, deadline_ns) != CORE_SUCCESS) {
+            return false;
+        }
+        core_id = target;
     }
+
+    // A backlog of a full batch is worth waking an idle core to steal it
+    if (core_task_sched_size(cores_[core_id].task_sched) >= kTaskBatch) {
+        const int node = cores_[core_id].placement.node;
+        size_t thief = static_cast<size_t>(-1);
+        for (size_t k = 1; k < cores_.size(); ++k) {
+            size_t i = (core_id + k) % cores_.size();
+            if (!cores_[i].idle.load(std::memory_order_relaxed)) continue;
+            if (cores_[i].placement.node == node) {
+                thief = i;
+                break;
+            }
+            if (thief == static_cast<size_t>(-1)) thief = i;
+        }
+        if (thief != static_cast<size_t>(-1)) {
+            core_task_sched_wake(cores_[thief].task_sched);
+        }
+    }
+    return true;
+}
+
+void MultiCoreEngine::submit_task(size_t core_id, const Task& task, int sched_class, uint64_t deadline_ns) {
+    auto* copy = new Task(task);
+    if (!submit_task(core_id, &run_engine_task, copy, sched_class, deadline_ns)) {
+        delete copy;
+        throw std::runtime_error("All core task queues are full");
+    }
+}
+
+void MultiCoreEngine::submit_task(size_t core_id, const Task& task, std::function<void()> on_done,
+                                  int sched_class, uint64_t deadline_ns) {
+    auto* tracked = new TrackedTask{task, std::move(on_done)};
+    if (!submit_task(core_id, &run_tracked_task, tracked, sched_class, deadline_ns)) {
+        delete tracked;
+        throw std::runtime_error("All core task queues are full");
+    }
+}
+
+async::Executor MultiCoreEngine::executor(size_t core_id, int sched_class) {
+    if (core_id >= cores_.size() || sched_class < 0 || sched_class >= CORE_SCHED_CLASSES) {
+        throw std::out_of_range("Invalid core or scheduling class");
+    }
+    return async::Executor{&MultiCoreEngine::post_coroutine, &cores_[core_id].executors[sched_class]};
+}
+
+void MultiCoreEngine::post_coroutine(void* ctx, std::coroutine_handle<> handle) {
+    auto* target = static_cast<CoreExecutor*>(ctx);
+    // A coroutine is never dropped: with every queue full it continues on the
+    // posting thread instead
+    if (!target->engine->submit_task(target->core_id, &resume_coroutine, handle.address(), target->sched_class)) {
+        handle.resume();
+    }
+}
+
+async::Reactor& MultiCoreEngine::reactor() {
+    if (!reactor_) {
+        throw std::runtime_error("Engine is not started");
+    }
+    return *reactor_;
+}
+
+void MultiCoreEngine::set_scheduling_config(const core_sched_config_t& config) {
+    std::lock_guard<std::mutex> lock(system_mutex_);
+    sched_config_ = config;
+}
+
+core_sched_stats_t MultiCoreEngine::get_scheduling_stats() const {
+    // Counters are per core and summed on read; histograms of all cores merge
+    core_sched_stats_t stats;
+    std::memset(&stats, 0, sizeof(stats));
+    for (const auto& core : cores_) {
+        core_task_sched_stats(core.task_sched, &stats, 1);
+    }
+    return stats;
 }
 
 void MultiCoreEngine::optimize_core_performance(size_t core_id) {
@@ -231,21 +532,39 @@ void MultiCoreEngine::handle_core_failure(size_t core_id) {
 }
 
 void MultiCoreEngine::redistribute_tasks() {
-    std::vector<Task> failed_tasks;
+    struct StolenTask {
+        size_t core_id;
+        core_task_t task;
+        int sched_class;
+        uint64_t deadline_ns;
+    };
+    std::vector<StolenTask> failed_tasks;
     
-    // Collect tasks from failed cores
+    // Collect tasks from failed cores with their class and deadline. Stealing
+    // is safe against the exiting owner; latency tasks it already moved into
+    // its deadline order are run by its own drain on exit
+    core_task_t batch[kTaskBatch];
+    uint64_t deadlines[kTaskBatch];
+    int sched_class;
     for (size_t i = 0; i < cores_.size(); ++i) {
         if (!cores_[i].running) {
-            auto tasks = cores_[i].task_queue.drain();
-            failed_tasks.insert(failed_tasks.end(), tasks.begin(), tasks.end());
+            while (size_t n = core_task_sched_steal_class(cores_[i].task_sched, batch, deadlines,
+                                                          kTaskBatch, &sched_class)) {
+                for (size_t k = 0; k < n; ++k) {
+                    failed_tasks.push_back({i, batch[k], sched_class, deadlines[k]});
+                }
+            }
         }
     }
     
-    // Redistribute tasks to healthy cores
-    for (const auto& task : failed_tasks) {
+    // Redistribute tasks to healthy cores. A task no core can take is run here
+    // rather than dropped: its argument owns the Task copy and, for tracked
+    // tasks, the completion callback the load balancer is waiting on
+    for (const auto& stolen : failed_tasks) {
         size_t target_core = find_least_loaded_core();
-        if (target_core != static_cast<size_t>(-1)) {
-            submit_task(target_core, task);
+        if (target_core == static_cast<size_t>(-1) ||
+            !submit_task(target_core, stolen.task.run, stolen.task.arg, stolen.sched_class, stolen.deadline_ns)) {
+            run_tasks(stolen.core_id, &stolen.task, 1);
         }
     }
 }
@@ -257,7 +576,7 @@ size_t MultiCoreEngine::find_least_loaded_core() const {
     for (size_t i = 0; i < cores_.size(); ++i) {
         if (!cores_[i].running) continue;
         
-        auto load = cores_[i].task_queue.size();
+        auto load = core_task_sched_size(cores_[i].task_sched);
         if (load < min_load) {
             min_load = load;
             target_core = i;
@@ -1,9 +1,12 @@
 #include "core/NetworkManager.h"
+#include "core/drivers/task_queue_ops.h"
+#include "core/error_handling/core_errors.h"
 #include <algorithm>
 #include <chrono>
 #include <thread>
 #include <sstream>
 #include <iomanip>
+#include <random>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -14,14 +17,138 @@
 
 namespace core {
 
+namespace {
+
+constexpr uint64_t kMonitorPeriodNs = 1000000000ull;
+
+} // namespace
+
 NetworkManager::NetworkManager()
+    : NetworkManager(PoolConfig{}) {
+}
+
+NetworkManager::NetworkManager(const PoolConfig& pool_config)
+    : NetworkManager(pool_config, ReactorConfig{}) {
+}
+
+NetworkManager::NetworkManager(const PoolConfig& pool_config, const ReactorConfig& reactor_config)
     : running_(false)
-    , paused_(false) {
+    , paused_(false)
+    , reactor_config_(reactor_config) {
     metrics_ = NetworkMetrics{};
+
+    core_conn_pool_config_t config;
+    core_conn_pool_default_config(&config);
+    config.max_per_host = static_cast<uint32_t>(pool_config.max_per_host);
+    config.max_idle_per_host = static_cast<uint32_t>(pool_config.max_idle_per_host);
+    config.idle_timeout_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(pool_config.idle_timeout).count());
+    config.keepalive_idle_s = static_cast<uint32_t>(pool_config.keepalive_idle.count());
+    if (core_conn_pool_create(&config, &pool_) != CORE_SUCCESS) {
+        throw std::runtime_error("Failed to create connection pool");
+    }
+
+    try {
+        create_reactors();
+    } catch (...) {
+        for (auto& reactor : reactors_) {
+            core_event_loop_destroy(reactor->loop);
+        }
+        core_conn_pool_destroy(pool_);
+        throw;
+    }
 }
 
 NetworkManager::~NetworkManager() {
     stop();
+    release_all_connections();
+    // Closes still pending run on destroy, so every socket is back in the
+    // pool before the pool goes away
+    for (auto& reactor : reactors_) {
+        core_event_loop_destroy(reactor->loop);
+    }
+    core_conn_pool_destroy(pool_);
+}
+
+void NetworkManager::create_reactors() {
+    const core_topology_t* topology = core_topology_system();
+    size_t count = reactor_config_.reactors;
+    if (count == 0) {
+        count = topology ? topology->num_cores : std::thread::hardware_concurrency();
+    }
+    count = std::max<size_t>(count, 1);
+
+    // One reactor per physical core where the topology allows; unpinned otherwise
+    std::vector<core_place_request_t> requests(count, core_place_request_t{CORE_PLACE_ANY_NODE, 0, 1});
+    std::vector<core_placement_t> placements(count);
+    if (!topology ||
+        core_topology_place(topology, requests.data(), requests.size(), placements.data()) != CORE_SUCCESS) {
+        for (auto& placement : placements) placement = core_placement_t{-1, -1, -1, 0, 1};
+    }
+
+    const int backend = reactor_config_.use_io_uring ? CORE_EV_BACKEND_IO_URING : CORE_EV_BACKEND_EPOLL;
+    for (size_t i = 0; i < count; ++i) {
+        auto reactor = std::make_unique<Reactor>();
+        int rc = core_event_loop_create_with(backend, &reactor->loop);
+        if (rc == CORE_ERR_UNSUPPORTED && backend != CORE_EV_BACKEND_EPOLL) {
+            rc = core_event_loop_create(&reactor->loop);
+        }
+        if (rc != CORE_SUCCESS) {
+            throw std::runtime_error(std::string("Failed to create reactor: ") + core_strerror(rc));
+        }
+        reactor->placement = placements[i];
+        reactors_.push_back(std::move(reactor));
+    }
+}
+
+NetworkManager::ConnectionEntry::ConnectionEntry(std::shared_ptr<ConnectionState> state,
+                                                 const ConnectionConfig& config)
+    : state(std::move(state))
+    , connection(std::make_unique<Connection>(core_pooled_conn_fd(this->state->pooled), config)) {
+}
+
+NetworkManager::ConnectionEntry::~ConnectionEntry() {
+    if (connection && !connection->is_healthy()) {
+        state->reusable.store(false, std::memory_order_relaxed);
+    }
+    connection.reset();
+    if (net) {
+        // The reactor flushes what is queued, then on_close pools the socket
+        state->closing.store(true, std::memory_order_relaxed);
+        core_net_conn_close(net, state->abort.load(std::memory_order_relaxed) ? 0 : 1);
+    }
+}
+
+void NetworkManager::ConnectionState::on_data(void* ctx, const void* data, size_t size) {
+    auto* state = static_cast<ConnectionState*>(ctx);
+    const auto& handler = state->owner->data_handler_;
+    if (handler) {
+        handler(state->core_id, state->id, data, size);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(state->inbound_mutex);
+    if (state->inbound_offset > 0 && state->inbound_offset * 2 >= state->inbound.size()) {
+        state->inbound.erase(0, state->inbound_offset);
+        state->inbound_offset = 0;
+    }
+    state->inbound.append(static_cast<const char*>(data), size);
+}
+
+void NetworkManager::ConnectionState::on_close(void* ctx, int error) {
+    auto* state = static_cast<ConnectionState*>(ctx);
+    bool unread;
+    {
+        std::lock_guard<std::mutex> lock(state->inbound_mutex);
+        unread = state->inbound.size() > state->inbound_offset;
+    }
+    // Only a socket we closed cleanly with nothing left unread is safe to
+    // hand to the next request; a peer close or an I/O error closes it
+    const bool reusable = error == 0 && !unread &&
+                          state->closing.load(std::memory_order_relaxed) &&
+                          state->reusable.load(std::memory_order_relaxed);
+    core_conn_pool_release(state->pool, state->pooled, reusable ? 1 : 0);
+    state->closed.store(true, std::memory_order_release);
+    auto self = std::move(state->self);
 }
 
 void NetworkManager::start() {
@@ -29,9 +156,22 @@ void NetworkManager::start() {
         return;
     }
 
-    // Start monitoring thread
-    std::thread monitor_thread(&NetworkManager::monitor_connections, this);
-    monitor_thread.detach();
+    for (auto& reactor : reactors_) {
+        Reactor* r = reactor.get();
+        r->thread = std::thread([r] {
+            if (r->placement.cpu >= 0) {
+                core_topology_bind_current(core_topology_system(), r->placement.cpu);
+            }
+            core_event_loop_run(r->loop);
+        });
+    }
+
+    // Health checks, metrics and pool reaping run once a second on reactor 0
+    core_event_loop_post(reactors_[0]->loop, [](void* ctx) {
+        auto* self = static_cast<NetworkManager*>(ctx);
+        core_event_loop_add_timer(self->reactors_[0]->loop, core_task_now_ns() + kMonitorPeriodNs,
+                                  &NetworkManager::monitor_tick, self, &self->monitor_timer_);
+    }, this);
 }
 
 void NetworkManager::stop() {
@@ -39,16 +179,36 @@ void NetworkManager::stop() {
         return;
     }
 
-    // Wait for monitoring thread to stop
-    std::unique_lock<std::mutex> lock(state_mutex_);
-    state_cv_.wait(lock, [this] { return !running_; });
+    release_all_connections();
+    core_event_loop_post(reactors_[0]->loop, [](void* ctx) {
+        auto* self = static_cast<NetworkManager*>(ctx);
+        core_event_loop_cancel_timer(self->reactors_[0]->loop, self->monitor_timer_);
+    }, this);
 
-    // Cleanup all connections
-    std::lock_guard<std::mutex> conn_lock(connection_mutex_);
-    for (auto& [id, conn] : connections_) {
-        cleanup_connection(id);
+    // Posted closes run before the loops see the stop
+    for (auto& reactor : reactors_) {
+        core_event_loop_stop(reactor->loop);
+    }
+    for (auto& reactor : reactors_) {
+        if (reactor->thread.joinable()) {
+            reactor->thread.join();
+        }
+    }
+}
+
+void NetworkManager::release_all_connections() {
+    // Queued sends are dropped: a stopped reactor would never flush them
+    for (auto& shard : connection_shards_) {
+        std::unordered_map<size_t, std::shared_ptr<ConnectionEntry>> released;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            released.swap(shard.connections);
+        }
+        for (auto& [id, entry] : released) {
+            entry->state->abort.store(true, std::memory_order_relaxed);
+        }
+        connections_in_use_.fetch_sub(released.size(), std::memory_order_relaxed);
     }
-    connections_.clear();
 }
 
 void NetworkManager::pause() {
@@ -94,71 +254,196 @@ void NetworkManager::resume_core(size_t core_id) {
 }
 
 size_t NetworkManager::connect(const ConnectionConfig& config) {
-    // Create socket
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock < 0) {
-        throw std::runtime_error("Failed to create socket");
+    core_pooled_conn_t* pooled = nullptr;
+    uint64_t timeout_ns = static_cast<uint64_t>(config.timeout_ms) * 1000000ull;
+    int rc = core_conn_pool_acquire(pool_, config.host.c_str(), config.port, timeout_ns, &pooled);
+    if (rc != CORE_SUCCESS) {
+        throw std::runtime_error(std::string("Failed to connect: ") + core_strerror(rc));
     }
 
-    // Set non-blocking mode
-    int flags = fcntl(sock, F_GETFL, 0);
-    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
-
-    // Connect
-    struct sockaddr_in addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(config.port);
-    inet_pton(AF_INET, config.host.c_str(), &addr.sin_addr);
-
-    int ret = ::connect(sock, (struct sockaddr*)&addr, sizeof(addr));
-    if (ret < 0 && errno != EINPROGRESS) {
-        close(sock);
-        throw std::runtime_error("Failed to connect");
+    const size_t connection_id = next_connection_id_.fetch_add(1, std::memory_order_relaxed);
+    std::shared_ptr<ConnectionEntry> entry;
+    try {
+        auto state = std::make_shared<ConnectionState>();
+        state->owner = this;
+        state->id = connection_id;
+        state->core_id = connection_id % reactors_.size();
+        state->pool = pool_;
+        state->pooled = pooled;
+        entry = std::make_shared<ConnectionEntry>(std::move(state), config);
+    } catch (...) {
+        core_conn_pool_release(pool_, pooled, 0);
+        throw;
     }
 
-    // Create connection object
-    std::lock_guard<std::mutex> lock(connection_mutex_);
-    size_t connection_id = connections_.size() + 1;
-    connections_[connection_id] = std::make_unique<Connection>(sock, config);
+    // The connection lives on its core's reactor from here on
+    ConnectionState& state = *entry->state;
+    core_net_conn_config_t net_config{};
+    net_config.high_watermark = reactor_config_.send_high_watermark;
+    net_config.low_watermark = reactor_config_.send_low_watermark;
+    core_net_handlers_t handlers{};
+    handlers.on_data = &ConnectionState::on_data;
+    handlers.on_close = &ConnectionState::on_close;
+    state.self = entry->state;
+    rc = core_net_conn_open(reactors_[state.core_id]->loop, core_pooled_conn_fd(pooled), &net_config, &handlers,
+                            &state, &entry->net);
+    if (rc != CORE_SUCCESS) {
+        state.self.reset();
+        core_conn_pool_release(pool_, pooled, 0);
+        throw std::runtime_error(std::string("Failed to register connection: ") + core_strerror(rc));
+    }
 
+    auto& shard = connection_shard(connection_id);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.connections.emplace(connection_id, std::move(entry));
+    }
+    connections_in_use_.fetch_add(1, std::memory_order_relaxed);
     return connection_id;
 }
 
 void NetworkManager::disconnect(size_t connection_id) {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
-    auto it = connections_.find(connection_id);
-    if (it != connections_.end()) {
-        cleanup_connection(connection_id);
-        connections_.erase(it);
+    std::shared_ptr<ConnectionEntry> entry;
+    auto& shard = connection_shard(connection_id);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.connections.find(connection_id);
+        if (it == shard.connections.end()) {
+            return;
+        }
+        entry = std::move(it->second);
+        shard.connections.erase(it);
+    }
+    connections_in_use_.fetch_sub(1, std::memory_order_relaxed);
+    // Once in-flight I/O drops its reference the reactor flushes the send
+    // queue and returns the socket to the pool
+}
+
+std::shared_ptr<NetworkManager::ConnectionEntry> NetworkManager::find_connection(size_t connection_id) {
+    auto& shard = connection_shard(connection_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.connections.find(connection_id);
+    return it != shard.connections.end() ? it->second : nullptr;
+}
+
+std::vector<std::pair<size_t, std::shared_ptr<NetworkManager::ConnectionEntry>>>
+NetworkManager::snapshot_connections() {
+    std::vector<std::pair<size_t, std::shared_ptr<ConnectionEntry>>> entries;
+    entries.reserve(connections_in_use_.load(std::memory_order_relaxed));
+    for (auto& shard : connection_shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [id, entry] : shard.connections) {
+            entries.emplace_back(id, entry);
+        }
     }
+    return entries;
 }
 
 size_t NetworkManager::send(size_t connection_id, const void* data, size_t size) {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
-    auto it = connections_.find(connection_id);
-    if (it == connections_.end()) {
+    auto entry = find_connection(connection_id);
+    if (!entry) {
         return 0;
     }
-
-    return it->second->send(data, size);
+    return core_net_conn_send(entry->net, data, size) == CORE_SUCCESS ? size : 0;
 }
 
 size_t NetworkManager::receive(size_t connection_id, void* buffer, size_t size) {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
-    auto it = connections_.find(connection_id);
-    if (it == connections_.end()) {
+    auto entry = find_connection(connection_id);
+    if (!entry) {
         return 0;
     }
-
-    return it->second->receive(buffer, size);
+    ConnectionState& state = *entry->state;
+    std::lock_guard<std::mutex> lock(state.inbound_mutex);
+    size_t count = std::min(size, state.inbound.size() - state.inbound_offset);
+    memcpy(buffer, state.inbound.data() + state.inbound_offset, count);
+    state.inbound_offset += count;
+    if (state.inbound_offset == state.inbound.size()) {
+        state.inbound.clear();
+        state.inbound_offset = 0;
+    }
+    return count;
 }
 
 void NetworkManager::broadcast(const void* data, size_t size) {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
-    for (auto& [id, conn] : connections_) {
-        conn->send(data, size);
+    fan_out(snapshot_connections(), data, size);
+}
+
+void NetworkManager::gossip(const void* data, size_t size, size_t fanout) {
+    auto entries = snapshot_connections();
+    if (entries.size() > fanout) {
+        // Partial Fisher-Yates: the first `fanout` entries become a uniform sample
+        thread_local std::mt19937_64 rng{std::random_device{}()};
+        for (size_t i = 0; i < fanout; ++i) {
+            std::uniform_int_distribution<size_t> pick(i, entries.size() - 1);
+            std::swap(entries[i], entries[pick(rng)]);
+        }
+        entries.resize(fanout);
+    }
+    fan_out(std::move(entries), data, size);
+}
+
+void NetworkManager::fan_out(std::vector<std::pair<size_t, std::shared_ptr<ConnectionEntry>>> entries,
+                             const void* data, size_t size) {
+    if (entries.empty()) {
+        return;
+    }
+    core_net_payload_t* payload = nullptr;
+    int rc = core_net_payload_create(data, size, &payload);
+    if (rc != CORE_SUCCESS) {
+        throw std::runtime_error(std::string("Failed to create broadcast payload: ") + core_strerror(rc));
+    }
+
+    // Each reactor writes to the connections it owns, so the sends run in
+    // parallel and hit the socket directly from the thread that flushes it
+    std::vector<std::unique_ptr<FanOut>> batches(reactors_.size());
+    for (auto& [id, entry] : entries) {
+        auto& batch = batches[entry->state->core_id];
+        if (!batch) {
+            batch = std::make_unique<FanOut>();
+            core_net_payload_retain(payload);
+            batch->payload = payload;
+        }
+        batch->entries.push_back(std::move(entry));
+    }
+    core_net_payload_release(payload);
+
+    for (size_t i = 0; i < batches.size(); ++i) {
+        if (!batches[i]) {
+            continue;
+        }
+        FanOut* batch = batches[i].get();
+        if (core_event_loop_post(reactors_[i]->loop, &NetworkManager::run_fan_out, batch) == CORE_SUCCESS) {
+            batches[i].release();
+        } else {
+            run_fan_out(batches[i].release());
+        }
+    }
+}
+
+void NetworkManager::run_fan_out(void* ctx) {
+    std::unique_ptr<FanOut> batch(static_cast<FanOut*>(ctx));
+    for (const auto& entry : batch->entries) {
+        core_net_conn_send_payload(entry->net, batch->payload);
+    }
+}
+
+void NetworkManager::set_data_handler(DataHandler handler) {
+    // Reactor threads read data_handler_ without a lock; they exist only
+    // between start() and stop(), which joins them
+    if (running_.load()) {
+        throw std::runtime_error("Data handler must be set while the network manager is stopped");
     }
+    data_handler_ = std::move(handler);
+}
+
+size_t NetworkManager::get_pool_size() const {
+    return connections_in_use_.load(std::memory_order_relaxed);
+}
+
+core_conn_pool_stats_t NetworkManager::get_pool_stats() const {
+    core_conn_pool_stats_t stats{};
+    core_conn_pool_stats(pool_, &stats);
+    return stats;
 }
 
 size_t NetworkManager::submit_task(size_t task_id, const Task& task) {
@@ -253,81 +538,89 @@ void NetworkManager::update_metrics(const NetworkMetrics& metrics) {
     metrics_ = metrics;
 }
 
-void NetworkManager::monitor_connections() {
-    while (running_) {
-        {
-            std::unique_lock<std::mutex> lock(state_mutex_);
-            state_cv_.wait(lock, [this] { return !paused_ || !running_; });
-            
-            if (!running_) {
-                break;
-            }
-        }
-
-        // Update metrics
-        NetworkMetrics new_metrics{};
-        {
-            std::lock_guard<std::mutex> lock(connection_mutex_);
-            for (const auto& [id, conn] : connections_) {
-                auto conn_metrics = conn->get_metrics();
-                new_metrics.bandwidth_usage += conn_metrics.bandwidth_usage;
-                new_metrics.latency += conn_metrics.latency;
-                new_metrics.active_connections++;
-                new_metrics.queued_requests += conn_metrics.queued_requests;
-                new_metrics.failed_requests += conn_metrics.failed_requests;
-            }
-        }
+void NetworkManager::monitor_tick(void* ctx) {
+    auto* self = static_cast<NetworkManager*>(ctx);
+    if (!self->running_) {
+        return;
+    }
+    if (!self->paused_) {
+        self->monitor_connections();
+    }
+    core_event_loop_add_timer(self->reactors_[0]->loop, core_task_now_ns() + kMonitorPeriodNs,
+                              &NetworkManager::monitor_tick, self, &self->monitor_timer_);
+}
 
-        // Normalize metrics
-        if (new_metrics.active_connections > 0) {
-            new_metrics.bandwidth_usage /= new_metrics.active_connections;
-            new_metrics.latency /= new_metrics.active_connections;
-        }
+void NetworkManager::monitor_connections() {
+    // Update metrics
+    auto entries = snapshot_connections();
+    NetworkMetrics new_metrics{};
+    for (const auto& [id, entry] : entries) {
+        auto conn_metrics = entry->connection->get_metrics();
+        new_metrics.bandwidth_usage += conn_metrics.bandwidth_usage;
+        new_metrics.latency += conn_metrics.latency;
+        new_metrics.active_connections++;
+        new_metrics.queued_requests += conn_metrics.queued_requests;
+        new_metrics.failed_requests += conn_metrics.failed_requests;
+    }
 
-        // Update global metrics
-        update_metrics(new_metrics);
+    // Normalize metrics
+    if (new_metrics.active_connections > 0) {
+        new_metrics.bandwidth_usage /= new_metrics.active_connections;
+        new_metrics.latency /= new_metrics.active_connections;
+    }
 
-        // Check connection health
-        std::lock_guard<std::mutex> lock(connection_mutex_);
-        for (const auto& [id, conn] : connections_) {
-            if (!conn->is_healthy()) {
-                handle_connection_failure(id);
-            } else {
-                optimize_connection(id);
+    // Update global metrics
+    update_metrics(new_metrics);
+
+    // Check connection health
+    for (const auto& [id, entry] : entries) {
+        if (entry->state->closed.load(std::memory_order_acquire)) {
+            // Closed by the peer or on an I/O error; dropped once read out
+            bool drained;
+            {
+                std::lock_guard<std::mutex> lock(entry->state->inbound_mutex);
+                drained = entry->state->inbound_offset == entry->state->inbound.size();
             }
+            if (drained) {
+                disconnect(id);
+            }
+        } else if (!entry->connection->is_healthy()) {
+            handle_connection_failure(id);
+        } else {
+            optimize_connection(id);
         }
-
-        std::this_thread::sleep_for(std::chrono::seconds(1));
     }
+    entries.clear();
+
+    // Close pooled sockets idle past idle_timeout or closed by the peer
+    core_conn_pool_reap(pool_);
 }
 
 void NetworkManager::handle_connection_failure(size_t connection_id) {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
-    auto it = connections_.find(connection_id);
-    if (it != connections_.end()) {
+    auto entry = find_connection(connection_id);
+    if (entry) {
         // Attempt recovery
-        if (!it->second->recover()) {
-            // If recovery fails, cleanup
+        if (!entry->connection->recover()) {
+            // If recovery fails, cleanup; the socket is closed, not pooled
+            entry->state->reusable.store(false, std::memory_order_relaxed);
             cleanup_connection(connection_id);
-            connections_.erase(it);
+            disconnect(connection_id);
         }
     }
 }
 
 void NetworkManager::optimize_connection(size_t connection_id) {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
-    auto it = connections_.find(connection_id);
-    if (it != connections_.end()) {
-        it->second->optimize();
+    auto entry = find_connection(connection_id);
+    if (entry) {
+        entry->connection->optimize();
     }
 }
 
 void NetworkManager::cleanup_connection(size_t connection_id) {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
-    auto it = connections_.find(connection_id);
-    if (it != connections_.end()) {
-        it->second->cleanup();
+    auto entry = find_connection(connection_id);
+    if (entry) {
+        entry->connection->cleanup();
     }
 }
 
-} // namespace core 
\ No newline at end of file
+} // namespace core
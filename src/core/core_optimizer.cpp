@@ -10,7 +10,7 @@
 
 #ifdef __linux__
 #include <sys/sysinfo.h>
-#include <numa.h>
+#include "core/drivers/topology_ops.h"
 #elif defined(_WIN32)
 #include <windows.h>
 #elif defined(__APPLE__)
@@ -109,102 +109,21 @@ bool AdvancedThreadPool::try_steal_work(size_t thread_id) {
     return false;
 }
 
-// Implementation of SIMDOperations methods
-template<typename T>
-void SIMDOperations::vector_add(T* dst, const T* src1, const T* src2, size_t count) {
-#ifdef __AVX2__
-    if constexpr (std::is_same_v<T, float>) {
-        size_t i = 0;
-        for (; i + 8 <= count; i += 8) {
-            __m256 a = _mm256_loadu_ps(&src1[i]);
-            __m256 b = _mm256_loadu_ps(&src2[i]);
-            __m256 c = _mm256_add_ps(a, b);
-            _mm256_storeu_ps(&dst[i], c);
-        }
-        for (; i < count; ++i) {
-            dst[i] = src1[i] + src2[i];
-        }
-    } else if constexpr (std::is_same_v<T, double>) {
-        size_t i = 0;
-        for (; i + 4 <= count; i += 4) {
-            __m256d a = _mm256_loadu_pd(&src1[i]);
-            __m256d b = _mm256_loadu_pd(&src2[i]);
-            __m256d c = _mm256_add_pd(a, b);
-            _mm256_storeu_pd(&dst[i], c);
-        }
-        for (; i < count; ++i) {
-            dst[i] = src1[i] + src2[i];
-        }
-    } else if constexpr (std::is_integral_v<T>) {
-        size_t i = 0;
-        for (; i + 8 <= count; i += 8) {
-            __m256i a = _mm256_loadu_si256((__m256i*)&src1[i]);
-            __m256i b = _mm256_loadu_si256((__m256i*)&src2[i]);
-            __m256i c = _mm256_add_epi32(a, b);
-            _mm256_storeu_si256((__m256i*)&dst[i], c);
-        }
-        for (; i < count; ++i) {
-            dst[i] = src1[i] + src2[i];
-        }
-    }
-#elif defined(__ARM_NEON)
-    if constexpr (std::is_same_v<T, float>) {
-        size_t i = 0;
-        for (; i + 4 <= count; i += 4) {
-            float32x4_t a = vld1q_f32(&src1[i]);
-            float32x4_t b = vld1q_f32(&src2[i]);
-            float32x4_t c = vaddq_f32(a, b);
-            vst1q_f32(&dst[i], c);
-        }
-        for (; i < count; ++i) {
-            dst[i] = src1[i] + src2[i];
-        }
-    } else if constexpr (std::is_same_v<T, double>) {
-        size_t i = 0;
-        for (; i + 2 <= count; i += 2) {
-            float64x2_t a = vld1q_f64(&src1[i]);
-            float64x2_t b = vld1q_f64(&src2[i]);
-            float64x2_t c = vaddq_f64(a, b);
-            vst1q_f64(&dst[i], c);
-        }
-        for (; i < count; ++i) {
-            dst[i] = src1[i] + src2[i];
-        }
-    } else if constexpr (std::is_integral_v<T>) {
-        size_t i = 0;
-        for (; i + 4 <= count; i += 4) {
-            int32x4_t a = vld1q_s32((int32_t*)&src1[i]);
-            int32x4_t b = vld1q_s32((int32_t*)&src2[i]);
-            int32x4_t c = vaddq_s32(a, b);
-            vst1q_s32((int32_t*)&dst[i], c);
-        }
-        for (; i < count; ++i) {
-            dst[i] = src1[i] + src2[i];
-        }
-    }
-#else
-    for (size_t i = 0; i < count; ++i) {
-        dst[i] = src1[i] + src2[i];
-    }
-#endif
-}
-
 // Implementation of CoreOptimizer methods
 void CoreOptimizer::detect_hardware() {
 #ifdef __linux__
-    // Detect CPU topology using sysfs
-    for (size_t i = 0; i < MAX_CORES; ++i) {
-        std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(i) + "/topology/core_id";
-        std::ifstream file(path);
-        if (file.is_open()) {
-            file >> topology_.core_ids[i];
-        }
-    }
-    
-    // Detect NUMA nodes
-    topology_.num_numa_nodes = numa_num_configured_nodes();
-    for (size_t i = 0; i < MAX_CORES; ++i) {
-        topology_.numa_nodes[i] = numa_node_of_cpu(i);
+    // Detect CPU topology using sysfs (shared with thread placement)
+    if (const core_topology_t* topology = core_topology_system()) {
+        for (size_t i = 0; i < topology->num_cpus; ++i) {
+            const core_cpu_desc_t& cpu = topology->cpus[i];
+            if (static_cast<size_t>(cpu.cpu) >= MAX_CORES) continue;
+            topology_.core_ids[cpu.cpu] = cpu.core;
+            topology_.numa_nodes[cpu.cpu] = cpu.node;
+            topology_.thread_ids[cpu.cpu] = cpu.smt_index;
+        }
+        topology_.num_cores = topology->num_cores;
+        topology_.num_numa_nodes = topology->num_nodes;
+        topology_.threads_per_core = topology->threads_per_core;
     }
     
     // Detect cache configuration
@@ -2,10 +2,20 @@
 #include "core/drivers/memory_ops.h"
 #include "core/drivers/thread_ops.h"
 #include "core/drivers/math_ops.h"
+#include "core/drivers/gemm_ops.h"
+#include "core/drivers/fft_ops.h"
+#include "core/drivers/filter_ops.h"
 
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 // Оптимизированные математические операции
 void core_compute_vector_add(const float* a, const float* b, float* result, size_t size) {
 #ifdef __AVX2__
@@ -179,43 +189,11 @@ void core_compute_matrix_sub(const float* a, const float* b, float* result, size
     core_compute_vector_sub(a, b, result, size);
 }
 
-void core_compute_matrix_mul(const float* a, const float* b, float* result,
+int core_compute_matrix_mul(const float* a, const float* b, float* result,
                            size_t a_rows, size_t a_cols, size_t b_cols) {
-#ifdef __AVX2__
-    for (size_t i = 0; i < a_rows; i++) {
-        for (size_t j = 0; j < b_cols; j += 8) {
-            __m256 sum = _mm256_setzero_ps();
-            for (size_t k = 0; k < a_cols; k++) {
-                __m256 va = _mm256_set1_ps(a[i * a_cols + k]);
-                __m256 vb = _mm256_loadu_ps(&b[k * b_cols + j]);
-                sum = _mm256_add_ps(sum, _mm256_mul_ps(va, vb));
-            }
-            _mm256_storeu_ps(&result[i * b_cols + j], sum);
-        }
-    }
-#elif defined(__ARM_NEON)
-    for (size_t i = 0; i < a_rows; i++) {
-        for (size_t j = 0; j < b_cols; j += 4) {
-            float32x4_t sum = vdupq_n_f32(0.0f);
-            for (size_t k = 0; k < a_cols; k++) {
-                float32x4_t va = vdupq_n_f32(a[i * a_cols + k]);
-                float32x4_t vb = vld1q_f32(&b[k * b_cols + j]);
-                sum = vaddq_f32(sum, vmulq_f32(va, vb));
-            }
-            vst1q_f32(&result[i * b_cols + j], sum);
-        }
-    }
-#else
-    for (size_t i = 0; i < a_rows; i++) {
-        for (size_t j = 0; j < b_cols; j++) {
-            float sum = 0.0f;
-            for (size_t k = 0; k < a_cols; k++) {
-                sum += a[i * a_cols + k] * b[k * b_cols + j];
-            }
-            result[i * b_cols + j] = sum;
-        }
-    }
-#endif
+    // Упакованный блочный GEMM на общем пуле; остатки по b_cols обрабатываются без выхода за границы
+    return core_gemm_f32(CORE_GEMM_NO_TRANS, CORE_GEMM_NO_TRANS, a_rows, b_cols, a_cols,
+                         1.0f, a, a_cols, b, b_cols, 0.0f, result, b_cols, core_default_executor());
 }
 
 void core_compute_matrix_transpose(const float* matrix, float* result, size_t rows, size_t cols) {
@@ -228,7 +206,7 @@ void core_compute_matrix_transpose(const float* matrix, float* result, size_t ro
 
 void core_compute_matrix_inverse(const float* matrix, float* result, size_t size) {
     // Реализация метода Гаусса-Жордана
-    float* temp = (float*)core_malloc(size * size * sizeof(float));
+    float* temp = (float*)malloc(size * size * sizeof(float));
     if (!temp) {
         return;
     }
@@ -288,11 +266,11 @@ void core_compute_matrix_inverse(const float* matrix, float* result, size_t size
         }
     }
 
-    core_free(temp);
+    free(temp);
 }
 
 float core_compute_matrix_determinant(const float* matrix, size_t size) {
-    float* temp = (float*)core_malloc(size * size * sizeof(float));
+    float* temp = (float*)malloc(size * size * sizeof(float));
     if (!temp) {
         return 0.0f;
     }
@@ -328,7 +306,7 @@ float core_compute_matrix_determinant(const float* matrix, size_t size) {
         // Нормализуем текущую строку
         float pivot = temp[i * size + i];
         if (pivot == 0.0f) {
-            core_free(temp);
+            free(temp);
             return 0.0f;
         }
         det *= pivot;
@@ -348,7 +326,7 @@ float core_compute_matrix_determinant(const float* matrix, size_t size) {
         }
     }
 
-    core_free(temp);
+    free(temp);
     return det;
 }
 
@@ -571,7 +549,7 @@ void core_compute_ray_intersect_sphere(const float* ray_origin, const float* ray
 
 // Оптимизированные операции с кривыми
 void core_compute_bezier_point(const float* control_points, size_t degree, float t, float* result) {
-    float* temp = (float*)core_malloc((degree + 1) * sizeof(float));
+    float* temp = (float*)malloc((degree + 1) * sizeof(float));
     if (!temp) {
         return;
     }
@@ -587,11 +565,11 @@ void core_compute_bezier_point(const float* control_points, size_t degree, float
     }
 
     *result = temp[0];
-    core_free(temp);
+    free(temp);
 }
 
 void core_compute_bezier_derivative(const float* control_points, size_t degree, float t, float* result) {
-    float* temp = (float*)core_malloc(degree * sizeof(float));
+    float* temp = (float*)malloc(degree * sizeof(float));
     if (!temp) {
         return;
     }
@@ -609,12 +587,12 @@ void core_compute_bezier_derivative(const float* control_points, size_t degree,
     }
 
     *result = temp[0];
-    core_free(temp);
+    free(temp);
 }
 
 void core_compute_bspline_point(const float* control_points, const float* knots,
                               size_t degree, float t, float* result) {
-    float* temp = (float*)core_malloc((degree + 1) * sizeof(float));
+    float* temp = (float*)malloc((degree + 1) * sizeof(float));
     if (!temp) {
         return;
     }
@@ -637,12 +615,12 @@ void core_compute_bspline_point(const float* control_points, const float* knots,
     }
 
     *result = temp[degree];
-    core_free(temp);
+    free(temp);
 }
 
 void core_compute_bspline_derivative(const float* control_points, const float* knots,
                                    size_t degree, float t, float* result) {
-    float* temp = (float*)core_malloc(degree * sizeof(float));
+    float* temp = (float*)malloc(degree * sizeof(float));
     if (!temp) {
         return;
     }
@@ -672,7 +650,7 @@ void core_compute_bspline_derivative(const float* control_points, const float* k
     }
 
     *result = temp[degree - 1];
-    core_free(temp);
+    free(temp);
 }
 
 // Оптимизированные операции с шумом
@@ -710,42 +688,48 @@ float core_compute_fractal_noise(float x, float y, float z, int octaves, float p
     return total / max_value;
 }
 
-// Оптимизированные операции с фильтрацией
+// Оптимизированные операции с фильтрацией (полосы строк на общем пуле потоков)
 void core_compute_gaussian_blur(const float* input, float* output, size_t width, size_t height,
                               float sigma) {
-    // Реализация размытия по Гауссу
-    // TODO: Реализовать оптимизированное размытие по Гауссу
+    core_filter_gaussian(input, width, output, width, width, height, sigma, core_default_executor());
 }
 
 void core_compute_bilateral_filter(const float* input, float* output, size_t width, size_t height,
                                  float sigma_space, float sigma_color) {
-    // Реализация билатеральной фильтрации
-    // TODO: Реализовать оптимизированную билатеральную фильтрацию
+    core_filter_bilateral(input, width, output, width, width, height, sigma_space, sigma_color,
+                          core_default_executor());
 }
 
 void core_compute_median_filter(const float* input, float* output, size_t width, size_t height,
                               size_t kernel_size) {
-    // Реализация медианной фильтрации
-    // TODO: Реализовать оптимизированную медианную фильтрацию
+    core_filter_median(input, width, output, width, width, height, kernel_size, core_default_executor());
 }
 
-// Оптимизированные операции с преобразованиями
+// Оптимизированные операции с преобразованиями (планы берутся из общего кэша fft_ops)
 void core_compute_fft(const float* input, float* output, size_t size) {
-    // Реализация быстрого преобразования Фурье
-    // TODO: Реализовать оптимизированное БПФ
+    const core_fft_plan_t* plan = core_fft_plan_cached(CORE_FFT_C2C, size);
+    if (plan) {
+        core_fft_c2c(plan, input, output, CORE_FFT_FORWARD);
+    }
 }
 
 void core_compute_ifft(const float* input, float* output, size_t size) {
-    // Реализация обратного быстрого преобразования Фурье
-    // TODO: Реализовать оптимизированное обратное БПФ
+    const core_fft_plan_t* plan = core_fft_plan_cached(CORE_FFT_C2C, size);
+    if (plan) {
+        core_fft_c2c(plan, input, output, CORE_FFT_INVERSE);
+    }
 }
 
 void core_compute_dct(const float* input, float* output, size_t size) {
-    // Реализация дискретного косинусного преобразования
-    // TODO: Реализовать оптимизированное ДКП
+    const core_fft_plan_t* plan = core_fft_plan_cached(CORE_FFT_DCT, size);
+    if (plan) {
+        core_fft_dct(plan, input, output, CORE_FFT_FORWARD);
+    }
 }
 
 void core_compute_idct(const float* input, float* output, size_t size) {
-    // Реализация обратного дискретного косинусного преобразования
-    // TODO: Реализовать оптимизированное обратное ДКП
-} 
\ No newline at end of file
+    const core_fft_plan_t* plan = core_fft_plan_cached(CORE_FFT_DCT, size);
+    if (plan) {
+        core_fft_dct(plan, input, output, CORE_FFT_INVERSE);
+    }
+}
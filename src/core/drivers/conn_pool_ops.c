@@ -0,0 +1,636 @@
+#include "core/drivers/conn_pool_ops.h"
+#include "core/drivers/task_queue_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+// Кэш потоков — CP_CACHE_SLOTS ячеек по CP_CACHE_WAYS соединений, по ячейке
+// на строку кэша. Поток при первом обращении получает номер ячейки и дальше
+// кладёт и забирает соединения только в ней, так что между потоками строки
+// не делятся, пока потоков не больше ячеек. Ячейку может опустошить и чужой
+// поток (уборка, запрос, упёршийся в предел точки), поэтому соединение из неё
+// забирается только обменом на NULL, а метка точки рядом — лишь подсказка,
+// которая проверяется уже по забранному соединению.
+//
+// Ожидающие места на точке и возвращающие в кэш потока не встречаются под
+// мьютексом: ожидающий увеличивает waiters и затем осматривает кэши, а
+// возвращающий кладёт соединение в кэш и затем читает waiters. Порядок
+// seq_cst гарантирует, что хотя бы один из них увидит другого; сигнал
+// приходит через wake_seq под мьютексом точки и не теряется между осмотром
+// и засыпанием.
+
+#define CP_CACHE_LINE 64
+#define CP_CACHE_SLOTS 64
+#define CP_CACHE_WAYS 4
+#define CP_MAX_ENDPOINTS 1024   // степень двойки
+#define CP_MAX_HOST 256
+
+typedef struct cp_endpoint cp_endpoint_t;
+
+struct core_pooled_conn {
+    int fd;
+    int reused;
+    uint64_t idle_since_ns;
+    cp_endpoint_t* endpoint;
+    core_pooled_conn_t* next;   // в общем списке точки
+};
+
+struct cp_endpoint {
+    char host[CP_MAX_HOST];
+    uint16_t port;
+    uint32_t tag;                  // номер точки в таблице + 1
+    struct sockaddr_storage addr;
+    socklen_t addrlen;
+    pthread_mutex_t mutex;
+    pthread_cond_t cv;
+    core_pooled_conn_t* idle;      // стек: последним вернувшееся — первым выдаётся
+    uint32_t idle_count;
+    uint32_t open;                 // под mutex
+    uint32_t waiters;              // изменяется под mutex, читается без него
+    uint64_t wake_seq;             // под mutex
+};
+
+typedef struct {
+    core_pooled_conn_t* conns[CP_CACHE_WAYS];
+    uint32_t tags[CP_CACHE_WAYS];
+} __attribute__((aligned(CP_CACHE_LINE))) cp_slot_t;
+
+struct core_conn_pool {
+    cp_slot_t slots[CP_CACHE_SLOTS];
+    core_conn_pool_config_t config;
+    pthread_mutex_t table_mutex;   // только для вставки точек
+    cp_endpoint_t* table[CP_MAX_ENDPOINTS];
+    uint32_t endpoint_count;
+    uint64_t connects;
+    uint64_t reuses;
+    uint64_t validation_failures;
+    uint64_t reaped;
+    uint64_t open;
+    uint64_t idle;
+};
+
+static uint32_t cp_thread_counter = 0;
+static __thread uint32_t cp_thread_slot = 0;   // номер ячейки + 1
+
+static cp_slot_t* cp_own_slot(core_conn_pool_t* pool) {
+    if (cp_thread_slot == 0) {
+        cp_thread_slot = __atomic_fetch_add(&cp_thread_counter, 1, __ATOMIC_RELAXED) % CP_CACHE_SLOTS + 1;
+    }
+    return &pool->slots[cp_thread_slot - 1];
+}
+
+static void cp_count(uint64_t* counter, int64_t delta) {
+    __atomic_fetch_add(counter, (uint64_t)delta, __ATOMIC_RELAXED);
+}
+
+void core_conn_pool_default_config(core_conn_pool_config_t* config) {
+    if (!config) {
+        return;
+    }
+    config->max_per_host = 64;
+    config->max_idle_per_host = 16;
+    config->idle_timeout_ns = 60ull * 1000000000ull;
+    config->connect_timeout_ns = 3ull * 1000000000ull;
+    config->keepalive_idle_s = 30;
+    config->keepalive_interval_s = 10;
+    config->keepalive_probes = 3;
+}
+
+int core_conn_pool_create(const core_conn_pool_config_t* config, core_conn_pool_t** pool) {
+    if (!pool) {
+        return CORE_ERR_INVALID;
+    }
+    core_conn_pool_config_t defaults;
+    core_conn_pool_default_config(&defaults);
+
+    core_conn_pool_t* p = NULL;
+    if (posix_memalign((void**)&p, CP_CACHE_LINE, sizeof(*p)) != 0) {
+        return CORE_ERR_NOMEM;
+    }
+    memset(p, 0, sizeof(*p));
+    p->config = config ? *config : defaults;
+    if (p->config.max_per_host == 0) p->config.max_per_host = defaults.max_per_host;
+    if (p->config.max_idle_per_host == 0) p->config.max_idle_per_host = defaults.max_idle_per_host;
+    if (p->config.max_idle_per_host > p->config.max_per_host) p->config.max_idle_per_host = p->config.max_per_host;
+    if (p->config.idle_timeout_ns == 0) p->config.idle_timeout_ns = defaults.idle_timeout_ns;
+    if (p->config.connect_timeout_ns == 0) p->config.connect_timeout_ns = defaults.connect_timeout_ns;
+    if (p->config.keepalive_interval_s == 0) p->config.keepalive_interval_s = defaults.keepalive_interval_s;
+    if (p->config.keepalive_probes == 0) p->config.keepalive_probes = defaults.keepalive_probes;
+    pthread_mutex_init(&p->table_mutex, NULL);
+    *pool = p;
+    return CORE_SUCCESS;
+}
+
+void core_conn_pool_destroy(core_conn_pool_t* pool) {
+    if (!pool) {
+        return;
+    }
+    for (size_t s = 0; s < CP_CACHE_SLOTS; ++s) {
+        for (size_t w = 0; w < CP_CACHE_WAYS; ++w) {
+            core_pooled_conn_t* conn = pool->slots[s].conns[w];
+            if (conn) {
+                close(conn->fd);
+                free(conn);
+            }
+        }
+    }
+    for (size_t i = 0; i < CP_MAX_ENDPOINTS; ++i) {
+        cp_endpoint_t* ep = pool->table[i];
+        if (!ep) {
+            continue;
+        }
+        while (ep->idle) {
+            core_pooled_conn_t* conn = ep->idle;
+            ep->idle = conn->next;
+            close(conn->fd);
+            free(conn);
+        }
+        pthread_cond_destroy(&ep->cv);
+        pthread_mutex_destroy(&ep->mutex);
+        free(ep);
+    }
+    pthread_mutex_destroy(&pool->table_mutex);
+    free(pool);
+}
+
+// FNV-1a по имени и порту
+static uint32_t cp_hash(const char* host, uint16_t port) {
+    uint32_t h = 2166136261u;
+    for (const char* c = host; *c; ++c) h = (h ^ (uint8_t)*c) * 16777619u;
+    h = (h ^ (port & 0xff)) * 16777619u;
+    h = (h ^ (port >> 8)) * 16777619u;
+    return h;
+}
+
+// Поиск без блокировок: точки только добавляются и живут до destroy
+static cp_endpoint_t* cp_lookup(core_conn_pool_t* pool, const char* host, uint16_t port, uint32_t hash) {
+    for (uint32_t i = 0; i < CP_MAX_ENDPOINTS; ++i) {
+        cp_endpoint_t* ep = __atomic_load_n(&pool->table[(hash + i) & (CP_MAX_ENDPOINTS - 1)], __ATOMIC_ACQUIRE);
+        if (!ep) {
+            return NULL;
+        }
+        if (ep->port == port && strcmp(ep->host, host) == 0) {
+            return ep;
+        }
+    }
+    return NULL;
+}
+
+static int cp_endpoint(core_conn_pool_t* pool, const char* host, uint16_t port, cp_endpoint_t** out) {
+    const uint32_t hash = cp_hash(host, port);
+    cp_endpoint_t* ep = cp_lookup(pool, host, port, hash);
+    if (ep) {
+        *out = ep;
+        return CORE_SUCCESS;
+    }
+
+    // Разрешение имени — до мьютекса таблицы: оно может идти долго
+    char service[8];
+    snprintf(service, sizeof(service), "%u", (unsigned)port);
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    struct addrinfo* result = NULL;
+    if (getaddrinfo(host, service, &hints, &result) != 0 || !result) {
+        return CORE_ERR_NOTFOUND;
+    }
+
+    ep = (cp_endpoint_t*)calloc(1, sizeof(*ep));
+    if (!ep) {
+        freeaddrinfo(result);
+        return CORE_ERR_NOMEM;
+    }
+    snprintf(ep->host, sizeof(ep->host), "%s", host);
+    ep->port = port;
+    memcpy(&ep->addr, result->ai_addr, result->ai_addrlen);
+    ep->addrlen = result->ai_addrlen;
+    freeaddrinfo(result);
+    pthread_mutex_init(&ep->mutex, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&ep->cv, &attr);
+    pthread_condattr_destroy(&attr);
+
+    int rc = CORE_ERR_NOMEM;
+    pthread_mutex_lock(&pool->table_mutex);
+    cp_endpoint_t* existing = cp_lookup(pool, host, port, hash);
+    if (existing) {
+        *out = existing;
+        rc = CORE_SUCCESS;
+    } else if (pool->endpoint_count < CP_MAX_ENDPOINTS) {
+        for (uint32_t i = 0;; ++i) {
+            cp_endpoint_t** cell = &pool->table[(hash + i) & (CP_MAX_ENDPOINTS - 1)];
+            if (!*cell) {
+                ep->tag = ++pool->endpoint_count;
+                __atomic_store_n(cell, ep, __ATOMIC_RELEASE);
+                break;
+            }
+        }
+        *out = ep;
+        ep = NULL;
+        rc = CORE_SUCCESS;
+    }
+    pthread_mutex_unlock(&pool->table_mutex);
+    if (ep) {
+        pthread_cond_destroy(&ep->cv);
+        pthread_mutex_destroy(&ep->mutex);
+        free(ep);
+    }
+    return rc;
+}
+
+// Будит ожидающих места на точке; вызывается под её мьютексом
+static void cp_signal_locked(cp_endpoint_t* ep) {
+    ep->wake_seq++;
+    if (ep->waiters) {
+        pthread_cond_broadcast(&ep->cv);
+    }
+}
+
+// Закрывает соединение и освобождает его место в пределе точки
+static void cp_close(core_conn_pool_t* pool, core_pooled_conn_t* conn) {
+    cp_endpoint_t* ep = conn->endpoint;
+    close(conn->fd);
+    free(conn);
+    pthread_mutex_lock(&ep->mutex);
+    ep->open--;
+    cp_signal_locked(ep);
+    pthread_mutex_unlock(&ep->mutex);
+    cp_count(&pool->open, -1);
+}
+
+// Простаивавшее соединение пригодно, если срок простоя не истёк и во
+// входящем потоке пусто: 0 от recv — вторая сторона закрыла соединение,
+// данные — остаток чужого ответа, в обоих случаях соединение не годится
+static int cp_alive(const core_conn_pool_t* pool, const core_pooled_conn_t* conn, uint64_t now) {
+    if (now - conn->idle_since_ns > pool->config.idle_timeout_ns) {
+        return 0;
+    }
+    char byte;
+    ssize_t n = recv(conn->fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+// Простаивающее соединение, которому не нашлось места в ячейке, — в общий
+// список его точки, не сбрасывая срок простоя
+static void cp_requeue(core_pooled_conn_t* conn) {
+    cp_endpoint_t* ep = conn->endpoint;
+    pthread_mutex_lock(&ep->mutex);
+    conn->next = ep->idle;
+    ep->idle = conn;
+    ep->idle_count++;
+    cp_signal_locked(ep);
+    pthread_mutex_unlock(&ep->mutex);
+}
+
+static int cp_cache_put(cp_slot_t* slot, core_pooled_conn_t* conn) {
+    for (size_t w = 0; w < CP_CACHE_WAYS; ++w) {
+        if (__atomic_load_n(&slot->conns[w], __ATOMIC_RELAXED)) {
+            continue;
+        }
+        __atomic_store_n(&slot->tags[w], conn->endpoint->tag, __ATOMIC_RELAXED);
+        core_pooled_conn_t* expected = NULL;
+        if (__atomic_compare_exchange_n(&slot->conns[w], &expected, conn, 0, __ATOMIC_SEQ_CST,
+                                        __ATOMIC_RELAXED)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Забирает из ячейки соединение к ep; чужие, забранные по устаревшей
+// метке, возвращаются на место или, если место уже занято, в свой список
+static core_pooled_conn_t* cp_cache_take(cp_slot_t* slot, const cp_endpoint_t* ep) {
+    for (size_t w = 0; w < CP_CACHE_WAYS; ++w) {
+        if (__atomic_load_n(&slot->tags[w], __ATOMIC_RELAXED) != ep->tag ||
+            !__atomic_load_n(&slot->conns[w], __ATOMIC_RELAXED)) {
+            continue;
+        }
+        core_pooled_conn_t* conn = __atomic_exchange_n(&slot->conns[w], NULL, __ATOMIC_ACQUIRE);
+        if (!conn) {
+            continue;
+        }
+        if (conn->endpoint == ep) {
+            return conn;
+        }
+        if (!cp_cache_put(slot, conn)) {
+            cp_requeue(conn);
+        }
+    }
+    return NULL;
+}
+
+// Ищет соединение к ep в ячейках всех потоков, начиная со своей
+static core_pooled_conn_t* cp_cache_steal(core_conn_pool_t* pool, const cp_endpoint_t* ep) {
+    const size_t own = (size_t)(cp_own_slot(pool) - pool->slots);
+    for (size_t i = 0; i < CP_CACHE_SLOTS; ++i) {
+        core_pooled_conn_t* conn = cp_cache_take(&pool->slots[(own + i) % CP_CACHE_SLOTS], ep);
+        if (conn) {
+            return conn;
+        }
+    }
+    return NULL;
+}
+
+static void cp_set_option(int fd, int level, int name, int value) {
+    setsockopt(fd, level, name, &value, sizeof(value));
+}
+
+// Неблокирующий connect с ожиданием до deadline; сокет возвращается в
+// блокирующем режиме
+static int cp_connect(const core_conn_pool_t* pool, const cp_endpoint_t* ep, uint64_t deadline) {
+    int fd = socket(ep->addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    cp_set_option(fd, IPPROTO_TCP, TCP_NODELAY, 1);
+    if (pool->config.keepalive_idle_s) {
+        cp_set_option(fd, SOL_SOCKET, SO_KEEPALIVE, 1);
+#ifdef TCP_KEEPIDLE
+        cp_set_option(fd, IPPROTO_TCP, TCP_KEEPIDLE, (int)pool->config.keepalive_idle_s);
+        cp_set_option(fd, IPPROTO_TCP, TCP_KEEPINTVL, (int)pool->config.keepalive_interval_s);
+        cp_set_option(fd, IPPROTO_TCP, TCP_KEEPCNT, (int)pool->config.keepalive_probes);
+#endif
+    }
+
+    int rc = connect(fd, (const struct sockaddr*)&ep->addr, ep->addrlen);
+    if (rc < 0 && errno == EINPROGRESS) {
+        struct pollfd pfd = {fd, POLLOUT, 0};
+        for (;;) {
+            uint64_t now = core_task_now_ns();
+            int timeout_ms = now < deadline ? (int)((deadline - now + 999999) / 1000000) : 0;
+            rc = poll(&pfd, 1, timeout_ms);
+            if (rc >= 0 || errno != EINTR) {
+                break;
+            }
+        }
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if (rc == 1 && getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) == 0 && error == 0) {
+            rc = 0;
+        } else {
+            rc = -1;
+        }
+    }
+    if (rc < 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) & ~O_NONBLOCK);
+    return fd;
+}
+
+// Выдаёт простаивавшее соединение, если оно прошло проверку; иначе
+// закрывает его и возвращает NULL
+static core_pooled_conn_t* cp_checkout(core_conn_pool_t* pool, core_pooled_conn_t* conn) {
+    cp_count(&pool->idle, -1);
+    if (!cp_alive(pool, conn, core_task_now_ns())) {
+        cp_count(&pool->validation_failures, 1);
+        cp_close(pool, conn);
+        return NULL;
+    }
+    conn->reused = 1;
+    conn->next = NULL;
+    cp_count(&pool->reuses, 1);
+    return conn;
+}
+
+int core_conn_pool_acquire(core_conn_pool_t* pool, const char* host, uint16_t port, uint64_t timeout_ns,
+                           core_pooled_conn_t** conn) {
+    if (!pool || !host || !conn || strlen(host) >= CP_MAX_HOST) {
+        return CORE_ERR_INVALID;
+    }
+    const uint64_t deadline = core_task_now_ns() + (timeout_ns ? timeout_ns : pool->config.connect_timeout_ns);
+    cp_endpoint_t* ep = NULL;
+    int rc = cp_endpoint(pool, host, port, &ep);
+    if (rc != CORE_SUCCESS) {
+        return rc;
+    }
+
+    // Быстрый путь: своя ячейка, без блокировок
+    cp_slot_t* slot = cp_own_slot(pool);
+    core_pooled_conn_t* found;
+    while ((found = cp_cache_take(slot, ep))) {
+        if ((found = cp_checkout(pool, found))) {
+            *conn = found;
+            return CORE_SUCCESS;
+        }
+    }
+
+    int stole = 0;
+    pthread_mutex_lock(&ep->mutex);
+    for (;;) {
+        if (ep->idle) {
+            found = ep->idle;
+            ep->idle = found->next;
+            ep->idle_count--;
+            pthread_mutex_unlock(&ep->mutex);
+            if ((found = cp_checkout(pool, found))) {
+                *conn = found;
+                return CORE_SUCCESS;
+            }
+            pthread_mutex_lock(&ep->mutex);
+            continue;
+        }
+
+        // Простаивающее в кэше другого потока дешевле нового соединения:
+        // так соединения, возвращённые потоками циклов событий, достаются
+        // запросам из других потоков
+        if (!stole && __atomic_load_n(&pool->idle, __ATOMIC_RELAXED)) {
+            stole = 1;
+            pthread_mutex_unlock(&ep->mutex);
+            found = cp_cache_steal(pool, ep);
+            if (found && (found = cp_checkout(pool, found))) {
+                *conn = found;
+                return CORE_SUCCESS;
+            }
+            pthread_mutex_lock(&ep->mutex);
+            continue;
+        }
+
+        if (ep->open < pool->config.max_per_host) {
+            ep->open++;
+            pthread_mutex_unlock(&ep->mutex);
+            cp_count(&pool->open, 1);
+            found = (core_pooled_conn_t*)calloc(1, sizeof(*found));
+            int fd = found ? cp_connect(pool, ep, deadline) : -1;
+            if (fd < 0) {
+                pthread_mutex_lock(&ep->mutex);
+                ep->open--;
+                cp_signal_locked(ep);
+                pthread_mutex_unlock(&ep->mutex);
+                cp_count(&pool->open, -1);
+                free(found);
+                return found ? CORE_ERR_INTERNAL : CORE_ERR_NOMEM;
+            }
+            found->fd = fd;
+            found->endpoint = ep;
+            cp_count(&pool->connects, 1);
+            *conn = found;
+            return CORE_SUCCESS;
+        }
+
+        // Предел исчерпан: простаивающие могут лежать в кэшах других потоков
+        __atomic_fetch_add(&ep->waiters, 1, __ATOMIC_SEQ_CST);
+        const uint64_t seq = ep->wake_seq;
+        pthread_mutex_unlock(&ep->mutex);
+        found = cp_cache_steal(pool, ep);
+        pthread_mutex_lock(&ep->mutex);
+        if (!found && ep->wake_seq == seq && !ep->idle && ep->open >= pool->config.max_per_host) {
+            uint64_t now = core_task_now_ns();
+            if (now < deadline) {
+                struct timespec ts;
+                ts.tv_sec = (time_t)(deadline / 1000000000ull);
+                ts.tv_nsec = (long)(deadline % 1000000000ull);
+                pthread_cond_timedwait(&ep->cv, &ep->mutex, &ts);
+            } else {
+                __atomic_fetch_sub(&ep->waiters, 1, __ATOMIC_SEQ_CST);
+                pthread_mutex_unlock(&ep->mutex);
+                return CORE_ERR_NOMEM;
+            }
+        }
+        __atomic_fetch_sub(&ep->waiters, 1, __ATOMIC_SEQ_CST);
+        if (found) {
+            pthread_mutex_unlock(&ep->mutex);
+            if ((found = cp_checkout(pool, found))) {
+                *conn = found;
+                return CORE_SUCCESS;
+            }
+            pthread_mutex_lock(&ep->mutex);
+        }
+    }
+}
+
+void core_conn_pool_release(core_conn_pool_t* pool, core_pooled_conn_t* conn, int reusable) {
+    if (!pool || !conn) {
+        return;
+    }
+    if (!reusable) {
+        cp_close(pool, conn);
+        return;
+    }
+    cp_endpoint_t* ep = conn->endpoint;
+    conn->idle_since_ns = core_task_now_ns();
+    cp_count(&pool->idle, 1);
+
+    // Пока место никто не ждёт — в свою ячейку; если ожидающий появился
+    // одновременно, он либо уже увидит соединение в ячейке, либо будет разбужен
+    if (__atomic_load_n(&ep->waiters, __ATOMIC_SEQ_CST) == 0 && cp_cache_put(cp_own_slot(pool), conn)) {
+        if (__atomic_load_n(&ep->waiters, __ATOMIC_SEQ_CST) != 0) {
+            pthread_mutex_lock(&ep->mutex);
+            cp_signal_locked(ep);
+            pthread_mutex_unlock(&ep->mutex);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&ep->mutex);
+    if (ep->idle_count < pool->config.max_idle_per_host || ep->waiters) {
+        conn->next = ep->idle;
+        ep->idle = conn;
+        ep->idle_count++;
+        cp_signal_locked(ep);
+        pthread_mutex_unlock(&ep->mutex);
+        return;
+    }
+    pthread_mutex_unlock(&ep->mutex);
+    cp_count(&pool->idle, -1);
+    cp_close(pool, conn);
+}
+
+int core_pooled_conn_fd(const core_pooled_conn_t* conn) {
+    return conn ? conn->fd : -1;
+}
+
+int core_pooled_conn_reused(const core_pooled_conn_t* conn) {
+    return conn ? conn->reused : 0;
+}
+
+size_t core_conn_pool_reap(core_conn_pool_t* pool) {
+    if (!pool) {
+        return 0;
+    }
+    size_t closed = 0;
+    const uint64_t now = core_task_now_ns();
+
+    for (size_t s = 0; s < CP_CACHE_SLOTS; ++s) {
+        cp_slot_t* slot = &pool->slots[s];
+        for (size_t w = 0; w < CP_CACHE_WAYS; ++w) {
+            if (!__atomic_load_n(&slot->conns[w], __ATOMIC_RELAXED)) {
+                continue;
+            }
+            core_pooled_conn_t* conn = __atomic_exchange_n(&slot->conns[w], NULL, __ATOMIC_ACQUIRE);
+            if (!conn) {
+                continue;
+            }
+            if (cp_alive(pool, conn, now)) {
+                core_pooled_conn_t* expected = NULL;
+                if (!__atomic_compare_exchange_n(&slot->conns[w], &expected, conn, 0, __ATOMIC_SEQ_CST,
+                                                 __ATOMIC_RELAXED)) {
+                    cp_requeue(conn);
+                }
+                continue;
+            }
+            cp_count(&pool->idle, -1);
+            cp_close(pool, conn);
+            closed++;
+        }
+    }
+
+    for (size_t i = 0; i < CP_MAX_ENDPOINTS; ++i) {
+        cp_endpoint_t* ep = __atomic_load_n(&pool->table[i], __ATOMIC_ACQUIRE);
+        if (!ep) {
+            continue;
+        }
+        core_pooled_conn_t* dead = NULL;
+        pthread_mutex_lock(&ep->mutex);
+        for (core_pooled_conn_t** link = &ep->idle; *link;) {
+            core_pooled_conn_t* conn = *link;
+            if (cp_alive(pool, conn, now)) {
+                link = &conn->next;
+                continue;
+            }
+            *link = conn->next;
+            ep->idle_count--;
+            conn->next = dead;
+            dead = conn;
+        }
+        pthread_mutex_unlock(&ep->mutex);
+        while (dead) {
+            core_pooled_conn_t* conn = dead;
+            dead = conn->next;
+            cp_count(&pool->idle, -1);
+            cp_close(pool, conn);
+            closed++;
+        }
+    }
+    cp_count(&pool->reaped, (int64_t)closed);
+    return closed;
+}
+
+void core_conn_pool_stats(const core_conn_pool_t* pool, core_conn_pool_stats_t* stats) {
+    if (!pool || !stats) {
+        return;
+    }
+    stats->connects = __atomic_load_n(&pool->connects, __ATOMIC_RELAXED);
+    stats->reuses = __atomic_load_n(&pool->reuses, __ATOMIC_RELAXED);
+    stats->validation_failures = __atomic_load_n(&pool->validation_failures, __ATOMIC_RELAXED);
+    stats->reaped = __atomic_load_n(&pool->reaped, __ATOMIC_RELAXED);
+    stats->open = __atomic_load_n(&pool->open, __ATOMIC_RELAXED);
+    stats->idle = __atomic_load_n(&pool->idle, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,783 @@
+#include "core/drivers/conv_ops.h"
+#include "core/drivers/fft_ops.h"
+#include "core/drivers/gemm_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Все варианты сводятся к одной задаче: in_channels плоскостей входа,
+// out_channels плоскостей выхода, ядра [out][in][kernel_h][kernel_w].
+// Одномерный пакет — это плоскость из count строк с ядром высоты 1.
+// Каждый алгоритм режет выход на задачи исполнителя (выходной канал x полоса
+// строк), задачи пишут непересекающиеся части выхода.
+
+#define CONV_ALIGNMENT 64
+#define CONV_DIRECT_COLS 512          // минимальная ширина куска строки в задаче прямого алгоритма
+#define CONV_WINOGRAD_BAND (1 << 18)  // float'ов преобразованных тайлов на полосу Винограда
+#define CONV_FFT_MIN 16               // наименьшая длина БПФ
+#define CONV_FFT_MAX (1 << 20)
+#define CONV_TASKS_PER_THREAD 4
+
+// Относительные стоимости для выбора алгоритма в долях умножения-сложения
+// прямого алгоритма, подобраны по compute_benchmark (ConvolutionAlgorithms).
+// Преобразования Винограда и БПФ упираются в перестановки и память, а не в FMA,
+// у Винограда ещё есть постоянная цена тайла (вызовы GEMM на малых матрицах).
+#define CONV_COST_GEMM 1.0
+#define CONV_COST_WINOGRAD_IN 80.0
+#define CONV_COST_WINOGRAD_OUT 60.0
+#define CONV_COST_WINOGRAD_TILE 500.0
+#define CONV_COST_FFT 7.5
+#define CONV_COST_CMAC 7.0
+
+#if defined(__AVX512F__)
+
+#define CF_W 16
+typedef __m512 cf_t;
+static inline cf_t cf_load(const float* p) { return _mm512_loadu_ps(p); }
+static inline void cf_store(float* p, cf_t v) { _mm512_storeu_ps(p, v); }
+static inline cf_t cf_set1(float x) { return _mm512_set1_ps(x); }
+static inline cf_t cf_zero(void) { return _mm512_setzero_ps(); }
+static inline cf_t cf_add(cf_t a, cf_t b) { return _mm512_add_ps(a, b); }
+static inline cf_t cf_sub(cf_t a, cf_t b) { return _mm512_sub_ps(a, b); }
+static inline cf_t cf_fma(cf_t a, cf_t b, cf_t c) { return _mm512_fmadd_ps(a, b, c); }
+// (re, im) -> (im, re) в каждой комплексной паре
+static inline cf_t cf_swap(cf_t a) { return _mm512_permute_ps(a, 0xB1); }
+
+#elif defined(__AVX2__)
+
+#define CF_W 8
+typedef __m256 cf_t;
+static inline cf_t cf_load(const float* p) { return _mm256_loadu_ps(p); }
+static inline void cf_store(float* p, cf_t v) { _mm256_storeu_ps(p, v); }
+static inline cf_t cf_set1(float x) { return _mm256_set1_ps(x); }
+static inline cf_t cf_zero(void) { return _mm256_setzero_ps(); }
+static inline cf_t cf_add(cf_t a, cf_t b) { return _mm256_add_ps(a, b); }
+static inline cf_t cf_sub(cf_t a, cf_t b) { return _mm256_sub_ps(a, b); }
+#if defined(__FMA__)
+static inline cf_t cf_fma(cf_t a, cf_t b, cf_t c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+static inline cf_t cf_fma(cf_t a, cf_t b, cf_t c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+static inline cf_t cf_swap(cf_t a) { return _mm256_permute_ps(a, 0xB1); }
+
+#elif defined(__SSE4_2__)
+
+#define CF_W 4
+typedef __m128 cf_t;
+static inline cf_t cf_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void cf_store(float* p, cf_t v) { _mm_storeu_ps(p, v); }
+static inline cf_t cf_set1(float x) { return _mm_set1_ps(x); }
+static inline cf_t cf_zero(void) { return _mm_setzero_ps(); }
+static inline cf_t cf_add(cf_t a, cf_t b) { return _mm_add_ps(a, b); }
+static inline cf_t cf_sub(cf_t a, cf_t b) { return _mm_sub_ps(a, b); }
+static inline cf_t cf_fma(cf_t a, cf_t b, cf_t c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+static inline cf_t cf_swap(cf_t a) { return _mm_shuffle_ps(a, a, 0xB1); }
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+#define CF_W 4
+typedef float32x4_t cf_t;
+static inline cf_t cf_load(const float* p) { return vld1q_f32(p); }
+static inline void cf_store(float* p, cf_t v) { vst1q_f32(p, v); }
+static inline cf_t cf_set1(float x) { return vdupq_n_f32(x); }
+static inline cf_t cf_zero(void) { return vdupq_n_f32(0.0f); }
+static inline cf_t cf_add(cf_t a, cf_t b) { return vaddq_f32(a, b); }
+static inline cf_t cf_sub(cf_t a, cf_t b) { return vsubq_f32(a, b); }
+static inline cf_t cf_fma(cf_t a, cf_t b, cf_t c) { return vfmaq_f32(c, a, b); }
+static inline cf_t cf_swap(cf_t a) { return vrev64q_f32(a); }
+
+#else
+
+// Без SIMD комплексные пары обрабатываются скалярным хвостом cmac, cf_swap не нужен
+#define CF_W 1
+typedef float cf_t;
+static inline cf_t cf_load(const float* p) { return *p; }
+static inline void cf_store(float* p, cf_t v) { *p = v; }
+static inline cf_t cf_set1(float x) { return x; }
+static inline cf_t cf_zero(void) { return 0.0f; }
+static inline cf_t cf_add(cf_t a, cf_t b) { return a + b; }
+static inline cf_t cf_sub(cf_t a, cf_t b) { return a - b; }
+static inline cf_t cf_fma(cf_t a, cf_t b, cf_t c) { return a * b + c; }
+
+#endif
+
+static inline size_t conv_min(size_t a, size_t b) { return a < b ? a : b; }
+static inline size_t conv_max(size_t a, size_t b) { return a > b ? a : b; }
+static inline size_t conv_div_up(size_t a, size_t b) { return (a + b - 1) / b; }
+static inline size_t conv_round_up(size_t x, size_t m) { return conv_div_up(x, m) * m; }
+
+static void* conv_alloc(size_t bytes) {
+    void* ptr = NULL;
+    if (posix_memalign(&ptr, CONV_ALIGNMENT, bytes ? bytes : CONV_ALIGNMENT) != 0) {
+        return NULL;
+    }
+    return ptr;
+}
+
+static size_t conv_threads(const core_executor_t* executor) {
+    return executor && executor->num_threads > 1 ? executor->num_threads : 1;
+}
+
+typedef struct {
+    const float* in;
+    size_t in_stride;
+    size_t in_plane;
+    size_t width;
+    size_t height;
+    size_t in_channels;
+    const float* kernel;
+    size_t kernel_w;
+    size_t kernel_h;
+    float* out;
+    size_t out_stride;
+    size_t out_plane;
+    size_t out_channels;
+    size_t out_w;
+    size_t out_h;
+    int status;
+    // Разбиение: задача — (выходной канал, полоса строк, кусок столбцов)
+    size_t band_rows;
+    size_t num_bands;
+    size_t chunk_cols;
+    size_t num_chunks;
+    // Виноград: U[16][out_channels][in_channels], тайлы 2x2 выхода
+    const float* wino_u;
+    size_t tiles_x;
+    size_t tiles_y;
+    size_t tiles_stride;  // tiles_x, дополненное до CF_W
+    // БПФ: отрезки по seg_len выходов, bins = fft_n / 2 + 1. Спектры входа
+    // [in_channels][height][num_segs][2 * bins]; спектры ядра
+    // [out][in][kernel_h][4 * bins]: (re, re) и (im, -im) для умножения на сопряжённое
+    const core_fft_plan_t* plan;
+    size_t fft_n;
+    size_t seg_len;
+    size_t num_segs;
+    size_t bins;
+    float* spectra;
+    const float* kernel_spectra;
+} conv_job_t;
+
+static void conv_fail(conv_job_t* job, int status) {
+    __atomic_store_n(&job->status, status, __ATOMIC_RELAXED);
+}
+
+// ---- Оценка стоимости. Все оценки — в векторных операциях на всю задачу.
+
+static double conv_cost_direct(size_t out_w, size_t out_h, size_t kernel_w, size_t kernel_h,
+                               size_t in_channels, size_t out_channels) {
+    return (double)out_w * (double)out_h * (double)(kernel_w * kernel_h) *
+           (double)(in_channels * out_channels) / CF_W;
+}
+
+static double conv_cost_winograd(size_t out_w, size_t out_h, size_t in_channels, size_t out_channels) {
+    double tiles = (double)conv_div_up(out_w, 2) * (double)conv_div_up(out_h, 2);
+    return tiles * (CONV_COST_WINOGRAD_IN * (double)in_channels +
+                    CONV_COST_WINOGRAD_OUT * (double)out_channels + CONV_COST_WINOGRAD_TILE +
+                    16.0 * CONV_COST_GEMM * (double)(in_channels * out_channels)) / CF_W;
+}
+
+static double conv_cost_fft_length(size_t n, size_t out_w, size_t height, size_t out_h, size_t kernel_w,
+                                   size_t kernel_h, size_t in_channels, size_t out_channels) {
+    double segs = (double)conv_div_up(out_w, n - kernel_w + 1);
+    double transform = CONV_COST_FFT * (double)n * log2((double)n) / CF_W;
+    double bins = (double)(n / 2 + 1);
+    double forward = (double)(in_channels * height) * segs * transform;
+    double products = (double)(out_channels * out_h) * segs *
+                      (double)(in_channels * kernel_h) * bins * CONV_COST_CMAC / CF_W * 2.0;
+    double inverse = (double)(out_channels * out_h) * segs * transform;
+    return forward + products + inverse;
+}
+
+// Чётная длина с множителями 2, 3, 5 и наименьшей оценкой стоимости: от
+// 2 * kernel_w до вдвое большей, чем нужна для покрытия строки одним отрезком
+static size_t conv_fft_length(size_t out_w, size_t height, size_t out_h, size_t kernel_w, size_t kernel_h,
+                              size_t in_channels, size_t out_channels, double* cost) {
+    size_t first = conv_max(CONV_FFT_MIN, 2 * kernel_w);
+    size_t last = conv_min(CONV_FFT_MAX, 2 * conv_max(first, out_w + kernel_w - 1));
+    size_t best = 0;
+    double best_cost = HUGE_VAL;
+    for (size_t p2 = 2; p2 <= last; p2 *= 2) {
+        for (size_t p3 = p2; p3 <= last; p3 *= 3) {
+            for (size_t n = p3; n <= last; n *= 5) {
+                if (n < first) {
+                    continue;
+                }
+                double c = conv_cost_fft_length(n, out_w, height, out_h, kernel_w, kernel_h,
+                                                in_channels, out_channels);
+                if (c < best_cost || (c == best_cost && n < best)) {
+                    best_cost = c;
+                    best = n;
+                }
+            }
+        }
+    }
+    if (cost) {
+        *cost = best_cost;
+    }
+    return best;
+}
+
+int core_conv_select(size_t width, size_t height, size_t kernel_w, size_t kernel_h,
+                     size_t in_channels, size_t out_channels) {
+    if (kernel_w == 0 || kernel_h == 0 || kernel_w > width || kernel_h > height) {
+        return CORE_CONV_DIRECT;
+    }
+    size_t out_w = width - kernel_w + 1, out_h = height - kernel_h + 1;
+    in_channels = conv_max(in_channels, 1);
+    out_channels = conv_max(out_channels, 1);
+
+    int best = CORE_CONV_DIRECT;
+    double best_cost = conv_cost_direct(out_w, out_h, kernel_w, kernel_h, in_channels, out_channels);
+    if (kernel_w == 3 && kernel_h == 3) {
+        double c = conv_cost_winograd(out_w, out_h, in_channels, out_channels);
+        if (c < best_cost) {
+            best = CORE_CONV_WINOGRAD;
+            best_cost = c;
+        }
+    }
+    double fft_cost = HUGE_VAL;
+    if (conv_fft_length(out_w, height, out_h, kernel_w, kernel_h, in_channels, out_channels, &fft_cost) &&
+        fft_cost < best_cost) {
+        best = CORE_CONV_FFT;
+    }
+    return best;
+}
+
+// ---- Прямой алгоритм: четыре вектора выходов на итерацию, чтобы скрыть
+// задержку FMA и переиспользовать загруженный коэффициент ядра.
+
+static void direct_row(const conv_job_t* job, size_t oc, size_t y, size_t x0, size_t x1) {
+    const size_t kw = job->kernel_w, kh = job->kernel_h, ic_n = job->in_channels;
+    const float* kernels = job->kernel + oc * ic_n * kh * kw;
+    float* dst = job->out + oc * job->out_plane + y * job->out_stride;
+    size_t x = x0;
+
+    for (; x + 4 * CF_W <= x1; x += 4 * CF_W) {
+        cf_t a0 = cf_zero(), a1 = cf_zero(), a2 = cf_zero(), a3 = cf_zero();
+        for (size_t ic = 0; ic < ic_n; ++ic) {
+            for (size_t r = 0; r < kh; ++r) {
+                const float* src = job->in + ic * job->in_plane + (y + r) * job->in_stride + x;
+                const float* k = kernels + (ic * kh + r) * kw;
+                for (size_t c = 0; c < kw; ++c) {
+                    cf_t w = cf_set1(k[c]);
+                    a0 = cf_fma(w, cf_load(src + c), a0);
+                    a1 = cf_fma(w, cf_load(src + c + CF_W), a1);
+                    a2 = cf_fma(w, cf_load(src + c + 2 * CF_W), a2);
+                    a3 = cf_fma(w, cf_load(src + c + 3 * CF_W), a3);
+                }
+            }
+        }
+        cf_store(dst + x, a0);
+        cf_store(dst + x + CF_W, a1);
+        cf_store(dst + x + 2 * CF_W, a2);
+        cf_store(dst + x + 3 * CF_W, a3);
+    }
+    // Хвост короче вектора — последним вектором, перекрывающимся с уже посчитанными
+    // выходами (они пересчитываются в том же порядке и не меняются)
+    for (; x < x1 && x1 - x0 >= CF_W; x += CF_W) {
+        x = conv_min(x, x1 - CF_W);
+        cf_t acc = cf_zero();
+        for (size_t ic = 0; ic < ic_n; ++ic) {
+            for (size_t r = 0; r < kh; ++r) {
+                const float* src = job->in + ic * job->in_plane + (y + r) * job->in_stride + x;
+                const float* k = kernels + (ic * kh + r) * kw;
+                for (size_t c = 0; c < kw; ++c) {
+                    acc = cf_fma(cf_set1(k[c]), cf_load(src + c), acc);
+                }
+            }
+        }
+        cf_store(dst + x, acc);
+    }
+    for (; x < x1; ++x) {
+        float acc = 0.0f;
+        for (size_t ic = 0; ic < ic_n; ++ic) {
+            for (size_t r = 0; r < kh; ++r) {
+                const float* src = job->in + ic * job->in_plane + (y + r) * job->in_stride + x;
+                const float* k = kernels + (ic * kh + r) * kw;
+                for (size_t c = 0; c < kw; ++c) {
+                    acc = fmaf(k[c], src[c], acc);
+                }
+            }
+        }
+        dst[x] = acc;
+    }
+}
+
+static void direct_task(void* arg, size_t index) {
+    conv_job_t* job = (conv_job_t*)arg;
+    size_t chunk = index % job->num_chunks;
+    size_t band = index / job->num_chunks % job->num_bands;
+    size_t oc = index / (job->num_chunks * job->num_bands);
+    size_t y0 = band * job->band_rows, y1 = conv_min(y0 + job->band_rows, job->out_h);
+    size_t x0 = chunk * job->chunk_cols, x1 = conv_min(x0 + job->chunk_cols, job->out_w);
+    for (size_t y = y0; y < y1; ++y) {
+        direct_row(job, oc, y, x0, x1);
+    }
+}
+
+static int conv_direct(conv_job_t* job, const core_executor_t* executor) {
+    size_t target = conv_threads(executor) * CONV_TASKS_PER_THREAD;
+    size_t rows = job->out_channels * job->out_h;
+    if (rows >= target) {
+        // Достаточно строк: задача — полоса целых строк
+        job->band_rows = conv_max(1, rows / target);
+        job->chunk_cols = job->out_w;
+    } else {
+        // Мало строк (одномерный случай): строки режутся на куски
+        job->band_rows = 1;
+        size_t cols = conv_div_up(job->out_w * rows, target);
+        job->chunk_cols = conv_round_up(conv_max(CONV_DIRECT_COLS, cols), 4 * CF_W);
+    }
+    job->band_rows = conv_min(job->band_rows, job->out_h);
+    job->num_bands = conv_div_up(job->out_h, job->band_rows);
+    job->num_chunks = conv_div_up(job->out_w, job->chunk_cols);
+    core_parallel_for(executor, job->out_channels * job->num_bands * job->num_chunks, direct_task, job);
+    return job->status;
+}
+
+// ---- Виноград F(2x2, 3x3): Y = A^T [sum_i (G g_i G^T) . (B^T d_i B)] A.
+// Тайл 4x4 входа даёт 2x2 выхода. Строки входа заранее разводятся на чётные и
+// нечётные элементы, тогда четыре столбца тайлов t..t+CF_W-1 — это четыре
+// сплошных вектора: чётные с t, нечётные с t, чётные с t + 1, нечётные с t + 1.
+// Для каждой из 16 позиций тайла сумма по входным каналам — GEMM
+// M[xi] (out x tiles) = U[xi] (out x in) * V[xi] (in x tiles).
+
+static void winograd_kernel_transform(const float* g, float* u, size_t stride) {
+    float t[4][3];
+    for (size_t c = 0; c < 3; ++c) {
+        t[0][c] = g[c];
+        t[1][c] = 0.5f * (g[c] + g[3 + c] + g[6 + c]);
+        t[2][c] = 0.5f * (g[c] - g[3 + c] + g[6 + c]);
+        t[3][c] = g[6 + c];
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        u[(i * 4 + 0) * stride] = t[i][0];
+        u[(i * 4 + 1) * stride] = 0.5f * (t[i][0] + t[i][1] + t[i][2]);
+        u[(i * 4 + 2) * stride] = 0.5f * (t[i][0] - t[i][1] + t[i][2]);
+        u[(i * 4 + 3) * stride] = t[i][2];
+    }
+}
+
+static void winograd_split_row(const conv_job_t* job, const float* src, size_t count, float* even, float* odd) {
+    for (size_t t = 0; t < count; ++t) {
+        even[t] = src && 2 * t < job->width ? src[2 * t] : 0.0f;
+        odd[t] = src && 2 * t + 1 < job->width ? src[2 * t + 1] : 0.0f;
+    }
+}
+
+static void winograd_input(const conv_job_t* job, size_t ic, size_t ty, float* split, float* v,
+                           size_t tiles) {
+    const size_t stride = job->tiles_stride, split_len = stride + CF_W;
+    const float* rows[4];
+    for (size_t i = 0; i < 4; ++i) {
+        size_t y = 2 * ty + i;
+        const float* src = y < job->height ? job->in + ic * job->in_plane + y * job->in_stride : NULL;
+        winograd_split_row(job, src, split_len, split + 2 * i * split_len, split + (2 * i + 1) * split_len);
+        rows[i] = split + 2 * i * split_len;
+    }
+    for (size_t t = 0; t < stride; t += CF_W) {
+        cf_t d[4][4];
+        for (size_t i = 0; i < 4; ++i) {
+            const float* even = rows[i];
+            const float* odd = rows[i] + split_len;
+            cf_t d0 = cf_load(even + t), d1 = cf_load(odd + t);
+            cf_t d2 = cf_load(even + t + 1), d3 = cf_load(odd + t + 1);
+            d[i][0] = cf_sub(d0, d2);
+            d[i][1] = cf_add(d1, d2);
+            d[i][2] = cf_sub(d2, d1);
+            d[i][3] = cf_sub(d1, d3);
+        }
+        for (size_t j = 0; j < 4; ++j) {
+            cf_store(v + (0 * 4 + j) * tiles + t, cf_sub(d[0][j], d[2][j]));
+            cf_store(v + (1 * 4 + j) * tiles + t, cf_add(d[1][j], d[2][j]));
+            cf_store(v + (2 * 4 + j) * tiles + t, cf_sub(d[2][j], d[1][j]));
+            cf_store(v + (3 * 4 + j) * tiles + t, cf_sub(d[1][j], d[3][j]));
+        }
+    }
+}
+
+static void winograd_output(const conv_job_t* job, size_t oc, size_t ty, const float* m, size_t tiles,
+                            float* tmp) {
+    const size_t stride = job->tiles_stride;
+    for (size_t t = 0; t < stride; t += CF_W) {
+        cf_t s[4][2];
+        for (size_t i = 0; i < 4; ++i) {
+            cf_t m0 = cf_load(m + (i * 4 + 0) * tiles + t), m1 = cf_load(m + (i * 4 + 1) * tiles + t);
+            cf_t m2 = cf_load(m + (i * 4 + 2) * tiles + t), m3 = cf_load(m + (i * 4 + 3) * tiles + t);
+            s[i][0] = cf_add(cf_add(m0, m1), m2);
+            s[i][1] = cf_sub(cf_sub(m1, m2), m3);
+        }
+        for (size_t c = 0; c < 2; ++c) {
+            cf_store(tmp + (0 * 2 + c) * stride + t, cf_add(cf_add(s[0][c], s[1][c]), s[2][c]));
+            cf_store(tmp + (1 * 2 + c) * stride + t, cf_sub(cf_sub(s[1][c], s[2][c]), s[3][c]));
+        }
+    }
+    for (size_t r = 0; r < 2 && 2 * ty + r < job->out_h; ++r) {
+        float* dst = job->out + oc * job->out_plane + (2 * ty + r) * job->out_stride;
+        const float* y0 = tmp + (r * 2 + 0) * stride;
+        const float* y1 = tmp + (r * 2 + 1) * stride;
+        size_t t = 0;
+        for (; 2 * t + 1 < job->out_w; ++t) {
+            dst[2 * t] = y0[t];
+            dst[2 * t + 1] = y1[t];
+        }
+        if (2 * t < job->out_w) {
+            dst[2 * t] = y0[t];
+        }
+    }
+}
+
+static void winograd_task(void* arg, size_t band) {
+    conv_job_t* job = (conv_job_t*)arg;
+    const size_t ic_n = job->in_channels, oc_n = job->out_channels, stride = job->tiles_stride;
+    size_t ty0 = band * job->band_rows, ty1 = conv_min(ty0 + job->band_rows, job->tiles_y);
+    size_t tiles = (ty1 - ty0) * stride;
+    float* v = (float*)conv_alloc(16 * ic_n * tiles * sizeof(float));
+    float* m = (float*)conv_alloc(16 * oc_n * tiles * sizeof(float));
+    float* split = (float*)conv_alloc(8 * (stride + CF_W) * sizeof(float));
+    float* tmp = (float*)conv_alloc(4 * stride * sizeof(float));
+    if (!v || !m || !split || !tmp) {
+        conv_fail(job, CORE_ERR_NOMEM);
+        goto done;
+    }
+
+    // V[xi][ic][tile]: 16 матриц in x tiles
+    for (size_t ic = 0; ic < ic_n; ++ic) {
+        for (size_t ty = ty0; ty < ty1; ++ty) {
+            winograd_input(job, ic, ty, split, v + ic * tiles + (ty - ty0) * stride, ic_n * tiles);
+        }
+    }
+    for (size_t xi = 0; xi < 16; ++xi) {
+        int status = core_gemm_f32(CORE_GEMM_NO_TRANS, CORE_GEMM_NO_TRANS, oc_n, tiles, ic_n,
+                                   1.0f, job->wino_u + xi * oc_n * ic_n, ic_n, v + xi * ic_n * tiles, tiles,
+                                   0.0f, m + xi * oc_n * tiles, tiles, NULL);
+        if (status != CORE_SUCCESS) {
+            conv_fail(job, status);
+            goto done;
+        }
+    }
+    for (size_t oc = 0; oc < oc_n; ++oc) {
+        for (size_t ty = ty0; ty < ty1; ++ty) {
+            winograd_output(job, oc, ty, m + oc * tiles + (ty - ty0) * stride, oc_n * tiles, tmp);
+        }
+    }
+
+done:
+    free(v);
+    free(m);
+    free(split);
+    free(tmp);
+}
+
+static int conv_winograd(conv_job_t* job, const core_executor_t* executor) {
+    const size_t ic_n = job->in_channels, oc_n = job->out_channels;
+    job->tiles_x = conv_div_up(job->out_w, 2);
+    job->tiles_y = conv_div_up(job->out_h, 2);
+    job->tiles_stride = conv_round_up(job->tiles_x, CF_W);
+
+    float* u = (float*)conv_alloc(16 * oc_n * ic_n * sizeof(float));
+    if (!u) {
+        return CORE_ERR_NOMEM;
+    }
+    for (size_t oc = 0; oc < oc_n; ++oc) {
+        for (size_t ic = 0; ic < ic_n; ++ic) {
+            winograd_kernel_transform(job->kernel + (oc * ic_n + ic) * 9, u + oc * ic_n + ic, oc_n * ic_n);
+        }
+    }
+    job->wino_u = u;
+
+    // Полоса тайловых строк: преобразованные тайлы в пределах CONV_WINOGRAD_BAND,
+    // но не меньше CONV_TASKS_PER_THREAD полос на поток, если строк хватает
+    size_t per_row = 16 * (ic_n + oc_n) * job->tiles_stride;
+    size_t rows = conv_max(1, CONV_WINOGRAD_BAND / per_row);
+    size_t target = conv_threads(executor) * CONV_TASKS_PER_THREAD;
+    if (target > 1) {
+        rows = conv_min(rows, conv_max(1, job->tiles_y / target));
+    }
+    job->band_rows = conv_min(rows, job->tiles_y);
+    job->num_bands = conv_div_up(job->tiles_y, job->band_rows);
+    core_parallel_for(executor, job->num_bands, winograd_task, job);
+    free(u);
+    job->wino_u = NULL;
+    return job->status;
+}
+
+// ---- БПФ, overlap-save по строкам. Отрезок s строки входа длины fft_n,
+// начиная с s * seg_len, коррелируется с дополненной нулями строкой ядра:
+// первые seg_len = fft_n - kernel_w + 1 отсчётов циклической корреляции
+// совпадают с обычной. Корреляция — умножение на сопряжённый спектр ядра,
+// а сумма по строкам ядра и каналам делается прямо в частотной области.
+
+// acc += x * conj(k); k хранится как (re, re) и (im, -im) для каждого бина
+static void fft_cmac(float* acc, const float* x, const float* k, size_t bins) {
+    const float* k_re = k;
+    const float* k_im = k + 2 * bins;
+    size_t i = 0;
+#if CF_W > 1
+    for (; i + CF_W <= 2 * bins; i += CF_W) {
+        cf_t xv = cf_load(x + i);
+        cf_t a = cf_fma(xv, cf_load(k_re + i), cf_load(acc + i));
+        cf_store(acc + i, cf_fma(cf_swap(xv), cf_load(k_im + i), a));
+    }
+#endif
+    for (; i < 2 * bins; i += 2) {
+        acc[i] += x[i] * k_re[i] + x[i + 1] * k_im[i];
+        acc[i + 1] += x[i + 1] * k_re[i + 1] + x[i] * k_im[i + 1];
+    }
+}
+
+static float* fft_spectrum(const conv_job_t* job, size_t ic, size_t y) {
+    return job->spectra + ((ic * job->height + y) * job->num_segs) * 2 * job->bins;
+}
+
+// Прямые БПФ всех отрезков строк: целые отрезки пакетом прямо из входа,
+// хвостовые — через буфер с нулями
+static void fft_forward_task(void* arg, size_t band) {
+    conv_job_t* job = (conv_job_t*)arg;
+    const size_t n = job->fft_n, rows = job->in_channels * job->height;
+    size_t r0 = band * job->band_rows, r1 = conv_min(r0 + job->band_rows, rows);
+    size_t full = job->width >= n ? (job->width - n) / job->seg_len + 1 : 0;
+    full = conv_min(full, job->num_segs);
+    float* pad = (float*)conv_alloc(n * sizeof(float));
+    if (!pad) {
+        conv_fail(job, CORE_ERR_NOMEM);
+        return;
+    }
+    for (size_t row = r0; row < r1; ++row) {
+        size_t ic = row / job->height, y = row % job->height;
+        const float* src = job->in + ic * job->in_plane + y * job->in_stride;
+        float* spec = fft_spectrum(job, ic, y);
+        int status = core_fft_r2c_batch(job->plan, full, src, job->seg_len, spec, 2 * job->bins);
+        for (size_t s = full; s < job->num_segs && status == CORE_SUCCESS; ++s) {
+            size_t x0 = s * job->seg_len;
+            size_t len = conv_min(n, job->width - x0);
+            memcpy(pad, src + x0, len * sizeof(float));
+            memset(pad + len, 0, (n - len) * sizeof(float));
+            status = core_fft_r2c(job->plan, pad, spec + s * 2 * job->bins);
+        }
+        if (status != CORE_SUCCESS) {
+            conv_fail(job, status);
+            break;
+        }
+    }
+    free(pad);
+}
+
+static void fft_output_task(void* arg, size_t index) {
+    conv_job_t* job = (conv_job_t*)arg;
+    const size_t ic_n = job->in_channels, kh = job->kernel_h, segs = job->num_segs;
+    const size_t spec_len = 2 * job->bins, n = job->fft_n;
+    size_t band = index % job->num_bands, oc = index / job->num_bands;
+    size_t y0 = band * job->band_rows, y1 = conv_min(y0 + job->band_rows, job->out_h);
+    float* acc = (float*)conv_alloc(segs * spec_len * sizeof(float));
+    float* time = (float*)conv_alloc(segs * n * sizeof(float));
+    if (!acc || !time) {
+        conv_fail(job, CORE_ERR_NOMEM);
+        goto done;
+    }
+
+    for (size_t y = y0; y < y1; ++y) {
+        memset(acc, 0, segs * spec_len * sizeof(float));
+        for (size_t ic = 0; ic < ic_n; ++ic) {
+            for (size_t r = 0; r < kh; ++r) {
+                const float* x = fft_spectrum(job, ic, y + r);
+                const float* k = job->kernel_spectra + ((oc * ic_n + ic) * kh + r) * 2 * spec_len;
+                for (size_t s = 0; s < segs; ++s) {
+                    fft_cmac(acc + s * spec_len, x + s * spec_len, k, job->bins);
+                }
+            }
+        }
+        int status = core_fft_c2r_batch(job->plan, segs, acc, spec_len, time, n);
+        if (status != CORE_SUCCESS) {
+            conv_fail(job, status);
+            break;
+        }
+        float* dst = job->out + oc * job->out_plane + y * job->out_stride;
+        for (size_t s = 0; s < segs; ++s) {
+            size_t x0 = s * job->seg_len;
+            memcpy(dst + x0, time + s * n, conv_min(job->seg_len, job->out_w - x0) * sizeof(float));
+        }
+    }
+
+done:
+    free(acc);
+    free(time);
+}
+
+static int conv_fft(conv_job_t* job, const core_executor_t* executor) {
+    const size_t ic_n = job->in_channels, oc_n = job->out_channels, kh = job->kernel_h, kw = job->kernel_w;
+    size_t n = conv_fft_length(job->out_w, job->height, job->out_h, kw, kh, ic_n, oc_n, NULL);
+    if (n == 0) {
+        return CORE_ERR_INVALID;
+    }
+    job->plan = core_fft_plan_cached(CORE_FFT_R2C, n);
+    if (!job->plan) {
+        return CORE_ERR_NOMEM;
+    }
+    job->fft_n = n;
+    job->seg_len = n - kw + 1;
+    job->num_segs = conv_div_up(job->out_w, job->seg_len);
+    job->bins = n / 2 + 1;
+    const size_t spec_len = 2 * job->bins;
+
+    job->spectra = (float*)conv_alloc(ic_n * job->height * job->num_segs * spec_len * sizeof(float));
+    float* kernel_spectra = (float*)conv_alloc(oc_n * ic_n * kh * 2 * spec_len * sizeof(float));
+    float* pad = (float*)conv_alloc(n * sizeof(float));
+    int status = job->spectra && kernel_spectra && pad ? CORE_SUCCESS : CORE_ERR_NOMEM;
+
+    // Спектры строк ядер, развёрнутые для fft_cmac
+    for (size_t row = 0; row < oc_n * ic_n * kh && status == CORE_SUCCESS; ++row) {
+        float* k = kernel_spectra + row * 2 * spec_len;
+        memcpy(pad, job->kernel + row * kw, kw * sizeof(float));
+        memset(pad + kw, 0, (n - kw) * sizeof(float));
+        status = core_fft_r2c(job->plan, pad, k);
+        for (size_t b = 0; b < spec_len; b += 2) {
+            float im = k[b + 1];
+            k[b + 1] = k[b];
+            k[spec_len + b] = im;
+            k[spec_len + b + 1] = -im;
+        }
+    }
+    job->kernel_spectra = kernel_spectra;
+
+    size_t target = conv_threads(executor) * CONV_TASKS_PER_THREAD;
+    if (status == CORE_SUCCESS) {
+        size_t rows = ic_n * job->height;
+        job->band_rows = conv_max(1, rows / target);
+        core_parallel_for(executor, conv_div_up(rows, job->band_rows), fft_forward_task, job);
+        status = job->status;
+    }
+    if (status == CORE_SUCCESS) {
+        job->band_rows = conv_max(1, conv_min(job->out_h, oc_n * job->out_h / target));
+        job->num_bands = conv_div_up(job->out_h, job->band_rows);
+        core_parallel_for(executor, oc_n * job->num_bands, fft_output_task, job);
+        status = job->status;
+    }
+
+    free(job->spectra);
+    free(kernel_spectra);
+    free(pad);
+    job->spectra = NULL;
+    job->kernel_spectra = NULL;
+    return status;
+}
+
+static int conv_run(conv_job_t* job, int algorithm, const core_executor_t* executor) {
+    job->out_w = job->width - job->kernel_w + 1;
+    job->out_h = job->height - job->kernel_h + 1;
+    job->status = CORE_SUCCESS;
+    if (algorithm == CORE_CONV_AUTO) {
+        algorithm = core_conv_select(job->width, job->height, job->kernel_w, job->kernel_h,
+                                     job->in_channels, job->out_channels);
+    }
+    switch (algorithm) {
+    case CORE_CONV_DIRECT:
+        return conv_direct(job, executor);
+    case CORE_CONV_WINOGRAD:
+        return job->kernel_w == 3 && job->kernel_h == 3 ? conv_winograd(job, executor) : CORE_ERR_INVALID;
+    case CORE_CONV_FFT:
+        return conv_fft(job, executor);
+    default:
+        return CORE_ERR_INVALID;
+    }
+}
+
+static int conv_check(const float* in, const float* kernel, const float* out, size_t width, size_t height,
+                      size_t kernel_w, size_t kernel_h) {
+    if (!in || !kernel || !out || kernel_w == 0 || kernel_h == 0 || kernel_w > width || kernel_h > height) {
+        return CORE_ERR_INVALID;
+    }
+    return CORE_SUCCESS;
+}
+
+int core_conv1d_f32(const float* in, size_t in_size, const float* kernel, size_t kernel_size,
+                    float* out, int algorithm, const core_executor_t* executor) {
+    return core_conv1d_f32_batch(1, in, in_size, in_size, kernel, kernel_size, out, in_size,
+                                 algorithm, executor);
+}
+
+int core_conv1d_f32_batch(size_t count, const float* in, size_t in_dist, size_t in_size,
+                          const float* kernel, size_t kernel_size, float* out, size_t out_dist,
+                          int algorithm, const core_executor_t* executor) {
+    if (count == 0) {
+        return CORE_SUCCESS;
+    }
+    int status = conv_check(in, kernel, out, in_size, 1, kernel_size, 1);
+    if (status != CORE_SUCCESS || (count > 1 && (in_dist < in_size || out_dist < in_size - kernel_size + 1))) {
+        return status != CORE_SUCCESS ? status : CORE_ERR_INVALID;
+    }
+    conv_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.in = in;
+    job.in_stride = in_dist;
+    job.width = in_size;
+    job.height = count;
+    job.in_channels = 1;
+    job.kernel = kernel;
+    job.kernel_w = kernel_size;
+    job.kernel_h = 1;
+    job.out = out;
+    job.out_stride = out_dist;
+    job.out_channels = 1;
+    return conv_run(&job, algorithm, executor);
+}
+
+int core_conv2d_f32(const float* in, size_t in_stride, size_t width, size_t height,
+                    const float* kernel, size_t kernel_w, size_t kernel_h,
+                    float* out, size_t out_stride, int algorithm, const core_executor_t* executor) {
+    int status = conv_check(in, kernel, out, width, height, kernel_w, kernel_h);
+    if (status != CORE_SUCCESS || in_stride < width || out_stride < width - kernel_w + 1) {
+        return status != CORE_SUCCESS ? status : CORE_ERR_INVALID;
+    }
+    conv_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.in = in;
+    job.in_stride = in_stride;
+    job.width = width;
+    job.height = height;
+    job.in_channels = 1;
+    job.kernel = kernel;
+    job.kernel_w = kernel_w;
+    job.kernel_h = kernel_h;
+    job.out = out;
+    job.out_stride = out_stride;
+    job.out_channels = 1;
+    return conv_run(&job, algorithm, executor);
+}
+
+int core_conv2d_f32_multi(const float* in, size_t in_channels, size_t width, size_t height,
+                          const float* kernels, size_t kernel_w, size_t kernel_h,
+                          float* out, size_t out_channels, int algorithm,
+                          const core_executor_t* executor) {
+    if (out_channels == 0) {
+        return CORE_SUCCESS;
+    }
+    int status = conv_check(in, kernels, out, width, height, kernel_w, kernel_h);
+    if (status != CORE_SUCCESS || in_channels == 0) {
+        return status != CORE_SUCCESS ? status : CORE_ERR_INVALID;
+    }
+    conv_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.in = in;
+    job.in_stride = width;
+    job.in_plane = width * height;
+    job.width = width;
+    job.height = height;
+    job.in_channels = in_channels;
+    job.kernel = kernels;
+    job.kernel_w = kernel_w;
+    job.kernel_h = kernel_h;
+    job.out = out;
+    job.out_stride = width - kernel_w + 1;
+    job.out_plane = job.out_stride * (height - kernel_h + 1);
+    job.out_channels = out_channels;
+    return conv_run(&job, algorithm, executor);
+}
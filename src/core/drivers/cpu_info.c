@@ -2,6 +2,14 @@
 #if defined(__x86_64__)
 #include <cpuid.h>
 #endif
+#include "core/error_handling/core_errors.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 int core_cpu_arch() {
 #if defined(__x86_64__)
@@ -31,4 +39,105 @@ int core_cpu_has_neon() {
 #else
     return 0;
 #endif
-} 
\ No newline at end of file
+} 
+
+// Чтение одного атрибута кэша из sysfs; размеры вида "48K" / "32M" переводятся в байты
+static size_t read_cache_attr(int index, const char* attr) {
+#if defined(__linux__)
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/%s", index, attr);
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return 0;
+    }
+    char buf[64] = {0};
+    size_t value = 0;
+    if (fgets(buf, sizeof(buf), f)) {
+        char* end = NULL;
+        value = (size_t)strtoull(buf, &end, 10);
+        if (end && (*end == 'K' || *end == 'k')) value *= 1024;
+        else if (end && (*end == 'M' || *end == 'm')) value *= 1024 * 1024;
+    }
+    fclose(f);
+    return value;
+#else
+    (void)index;
+    (void)attr;
+    return 0;
+#endif
+}
+
+static int read_cache_is_data(int index) {
+#if defined(__linux__)
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/type", index);
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return 0;
+    }
+    char buf[32] = {0};
+    int is_data = fgets(buf, sizeof(buf), f) && (strncmp(buf, "Data", 4) == 0 || strncmp(buf, "Unified", 7) == 0);
+    fclose(f);
+    return is_data;
+#else
+    (void)index;
+    return 0;
+#endif
+}
+
+static void detect_cache_config(core_cache_config_t* config) {
+    static const size_t default_sizes[CORE_CACHE_MAX_LEVELS] = {32 * 1024, 256 * 1024, 8 * 1024 * 1024};
+    memset(config, 0, sizeof(*config));
+
+    for (int index = 0; index < 8; ++index) {
+        size_t level = read_cache_attr(index, "level");
+        if (level == 0 || level > CORE_CACHE_MAX_LEVELS || !read_cache_is_data(index)) {
+            continue;
+        }
+        core_cache_level_config_t* lvl = &config->levels[level - 1];
+        lvl->size = read_cache_attr(index, "size");
+        lvl->associativity = read_cache_attr(index, "ways_of_associativity");
+        lvl->line_size = read_cache_attr(index, "coherency_line_size");
+    }
+
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+    static const int sysconf_names[CORE_CACHE_MAX_LEVELS] = {
+        _SC_LEVEL1_DCACHE_SIZE, _SC_LEVEL2_CACHE_SIZE, _SC_LEVEL3_CACHE_SIZE
+    };
+#endif
+    for (size_t i = 0; i < CORE_CACHE_MAX_LEVELS; ++i) {
+        core_cache_level_config_t* lvl = &config->levels[i];
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+        if (lvl->size == 0) {
+            long size = sysconf(sysconf_names[i]);
+            if (size > 0) lvl->size = (size_t)size;
+        }
+#endif
+        if (lvl->size == 0) lvl->size = default_sizes[i];
+        if (lvl->line_size == 0) lvl->line_size = CORE_CACHE_LINE_SIZE;
+        if (lvl->associativity == 0) lvl->associativity = 8;
+    }
+    config->num_levels = CORE_CACHE_MAX_LEVELS;
+}
+
+#if !defined(_WIN32)
+static core_cache_config_t cached_cache_config;
+
+static void detect_cache_config_once() {
+    detect_cache_config(&cached_cache_config);
+}
+#endif
+
+int core_cpu_cache_config(core_cache_config_t* config) {
+    if (!config) {
+        return CORE_ERR_INVALID;
+    }
+#if defined(_WIN32)
+    detect_cache_config(config);
+#else
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, detect_cache_config_once);
+    *config = cached_cache_config;
+#endif
+    return CORE_SUCCESS;
+}
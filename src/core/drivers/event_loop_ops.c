@@ -0,0 +1,890 @@
+// POLLRDHUP для опроса через io_uring
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "core/drivers/event_loop_ops.h"
+#include "core/drivers/task_queue_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux__)
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+// Очередь функций от других потоков — стек Трайбера: постановщик кладёт узел
+// одним CAS и будит цикл через eventfd, только если стек был пуст; цикл
+// забирает стек целиком и разворачивает его в порядок постановки. Цикл
+// сбрасывает eventfd до того, как забрать стек, поэтому узел, положенный
+// после этого, либо будет забран сейчас, либо разбудит следующую итерацию.
+//
+// Таймеры лежат в массиве слотов, куча хранит номера слотов. id таймера —
+// номер слота и поколение слота, так что отмена уже сработавшего таймера
+// не заденет новый таймер в том же слоте.
+//
+// Вариант на io_uring: каждая подписка — многоразовый POLL_ADD, чья
+// user_data — адрес подписки. Запросы подаёт только поток цикла: ядро
+// доводит срабатывание опроса до CQE в контексте подавшего потока, и запрос,
+// поданный посторонним потоком, зависел бы от него (и отменялся бы с его
+// завершением). Подписка и снятие из других потоков идут через очередь
+// функций; поэтому armed, removing и кольцо подачи трогает один поток.
+// Снятие подаёт POLL_REMOVE, а память подписки освобождается только после
+// последнего CQE её запроса (без IORING_CQE_F_MORE). Запрос, завершённый
+// ядром сам (переполнение CQ, отмена), цикл подаёт заново.
+
+#define EL_MAX_EVENTS 128
+#define EL_OFFLOAD_THREADS 2
+#define EL_NO_POS UINT32_MAX
+#define EL_URING_ENTRIES 256
+#define EL_URING_CQ_ENTRIES 16384
+#define EL_URING_WAKE 0      // user_data опроса eventfd
+#define EL_URING_IGNORE 1    // user_data запросов POLL_REMOVE
+
+typedef struct el_post {
+    core_event_fn fn;
+    void* ctx;
+    struct el_post* next;
+    int owned;   // узел выделен циклом и освобождается после исполнения
+} el_post_t;
+
+struct core_event_watch {
+    el_post_t release;   // отложенное освобождение после удаления
+    core_event_cb cb;
+    void* ctx;
+    int fd;
+    int removed;
+    int armed;           // io_uring: запрос опроса в ядре
+    el_post_t arm;       // io_uring: подача и снятие из чужого потока
+    el_post_t disarm;
+};
+
+typedef struct {
+    uint64_t deadline_ns;
+    core_event_fn fn;
+    void* ctx;
+    uint32_t gen;
+    uint32_t heap_pos;   // EL_NO_POS — слот свободен
+    uint32_t next_free;
+} el_timer_t;
+
+typedef struct el_job {
+    el_post_t done;      // первым полем: освобождение узла освобождает задание
+    core_event_fn work;
+    struct el_job* next;
+} el_job_t;
+
+#if defined(__linux__)
+typedef struct {
+    int fd;
+    void* sq_map;
+    size_t sq_map_size;
+    void* cq_map;
+    size_t cq_map_size;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    uint32_t* sq_head;
+    uint32_t* sq_tail;
+    uint32_t* sq_array;
+    uint32_t sq_mask;
+    uint32_t sq_entries;
+    uint32_t* cq_head;
+    uint32_t* cq_tail;
+    struct io_uring_cqe* cqes;
+    uint32_t cq_mask;
+    uint32_t removing;   // снятые подписки, чей последний CQE ещё не пришёл
+    int wake_armed;
+} el_uring_t;
+#endif
+
+struct core_event_loop {
+    int backend;
+    int epfd;
+    int wakefd;
+    el_post_t* posts;
+    int stop;
+
+    el_timer_t* timers;
+    uint32_t timers_capacity;
+    uint32_t free_timer;
+    uint32_t* heap;
+    uint32_t heap_count;
+
+#if defined(__linux__)
+    pthread_mutex_t offload_mutex;
+    pthread_cond_t offload_cv;
+    pthread_t offload_threads[EL_OFFLOAD_THREADS];
+    el_uring_t ring;
+#endif
+    el_job_t* jobs_head;
+    el_job_t* jobs_tail;
+    int offload_started;
+    int offload_stop;
+};
+
+static __thread const core_event_loop_t* el_current_loop;
+
+#if defined(__linux__)
+
+static void el_push(core_event_loop_t* loop, el_post_t* node) {
+    el_post_t* head = __atomic_load_n(&loop->posts, __ATOMIC_RELAXED);
+    do {
+        node->next = head;
+    } while (!__atomic_compare_exchange_n(&loop->posts, &head, node, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    if (!head) {
+        uint64_t one = 1;
+        ssize_t r = write(loop->wakefd, &one, sizeof(one));
+        (void)r;
+    }
+}
+
+static size_t el_run_posts(core_event_loop_t* loop) {
+    el_post_t* node = __atomic_exchange_n(&loop->posts, NULL, __ATOMIC_ACQUIRE);
+    el_post_t* fifo = NULL;
+    while (node) {
+        el_post_t* next = node->next;
+        node->next = fifo;
+        fifo = node;
+        node = next;
+    }
+    size_t count = 0;
+    while (fifo) {
+        el_post_t* next = fifo->next;
+        int owned = fifo->owned;
+        fifo->fn(fifo->ctx);
+        if (owned) free(fifo);
+        fifo = next;
+        ++count;
+    }
+    return count;
+}
+
+static void el_read_wakefd(core_event_loop_t* loop) {
+    uint64_t value;
+    ssize_t r = read(loop->wakefd, &value, sizeof(value));
+    (void)r;
+}
+
+static void el_release_watch(void* ctx) {
+    free(ctx);
+}
+
+static void el_uring_teardown(el_uring_t* ring) {
+    if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_map && ring->cq_map != ring->sq_map) munmap(ring->cq_map, ring->cq_map_size);
+    if (ring->sq_map) munmap(ring->sq_map, ring->sq_map_size);
+    if (ring->fd >= 0) close(ring->fd);
+}
+
+static int el_uring_setup(el_uring_t* ring) {
+    memset(ring, 0, sizeof(*ring));
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+    params.cq_entries = EL_URING_CQ_ENTRIES;
+    ring->fd = (int)syscall(__NR_io_uring_setup, EL_URING_ENTRIES, &params);
+    if (ring->fd < 0) {
+        return errno == ENOMEM ? CORE_ERR_NOMEM : CORE_ERR_UNSUPPORTED;
+    }
+    // Многоразовый опрос появился вместе с RSRC_TAGS (5.13); таймаут
+    // ожидания передаётся через EXT_ARG
+    const uint32_t required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG |
+                              IORING_FEAT_RSRC_TAGS;
+    if ((params.features & required) != required) {
+        close(ring->fd);
+        return CORE_ERR_UNSUPPORTED;
+    }
+
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sq_map_size = ring->cq_map_size = sq_size > cq_size ? sq_size : cq_size;
+    ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                        IORING_OFF_SQ_RING);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                                            MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sq_map == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        if (ring->sq_map == MAP_FAILED) ring->sq_map = NULL;
+        if (ring->sqes == MAP_FAILED) ring->sqes = NULL;
+        el_uring_teardown(ring);
+        return CORE_ERR_NOMEM;
+    }
+    ring->cq_map = ring->sq_map;
+
+    char* sq = (char*)ring->sq_map;
+    ring->sq_head = (uint32_t*)(sq + params.sq_off.head);
+    ring->sq_tail = (uint32_t*)(sq + params.sq_off.tail);
+    ring->sq_array = (uint32_t*)(sq + params.sq_off.array);
+    ring->sq_mask = *(uint32_t*)(sq + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+    char* cq = (char*)ring->cq_map;
+    ring->cq_head = (uint32_t*)(cq + params.cq_off.head);
+    ring->cq_tail = (uint32_t*)(cq + params.cq_off.tail);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    ring->cq_mask = *(uint32_t*)(cq + params.cq_off.ring_mask);
+    return CORE_SUCCESS;
+}
+
+// Подаёт один SQE из потока цикла. Запросы подаются сразу, так что в
+// кольце подачи не копится больше одного.
+static int el_uring_submit(el_uring_t* ring, uint8_t opcode, int fd, uint64_t addr, uint32_t len,
+                           uint32_t poll_events, uint64_t user_data) {
+    uint32_t tail = *ring->sq_tail;
+    if (tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries) {
+        return CORE_ERR_NOMEM;
+    }
+    uint32_t index = tail & ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = addr;
+    sqe->len = len;
+    sqe->poll32_events = poll_events;
+    sqe->user_data = user_data;
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    for (;;) {
+        long r = syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0);
+        if (r >= 0) {
+            return CORE_SUCCESS;
+        }
+        if (errno != EINTR) {
+            return errno == EBUSY || errno == EAGAIN ? CORE_ERR_NOMEM : CORE_ERR_INTERNAL;
+        }
+    }
+}
+
+static int el_uring_poll_add(el_uring_t* ring, int fd, uint32_t events, uint64_t user_data) {
+    return el_uring_submit(ring, IORING_OP_POLL_ADD, fd, 0, IORING_POLL_ADD_MULTI, events, user_data);
+}
+
+#define EL_URING_POLL_EVENTS (POLLIN | POLLPRI | POLLOUT | POLLRDHUP)
+
+static core_event_loop_t* el_loop_of_thread(void) {
+    return (core_event_loop_t*)el_current_loop;
+}
+
+// Подача подписки из очереди функций: уже снятую не подаём, освобождение
+// идёт следом в той же очереди
+static void el_uring_arm(void* ctx) {
+    core_event_watch_t* w = (core_event_watch_t*)ctx;
+    core_event_loop_t* loop = el_loop_of_thread();
+    if (__atomic_load_n(&w->removed, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    if (el_uring_poll_add(&loop->ring, w->fd, EL_URING_POLL_EVENTS, (uint64_t)(uintptr_t)w) == CORE_SUCCESS) {
+        w->armed = 1;
+    } else {
+        w->cb(w->ctx, CORE_EV_ERROR | CORE_EV_READ | CORE_EV_WRITE);
+    }
+}
+
+static void el_uring_disarm(void* ctx) {
+    core_event_watch_t* w = (core_event_watch_t*)ctx;
+    core_event_loop_t* loop = el_loop_of_thread();
+    if (w->armed && el_uring_submit(&loop->ring, IORING_OP_POLL_REMOVE, -1, (uint64_t)(uintptr_t)w, 0, 0,
+                                    EL_URING_IGNORE) == CORE_SUCCESS) {
+        loop->ring.removing++;
+        return;
+    }
+    if (w->armed) {
+        // Без отмены запрос живёт до закрытия fd или кольца: память
+        // подписки не освобождаем, removed глушит её события
+        return;
+    }
+    el_push(loop, &w->release);
+}
+
+int core_event_loop_create(core_event_loop_t** loop) {
+    return core_event_loop_create_with(CORE_EV_BACKEND_EPOLL, loop);
+}
+
+int core_event_loop_create_with(int backend, core_event_loop_t** loop) {
+    if (!loop || (backend != CORE_EV_BACKEND_EPOLL && backend != CORE_EV_BACKEND_IO_URING)) {
+        return CORE_ERR_INVALID;
+    }
+    core_event_loop_t* l = (core_event_loop_t*)calloc(1, sizeof(*l));
+    if (!l) {
+        return CORE_ERR_NOMEM;
+    }
+    l->backend = backend;
+    l->epfd = -1;
+    l->wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (l->wakefd < 0) {
+        free(l);
+        return CORE_ERR_INTERNAL;
+    }
+    if (backend == CORE_EV_BACKEND_IO_URING) {
+        // Опрос eventfd подаёт первая итерация цикла — из его потока
+        int rc = el_uring_setup(&l->ring);
+        if (rc != CORE_SUCCESS) {
+            close(l->wakefd);
+            free(l);
+            return rc;
+        }
+    } else {
+        l->epfd = epoll_create1(EPOLL_CLOEXEC);
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.ptr = NULL;
+        if (l->epfd < 0 || epoll_ctl(l->epfd, EPOLL_CTL_ADD, l->wakefd, &ev) != 0) {
+            if (l->epfd >= 0) close(l->epfd);
+            close(l->wakefd);
+            free(l);
+            return CORE_ERR_INTERNAL;
+        }
+    }
+    l->free_timer = EL_NO_POS;
+    pthread_mutex_init(&l->offload_mutex, NULL);
+    pthread_cond_init(&l->offload_cv, NULL);
+    *loop = l;
+    return CORE_SUCCESS;
+}
+
+int core_event_loop_backend(const core_event_loop_t* loop) {
+    return loop ? loop->backend : CORE_EV_BACKEND_EPOLL;
+}
+
+static size_t el_uring_wait(core_event_loop_t* loop, int64_t wait_ns);
+
+void core_event_loop_destroy(core_event_loop_t* loop) {
+    if (!loop) {
+        return;
+    }
+    pthread_mutex_lock(&loop->offload_mutex);
+    loop->offload_stop = 1;
+    int started = loop->offload_started;
+    pthread_cond_broadcast(&loop->offload_cv);
+    pthread_mutex_unlock(&loop->offload_mutex);
+    for (int i = 0; i < started; ++i) pthread_join(loop->offload_threads[i], NULL);
+
+    // Завершения заданий и отложенные освобождения подписок; у io_uring —
+    // после последних CQE снятых подписок
+    const core_event_loop_t* prev = el_current_loop;
+    el_current_loop = loop;
+    if (loop->backend == CORE_EV_BACKEND_IO_URING) {
+        for (int i = 0; i < 1000; ++i) {
+            el_run_posts(loop);
+            if (loop->ring.removing == 0) break;
+            el_uring_wait(loop, 1000000);
+        }
+    }
+    while (el_run_posts(loop) > 0) {
+    }
+    el_current_loop = prev;
+
+    pthread_cond_destroy(&loop->offload_cv);
+    pthread_mutex_destroy(&loop->offload_mutex);
+    if (loop->backend == CORE_EV_BACKEND_IO_URING) {
+        el_uring_teardown(&loop->ring);
+    } else {
+        close(loop->epfd);
+    }
+    close(loop->wakefd);
+    free(loop->timers);
+    free(loop->heap);
+    free(loop);
+}
+
+int core_event_loop_add_fd(core_event_loop_t* loop, int fd, core_event_cb cb, void* ctx,
+                           core_event_watch_t** watch) {
+    if (!loop || fd < 0 || !cb || !watch) {
+        return CORE_ERR_INVALID;
+    }
+    core_event_watch_t* w = (core_event_watch_t*)calloc(1, sizeof(*w));
+    if (!w) {
+        return CORE_ERR_NOMEM;
+    }
+    w->cb = cb;
+    w->ctx = ctx;
+    w->fd = fd;
+    w->release.fn = el_release_watch;
+    w->release.ctx = w;
+
+    if (loop->backend == CORE_EV_BACKEND_IO_URING) {
+        w->arm.fn = el_uring_arm;
+        w->arm.ctx = w;
+        w->disarm.fn = el_uring_disarm;
+        w->disarm.ctx = w;
+        if (core_event_loop_in_loop_thread(loop)) {
+            int rc = el_uring_poll_add(&loop->ring, fd, EL_URING_POLL_EVENTS, (uint64_t)(uintptr_t)w);
+            if (rc != CORE_SUCCESS) {
+                free(w);
+                return rc;
+            }
+            w->armed = 1;
+        } else {
+            el_push(loop, &w->arm);
+        }
+        *watch = w;
+        return CORE_SUCCESS;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.ptr = w;
+    if (epoll_ctl(loop->epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        int err = errno;
+        free(w);
+        return err == EPERM ? CORE_ERR_UNSUPPORTED : CORE_ERR_INVALID;
+    }
+    *watch = w;
+    return CORE_SUCCESS;
+}
+
+void core_event_loop_remove_fd(core_event_loop_t* loop, core_event_watch_t* watch) {
+    if (!loop || !watch) {
+        return;
+    }
+    // События, уже выбранные циклом, увидят removed; память освобождается
+    // из очереди функций — после того как текущая итерация их разберёт
+    __atomic_store_n(&watch->removed, 1, __ATOMIC_RELEASE);
+    if (loop->backend == CORE_EV_BACKEND_IO_URING) {
+        if (core_event_loop_in_loop_thread(loop)) {
+            el_uring_disarm(watch);
+        } else {
+            el_push(loop, &watch->disarm);
+        }
+        return;
+    }
+    epoll_ctl(loop->epfd, EPOLL_CTL_DEL, watch->fd, NULL);
+    el_push(loop, &watch->release);
+}
+
+static int el_timer_less(const core_event_loop_t* loop, uint32_t a, uint32_t b) {
+    return loop->timers[a].deadline_ns < loop->timers[b].deadline_ns;
+}
+
+static void el_heap_set(core_event_loop_t* loop, uint32_t pos, uint32_t slot) {
+    loop->heap[pos] = slot;
+    loop->timers[slot].heap_pos = pos;
+}
+
+static void el_heap_up(core_event_loop_t* loop, uint32_t pos) {
+    uint32_t slot = loop->heap[pos];
+    while (pos > 0) {
+        uint32_t parent = (pos - 1) / 2;
+        if (!el_timer_less(loop, slot, loop->heap[parent])) break;
+        el_heap_set(loop, pos, loop->heap[parent]);
+        pos = parent;
+    }
+    el_heap_set(loop, pos, slot);
+}
+
+static void el_heap_down(core_event_loop_t* loop, uint32_t pos) {
+    uint32_t slot = loop->heap[pos];
+    for (;;) {
+        uint32_t child = 2 * pos + 1;
+        if (child >= loop->heap_count) break;
+        if (child + 1 < loop->heap_count && el_timer_less(loop, loop->heap[child + 1], loop->heap[child])) {
+            ++child;
+        }
+        if (!el_timer_less(loop, loop->heap[child], slot)) break;
+        el_heap_set(loop, pos, loop->heap[child]);
+        pos = child;
+    }
+    el_heap_set(loop, pos, slot);
+}
+
+static void el_heap_remove(core_event_loop_t* loop, uint32_t pos) {
+    uint32_t slot = loop->heap[pos];
+    uint32_t last = loop->heap[--loop->heap_count];
+    if (pos < loop->heap_count) {
+        el_heap_set(loop, pos, last);
+        el_heap_down(loop, pos);
+        el_heap_up(loop, loop->timers[last].heap_pos);
+    }
+    el_timer_t* t = &loop->timers[slot];
+    t->heap_pos = EL_NO_POS;
+    ++t->gen;
+    t->next_free = loop->free_timer;
+    loop->free_timer = slot;
+}
+
+int core_event_loop_add_timer(core_event_loop_t* loop, uint64_t deadline_ns, core_event_fn fn, void* ctx,
+                              uint64_t* timer_id) {
+    if (!loop || !fn) {
+        return CORE_ERR_INVALID;
+    }
+    if (loop->free_timer == EL_NO_POS) {
+        uint32_t capacity = loop->timers_capacity ? loop->timers_capacity * 2 : 64;
+        el_timer_t* timers = (el_timer_t*)realloc(loop->timers, capacity * sizeof(el_timer_t));
+        if (!timers) {
+            return CORE_ERR_NOMEM;
+        }
+        loop->timers = timers;
+        uint32_t* heap = (uint32_t*)realloc(loop->heap, capacity * sizeof(uint32_t));
+        if (!heap) {
+            return CORE_ERR_NOMEM;
+        }
+        loop->heap = heap;
+        for (uint32_t i = capacity; i-- > loop->timers_capacity;) {
+            timers[i].gen = 1;
+            timers[i].heap_pos = EL_NO_POS;
+            timers[i].next_free = loop->free_timer;
+            loop->free_timer = i;
+        }
+        loop->timers_capacity = capacity;
+    }
+    uint32_t slot = loop->free_timer;
+    el_timer_t* t = &loop->timers[slot];
+    loop->free_timer = t->next_free;
+    t->deadline_ns = deadline_ns;
+    t->fn = fn;
+    t->ctx = ctx;
+    el_heap_set(loop, loop->heap_count++, slot);
+    el_heap_up(loop, t->heap_pos);
+    if (timer_id) *timer_id = ((uint64_t)t->gen << 32) | slot;
+    return CORE_SUCCESS;
+}
+
+int core_event_loop_cancel_timer(core_event_loop_t* loop, uint64_t timer_id) {
+    if (!loop) {
+        return CORE_ERR_INVALID;
+    }
+    uint32_t slot = (uint32_t)timer_id;
+    if (slot >= loop->timers_capacity || loop->timers[slot].gen != (uint32_t)(timer_id >> 32) ||
+        loop->timers[slot].heap_pos == EL_NO_POS) {
+        return CORE_ERR_NOTFOUND;
+    }
+    el_heap_remove(loop, loop->timers[slot].heap_pos);
+    return CORE_SUCCESS;
+}
+
+static size_t el_run_timers(core_event_loop_t* loop) {
+    // Таймеры, добавленные обработчиками, ждут следующей итерации
+    uint64_t now = core_task_now_ns();
+    size_t count = 0;
+    while (loop->heap_count > 0 && loop->timers[loop->heap[0]].deadline_ns <= now) {
+        el_timer_t* t = &loop->timers[loop->heap[0]];
+        core_event_fn fn = t->fn;
+        void* ctx = t->ctx;
+        el_heap_remove(loop, 0);
+        fn(ctx);
+        ++count;
+    }
+    return count;
+}
+
+int core_event_loop_post(core_event_loop_t* loop, core_event_fn fn, void* ctx) {
+    if (!loop || !fn) {
+        return CORE_ERR_INVALID;
+    }
+    el_post_t* node = (el_post_t*)malloc(sizeof(*node));
+    if (!node) {
+        return CORE_ERR_NOMEM;
+    }
+    node->fn = fn;
+    node->ctx = ctx;
+    node->owned = 1;
+    el_push(loop, node);
+    return CORE_SUCCESS;
+}
+
+static void* el_offload_worker(void* arg) {
+    core_event_loop_t* loop = (core_event_loop_t*)arg;
+    pthread_mutex_lock(&loop->offload_mutex);
+    for (;;) {
+        while (!loop->jobs_head && !loop->offload_stop) {
+            pthread_cond_wait(&loop->offload_cv, &loop->offload_mutex);
+        }
+        el_job_t* job = loop->jobs_head;
+        if (!job) break;
+        loop->jobs_head = job->next;
+        if (!loop->jobs_head) loop->jobs_tail = NULL;
+        pthread_mutex_unlock(&loop->offload_mutex);
+        job->work(job->done.ctx);
+        el_push(loop, &job->done);
+        pthread_mutex_lock(&loop->offload_mutex);
+    }
+    pthread_mutex_unlock(&loop->offload_mutex);
+    return NULL;
+}
+
+int core_event_loop_offload(core_event_loop_t* loop, core_event_fn work, core_event_fn done, void* ctx) {
+    if (!loop || !work || !done) {
+        return CORE_ERR_INVALID;
+    }
+    el_job_t* job = (el_job_t*)calloc(1, sizeof(*job));
+    if (!job) {
+        return CORE_ERR_NOMEM;
+    }
+    job->work = work;
+    job->done.fn = done;
+    job->done.ctx = ctx;
+    job->done.owned = 1;
+
+    int status = CORE_SUCCESS;
+    pthread_mutex_lock(&loop->offload_mutex);
+    if (loop->offload_stop) {
+        status = CORE_ERR_INVALID;
+    } else {
+        // Потоки запускаются при первом задании: циклам без файлового
+        // ввода-вывода они не нужны
+        while (loop->offload_started < EL_OFFLOAD_THREADS &&
+               pthread_create(&loop->offload_threads[loop->offload_started], NULL, el_offload_worker, loop) == 0) {
+            ++loop->offload_started;
+        }
+        if (loop->offload_started == 0) {
+            status = CORE_ERR_INTERNAL;
+        } else {
+            if (loop->jobs_tail) {
+                loop->jobs_tail->next = job;
+            } else {
+                loop->jobs_head = job;
+            }
+            loop->jobs_tail = job;
+            pthread_cond_signal(&loop->offload_cv);
+        }
+    }
+    pthread_mutex_unlock(&loop->offload_mutex);
+    if (status != CORE_SUCCESS) free(job);
+    return status;
+}
+
+static size_t el_epoll_wait(core_event_loop_t* loop, int wait_ms);
+
+size_t core_event_loop_run_once(core_event_loop_t* loop, int64_t timeout_ns) {
+    if (!loop) {
+        return 0;
+    }
+    const core_event_loop_t* prev = el_current_loop;
+    el_current_loop = loop;
+
+    // io_uring: подписки из других потоков подаются до ожидания, чтобы их
+    // готовность пришла уже в этой итерации
+    size_t count = 0;
+    if (loop->backend == CORE_EV_BACKEND_IO_URING && __atomic_load_n(&loop->posts, __ATOMIC_RELAXED)) {
+        count += el_run_posts(loop);
+    }
+
+    // Сон не дольше ближайшего таймера; при ожидающих функциях — без сна.
+    // epoll_wait считает в миллисекундах — округляем вверх, чтобы не
+    // просыпаться раньше срока
+    int64_t wait_ns = timeout_ns;
+    if (loop->heap_count > 0) {
+        uint64_t now = core_task_now_ns();
+        uint64_t deadline = loop->timers[loop->heap[0]].deadline_ns;
+        int64_t until = deadline > now ? (int64_t)(deadline - now) : 0;
+        if (wait_ns < 0 || until < wait_ns) wait_ns = until;
+    }
+    if (__atomic_load_n(&loop->posts, __ATOMIC_RELAXED)) wait_ns = 0;
+    int wait_ms = -1;
+    if (wait_ns >= 0) {
+        int64_t ms = (wait_ns + 999999) / 1000000;
+        wait_ms = ms > 0x7fffffff ? 0x7fffffff : (int)ms;
+    }
+
+    if (loop->backend == CORE_EV_BACKEND_IO_URING) {
+        count += el_uring_wait(loop, wait_ns);
+    } else {
+        count += el_epoll_wait(loop, wait_ms);
+    }
+    count += el_run_posts(loop);
+    count += el_run_timers(loop);
+
+    el_current_loop = prev;
+    return count;
+}
+
+static size_t el_epoll_wait(core_event_loop_t* loop, int wait_ms) {
+    struct epoll_event events[EL_MAX_EVENTS];
+    int n = epoll_wait(loop->epfd, events, EL_MAX_EVENTS, wait_ms);
+    size_t count = 0;
+    for (int i = 0; i < n; ++i) {
+        core_event_watch_t* w = (core_event_watch_t*)events[i].data.ptr;
+        if (!w) {
+            el_read_wakefd(loop);
+            continue;
+        }
+        if (__atomic_load_n(&w->removed, __ATOMIC_ACQUIRE)) continue;
+        uint32_t e = events[i].events;
+        uint32_t mask = 0;
+        if (e & (EPOLLIN | EPOLLPRI)) mask |= CORE_EV_READ;
+        if (e & EPOLLOUT) mask |= CORE_EV_WRITE;
+        // Ошибка будит обе стороны: ожидающие повторят операцию и получат код
+        if (e & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) mask |= CORE_EV_ERROR | CORE_EV_READ | CORE_EV_WRITE;
+        w->cb(w->ctx, mask);
+        ++count;
+    }
+    return count;
+}
+
+// Последний CQE запроса опроса: подписку либо освобождаем (её сняли), либо
+// подаём заново, если запрос не завершился ошибкой
+static void el_uring_finish(core_event_loop_t* loop, core_event_watch_t* w, int rearm) {
+    if (__atomic_load_n(&w->removed, __ATOMIC_ACQUIRE)) {
+        loop->ring.removing -= w->armed;
+        w->armed = 0;
+        el_push(loop, &w->release);
+        return;
+    }
+    w->armed = rearm && el_uring_poll_add(&loop->ring, w->fd, EL_URING_POLL_EVENTS, (uint64_t)(uintptr_t)w) ==
+                            CORE_SUCCESS;
+}
+
+static size_t el_uring_wait(core_event_loop_t* loop, int64_t wait_ns) {
+    el_uring_t* ring = &loop->ring;
+    if (!ring->wake_armed) {
+        ring->wake_armed = el_uring_poll_add(ring, loop->wakefd, POLLIN, EL_URING_WAKE) == CORE_SUCCESS;
+        // Пропущенное до подачи пробуждение
+        if (__atomic_load_n(&loop->posts, __ATOMIC_RELAXED)) wait_ns = 0;
+    }
+    if (__atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE) == *ring->cq_head) {
+        struct __kernel_timespec ts;
+        struct io_uring_getevents_arg arg;
+        memset(&arg, 0, sizeof(arg));
+        if (wait_ns >= 0) {
+            ts.tv_sec = wait_ns / 1000000000;
+            ts.tv_nsec = wait_ns % 1000000000;
+            arg.ts = (uint64_t)(uintptr_t)&ts;
+        }
+        // При wait_ns == 0 вызов только переносит в кольцо переполнившиеся CQE
+        syscall(__NR_io_uring_enter, ring->fd, 0, wait_ns == 0 ? 0 : 1,
+                IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    }
+
+    size_t count = 0;
+    uint32_t head = *ring->cq_head;
+    const uint32_t tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+        struct io_uring_cqe cqe = ring->cqes[head & ring->cq_mask];
+        __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+        if (cqe.user_data == EL_URING_IGNORE) {
+            continue;
+        }
+        const int more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+        if (cqe.user_data == EL_URING_WAKE) {
+            el_read_wakefd(loop);
+            if (!more) {
+                ring->wake_armed = el_uring_poll_add(ring, loop->wakefd, POLLIN, EL_URING_WAKE) == CORE_SUCCESS;
+            }
+            continue;
+        }
+
+        core_event_watch_t* w = (core_event_watch_t*)(uintptr_t)cqe.user_data;
+        if (!__atomic_load_n(&w->removed, __ATOMIC_ACQUIRE)) {
+            uint32_t mask = 0;
+            if (cqe.res < 0) {
+                // Запрос не принят (закрытый fd и т.п.): сообщаем как ошибку
+                // и заново не подаём
+                if (cqe.res != -ECANCELED) mask = CORE_EV_ERROR | CORE_EV_READ | CORE_EV_WRITE;
+            } else {
+                uint32_t e = (uint32_t)cqe.res;
+                if (e & (POLLIN | POLLPRI)) mask |= CORE_EV_READ;
+                if (e & POLLOUT) mask |= CORE_EV_WRITE;
+                if (e & (POLLERR | POLLHUP | POLLRDHUP)) mask |= CORE_EV_ERROR | CORE_EV_READ | CORE_EV_WRITE;
+            }
+            if (mask) {
+                w->cb(w->ctx, mask);
+                ++count;
+            }
+        }
+        if (!more) {
+            el_uring_finish(loop, w, cqe.res >= 0 || cqe.res == -ECANCELED);
+        }
+    }
+    return count;
+}
+
+void core_event_loop_run(core_event_loop_t* loop) {
+    if (!loop) {
+        return;
+    }
+    while (!__atomic_exchange_n(&loop->stop, 0, __ATOMIC_ACQ_REL)) {
+        core_event_loop_run_once(loop, -1);
+    }
+}
+
+static void el_nop(void* ctx) {
+    (void)ctx;
+}
+
+void core_event_loop_stop(core_event_loop_t* loop) {
+    if (!loop) {
+        return;
+    }
+    __atomic_store_n(&loop->stop, 1, __ATOMIC_RELEASE);
+    core_event_loop_post(loop, el_nop, NULL);
+}
+
+#else
+
+int core_event_loop_create(core_event_loop_t** loop) {
+    (void)loop;
+    return CORE_ERR_UNSUPPORTED;
+}
+
+int core_event_loop_create_with(int backend, core_event_loop_t** loop) {
+    (void)backend; (void)loop;
+    return CORE_ERR_UNSUPPORTED;
+}
+
+int core_event_loop_backend(const core_event_loop_t* loop) {
+    (void)loop;
+    return CORE_EV_BACKEND_EPOLL;
+}
+
+void core_event_loop_destroy(core_event_loop_t* loop) {
+    (void)loop;
+}
+
+int core_event_loop_add_fd(core_event_loop_t* loop, int fd, core_event_cb cb, void* ctx,
+                           core_event_watch_t** watch) {
+    (void)loop; (void)fd; (void)cb; (void)ctx; (void)watch;
+    return CORE_ERR_UNSUPPORTED;
+}
+
+void core_event_loop_remove_fd(core_event_loop_t* loop, core_event_watch_t* watch) {
+    (void)loop; (void)watch;
+}
+
+int core_event_loop_add_timer(core_event_loop_t* loop, uint64_t deadline_ns, core_event_fn fn, void* ctx,
+                              uint64_t* timer_id) {
+    (void)loop; (void)deadline_ns; (void)fn; (void)ctx; (void)timer_id;
+    return CORE_ERR_UNSUPPORTED;
+}
+
+int core_event_loop_cancel_timer(core_event_loop_t* loop, uint64_t timer_id) {
+    (void)loop; (void)timer_id;
+    return CORE_ERR_UNSUPPORTED;
+}
+
+int core_event_loop_post(core_event_loop_t* loop, core_event_fn fn, void* ctx) {
+    (void)loop; (void)fn; (void)ctx;
+    return CORE_ERR_UNSUPPORTED;
+}
+
+int core_event_loop_offload(core_event_loop_t* loop, core_event_fn work, core_event_fn done, void* ctx) {
+    (void)loop; (void)work; (void)done; (void)ctx;
+    return CORE_ERR_UNSUPPORTED;
+}
+
+size_t core_event_loop_run_once(core_event_loop_t* loop, int64_t timeout_ns) {
+    (void)loop; (void)timeout_ns;
+    return 0;
+}
+
+void core_event_loop_run(core_event_loop_t* loop) {
+    (void)loop;
+}
+
+void core_event_loop_stop(core_event_loop_t* loop) {
+    (void)loop;
+}
+
+#endif
+
+int core_event_loop_in_loop_thread(const core_event_loop_t* loop) {
+    return loop && el_current_loop == loop;
+}
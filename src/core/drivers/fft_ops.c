@@ -0,0 +1,785 @@
+#include "core/drivers/fft_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE3__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// БПФ по схеме Стокхема (без перестановки бит-реверса): на каждой ступени
+// radix r вход x длины n = r*m со страйдом s раскладывается в выход y так, что
+//   y[q + s*(r*p + k)] = w^(k*p) * DFT_r(x[q + s*(p + j*m)], j = 0..r-1)[k],
+// после чего n /= r, s *= r. Внутренний цикл по q идёт по подряд лежащим
+// комплексным числам с общим поворотным множителем, поэтому векторизуется
+// целиком, как только s кратен ширине регистра. Множители 2 идут первыми
+// (radix-4, затем radix-2), чтобы s быстрее достигал ширины вектора.
+
+#define FFT_ALIGNMENT 64
+#define FFT_MAX_STAGES 64
+#define FFT_PI 3.14159265358979323846
+
+// Комплексные числа по одному (и хвостовые ступени с малым s)
+typedef struct {
+    float re;
+    float im;
+} cs_t;
+
+#define cs_W 1
+static inline cs_t cs_load(const float* p) { cs_t v = {p[0], p[1]}; return v; }
+static inline void cs_store(float* p, cs_t v) { p[0] = v.re; p[1] = v.im; }
+static inline cs_t cs_bcast(const float* p) { return cs_load(p); }
+static inline cs_t cs_pair(float re, float im) { cs_t v = {re, im}; return v; }
+static inline cs_t cs_add(cs_t a, cs_t b) { cs_t v = {a.re + b.re, a.im + b.im}; return v; }
+static inline cs_t cs_sub(cs_t a, cs_t b) { cs_t v = {a.re - b.re, a.im - b.im}; return v; }
+static inline cs_t cs_mul(cs_t a, cs_t b) { cs_t v = {a.re * b.re, a.im * b.im}; return v; }
+static inline cs_t cs_swap(cs_t a) { cs_t v = {a.im, a.re}; return v; }
+static inline cs_t cs_cmul(cs_t a, cs_t w) {
+    cs_t v = {a.re * w.re - a.im * w.im, a.re * w.im + a.im * w.re};
+    return v;
+}
+
+// Векторы из cv_W комплексных чисел, чередование (re, im)
+#if defined(__AVX512F__)
+
+#define FFT_VEC 1
+#define cv_W 8
+typedef __m512 cv_t;
+static inline cv_t cv_load(const float* p) { return _mm512_loadu_ps(p); }
+static inline void cv_store(float* p, cv_t v) { _mm512_storeu_ps(p, v); }
+static inline cv_t cv_bcast(const float* p) {
+    double d;
+    memcpy(&d, p, sizeof(d));
+    return _mm512_castpd_ps(_mm512_set1_pd(d));
+}
+static inline cv_t cv_add(cv_t a, cv_t b) { return _mm512_add_ps(a, b); }
+static inline cv_t cv_sub(cv_t a, cv_t b) { return _mm512_sub_ps(a, b); }
+static inline cv_t cv_mul(cv_t a, cv_t b) { return _mm512_mul_ps(a, b); }
+static inline cv_t cv_swap(cv_t a) { return _mm512_permute_ps(a, 0xB1); }
+static inline cv_t cv_cmul(cv_t a, cv_t w) {
+    return _mm512_fmaddsub_ps(a, _mm512_moveldup_ps(w), _mm512_mul_ps(cv_swap(a), _mm512_movehdup_ps(w)));
+}
+
+#elif defined(__AVX2__)
+
+#define FFT_VEC 1
+#define cv_W 4
+typedef __m256 cv_t;
+static inline cv_t cv_load(const float* p) { return _mm256_loadu_ps(p); }
+static inline void cv_store(float* p, cv_t v) { _mm256_storeu_ps(p, v); }
+static inline cv_t cv_bcast(const float* p) {
+    double d;
+    memcpy(&d, p, sizeof(d));
+    return _mm256_castpd_ps(_mm256_set1_pd(d));
+}
+static inline cv_t cv_add(cv_t a, cv_t b) { return _mm256_add_ps(a, b); }
+static inline cv_t cv_sub(cv_t a, cv_t b) { return _mm256_sub_ps(a, b); }
+static inline cv_t cv_mul(cv_t a, cv_t b) { return _mm256_mul_ps(a, b); }
+static inline cv_t cv_swap(cv_t a) { return _mm256_permute_ps(a, 0xB1); }
+static inline cv_t cv_cmul(cv_t a, cv_t w) {
+#if defined(__FMA__)
+    return _mm256_fmaddsub_ps(a, _mm256_moveldup_ps(w), _mm256_mul_ps(cv_swap(a), _mm256_movehdup_ps(w)));
+#else
+    return _mm256_addsub_ps(_mm256_mul_ps(a, _mm256_moveldup_ps(w)),
+                            _mm256_mul_ps(cv_swap(a), _mm256_movehdup_ps(w)));
+#endif
+}
+
+#elif defined(__SSE3__)
+
+#define FFT_VEC 1
+#define cv_W 2
+typedef __m128 cv_t;
+static inline cv_t cv_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void cv_store(float* p, cv_t v) { _mm_storeu_ps(p, v); }
+static inline cv_t cv_bcast(const float* p) {
+    double d;
+    memcpy(&d, p, sizeof(d));
+    return _mm_castpd_ps(_mm_set1_pd(d));
+}
+static inline cv_t cv_add(cv_t a, cv_t b) { return _mm_add_ps(a, b); }
+static inline cv_t cv_sub(cv_t a, cv_t b) { return _mm_sub_ps(a, b); }
+static inline cv_t cv_mul(cv_t a, cv_t b) { return _mm_mul_ps(a, b); }
+static inline cv_t cv_swap(cv_t a) { return _mm_shuffle_ps(a, a, 0xB1); }
+static inline cv_t cv_cmul(cv_t a, cv_t w) {
+    return _mm_addsub_ps(_mm_mul_ps(a, _mm_moveldup_ps(w)), _mm_mul_ps(cv_swap(a), _mm_movehdup_ps(w)));
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+#define FFT_VEC 1
+#define cv_W 2
+typedef float32x4_t cv_t;
+static inline cv_t cv_load(const float* p) { return vld1q_f32(p); }
+static inline void cv_store(float* p, cv_t v) { vst1q_f32(p, v); }
+static inline cv_t cv_bcast(const float* p) { return vcombine_f32(vld1_f32(p), vld1_f32(p)); }
+static inline cv_t cv_add(cv_t a, cv_t b) { return vaddq_f32(a, b); }
+static inline cv_t cv_sub(cv_t a, cv_t b) { return vsubq_f32(a, b); }
+static inline cv_t cv_mul(cv_t a, cv_t b) { return vmulq_f32(a, b); }
+static inline cv_t cv_swap(cv_t a) { return vrev64q_f32(a); }
+static inline cv_t cv_cmul(cv_t a, cv_t w) {
+    static const float sign[4] = {-1.0f, 1.0f, -1.0f, 1.0f};
+    cv_t cross = vmulq_f32(vmulq_f32(cv_swap(a), vtrn2q_f32(w, w)), vld1q_f32(sign));
+    return vfmaq_f32(cross, a, vtrn1q_f32(w, w));
+}
+
+#endif
+
+#if defined(FFT_VEC)
+static inline cv_t cv_pair(float re, float im) {
+    float p[2] = {re, im};
+    return cv_bcast(p);
+}
+#endif
+
+// Бабочки radix 2/3/4/5 над набором операций P (cs_ или cv_). Знак sigma = +1
+// для прямого преобразования и -1 для обратного: умножение на -i*sigma*c
+// записывается как swap(a) * (c*sigma, -c*sigma). Поворотные множители ступени
+// лежат по p: tw[(r-1)*p + k-1] = w^(k*p).
+#define FFT_DEFINE_STAGES(P)                                                                    \
+static void P##_radix2(const float* x, float* y, size_t m, size_t s, const float* tw, float sigma) { \
+    (void)sigma;                                                                                \
+    for (size_t p = 0; p < m; ++p) {                                                            \
+        P##_t w1 = P##_bcast(tw + 2 * p);                                                       \
+        const float* x0 = x + 2 * s * p;                                                        \
+        const float* x1 = x0 + 2 * s * m;                                                       \
+        float* y0 = y + 4 * s * p;                                                              \
+        float* y1 = y0 + 2 * s;                                                                 \
+        for (size_t q = 0; q < 2 * s; q += 2 * P##_W) {                                         \
+            P##_t a0 = P##_load(x0 + q), a1 = P##_load(x1 + q);                                 \
+            P##_store(y0 + q, P##_add(a0, a1));                                                 \
+            P##_store(y1 + q, P##_cmul(P##_sub(a0, a1), w1));                                   \
+        }                                                                                       \
+    }                                                                                           \
+}                                                                                               \
+                                                                                                \
+static void P##_radix3(const float* x, float* y, size_t m, size_t s, const float* tw, float sigma) { \
+    const float s3 = 0.86602540378443864676f * sigma;                                           \
+    P##_t half = P##_pair(-0.5f, -0.5f), rot = P##_pair(s3, -s3);                               \
+    for (size_t p = 0; p < m; ++p) {                                                            \
+        P##_t w1 = P##_bcast(tw + 4 * p), w2 = P##_bcast(tw + 4 * p + 2);                       \
+        const float* x0 = x + 2 * s * p;                                                        \
+        float* y0 = y + 6 * s * p;                                                              \
+        for (size_t q = 0; q < 2 * s; q += 2 * P##_W) {                                         \
+            P##_t a0 = P##_load(x0 + q);                                                        \
+            P##_t a1 = P##_load(x0 + 2 * s * m + q);                                            \
+            P##_t a2 = P##_load(x0 + 4 * s * m + q);                                            \
+            P##_t t1 = P##_add(a1, a2), t2 = P##_sub(a1, a2);                                   \
+            P##_t mid = P##_add(a0, P##_mul(t1, half));                                         \
+            P##_t r = P##_mul(P##_swap(t2), rot);                                               \
+            P##_store(y0 + q, P##_add(a0, t1));                                                 \
+            P##_store(y0 + 2 * s + q, P##_cmul(P##_add(mid, r), w1));                           \
+            P##_store(y0 + 4 * s + q, P##_cmul(P##_sub(mid, r), w2));                           \
+        }                                                                                       \
+    }                                                                                           \
+}                                                                                               \
+                                                                                                \
+static void P##_radix4(const float* x, float* y, size_t m, size_t s, const float* tw, float sigma) { \
+    P##_t rot = P##_pair(sigma, -sigma);                                                        \
+    for (size_t p = 0; p < m; ++p) {                                                            \
+        P##_t w1 = P##_bcast(tw + 6 * p);                                                       \
+        P##_t w2 = P##_bcast(tw + 6 * p + 2);                                                   \
+        P##_t w3 = P##_bcast(tw + 6 * p + 4);                                                   \
+        const float* x0 = x + 2 * s * p;                                                        \
+        float* y0 = y + 8 * s * p;                                                              \
+        for (size_t q = 0; q < 2 * s; q += 2 * P##_W) {                                         \
+            P##_t a0 = P##_load(x0 + q);                                                        \
+            P##_t a1 = P##_load(x0 + 2 * s * m + q);                                            \
+            P##_t a2 = P##_load(x0 + 4 * s * m + q);                                            \
+            P##_t a3 = P##_load(x0 + 6 * s * m + q);                                            \
+            P##_t t0 = P##_add(a0, a2), t1 = P##_sub(a0, a2);                                   \
+            P##_t t2 = P##_add(a1, a3), t3 = P##_mul(P##_swap(P##_sub(a1, a3)), rot);           \
+            P##_store(y0 + q, P##_add(t0, t2));                                                 \
+            P##_store(y0 + 2 * s + q, P##_cmul(P##_add(t1, t3), w1));                           \
+            P##_store(y0 + 4 * s + q, P##_cmul(P##_sub(t0, t2), w2));                           \
+            P##_store(y0 + 6 * s + q, P##_cmul(P##_sub(t1, t3), w3));                           \
+        }                                                                                       \
+    }                                                                                           \
+}                                                                                               \
+                                                                                                \
+static void P##_radix5(const float* x, float* y, size_t m, size_t s, const float* tw, float sigma) { \
+    const float s1 = 0.95105651629515357212f * sigma, s2 = 0.58778525229247312917f * sigma;     \
+    P##_t c1 = P##_pair(0.30901699437494742410f, 0.30901699437494742410f);                      \
+    P##_t c2 = P##_pair(-0.80901699437494742410f, -0.80901699437494742410f);                    \
+    P##_t r1 = P##_pair(s1, -s1), r2 = P##_pair(s2, -s2);                                       \
+    for (size_t p = 0; p < m; ++p) {                                                            \
+        P##_t w1 = P##_bcast(tw + 8 * p), w2 = P##_bcast(tw + 8 * p + 2);                       \
+        P##_t w3 = P##_bcast(tw + 8 * p + 4), w4 = P##_bcast(tw + 8 * p + 6);                   \
+        const float* x0 = x + 2 * s * p;                                                        \
+        float* y0 = y + 10 * s * p;                                                             \
+        for (size_t q = 0; q < 2 * s; q += 2 * P##_W) {                                         \
+            P##_t a0 = P##_load(x0 + q);                                                        \
+            P##_t a1 = P##_load(x0 + 2 * s * m + q);                                            \
+            P##_t a2 = P##_load(x0 + 4 * s * m + q);                                            \
+            P##_t a3 = P##_load(x0 + 6 * s * m + q);                                            \
+            P##_t a4 = P##_load(x0 + 8 * s * m + q);                                            \
+            P##_t t1 = P##_add(a1, a4), t2 = P##_add(a2, a3);                                   \
+            P##_t t3 = P##_swap(P##_sub(a1, a4)), t4 = P##_swap(P##_sub(a2, a3));               \
+            P##_t m1 = P##_add(a0, P##_add(P##_mul(t1, c1), P##_mul(t2, c2)));                  \
+            P##_t m2 = P##_add(a0, P##_add(P##_mul(t1, c2), P##_mul(t2, c1)));                  \
+            P##_t n1 = P##_add(P##_mul(t3, r1), P##_mul(t4, r2));                               \
+            P##_t n2 = P##_sub(P##_mul(t3, r2), P##_mul(t4, r1));                               \
+            P##_store(y0 + q, P##_add(a0, P##_add(t1, t2)));                                    \
+            P##_store(y0 + 2 * s + q, P##_cmul(P##_add(m1, n1), w1));                           \
+            P##_store(y0 + 4 * s + q, P##_cmul(P##_add(m2, n2), w2));                           \
+            P##_store(y0 + 6 * s + q, P##_cmul(P##_sub(m2, n2), w3));                           \
+            P##_store(y0 + 8 * s + q, P##_cmul(P##_sub(m1, n1), w4));                           \
+        }                                                                                       \
+    }                                                                                           \
+}
+
+FFT_DEFINE_STAGES(cs)
+#if defined(FFT_VEC)
+FFT_DEFINE_STAGES(cv)
+#endif
+
+typedef void (*fft_stage_fn)(const float* x, float* y, size_t m, size_t s, const float* tw, float sigma);
+
+static const fft_stage_fn fft_scalar_stages[6] = {NULL, NULL, cs_radix2, cs_radix3, cs_radix4, cs_radix5};
+#if defined(FFT_VEC)
+static const fft_stage_fn fft_vector_stages[6] = {NULL, NULL, cv_radix2, cv_radix3, cv_radix4, cv_radix5};
+#endif
+
+struct core_fft_plan {
+    int kind;
+    size_t n;
+    size_t scratch;                     // рабочая память на одно преобразование, во float'ах
+    // C2C по Стокхему
+    size_t num_stages;
+    unsigned char radix[FFT_MAX_STAGES];
+    size_t tw_offset[FFT_MAX_STAGES];
+    float* twiddles[2];                 // по направлениям
+    // C2C по Блюстейну (bluestein_m != 0)
+    size_t bluestein_m;
+    float* chirp;                       // exp(-i*pi*j^2/n), j < n
+    float* chirp_fft[2];                // БПФ дополненного сопряжённого чирпа, делённое на m
+    // R2C / DCT
+    float* post;                        // exp(-2*pi*i*k/n) для R2C, exp(-i*pi*k/(2n)) для DCT, k <= n/2
+    core_fft_plan_t* sub;
+    core_fft_plan_t* cache_next;
+};
+
+static void* fft_alloc(size_t bytes) {
+    void* ptr = NULL;
+    if (posix_memalign(&ptr, FFT_ALIGNMENT, bytes ? bytes : FFT_ALIGNMENT) != 0) {
+        return NULL;
+    }
+    return ptr;
+}
+
+static void fft_unit(float* dst, double angle) {
+    dst[0] = (float)cos(angle);
+    dst[1] = (float)sin(angle);
+}
+
+static void fft_scale(float* data, size_t count, float k) {
+    size_t i = 0;
+#if defined(FFT_VEC)
+    cv_t vk = cv_pair(k, k);
+    for (; i + 2 * cv_W <= count; i += 2 * cv_W) {
+        cv_store(data + i, cv_mul(cv_load(data + i), vk));
+    }
+#endif
+    for (; i < count; ++i) {
+        data[i] *= k;
+    }
+}
+
+// Точечное комплексное умножение a[j] *= b[j], j < n
+static void fft_pointwise(float* a, const float* b, size_t n) {
+    size_t j = 0;
+#if defined(FFT_VEC)
+    for (; j + cv_W <= n; j += cv_W) {
+        cv_store(a + 2 * j, cv_cmul(cv_load(a + 2 * j), cv_load(b + 2 * j)));
+    }
+#endif
+    for (; j < n; ++j) {
+        cs_store(a + 2 * j, cs_cmul(cs_load(a + 2 * j), cs_load(b + 2 * j)));
+    }
+}
+
+// ---- Комплексное преобразование без нормировки
+
+static void fft_c2c_raw(const core_fft_plan_t* plan, const float* in, float* out, float* work, int inverse);
+
+static void fft_stockham(const core_fft_plan_t* plan, const float* in, float* out, float* work, int inverse) {
+    size_t stages = plan->num_stages;
+    if (stages == 0) {
+        if (in != out) {
+            memcpy(out, in, 2 * plan->n * sizeof(float));
+        }
+        return;
+    }
+
+    // Ступени чередуют out и work так, чтобы последняя писала в out
+    const float* src = in;
+    if (in == out && (stages & 1)) {
+        memcpy(work, in, 2 * plan->n * sizeof(float));
+        src = work;
+    }
+
+    float sigma = inverse ? -1.0f : 1.0f;
+    size_t n = plan->n, s = 1;
+    for (size_t i = 0; i < stages; ++i) {
+        size_t r = plan->radix[i], m = n / r;
+        float* dst = ((stages - 1 - i) & 1) ? work : out;
+        const float* tw = plan->twiddles[inverse] + plan->tw_offset[i];
+#if defined(FFT_VEC)
+        fft_stage_fn stage = s % cv_W == 0 ? fft_vector_stages[r] : fft_scalar_stages[r];
+#else
+        fft_stage_fn stage = fft_scalar_stages[r];
+#endif
+        stage(src, dst, m, s, tw, sigma);
+        src = dst;
+        n = m;
+        s *= r;
+    }
+}
+
+// Блюстейн: jk = (j^2 + k^2 - (k-j)^2)/2 сводит ДПФ к циклической свёртке
+// длины m >= 2n-1 (степень двойки) с чирпом exp(i*pi*l^2/n).
+static void fft_bluestein(const core_fft_plan_t* plan, const float* in, float* out, float* work, int inverse) {
+    size_t n = plan->n, m = plan->bluestein_m;
+    float* a = work;
+    float* sub_work = work + 2 * m;
+    const float* chirp = plan->chirp;
+    float sg = inverse ? -1.0f : 1.0f;
+
+    for (size_t j = 0; j < n; ++j) {
+        cs_t w = cs_pair(chirp[2 * j], sg * chirp[2 * j + 1]);
+        cs_store(a + 2 * j, cs_cmul(cs_load(in + 2 * j), w));
+    }
+    memset(a + 2 * n, 0, 2 * (m - n) * sizeof(float));
+
+    fft_c2c_raw(plan->sub, a, a, sub_work, 0);
+    fft_pointwise(a, plan->chirp_fft[inverse], m);
+    fft_c2c_raw(plan->sub, a, a, sub_work, 1);
+
+    for (size_t k = 0; k < n; ++k) {
+        cs_t w = cs_pair(chirp[2 * k], sg * chirp[2 * k + 1]);
+        cs_store(out + 2 * k, cs_cmul(cs_load(a + 2 * k), w));
+    }
+}
+
+static void fft_c2c_raw(const core_fft_plan_t* plan, const float* in, float* out, float* work, int inverse) {
+    if (plan->bluestein_m) {
+        fft_bluestein(plan, in, out, work, inverse);
+    } else {
+        fft_stockham(plan, in, out, work, inverse);
+    }
+}
+
+// ---- Вещественное преобразование
+// Чётное n: n вещественных отсчётов читаются как n/2 комплексных z[j] = x[2j] + i*x[2j+1],
+// после БПФ длины h = n/2 спектры чётных и нечётных отсчётов разделяются:
+//   E[k] = (Z[k] + conj(Z[h-k]))/2, O[k] = -i*(Z[k] - conj(Z[h-k]))/2,
+//   X[k] = E[k] + w^k*O[k], X[h-k] = conj(E[k] - w^k*O[k]).
+// Нечётное n считается полным комплексным БПФ.
+
+static void fft_r2c_raw(const core_fft_plan_t* plan, const float* in, float* out, float* work) {
+    size_t n = plan->n;
+    if (n & 1) {
+        for (size_t j = 0; j < n; ++j) {
+            work[2 * j] = in[j];
+            work[2 * j + 1] = 0.0f;
+        }
+        fft_c2c_raw(plan->sub, work, work, work + 2 * n, 0);
+        memcpy(out, work, 2 * (n / 2 + 1) * sizeof(float));
+        return;
+    }
+
+    size_t h = n / 2;
+    fft_c2c_raw(plan->sub, in, out, work, 0);
+
+    cs_t z0 = cs_load(out);
+    cs_store(out + 2 * h, cs_pair(z0.re - z0.im, 0.0f));
+    cs_store(out, cs_pair(z0.re + z0.im, 0.0f));
+    cs_t half = cs_pair(0.5f, 0.5f), neg_half_i = cs_pair(0.5f, -0.5f);
+    for (size_t k = 1; k <= h / 2; ++k) {
+        cs_t zk = cs_load(out + 2 * k), zc = cs_load(out + 2 * (h - k));
+        zc.im = -zc.im;
+        cs_t e = cs_mul(cs_add(zk, zc), half);
+        cs_t o = cs_mul(cs_swap(cs_sub(zk, zc)), neg_half_i);
+        cs_t wo = cs_cmul(o, cs_load(plan->post + 2 * k));
+        cs_t xc = cs_sub(e, wo);
+        xc.im = -xc.im;
+        cs_store(out + 2 * (h - k), xc);
+        cs_store(out + 2 * k, cs_add(e, wo));
+    }
+}
+
+static void fft_c2r_raw(const core_fft_plan_t* plan, const float* in, float* out, float* work) {
+    size_t n = plan->n;
+    if (n & 1) {
+        for (size_t k = 0; k <= n / 2; ++k) {
+            work[2 * k] = in[2 * k];
+            work[2 * k + 1] = k ? in[2 * k + 1] : 0.0f;
+            if (k) {
+                work[2 * (n - k)] = in[2 * k];
+                work[2 * (n - k) + 1] = -in[2 * k + 1];
+            }
+        }
+        fft_c2c_raw(plan->sub, work, work, work + 2 * n, 1);
+        float inv_n = 1.0f / (float)n;
+        for (size_t j = 0; j < n; ++j) {
+            out[j] = work[2 * j] * inv_n;
+        }
+        return;
+    }
+
+    // E[k] = (X[k] + conj(X[h-k]))/2, O[k] = (X[k] - conj(X[h-k])) * conj(w^k)/2,
+    // Z[k] = E[k] + i*O[k]; нормировка 1/h внесена в множитель.
+    size_t h = n / 2;
+    float* z = work;
+    float scale = 0.5f / (float)h;
+    cs_t sc = cs_pair(scale, scale), neg_one = cs_pair(-1.0f, 1.0f);
+    for (size_t k = 0; k <= h / 2; ++k) {
+        cs_t xk = cs_load(in + 2 * k), xc = cs_load(in + 2 * (h - k));
+        xc.im = -xc.im;
+        cs_t e = cs_mul(cs_add(xk, xc), sc);
+        cs_t w = cs_load(plan->post + 2 * k);
+        w.im = -w.im;
+        cs_t o = cs_cmul(cs_mul(cs_sub(xk, xc), sc), w);
+        cs_t io = cs_mul(cs_swap(o), neg_one);
+        cs_store(z + 2 * k, cs_add(e, io));
+        if (k && k != h - k) {
+            // Z[h-k] = conj(E) + i*conj(O)
+            cs_t ec = e, oc = o;
+            ec.im = -ec.im;
+            oc.im = -oc.im;
+            cs_store(z + 2 * (h - k), cs_add(ec, cs_mul(cs_swap(oc), neg_one)));
+        }
+    }
+    fft_c2c_raw(plan->sub, z, out, work + n, 1);
+}
+
+// ---- ДКП через вещественное БПФ (Махоул): v — чётные отсчёты по возрастанию,
+// затем нечётные по убыванию; X[k] = Re(V[k]*exp(-i*pi*k/(2n))),
+// X[n-k] = -Im(V[k]*exp(-i*pi*k/(2n))).
+
+static void fft_dct2_raw(const core_fft_plan_t* plan, const float* in, float* out, float* work) {
+    size_t n = plan->n;
+    float* v = work;
+    float* spec = work + n;
+    float* sub_work = spec + 2 * (n / 2 + 1);
+    for (size_t k = 0; 2 * k < n; ++k) {
+        v[k] = in[2 * k];
+    }
+    for (size_t k = 0; 2 * k + 1 < n; ++k) {
+        v[n - 1 - k] = in[2 * k + 1];
+    }
+    fft_r2c_raw(plan->sub, v, spec, sub_work);
+
+    out[0] = spec[0];
+    for (size_t k = 1; k <= n / 2; ++k) {
+        cs_t t = cs_cmul(cs_load(spec + 2 * k), cs_load(plan->post + 2 * k));
+        out[n - k] = -t.im;
+        out[k] = t.re;
+    }
+}
+
+static void fft_dct3_raw(const core_fft_plan_t* plan, const float* in, float* out, float* work) {
+    size_t n = plan->n;
+    float* v = work;
+    float* spec = work + n;
+    float* sub_work = spec + 2 * (n / 2 + 1);
+    spec[0] = in[0];
+    spec[1] = 0.0f;
+    for (size_t k = 1; k <= n / 2; ++k) {
+        cs_t w = cs_load(plan->post + 2 * k);
+        w.im = -w.im;
+        cs_store(spec + 2 * k, cs_cmul(cs_pair(in[k], -in[n - k]), w));
+    }
+    fft_c2r_raw(plan->sub, spec, v, sub_work);
+
+    for (size_t k = 0; 2 * k < n; ++k) {
+        out[2 * k] = v[k];
+    }
+    for (size_t k = 0; 2 * k + 1 < n; ++k) {
+        out[2 * k + 1] = v[n - 1 - k];
+    }
+}
+
+// ---- Планы
+
+static int fft_init_stockham(core_fft_plan_t* plan) {
+    size_t n = plan->n, rest = n, stages = 0;
+    while (rest % 4 == 0) { plan->radix[stages++] = 4; rest /= 4; }
+    while (rest % 2 == 0) { plan->radix[stages++] = 2; rest /= 2; }
+    while (rest % 3 == 0) { plan->radix[stages++] = 3; rest /= 3; }
+    while (rest % 5 == 0) { plan->radix[stages++] = 5; rest /= 5; }
+    if (rest != 1) {
+        return CORE_ERR_UNSUPPORTED;
+    }
+    plan->num_stages = stages;
+
+    size_t total = 0, len = n;
+    for (size_t i = 0; i < stages; ++i) {
+        plan->tw_offset[i] = total;
+        len /= plan->radix[i];
+        total += 2 * (plan->radix[i] - 1) * len;
+    }
+    plan->twiddles[0] = (float*)fft_alloc(total * sizeof(float));
+    plan->twiddles[1] = (float*)fft_alloc(total * sizeof(float));
+    if (!plan->twiddles[0] || !plan->twiddles[1]) {
+        return CORE_ERR_NOMEM;
+    }
+
+    len = n;
+    for (size_t i = 0; i < stages; ++i) {
+        size_t r = plan->radix[i], m = len / r;
+        float* fwd = plan->twiddles[0] + plan->tw_offset[i];
+        float* inv = plan->twiddles[1] + plan->tw_offset[i];
+        for (size_t p = 0; p < m; ++p) {
+            for (size_t k = 1; k < r; ++k) {
+                size_t at = 2 * ((r - 1) * p + k - 1);
+                fft_unit(fwd + at, -2.0 * FFT_PI * (double)(k * p) / (double)len);
+                inv[at] = fwd[at];
+                inv[at + 1] = -fwd[at + 1];
+            }
+        }
+        len = m;
+    }
+    plan->scratch = 2 * n;
+    return CORE_SUCCESS;
+}
+
+static int fft_init_bluestein(core_fft_plan_t* plan) {
+    size_t n = plan->n, m = 1;
+    while (m < 2 * n - 1) {
+        m <<= 1;
+    }
+    plan->bluestein_m = m;
+    plan->sub = core_fft_plan_create(CORE_FFT_C2C, m);
+    plan->chirp = (float*)fft_alloc(2 * n * sizeof(float));
+    plan->chirp_fft[0] = (float*)fft_alloc(2 * m * sizeof(float));
+    plan->chirp_fft[1] = (float*)fft_alloc(2 * m * sizeof(float));
+    float* tmp = (float*)fft_alloc(4 * m * sizeof(float));
+    if (!plan->sub || !plan->chirp || !plan->chirp_fft[0] || !plan->chirp_fft[1] || !tmp) {
+        free(tmp);
+        return CORE_ERR_NOMEM;
+    }
+
+    for (size_t j = 0; j < n; ++j) {
+        // j^2 mod 2n, чтобы угол не терял точность на больших j
+        unsigned long long sq = (unsigned long long)j * j % (2ULL * n);
+        fft_unit(plan->chirp + 2 * j, -FFT_PI * (double)sq / (double)n);
+    }
+    for (int dir = 0; dir < 2; ++dir) {
+        float* b = plan->chirp_fft[dir];
+        float sg = dir ? 1.0f : -1.0f;
+        memset(b, 0, 2 * m * sizeof(float));
+        for (size_t j = 0; j < n; ++j) {
+            b[2 * j] = plan->chirp[2 * j];
+            b[2 * j + 1] = sg * plan->chirp[2 * j + 1];
+            if (j) {
+                b[2 * (m - j)] = b[2 * j];
+                b[2 * (m - j) + 1] = b[2 * j + 1];
+            }
+        }
+        fft_c2c_raw(plan->sub, b, b, tmp, 0);
+        fft_scale(b, 2 * m, 1.0f / (float)m);
+    }
+    free(tmp);
+    plan->scratch = 2 * m + plan->sub->scratch;
+    return CORE_SUCCESS;
+}
+
+static int fft_init_post(core_fft_plan_t* plan, double step) {
+    size_t count = plan->n / 2 + 1;
+    plan->post = (float*)fft_alloc(2 * count * sizeof(float));
+    if (!plan->post) {
+        return CORE_ERR_NOMEM;
+    }
+    for (size_t k = 0; k < count; ++k) {
+        fft_unit(plan->post + 2 * k, -step * (double)k);
+    }
+    return CORE_SUCCESS;
+}
+
+core_fft_plan_t* core_fft_plan_create(int kind, size_t n) {
+    if (n == 0 || (kind != CORE_FFT_C2C && kind != CORE_FFT_R2C && kind != CORE_FFT_DCT)) {
+        return NULL;
+    }
+    core_fft_plan_t* plan = (core_fft_plan_t*)calloc(1, sizeof(core_fft_plan_t));
+    if (!plan) {
+        return NULL;
+    }
+    plan->kind = kind;
+    plan->n = n;
+
+    int status;
+    if (kind == CORE_FFT_C2C) {
+        status = fft_init_stockham(plan);
+        if (status == CORE_ERR_UNSUPPORTED) {
+            status = fft_init_bluestein(plan);
+        }
+    } else if (kind == CORE_FFT_R2C) {
+        plan->sub = core_fft_plan_create(CORE_FFT_C2C, n & 1 ? n : n / 2);
+        status = plan->sub ? fft_init_post(plan, 2.0 * FFT_PI / (double)n) : CORE_ERR_NOMEM;
+        if (status == CORE_SUCCESS) {
+            plan->scratch = 2 * n + plan->sub->scratch;
+        }
+    } else {
+        plan->sub = core_fft_plan_create(CORE_FFT_R2C, n);
+        status = plan->sub ? fft_init_post(plan, FFT_PI / (2.0 * (double)n)) : CORE_ERR_NOMEM;
+        if (status == CORE_SUCCESS) {
+            plan->scratch = n + 2 * (n / 2 + 1) + plan->sub->scratch;
+        }
+    }
+
+    if (status != CORE_SUCCESS) {
+        core_fft_plan_destroy(plan);
+        return NULL;
+    }
+    return plan;
+}
+
+void core_fft_plan_destroy(core_fft_plan_t* plan) {
+    if (!plan) {
+        return;
+    }
+    free(plan->twiddles[0]);
+    free(plan->twiddles[1]);
+    free(plan->chirp);
+    free(plan->chirp_fft[0]);
+    free(plan->chirp_fft[1]);
+    free(plan->post);
+    core_fft_plan_destroy(plan->sub);
+    free(plan);
+}
+
+// Общий кэш планов: список под мьютексом, планы не удаляются
+static pthread_mutex_t fft_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static core_fft_plan_t* fft_cache_head;
+
+const core_fft_plan_t* core_fft_plan_cached(int kind, size_t n) {
+    pthread_mutex_lock(&fft_cache_lock);
+    core_fft_plan_t* plan = fft_cache_head;
+    while (plan && (plan->kind != kind || plan->n != n)) {
+        plan = plan->cache_next;
+    }
+    if (!plan) {
+        plan = core_fft_plan_create(kind, n);
+        if (plan) {
+            plan->cache_next = fft_cache_head;
+            fft_cache_head = plan;
+        }
+    }
+    pthread_mutex_unlock(&fft_cache_lock);
+    return plan;
+}
+
+size_t core_fft_plan_length(const core_fft_plan_t* plan) {
+    return plan ? plan->n : 0;
+}
+
+// ---- Выполнение
+
+static int fft_check(const core_fft_plan_t* plan, int kind, size_t count, const void* in, const void* out,
+                     int direction) {
+    if (!plan || plan->kind != kind || (direction != CORE_FFT_FORWARD && direction != CORE_FFT_INVERSE)) {
+        return CORE_ERR_INVALID;
+    }
+    if (count && (!in || !out)) {
+        return CORE_ERR_INVALID;
+    }
+    return CORE_SUCCESS;
+}
+
+int core_fft_c2c_batch(const core_fft_plan_t* plan, size_t count, const float* in, size_t in_dist,
+                       float* out, size_t out_dist, int direction) {
+    int status = fft_check(plan, CORE_FFT_C2C, count, in, out, direction);
+    if (status != CORE_SUCCESS || count == 0) {
+        return status;
+    }
+    float* work = (float*)fft_alloc(plan->scratch * sizeof(float));
+    if (!work) {
+        return CORE_ERR_NOMEM;
+    }
+    int inverse = direction == CORE_FFT_INVERSE;
+    for (size_t t = 0; t < count; ++t) {
+        float* dst = out + t * out_dist;
+        fft_c2c_raw(plan, in + t * in_dist, dst, work, inverse);
+        if (inverse) {
+            fft_scale(dst, 2 * plan->n, 1.0f / (float)plan->n);
+        }
+    }
+    free(work);
+    return CORE_SUCCESS;
+}
+
+int core_fft_r2c_batch(const core_fft_plan_t* plan, size_t count, const float* in, size_t in_dist,
+                       float* out, size_t out_dist) {
+    int status = fft_check(plan, CORE_FFT_R2C, count, in, out, CORE_FFT_FORWARD);
+    if (status != CORE_SUCCESS || count == 0) {
+        return status;
+    }
+    float* work = (float*)fft_alloc(plan->scratch * sizeof(float));
+    if (!work) {
+        return CORE_ERR_NOMEM;
+    }
+    for (size_t t = 0; t < count; ++t) {
+        fft_r2c_raw(plan, in + t * in_dist, out + t * out_dist, work);
+    }
+    free(work);
+    return CORE_SUCCESS;
+}
+
+int core_fft_c2r_batch(const core_fft_plan_t* plan, size_t count, const float* in, size_t in_dist,
+                       float* out, size_t out_dist) {
+    int status = fft_check(plan, CORE_FFT_R2C, count, in, out, CORE_FFT_INVERSE);
+    if (status != CORE_SUCCESS || count == 0) {
+        return status;
+    }
+    float* work = (float*)fft_alloc(plan->scratch * sizeof(float));
+    if (!work) {
+        return CORE_ERR_NOMEM;
+    }
+    for (size_t t = 0; t < count; ++t) {
+        fft_c2r_raw(plan, in + t * in_dist, out + t * out_dist, work);
+    }
+    free(work);
+    return CORE_SUCCESS;
+}
+
+int core_fft_dct_batch(const core_fft_plan_t* plan, size_t count, const float* in, size_t in_dist,
+                       float* out, size_t out_dist, int direction) {
+    int status = fft_check(plan, CORE_FFT_DCT, count, in, out, direction);
+    if (status != CORE_SUCCESS || count == 0) {
+        return status;
+    }
+    float* work = (float*)fft_alloc(plan->scratch * sizeof(float));
+    if (!work) {
+        return CORE_ERR_NOMEM;
+    }
+    for (size_t t = 0; t < count; ++t) {
+        if (direction == CORE_FFT_FORWARD) {
+            fft_dct2_raw(plan, in + t * in_dist, out + t * out_dist, work);
+        } else {
+            fft_dct3_raw(plan, in + t * in_dist, out + t * out_dist, work);
+        }
+    }
+    free(work);
+    return CORE_SUCCESS;
+}
+
+int core_fft_c2c(const core_fft_plan_t* plan, const float* in, float* out, int direction) {
+    return core_fft_c2c_batch(plan, 1, in, 0, out, 0, direction);
+}
+
+int core_fft_r2c(const core_fft_plan_t* plan, const float* in, float* out) {
+    return core_fft_r2c_batch(plan, 1, in, 0, out, 0);
+}
+
+int core_fft_c2r(const core_fft_plan_t* plan, const float* in, float* out) {
+    return core_fft_c2r_batch(plan, 1, in, 0, out, 0);
+}
+
+int core_fft_dct(const core_fft_plan_t* plan, const float* in, float* out, int direction) {
+    return core_fft_dct_batch(plan, 1, in, 0, out, 0, direction);
+}
@@ -0,0 +1,671 @@
+#include "core/drivers/filter_ops.h"
+#include "core/optimization/simd_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Все фильтры устроены одинаково: изображение режется на полосы строк (задачи
+// исполнителя), полоса — на тайлы по FILTER_TILE_W столбцов. Тайл вместе с
+// ореолом радиуса r копируется в выровненный буфер с повтором краёв, так что ядра
+// работают без проверок границ, целыми векторами, а буфер тайла остаётся в L2.
+
+#define FILTER_ALIGNMENT 64
+#define FILTER_TILE_W 256
+#define FILTER_LUT_SIZE 4096
+#define FILTER_MAX_NETWORK 64   // окно до 7x7 дополняется до 64 элементов
+#define FILTER_HIST_BINS 256
+
+#if defined(__AVX512F__)
+
+#define FV_W 16
+typedef __m512 fv_t;
+static inline fv_t fv_load(const float* p) { return _mm512_loadu_ps(p); }
+static inline void fv_store(float* p, fv_t v) { _mm512_storeu_ps(p, v); }
+static inline fv_t fv_set1(float x) { return _mm512_set1_ps(x); }
+static inline fv_t fv_add(fv_t a, fv_t b) { return _mm512_add_ps(a, b); }
+static inline fv_t fv_sub(fv_t a, fv_t b) { return _mm512_sub_ps(a, b); }
+static inline fv_t fv_mul(fv_t a, fv_t b) { return _mm512_mul_ps(a, b); }
+static inline fv_t fv_div(fv_t a, fv_t b) { return _mm512_div_ps(a, b); }
+static inline fv_t fv_fma(fv_t a, fv_t b, fv_t c) { return _mm512_fmadd_ps(a, b, c); }
+static inline fv_t fv_min(fv_t a, fv_t b) { return _mm512_min_ps(a, b); }
+static inline fv_t fv_max(fv_t a, fv_t b) { return _mm512_max_ps(a, b); }
+static inline fv_t fv_abs(fv_t a) {
+    return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_set1_epi32(0x7fffffff)));
+}
+// idx уже ограничен [0, FILTER_LUT_SIZE - 1]
+static inline fv_t fv_lut(const float* lut, fv_t idx) {
+    return _mm512_i32gather_ps(_mm512_cvttps_epi32(idx), lut, 4);
+}
+
+#elif defined(__AVX2__)
+
+#define FV_W 8
+typedef __m256 fv_t;
+static inline fv_t fv_load(const float* p) { return _mm256_loadu_ps(p); }
+static inline void fv_store(float* p, fv_t v) { _mm256_storeu_ps(p, v); }
+static inline fv_t fv_set1(float x) { return _mm256_set1_ps(x); }
+static inline fv_t fv_add(fv_t a, fv_t b) { return _mm256_add_ps(a, b); }
+static inline fv_t fv_sub(fv_t a, fv_t b) { return _mm256_sub_ps(a, b); }
+static inline fv_t fv_mul(fv_t a, fv_t b) { return _mm256_mul_ps(a, b); }
+static inline fv_t fv_div(fv_t a, fv_t b) { return _mm256_div_ps(a, b); }
+#if defined(__FMA__)
+static inline fv_t fv_fma(fv_t a, fv_t b, fv_t c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+static inline fv_t fv_fma(fv_t a, fv_t b, fv_t c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+static inline fv_t fv_min(fv_t a, fv_t b) { return _mm256_min_ps(a, b); }
+static inline fv_t fv_max(fv_t a, fv_t b) { return _mm256_max_ps(a, b); }
+static inline fv_t fv_abs(fv_t a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+static inline fv_t fv_lut(const float* lut, fv_t idx) {
+    return _mm256_i32gather_ps(lut, _mm256_cvttps_epi32(idx), 4);
+}
+
+#elif defined(__SSE4_2__)
+
+#define FV_W 4
+typedef __m128 fv_t;
+static inline fv_t fv_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void fv_store(float* p, fv_t v) { _mm_storeu_ps(p, v); }
+static inline fv_t fv_set1(float x) { return _mm_set1_ps(x); }
+static inline fv_t fv_add(fv_t a, fv_t b) { return _mm_add_ps(a, b); }
+static inline fv_t fv_sub(fv_t a, fv_t b) { return _mm_sub_ps(a, b); }
+static inline fv_t fv_mul(fv_t a, fv_t b) { return _mm_mul_ps(a, b); }
+static inline fv_t fv_div(fv_t a, fv_t b) { return _mm_div_ps(a, b); }
+static inline fv_t fv_fma(fv_t a, fv_t b, fv_t c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+static inline fv_t fv_min(fv_t a, fv_t b) { return _mm_min_ps(a, b); }
+static inline fv_t fv_max(fv_t a, fv_t b) { return _mm_max_ps(a, b); }
+static inline fv_t fv_abs(fv_t a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline fv_t fv_lut(const float* lut, fv_t idx) {
+    __m128i i = _mm_cvttps_epi32(idx);
+    return _mm_setr_ps(lut[_mm_extract_epi32(i, 0)], lut[_mm_extract_epi32(i, 1)],
+                       lut[_mm_extract_epi32(i, 2)], lut[_mm_extract_epi32(i, 3)]);
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+#define FV_W 4
+typedef float32x4_t fv_t;
+static inline fv_t fv_load(const float* p) { return vld1q_f32(p); }
+static inline void fv_store(float* p, fv_t v) { vst1q_f32(p, v); }
+static inline fv_t fv_set1(float x) { return vdupq_n_f32(x); }
+static inline fv_t fv_add(fv_t a, fv_t b) { return vaddq_f32(a, b); }
+static inline fv_t fv_sub(fv_t a, fv_t b) { return vsubq_f32(a, b); }
+static inline fv_t fv_mul(fv_t a, fv_t b) { return vmulq_f32(a, b); }
+static inline fv_t fv_div(fv_t a, fv_t b) { return vdivq_f32(a, b); }
+static inline fv_t fv_fma(fv_t a, fv_t b, fv_t c) { return vfmaq_f32(c, a, b); }
+// minnm: NaN в первом операнде даёт второй, индекс таблицы остаётся в границах
+static inline fv_t fv_min(fv_t a, fv_t b) { return vminnmq_f32(a, b); }
+static inline fv_t fv_max(fv_t a, fv_t b) { return vmaxnmq_f32(a, b); }
+static inline fv_t fv_abs(fv_t a) { return vabsq_f32(a); }
+static inline fv_t fv_lut(const float* lut, fv_t idx) {
+    uint32x4_t i = vcvtq_u32_f32(idx);
+    float v[4] = {lut[vgetq_lane_u32(i, 0)], lut[vgetq_lane_u32(i, 1)],
+                  lut[vgetq_lane_u32(i, 2)], lut[vgetq_lane_u32(i, 3)]};
+    return vld1q_f32(v);
+}
+
+#else
+
+#define FV_W 1
+typedef float fv_t;
+static inline fv_t fv_load(const float* p) { return *p; }
+static inline void fv_store(float* p, fv_t v) { *p = v; }
+static inline fv_t fv_set1(float x) { return x; }
+static inline fv_t fv_add(fv_t a, fv_t b) { return a + b; }
+static inline fv_t fv_sub(fv_t a, fv_t b) { return a - b; }
+static inline fv_t fv_mul(fv_t a, fv_t b) { return a * b; }
+static inline fv_t fv_div(fv_t a, fv_t b) { return a / b; }
+static inline fv_t fv_fma(fv_t a, fv_t b, fv_t c) { return a * b + c; }
+static inline fv_t fv_min(fv_t a, fv_t b) { return a < b ? a : b; }
+static inline fv_t fv_max(fv_t a, fv_t b) { return a > b ? a : b; }
+static inline fv_t fv_abs(fv_t a) { return fabsf(a); }
+static inline fv_t fv_lut(const float* lut, fv_t idx) { return lut[(size_t)idx]; }
+
+#endif
+
+static inline size_t filter_round_up(size_t x, size_t m) { return (x + m - 1) / m * m; }
+static inline size_t filter_min(size_t a, size_t b) { return a < b ? a : b; }
+
+static void* filter_alloc(size_t bytes) {
+    void* ptr = NULL;
+    if (posix_memalign(&ptr, FILTER_ALIGNMENT, bytes ? bytes : FILTER_ALIGNMENT) != 0) {
+        return NULL;
+    }
+    return ptr;
+}
+
+typedef struct filter_job filter_job_t;
+
+// Ядро тайла: элемент тайла (i, c) — пиксель (y0 - r + i, x0 - r + c); выход —
+// rows x cols пикселей, начиная с (y0, x0). row_buf вмещает две строки тайла.
+typedef void (*filter_tile_fn)(const filter_job_t* job, const float* tile, size_t tile_stride,
+                               size_t rows, size_t cols, float* out, size_t out_stride, float* row_buf);
+
+struct filter_job {
+    const float* in;
+    size_t in_stride;
+    float* out;
+    size_t out_stride;
+    size_t width;
+    size_t height;
+    size_t radius;
+    size_t band_rows;
+    filter_tile_fn tile_fn;
+    int status;
+    // Гаусс: веса w[0..r], w[k] — на расстоянии k
+    const float* weights;
+    // Билатеральный: смещения окна (dy, dx), их пространственные веса в weights
+    // и таблица яркостных весов; индекс округляется к ближайшему узлу
+    const int* offsets;
+    size_t num_offsets;
+    const float* lut;
+    float lut_scale;
+    // Медиана: сеть сравнений (пары индексов) и позиция медианы
+    const uint8_t* network;
+    size_t network_size;
+    size_t kernel;
+    size_t median_index;
+    // Медиана по гистограмме: квантование в 256 уровней
+    float q_min;
+    float q_scale;
+};
+
+static void filter_fail(filter_job_t* job, int status) {
+    __atomic_store_n(&job->status, status, __ATOMIC_RELAXED);
+}
+
+// Копия строк [y - r, y + rows + r) и столбцов [x0 - r, x0 - r + cols) с повтором краёв
+static void filter_fill_tile(const filter_job_t* job, size_t y0, size_t rows, size_t x0, size_t cols,
+                             float* tile, size_t tile_stride) {
+    long r = (long)job->radius, w = (long)job->width, h = (long)job->height;
+    long first = (long)x0 - r, last = first + (long)cols;
+    long mid_begin = first < 0 ? 0 : first;
+    long mid_end = last > w ? w : last;
+    for (long i = 0; i < (long)rows + 2 * r; ++i) {
+        long y = (long)y0 - r + i;
+        y = y < 0 ? 0 : y >= h ? h - 1 : y;
+        const float* src = job->in + (size_t)y * job->in_stride;
+        float* dst = tile + (size_t)i * tile_stride;
+        long c = 0;
+        for (; first + c < mid_begin; ++c) {
+            dst[c] = src[0];
+        }
+        if (mid_end > mid_begin) {
+            memcpy(dst + c, src + mid_begin, (size_t)(mid_end - mid_begin) * sizeof(float));
+            c += mid_end - mid_begin;
+        }
+        for (; c < (long)cols; ++c) {
+            dst[c] = src[w - 1];
+        }
+    }
+}
+
+static void filter_band_task(void* arg, size_t band) {
+    filter_job_t* job = (filter_job_t*)arg;
+    size_t r = job->radius;
+    size_t y0 = band * job->band_rows;
+    size_t rows = filter_min(job->band_rows, job->height - y0);
+    // Ширина тайла с ореолом, кратная вектору, чтобы последний вектор строки не выходил за буфер
+    size_t tile_stride = filter_round_up(filter_round_up(FILTER_TILE_W, FV_W) + 2 * r, FV_W) + FV_W;
+    float* tile = (float*)filter_alloc((rows + 2 * r) * tile_stride * sizeof(float));
+    float* row_buf = (float*)filter_alloc(2 * tile_stride * sizeof(float));
+    if (!tile || !row_buf) {
+        filter_fail(job, CORE_ERR_NOMEM);
+    } else {
+        for (size_t x0 = 0; x0 < job->width; x0 += FILTER_TILE_W) {
+            size_t cols = filter_min(FILTER_TILE_W, job->width - x0);
+            size_t fill = filter_round_up(filter_round_up(cols, FV_W) + 2 * r, FV_W);
+            filter_fill_tile(job, y0, rows, x0, fill, tile, tile_stride);
+            job->tile_fn(job, tile, tile_stride, rows, cols,
+                         job->out + y0 * job->out_stride + x0, job->out_stride, row_buf);
+        }
+    }
+    free(tile);
+    free(row_buf);
+}
+
+static int filter_run(filter_job_t* job, void (*band_task)(void*, size_t), size_t min_band_rows,
+                      const core_executor_t* executor) {
+    size_t threads = executor && executor->num_threads > 1 ? executor->num_threads : 1;
+    // Около четырёх полос на поток для балансировки, но не короче min_band_rows
+    size_t band = (job->height + 4 * threads - 1) / (4 * threads);
+    job->band_rows = band < min_band_rows ? min_band_rows : band;
+    job->status = CORE_SUCCESS;
+    size_t bands = (job->height + job->band_rows - 1) / job->band_rows;
+    core_parallel_for(executor, bands, band_task, job);
+    return job->status;
+}
+
+static void filter_copy(const float* in, size_t in_stride, float* out, size_t out_stride,
+                        size_t width, size_t height) {
+    for (size_t y = 0; y < height; ++y) {
+        memcpy(out + y * out_stride, in + y * in_stride, width * sizeof(float));
+    }
+}
+
+static int filter_check(const float* in, size_t in_stride, const float* out, size_t out_stride,
+                        size_t width, size_t height) {
+    if ((width && height && (!in || !out)) || in_stride < width || out_stride < width) {
+        return CORE_ERR_INVALID;
+    }
+    return CORE_SUCCESS;
+}
+
+// ---- Гаусс: вертикальный проход по строкам тайла во временную строку,
+// затем горизонтальный; симметрия ядра — одно умножение на пару отсчётов.
+
+static void gaussian_tile(const filter_job_t* job, const float* tile, size_t tile_stride,
+                          size_t rows, size_t cols, float* out, size_t out_stride, float* row_buf) {
+    size_t r = job->radius;
+    const float* w = job->weights;
+    size_t out_cols = filter_round_up(cols, FV_W);
+    size_t vert_cols = filter_round_up(out_cols + 2 * r, FV_W);
+    float* vt = row_buf;
+    float* ob = row_buf + tile_stride;
+
+    for (size_t j = 0; j < rows; ++j) {
+        const float* center = tile + (j + r) * tile_stride;
+        for (size_t c = 0; c < vert_cols; c += FV_W) {
+            fv_t acc = fv_mul(fv_set1(w[0]), fv_load(center + c));
+            for (size_t k = 1; k <= r; ++k) {
+                fv_t pair = fv_add(fv_load(center - k * tile_stride + c), fv_load(center + k * tile_stride + c));
+                acc = fv_fma(fv_set1(w[k]), pair, acc);
+            }
+            fv_store(vt + c, acc);
+        }
+        for (size_t x = 0; x < out_cols; x += FV_W) {
+            const float* p = vt + x + r;
+            fv_t acc = fv_mul(fv_set1(w[0]), fv_load(p));
+            for (size_t k = 1; k <= r; ++k) {
+                acc = fv_fma(fv_set1(w[k]), fv_add(fv_load(p - k), fv_load(p + k)), acc);
+            }
+            fv_store(ob + x, acc);
+        }
+        memcpy(out + j * out_stride, ob, cols * sizeof(float));
+    }
+}
+
+int core_filter_gaussian(const float* in, size_t in_stride, float* out, size_t out_stride,
+                         size_t width, size_t height, float sigma, const core_executor_t* executor) {
+    int status = filter_check(in, in_stride, out, out_stride, width, height);
+    if (status != CORE_SUCCESS || width == 0 || height == 0) {
+        return status;
+    }
+    size_t r = sigma > 0.0f ? (size_t)ceilf(3.0f * sigma) : 0;
+    if (r == 0) {
+        filter_copy(in, in_stride, out, out_stride, width, height);
+        return CORE_SUCCESS;
+    }
+
+    float* weights = (float*)malloc((r + 1) * sizeof(float));
+    if (!weights) {
+        return CORE_ERR_NOMEM;
+    }
+    double sum = 0.0;
+    for (size_t k = 0; k <= r; ++k) {
+        weights[k] = (float)exp(-(double)(k * k) / (2.0 * sigma * sigma));
+        sum += k ? 2.0 * weights[k] : weights[k];
+    }
+    for (size_t k = 0; k <= r; ++k) {
+        weights[k] = (float)(weights[k] / sum);
+    }
+
+    filter_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.in = in;
+    job.in_stride = in_stride;
+    job.out = out;
+    job.out_stride = out_stride;
+    job.width = width;
+    job.height = height;
+    job.radius = r;
+    job.tile_fn = gaussian_tile;
+    job.weights = weights;
+    status = filter_run(&job, filter_band_task, 8, executor);
+    free(weights);
+    return status;
+}
+
+// ---- Билатеральный: по всем смещениям круглого окна, вес = пространственный *
+// табличный яркостный (индекс — |I(q) - I(p)| в шагах таблицы, дальше 4*sigma — 0).
+
+static void bilateral_tile(const filter_job_t* job, const float* tile, size_t tile_stride,
+                           size_t rows, size_t cols, float* out, size_t out_stride, float* row_buf) {
+    size_t r = job->radius;
+    size_t out_cols = filter_round_up(cols, FV_W);
+    const fv_t scale = fv_set1(job->lut_scale), half = fv_set1(0.5f);
+    const fv_t last = fv_set1((float)(FILTER_LUT_SIZE - 1));
+    float* ob = row_buf;
+
+    for (size_t j = 0; j < rows; ++j) {
+        const float* center_row = tile + (j + r) * tile_stride + r;
+        for (size_t x = 0; x < out_cols; x += FV_W) {
+            fv_t center = fv_load(center_row + x);
+            fv_t num = fv_set1(0.0f), den = fv_set1(0.0f);
+            for (size_t o = 0; o < job->num_offsets; ++o) {
+                long delta = (long)job->offsets[2 * o] * (long)tile_stride + job->offsets[2 * o + 1];
+                fv_t v = fv_load(center_row + x + delta);
+                fv_t idx = fv_min(fv_fma(fv_abs(fv_sub(v, center)), scale, half), last);
+                fv_t wgt = fv_mul(fv_lut(job->lut, idx), fv_set1(job->weights[o]));
+                num = fv_fma(wgt, v, num);
+                den = fv_add(den, wgt);
+            }
+            fv_store(ob + x, fv_div(num, den));
+        }
+        memcpy(out + j * out_stride, ob, cols * sizeof(float));
+    }
+}
+
+int core_filter_bilateral(const float* in, size_t in_stride, float* out, size_t out_stride,
+                          size_t width, size_t height, float sigma_space, float sigma_color,
+                          const core_executor_t* executor) {
+    int status = filter_check(in, in_stride, out, out_stride, width, height);
+    if (status != CORE_SUCCESS || width == 0 || height == 0) {
+        return status;
+    }
+    size_t r = sigma_space > 0.0f ? (size_t)ceilf(2.0f * sigma_space) : 0;
+    if (r == 0 || !(sigma_color > 0.0f)) {
+        filter_copy(in, in_stride, out, out_stride, width, height);
+        return CORE_SUCCESS;
+    }
+
+    size_t side = 2 * r + 1;
+    int* offsets = (int*)malloc(2 * side * side * sizeof(int));
+    float* spatial = (float*)malloc(side * side * sizeof(float));
+    float* lut = (float*)filter_alloc(FILTER_LUT_SIZE * sizeof(float));
+    if (!offsets || !spatial || !lut) {
+        free(offsets);
+        free(spatial);
+        free(lut);
+        return CORE_ERR_NOMEM;
+    }
+
+    size_t count = 0;
+    long rr = (long)r;
+    for (long dy = -rr; dy <= rr; ++dy) {
+        for (long dx = -rr; dx <= rr; ++dx) {
+            if (dy * dy + dx * dx > rr * rr) {
+                continue;
+            }
+            offsets[2 * count] = (int)dy;
+            offsets[2 * count + 1] = (int)dx;
+            spatial[count] = (float)exp(-(double)(dy * dy + dx * dx) / (2.0 * sigma_space * sigma_space));
+            ++count;
+        }
+    }
+    double range = 4.0 * sigma_color;
+    for (size_t i = 0; i < FILTER_LUT_SIZE - 1; ++i) {
+        double d = range * (double)i / (double)(FILTER_LUT_SIZE - 1);
+        lut[i] = (float)exp(-d * d / (2.0 * sigma_color * sigma_color));
+    }
+    lut[FILTER_LUT_SIZE - 1] = 0.0f;
+
+    filter_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.in = in;
+    job.in_stride = in_stride;
+    job.out = out;
+    job.out_stride = out_stride;
+    job.width = width;
+    job.height = height;
+    job.radius = r;
+    job.tile_fn = bilateral_tile;
+    job.offsets = offsets;
+    job.num_offsets = count;
+    job.weights = spatial;
+    job.lut = lut;
+    job.lut_scale = (float)((FILTER_LUT_SIZE - 1) / range);
+    status = filter_run(&job, filter_band_task, 8, executor);
+    free(offsets);
+    free(spatial);
+    free(lut);
+    return status;
+}
+
+// ---- Медиана сетью сравнений: окно k x k дополняется +inf до степени двойки и
+// сортируется сетью Батчера; из сети оставлены только сравнения, от которых
+// зависит центральный элемент, и не вырожденные из-за +inf.
+
+static size_t median_network(size_t n, size_t padded, size_t mid, uint8_t* pairs, size_t capacity) {
+    size_t count = 0;
+    uint8_t* all = (uint8_t*)malloc(2 * capacity);
+    if (!all) {
+        return 0;
+    }
+    for (size_t p = 1; p < padded; p <<= 1) {
+        for (size_t k = p; k >= 1; k >>= 1) {
+            for (size_t j = k % p; j + k < padded; j += 2 * k) {
+                for (size_t i = 0; i < k && i + j + k < padded; ++i) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        all[2 * count] = (uint8_t)(i + j);
+                        all[2 * count + 1] = (uint8_t)(i + j + k);
+                        ++count;
+                    }
+                }
+            }
+        }
+    }
+
+    // Прямой проход: сравнение с +inf на позиции максимума ничего не меняет
+    uint64_t inf = 0;
+    for (size_t i = n; i < padded; ++i) {
+        inf |= 1ULL << i;
+    }
+    size_t kept = 0;
+    for (size_t c = 0; c < count; ++c) {
+        uint8_t a = all[2 * c], b = all[2 * c + 1];
+        if (inf >> b & 1) {
+            continue;
+        }
+        if (inf >> a & 1) {
+            inf = (inf & ~(1ULL << a)) | (1ULL << b);
+        }
+        all[2 * kept] = a;
+        all[2 * kept + 1] = b;
+        ++kept;
+    }
+
+    // Обратный проход: только сравнения, влияющие на позицию mid
+    uint64_t needed = 1ULL << mid;
+    size_t out = kept;
+    for (size_t c = kept; c-- > 0;) {
+        uint8_t a = all[2 * c], b = all[2 * c + 1];
+        if ((needed >> a & 1) || (needed >> b & 1)) {
+            needed |= (1ULL << a) | (1ULL << b);
+            --out;
+            pairs[2 * out] = a;
+            pairs[2 * out + 1] = b;
+        }
+    }
+    memmove(pairs, pairs + 2 * out, 2 * (kept - out));
+    free(all);
+    return kept - out;
+}
+
+static void median_network_tile(const filter_job_t* job, const float* tile, size_t tile_stride,
+                                size_t rows, size_t cols, float* out, size_t out_stride, float* row_buf) {
+    size_t k = job->kernel;
+    size_t out_cols = filter_round_up(cols, FV_W);
+    const uint8_t* net = job->network;
+    float* ob = row_buf;
+    fv_t v[FILTER_MAX_NETWORK];
+    for (size_t i = 0; i < FILTER_MAX_NETWORK; ++i) {
+        v[i] = fv_set1(INFINITY);
+    }
+
+    for (size_t j = 0; j < rows; ++j) {
+        for (size_t x = 0; x < out_cols; x += FV_W) {
+            for (size_t dy = 0; dy < k; ++dy) {
+                const float* src = tile + (j + dy) * tile_stride + x;
+                for (size_t dx = 0; dx < k; ++dx) {
+                    v[dy * k + dx] = fv_load(src + dx);
+                }
+            }
+            for (size_t c = 0; c < job->network_size; ++c) {
+                fv_t a = v[net[2 * c]], b = v[net[2 * c + 1]];
+                v[net[2 * c]] = fv_min(a, b);
+                v[net[2 * c + 1]] = fv_max(a, b);
+            }
+            fv_store(ob + x, v[job->median_index]);
+        }
+        memcpy(out + j * out_stride, ob, cols * sizeof(float));
+    }
+}
+
+// ---- Медиана по гистограммам (Perreault–Hébert): для каждого столбца полосы
+// хранится гистограмма k строк, окно — сумма k столбцовых гистограмм; при сдвиге
+// на пиксель добавляется одна столбцовая и вычитается другая, при переходе на
+// строку каждая столбцовая обновляется на два значения. Грубая гистограмма на 16
+// корзин сокращает поиск медианы до двух коротких проходов.
+
+#define HIST_COARSE 16
+
+typedef struct {
+    uint16_t fine[FILTER_HIST_BINS];
+    uint16_t coarse[HIST_COARSE];
+} median_hist_t;
+
+static inline unsigned median_key(const filter_job_t* job, float v) {
+    float q = (v - job->q_min) * job->q_scale + 0.5f;
+    return q >= (float)(FILTER_HIST_BINS - 1) ? FILTER_HIST_BINS - 1 : q > 0.0f ? (unsigned)q : 0;
+}
+
+static inline void median_hist_update(median_hist_t* h, unsigned key, int delta) {
+    h->fine[key] = (uint16_t)(h->fine[key] + delta);
+    h->coarse[key / (FILTER_HIST_BINS / HIST_COARSE)] =
+        (uint16_t)(h->coarse[key / (FILTER_HIST_BINS / HIST_COARSE)] + delta);
+}
+
+static inline void median_hist_shift(median_hist_t* win, const median_hist_t* add, const median_hist_t* sub) {
+    for (size_t b = 0; b < FILTER_HIST_BINS; ++b) {
+        win->fine[b] = (uint16_t)(win->fine[b] + add->fine[b] - sub->fine[b]);
+    }
+    for (size_t b = 0; b < HIST_COARSE; ++b) {
+        win->coarse[b] = (uint16_t)(win->coarse[b] + add->coarse[b] - sub->coarse[b]);
+    }
+}
+
+static void median_hist_band_task(void* arg, size_t band) {
+    filter_job_t* job = (filter_job_t*)arg;
+    long r = (long)job->radius, w = (long)job->width, h = (long)job->height;
+    size_t y0 = band * job->band_rows;
+    size_t y1 = filter_min(y0 + job->band_rows, job->height);
+    median_hist_t* cols = (median_hist_t*)filter_alloc((size_t)w * sizeof(median_hist_t));
+    if (!cols) {
+        filter_fail(job, CORE_ERR_NOMEM);
+        return;
+    }
+    memset(cols, 0, (size_t)w * sizeof(median_hist_t));
+
+    for (long dy = -r; dy <= r; ++dy) {
+        long y = (long)y0 + dy;
+        const float* row = job->in + (size_t)(y < 0 ? 0 : y >= h ? h - 1 : y) * job->in_stride;
+        for (long x = 0; x < w; ++x) {
+            median_hist_update(&cols[x], median_key(job, row[x]), 1);
+        }
+    }
+
+    const unsigned target = (unsigned)job->median_index;
+    const float step = job->q_scale > 0.0f ? 1.0f / job->q_scale : 0.0f;
+    for (size_t y = y0; y < y1; ++y) {
+        if (y > y0) {
+            long ys = (long)y - r - 1, ya = (long)y + r;
+            const float* sub = job->in + (size_t)(ys < 0 ? 0 : ys) * job->in_stride;
+            const float* add = job->in + (size_t)(ya >= h ? h - 1 : ya) * job->in_stride;
+            for (long x = 0; x < w; ++x) {
+                median_hist_update(&cols[x], median_key(job, sub[x]), -1);
+                median_hist_update(&cols[x], median_key(job, add[x]), 1);
+            }
+        }
+
+        median_hist_t win;
+        memset(&win, 0, sizeof(win));
+        for (long dx = -r; dx <= r; ++dx) {
+            const median_hist_t* c = &cols[dx < 0 ? 0 : dx >= w ? w - 1 : dx];
+            for (size_t b = 0; b < FILTER_HIST_BINS; ++b) win.fine[b] = (uint16_t)(win.fine[b] + c->fine[b]);
+            for (size_t b = 0; b < HIST_COARSE; ++b) win.coarse[b] = (uint16_t)(win.coarse[b] + c->coarse[b]);
+        }
+
+        float* out = job->out + y * job->out_stride;
+        for (long x = 0; x < w; ++x) {
+            if (x > 0) {
+                long xa = x + r, xs = x - r - 1;
+                median_hist_shift(&win, &cols[xa >= w ? w - 1 : xa], &cols[xs < 0 ? 0 : xs]);
+            }
+            unsigned acc = 0, cb = 0;
+            while (acc + win.coarse[cb] <= target) {
+                acc += win.coarse[cb++];
+            }
+            unsigned b = cb * (FILTER_HIST_BINS / HIST_COARSE);
+            while (acc + win.fine[b] <= target) {
+                acc += win.fine[b++];
+            }
+            out[x] = job->q_min + (float)b * step;
+        }
+    }
+    free(cols);
+}
+
+int core_filter_median(const float* in, size_t in_stride, float* out, size_t out_stride,
+                       size_t width, size_t height, size_t kernel_size, const core_executor_t* executor) {
+    int status = filter_check(in, in_stride, out, out_stride, width, height);
+    if (status != CORE_SUCCESS || width == 0 || height == 0) {
+        return status;
+    }
+    if (kernel_size > 255) {
+        return CORE_ERR_INVALID;
+    }
+    size_t k = kernel_size | 1;
+    if (k == 1) {
+        filter_copy(in, in_stride, out, out_stride, width, height);
+        return CORE_SUCCESS;
+    }
+
+    filter_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.in = in;
+    job.in_stride = in_stride;
+    job.out = out;
+    job.out_stride = out_stride;
+    job.width = width;
+    job.height = height;
+    job.radius = k / 2;
+    job.kernel = k;
+    job.median_index = k * k / 2;
+
+    if (k * k <= FILTER_MAX_NETWORK) {
+        size_t padded = 1;
+        while (padded < k * k) {
+            padded <<= 1;
+        }
+        // Сеть Батчера на 64 входа — 543 сравнения
+        uint8_t network[2 * 1024];
+        job.network_size = median_network(k * k, padded, job.median_index, network, 1024);
+        if (job.network_size == 0) {
+            return CORE_ERR_NOMEM;
+        }
+        job.network = network;
+        job.tile_fn = median_network_tile;
+        return filter_run(&job, filter_band_task, 8, executor);
+    }
+
+    float lo = INFINITY, hi = -INFINITY;
+    for (size_t y = 0; y < height; ++y) {
+        float row_lo = core_vector_reduce_min_f32(in + y * in_stride, width);
+        float row_hi = core_vector_reduce_max_f32(in + y * in_stride, width);
+        lo = row_lo < lo ? row_lo : lo;
+        hi = row_hi > hi ? row_hi : hi;
+    }
+    job.q_min = lo;
+    job.q_scale = hi > lo ? (float)(FILTER_HIST_BINS - 1) / (hi - lo) : 0.0f;
+    // Полоса должна окупать начальное заполнение столбцовых гистограмм (2r+1 строк)
+    return filter_run(&job, median_hist_band_task, 4 * k, executor);
+}
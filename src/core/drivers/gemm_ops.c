@@ -0,0 +1,532 @@
+#include "core/drivers/gemm_ops.h"
+#include "core/drivers/cpu_info.h"
+#include "core/error_handling/core_errors.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+
+// Упакованный блочный GEMM в стиле Goto/BLIS:
+//   jc (nc столбцов) -> pc (kc глубина) -> упаковка панели B
+//     -> макроблоки (ic по mc строк) x (группы микропанелей B), параллельно
+//       -> упаковка блока A -> микроядро mr x nr по регистрам.
+// Хвосты по m и n дополняются нулями при упаковке, так что микроядро
+// всегда работает с полным блоком и лишь запись в C обрезается.
+
+#if defined(__AVX512F__)
+
+#define GEMM_MR 6
+#define GEMM_VF 16
+#define GEMM_VD 8
+#define GEMM_NRV 2
+typedef __m512 gemm_vf_t;
+typedef __m512d gemm_vd_t;
+static inline gemm_vf_t gemm_vf_zero() { return _mm512_setzero_ps(); }
+static inline gemm_vf_t gemm_vf_load(const float* p) { return _mm512_loadu_ps(p); }
+static inline void gemm_vf_store(float* p, gemm_vf_t v) { _mm512_storeu_ps(p, v); }
+static inline gemm_vf_t gemm_vf_bcast(float x) { return _mm512_set1_ps(x); }
+static inline gemm_vf_t gemm_vf_fma(gemm_vf_t a, gemm_vf_t b, gemm_vf_t c) { return _mm512_fmadd_ps(a, b, c); }
+static inline gemm_vd_t gemm_vd_zero() { return _mm512_setzero_pd(); }
+static inline gemm_vd_t gemm_vd_load(const double* p) { return _mm512_loadu_pd(p); }
+static inline void gemm_vd_store(double* p, gemm_vd_t v) { _mm512_storeu_pd(p, v); }
+static inline gemm_vd_t gemm_vd_bcast(double x) { return _mm512_set1_pd(x); }
+static inline gemm_vd_t gemm_vd_fma(gemm_vd_t a, gemm_vd_t b, gemm_vd_t c) { return _mm512_fmadd_pd(a, b, c); }
+
+#elif defined(__AVX2__)
+
+#define GEMM_MR 6
+#define GEMM_VF 8
+#define GEMM_VD 4
+#define GEMM_NRV 2
+typedef __m256 gemm_vf_t;
+typedef __m256d gemm_vd_t;
+static inline gemm_vf_t gemm_vf_zero() { return _mm256_setzero_ps(); }
+static inline gemm_vf_t gemm_vf_load(const float* p) { return _mm256_loadu_ps(p); }
+static inline void gemm_vf_store(float* p, gemm_vf_t v) { _mm256_storeu_ps(p, v); }
+static inline gemm_vf_t gemm_vf_bcast(float x) { return _mm256_set1_ps(x); }
+static inline gemm_vd_t gemm_vd_zero() { return _mm256_setzero_pd(); }
+static inline gemm_vd_t gemm_vd_load(const double* p) { return _mm256_loadu_pd(p); }
+static inline void gemm_vd_store(double* p, gemm_vd_t v) { _mm256_storeu_pd(p, v); }
+static inline gemm_vd_t gemm_vd_bcast(double x) { return _mm256_set1_pd(x); }
+#if defined(__FMA__)
+static inline gemm_vf_t gemm_vf_fma(gemm_vf_t a, gemm_vf_t b, gemm_vf_t c) { return _mm256_fmadd_ps(a, b, c); }
+static inline gemm_vd_t gemm_vd_fma(gemm_vd_t a, gemm_vd_t b, gemm_vd_t c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+static inline gemm_vf_t gemm_vf_fma(gemm_vf_t a, gemm_vf_t b, gemm_vf_t c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+static inline gemm_vd_t gemm_vd_fma(gemm_vd_t a, gemm_vd_t b, gemm_vd_t c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+#endif
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+#define GEMM_MR 8
+#define GEMM_VF 4
+#define GEMM_VD 2
+#define GEMM_NRV 3
+typedef float32x4_t gemm_vf_t;
+typedef float64x2_t gemm_vd_t;
+static inline gemm_vf_t gemm_vf_zero() { return vdupq_n_f32(0.0f); }
+static inline gemm_vf_t gemm_vf_load(const float* p) { return vld1q_f32(p); }
+static inline void gemm_vf_store(float* p, gemm_vf_t v) { vst1q_f32(p, v); }
+static inline gemm_vf_t gemm_vf_bcast(float x) { return vdupq_n_f32(x); }
+static inline gemm_vf_t gemm_vf_fma(gemm_vf_t a, gemm_vf_t b, gemm_vf_t c) { return vfmaq_f32(c, a, b); }
+static inline gemm_vd_t gemm_vd_zero() { return vdupq_n_f64(0.0); }
+static inline gemm_vd_t gemm_vd_load(const double* p) { return vld1q_f64(p); }
+static inline void gemm_vd_store(double* p, gemm_vd_t v) { vst1q_f64(p, v); }
+static inline gemm_vd_t gemm_vd_bcast(double x) { return vdupq_n_f64(x); }
+static inline gemm_vd_t gemm_vd_fma(gemm_vd_t a, gemm_vd_t b, gemm_vd_t c) { return vfmaq_f64(c, a, b); }
+
+#else
+
+#define GEMM_MR 4
+#define GEMM_VF 1
+#define GEMM_VD 1
+#define GEMM_NRV 4
+typedef float gemm_vf_t;
+typedef double gemm_vd_t;
+static inline gemm_vf_t gemm_vf_zero() { return 0.0f; }
+static inline gemm_vf_t gemm_vf_load(const float* p) { return *p; }
+static inline void gemm_vf_store(float* p, gemm_vf_t v) { *p = v; }
+static inline gemm_vf_t gemm_vf_bcast(float x) { return x; }
+static inline gemm_vf_t gemm_vf_fma(gemm_vf_t a, gemm_vf_t b, gemm_vf_t c) { return a * b + c; }
+static inline gemm_vd_t gemm_vd_zero() { return 0.0; }
+static inline gemm_vd_t gemm_vd_load(const double* p) { return *p; }
+static inline void gemm_vd_store(double* p, gemm_vd_t v) { *p = v; }
+static inline gemm_vd_t gemm_vd_bcast(double x) { return x; }
+static inline gemm_vd_t gemm_vd_fma(gemm_vd_t a, gemm_vd_t b, gemm_vd_t c) { return a * b + c; }
+
+#endif
+
+#define GEMM_NR_F32 (GEMM_NRV * GEMM_VF)
+#define GEMM_NR_F64 (GEMM_NRV * GEMM_VD)
+#define GEMM_ALIGNMENT 64
+
+static inline size_t gemm_min(size_t a, size_t b) { return a < b ? a : b; }
+static inline size_t gemm_round_down(size_t x, size_t m) { return x / m * m; }
+
+static void* gemm_alloc(size_t bytes) {
+    void* ptr = NULL;
+    if (posix_memalign(&ptr, GEMM_ALIGNMENT, bytes) != 0) {
+        return NULL;
+    }
+    return ptr;
+}
+
+// Микроядра: C[mr x nr] += alpha * Ap(mr x kc) * Bp(kc x nr)
+
+static void gemm_kernel_f32(size_t kc, const void* ap_, const void* bp_, void* c_, size_t ldc,
+                            double alpha_d, size_t mr, size_t nr) {
+    const float* ap = (const float*)ap_;
+    const float* bp = (const float*)bp_;
+    float* c = (float*)c_;
+    gemm_vf_t acc[GEMM_MR][GEMM_NRV];
+    for (size_t r = 0; r < GEMM_MR; ++r) {
+        for (size_t v = 0; v < GEMM_NRV; ++v) acc[r][v] = gemm_vf_zero();
+    }
+
+    for (size_t p = 0; p < kc; ++p) {
+        gemm_vf_t b[GEMM_NRV];
+        for (size_t v = 0; v < GEMM_NRV; ++v) b[v] = gemm_vf_load(bp + v * GEMM_VF);
+        for (size_t r = 0; r < GEMM_MR; ++r) {
+            gemm_vf_t a = gemm_vf_bcast(ap[r]);
+            for (size_t v = 0; v < GEMM_NRV; ++v) acc[r][v] = gemm_vf_fma(a, b[v], acc[r][v]);
+        }
+        ap += GEMM_MR;
+        bp += GEMM_NR_F32;
+    }
+
+    const gemm_vf_t alpha = gemm_vf_bcast((float)alpha_d);
+    if (mr == GEMM_MR && nr == GEMM_NR_F32) {
+        for (size_t r = 0; r < GEMM_MR; ++r) {
+            for (size_t v = 0; v < GEMM_NRV; ++v) {
+                float* cp = c + r * ldc + v * GEMM_VF;
+                gemm_vf_store(cp, gemm_vf_fma(alpha, acc[r][v], gemm_vf_load(cp)));
+            }
+        }
+    } else {
+        float tile[GEMM_MR * GEMM_NR_F32];
+        for (size_t r = 0; r < GEMM_MR; ++r) {
+            for (size_t v = 0; v < GEMM_NRV; ++v) gemm_vf_store(tile + r * GEMM_NR_F32 + v * GEMM_VF, acc[r][v]);
+        }
+        for (size_t r = 0; r < mr; ++r) {
+            for (size_t j = 0; j < nr; ++j) c[r * ldc + j] += (float)alpha_d * tile[r * GEMM_NR_F32 + j];
+        }
+    }
+}
+
+static void gemm_kernel_f64(size_t kc, const void* ap_, const void* bp_, void* c_, size_t ldc,
+                            double alpha_d, size_t mr, size_t nr) {
+    const double* ap = (const double*)ap_;
+    const double* bp = (const double*)bp_;
+    double* c = (double*)c_;
+    gemm_vd_t acc[GEMM_MR][GEMM_NRV];
+    for (size_t r = 0; r < GEMM_MR; ++r) {
+        for (size_t v = 0; v < GEMM_NRV; ++v) acc[r][v] = gemm_vd_zero();
+    }
+
+    for (size_t p = 0; p < kc; ++p) {
+        gemm_vd_t b[GEMM_NRV];
+        for (size_t v = 0; v < GEMM_NRV; ++v) b[v] = gemm_vd_load(bp + v * GEMM_VD);
+        for (size_t r = 0; r < GEMM_MR; ++r) {
+            gemm_vd_t a = gemm_vd_bcast(ap[r]);
+            for (size_t v = 0; v < GEMM_NRV; ++v) acc[r][v] = gemm_vd_fma(a, b[v], acc[r][v]);
+        }
+        ap += GEMM_MR;
+        bp += GEMM_NR_F64;
+    }
+
+    const gemm_vd_t alpha = gemm_vd_bcast(alpha_d);
+    if (mr == GEMM_MR && nr == GEMM_NR_F64) {
+        for (size_t r = 0; r < GEMM_MR; ++r) {
+            for (size_t v = 0; v < GEMM_NRV; ++v) {
+                double* cp = c + r * ldc + v * GEMM_VD;
+                gemm_vd_store(cp, gemm_vd_fma(alpha, acc[r][v], gemm_vd_load(cp)));
+            }
+        }
+    } else {
+        double tile[GEMM_MR * GEMM_NR_F64];
+        for (size_t r = 0; r < GEMM_MR; ++r) {
+            for (size_t v = 0; v < GEMM_NRV; ++v) gemm_vd_store(tile + r * GEMM_NR_F64 + v * GEMM_VD, acc[r][v]);
+        }
+        for (size_t r = 0; r < mr; ++r) {
+            for (size_t j = 0; j < nr; ++j) c[r * ldc + j] += alpha_d * tile[r * GEMM_NR_F64 + j];
+        }
+    }
+}
+
+// Упаковка блока op(A)[i0:i0+mc, p0:p0+kc] в микропанели по GEMM_MR строк,
+// внутри панели — по столбцам (kc групп по GEMM_MR элементов)
+
+static void gemm_pack_a_f32(const void* a_, size_t lda, int trans, size_t i0, size_t p0,
+                            size_t mc, size_t kc, void* dst_) {
+    const float* a = (const float*)a_;
+    float* dst = (float*)dst_;
+    for (size_t ir = 0; ir < mc; ir += GEMM_MR) {
+        size_t rows = gemm_min(GEMM_MR, mc - ir);
+        for (size_t p = 0; p < kc; ++p) {
+            for (size_t r = 0; r < GEMM_MR; ++r) {
+                size_t i = i0 + ir + r;
+                dst[p * GEMM_MR + r] = r >= rows ? 0.0f
+                                     : trans ? a[(p0 + p) * lda + i] : a[i * lda + p0 + p];
+            }
+        }
+        dst += kc * GEMM_MR;
+    }
+}
+
+static void gemm_pack_a_f64(const void* a_, size_t lda, int trans, size_t i0, size_t p0,
+                            size_t mc, size_t kc, void* dst_) {
+    const double* a = (const double*)a_;
+    double* dst = (double*)dst_;
+    for (size_t ir = 0; ir < mc; ir += GEMM_MR) {
+        size_t rows = gemm_min(GEMM_MR, mc - ir);
+        for (size_t p = 0; p < kc; ++p) {
+            for (size_t r = 0; r < GEMM_MR; ++r) {
+                size_t i = i0 + ir + r;
+                dst[p * GEMM_MR + r] = r >= rows ? 0.0
+                                     : trans ? a[(p0 + p) * lda + i] : a[i * lda + p0 + p];
+            }
+        }
+        dst += kc * GEMM_MR;
+    }
+}
+
+// Упаковка панели op(B)[p0:p0+kc, j0:j0+nc] в микропанели по nr столбцов,
+// внутри панели — по строкам (kc групп по nr элементов)
+
+static void gemm_pack_b_f32(const void* b_, size_t ldb, int trans, size_t p0, size_t j0,
+                            size_t kc, size_t nc, void* dst_) {
+    const float* b = (const float*)b_;
+    float* dst = (float*)dst_;
+    for (size_t jr = 0; jr < nc; jr += GEMM_NR_F32) {
+        size_t cols = gemm_min(GEMM_NR_F32, nc - jr);
+        if (cols < GEMM_NR_F32) {
+            memset(dst, 0, kc * GEMM_NR_F32 * sizeof(float));
+        }
+        if (!trans) {
+            for (size_t p = 0; p < kc; ++p) {
+                memcpy(dst + p * GEMM_NR_F32, b + (p0 + p) * ldb + j0 + jr, cols * sizeof(float));
+            }
+        } else {
+            for (size_t j = 0; j < cols; ++j) {
+                const float* src = b + (j0 + jr + j) * ldb + p0;
+                for (size_t p = 0; p < kc; ++p) dst[p * GEMM_NR_F32 + j] = src[p];
+            }
+        }
+        dst += kc * GEMM_NR_F32;
+    }
+}
+
+static void gemm_pack_b_f64(const void* b_, size_t ldb, int trans, size_t p0, size_t j0,
+                            size_t kc, size_t nc, void* dst_) {
+    const double* b = (const double*)b_;
+    double* dst = (double*)dst_;
+    for (size_t jr = 0; jr < nc; jr += GEMM_NR_F64) {
+        size_t cols = gemm_min(GEMM_NR_F64, nc - jr);
+        if (cols < GEMM_NR_F64) {
+            memset(dst, 0, kc * GEMM_NR_F64 * sizeof(double));
+        }
+        if (!trans) {
+            for (size_t p = 0; p < kc; ++p) {
+                memcpy(dst + p * GEMM_NR_F64, b + (p0 + p) * ldb + j0 + jr, cols * sizeof(double));
+            }
+        } else {
+            for (size_t j = 0; j < cols; ++j) {
+                const double* src = b + (j0 + jr + j) * ldb + p0;
+                for (size_t p = 0; p < kc; ++p) dst[p * GEMM_NR_F64 + j] = src[p];
+            }
+        }
+        dst += kc * GEMM_NR_F64;
+    }
+}
+
+static void gemm_scale_f32(void* c_, size_t ldc, size_t m, size_t n, double beta) {
+    float* c = (float*)c_;
+    for (size_t i = 0; i < m; ++i) {
+        float* row = c + i * ldc;
+        if (beta == 0.0) {
+            memset(row, 0, n * sizeof(float));
+        } else {
+            for (size_t j = 0; j < n; ++j) row[j] *= (float)beta;
+        }
+    }
+}
+
+static void gemm_scale_f64(void* c_, size_t ldc, size_t m, size_t n, double beta) {
+    double* c = (double*)c_;
+    for (size_t i = 0; i < m; ++i) {
+        double* row = c + i * ldc;
+        if (beta == 0.0) {
+            memset(row, 0, n * sizeof(double));
+        } else {
+            for (size_t j = 0; j < n; ++j) row[j] *= beta;
+        }
+    }
+}
+
+// Типонезависимый драйвер работает через таблицу операций конкретного типа
+typedef struct {
+    size_t elem;
+    size_t mr;
+    size_t nr;
+    void (*pack_a)(const void* a, size_t lda, int trans, size_t i0, size_t p0, size_t mc, size_t kc, void* dst);
+    void (*pack_b)(const void* b, size_t ldb, int trans, size_t p0, size_t j0, size_t kc, size_t nc, void* dst);
+    void (*kernel)(size_t kc, const void* ap, const void* bp, void* c, size_t ldc, double alpha, size_t mr, size_t nr);
+    void (*scale)(void* c, size_t ldc, size_t m, size_t n, double beta);
+} gemm_type_ops_t;
+
+static const gemm_type_ops_t gemm_ops_f32 = {
+    sizeof(float), GEMM_MR, GEMM_NR_F32,
+    gemm_pack_a_f32, gemm_pack_b_f32, gemm_kernel_f32, gemm_scale_f32
+};
+
+static const gemm_type_ops_t gemm_ops_f64 = {
+    sizeof(double), GEMM_MR, GEMM_NR_F64,
+    gemm_pack_a_f64, gemm_pack_b_f64, gemm_kernel_f64, gemm_scale_f64
+};
+
+// Ручная настройка разбиения (0 — автоматически). Поля читаются и пишутся
+// атомарно: set может вызываться параллельно с идущими умножениями, каждое из
+// которых снимает разбиение один раз в начале.
+static size_t gemm_blocking_override_mc;
+static size_t gemm_blocking_override_kc;
+static size_t gemm_blocking_override_nc;
+
+void core_gemm_get_blocking(size_t elem_size, core_gemm_blocking_t* blocking) {
+    if (!blocking) {
+        return;
+    }
+    if (elem_size == 0) {
+        elem_size = sizeof(float);
+    }
+    core_cache_config_t cache;
+    core_cpu_cache_config(&cache);
+
+    size_t mr = GEMM_MR;
+    size_t nr = elem_size == sizeof(double) ? GEMM_NR_F64 : GEMM_NR_F32;
+
+    // Микропанель B (kc x nr) и микропанель A (mr x kc) занимают около половины L1
+    size_t kc = cache.levels[0].size / 2 / ((mr + nr) * elem_size);
+    kc = kc < 64 ? 64 : kc > 512 ? 512 : gemm_round_down(kc, 8);
+    // Блок A (mc x kc) — около половины L2
+    size_t mc = gemm_round_down(cache.levels[1].size / 2 / (kc * elem_size), mr);
+    mc = mc < mr ? mr : mc > 1024 ? gemm_round_down(1024, mr) : mc;
+    // Панель B (kc x nc) — около половины L3
+    size_t nc = gemm_round_down(cache.levels[2].size / 2 / (kc * elem_size), nr);
+    nc = nc < nr ? nr : nc > 8192 ? gemm_round_down(8192, nr) : nc;
+
+    size_t mc_override = __atomic_load_n(&gemm_blocking_override_mc, __ATOMIC_RELAXED);
+    size_t kc_override = __atomic_load_n(&gemm_blocking_override_kc, __ATOMIC_RELAXED);
+    size_t nc_override = __atomic_load_n(&gemm_blocking_override_nc, __ATOMIC_RELAXED);
+
+    blocking->mr = mr;
+    blocking->nr = nr;
+    blocking->kc = kc_override ? kc_override : kc;
+    blocking->mc = mc_override ? gemm_round_down(mc_override + mr - 1, mr) : mc;
+    blocking->nc = nc_override ? gemm_round_down(nc_override + nr - 1, nr) : nc;
+}
+
+void core_gemm_set_blocking(const core_gemm_blocking_t* blocking) {
+    __atomic_store_n(&gemm_blocking_override_mc, blocking ? blocking->mc : 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&gemm_blocking_override_kc, blocking ? blocking->kc : 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&gemm_blocking_override_nc, blocking ? blocking->nc : 0, __ATOMIC_RELAXED);
+}
+
+// Макроблок: строки [ic, ic + mc) блока A на группе микропанелей упакованной панели B.
+// Блоки A упаковываются отдельным проходом один раз на (ic, pc) в общий буфер
+// packed_a (num_ic блоков по mc x kc_max), так что задачи по столбцам их разделяют.
+typedef struct {
+    const gemm_type_ops_t* ops;
+    const core_gemm_blocking_t* blk;
+    int trans_a;
+    const char* a;
+    size_t lda;
+    char* packed_a;
+    size_t packed_a_stride;
+    const char* packed_b;
+    char* c;
+    size_t ldc;
+    size_t m;
+    size_t pc;
+    size_t kc;
+    size_t jc;
+    size_t nc;
+    size_t num_ic;
+    size_t slivers_per_task;
+    double alpha;
+} gemm_macro_ctx_t;
+
+static void gemm_pack_a_block(void* arg, size_t index) {
+    gemm_macro_ctx_t* ctx = (gemm_macro_ctx_t*)arg;
+    size_t ic = index * ctx->blk->mc;
+    size_t mc = gemm_min(ctx->blk->mc, ctx->m - ic);
+    ctx->ops->pack_a(ctx->a, ctx->lda, ctx->trans_a, ic, ctx->pc, mc, ctx->kc,
+                     ctx->packed_a + index * ctx->packed_a_stride);
+}
+
+static void gemm_macro_tile(void* arg, size_t index) {
+    gemm_macro_ctx_t* ctx = (gemm_macro_ctx_t*)arg;
+    const gemm_type_ops_t* ops = ctx->ops;
+    const size_t mr = ops->mr, nr = ops->nr, elem = ops->elem;
+
+    size_t ic = (index % ctx->num_ic) * ctx->blk->mc;
+    size_t mc = gemm_min(ctx->blk->mc, ctx->m - ic);
+    size_t j_begin = (index / ctx->num_ic) * ctx->slivers_per_task * nr;
+    if (j_begin >= ctx->nc) {
+        return;
+    }
+    size_t j_end = gemm_min(ctx->nc, j_begin + ctx->slivers_per_task * nr);
+
+    const char* packed_a = ctx->packed_a + (index % ctx->num_ic) * ctx->packed_a_stride;
+    for (size_t jr = j_begin; jr < j_end; jr += nr) {
+        const char* bp = ctx->packed_b + jr * ctx->kc * elem;
+        for (size_t ir = 0; ir < mc; ir += mr) {
+            char* cp = ctx->c + ((ic + ir) * ctx->ldc + ctx->jc + jr) * elem;
+            ops->kernel(ctx->kc, packed_a + ir * ctx->kc * elem, bp, cp, ctx->ldc, ctx->alpha,
+                        gemm_min(mr, mc - ir), gemm_min(nr, ctx->nc - jr));
+        }
+    }
+}
+
+static int gemm_driver(const gemm_type_ops_t* ops, int trans_a, int trans_b,
+                       size_t m, size_t n, size_t k, double alpha,
+                       const void* a, size_t lda, const void* b, size_t ldb,
+                       double beta, void* c, size_t ldc, const core_gemm_executor_t* executor) {
+    if (m == 0 || n == 0) {
+        return CORE_SUCCESS;
+    }
+    if (!a || !b || !c || ldc < n || lda < (trans_a ? m : k) || ldb < (trans_b ? k : n)) {
+        return CORE_ERR_INVALID;
+    }
+
+    if (beta != 1.0) {
+        ops->scale(c, ldc, m, n, beta);
+    }
+    if (k == 0 || alpha == 0.0) {
+        return CORE_SUCCESS;
+    }
+
+    core_gemm_blocking_t blk;
+    core_gemm_get_blocking(ops->elem, &blk);
+    const size_t kc_max = gemm_min(blk.kc, k);
+    const size_t nc_max = gemm_min(blk.nc, (n + blk.nr - 1) / blk.nr * blk.nr);
+
+    const size_t num_ic = (m + blk.mc - 1) / blk.mc;
+    const size_t mc_padded = (gemm_min(blk.mc, m) + blk.mr - 1) / blk.mr * blk.mr;
+
+    char* packed_b = (char*)gemm_alloc(kc_max * nc_max * ops->elem);
+    char* packed_a = (char*)gemm_alloc(num_ic * mc_padded * kc_max * ops->elem);
+    if (!packed_b || !packed_a) {
+        free(packed_b);
+        free(packed_a);
+        return CORE_ERR_NOMEM;
+    }
+
+    size_t threads = executor && executor->parallel_for && executor->num_threads > 1 ? executor->num_threads : 1;
+    gemm_macro_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.ops = ops;
+    ctx.blk = &blk;
+    ctx.trans_a = trans_a;
+    ctx.a = (const char*)a;
+    ctx.lda = lda;
+    ctx.packed_a = packed_a;
+    ctx.packed_a_stride = mc_padded * kc_max * ops->elem;
+    ctx.packed_b = packed_b;
+    ctx.c = (char*)c;
+    ctx.ldc = ldc;
+    ctx.m = m;
+    ctx.alpha = alpha;
+    ctx.num_ic = num_ic;
+
+    for (size_t jc = 0; jc < n; jc += blk.nc) {
+        size_t nc = gemm_min(blk.nc, n - jc);
+        size_t slivers = (nc + blk.nr - 1) / blk.nr;
+        // Если блоков по m меньше, чем потоков, дополнительно делим панель B по столбцам
+        size_t j_tasks = gemm_min(slivers, (2 * threads + ctx.num_ic - 1) / ctx.num_ic);
+        if (j_tasks == 0) j_tasks = 1;
+        ctx.slivers_per_task = (slivers + j_tasks - 1) / j_tasks;
+        j_tasks = (slivers + ctx.slivers_per_task - 1) / ctx.slivers_per_task;
+
+        for (size_t pc = 0; pc < k; pc += blk.kc) {
+            size_t kc = gemm_min(blk.kc, k - pc);
+            ops->pack_b(b, ldb, trans_b, pc, jc, kc, nc, packed_b);
+
+            ctx.pc = pc;
+            ctx.kc = kc;
+            ctx.jc = jc;
+            ctx.nc = nc;
+            size_t num_tasks = ctx.num_ic * j_tasks;
+            if (threads > 1 && num_tasks > 1) {
+                if (ctx.num_ic > 1) {
+                    executor->parallel_for(executor->ctx, ctx.num_ic, gemm_pack_a_block, &ctx);
+                } else {
+                    gemm_pack_a_block(&ctx, 0);
+                }
+                executor->parallel_for(executor->ctx, num_tasks, gemm_macro_tile, &ctx);
+            } else {
+                for (size_t t = 0; t < ctx.num_ic; ++t) gemm_pack_a_block(&ctx, t);
+                for (size_t t = 0; t < num_tasks; ++t) gemm_macro_tile(&ctx, t);
+            }
+        }
+    }
+
+    free(packed_a);
+    free(packed_b);
+    return CORE_SUCCESS;
+}
+
+int core_gemm_f32(int trans_a, int trans_b, size_t m, size_t n, size_t k,
+                  float alpha, const float* a, size_t lda, const float* b, size_t ldb,
+                  float beta, float* c, size_t ldc, const core_gemm_executor_t* executor) {
+    return gemm_driver(&gemm_ops_f32, trans_a, trans_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, executor);
+}
+
+int core_gemm_f64(int trans_a, int trans_b, size_t m, size_t n, size_t k,
+                  double alpha, const double* a, size_t lda, const double* b, size_t ldb,
+                  double beta, double* c, size_t ldc, const core_gemm_executor_t* executor) {
+    return gemm_driver(&gemm_ops_f64, trans_a, trans_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, executor);
+}
@@ -1,272 +1,476 @@
 #include "core/drivers/math_ops.h"
-#include <math.h>
 
-#if defined(__AVX2__)
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE4_2__)
 #include <immintrin.h>
-#elif defined(__ARM_NEON)
+#elif defined(__ARM_NEON) && defined(__aarch64__)
 #include <arm_neon.h>
 #endif
+#include <math.h>
+#include <string.h>
 
-// Быстрые математические функции с использованием таблиц и аппроксимаций
-static const float sin_table[256] = {
-    // Таблица предварительно вычисленных значений sin
-    #include "sin_table.h"
-};
-
-static const float cos_table[256] = {
-    // Таблица предварительно вычисленных значений cos
-    #include "cos_table.h"
-};
-
-float core_fast_sin(float x) {
-    // Нормализация угла в диапазон [0, 2π]
-    x = fmodf(x, 2.0f * M_PI);
-    if (x < 0) x += 2.0f * M_PI;
-    
-    // Преобразование в индекс таблицы
-    int idx = (int)(x * 256.0f / (2.0f * M_PI)) & 0xFF;
-    return sin_table[idx];
-}
+// Слой абстракции над набором инструкций: каждая функция ниже написана один раз
+// в терминах vf_* (float), vi_* (int32) и vm_* (маска по элементам). Для
+// константных сдвигов vi_slli/vi_srai — макросы, потому что интринсики требуют
+// непосредственный операнд.
 
-float core_fast_cos(float x) {
-    // Нормализация угла в диапазон [0, 2π]
-    x = fmodf(x, 2.0f * M_PI);
-    if (x < 0) x += 2.0f * M_PI;
-    
-    // Преобразование в индекс таблицы
-    int idx = (int)(x * 256.0f / (2.0f * M_PI)) & 0xFF;
-    return cos_table[idx];
-}
+#if defined(__AVX512F__)
+
+#define VF_WIDTH 16
+typedef __m512 vf_t;
+typedef __m512i vi_t;
+typedef __mmask16 vm_t;
+
+static inline vf_t vf_load(const float* p) { return _mm512_loadu_ps(p); }
+static inline void vf_store(float* p, vf_t v) { _mm512_storeu_ps(p, v); }
+static inline vf_t vf_set1(float x) { return _mm512_set1_ps(x); }
+static inline vf_t vf_add(vf_t a, vf_t b) { return _mm512_add_ps(a, b); }
+static inline vf_t vf_sub(vf_t a, vf_t b) { return _mm512_sub_ps(a, b); }
+static inline vf_t vf_mul(vf_t a, vf_t b) { return _mm512_mul_ps(a, b); }
+static inline vf_t vf_div(vf_t a, vf_t b) { return _mm512_div_ps(a, b); }
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) { return _mm512_fmadd_ps(a, b, c); }
+static inline vf_t vf_min(vf_t a, vf_t b) { return _mm512_min_ps(a, b); }
+static inline vf_t vf_max(vf_t a, vf_t b) { return _mm512_max_ps(a, b); }
+static inline vf_t vf_sqrt(vf_t a) { return _mm512_sqrt_ps(a); }
+static inline vf_t vf_rsqrt_estimate(vf_t a) { return _mm512_rsqrt14_ps(a); }
+static inline vf_t vf_round(vf_t a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+static inline vm_t vf_lt(vf_t a, vf_t b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+static inline vm_t vf_eq(vf_t a, vf_t b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+static inline vm_t vf_isnan(vf_t a) { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+static inline vf_t vf_select(vm_t m, vf_t a, vf_t b) { return _mm512_mask_blend_ps(m, b, a); }
+static inline vm_t vm_or(vm_t a, vm_t b) { return (vm_t)(a | b); }
 
-float core_fast_sqrt(float x) {
-#if defined(__AVX2__)
-    __m128 val = _mm_set_ss(x);
-    val = _mm_sqrt_ss(val);
-    return _mm_cvtss_f32(val);
-#elif defined(__ARM_NEON)
-    float32x2_t val = vdup_n_f32(x);
-    val = vsqrt_f32(val);
-    return vget_lane_f32(val, 0);
+static inline vi_t vi_set1(int32_t x) { return _mm512_set1_epi32(x); }
+static inline vi_t vi_add(vi_t a, vi_t b) { return _mm512_add_epi32(a, b); }
+static inline vi_t vi_sub(vi_t a, vi_t b) { return _mm512_sub_epi32(a, b); }
+static inline vi_t vi_and(vi_t a, vi_t b) { return _mm512_and_si512(a, b); }
+static inline vi_t vi_xor(vi_t a, vi_t b) { return _mm512_xor_si512(a, b); }
+static inline vm_t vi_test(vi_t a, int32_t bits) { return _mm512_test_epi32_mask(a, _mm512_set1_epi32(bits)); }
+static inline vi_t vi_from_vf(vf_t a) { return _mm512_cvtps_epi32(a); }
+static inline vf_t vf_from_vi(vi_t a) { return _mm512_cvtepi32_ps(a); }
+static inline vi_t vi_cast(vf_t a) { return _mm512_castps_si512(a); }
+static inline vf_t vf_cast(vi_t a) { return _mm512_castsi512_ps(a); }
+#define vi_slli(a, k) _mm512_slli_epi32((a), (k))
+#define vi_srai(a, k) _mm512_srai_epi32((a), (k))
+
+#elif defined(__AVX2__)
+
+#define VF_WIDTH 8
+typedef __m256 vf_t;
+typedef __m256i vi_t;
+typedef __m256 vm_t;
+
+static inline vf_t vf_load(const float* p) { return _mm256_loadu_ps(p); }
+static inline void vf_store(float* p, vf_t v) { _mm256_storeu_ps(p, v); }
+static inline vf_t vf_set1(float x) { return _mm256_set1_ps(x); }
+static inline vf_t vf_add(vf_t a, vf_t b) { return _mm256_add_ps(a, b); }
+static inline vf_t vf_sub(vf_t a, vf_t b) { return _mm256_sub_ps(a, b); }
+static inline vf_t vf_mul(vf_t a, vf_t b) { return _mm256_mul_ps(a, b); }
+static inline vf_t vf_div(vf_t a, vf_t b) { return _mm256_div_ps(a, b); }
+#if defined(__FMA__)
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) { return _mm256_fmadd_ps(a, b, c); }
 #else
-    return sqrtf(x);
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
 #endif
+static inline vf_t vf_min(vf_t a, vf_t b) { return _mm256_min_ps(a, b); }
+static inline vf_t vf_max(vf_t a, vf_t b) { return _mm256_max_ps(a, b); }
+static inline vf_t vf_sqrt(vf_t a) { return _mm256_sqrt_ps(a); }
+static inline vf_t vf_rsqrt_estimate(vf_t a) { return _mm256_rsqrt_ps(a); }
+static inline vf_t vf_round(vf_t a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+static inline vm_t vf_lt(vf_t a, vf_t b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline vm_t vf_eq(vf_t a, vf_t b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+static inline vm_t vf_isnan(vf_t a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+static inline vf_t vf_select(vm_t m, vf_t a, vf_t b) { return _mm256_blendv_ps(b, a, m); }
+static inline vm_t vm_or(vm_t a, vm_t b) { return _mm256_or_ps(a, b); }
+
+static inline vi_t vi_set1(int32_t x) { return _mm256_set1_epi32(x); }
+static inline vi_t vi_add(vi_t a, vi_t b) { return _mm256_add_epi32(a, b); }
+static inline vi_t vi_sub(vi_t a, vi_t b) { return _mm256_sub_epi32(a, b); }
+static inline vi_t vi_and(vi_t a, vi_t b) { return _mm256_and_si256(a, b); }
+static inline vi_t vi_xor(vi_t a, vi_t b) { return _mm256_xor_si256(a, b); }
+static inline vm_t vi_test(vi_t a, int32_t bits) {
+    vi_t b = _mm256_set1_epi32(bits);
+    return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(a, b), b));
 }
+static inline vi_t vi_from_vf(vf_t a) { return _mm256_cvtps_epi32(a); }
+static inline vf_t vf_from_vi(vi_t a) { return _mm256_cvtepi32_ps(a); }
+static inline vi_t vi_cast(vf_t a) { return _mm256_castps_si256(a); }
+static inline vf_t vf_cast(vi_t a) { return _mm256_castsi256_ps(a); }
+#define vi_slli(a, k) _mm256_slli_epi32((a), (k))
+#define vi_srai(a, k) _mm256_srai_epi32((a), (k))
+
+#elif defined(__SSE4_2__)
+
+#define VF_WIDTH 4
+typedef __m128 vf_t;
+typedef __m128i vi_t;
+typedef __m128 vm_t;
 
-float core_fast_rsqrt(float x) {
-#if defined(__AVX2__)
-    __m128 val = _mm_set_ss(x);
-    val = _mm_rsqrt_ss(val);
-    return _mm_cvtss_f32(val);
-#elif defined(__ARM_NEON)
-    float32x2_t val = vdup_n_f32(x);
-    val = vrsqrte_f32(val);
-    return vget_lane_f32(val, 0);
+static inline vf_t vf_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void vf_store(float* p, vf_t v) { _mm_storeu_ps(p, v); }
+static inline vf_t vf_set1(float x) { return _mm_set1_ps(x); }
+static inline vf_t vf_add(vf_t a, vf_t b) { return _mm_add_ps(a, b); }
+static inline vf_t vf_sub(vf_t a, vf_t b) { return _mm_sub_ps(a, b); }
+static inline vf_t vf_mul(vf_t a, vf_t b) { return _mm_mul_ps(a, b); }
+static inline vf_t vf_div(vf_t a, vf_t b) { return _mm_div_ps(a, b); }
+#if defined(__FMA__)
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) { return _mm_fmadd_ps(a, b, c); }
 #else
-    return 1.0f / sqrtf(x);
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
 #endif
+static inline vf_t vf_min(vf_t a, vf_t b) { return _mm_min_ps(a, b); }
+static inline vf_t vf_max(vf_t a, vf_t b) { return _mm_max_ps(a, b); }
+static inline vf_t vf_sqrt(vf_t a) { return _mm_sqrt_ps(a); }
+static inline vf_t vf_rsqrt_estimate(vf_t a) { return _mm_rsqrt_ps(a); }
+static inline vf_t vf_round(vf_t a) { return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+static inline vm_t vf_lt(vf_t a, vf_t b) { return _mm_cmplt_ps(a, b); }
+static inline vm_t vf_eq(vf_t a, vf_t b) { return _mm_cmpeq_ps(a, b); }
+static inline vm_t vf_isnan(vf_t a) { return _mm_cmpunord_ps(a, a); }
+static inline vf_t vf_select(vm_t m, vf_t a, vf_t b) { return _mm_blendv_ps(b, a, m); }
+static inline vm_t vm_or(vm_t a, vm_t b) { return _mm_or_ps(a, b); }
+
+static inline vi_t vi_set1(int32_t x) { return _mm_set1_epi32(x); }
+static inline vi_t vi_add(vi_t a, vi_t b) { return _mm_add_epi32(a, b); }
+static inline vi_t vi_sub(vi_t a, vi_t b) { return _mm_sub_epi32(a, b); }
+static inline vi_t vi_and(vi_t a, vi_t b) { return _mm_and_si128(a, b); }
+static inline vi_t vi_xor(vi_t a, vi_t b) { return _mm_xor_si128(a, b); }
+static inline vm_t vi_test(vi_t a, int32_t bits) {
+    vi_t b = _mm_set1_epi32(bits);
+    return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(a, b), b));
 }
+static inline vi_t vi_from_vf(vf_t a) { return _mm_cvtps_epi32(a); }
+static inline vf_t vf_from_vi(vi_t a) { return _mm_cvtepi32_ps(a); }
+static inline vi_t vi_cast(vf_t a) { return _mm_castps_si128(a); }
+static inline vf_t vf_cast(vi_t a) { return _mm_castsi128_ps(a); }
+#define vi_slli(a, k) _mm_slli_epi32((a), (k))
+#define vi_srai(a, k) _mm_srai_epi32((a), (k))
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+#define VF_WIDTH 4
+typedef float32x4_t vf_t;
+typedef int32x4_t vi_t;
+typedef uint32x4_t vm_t;
+
+static inline vf_t vf_load(const float* p) { return vld1q_f32(p); }
+static inline void vf_store(float* p, vf_t v) { vst1q_f32(p, v); }
+static inline vf_t vf_set1(float x) { return vdupq_n_f32(x); }
+static inline vf_t vf_add(vf_t a, vf_t b) { return vaddq_f32(a, b); }
+static inline vf_t vf_sub(vf_t a, vf_t b) { return vsubq_f32(a, b); }
+static inline vf_t vf_mul(vf_t a, vf_t b) { return vmulq_f32(a, b); }
+static inline vf_t vf_div(vf_t a, vf_t b) { return vdivq_f32(a, b); }
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) { return vfmaq_f32(c, a, b); }
+static inline vf_t vf_min(vf_t a, vf_t b) { return vminq_f32(a, b); }
+static inline vf_t vf_max(vf_t a, vf_t b) { return vmaxq_f32(a, b); }
+static inline vf_t vf_sqrt(vf_t a) { return vsqrtq_f32(a); }
+static inline vf_t vf_rsqrt_estimate(vf_t a) { return vrsqrteq_f32(a); }
+static inline vf_t vf_round(vf_t a) { return vrndnq_f32(a); }
+static inline vm_t vf_lt(vf_t a, vf_t b) { return vcltq_f32(a, b); }
+static inline vm_t vf_eq(vf_t a, vf_t b) { return vceqq_f32(a, b); }
+static inline vm_t vf_isnan(vf_t a) { return vmvnq_u32(vceqq_f32(a, a)); }
+static inline vf_t vf_select(vm_t m, vf_t a, vf_t b) { return vbslq_f32(m, a, b); }
+static inline vm_t vm_or(vm_t a, vm_t b) { return vorrq_u32(a, b); }
+
+static inline vi_t vi_set1(int32_t x) { return vdupq_n_s32(x); }
+static inline vi_t vi_add(vi_t a, vi_t b) { return vaddq_s32(a, b); }
+static inline vi_t vi_sub(vi_t a, vi_t b) { return vsubq_s32(a, b); }
+static inline vi_t vi_and(vi_t a, vi_t b) { return vandq_s32(a, b); }
+static inline vi_t vi_xor(vi_t a, vi_t b) { return veorq_s32(a, b); }
+static inline vm_t vi_test(vi_t a, int32_t bits) { return vtstq_s32(a, vdupq_n_s32(bits)); }
+static inline vi_t vi_from_vf(vf_t a) { return vcvtnq_s32_f32(a); }
+static inline vf_t vf_from_vi(vi_t a) { return vcvtq_f32_s32(a); }
+static inline vi_t vi_cast(vf_t a) { return vreinterpretq_s32_f32(a); }
+static inline vf_t vf_cast(vi_t a) { return vreinterpretq_f32_s32(a); }
+#define vi_slli(a, k) vshlq_n_s32((a), (k))
+#define vi_srai(a, k) vshrq_n_s32((a), (k))
 
-// Векторные операции с SIMD
-void core_vector_sin(float* dst, const float* src, size_t n) {
-#if defined(__AVX2__)
-    size_t i = 0;
-    for (; i + 8 <= n; i += 8) {
-        __m256 x = _mm256_loadu_ps(&src[i]);
-        __m256 result;
-        for (int j = 0; j < 8; ++j) {
-            float val = _mm256_cvtss_f32(_mm256_permute_ps(x, j));
-            result = _mm256_insert_ps(result, _mm_set_ss(core_fast_sin(val)), j << 4);
-        }
-        _mm256_storeu_ps(&dst[i], result);
-    }
-    for (; i < n; ++i) {
-        dst[i] = core_fast_sin(src[i]);
-    }
-#elif defined(__ARM_NEON)
-    size_t i = 0;
-    for (; i + 4 <= n; i += 4) {
-        float32x4_t x = vld1q_f32(&src[i]);
-        float32x4_t result;
-        for (int j = 0; j < 4; ++j) {
-            result = vsetq_lane_f32(core_fast_sin(vgetq_lane_f32(x, j)), result, j);
-        }
-        vst1q_f32(&dst[i], result);
-    }
-    for (; i < n; ++i) {
-        dst[i] = core_fast_sin(src[i]);
-    }
 #else
-    for (size_t i = 0; i < n; ++i) {
-        dst[i] = core_fast_sin(src[i]);
-    }
-#endif
-}
 
-void core_vector_cos(float* dst, const float* src, size_t n) {
-#if defined(__AVX2__)
-    size_t i = 0;
-    for (; i + 8 <= n; i += 8) {
-        __m256 x = _mm256_loadu_ps(&src[i]);
-        __m256 result;
-        for (int j = 0; j < 8; ++j) {
-            float val = _mm256_cvtss_f32(_mm256_permute_ps(x, j));
-            result = _mm256_insert_ps(result, _mm_set_ss(core_fast_cos(val)), j << 4);
-        }
-        _mm256_storeu_ps(&dst[i], result);
-    }
-    for (; i < n; ++i) {
-        dst[i] = core_fast_cos(src[i]);
-    }
-#elif defined(__ARM_NEON)
-    size_t i = 0;
-    for (; i + 4 <= n; i += 4) {
-        float32x4_t x = vld1q_f32(&src[i]);
-        float32x4_t result;
-        for (int j = 0; j < 4; ++j) {
-            result = vsetq_lane_f32(core_fast_cos(vgetq_lane_f32(x, j)), result, j);
-        }
-        vst1q_f32(&dst[i], result);
-    }
-    for (; i < n; ++i) {
-        dst[i] = core_fast_cos(src[i]);
-    }
+#define VF_WIDTH 1
+typedef float vf_t;
+typedef int32_t vi_t;
+typedef int vm_t;
+
+static inline vf_t vf_load(const float* p) { return *p; }
+static inline void vf_store(float* p, vf_t v) { *p = v; }
+static inline vf_t vf_set1(float x) { return x; }
+static inline vf_t vf_add(vf_t a, vf_t b) { return a + b; }
+static inline vf_t vf_sub(vf_t a, vf_t b) { return a - b; }
+static inline vf_t vf_mul(vf_t a, vf_t b) { return a * b; }
+static inline vf_t vf_div(vf_t a, vf_t b) { return a / b; }
+#if defined(__FMA__) || defined(__ARM_FEATURE_FMA)
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) { return fmaf(a, b, c); }
 #else
-    for (size_t i = 0; i < n; ++i) {
-        dst[i] = core_fast_cos(src[i]);
-    }
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) { return a * b + c; }
 #endif
+static inline vf_t vf_min(vf_t a, vf_t b) { return a < b ? a : b; }
+static inline vf_t vf_max(vf_t a, vf_t b) { return a > b ? a : b; }
+static inline vf_t vf_sqrt(vf_t a) { return sqrtf(a); }
+static inline vf_t vf_rsqrt_estimate(vf_t a) { return 1.0f / sqrtf(a); }
+static inline vf_t vf_round(vf_t a) { return nearbyintf(a); }
+static inline vm_t vf_lt(vf_t a, vf_t b) { return a < b; }
+static inline vm_t vf_eq(vf_t a, vf_t b) { return a == b; }
+static inline vm_t vf_isnan(vf_t a) { return a != a; }
+static inline vf_t vf_select(vm_t m, vf_t a, vf_t b) { return m ? a : b; }
+static inline vm_t vm_or(vm_t a, vm_t b) { return a | b; }
+
+static inline vi_t vi_set1(int32_t x) { return x; }
+static inline vi_t vi_add(vi_t a, vi_t b) { return (vi_t)((uint32_t)a + (uint32_t)b); }
+static inline vi_t vi_sub(vi_t a, vi_t b) { return (vi_t)((uint32_t)a - (uint32_t)b); }
+static inline vi_t vi_and(vi_t a, vi_t b) { return a & b; }
+static inline vi_t vi_xor(vi_t a, vi_t b) { return a ^ b; }
+static inline vm_t vi_test(vi_t a, int32_t bits) { return (a & bits) == bits; }
+static inline vi_t vi_from_vf(vf_t a) {
+    return a > -2147483648.0f && a < 2147483648.0f ? (vi_t)a : INT32_MIN;
 }
+static inline vf_t vf_from_vi(vi_t a) { return (vf_t)a; }
+static inline vi_t vi_cast(vf_t a) { vi_t r; memcpy(&r, &a, sizeof(r)); return r; }
+static inline vf_t vf_cast(vi_t a) { vf_t r; memcpy(&r, &a, sizeof(r)); return r; }
+#define vi_slli(a, k) ((vi_t)((uint32_t)(a) << (k)))
+#define vi_srai(a, k) ((vi_t)((a) >> (k)))
 
-void core_vector_sqrt(float* dst, const float* src, size_t n) {
-#if defined(__AVX2__)
-    size_t i = 0;
-    for (; i + 8 <= n; i += 8) {
-        __m256 x = _mm256_loadu_ps(&src[i]);
-        __m256 result = _mm256_sqrt_ps(x);
-        _mm256_storeu_ps(&dst[i], result);
-    }
-    for (; i < n; ++i) {
-        dst[i] = core_fast_sqrt(src[i]);
-    }
-#elif defined(__ARM_NEON)
-    size_t i = 0;
-    for (; i + 4 <= n; i += 4) {
-        float32x4_t x = vld1q_f32(&src[i]);
-        float32x4_t result = vsqrtq_f32(x);
-        vst1q_f32(&dst[i], result);
-    }
-    for (; i < n; ++i) {
-        dst[i] = core_fast_sqrt(src[i]);
-    }
-#else
-    for (size_t i = 0; i < n; ++i) {
-        dst[i] = core_fast_sqrt(src[i]);
-    }
 #endif
+
+static inline vf_t vf_abs(vf_t a) { return vf_cast(vi_and(vi_cast(a), vi_set1(0x7FFFFFFF))); }
+static inline vi_t vi_sign(vf_t a) { return vi_and(vi_cast(a), vi_set1((int32_t)0x80000000u)); }
+
+// 2^n для целых n из [-126, 127]: показатель собирается прямо в битах
+static inline vf_t math_pow2i(vi_t n) { return vf_cast(vi_slli(vi_add(n, vi_set1(127)), 23)); }
+
+// sin/cos: редукция Коди–Уэйта x = q*pi/2 + r, |r| <= pi/4. pi/2 разбита на
+// четыре части; у первых трёх по 11 значащих бит, так что их произведения на q
+// точны при |q| < 2^13 (|x| <= 8192). Далее минимаксные полиномы Cephes для sin
+// и cos на [-pi/4, pi/4]; номер четверти выбирает полином (бит 0) и знак (бит 1).
+#define MATH_2_PI 0.636619772367581343f
+#define MATH_PIO2_1 1.5703125f
+#define MATH_PIO2_2 4.837512969970703125e-4f
+#define MATH_PIO2_3 7.5495336204767227172851562e-8f
+#define MATH_PIO2_4 2.5633440682570896029801588e-12f
+
+static inline vf_t math_sincos(vf_t x, int32_t quadrant_shift) {
+    vf_t q = vf_round(vf_mul(x, vf_set1(MATH_2_PI)));
+    vf_t r = vf_fma(q, vf_set1(-MATH_PIO2_1), x);
+    r = vf_fma(q, vf_set1(-MATH_PIO2_2), r);
+    r = vf_fma(q, vf_set1(-MATH_PIO2_3), r);
+    r = vf_fma(q, vf_set1(-MATH_PIO2_4), r);
+    vi_t quadrant = vi_add(vi_from_vf(q), vi_set1(quadrant_shift));
+
+    vf_t r2 = vf_mul(r, r);
+    vf_t ps = vf_fma(r2, vf_set1(-1.9515295891e-4f), vf_set1(8.3321608736e-3f));
+    ps = vf_fma(ps, r2, vf_set1(-1.6666654611e-1f));
+    vf_t s = vf_fma(vf_mul(r2, r), ps, r);
+    vf_t pc = vf_fma(r2, vf_set1(2.443315711809948e-5f), vf_set1(-1.388731625493765e-3f));
+    pc = vf_fma(pc, r2, vf_set1(4.166664568298827e-2f));
+    vf_t c = vf_fma(vf_mul(r2, r2), pc, vf_fma(r2, vf_set1(-0.5f), vf_set1(1.0f)));
+
+    vf_t result = vf_select(vi_test(quadrant, 1), c, s);
+    return vf_cast(vi_xor(vi_cast(result), vi_slli(vi_and(quadrant, vi_set1(2)), 30)));
 }
 
-void core_vector_rsqrt(float* dst, const float* src, size_t n) {
-#if defined(__AVX2__)
-    size_t i = 0;
-    for (; i + 8 <= n; i += 8) {
-        __m256 x = _mm256_loadu_ps(&src[i]);
-        __m256 result = _mm256_rsqrt_ps(x);
-        _mm256_storeu_ps(&dst[i], result);
-    }
-    for (; i < n; ++i) {
-        dst[i] = core_fast_rsqrt(src[i]);
-    }
-#elif defined(__ARM_NEON)
-    size_t i = 0;
-    for (; i + 4 <= n; i += 4) {
-        float32x4_t x = vld1q_f32(&src[i]);
-        float32x4_t result = vrsqrteq_f32(x);
-        vst1q_f32(&dst[i], result);
-    }
-    for (; i < n; ++i) {
-        dst[i] = core_fast_rsqrt(src[i]);
-    }
-#else
-    for (size_t i = 0; i < n; ++i) {
-        dst[i] = core_fast_rsqrt(src[i]);
-    }
-#endif
+static inline vf_t math_sin(vf_t x) { return math_sincos(x, 0); }
+static inline vf_t math_cos(vf_t x) { return math_sincos(x, 1); }
+
+// exp: x = n*ln2 + r, |r| <= ln2/2, полином Cephes степени 7 для e^r.
+// Масштаб 2^n применяется двумя множителями, чтобы n = 128 (переполнение в inf)
+// и n до -150 (денормализованные результаты) не выходили за поле показателя.
+#define MATH_EXP_HI 88.7228394f
+#define MATH_EXP_LO -104.0f
+
+static inline vf_t math_exp(vf_t x) {
+    vf_t xc = vf_min(vf_max(x, vf_set1(MATH_EXP_LO)), vf_set1(MATH_EXP_HI));
+    vf_t n = vf_round(vf_mul(xc, vf_set1(1.44269504088896341f)));
+    vf_t r = vf_fma(n, vf_set1(-0.693359375f), xc);
+    r = vf_fma(n, vf_set1(2.12194440e-4f), r);
+
+    vf_t p = vf_fma(r, vf_set1(1.9875691500e-4f), vf_set1(1.3981999507e-3f));
+    p = vf_fma(p, r, vf_set1(8.3334519073e-3f));
+    p = vf_fma(p, r, vf_set1(4.1665795894e-2f));
+    p = vf_fma(p, r, vf_set1(1.6666665459e-1f));
+    p = vf_fma(p, r, vf_set1(5.0000001201e-1f));
+    p = vf_fma(p, vf_mul(r, r), vf_add(r, vf_set1(1.0f)));
+
+    vi_t ni = vi_from_vf(n);
+    vi_t half = vi_srai(ni, 1);
+    vf_t result = vf_mul(vf_mul(p, math_pow2i(half)), math_pow2i(vi_sub(ni, half)));
+    return vf_select(vf_isnan(x), x, result);
+}
+
+// log: x = m * 2^e с m из [sqrt(1/2), sqrt(2)), log(m) = f - f^2/2 + f^3 P(f),
+// f = m - 1, полином Cephes. Денормализованные x предварительно умножаются на 2^23.
+static inline vf_t math_log(vf_t x) {
+    vm_t tiny = vf_lt(x, vf_set1(1.17549435e-38f));
+    vf_t xs = vf_select(tiny, vf_mul(x, vf_set1(8388608.0f)), x);
+    vf_t e = vf_select(tiny, vf_set1(-23.0f), vf_set1(0.0f));
+
+    vi_t bits = vi_cast(xs);
+    e = vf_add(e, vf_from_vi(vi_sub(vi_srai(bits, 23), vi_set1(126))));
+    vf_t m = vf_cast(vi_add(vi_and(bits, vi_set1(0x007FFFFF)), vi_set1(0x3F000000)));
+    vm_t low = vf_lt(m, vf_set1(0.707106781186547524f));
+    e = vf_sub(e, vf_select(low, vf_set1(1.0f), vf_set1(0.0f)));
+    vf_t f = vf_sub(vf_add(m, vf_select(low, m, vf_set1(0.0f))), vf_set1(1.0f));
+
+    vf_t z = vf_mul(f, f);
+    vf_t p = vf_fma(f, vf_set1(7.0376836292e-2f), vf_set1(-1.1514610310e-1f));
+    p = vf_fma(p, f, vf_set1(1.1676998740e-1f));
+    p = vf_fma(p, f, vf_set1(-1.2420140846e-1f));
+    p = vf_fma(p, f, vf_set1(1.4249322787e-1f));
+    p = vf_fma(p, f, vf_set1(-1.6668057665e-1f));
+    p = vf_fma(p, f, vf_set1(2.0000714765e-1f));
+    p = vf_fma(p, f, vf_set1(-2.4999993993e-1f));
+    p = vf_fma(p, f, vf_set1(3.3333331174e-1f));
+    vf_t y = vf_mul(vf_mul(f, z), p);
+    y = vf_fma(e, vf_set1(-2.12194440e-4f), y);
+    y = vf_fma(z, vf_set1(-0.5f), y);
+    vf_t result = vf_fma(e, vf_set1(0.693359375f), vf_add(f, y));
+
+    // log(0) = -inf, log(x < 0) = NaN, log(+inf) = +inf, NaN сохраняется
+    vf_t zero = vf_set1(0.0f), inf = vf_set1(INFINITY);
+    result = vf_select(vf_eq(x, inf), inf, result);
+    result = vf_select(vf_eq(x, zero), vf_set1(-INFINITY), result);
+    return vf_select(vm_or(vf_lt(x, zero), vf_isnan(x)), vf_set1(NAN), result);
+}
+
+// tanh: при |x| < 0.625 — нечётный полином Cephes, иначе (1 - e) / (1 + e) с
+// e = exp(-2|x|) <= 1, без переполнения; знак переносится с x.
+static inline vf_t math_tanh(vf_t x) {
+    vf_t ax = vf_abs(x);
+    vf_t e = math_exp(vf_mul(ax, vf_set1(-2.0f)));
+    vf_t large = vf_div(vf_sub(vf_set1(1.0f), e), vf_add(vf_set1(1.0f), e));
+    large = vf_cast(vi_xor(vi_cast(large), vi_sign(x)));
+
+    vf_t z = vf_mul(x, x);
+    vf_t p = vf_fma(z, vf_set1(-5.70498872745e-3f), vf_set1(2.06390887954e-2f));
+    p = vf_fma(p, z, vf_set1(-5.37397155531e-2f));
+    p = vf_fma(p, z, vf_set1(1.33314422036e-1f));
+    p = vf_fma(p, z, vf_set1(-3.33332819422e-1f));
+    vf_t small = vf_fma(vf_mul(p, z), x, x);
+    return vf_select(vf_lt(ax, vf_set1(0.625f)), small, large);
+}
+
+// sigmoid: e = exp(-|x|) <= 1; 1 / (1 + e) для x >= 0 и e / (1 + e) для x < 0 —
+// без переполнения и с сохранением относительной точности в левом хвосте.
+static inline vf_t math_sigmoid(vf_t x) {
+    vf_t e = math_exp(vf_sub(vf_set1(0.0f), vf_abs(x)));
+    vf_t num = vf_select(vf_lt(x, vf_set1(0.0f)), e, vf_set1(1.0f));
+    return vf_div(num, vf_add(vf_set1(1.0f), e));
 }
 
+// rsqrt: аппаратная оценка и один шаг Ньютона. Оценка SSE/AVX обнуляет
+// денормализованные x, поэтому они заранее умножаются на 2^24. Для 0, inf и
+// отрицательных x шаг даёт NaN, и остаётся оценка (inf, 0 и NaN соответственно).
+static inline vf_t math_rsqrt(vf_t x) {
+    vm_t tiny = vf_lt(x, vf_set1(1.17549435e-38f));
+    vf_t xs = vf_select(tiny, vf_mul(x, vf_set1(16777216.0f)), x);
+    vf_t y = vf_rsqrt_estimate(xs);
+    vf_t residual = vf_fma(vf_mul(xs, y), vf_sub(vf_set1(0.0f), y), vf_set1(1.0f));
+    vf_t refined = vf_fma(vf_mul(y, vf_set1(0.5f)), residual, y);
+    vf_t result = vf_select(vf_isnan(refined), y, refined);
+    return vf_mul(result, vf_select(tiny, vf_set1(4096.0f), vf_set1(1.0f)));
+}
+
+static inline float math_lane0(vf_t v) {
+    float lanes[VF_WIDTH];
+    vf_store(lanes, v);
+    return lanes[0];
+}
+
+// Основной цикл по полным векторам; хвост проходит через буфер на стеке
+#define MATH_DEFINE_VECTOR(name, kernel)                                  \
+    void name(float* dst, const float* src, size_t n) {                   \
+        size_t i = 0;                                                     \
+        for (; i + VF_WIDTH <= n; i += VF_WIDTH) {                        \
+            vf_store(dst + i, kernel(vf_load(src + i)));                  \
+        }                                                                 \
+        if (i < n) {                                                      \
+            float buf[VF_WIDTH] = {0};                                    \
+            memcpy(buf, src + i, (n - i) * sizeof(float));                \
+            vf_store(buf, kernel(vf_load(buf)));                          \
+            memcpy(dst + i, buf, (n - i) * sizeof(float));                \
+        }                                                                 \
+    }
+
+MATH_DEFINE_VECTOR(core_vector_sin, math_sin)
+MATH_DEFINE_VECTOR(core_vector_cos, math_cos)
+MATH_DEFINE_VECTOR(core_vector_sqrt, vf_sqrt)
+MATH_DEFINE_VECTOR(core_vector_rsqrt, math_rsqrt)
+MATH_DEFINE_VECTOR(core_vector_exp, math_exp)
+MATH_DEFINE_VECTOR(core_vector_log, math_log)
+MATH_DEFINE_VECTOR(core_vector_tanh, math_tanh)
+MATH_DEFINE_VECTOR(core_vector_sigmoid, math_sigmoid)
+
+// Скалярные варианты считают те же полиномы, что и векторные
+float core_fast_sin(float x) { return math_lane0(math_sin(vf_set1(x))); }
+float core_fast_cos(float x) { return math_lane0(math_cos(vf_set1(x))); }
+float core_fast_sqrt(float x) { return sqrtf(x); }
+float core_fast_rsqrt(float x) { return math_lane0(math_rsqrt(vf_set1(x))); }
+float core_fast_exp(float x) { return math_lane0(math_exp(vf_set1(x))); }
+float core_fast_log(float x) { return math_lane0(math_log(vf_set1(x))); }
+float core_fast_tanh(float x) { return math_lane0(math_tanh(vf_set1(x))); }
+float core_fast_sigmoid(float x) { return math_lane0(math_sigmoid(vf_set1(x))); }
+
 // Матричные операции
 void core_matrix_multiply_4x4(float* dst, const float* a, const float* b) {
-#if defined(__AVX2__)
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE4_2__)
+    // Строки b загружаются заранее, поэтому dst может совпадать с a или b
+    __m128 b0 = _mm_loadu_ps(&b[0]), b1 = _mm_loadu_ps(&b[4]);
+    __m128 b2 = _mm_loadu_ps(&b[8]), b3 = _mm_loadu_ps(&b[12]);
     for (int i = 0; i < 4; ++i) {
-        __m256 row = _mm256_loadu_ps(&a[i * 4]);
-        for (int j = 0; j < 4; ++j) {
-            __m256 col = _mm256_loadu_ps(&b[j * 4]);
-            __m256 prod = _mm256_mul_ps(row, col);
-            float sum = 0;
-            for (int k = 0; k < 4; ++k) {
-                sum += _mm256_cvtss_f32(_mm256_permute_ps(prod, k));
-            }
-            dst[i * 4 + j] = sum;
-        }
+        __m128 row = _mm_mul_ps(_mm_set1_ps(a[i * 4 + 0]), b0);
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 1]), b1));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 2]), b2));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 3]), b3));
+        _mm_storeu_ps(&dst[i * 4], row);
     }
-#elif defined(__ARM_NEON)
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    float32x4_t b0 = vld1q_f32(&b[0]), b1 = vld1q_f32(&b[4]);
+    float32x4_t b2 = vld1q_f32(&b[8]), b3 = vld1q_f32(&b[12]);
     for (int i = 0; i < 4; ++i) {
         float32x4_t row = vld1q_f32(&a[i * 4]);
-        for (int j = 0; j < 4; ++j) {
-            float32x4_t col = vld1q_f32(&b[j * 4]);
-            float32x4_t prod = vmulq_f32(row, col);
-            float sum = 0;
-            for (int k = 0; k < 4; ++k) {
-                sum += vgetq_lane_f32(prod, k);
-            }
-            dst[i * 4 + j] = sum;
-        }
+        float32x4_t acc = vmulq_laneq_f32(b0, row, 0);
+        acc = vfmaq_laneq_f32(acc, b1, row, 1);
+        acc = vfmaq_laneq_f32(acc, b2, row, 2);
+        acc = vfmaq_laneq_f32(acc, b3, row, 3);
+        vst1q_f32(&dst[i * 4], acc);
     }
 #else
+    float tmp[16];
     for (int i = 0; i < 4; ++i) {
         for (int j = 0; j < 4; ++j) {
             float sum = 0;
             for (int k = 0; k < 4; ++k) {
                 sum += a[i * 4 + k] * b[k * 4 + j];
             }
-            dst[i * 4 + j] = sum;
+            tmp[i * 4 + j] = sum;
         }
     }
+    memcpy(dst, tmp, sizeof(tmp));
 #endif
 }
 
 void core_matrix_transpose_4x4(float* dst, const float* src) {
-#if defined(__AVX2__)
-    __m256 row0 = _mm256_loadu_ps(&src[0]);
-    __m256 row1 = _mm256_loadu_ps(&src[4]);
-    __m256 row2 = _mm256_loadu_ps(&src[8]);
-    __m256 row3 = _mm256_loadu_ps(&src[12]);
-    
-    __m256 tmp0 = _mm256_unpacklo_ps(row0, row1);
-    __m256 tmp1 = _mm256_unpackhi_ps(row0, row1);
-    __m256 tmp2 = _mm256_unpacklo_ps(row2, row3);
-    __m256 tmp3 = _mm256_unpackhi_ps(row2, row3);
-    
-    row0 = _mm256_movelh_ps(tmp0, tmp2);
-    row1 = _mm256_movehl_ps(tmp2, tmp0);
-    row2 = _mm256_movelh_ps(tmp1, tmp3);
-    row3 = _mm256_movehl_ps(tmp3, tmp1);
-    
-    _mm256_storeu_ps(&dst[0], row0);
-    _mm256_storeu_ps(&dst[4], row1);
-    _mm256_storeu_ps(&dst[8], row2);
-    _mm256_storeu_ps(&dst[12], row3);
-#elif defined(__ARM_NEON)
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE4_2__)
+    __m128 row0 = _mm_loadu_ps(&src[0]);
+    __m128 row1 = _mm_loadu_ps(&src[4]);
+    __m128 row2 = _mm_loadu_ps(&src[8]);
+    __m128 row3 = _mm_loadu_ps(&src[12]);
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+    _mm_storeu_ps(&dst[0], row0);
+    _mm_storeu_ps(&dst[4], row1);
+    _mm_storeu_ps(&dst[8], row2);
+    _mm_storeu_ps(&dst[12], row3);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
     float32x4x4_t mat = vld4q_f32(src);
     vst1q_f32(&dst[0], mat.val[0]);
     vst1q_f32(&dst[4], mat.val[1]);
     vst1q_f32(&dst[8], mat.val[2]);
     vst1q_f32(&dst[12], mat.val[3]);
 #else
+    float tmp[16];
     for (int i = 0; i < 4; ++i) {
         for (int j = 0; j < 4; ++j) {
-            dst[i * 4 + j] = src[j * 4 + i];
+            tmp[i * 4 + j] = src[j * 4 + i];
         }
     }
+    memcpy(dst, tmp, sizeof(tmp));
 #endif
 }
 
@@ -291,4 +495,4 @@ int32_t core_fast_mod(int32_t a, int32_t b) {
     if (b == 8) return a & 7;
     if (b == 16) return a & 15;
     return a % b;
-} 
\ No newline at end of file
+}
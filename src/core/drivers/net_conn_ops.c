@@ -0,0 +1,425 @@
+#include "core/drivers/net_conn_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Соединение живёт, пока на него ссылаются пользователь (до
+// core_net_conn_close) и цикл (до on_close); отложенное дочитывание держит
+// свою ссылку. Завершение всегда откладывается в очередь цикла, даже из
+// самого цикла: on_close не может прийти посреди on_data, а память — уйти
+// из-под цикла чтения.
+//
+// Очередь отправки и флаги закрытия — под мьютексом соединения. Прямая
+// запись из send и дописывание очереди по готовности тоже идут под ним, так
+// что фронт готовности на запись не проскочит между частичной записью и
+// постановкой остатка в очередь. Чтение — только в потоке цикла и без
+// мьютекса; буфер чтения общий на вызов, на стеке, а не на соединение.
+
+#define NC_DEFAULT_HIGH_WATERMARK (1u << 20)
+#define NC_DEFAULT_READ_BUDGET (256u << 10)
+#define NC_READ_CHUNK (64u << 10)
+#define NC_MAX_IOV 64
+
+struct core_net_payload {
+    int refs;
+    size_t size;
+    char data[];
+};
+
+// Сегмент очереди: либо свой хвост данных (inline), либо ссылка на общий
+// неизменяемый буфер
+typedef struct nc_segment {
+    struct nc_segment* next;
+    const char* data;
+    size_t size;
+    size_t offset;   // уже отправлено
+    core_net_payload_t* payload;
+    char inline_data[];
+} nc_segment_t;
+
+struct core_net_conn {
+    core_event_loop_t* loop;
+    core_event_watch_t* watch;   // под mutex до завершения
+    int fd;
+    core_net_handlers_t handlers;
+    void* ctx;
+    size_t high_watermark;
+    size_t low_watermark;
+    size_t read_budget;
+    int refs;
+    pthread_mutex_t mutex;
+    nc_segment_t* head;
+    nc_segment_t* tail;
+    size_t queued;          // изменяется под mutex, читается без него
+    int want_drain;         // send отказал по high_watermark
+    int closing;            // close с flush: завершить, когда очередь опустеет
+    int read_closed;        // вторая сторона закрыла запись
+    int error;
+    int finalize_posted;    // изменяется под mutex, читается без него
+    int read_posted;        // только поток цикла
+    int finalized;          // только поток цикла
+};
+
+static void nc_unref(core_net_conn_t* conn) {
+    if (__atomic_sub_fetch(&conn->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        pthread_mutex_destroy(&conn->mutex);
+        free(conn);
+    }
+}
+
+static void nc_free_segment(nc_segment_t* seg) {
+    core_net_payload_release(seg->payload);
+    free(seg);
+}
+
+static void nc_free_segments(nc_segment_t* seg) {
+    while (seg) {
+        nc_segment_t* next = seg->next;
+        nc_free_segment(seg);
+        seg = next;
+    }
+}
+
+static void nc_finalize(void* ctx) {
+    core_net_conn_t* conn = (core_net_conn_t*)ctx;
+    pthread_mutex_lock(&conn->mutex);
+    core_event_watch_t* watch = conn->watch;
+    nc_segment_t* head = conn->head;
+    conn->head = conn->tail = NULL;
+    __atomic_store_n(&conn->queued, 0, __ATOMIC_RELAXED);
+    const int error = conn->error;
+    pthread_mutex_unlock(&conn->mutex);
+
+    conn->finalized = 1;
+    if (watch) {
+        core_event_loop_remove_fd(conn->loop, watch);
+    }
+    nc_free_segments(head);
+    if (conn->handlers.on_close) {
+        conn->handlers.on_close(conn->ctx, error);
+    }
+    nc_unref(conn);
+}
+
+// Под mutex. Первая причина закрытия побеждает.
+static void nc_request_finalize_locked(core_net_conn_t* conn, int error) {
+    if (conn->finalize_posted) {
+        return;
+    }
+    conn->error = error;
+    __atomic_store_n(&conn->finalize_posted, 1, __ATOMIC_RELEASE);
+    core_event_loop_post(conn->loop, nc_finalize, conn);
+}
+
+// Под mutex: дописывает очередь, пока сокет принимает. 0 или errno.
+static int nc_flush_locked(core_net_conn_t* conn) {
+    while (conn->head) {
+        struct iovec iov[NC_MAX_IOV];
+        int count = 0;
+        for (nc_segment_t* seg = conn->head; seg && count < NC_MAX_IOV; seg = seg->next) {
+            iov[count].iov_base = (void*)(seg->data + seg->offset);
+            iov[count].iov_len = seg->size - seg->offset;
+            ++count;
+        }
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t)count;
+        ssize_t n = sendmsg(conn->fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : errno;
+        }
+        size_t left = (size_t)n;
+        __atomic_store_n(&conn->queued, conn->queued - left, __ATOMIC_RELAXED);
+        while (left) {
+            nc_segment_t* seg = conn->head;
+            const size_t rest = seg->size - seg->offset;
+            if (left < rest) {
+                seg->offset += left;
+                break;
+            }
+            left -= rest;
+            conn->head = seg->next;
+            nc_free_segment(seg);
+        }
+        if (!conn->head) {
+            conn->tail = NULL;
+        }
+    }
+    return 0;
+}
+
+static void nc_read(core_net_conn_t* conn);
+
+static void nc_read_more(void* ctx) {
+    core_net_conn_t* conn = (core_net_conn_t*)ctx;
+    conn->read_posted = 0;
+    if (!conn->finalized) {
+        nc_read(conn);
+    }
+    nc_unref(conn);
+}
+
+static void nc_read(core_net_conn_t* conn) {
+    char buf[NC_READ_CHUNK];
+    size_t total = 0;
+    while (total < conn->read_budget) {
+        if (__atomic_load_n(&conn->finalize_posted, __ATOMIC_ACQUIRE)) {
+            return;
+        }
+        ssize_t n = recv(conn->fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            total += (size_t)n;
+            if (conn->handlers.on_data) {
+                conn->handlers.on_data(conn->ctx, buf, (size_t)n);
+            }
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        }
+        // Конец потока: недописанная очередь ещё уходит, завершение — после неё
+        const int error = n == 0 ? 0 : errno;
+        pthread_mutex_lock(&conn->mutex);
+        conn->read_closed = 1;
+        if (error || !conn->head) {
+            nc_request_finalize_locked(conn, error);
+        }
+        pthread_mutex_unlock(&conn->mutex);
+        return;
+    }
+    // Бюджет исчерпан, а данные ещё могут быть: нового фронта на них не
+    // придёт, поэтому чтение продолжается следующей итерацией цикла
+    if (!conn->read_posted) {
+        conn->read_posted = 1;
+        __atomic_add_fetch(&conn->refs, 1, __ATOMIC_RELAXED);
+        if (core_event_loop_post(conn->loop, nc_read_more, conn) != CORE_SUCCESS) {
+            conn->read_posted = 0;
+            nc_unref(conn);
+        }
+    }
+}
+
+static void nc_write(core_net_conn_t* conn) {
+    pthread_mutex_lock(&conn->mutex);
+    if (conn->finalize_posted) {
+        pthread_mutex_unlock(&conn->mutex);
+        return;
+    }
+    const int error = nc_flush_locked(conn);
+    if (error) {
+        nc_request_finalize_locked(conn, error);
+    } else if (!conn->head && (conn->closing || conn->read_closed)) {
+        nc_request_finalize_locked(conn, 0);
+    }
+    const int drain = conn->want_drain && !conn->finalize_posted && conn->queued <= conn->low_watermark;
+    if (drain) {
+        conn->want_drain = 0;
+    }
+    pthread_mutex_unlock(&conn->mutex);
+    if (drain && conn->handlers.on_drain) {
+        conn->handlers.on_drain(conn->ctx);
+    }
+}
+
+static void nc_on_event(void* ctx, uint32_t events) {
+    core_net_conn_t* conn = (core_net_conn_t*)ctx;
+    if (conn->finalized) {
+        return;
+    }
+    if (events & (CORE_EV_READ | CORE_EV_ERROR)) {
+        nc_read(conn);
+    }
+    if (events & (CORE_EV_WRITE | CORE_EV_ERROR)) {
+        nc_write(conn);
+    }
+}
+
+int core_net_conn_open(core_event_loop_t* loop, int fd, const core_net_conn_config_t* config,
+                       const core_net_handlers_t* handlers, void* ctx, core_net_conn_t** conn) {
+    if (!loop || fd < 0 || !handlers || !conn) {
+        return CORE_ERR_INVALID;
+    }
+    const int flags = fcntl(fd, F_GETFL);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        return CORE_ERR_INVALID;
+    }
+    core_net_conn_t* c = (core_net_conn_t*)calloc(1, sizeof(*c));
+    if (!c) {
+        return CORE_ERR_NOMEM;
+    }
+    c->loop = loop;
+    c->fd = fd;
+    c->handlers = *handlers;
+    c->ctx = ctx;
+    c->high_watermark = config && config->high_watermark ? config->high_watermark : NC_DEFAULT_HIGH_WATERMARK;
+    c->low_watermark = config && config->low_watermark ? config->low_watermark : c->high_watermark / 4;
+    if (c->low_watermark >= c->high_watermark) {
+        c->low_watermark = c->high_watermark - 1;
+    }
+    c->read_budget = config && config->read_budget ? config->read_budget : NC_DEFAULT_READ_BUDGET;
+    c->refs = 2;
+    pthread_mutex_init(&c->mutex, NULL);
+
+    // Событие может прийти раньше, чем add_fd вернёт подписку: завершение
+    // ждёт её под мьютексом
+    pthread_mutex_lock(&c->mutex);
+    int rc = core_event_loop_add_fd(loop, fd, nc_on_event, c, &c->watch);
+    pthread_mutex_unlock(&c->mutex);
+    if (rc != CORE_SUCCESS) {
+        pthread_mutex_destroy(&c->mutex);
+        free(c);
+        return rc;
+    }
+    *conn = c;
+    return CORE_SUCCESS;
+}
+
+// Общий путь отправки: прямо в сокет, остаток — в очередь. payload != NULL —
+// данные принадлежат ему, и остаток ставится в очередь ссылкой без копии.
+static int nc_send(core_net_conn_t* conn, const void* data, size_t size, core_net_payload_t* payload) {
+    pthread_mutex_lock(&conn->mutex);
+    if (conn->finalize_posted || conn->closing) {
+        pthread_mutex_unlock(&conn->mutex);
+        return CORE_ERR_NOTFOUND;
+    }
+    if (conn->queued >= conn->high_watermark) {
+        conn->want_drain = 1;
+        pthread_mutex_unlock(&conn->mutex);
+        return CORE_ERR_NOMEM;
+    }
+    const char* bytes = (const char*)data;
+    if (!conn->head) {
+        while (size) {
+            ssize_t n = send(conn->fd, bytes, size, MSG_NOSIGNAL);
+            if (n >= 0) {
+                bytes += n;
+                size -= (size_t)n;
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            nc_request_finalize_locked(conn, errno);
+            pthread_mutex_unlock(&conn->mutex);
+            return CORE_ERR_INTERNAL;
+        }
+        if (!size) {
+            pthread_mutex_unlock(&conn->mutex);
+            return CORE_SUCCESS;
+        }
+    }
+    nc_segment_t* seg = (nc_segment_t*)malloc(sizeof(*seg) + (payload ? 0 : size));
+    if (!seg) {
+        // Часть могла уже уйти в сокет; поток байтов нарушен
+        if (bytes != (const char*)data) {
+            nc_request_finalize_locked(conn, ENOMEM);
+        }
+        pthread_mutex_unlock(&conn->mutex);
+        return CORE_ERR_NOMEM;
+    }
+    seg->next = NULL;
+    seg->size = size;
+    seg->offset = 0;
+    seg->payload = payload;
+    if (payload) {
+        __atomic_add_fetch(&payload->refs, 1, __ATOMIC_RELAXED);
+        seg->data = bytes;
+    } else {
+        memcpy(seg->inline_data, bytes, size);
+        seg->data = seg->inline_data;
+    }
+    if (conn->tail) {
+        conn->tail->next = seg;
+    } else {
+        conn->head = seg;
+    }
+    conn->tail = seg;
+    __atomic_store_n(&conn->queued, conn->queued + size, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&conn->mutex);
+    return CORE_SUCCESS;
+}
+
+int core_net_conn_send(core_net_conn_t* conn, const void* data, size_t size) {
+    if (!conn || (!data && size)) {
+        return CORE_ERR_INVALID;
+    }
+    return nc_send(conn, data, size, NULL);
+}
+
+int core_net_payload_create(const void* data, size_t size, core_net_payload_t** payload) {
+    if ((!data && size) || !payload) {
+        return CORE_ERR_INVALID;
+    }
+    core_net_payload_t* p = (core_net_payload_t*)malloc(sizeof(*p) + size);
+    if (!p) {
+        return CORE_ERR_NOMEM;
+    }
+    p->refs = 1;
+    p->size = size;
+    if (size) {
+        memcpy(p->data, data, size);
+    }
+    *payload = p;
+    return CORE_SUCCESS;
+}
+
+void core_net_payload_retain(core_net_payload_t* payload) {
+    if (payload) {
+        __atomic_add_fetch(&payload->refs, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void core_net_payload_release(core_net_payload_t* payload) {
+    if (payload && __atomic_sub_fetch(&payload->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(payload);
+    }
+}
+
+const void* core_net_payload_data(const core_net_payload_t* payload) {
+    return payload ? payload->data : NULL;
+}
+
+size_t core_net_payload_size(const core_net_payload_t* payload) {
+    return payload ? payload->size : 0;
+}
+
+int core_net_conn_send_payload(core_net_conn_t* conn, core_net_payload_t* payload) {
+    if (!conn || !payload) {
+        return CORE_ERR_INVALID;
+    }
+    return nc_send(conn, payload->data, payload->size, payload);
+}
+
+size_t core_net_conn_queued(const core_net_conn_t* conn) {
+    return conn ? __atomic_load_n(&conn->queued, __ATOMIC_RELAXED) : 0;
+}
+
+void core_net_conn_close(core_net_conn_t* conn, int flush) {
+    if (!conn) {
+        return;
+    }
+    pthread_mutex_lock(&conn->mutex);
+    conn->closing = 1;
+    if (!flush || !conn->head) {
+        nc_request_finalize_locked(conn, 0);
+    }
+    pthread_mutex_unlock(&conn->mutex);
+    nc_unref(conn);
+}
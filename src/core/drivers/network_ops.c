@@ -1,3 +1,7 @@
+// struct mmsghdr, sendmmsg и recvmmsg
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
 #include "core/drivers/network_ops.h"
 #include "core/drivers/memory_ops.h"
 #include "core/drivers/thread_ops.h"
@@ -14,6 +18,12 @@
 #include <fcntl.h>
 #include <poll.h>
 #include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <netinet/udp.h>
+#include <linux/errqueue.h>
 #endif
 
 // Оптимизированные сетевые операции
@@ -93,6 +103,295 @@ ssize_t core_socket_recvfrom(int socket, void* buf, size_t len, int flags,
     return recvfrom(socket, (char*)buf, len, flags, src_addr, addrlen);
 }
 
+// Пакетный ввод-вывод датаграмм
+#if defined(__linux__)
+
+#define NET_CONTROL_SIZE CMSG_SPACE(sizeof(int))
+
+// Заголовки пачки: при отправке адрес берётся, только если задан, а
+// segment_size превращается в UDP_SEGMENT; при приёме под каждое сообщение
+// отводится место для адреса и UDP_GRO
+static void net_fill_batch(struct mmsghdr* hdrs, struct iovec* iov, char (*control)[NET_CONTROL_SIZE],
+                           core_dgram_t* msgs, size_t count, int sending) {
+    memset(hdrs, 0, count * sizeof(*hdrs));
+    for (size_t i = 0; i < count; ++i) {
+        struct msghdr* msg = &hdrs[i].msg_hdr;
+        iov[i].iov_base = msgs[i].buf;
+        iov[i].iov_len = msgs[i].len;
+        msg->msg_iov = &iov[i];
+        msg->msg_iovlen = 1;
+        if (!sending) {
+            msg->msg_name = &msgs[i].addr;
+            msg->msg_namelen = sizeof(msgs[i].addr);
+            msg->msg_control = control[i];
+            msg->msg_controllen = NET_CONTROL_SIZE;
+            continue;
+        }
+        if (msgs[i].addrlen) {
+            msg->msg_name = &msgs[i].addr;
+            msg->msg_namelen = msgs[i].addrlen;
+        }
+        if (msgs[i].segment_size) {
+            memset(control[i], 0, NET_CONTROL_SIZE);
+            msg->msg_control = control[i];
+            msg->msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(msg);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            memcpy(CMSG_DATA(cmsg), &msgs[i].segment_size, sizeof(uint16_t));
+        }
+    }
+}
+
+int core_socket_sendmmsg(int socket, core_dgram_t* msgs, size_t count, int flags) {
+    if (!msgs && count) {
+        errno = EINVAL;
+        return -1;
+    }
+    struct mmsghdr hdrs[CORE_SOCKET_BATCH_MAX];
+    struct iovec iov[CORE_SOCKET_BATCH_MAX];
+    char control[CORE_SOCKET_BATCH_MAX][NET_CONTROL_SIZE];
+    size_t sent = 0;
+    while (sent < count) {
+        size_t batch = count - sent < CORE_SOCKET_BATCH_MAX ? count - sent : CORE_SOCKET_BATCH_MAX;
+        net_fill_batch(hdrs, iov, control, msgs + sent, batch, 1);
+        int n = sendmmsg(socket, hdrs, (unsigned)batch, flags);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return sent ? (int)sent : -1;
+        }
+        sent += (size_t)n;
+        if ((size_t)n < batch) {
+            break;
+        }
+    }
+    return (int)sent;
+}
+
+int core_socket_recvmmsg(int socket, core_dgram_t* msgs, size_t count, int flags) {
+    if (!msgs && count) {
+        errno = EINVAL;
+        return -1;
+    }
+    struct mmsghdr hdrs[CORE_SOCKET_BATCH_MAX];
+    struct iovec iov[CORE_SOCKET_BATCH_MAX];
+    char control[CORE_SOCKET_BATCH_MAX][NET_CONTROL_SIZE];
+    size_t received = 0;
+    while (received < count) {
+        size_t batch = count - received < CORE_SOCKET_BATCH_MAX ? count - received : CORE_SOCKET_BATCH_MAX;
+        core_dgram_t* part = msgs + received;
+        net_fill_batch(hdrs, iov, control, part, batch, 0);
+        int n = recvmmsg(socket, hdrs, (unsigned)batch, received ? flags | MSG_DONTWAIT : flags, NULL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return received ? (int)received : -1;
+        }
+        for (int i = 0; i < n; ++i) {
+            struct msghdr* msg = &hdrs[i].msg_hdr;
+            part[i].received = hdrs[i].msg_len;
+            part[i].addrlen = msg->msg_namelen;
+            part[i].flags = msg->msg_flags;
+            part[i].segment_size = 0;
+            for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+                if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                    int gso_size;
+                    memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+                    part[i].segment_size = (uint16_t)gso_size;
+                }
+            }
+        }
+        received += (size_t)n;
+        if ((size_t)n < batch) {
+            break;
+        }
+    }
+    return (int)received;
+}
+
+int core_socket_gso_supported(int socket) {
+    int size = 0;
+    socklen_t len = sizeof(size);
+    return getsockopt(socket, SOL_UDP, UDP_SEGMENT, &size, &len) == 0 ? 0 : -1;
+}
+
+int core_socket_enable_gro(int socket) {
+    int on = 1;
+    return setsockopt(socket, SOL_UDP, UDP_GRO, &on, sizeof(on));
+}
+
+// Нулевая копия. Ядро нумерует успешные отправки с MSG_ZEROCOPY подряд с
+// нуля и сообщает о завершении диапазонами номеров, не обязательно по
+// порядку. Окно done над base отмечает завершённые; base сдвигается, пока
+// младший бит окна установлен.
+static void net_zc_advance(core_zerocopy_t* zc) {
+    const size_t words = CORE_ZEROCOPY_WINDOW / 64;
+    while (zc->done[0] == ~0ull) {
+        memmove(zc->done, zc->done + 1, (words - 1) * sizeof(uint64_t));
+        zc->done[words - 1] = 0;
+        zc->base += 64;
+    }
+    unsigned shift = (unsigned)__builtin_ctzll(~zc->done[0]);
+    if (shift == 0) {
+        return;
+    }
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t next = w + 1 < words ? zc->done[w + 1] : 0;
+        zc->done[w] = (zc->done[w] >> shift) | (next << (64 - shift));
+    }
+    zc->base += shift;
+}
+
+static void net_zc_mark(core_zerocopy_t* zc, uint32_t id) {
+    const uint32_t offset = id - zc->base;
+    if (offset >= CORE_ZEROCOPY_WINDOW) {
+        return;   // уже учтено
+    }
+    zc->done[offset / 64] |= 1ull << (offset % 64);
+}
+
+int core_zerocopy_init(core_zerocopy_t* zc, int socket) {
+    if (!zc) {
+        errno = EINVAL;
+        return -1;
+    }
+    memset(zc, 0, sizeof(*zc));
+    zc->socket = socket;
+    int on = 1;
+    return setsockopt(socket, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on));
+}
+
+ssize_t core_zerocopy_send(core_zerocopy_t* zc, const void* buf, size_t len, int flags, uint32_t* id) {
+    if (!zc || !id) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (len < CORE_ZEROCOPY_MIN) {
+        *id = zc->base - 1;
+        return send(zc->socket, buf, len, flags);
+    }
+    if (zc->next_id - zc->base >= CORE_ZEROCOPY_WINDOW) {
+        errno = ENOBUFS;
+        return -1;
+    }
+    // Номер расходуется только успешной отправкой
+    ssize_t n = send(zc->socket, buf, len, flags | MSG_ZEROCOPY);
+    if (n >= 0) {
+        *id = zc->next_id++;
+    }
+    return n;
+}
+
+int core_zerocopy_reap(core_zerocopy_t* zc) {
+    if (!zc) {
+        errno = EINVAL;
+        return -1;
+    }
+    int completed = 0;
+    for (;;) {
+        char control[CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))];
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(zc->socket, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return completed ? completed : -1;
+        }
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+                !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+                continue;
+            }
+            struct sock_extended_err err;
+            memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+            if (err.ee_errno != 0 || err.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+            // Данные всё-таки скопированы (например, получатель на этой же
+            // машине): нулевая копия для такого сокета не окупается
+            if (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                zc->copied++;
+            }
+            for (uint32_t id = err.ee_info;; ++id) {
+                net_zc_mark(zc, id);
+                completed++;
+                if (id == err.ee_data) {
+                    break;
+                }
+            }
+        }
+    }
+    net_zc_advance(zc);
+    return completed;
+}
+
+int core_zerocopy_done(const core_zerocopy_t* zc, uint32_t id) {
+    const uint32_t offset = id - zc->base;
+    if ((int32_t)offset < 0) {
+        return 1;
+    }
+    return offset < CORE_ZEROCOPY_WINDOW && (zc->done[offset / 64] >> (offset % 64)) & 1;
+}
+
+#else
+
+int core_socket_sendmmsg(int socket, core_dgram_t* msgs, size_t count, int flags) {
+    (void)socket; (void)msgs; (void)count; (void)flags;
+    errno = ENOSYS;
+    return -1;
+}
+
+int core_socket_recvmmsg(int socket, core_dgram_t* msgs, size_t count, int flags) {
+    (void)socket; (void)msgs; (void)count; (void)flags;
+    errno = ENOSYS;
+    return -1;
+}
+
+int core_socket_gso_supported(int socket) {
+    (void)socket;
+    return -1;
+}
+
+int core_socket_enable_gro(int socket) {
+    (void)socket;
+    return -1;
+}
+
+int core_zerocopy_init(core_zerocopy_t* zc, int socket) {
+    (void)zc; (void)socket;
+    errno = ENOSYS;
+    return -1;
+}
+
+ssize_t core_zerocopy_send(core_zerocopy_t* zc, const void* buf, size_t len, int flags, uint32_t* id) {
+    (void)zc; (void)buf; (void)len; (void)flags; (void)id;
+    errno = ENOSYS;
+    return -1;
+}
+
+int core_zerocopy_reap(core_zerocopy_t* zc) {
+    (void)zc;
+    errno = ENOSYS;
+    return -1;
+}
+
+int core_zerocopy_done(const core_zerocopy_t* zc, uint32_t id) {
+    (void)zc; (void)id;
+    return 1;
+}
+
+#endif
+
 // Операции с буферами
 int core_socket_set_buffer_size(int socket, int rcvbuf, int sndbuf) {
     int ret = 0;
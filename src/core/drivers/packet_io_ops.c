@@ -0,0 +1,781 @@
+#include "core/drivers/packet_io_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <linux/bpf.h>
+#include <linux/if_ether.h>
+#include <linux/if_link.h>
+#include <linux/if_packet.h>
+#include <linux/if_xdp.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+#define PIO_FRAME_SIZE 2048
+#define PIO_FRAME_COUNT 4096
+#define PIO_BLOCK_SIZE (64u << 10)    // блок TPACKET_V3: мелкие блоки — меньше простоя по таймауту
+#define PIO_BLOCK_TIMEOUT_MS 1        // неполный блок отдаётся не позже
+#define PIO_BIND_RETRIES 100          // по 1 мс, пока очередь занята закрытым сокетом
+
+// Кольцо AF_XDP. Производитель и потребитель — общие с ядром счётчики:
+// свой пишем только мы, чужой читаем с acquire, свой публикуем с release.
+typedef struct {
+    uint32_t* producer;
+    uint32_t* consumer;
+    void* descs;
+    uint32_t mask;
+    uint32_t size;
+    void* map;
+    size_t map_len;
+} pio_ring_t;
+
+struct core_packet_io {
+    int backend;
+    int fd;
+    int membership_fd;   // держит неразборчивый режим, -1 — не нужен
+    int ifindex;
+    int zero_copy;
+    uint32_t frame_size;
+    uint32_t frame_count;
+
+    // AF_XDP: первая половина UMEM — кадры приёма (в fill, rx или у
+    // пользователя), вторая — кадры отправки (свободны, в tx или completion)
+    uint8_t* umem;
+    size_t umem_len;
+    pio_ring_t fill;
+    pio_ring_t comp;
+    pio_ring_t rx;
+    pio_ring_t tx;
+    uint64_t* held;        // кадры прошлой пачки, ещё не возвращённые в fill
+    size_t held_count;
+    uint64_t* tx_free;
+    size_t tx_free_count;
+    int map_fd;
+    int prog_fd;
+    int link_fd;           // закрытие снимает программу с интерфейса
+
+    // AF_PACKET: блоки кольца отдаются ядру целиком, поэтому дочитанные
+    // держатся до следующей пачки, как кадры AF_XDP
+    uint8_t* ring;
+    size_t ring_len;
+    uint32_t block_size;
+    uint32_t block_count;
+    uint32_t block;          // читаемый блок
+    uint32_t block_left;     // непрочитанных пакетов в нём
+    uint8_t* next_pkt;
+    uint32_t release_block;  // первый дочитанный и ещё не возвращённый блок
+    uint32_t release_count;
+
+    // Пишутся потоками приёма и отправки, читаются из любого
+    uint64_t rx_packets;
+    uint64_t rx_bytes;
+    uint64_t rx_dropped;
+    uint64_t tx_packets;
+};
+
+static uint32_t pio_round_pow2(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+static int pio_bpf(int cmd, union bpf_attr* attr) {
+    return (int)syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+// Ошибки, означающие «механизм здесь недоступен», а не сбой
+static int pio_unsupported(int error) {
+    return error == EPERM || error == EACCES || error == EAFNOSUPPORT || error == EPROTONOSUPPORT ||
+           error == EOPNOTSUPP || error == ENOSYS || error == EINVAL || error == EBUSY ||
+           error == EEXIST;
+}
+
+static int pio_membership(core_packet_io_t* io) {
+    struct packet_mreq mreq;
+    io->membership_fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if (io->membership_fd < 0) {
+        return pio_unsupported(errno) ? CORE_ERR_UNSUPPORTED : CORE_ERR_INTERNAL;
+    }
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.mr_ifindex = io->ifindex;
+    mreq.mr_type = PACKET_MR_PROMISC;
+    if (setsockopt(io->membership_fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+        return CORE_ERR_INTERNAL;
+    }
+    return CORE_SUCCESS;
+}
+
+// --- AF_XDP ---
+
+static void xsk_unmap_ring(pio_ring_t* ring) {
+    if (ring->map) {
+        munmap(ring->map, ring->map_len);
+    }
+    memset(ring, 0, sizeof(*ring));
+}
+
+static int xsk_map_ring(int fd, pio_ring_t* ring, const struct xdp_ring_offset* off, uint32_t size,
+                        size_t desc_size, off_t pgoff) {
+    uint8_t* base;
+    ring->map_len = off->desc + size * desc_size;
+    ring->map = mmap(NULL, ring->map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, pgoff);
+    if (ring->map == MAP_FAILED) {
+        ring->map = NULL;
+        return -1;
+    }
+    base = (uint8_t*)ring->map;
+    ring->producer = (uint32_t*)(base + off->producer);
+    ring->consumer = (uint32_t*)(base + off->consumer);
+    ring->descs = base + off->desc;
+    ring->mask = size - 1;
+    ring->size = size;
+    return 0;
+}
+
+static void xsk_close_socket(core_packet_io_t* io) {
+    xsk_unmap_ring(&io->rx);
+    xsk_unmap_ring(&io->tx);
+    xsk_unmap_ring(&io->fill);
+    xsk_unmap_ring(&io->comp);
+    if (io->fd >= 0) {
+        close(io->fd);
+        io->fd = -1;
+    }
+}
+
+// Сокет с UMEM и четырьмя кольцами, привязанный к очереди. errno при неудаче.
+static int xsk_open_socket(core_packet_io_t* io, uint32_t queue_id, uint16_t bind_flags) {
+    struct xdp_umem_reg reg;
+    struct xdp_mmap_offsets off;
+    struct sockaddr_xdp addr;
+    socklen_t optlen = sizeof(off);
+    uint32_t half = io->frame_count / 2;
+    uint32_t i;
+    int attempt;
+    int error;
+
+    io->fd = socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if (io->fd < 0) {
+        return errno;
+    }
+    memset(&reg, 0, sizeof(reg));
+    reg.addr = (uintptr_t)io->umem;
+    reg.len = io->umem_len;
+    reg.chunk_size = io->frame_size;
+    if (setsockopt(io->fd, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) != 0 ||
+        setsockopt(io->fd, SOL_XDP, XDP_UMEM_FILL_RING, &half, sizeof(half)) != 0 ||
+        setsockopt(io->fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &half, sizeof(half)) != 0 ||
+        setsockopt(io->fd, SOL_XDP, XDP_RX_RING, &half, sizeof(half)) != 0 ||
+        setsockopt(io->fd, SOL_XDP, XDP_TX_RING, &half, sizeof(half)) != 0 ||
+        getsockopt(io->fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen) != 0) {
+        goto fail;
+    }
+    if (xsk_map_ring(io->fd, &io->rx, &off.rx, half, sizeof(struct xdp_desc), XDP_PGOFF_RX_RING) != 0 ||
+        xsk_map_ring(io->fd, &io->tx, &off.tx, half, sizeof(struct xdp_desc), XDP_PGOFF_TX_RING) != 0 ||
+        xsk_map_ring(io->fd, &io->fill, &off.fr, half, sizeof(uint64_t), XDP_UMEM_PGOFF_FILL_RING) != 0 ||
+        xsk_map_ring(io->fd, &io->comp, &off.cr, half, sizeof(uint64_t), XDP_UMEM_PGOFF_COMPLETION_RING) != 0) {
+        goto fail;
+    }
+
+    // Все кадры приёма — ядру до привязки, чтобы первые пакеты было куда класть
+    for (i = 0; i < half; ++i) {
+        ((uint64_t*)io->fill.descs)[i] = (uint64_t)i * io->frame_size;
+    }
+    __atomic_store_n(io->fill.producer, half, __ATOMIC_RELEASE);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sxdp_family = AF_XDP;
+    addr.sxdp_ifindex = (uint32_t)io->ifindex;
+    addr.sxdp_queue_id = queue_id;
+    addr.sxdp_flags = bind_flags;
+    // Ядро освобождает очередь от закрытого сокета отложенно: EBUSY сразу
+    // после закрытия прежнего сокета проходит за несколько миллисекунд
+    for (attempt = 0; bind(io->fd, (struct sockaddr*)&addr, sizeof(addr)) != 0; ++attempt) {
+        if (errno != EBUSY || attempt == PIO_BIND_RETRIES) {
+            goto fail;
+        }
+        usleep(1000);
+    }
+    return 0;
+
+fail:
+    error = errno;
+    xsk_close_socket(io);
+    return error;
+}
+
+// XDP-программа: кадры очереди, для которой в карте есть сокет, уходят в
+// него, остальные — в обычный стек ядра. Собирается вручную, без libbpf:
+//   r2 = ctx->rx_queue_index
+//   r1 = &xsks_map
+//   r3 = XDP_PASS            (действие, если сокета для очереди нет)
+//   return bpf_redirect_map(r1, r2, r3)
+static int xsk_attach_program(core_packet_io_t* io, uint32_t queue_id) {
+    static const char license[] = "Dual MIT/GPL";
+    struct bpf_insn prog[6];
+    union bpf_attr attr;
+    uint32_t key = queue_id;
+    int value;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size = sizeof(uint32_t);
+    attr.value_size = sizeof(int);
+    attr.max_entries = queue_id + 1;
+    io->map_fd = pio_bpf(BPF_MAP_CREATE, &attr);
+    if (io->map_fd < 0) {
+        return errno;
+    }
+
+    memset(prog, 0, sizeof(prog));
+    prog[0].code = BPF_LDX | BPF_MEM | BPF_W;
+    prog[0].dst_reg = BPF_REG_2;
+    prog[0].src_reg = BPF_REG_1;
+    prog[0].off = offsetof(struct xdp_md, rx_queue_index);
+    prog[1].code = BPF_LD | BPF_DW | BPF_IMM;   // 64-битная загрузка — две инструкции
+    prog[1].dst_reg = BPF_REG_1;
+    prog[1].src_reg = BPF_PSEUDO_MAP_FD;
+    prog[1].imm = io->map_fd;
+    prog[3].code = BPF_ALU64 | BPF_MOV | BPF_K;
+    prog[3].dst_reg = BPF_REG_3;
+    prog[3].imm = XDP_PASS;
+    prog[4].code = BPF_JMP | BPF_CALL;
+    prog[4].imm = BPF_FUNC_redirect_map;
+    prog[5].code = BPF_JMP | BPF_EXIT;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.insns = (uintptr_t)prog;
+    attr.insn_cnt = sizeof(prog) / sizeof(prog[0]);
+    attr.license = (uintptr_t)license;
+    attr.expected_attach_type = BPF_XDP;
+    io->prog_fd = pio_bpf(BPF_PROG_LOAD, &attr);
+    if (io->prog_fd < 0) {
+        return errno;
+    }
+
+    // Сначала в режиме драйвера; интерфейсы без XDP в драйвере — общий режим
+    memset(&attr, 0, sizeof(attr));
+    attr.link_create.prog_fd = (uint32_t)io->prog_fd;
+    attr.link_create.target_ifindex = (uint32_t)io->ifindex;
+    attr.link_create.attach_type = BPF_XDP;
+    attr.link_create.flags = XDP_FLAGS_DRV_MODE;
+    io->link_fd = pio_bpf(BPF_LINK_CREATE, &attr);
+    if (io->link_fd < 0 && !io->zero_copy) {
+        attr.link_create.flags = XDP_FLAGS_SKB_MODE;
+        io->link_fd = pio_bpf(BPF_LINK_CREATE, &attr);
+    }
+    if (io->link_fd < 0) {
+        return errno;
+    }
+
+    memset(&attr, 0, sizeof(attr));
+    value = io->fd;
+    attr.map_fd = (uint32_t)io->map_fd;
+    attr.key = (uintptr_t)&key;
+    attr.value = (uintptr_t)&value;
+    attr.flags = BPF_ANY;
+    if (pio_bpf(BPF_MAP_UPDATE_ELEM, &attr) != 0) {
+        return errno;
+    }
+    return 0;
+}
+
+static void xsk_close(core_packet_io_t* io) {
+    if (io->link_fd >= 0) {
+        close(io->link_fd);
+    }
+    if (io->prog_fd >= 0) {
+        close(io->prog_fd);
+    }
+    if (io->map_fd >= 0) {
+        close(io->map_fd);
+    }
+    xsk_close_socket(io);
+    if (io->umem) {
+        munmap(io->umem, io->umem_len);
+    }
+    free(io->held);
+    free(io->tx_free);
+}
+
+static int xsk_open(core_packet_io_t* io, const core_packet_io_config_t* config) {
+    uint32_t half;
+    uint32_t i;
+    int error;
+
+    if (io->frame_size != 2048 && io->frame_size != 4096) {
+        return CORE_ERR_INVALID;
+    }
+    io->frame_count = pio_round_pow2(io->frame_count < 64 ? 64 : io->frame_count);
+    half = io->frame_count / 2;
+    io->umem_len = (size_t)io->frame_size * io->frame_count;
+    io->umem = (uint8_t*)mmap(NULL, io->umem_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (io->umem == MAP_FAILED) {
+        io->umem = NULL;
+        return CORE_ERR_NOMEM;
+    }
+    io->held = (uint64_t*)malloc(half * sizeof(uint64_t));
+    io->tx_free = (uint64_t*)malloc(half * sizeof(uint64_t));
+    if (!io->held || !io->tx_free) {
+        return CORE_ERR_NOMEM;
+    }
+    for (i = 0; i < half; ++i) {
+        io->tx_free[i] = (uint64_t)(half + i) * io->frame_size;
+    }
+    io->tx_free_count = half;
+
+    // Без копирования — только если драйвер умеет; иначе ядро копирует кадр в UMEM
+    error = EOPNOTSUPP;
+    if (!config->copy_mode) {
+        error = xsk_open_socket(io, config->queue_id, XDP_ZEROCOPY);
+        io->zero_copy = error == 0;
+    }
+    if (error != 0) {
+        error = xsk_open_socket(io, config->queue_id, XDP_COPY);
+    }
+    if (error != 0) {
+        return error == ENODEV || error == ENXIO ? CORE_ERR_NOTFOUND
+             : pio_unsupported(error)            ? CORE_ERR_UNSUPPORTED
+                                                  : CORE_ERR_INTERNAL;
+    }
+    error = xsk_attach_program(io, config->queue_id);
+    if (error != 0) {
+        return pio_unsupported(error) ? CORE_ERR_UNSUPPORTED : CORE_ERR_INTERNAL;
+    }
+    return CORE_SUCCESS;
+}
+
+static size_t xsk_rx_burst(core_packet_io_t* io, core_packet_t* pkts, size_t max) {
+    const struct xdp_desc* descs = (const struct xdp_desc*)io->rx.descs;
+    uint64_t* fill = (uint64_t*)io->fill.descs;
+    const uint64_t frame_mask = ~(uint64_t)(io->frame_size - 1);
+    uint32_t cons;
+    uint32_t prod;
+    size_t bytes = 0;
+    size_t n;
+    size_t i;
+
+    // Кадры прошлой пачки — обратно ядру. Место в fill есть всегда: кадров
+    // приёма столько же, сколько его ячеек.
+    if (io->held_count) {
+        prod = *io->fill.producer;
+        for (i = 0; i < io->held_count; ++i) {
+            fill[(prod + i) & io->fill.mask] = io->held[i];
+        }
+        __atomic_store_n(io->fill.producer, prod + (uint32_t)io->held_count, __ATOMIC_RELEASE);
+        io->held_count = 0;
+    }
+
+    cons = *io->rx.consumer;
+    n = __atomic_load_n(io->rx.producer, __ATOMIC_ACQUIRE) - cons;
+    if (n > max) {
+        n = max;
+    }
+    for (i = 0; i < n; ++i) {
+        const struct xdp_desc* desc = &descs[(cons + i) & io->rx.mask];
+        pkts[i].data = io->umem + desc->addr;
+        pkts[i].len = desc->len;
+        io->held[i] = desc->addr & frame_mask;
+        bytes += desc->len;
+    }
+    io->held_count = n;
+    __atomic_store_n(io->rx.consumer, cons + (uint32_t)n, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&io->rx_packets, n, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&io->rx_bytes, bytes, __ATOMIC_RELAXED);
+    return n;
+}
+
+static int xsk_send(core_packet_io_t* io, const void* frame, size_t len) {
+    const uint64_t* comp = (const uint64_t*)io->comp.descs;
+    struct xdp_desc* tx = (struct xdp_desc*)io->tx.descs;
+    uint32_t cons = *io->comp.consumer;
+    uint32_t done = __atomic_load_n(io->comp.producer, __ATOMIC_ACQUIRE) - cons;
+    uint32_t prod;
+    uint64_t addr;
+    uint32_t i;
+
+    if (len > io->frame_size) {
+        return CORE_ERR_INVALID;
+    }
+    // Отправленные ядром кадры снова свободны
+    for (i = 0; i < done; ++i) {
+        io->tx_free[io->tx_free_count++] = comp[(cons + i) & io->comp.mask];
+    }
+    __atomic_store_n(io->comp.consumer, cons + done, __ATOMIC_RELEASE);
+    if (!io->tx_free_count) {
+        sendto(io->fd, NULL, 0, MSG_DONTWAIT, NULL, 0);
+        return CORE_ERR_NOMEM;
+    }
+
+    addr = io->tx_free[--io->tx_free_count];
+    memcpy(io->umem + addr, frame, len);
+    prod = *io->tx.producer;
+    tx[prod & io->tx.mask].addr = addr;
+    tx[prod & io->tx.mask].len = (uint32_t)len;
+    tx[prod & io->tx.mask].options = 0;
+    __atomic_store_n(io->tx.producer, prod + 1, __ATOMIC_RELEASE);
+
+    // Кольцо отправки ядро разбирает только по системному вызову
+    if (sendto(io->fd, NULL, 0, MSG_DONTWAIT, NULL, 0) < 0 && errno != EAGAIN && errno != EBUSY &&
+        errno != ENOBUFS) {
+        return CORE_ERR_INTERNAL;
+    }
+    __atomic_fetch_add(&io->tx_packets, 1, __ATOMIC_RELAXED);
+    return CORE_SUCCESS;
+}
+
+static uint64_t xsk_dropped(core_packet_io_t* io) {
+    struct xdp_statistics stats;
+    socklen_t optlen = sizeof(stats);
+    memset(&stats, 0, sizeof(stats));
+    if (getsockopt(io->fd, SOL_XDP, XDP_STATISTICS, &stats, &optlen) != 0) {
+        return 0;
+    }
+    // Счётчики ядра накопительные
+    return stats.rx_dropped + stats.rx_ring_full + stats.rx_fill_ring_empty_descs;
+}
+
+// --- AF_PACKET / TPACKET_V3 ---
+
+static int tpacket_open(core_packet_io_t* io) {
+    struct tpacket_req3 req;
+    struct sockaddr_ll addr;
+    int version = TPACKET_V3;
+    size_t total;
+
+    if (io->frame_size < TPACKET3_HDRLEN || io->frame_size % TPACKET_ALIGNMENT != 0 ||
+        io->frame_size > PIO_BLOCK_SIZE) {
+        return CORE_ERR_INVALID;
+    }
+    total = (size_t)io->frame_size * io->frame_count;
+    io->block_size = PIO_BLOCK_SIZE;
+    io->block_count = (uint32_t)(total / PIO_BLOCK_SIZE);
+    if (io->block_count < 2) {
+        io->block_count = 2;
+    }
+
+    // Протокол 0: пока кольцо не готово и сокет не привязан, он ничего не принимает
+    io->fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if (io->fd < 0) {
+        return pio_unsupported(errno) ? CORE_ERR_UNSUPPORTED : CORE_ERR_INTERNAL;
+    }
+    if (setsockopt(io->fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) {
+        return CORE_ERR_UNSUPPORTED;
+    }
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = io->block_size;
+    req.tp_block_nr = io->block_count;
+    req.tp_frame_size = io->frame_size;
+    req.tp_frame_nr = io->block_size / io->frame_size * io->block_count;
+    req.tp_retire_blk_tov = PIO_BLOCK_TIMEOUT_MS;
+    if (setsockopt(io->fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) != 0) {
+        return errno == ENOMEM ? CORE_ERR_NOMEM : CORE_ERR_INTERNAL;
+    }
+    io->ring_len = (size_t)io->block_size * io->block_count;
+    io->ring = (uint8_t*)mmap(NULL, io->ring_len, PROT_READ | PROT_WRITE, MAP_SHARED, io->fd, 0);
+    if (io->ring == MAP_FAILED) {
+        io->ring = NULL;
+        return CORE_ERR_NOMEM;
+    }
+#ifdef PACKET_IGNORE_OUTGOING
+    {
+        // Свои отправленные кадры не нужны
+        int ignore = 1;
+        setsockopt(io->fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &ignore, sizeof(ignore));
+    }
+#endif
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_ALL);
+    addr.sll_ifindex = io->ifindex;
+    if (bind(io->fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        return errno == ENODEV ? CORE_ERR_NOTFOUND : CORE_ERR_INTERNAL;
+    }
+    return CORE_SUCCESS;
+}
+
+static void tpacket_close(core_packet_io_t* io) {
+    if (io->ring) {
+        munmap(io->ring, io->ring_len);
+    }
+    if (io->fd >= 0) {
+        close(io->fd);
+    }
+}
+
+static struct tpacket_block_desc* tpacket_block(core_packet_io_t* io, uint32_t index) {
+    return (struct tpacket_block_desc*)(io->ring + (size_t)index * io->block_size);
+}
+
+static size_t tpacket_rx_burst(core_packet_io_t* io, core_packet_t* pkts, size_t max) {
+    size_t bytes = 0;
+    size_t n = 0;
+
+    // Блоки, дочитанные прошлым вызовом, — обратно ядру
+    for (; io->release_count; --io->release_count) {
+        __atomic_store_n(&tpacket_block(io, io->release_block)->hdr.bh1.block_status, TP_STATUS_KERNEL,
+                         __ATOMIC_RELEASE);
+        io->release_block = (io->release_block + 1) % io->block_count;
+    }
+
+    while (n < max) {
+        const struct tpacket3_hdr* hdr;
+        if (!io->block_left) {
+            struct tpacket_block_desc* desc = tpacket_block(io, io->block);
+            if (!(__atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+                break;
+            }
+            io->block_left = desc->hdr.bh1.num_pkts;
+            io->next_pkt = (uint8_t*)desc + desc->hdr.bh1.offset_to_first_pkt;
+            if (!io->block_left) {
+                io->release_count++;
+                io->block = (io->block + 1) % io->block_count;
+                continue;
+            }
+        }
+        hdr = (const struct tpacket3_hdr*)io->next_pkt;
+        pkts[n].data = io->next_pkt + hdr->tp_mac;
+        pkts[n].len = hdr->tp_snaplen;
+        bytes += hdr->tp_snaplen;
+        ++n;
+        io->next_pkt += hdr->tp_next_offset;
+        if (--io->block_left == 0) {
+            io->release_count++;
+            io->block = (io->block + 1) % io->block_count;
+        }
+    }
+    __atomic_fetch_add(&io->rx_packets, n, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&io->rx_bytes, bytes, __ATOMIC_RELAXED);
+    return n;
+}
+
+static int tpacket_send(core_packet_io_t* io, const void* frame, size_t len) {
+    if (send(io->fd, frame, len, MSG_DONTWAIT) < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+            return CORE_ERR_NOMEM;
+        }
+        return errno == EMSGSIZE ? CORE_ERR_INVALID : CORE_ERR_INTERNAL;
+    }
+    __atomic_fetch_add(&io->tx_packets, 1, __ATOMIC_RELAXED);
+    return CORE_SUCCESS;
+}
+
+static uint64_t tpacket_dropped(core_packet_io_t* io) {
+    struct tpacket_stats_v3 stats;
+    socklen_t optlen = sizeof(stats);
+    memset(&stats, 0, sizeof(stats));
+    if (getsockopt(io->fd, SOL_PACKET, PACKET_STATISTICS, &stats, &optlen) != 0) {
+        return __atomic_load_n(&io->rx_dropped, __ATOMIC_RELAXED);
+    }
+    // Ядро обнуляет счётчики при каждом чтении
+    return __atomic_add_fetch(&io->rx_dropped, stats.tp_drops, __ATOMIC_RELAXED);
+}
+
+// --- Общий интерфейс ---
+
+static core_packet_io_t* pio_alloc(int ifindex, const core_packet_io_config_t* config) {
+    core_packet_io_t* io = (core_packet_io_t*)calloc(1, sizeof(core_packet_io_t));
+    if (!io) {
+        return NULL;
+    }
+    io->fd = -1;
+    io->membership_fd = -1;
+    io->map_fd = -1;
+    io->prog_fd = -1;
+    io->link_fd = -1;
+    io->ifindex = ifindex;
+    io->frame_size = config->frame_size ? config->frame_size : PIO_FRAME_SIZE;
+    io->frame_count = config->frame_count ? config->frame_count : PIO_FRAME_COUNT;
+    return io;
+}
+
+static void pio_free(core_packet_io_t* io) {
+    if (io->backend == CORE_PACKET_IO_AF_XDP) {
+        xsk_close(io);
+    } else {
+        tpacket_close(io);
+    }
+    if (io->membership_fd >= 0) {
+        close(io->membership_fd);
+    }
+    free(io);
+}
+
+static int pio_open_backend(int ifindex, int backend, const core_packet_io_config_t* config,
+                            core_packet_io_t** out) {
+    core_packet_io_t* io = pio_alloc(ifindex, config);
+    int result;
+    if (!io) {
+        return CORE_ERR_NOMEM;
+    }
+    io->backend = backend;
+    result = backend == CORE_PACKET_IO_AF_XDP ? xsk_open(io, config) : tpacket_open(io);
+    if (result == CORE_SUCCESS && config->promiscuous) {
+        result = pio_membership(io);
+    }
+    if (result != CORE_SUCCESS) {
+        pio_free(io);
+        return result;
+    }
+    *out = io;
+    return CORE_SUCCESS;
+}
+
+int core_packet_io_open(const char* ifname, int backend, const core_packet_io_config_t* config,
+                        core_packet_io_t** io) {
+    core_packet_io_config_t defaults;
+    unsigned ifindex;
+    int result;
+
+    if (!ifname || !io || backend < CORE_PACKET_IO_AUTO || backend > CORE_PACKET_IO_AF_PACKET) {
+        return CORE_ERR_INVALID;
+    }
+    if (!config) {
+        memset(&defaults, 0, sizeof(defaults));
+        config = &defaults;
+    }
+    ifindex = if_nametoindex(ifname);
+    if (ifindex == 0) {
+        return CORE_ERR_NOTFOUND;
+    }
+    if (backend != CORE_PACKET_IO_AF_PACKET) {
+        result = pio_open_backend((int)ifindex, CORE_PACKET_IO_AF_XDP, config, io);
+        if (backend == CORE_PACKET_IO_AF_XDP || result != CORE_ERR_UNSUPPORTED) {
+            return result;
+        }
+    }
+    return pio_open_backend((int)ifindex, CORE_PACKET_IO_AF_PACKET, config, io);
+}
+
+void core_packet_io_close(core_packet_io_t* io) {
+    if (io) {
+        pio_free(io);
+    }
+}
+
+int core_packet_io_backend(const core_packet_io_t* io) {
+    return io->backend;
+}
+
+int core_packet_io_zero_copy(const core_packet_io_t* io) {
+    return io->zero_copy;
+}
+
+int core_packet_io_fd(const core_packet_io_t* io) {
+    return io->fd;
+}
+
+int core_packet_io_wait(core_packet_io_t* io, int timeout_ms) {
+    struct pollfd pfd;
+    int ret;
+
+    // Непрочитанное уже на руках — ждать нечего
+    if (io->backend == CORE_PACKET_IO_AF_XDP) {
+        if (__atomic_load_n(io->rx.producer, __ATOMIC_ACQUIRE) != *io->rx.consumer) {
+            return 1;
+        }
+    } else if (io->block_left ||
+               (__atomic_load_n(&tpacket_block(io, io->block)->hdr.bh1.block_status, __ATOMIC_ACQUIRE) &
+                TP_STATUS_USER)) {
+        return 1;
+    }
+
+    pfd.fd = io->fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    do {
+        ret = poll(&pfd, 1, timeout_ms);
+    } while (ret < 0 && errno == EINTR);
+    if (ret > 0 && (pfd.revents & (POLLERR | POLLNVAL))) {
+        errno = EIO;
+        return -1;
+    }
+    return ret > 0 ? 1 : ret;
+}
+
+size_t core_packet_io_rx_burst(core_packet_io_t* io, core_packet_t* pkts, size_t max) {
+    return io->backend == CORE_PACKET_IO_AF_XDP ? xsk_rx_burst(io, pkts, max) : tpacket_rx_burst(io, pkts, max);
+}
+
+int core_packet_io_send(core_packet_io_t* io, const void* frame, size_t len) {
+    if (!frame || len == 0) {
+        return CORE_ERR_INVALID;
+    }
+    return io->backend == CORE_PACKET_IO_AF_XDP ? xsk_send(io, frame, len) : tpacket_send(io, frame, len);
+}
+
+void core_packet_io_stats(core_packet_io_t* io, core_packet_io_stats_t* stats) {
+    stats->rx_packets = __atomic_load_n(&io->rx_packets, __ATOMIC_RELAXED);
+    stats->rx_bytes = __atomic_load_n(&io->rx_bytes, __ATOMIC_RELAXED);
+    stats->rx_dropped = io->backend == CORE_PACKET_IO_AF_XDP ? xsk_dropped(io) : tpacket_dropped(io);
+    stats->tx_packets = __atomic_load_n(&io->tx_packets, __ATOMIC_RELAXED);
+}
+
+#else
+
+int core_packet_io_open(const char* ifname, int backend, const core_packet_io_config_t* config,
+                        core_packet_io_t** io) {
+    (void)ifname; (void)backend; (void)config; (void)io;
+    return CORE_ERR_UNSUPPORTED;
+}
+
+void core_packet_io_close(core_packet_io_t* io) {
+    (void)io;
+}
+
+int core_packet_io_backend(const core_packet_io_t* io) {
+    (void)io;
+    return CORE_PACKET_IO_AUTO;
+}
+
+int core_packet_io_zero_copy(const core_packet_io_t* io) {
+    (void)io;
+    return 0;
+}
+
+int core_packet_io_fd(const core_packet_io_t* io) {
+    (void)io;
+    return -1;
+}
+
+int core_packet_io_wait(core_packet_io_t* io, int timeout_ms) {
+    (void)io; (void)timeout_ms;
+    errno = ENOSYS;
+    return -1;
+}
+
+size_t core_packet_io_rx_burst(core_packet_io_t* io, core_packet_t* pkts, size_t max) {
+    (void)io; (void)pkts; (void)max;
+    return 0;
+}
+
+int core_packet_io_send(core_packet_io_t* io, const void* frame, size_t len) {
+    (void)io; (void)frame; (void)len;
+    return CORE_ERR_UNSUPPORTED;
+}
+
+void core_packet_io_stats(core_packet_io_t* io, core_packet_io_stats_t* stats) {
+    (void)io;
+    memset(stats, 0, sizeof(*stats));
+}
+
+#endif
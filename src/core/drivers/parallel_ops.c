@@ -0,0 +1,134 @@
+#include "core/drivers/parallel_ops.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Задание пула: индексы раздаются атомарным счётчиком, refs — число рабочих,
+// взявших задание; вызывающий ждёт, пока все задачи выполнены и refs == 0.
+typedef struct {
+    void (*task)(void* arg, size_t index);
+    void* arg;
+    size_t num_tasks;
+    size_t next;
+    size_t refs;
+} pool_job_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_mutex_t submit;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    pool_job_t* job;
+    unsigned long generation;
+    size_t num_workers;
+} thread_pool_t;
+
+static thread_pool_t pool = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER,
+    NULL, 0, 0
+};
+
+static core_executor_t default_executor;
+
+// Поток уже выполняет задачу пула: вложенный parallel_for идёт последовательно
+static _Thread_local int in_pool_task;
+
+static void run_job(pool_job_t* job) {
+    in_pool_task = 1;
+    for (size_t i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED); i < job->num_tasks;
+         i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) {
+        job->task(job->arg, i);
+    }
+    in_pool_task = 0;
+}
+
+static void* pool_worker(void* unused) {
+    (void)unused;
+    unsigned long seen = 0;
+    pthread_mutex_lock(&pool.lock);
+    for (;;) {
+        while (!pool.job || pool.generation == seen) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        }
+        seen = pool.generation;
+        pool_job_t* job = pool.job;
+        job->refs++;
+        pthread_mutex_unlock(&pool.lock);
+
+        run_job(job);
+
+        pthread_mutex_lock(&pool.lock);
+        if (--job->refs == 0) {
+            pthread_cond_broadcast(&pool.done);
+        }
+    }
+    return NULL;
+}
+
+static void pool_parallel_for(void* ctx, size_t num_tasks, void (*task)(void* arg, size_t index), void* arg) {
+    (void)ctx;
+    if (num_tasks == 0) {
+        return;
+    }
+    if (num_tasks == 1 || pool.num_workers == 0 || in_pool_task || pthread_mutex_trylock(&pool.submit) != 0) {
+        for (size_t i = 0; i < num_tasks; ++i) {
+            task(arg, i);
+        }
+        return;
+    }
+
+    pool_job_t job = {task, arg, num_tasks, 0, 0};
+    pthread_mutex_lock(&pool.lock);
+    pool.job = &job;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    run_job(&job);
+
+    // Задачи разобраны; снимаем задание, чтобы опоздавшие рабочие его не взяли,
+    // и ждём тех, кто ещё выполняет свою последнюю задачу
+    pthread_mutex_lock(&pool.lock);
+    pool.job = NULL;
+    while (job.refs > 0) {
+        pthread_cond_wait(&pool.done, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.submit);
+}
+
+static void start_pool_once() {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t workers = cpus > 1 ? (size_t)cpus - 1 : 0;
+    size_t started = 0;
+    for (; started < workers; ++started) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, pool_worker, NULL) != 0) {
+            break;
+        }
+        pthread_detach(thread);
+    }
+    pool.num_workers = started;
+    default_executor.parallel_for = pool_parallel_for;
+    default_executor.ctx = &pool;
+    default_executor.num_threads = started + 1;
+}
+
+const core_executor_t* core_default_executor(void) {
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, start_pool_once);
+    return &default_executor;
+}
+
+void core_parallel_for(const core_executor_t* executor, size_t num_tasks,
+                       void (*task)(void* arg, size_t index), void* arg) {
+    if (executor && executor->parallel_for && executor->num_threads > 1 && num_tasks > 1) {
+        executor->parallel_for(executor->ctx, num_tasks, task, arg);
+        return;
+    }
+    for (size_t i = 0; i < num_tasks; ++i) {
+        task(arg, i);
+    }
+}
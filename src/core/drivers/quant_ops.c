@@ -0,0 +1,743 @@
+#include "core/drivers/quant_ops.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#include <math.h>
+#include <string.h>
+
+// Слой абстракции над набором инструкций. qv_* работают с регистром как с
+// QV_BYTES байтами целых любой ширины, qf_* — с QF_WIDTH float. Ядра ниже
+// написаны один раз через эти функции; то, что различается по существу
+// (int8-произведение через VNNI/sdot, сужение при квантовании), — отдельно
+// в каждом ядре. Хвосты считаются скалярно той же формулой.
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+
+#define QV_BYTES 64
+typedef __m512i qv_t;
+
+static inline qv_t qv_load(const void* p) { return _mm512_loadu_si512(p); }
+static inline void qv_store(void* p, qv_t v) { _mm512_storeu_si512(p, v); }
+static inline qv_t qv_zero(void) { return _mm512_setzero_si512(); }
+static inline qv_t qv_add_i8(qv_t a, qv_t b) { return _mm512_add_epi8(a, b); }
+static inline qv_t qv_add_i16(qv_t a, qv_t b) { return _mm512_add_epi16(a, b); }
+static inline qv_t qv_add_i64(qv_t a, qv_t b) { return _mm512_add_epi64(a, b); }
+static inline qv_t qv_mul_i16(qv_t a, qv_t b) { return _mm512_mullo_epi16(a, b); }
+static inline qv_t qv_mul_i8(qv_t a, qv_t b) {
+    // Произведения чётных и нечётных байт в 16-битных полях, младшие байты результата
+    qv_t even = _mm512_mullo_epi16(a, b);
+    qv_t odd = _mm512_mullo_epi16(_mm512_srli_epi16(a, 8), _mm512_srli_epi16(b, 8));
+    return _mm512_or_si512(_mm512_and_si512(even, _mm512_set1_epi16(0x00FF)), _mm512_slli_epi16(odd, 8));
+}
+#if defined(__AVX512DQ__)
+static inline qv_t qv_mul_i64(qv_t a, qv_t b) { return _mm512_mullo_epi64(a, b); }
+#else
+static inline qv_t qv_mul_i64(qv_t a, qv_t b) {
+    qv_t lo = _mm512_mul_epu32(a, b);
+    qv_t cross = _mm512_add_epi64(_mm512_mul_epu32(_mm512_srli_epi64(a, 32), b),
+                                  _mm512_mul_epu32(a, _mm512_srli_epi64(b, 32)));
+    return _mm512_add_epi64(lo, _mm512_slli_epi64(cross, 32));
+}
+#endif
+// Сумма байт со знаком в 64-битные поля: сдвиг в беззнаковый диапазон и PSADBW
+static inline qv_t qv_sum_i8(qv_t acc, qv_t x) {
+    return _mm512_add_epi64(acc, _mm512_sad_epu8(_mm512_xor_si512(x, _mm512_set1_epi8((char)0x80)),
+                                                 _mm512_setzero_si512()));
+}
+static inline qv_t qv_widen_add_i32(qv_t acc, qv_t x) {
+    return _mm512_add_epi64(acc, _mm512_add_epi64(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(x)),
+                                                  _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(x, 1))));
+}
+static inline qv_t qv_sum_i16(qv_t acc, qv_t x) { return qv_widen_add_i32(acc, _mm512_madd_epi16(x, _mm512_set1_epi16(1))); }
+static inline qv_t qv_dot_i16(qv_t acc, qv_t a, qv_t b) { return qv_widen_add_i32(acc, _mm512_madd_epi16(a, b)); }
+
+#define QF_WIDTH 16
+typedef __m512 qf_t;
+
+static inline qf_t qf_load(const float* p) { return _mm512_loadu_ps(p); }
+static inline void qf_store(float* p, qf_t v) { _mm512_storeu_ps(p, v); }
+static inline qf_t qf_set1(float x) { return _mm512_set1_ps(x); }
+static inline qf_t qf_fma(qf_t a, qf_t b, qf_t c) { return _mm512_fmadd_ps(a, b, c); }
+static inline qf_t qf_load_bf16(const core_bf16_t* p) {
+    return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)p)), 16));
+}
+static inline float qf_hsum(qf_t v) { return _mm512_reduce_add_ps(v); }
+
+#elif defined(__AVX2__)
+
+#define QV_BYTES 32
+typedef __m256i qv_t;
+
+static inline qv_t qv_load(const void* p) { return _mm256_loadu_si256((const __m256i*)p); }
+static inline void qv_store(void* p, qv_t v) { _mm256_storeu_si256((__m256i*)p, v); }
+static inline qv_t qv_zero(void) { return _mm256_setzero_si256(); }
+static inline qv_t qv_add_i8(qv_t a, qv_t b) { return _mm256_add_epi8(a, b); }
+static inline qv_t qv_add_i16(qv_t a, qv_t b) { return _mm256_add_epi16(a, b); }
+static inline qv_t qv_add_i64(qv_t a, qv_t b) { return _mm256_add_epi64(a, b); }
+static inline qv_t qv_mul_i16(qv_t a, qv_t b) { return _mm256_mullo_epi16(a, b); }
+static inline qv_t qv_mul_i8(qv_t a, qv_t b) {
+    qv_t even = _mm256_mullo_epi16(a, b);
+    qv_t odd = _mm256_mullo_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+    return _mm256_or_si256(_mm256_and_si256(even, _mm256_set1_epi16(0x00FF)), _mm256_slli_epi16(odd, 8));
+}
+static inline qv_t qv_mul_i64(qv_t a, qv_t b) {
+    qv_t lo = _mm256_mul_epu32(a, b);
+    qv_t cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                  _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+static inline qv_t qv_sum_i8(qv_t acc, qv_t x) {
+    return _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_xor_si256(x, _mm256_set1_epi8((char)0x80)),
+                                                 _mm256_setzero_si256()));
+}
+static inline qv_t qv_widen_add_i32(qv_t acc, qv_t x) {
+    return _mm256_add_epi64(acc, _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)),
+                                                  _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1))));
+}
+static inline qv_t qv_sum_i16(qv_t acc, qv_t x) { return qv_widen_add_i32(acc, _mm256_madd_epi16(x, _mm256_set1_epi16(1))); }
+static inline qv_t qv_dot_i16(qv_t acc, qv_t a, qv_t b) { return qv_widen_add_i32(acc, _mm256_madd_epi16(a, b)); }
+
+#define QF_WIDTH 8
+typedef __m256 qf_t;
+
+static inline qf_t qf_load(const float* p) { return _mm256_loadu_ps(p); }
+static inline void qf_store(float* p, qf_t v) { _mm256_storeu_ps(p, v); }
+static inline qf_t qf_set1(float x) { return _mm256_set1_ps(x); }
+#if defined(__FMA__)
+static inline qf_t qf_fma(qf_t a, qf_t b, qf_t c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+static inline qf_t qf_fma(qf_t a, qf_t b, qf_t c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+static inline qf_t qf_load_bf16(const core_bf16_t* p) {
+    return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)p)), 16));
+}
+static inline float qf_hsum(qf_t v) {
+    __m128 x = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    return _mm_cvtss_f32(_mm_add_ss(x, _mm_movehdup_ps(x)));
+}
+
+#elif defined(__SSE4_2__)
+
+#define QV_BYTES 16
+typedef __m128i qv_t;
+
+static inline qv_t qv_load(const void* p) { return _mm_loadu_si128((const __m128i*)p); }
+static inline void qv_store(void* p, qv_t v) { _mm_storeu_si128((__m128i*)p, v); }
+static inline qv_t qv_zero(void) { return _mm_setzero_si128(); }
+static inline qv_t qv_add_i8(qv_t a, qv_t b) { return _mm_add_epi8(a, b); }
+static inline qv_t qv_add_i16(qv_t a, qv_t b) { return _mm_add_epi16(a, b); }
+static inline qv_t qv_add_i64(qv_t a, qv_t b) { return _mm_add_epi64(a, b); }
+static inline qv_t qv_mul_i16(qv_t a, qv_t b) { return _mm_mullo_epi16(a, b); }
+static inline qv_t qv_mul_i8(qv_t a, qv_t b) {
+    qv_t even = _mm_mullo_epi16(a, b);
+    qv_t odd = _mm_mullo_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+    return _mm_or_si128(_mm_and_si128(even, _mm_set1_epi16(0x00FF)), _mm_slli_epi16(odd, 8));
+}
+static inline qv_t qv_mul_i64(qv_t a, qv_t b) {
+    qv_t lo = _mm_mul_epu32(a, b);
+    qv_t cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+    return _mm_add_epi64(lo, _mm_slli_epi64(cross, 32));
+}
+static inline qv_t qv_sum_i8(qv_t acc, qv_t x) {
+    return _mm_add_epi64(acc, _mm_sad_epu8(_mm_xor_si128(x, _mm_set1_epi8((char)0x80)), _mm_setzero_si128()));
+}
+static inline qv_t qv_widen_add_i32(qv_t acc, qv_t x) {
+    return _mm_add_epi64(acc, _mm_add_epi64(_mm_cvtepi32_epi64(x), _mm_cvtepi32_epi64(_mm_srli_si128(x, 8))));
+}
+static inline qv_t qv_sum_i16(qv_t acc, qv_t x) { return qv_widen_add_i32(acc, _mm_madd_epi16(x, _mm_set1_epi16(1))); }
+static inline qv_t qv_dot_i16(qv_t acc, qv_t a, qv_t b) { return qv_widen_add_i32(acc, _mm_madd_epi16(a, b)); }
+
+#define QF_WIDTH 4
+typedef __m128 qf_t;
+
+static inline qf_t qf_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void qf_store(float* p, qf_t v) { _mm_storeu_ps(p, v); }
+static inline qf_t qf_set1(float x) { return _mm_set1_ps(x); }
+#if defined(__FMA__)
+static inline qf_t qf_fma(qf_t a, qf_t b, qf_t c) { return _mm_fmadd_ps(a, b, c); }
+#else
+static inline qf_t qf_fma(qf_t a, qf_t b, qf_t c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#endif
+static inline qf_t qf_load_bf16(const core_bf16_t* p) {
+    return _mm_castsi128_ps(_mm_slli_epi32(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)p)), 16));
+}
+static inline float qf_hsum(qf_t v) {
+    __m128 x = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(x, _mm_movehdup_ps(x)));
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+#define QV_BYTES 16
+typedef int8x16_t qv_t;
+
+static inline qv_t qv_load(const void* p) { return vld1q_s8((const int8_t*)p); }
+static inline void qv_store(void* p, qv_t v) { vst1q_s8((int8_t*)p, v); }
+static inline qv_t qv_zero(void) { return vdupq_n_s8(0); }
+static inline qv_t qv_add_i8(qv_t a, qv_t b) { return vaddq_s8(a, b); }
+static inline qv_t qv_add_i16(qv_t a, qv_t b) {
+    return vreinterpretq_s8_s16(vaddq_s16(vreinterpretq_s16_s8(a), vreinterpretq_s16_s8(b)));
+}
+static inline qv_t qv_add_i64(qv_t a, qv_t b) {
+    return vreinterpretq_s8_s64(vaddq_s64(vreinterpretq_s64_s8(a), vreinterpretq_s64_s8(b)));
+}
+static inline qv_t qv_mul_i8(qv_t a, qv_t b) { return vmulq_s8(a, b); }
+static inline qv_t qv_mul_i16(qv_t a, qv_t b) {
+    return vreinterpretq_s8_s16(vmulq_s16(vreinterpretq_s16_s8(a), vreinterpretq_s16_s8(b)));
+}
+static inline qv_t qv_mul_i64(qv_t a, qv_t b) {
+    // Векторного умножения 64x64 в NEON нет
+    uint64x2_t ua = vreinterpretq_u64_s8(a), ub = vreinterpretq_u64_s8(b);
+    uint64x2_t r = vsetq_lane_u64(vgetq_lane_u64(ua, 0) * vgetq_lane_u64(ub, 0), ua, 0);
+    r = vsetq_lane_u64(vgetq_lane_u64(ua, 1) * vgetq_lane_u64(ub, 1), r, 1);
+    return vreinterpretq_s8_u64(r);
+}
+static inline qv_t qv_sum_i8(qv_t acc, qv_t x) {
+    return vreinterpretq_s8_s64(vpadalq_s32(vreinterpretq_s64_s8(acc), vpaddlq_s16(vpaddlq_s8(x))));
+}
+static inline qv_t qv_sum_i16(qv_t acc, qv_t x) {
+    return vreinterpretq_s8_s64(vpadalq_s32(vreinterpretq_s64_s8(acc), vpaddlq_s16(vreinterpretq_s16_s8(x))));
+}
+static inline qv_t qv_dot_i16(qv_t acc, qv_t a, qv_t b) {
+    int16x8_t a16 = vreinterpretq_s16_s8(a), b16 = vreinterpretq_s16_s8(b);
+    int64x2_t r = vpadalq_s32(vreinterpretq_s64_s8(acc), vmull_s16(vget_low_s16(a16), vget_low_s16(b16)));
+    return vreinterpretq_s8_s64(vpadalq_s32(r, vmull_high_s16(a16, b16)));
+}
+
+#define QF_WIDTH 4
+typedef float32x4_t qf_t;
+
+static inline qf_t qf_load(const float* p) { return vld1q_f32(p); }
+static inline void qf_store(float* p, qf_t v) { vst1q_f32(p, v); }
+static inline qf_t qf_set1(float x) { return vdupq_n_f32(x); }
+static inline qf_t qf_fma(qf_t a, qf_t b, qf_t c) { return vfmaq_f32(c, a, b); }
+static inline qf_t qf_load_bf16(const core_bf16_t* p) {
+    return vreinterpretq_f32_u32(vshll_n_u16(vld1_u16((const uint16_t*)p), 16));
+}
+static inline float qf_hsum(qf_t v) { return vaddvq_f32(v); }
+
+#endif
+
+#ifdef QV_BYTES
+static inline int64_t qv_hsum_i64(qv_t v) {
+    int64_t lanes[QV_BYTES / 8];
+    memcpy(lanes, &v, sizeof(lanes));
+    uint64_t sum = 0;
+    for (size_t i = 0; i < QV_BYTES / 8; ++i) sum += (uint64_t)lanes[i];
+    return (int64_t)sum;
+}
+
+static inline int64_t qv_hsum_i32(qv_t v) {
+    int32_t lanes[QV_BYTES / 4];
+    memcpy(lanes, &v, sizeof(lanes));
+    int64_t sum = 0;
+    for (size_t i = 0; i < QV_BYTES / 4; ++i) sum += lanes[i];
+    return sum;
+}
+#endif
+
+// Скалярные операции по модулю 2^N без неопределённого поведения
+static inline int8_t wrap_i8(uint32_t x) { return (int8_t)(uint8_t)x; }
+static inline int16_t wrap_i16(uint32_t x) { return (int16_t)(uint16_t)x; }
+
+static inline float bf16_to_f32(core_bf16_t x) {
+    uint32_t bits = (uint32_t)x.bits << 16;
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static inline core_bf16_t f32_to_bf16(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    core_bf16_t r;
+    if (f != f) {
+        r.bits = (uint16_t)((bits >> 16) | 0x40); // тихий NaN
+    } else {
+        r.bits = (uint16_t)((bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16);
+    }
+    return r;
+}
+
+static inline int8_t quantize_one(float x, float inv_scale) {
+    float q = x * inv_scale;
+    if (q != q) return 0;
+    q = fminf(fmaxf(q, -127.0f), 127.0f);
+    return (int8_t)nearbyintf(q);
+}
+
+// --- Поэлементные операции ---
+
+// Тело поэлементной операции: векторный цикл по QV_BYTES и скалярный хвост
+#ifdef QV_BYTES
+#define QUANT_ELEMENTWISE(type, vec_op, scalar_expr)                                  \
+    size_t i = 0;                                                                     \
+    for (; i + QV_BYTES / sizeof(type) <= n; i += QV_BYTES / sizeof(type)) {          \
+        qv_store(dst + i, vec_op(qv_load(src1 + i), qv_load(src2 + i)));              \
+    }                                                                                 \
+    for (; i < n; ++i) {                                                              \
+        dst[i] = scalar_expr;                                                         \
+    }
+#else
+#define QUANT_ELEMENTWISE(type, vec_op, scalar_expr) \
+    for (size_t i = 0; i < n; ++i) {                 \
+        dst[i] = scalar_expr;                        \
+    }
+#endif
+
+void core_vector_add_i8(int8_t* dst, const int8_t* src1, const int8_t* src2, size_t n) {
+    QUANT_ELEMENTWISE(int8_t, qv_add_i8, wrap_i8((uint32_t)src1[i] + (uint32_t)src2[i]))
+}
+
+void core_vector_add_i16(int16_t* dst, const int16_t* src1, const int16_t* src2, size_t n) {
+    QUANT_ELEMENTWISE(int16_t, qv_add_i16, wrap_i16((uint32_t)src1[i] + (uint32_t)src2[i]))
+}
+
+void core_vector_add_i64(int64_t* dst, const int64_t* src1, const int64_t* src2, size_t n) {
+    QUANT_ELEMENTWISE(int64_t, qv_add_i64, (int64_t)((uint64_t)src1[i] + (uint64_t)src2[i]))
+}
+
+void core_vector_mul_i8(int8_t* dst, const int8_t* src1, const int8_t* src2, size_t n) {
+    QUANT_ELEMENTWISE(int8_t, qv_mul_i8, wrap_i8((uint32_t)src1[i] * (uint32_t)src2[i]))
+}
+
+void core_vector_mul_i16(int16_t* dst, const int16_t* src1, const int16_t* src2, size_t n) {
+    QUANT_ELEMENTWISE(int16_t, qv_mul_i16, wrap_i16((uint32_t)src1[i] * (uint32_t)src2[i]))
+}
+
+void core_vector_mul_i64(int64_t* dst, const int64_t* src1, const int64_t* src2, size_t n) {
+    QUANT_ELEMENTWISE(int64_t, qv_mul_i64, (int64_t)((uint64_t)src1[i] * (uint64_t)src2[i]))
+}
+
+#undef QUANT_ELEMENTWISE
+
+// --- Суммы и скалярные произведения ---
+
+int64_t core_vector_sum_i8(const int8_t* src, size_t n) {
+    int64_t sum = 0;
+    size_t i = 0;
+#ifdef QV_BYTES
+    qv_t acc = qv_zero();
+    for (; i + QV_BYTES <= n; i += QV_BYTES) {
+        acc = qv_sum_i8(acc, qv_load(src + i));
+    }
+    sum = qv_hsum_i64(acc);
+#if !(defined(__ARM_NEON) && defined(__aarch64__))
+    sum -= 128 * (int64_t)i; // PSADBW суммировал байты, сдвинутые на +128
+#endif
+#endif
+    for (; i < n; ++i) {
+        sum += src[i];
+    }
+    return sum;
+}
+
+int64_t core_vector_sum_i16(const int16_t* src, size_t n) {
+    int64_t sum = 0;
+    size_t i = 0;
+#ifdef QV_BYTES
+    qv_t acc = qv_zero();
+    for (; i + QV_BYTES / 2 <= n; i += QV_BYTES / 2) {
+        acc = qv_sum_i16(acc, qv_load(src + i));
+    }
+    sum = qv_hsum_i64(acc);
+#endif
+    for (; i < n; ++i) {
+        sum += src[i];
+    }
+    return sum;
+}
+
+int64_t core_vector_sum_i64(const int64_t* src, size_t n) {
+    uint64_t sum = 0;
+    size_t i = 0;
+#ifdef QV_BYTES
+    qv_t acc = qv_zero();
+    for (; i + QV_BYTES / 8 <= n; i += QV_BYTES / 8) {
+        acc = qv_add_i64(acc, qv_load(src + i));
+    }
+    sum = (uint64_t)qv_hsum_i64(acc);
+#endif
+    for (; i < n; ++i) {
+        sum += (uint64_t)src[i];
+    }
+    return (int64_t)sum;
+}
+
+int32_t core_vector_dot_i8(const int8_t* src1, const int8_t* src2, size_t n) {
+    int64_t sum = 0;
+    size_t i = 0;
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VNNI__)
+    // VPDPBUSD умножает беззнаковые байты на знаковые: src1 + 128 даёт
+    // беззнаковый операнд, поправка 128 * sum(src2) считается той же инструкцией
+    const __m512i bias = _mm512_set1_epi8((char)0x80), ones = _mm512_set1_epi8(1);
+    __m512i acc = _mm512_setzero_si512(), correction = _mm512_setzero_si512();
+    for (; i + 64 <= n; i += 64) {
+        __m512i a = _mm512_loadu_si512(src1 + i), b = _mm512_loadu_si512(src2 + i);
+        acc = _mm512_dpbusd_epi32(acc, _mm512_xor_si512(a, bias), b);
+        correction = _mm512_dpbusd_epi32(correction, ones, b);
+    }
+    sum = qv_hsum_i32(acc) - 128 * qv_hsum_i32(correction);
+#elif defined(__AVX512F__) && defined(__AVX512BW__)
+    __m512i acc = _mm512_setzero_si512();
+    for (; i + 32 <= n; i += 32) {
+        __m512i a = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(src1 + i)));
+        __m512i b = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(src2 + i)));
+        acc = _mm512_add_epi32(acc, _mm512_madd_epi16(a, b));
+    }
+    sum = qv_hsum_i32(acc);
+#elif defined(__AVX2__) && defined(__AVXVNNI__)
+    const __m256i bias = _mm256_set1_epi8((char)0x80), ones = _mm256_set1_epi8(1);
+    __m256i acc = _mm256_setzero_si256(), correction = _mm256_setzero_si256();
+    for (; i + 32 <= n; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(src1 + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src2 + i));
+        acc = _mm256_dpbusd_avx_epi32(acc, _mm256_xor_si256(a, bias), b);
+        correction = _mm256_dpbusd_avx_epi32(correction, ones, b);
+    }
+    sum = qv_hsum_i32(acc) - 128 * qv_hsum_i32(correction);
+#elif defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 16 <= n; i += 16) {
+        __m256i a = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(src1 + i)));
+        __m256i b = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(src2 + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+    }
+    sum = qv_hsum_i32(acc);
+#elif defined(__SSE4_2__)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8) {
+        __m128i a = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i*)(src1 + i)));
+        __m128i b = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i*)(src2 + i)));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a, b));
+    }
+    sum = qv_hsum_i32(acc);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    int32x4_t acc = vdupq_n_s32(0);
+    for (; i + 16 <= n; i += 16) {
+        int8x16_t a = vld1q_s8(src1 + i), b = vld1q_s8(src2 + i);
+#if defined(__ARM_FEATURE_DOTPROD)
+        acc = vdotq_s32(acc, a, b);
+#else
+        // Произведение байт помещается в int16: |(-128) * (-128)| = 2^14
+        acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(a), vget_low_s8(b)));
+        acc = vpadalq_s16(acc, vmull_high_s8(a, b));
+#endif
+    }
+    sum = vaddlvq_s32(acc);
+#endif
+    for (; i < n; ++i) {
+        sum += (int32_t)src1[i] * src2[i];
+    }
+    return (int32_t)(uint32_t)sum;
+}
+
+int64_t core_vector_dot_i16(const int16_t* src1, const int16_t* src2, size_t n) {
+    int64_t sum = 0;
+    size_t i = 0;
+#ifdef QV_BYTES
+    qv_t acc = qv_zero();
+    for (; i + QV_BYTES / 2 <= n; i += QV_BYTES / 2) {
+        acc = qv_dot_i16(acc, qv_load(src1 + i), qv_load(src2 + i));
+    }
+    sum = qv_hsum_i64(acc);
+#endif
+    for (; i < n; ++i) {
+        sum += (int32_t)src1[i] * src2[i];
+    }
+    return sum;
+}
+
+int64_t core_vector_dot_i64(const int64_t* src1, const int64_t* src2, size_t n) {
+    uint64_t sum = 0;
+    size_t i = 0;
+#ifdef QV_BYTES
+    qv_t acc = qv_zero();
+    for (; i + QV_BYTES / 8 <= n; i += QV_BYTES / 8) {
+        acc = qv_add_i64(acc, qv_mul_i64(qv_load(src1 + i), qv_load(src2 + i)));
+    }
+    sum = (uint64_t)qv_hsum_i64(acc);
+#endif
+    for (; i < n; ++i) {
+        sum += (uint64_t)src1[i] * (uint64_t)src2[i];
+    }
+    return (int64_t)sum;
+}
+
+// --- Квантование ---
+
+void core_vector_quantize_i8(int8_t* dst, const float* src, size_t n, float scale) {
+    const float inv_scale = 1.0f / scale;
+    size_t i = 0;
+#if defined(__AVX512F__)
+    const __m512 inv = _mm512_set1_ps(inv_scale), lo = _mm512_set1_ps(-127.0f), hi = _mm512_set1_ps(127.0f);
+    for (; i + 16 <= n; i += 16) {
+        __m512 x = _mm512_mul_ps(_mm512_loadu_ps(src + i), inv);
+        x = _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(x, x, _CMP_ORD_Q), x);
+        x = _mm512_min_ps(_mm512_max_ps(x, lo), hi);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm512_cvtsepi32_epi8(_mm512_cvtps_epi32(x)));
+    }
+#elif defined(__AVX2__)
+    const __m256 inv = _mm256_set1_ps(inv_scale), lo = _mm256_set1_ps(-127.0f), hi = _mm256_set1_ps(127.0f);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    for (; i + 32 <= n; i += 32) {
+        __m256i q[4];
+        for (int k = 0; k < 4; ++k) {
+            __m256 x = _mm256_mul_ps(_mm256_loadu_ps(src + i + 8 * k), inv);
+            x = _mm256_and_ps(x, _mm256_cmp_ps(x, x, _CMP_ORD_Q));
+            q[k] = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(x, lo), hi));
+        }
+        // Упаковка идёт внутри 128-битных половин, перестановка восстанавливает порядок
+        __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(q[0], q[1]), _mm256_packs_epi32(q[2], q[3]));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_permutevar8x32_epi32(packed, order));
+    }
+#elif defined(__SSE4_2__)
+    const __m128 inv = _mm_set1_ps(inv_scale), lo = _mm_set1_ps(-127.0f), hi = _mm_set1_ps(127.0f);
+    for (; i + 16 <= n; i += 16) {
+        __m128i q[4];
+        for (int k = 0; k < 4; ++k) {
+            __m128 x = _mm_mul_ps(_mm_loadu_ps(src + i + 4 * k), inv);
+            x = _mm_and_ps(x, _mm_cmpord_ps(x, x));
+            q[k] = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(x, lo), hi));
+        }
+        _mm_storeu_si128((__m128i*)(dst + i),
+                         _mm_packs_epi16(_mm_packs_epi32(q[0], q[1]), _mm_packs_epi32(q[2], q[3])));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t inv = vdupq_n_f32(inv_scale), lo = vdupq_n_f32(-127.0f), hi = vdupq_n_f32(127.0f);
+    for (; i + 8 <= n; i += 8) {
+        // NaN проходит через min/max, vcvtnq переводит его в 0
+        float32x4_t x0 = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i), inv), lo), hi);
+        float32x4_t x1 = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i + 4), inv), lo), hi);
+        int16x8_t q = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(x0)), vqmovn_s32(vcvtnq_s32_f32(x1)));
+        vst1_s8(dst + i, vqmovn_s16(q));
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = quantize_one(src[i], inv_scale);
+    }
+}
+
+void core_vector_dequantize_i8(float* dst, const int8_t* src, size_t n, float scale) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    const __m512 s = _mm512_set1_ps(scale);
+    for (; i + 16 <= n; i += 16) {
+        __m512i x = _mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+        _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_cvtepi32_ps(x), s));
+    }
+#elif defined(__AVX2__)
+    const __m256 s = _mm256_set1_ps(scale);
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(x), s));
+    }
+#elif defined(__SSE4_2__)
+    const __m128 s = _mm_set1_ps(scale);
+    for (; i + 8 <= n; i += 8) {
+        __m128i x = _mm_loadl_epi64((const __m128i*)(src + i));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi8_epi32(x)), s));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi8_epi32(_mm_srli_si128(x, 4))), s));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t s = vdupq_n_f32(scale);
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t x = vmovl_s8(vld1_s8(src + i));
+        vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), s));
+        vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_high_s16(x)), s));
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = (float)src[i] * scale;
+    }
+}
+
+void core_convolve_i8(int32_t* dst, const int8_t* src, size_t src_size,
+                      const int8_t* kernel, size_t kernel_size) {
+    if (kernel_size == 0 || kernel_size > src_size) return;
+    const size_t out_size = src_size - kernel_size + 1;
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE4_2__)
+    // Отводы берутся парами: в каждом 32-битном поле (src[i+j], src[i+j+1])
+    // умножается на (kernel[j], kernel[j+1]) одной PMADDWD. Для нечётного
+    // числа отводов последняя пара дополняется нулевым коэффициентом.
+    const size_t pairs = (kernel_size + 1) / 2;
+#if defined(__AVX2__)
+    // 16 выходов: распаковка внутри 128-битных половин даёт выходы 0-3, 8-11
+    // в lo и 4-7, 12-15 в hi; порядок восстанавливается при записи
+    for (; i + 16 + 2 * pairs <= src_size + 1 && i + 16 <= out_size; i += 16) {
+        __m256i acc_lo = _mm256_setzero_si256(), acc_hi = _mm256_setzero_si256();
+        for (size_t p = 0; p < pairs; ++p) {
+            const size_t j = 2 * p;
+            const int16_t k1 = j + 1 < kernel_size ? kernel[j + 1] : 0;
+            const __m256i k = _mm256_set1_epi32((int32_t)(uint16_t)kernel[j] | ((int32_t)k1 << 16));
+            __m256i x = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(src + i + j)));
+            __m256i y = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(src + i + j + 1)));
+            acc_lo = _mm256_add_epi32(acc_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(x, y), k));
+            acc_hi = _mm256_add_epi32(acc_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(x, y), k));
+        }
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_permute2x128_si256(acc_lo, acc_hi, 0x20));
+        _mm256_storeu_si256((__m256i*)(dst + i + 8), _mm256_permute2x128_si256(acc_lo, acc_hi, 0x31));
+    }
+#else
+    for (; i + 8 + 2 * pairs <= src_size + 1 && i + 8 <= out_size; i += 8) {
+        __m128i acc_lo = _mm_setzero_si128(), acc_hi = _mm_setzero_si128();
+        for (size_t p = 0; p < pairs; ++p) {
+            const size_t j = 2 * p;
+            const int16_t k1 = j + 1 < kernel_size ? kernel[j + 1] : 0;
+            const __m128i k = _mm_set1_epi32((int32_t)(uint16_t)kernel[j] | ((int32_t)k1 << 16));
+            __m128i x = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i*)(src + i + j)));
+            __m128i y = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i*)(src + i + j + 1)));
+            acc_lo = _mm_add_epi32(acc_lo, _mm_madd_epi16(_mm_unpacklo_epi16(x, y), k));
+            acc_hi = _mm_add_epi32(acc_hi, _mm_madd_epi16(_mm_unpackhi_epi16(x, y), k));
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), acc_lo);
+        _mm_storeu_si128((__m128i*)(dst + i + 4), acc_hi);
+    }
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 8 <= out_size; i += 8) {
+        int32x4_t acc_lo = vdupq_n_s32(0), acc_hi = vdupq_n_s32(0);
+        for (size_t j = 0; j < kernel_size; ++j) {
+            int16x8_t x = vmovl_s8(vld1_s8(src + i + j));
+            acc_lo = vmlal_n_s16(acc_lo, vget_low_s16(x), kernel[j]);
+            acc_hi = vmlal_high_n_s16(acc_hi, x, kernel[j]);
+        }
+        vst1q_s32(dst + i, acc_lo);
+        vst1q_s32(dst + i + 4, acc_hi);
+    }
+#endif
+    for (; i < out_size; ++i) {
+        int32_t sum = 0;
+        for (size_t j = 0; j < kernel_size; ++j) {
+            sum += (int32_t)src[i + j] * kernel[j];
+        }
+        dst[i] = sum;
+    }
+}
+
+// --- bfloat16 ---
+
+void core_vector_f32_to_bf16(core_bf16_t* dst, const float* src, size_t n) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    const __m512i one = _mm512_set1_epi32(1), round = _mm512_set1_epi32(0x7FFF), quiet = _mm512_set1_epi32(0x40);
+    for (; i + 16 <= n; i += 16) {
+        __m512 x = _mm512_loadu_ps(src + i);
+        __m512i v = _mm512_castps_si512(x);
+        __m512i hi = _mm512_srli_epi32(v, 16);
+        __m512i r = _mm512_srli_epi32(_mm512_add_epi32(v, _mm512_add_epi32(round, _mm512_and_si512(hi, one))), 16);
+        r = _mm512_mask_mov_epi32(r, _mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q), _mm512_or_si512(hi, quiet));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm512_cvtepi32_epi16(r));
+    }
+#elif defined(__AVX2__)
+    const __m256i one = _mm256_set1_epi32(1), round = _mm256_set1_epi32(0x7FFF), quiet = _mm256_set1_epi32(0x40);
+    for (; i + 16 <= n; i += 16) {
+        __m256i r[2];
+        for (int k = 0; k < 2; ++k) {
+            __m256 x = _mm256_loadu_ps(src + i + 8 * k);
+            __m256i v = _mm256_castps_si256(x);
+            __m256i hi = _mm256_srli_epi32(v, 16);
+            r[k] = _mm256_srli_epi32(_mm256_add_epi32(v, _mm256_add_epi32(round, _mm256_and_si256(hi, one))), 16);
+            r[k] = _mm256_blendv_epi8(r[k], _mm256_or_si256(hi, quiet),
+                                      _mm256_castps_si256(_mm256_cmp_ps(x, x, _CMP_UNORD_Q)));
+        }
+        __m256i packed = _mm256_packus_epi32(r[0], r[1]);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+#elif defined(__SSE4_2__)
+    const __m128i one = _mm_set1_epi32(1), round = _mm_set1_epi32(0x7FFF), quiet = _mm_set1_epi32(0x40);
+    for (; i + 8 <= n; i += 8) {
+        __m128i r[2];
+        for (int k = 0; k < 2; ++k) {
+            __m128 x = _mm_loadu_ps(src + i + 4 * k);
+            __m128i v = _mm_castps_si128(x);
+            __m128i hi = _mm_srli_epi32(v, 16);
+            r[k] = _mm_srli_epi32(_mm_add_epi32(v, _mm_add_epi32(round, _mm_and_si128(hi, one))), 16);
+            r[k] = _mm_blendv_epi8(r[k], _mm_or_si128(hi, quiet), _mm_castps_si128(_mm_cmpunord_ps(x, x)));
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi32(r[0], r[1]));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint32x4_t one = vdupq_n_u32(1), round = vdupq_n_u32(0x7FFF), quiet = vdupq_n_u32(0x40);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vld1q_f32(src + i);
+        uint32x4_t v = vreinterpretq_u32_f32(x);
+        uint32x4_t hi = vshrq_n_u32(v, 16);
+        uint32x4_t r = vshrq_n_u32(vaddq_u32(v, vaddq_u32(round, vandq_u32(hi, one))), 16);
+        r = vbslq_u32(vceqq_f32(x, x), r, vorrq_u32(hi, quiet));
+        vst1_u16((uint16_t*)(dst + i), vmovn_u32(r));
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = f32_to_bf16(src[i]);
+    }
+}
+
+void core_vector_bf16_to_f32(float* dst, const core_bf16_t* src, size_t n) {
+    size_t i = 0;
+#ifdef QF_WIDTH
+    for (; i + QF_WIDTH <= n; i += QF_WIDTH) {
+        qf_store(dst + i, qf_load_bf16(src + i));
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = bf16_to_f32(src[i]);
+    }
+}
+
+float core_vector_dot_bf16(const core_bf16_t* src1, const core_bf16_t* src2, size_t n) {
+    float sum = 0.0f;
+    size_t i = 0;
+#if defined(__AVX512F__) && defined(__AVX512BF16__)
+    __m512 acc = _mm512_setzero_ps();
+    for (; i + 32 <= n; i += 32) {
+        acc = _mm512_dpbf16_ps(acc, (__m512bh)_mm512_loadu_si512(src1 + i), (__m512bh)_mm512_loadu_si512(src2 + i));
+    }
+    sum = _mm512_reduce_add_ps(acc);
+#elif defined(QF_WIDTH)
+    qf_t acc0 = qf_set1(0.0f), acc1 = qf_set1(0.0f);
+    for (; i + 2 * QF_WIDTH <= n; i += 2 * QF_WIDTH) {
+        acc0 = qf_fma(qf_load_bf16(src1 + i), qf_load_bf16(src2 + i), acc0);
+        acc1 = qf_fma(qf_load_bf16(src1 + i + QF_WIDTH), qf_load_bf16(src2 + i + QF_WIDTH), acc1);
+    }
+    sum = qf_hsum(acc0) + qf_hsum(acc1);
+#endif
+    for (; i < n; ++i) {
+        sum += bf16_to_f32(src1[i]) * bf16_to_f32(src2[i]);
+    }
+    return sum;
+}
+
+void core_convolve_bf16(float* dst, const core_bf16_t* src, size_t src_size,
+                        const core_bf16_t* kernel, size_t kernel_size) {
+    if (kernel_size == 0 || kernel_size > src_size) return;
+    const size_t out_size = src_size - kernel_size + 1;
+    size_t i = 0;
+#ifdef QF_WIDTH
+    // Блок из четырёх регистров выходов; каждый отвод — одно FMA на регистр
+    for (; i + 4 * QF_WIDTH <= out_size; i += 4 * QF_WIDTH) {
+        qf_t acc[4] = {qf_set1(0.0f), qf_set1(0.0f), qf_set1(0.0f), qf_set1(0.0f)};
+        for (size_t j = 0; j < kernel_size; ++j) {
+            const qf_t k = qf_set1(bf16_to_f32(kernel[j]));
+            for (int r = 0; r < 4; ++r) {
+                acc[r] = qf_fma(qf_load_bf16(src + i + j + r * QF_WIDTH), k, acc[r]);
+            }
+        }
+        for (int r = 0; r < 4; ++r) {
+            qf_store(dst + i + r * QF_WIDTH, acc[r]);
+        }
+    }
+#endif
+    for (; i < out_size; ++i) {
+        float sum = 0.0f;
+        for (size_t j = 0; j < kernel_size; ++j) {
+            sum += bf16_to_f32(src[i + j]) * bf16_to_f32(kernel[j]);
+        }
+        dst[i] = sum;
+    }
+}
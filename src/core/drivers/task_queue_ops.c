@@ -0,0 +1,566 @@
+#include "core/drivers/task_queue_ops.h"
+#include "core/drivers/topology_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+// Ограниченная MPMC-очередь Вьюкова. Ячейка с номером позиции p свободна для
+// записи, когда seq == p, и готова к чтению, когда seq == p + 1; прочитавший
+// освобождает её под позицию p + capacity. Производители и потребители
+// соревнуются только за свой счётчик (tail / head) через CAS.
+//
+// Парковка — счётчик событий: владелец объявляет parked, перепроверяет
+// очередь и спит на futex-слове epoch; постановщик после публикации задачи
+// видит parked и увеличивает epoch. Полные барьеры с обеих сторон не дают
+// одновременно пропустить задачу и не увидеть ожидающего.
+
+#define TQ_CACHE_LINE 64
+
+// Метаданные задачи для планировщика; обычная очередь их не заполняет
+typedef struct {
+    uint64_t enqueued_ns;
+    uint64_t deadline_ns;
+} tq_meta_t;
+
+typedef struct {
+    size_t seq;
+    core_task_t task;
+    tq_meta_t meta;
+} tq_cell_t;
+
+struct core_task_queue {
+    size_t head __attribute__((aligned(TQ_CACHE_LINE)));  // следующая позиция чтения
+    size_t tail __attribute__((aligned(TQ_CACHE_LINE)));  // следующая позиция записи
+    uint32_t epoch __attribute__((aligned(TQ_CACHE_LINE)));
+    int parked;
+    tq_cell_t* cells __attribute__((aligned(TQ_CACHE_LINE)));
+    size_t mask;
+    size_t cells_bytes;
+};
+
+int core_task_queue_create(size_t capacity, int node, core_task_queue_t** queue) {
+    if (!queue || capacity == 0 || capacity > ((size_t)1 << (sizeof(size_t) * 8 - 2))) {
+        return CORE_ERR_INVALID;
+    }
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    core_task_queue_t* q = NULL;
+    if (posix_memalign((void**)&q, TQ_CACHE_LINE, sizeof(*q)) != 0) {
+        return CORE_ERR_NOMEM;
+    }
+    memset(q, 0, sizeof(*q));
+    q->mask = size - 1;
+    q->cells_bytes = size * sizeof(tq_cell_t);
+    q->cells = (tq_cell_t*)core_topology_alloc_on_node(q->cells_bytes, node);
+    if (!q->cells) {
+        free(q);
+        return CORE_ERR_NOMEM;
+    }
+    for (size_t i = 0; i < size; ++i) q->cells[i].seq = i;
+    *queue = q;
+    return CORE_SUCCESS;
+}
+
+void core_task_queue_destroy(core_task_queue_t* queue) {
+    if (!queue) {
+        return;
+    }
+    core_topology_free_on_node(queue->cells, queue->cells_bytes);
+    free(queue);
+}
+
+static void tq_futex_wake(uint32_t* epoch) {
+    __atomic_fetch_add(epoch, 1, __ATOMIC_SEQ_CST);
+#if defined(__linux__)
+    syscall(SYS_futex, epoch, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#endif
+}
+
+// Сторона ожидающего в счётчике событий: pending(ctx) перепроверяется уже после
+// объявления parked — позиция, занятая до этого места, видна (в том числе ещё
+// не дописанная), а занятая позже увидит parked и сменит epoch
+static void tq_park_on(uint32_t* epoch_word, int* parked, size_t (*pending)(const void*), const void* ctx,
+                       uint64_t timeout_ns) {
+    uint32_t epoch = __atomic_load_n(epoch_word, __ATOMIC_SEQ_CST);
+    __atomic_store_n(parked, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (pending(ctx) == 0) {
+#if defined(__linux__)
+        struct timespec ts;
+        ts.tv_sec = (time_t)(timeout_ns / 1000000000ull);
+        ts.tv_nsec = (long)(timeout_ns % 1000000000ull);
+        syscall(SYS_futex, epoch_word, FUTEX_WAIT_PRIVATE, epoch, timeout_ns ? &ts : NULL, NULL, 0);
+#else
+        (void)epoch;
+        (void)timeout_ns;
+#endif
+    }
+    __atomic_store_n(parked, 0, __ATOMIC_RELAXED);
+}
+
+// Сторона постановщика: вызывается после публикации задачи
+static void tq_notify(uint32_t* epoch, int* parked) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(parked, __ATOMIC_RELAXED)) {
+        tq_futex_wake(epoch);
+    }
+}
+
+static int tq_push(core_task_queue_t* queue, core_task_t task, tq_meta_t meta) {
+    size_t pos = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    tq_cell_t* cell;
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&queue->tail, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Ячейка ещё не прочитана с прошлого круга — очередь полна
+            return CORE_ERR_NOMEM;
+        } else {
+            pos = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+        }
+    }
+    cell->task = task;
+    cell->meta = meta;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+    return CORE_SUCCESS;
+}
+
+int core_task_queue_push(core_task_queue_t* queue, core_task_t task) {
+    if (!queue || !task.run) {
+        return CORE_ERR_INVALID;
+    }
+    tq_meta_t meta = {0, 0};
+    int status = tq_push(queue, task, meta);
+    if (status != CORE_SUCCESS) {
+        return status;
+    }
+    tq_notify(&queue->epoch, &queue->parked);
+    return CORE_SUCCESS;
+}
+
+// Захват до max подряд готовых ячеек одним CAS головы
+static size_t tq_take(core_task_queue_t* queue, core_task_t* tasks, tq_meta_t* metas, size_t max, int steal) {
+    if (!queue || !tasks || max == 0) {
+        return 0;
+    }
+    size_t pos = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    size_t n;
+    for (;;) {
+        size_t limit = max;
+        if (steal) {
+            size_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+            size_t available = tail > pos ? tail - pos : 0;
+            size_t half = (available + 1) / 2;
+            if (half < limit) limit = half;
+            if (limit == 0) return 0;
+        }
+        n = 0;
+        while (n < limit) {
+            const tq_cell_t* cell = &queue->cells[(pos + n) & queue->mask];
+            if (__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) != pos + n + 1) break;
+            ++n;
+        }
+        if (n == 0) {
+            const tq_cell_t* cell = &queue->cells[pos & queue->mask];
+            intptr_t diff = (intptr_t)__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - (intptr_t)(pos + 1);
+            if (diff < 0) {
+                return 0;  // пусто или производитель ещё не дописал ячейку
+            }
+            pos = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&queue->head, &pos, pos + n, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        tq_cell_t* cell = &queue->cells[(pos + i) & queue->mask];
+        tasks[i] = cell->task;
+        if (metas) metas[i] = cell->meta;
+        __atomic_store_n(&cell->seq, pos + i + queue->mask + 1, __ATOMIC_RELEASE);
+    }
+    return n;
+}
+
+size_t core_task_queue_pop_batch(core_task_queue_t* queue, core_task_t* tasks, size_t max) {
+    return tq_take(queue, tasks, NULL, max, 0);
+}
+
+size_t core_task_queue_steal(core_task_queue_t* victim, core_task_t* tasks, size_t max) {
+    return tq_take(victim, tasks, NULL, max, 1);
+}
+
+size_t core_task_queue_size(const core_task_queue_t* queue) {
+    if (!queue) {
+        return 0;
+    }
+    size_t head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    size_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    return tail > head ? tail - head : 0;
+}
+
+static size_t tq_pending(const void* queue) {
+    return core_task_queue_size((const core_task_queue_t*)queue);
+}
+
+void core_task_queue_park(core_task_queue_t* queue, uint64_t timeout_ns) {
+    if (queue) {
+        tq_park_on(&queue->epoch, &queue->parked, tq_pending, queue, timeout_ns);
+    }
+}
+
+void core_task_queue_wake(core_task_queue_t* queue) {
+    if (queue) {
+        tq_futex_wake(&queue->epoch);
+    }
+}
+
+// Планировщик ядра. Кольца классов общие с ворами; всё, что ниже помечено
+// "владелец", трогает только поток ядра, поэтому без атомиков. Счётчики
+// статистики пополняют и владелец, и воры.
+
+#define TQ_SCHED_CHUNK 64       // задач за одно обращение к кольцу
+#define TQ_DRR_QUANTUM 8        // задач на единицу веса за ход класса
+
+typedef struct {
+    core_task_t task;
+    uint64_t deadline;     // UINT64_MAX — без срока
+    uint64_t enqueued_ns;
+    uint64_t order;        // порядок постановки при равных сроках
+} tq_heap_entry_t;
+
+struct core_task_sched {
+    core_task_queue_t* rings[CORE_SCHED_CLASSES];
+    uint32_t epoch __attribute__((aligned(TQ_CACHE_LINE)));
+    int parked;
+
+    // Владелец: задачи latency по сроку, состояние DRR, время обслуживания
+    tq_heap_entry_t* heap __attribute__((aligned(TQ_CACHE_LINE)));
+    size_t heap_count;     // читается core_task_sched_size из других потоков
+    size_t heap_capacity;
+    size_t heap_bytes;
+    uint64_t heap_order;
+    uint64_t last_served_ns[CORE_SCHED_CLASSES];
+    int drr_class;
+    uint64_t drr_credit;
+    core_sched_config_t config;
+
+    core_sched_stats_t stats __attribute__((aligned(TQ_CACHE_LINE)));
+};
+
+uint64_t core_task_now_ns(void) {
+    struct timespec ts;
+#if defined(__linux__)
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void core_sched_default_config(core_sched_config_t* config) {
+    if (!config) {
+        return;
+    }
+    memset(config, 0, sizeof(*config));
+    config->weights[CORE_SCHED_LATENCY] = 1;
+    config->weights[CORE_SCHED_NORMAL] = 4;
+    config->weights[CORE_SCHED_BATCH] = 1;
+    config->max_wait_ns[CORE_SCHED_NORMAL] = 20000000ull;
+    config->max_wait_ns[CORE_SCHED_BATCH] = 100000000ull;
+}
+
+int core_task_sched_create(const core_sched_config_t* config, size_t capacity, int node,
+                           core_task_sched_t** sched) {
+    if (!sched || capacity == 0) {
+        return CORE_ERR_INVALID;
+    }
+    core_task_sched_t* s = NULL;
+    if (posix_memalign((void**)&s, TQ_CACHE_LINE, sizeof(*s)) != 0) {
+        return CORE_ERR_NOMEM;
+    }
+    memset(s, 0, sizeof(*s));
+    if (config) {
+        s->config = *config;
+    } else {
+        core_sched_default_config(&s->config);
+    }
+
+    int status = CORE_SUCCESS;
+    for (int c = 0; c < CORE_SCHED_CLASSES && status == CORE_SUCCESS; ++c) {
+        status = core_task_queue_create(capacity, node, &s->rings[c]);
+    }
+    if (status == CORE_SUCCESS) {
+        s->heap_capacity = s->rings[CORE_SCHED_LATENCY]->mask + 1;
+        s->heap_bytes = s->heap_capacity * sizeof(tq_heap_entry_t);
+        s->heap = (tq_heap_entry_t*)core_topology_alloc_on_node(s->heap_bytes, node);
+        if (!s->heap) status = CORE_ERR_NOMEM;
+    }
+    if (status != CORE_SUCCESS) {
+        core_task_sched_destroy(s);
+        return status;
+    }
+    uint64_t now = core_task_now_ns();
+    for (int c = 0; c < CORE_SCHED_CLASSES; ++c) s->last_served_ns[c] = now;
+    s->drr_class = CORE_SCHED_NORMAL;
+    *sched = s;
+    return CORE_SUCCESS;
+}
+
+void core_task_sched_destroy(core_task_sched_t* sched) {
+    if (!sched) {
+        return;
+    }
+    for (int c = 0; c < CORE_SCHED_CLASSES; ++c) core_task_queue_destroy(sched->rings[c]);
+    core_topology_free_on_node(sched->heap, sched->heap_bytes);
+    free(sched);
+}
+
+int core_task_sched_push(core_task_sched_t* sched, int sched_class, core_task_t task, uint64_t deadline_ns) {
+    if (!sched || !task.run || sched_class < 0 || sched_class >= CORE_SCHED_CLASSES) {
+        return CORE_ERR_INVALID;
+    }
+    tq_meta_t meta = {core_task_now_ns(), deadline_ns};
+    int status = tq_push(sched->rings[sched_class], task, meta);
+    if (status == CORE_SUCCESS) {
+        tq_notify(&sched->epoch, &sched->parked);
+    }
+    return status;
+}
+
+static void tq_record(core_task_sched_t* s, int c, const tq_meta_t* metas, size_t n, uint64_t now) {
+    core_sched_stats_t* st = &s->stats;
+    uint64_t sum = 0, max = 0, misses = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t delay = now > metas[i].enqueued_ns ? now - metas[i].enqueued_ns : 0;
+        int bucket = delay == 0 ? 0 : 64 - __builtin_clzll(delay);
+        if (bucket >= CORE_SCHED_HIST_BUCKETS) bucket = CORE_SCHED_HIST_BUCKETS - 1;
+        __atomic_fetch_add(&st->delay_hist[c][bucket], 1, __ATOMIC_RELAXED);
+        sum += delay;
+        if (delay > max) max = delay;
+        if (c == CORE_SCHED_LATENCY && metas[i].deadline_ns != 0 && now > metas[i].deadline_ns) ++misses;
+    }
+    __atomic_fetch_add(&st->dispatched[c], n, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&st->delay_sum_ns[c], sum, __ATOMIC_RELAXED);
+    if (misses) __atomic_fetch_add(&st->deadline_misses, misses, __ATOMIC_RELAXED);
+    uint64_t seen = __atomic_load_n(&st->delay_max_ns[c], __ATOMIC_RELAXED);
+    while (max > seen &&
+           !__atomic_compare_exchange_n(&st->delay_max_ns[c], &seen, max, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// Куча по (deadline, order): ближайший срок в корне
+static int tq_heap_less(const tq_heap_entry_t* a, const tq_heap_entry_t* b) {
+    return a->deadline < b->deadline || (a->deadline == b->deadline && a->order < b->order);
+}
+
+static void tq_heap_push(core_task_sched_t* s, tq_heap_entry_t entry) {
+    size_t i = s->heap_count;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!tq_heap_less(&entry, &s->heap[parent])) break;
+        s->heap[i] = s->heap[parent];
+        i = parent;
+    }
+    s->heap[i] = entry;
+    __atomic_store_n(&s->heap_count, s->heap_count + 1, __ATOMIC_RELAXED);
+}
+
+static tq_heap_entry_t tq_heap_pop(core_task_sched_t* s) {
+    tq_heap_entry_t top = s->heap[0];
+    size_t n = s->heap_count - 1;
+    tq_heap_entry_t last = s->heap[n];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && tq_heap_less(&s->heap[child + 1], &s->heap[child])) ++child;
+        if (!tq_heap_less(&s->heap[child], &last)) break;
+        s->heap[i] = s->heap[child];
+        i = child;
+    }
+    if (n > 0) s->heap[i] = last;
+    __atomic_store_n(&s->heap_count, n, __ATOMIC_RELAXED);
+    return top;
+}
+
+// Перекладывает кольцо latency в кучу, пока в ней есть место
+static void tq_refill_heap(core_task_sched_t* s) {
+    core_task_t tasks[TQ_SCHED_CHUNK];
+    tq_meta_t metas[TQ_SCHED_CHUNK];
+    while (s->heap_count < s->heap_capacity) {
+        size_t room = s->heap_capacity - s->heap_count;
+        size_t n = tq_take(s->rings[CORE_SCHED_LATENCY], tasks, metas, room < TQ_SCHED_CHUNK ? room : TQ_SCHED_CHUNK, 0);
+        if (n == 0) break;
+        for (size_t i = 0; i < n; ++i) {
+            tq_heap_entry_t entry = {tasks[i], metas[i].deadline_ns ? metas[i].deadline_ns : UINT64_MAX,
+                                     metas[i].enqueued_ns, s->heap_order++};
+            tq_heap_push(s, entry);
+        }
+    }
+}
+
+static size_t tq_take_class(core_task_sched_t* s, int c, core_task_t* tasks, size_t max, uint64_t now) {
+    tq_meta_t metas[TQ_SCHED_CHUNK];
+    size_t n = tq_take(s->rings[c], tasks, metas, max < TQ_SCHED_CHUNK ? max : TQ_SCHED_CHUNK, 0);
+    if (n > 0) {
+        tq_record(s, c, metas, n, now);
+        s->last_served_ns[c] = now;
+    }
+    return n;
+}
+
+size_t core_task_sched_next(core_task_sched_t* sched, core_task_t* tasks, size_t max) {
+    if (!sched || !tasks || max == 0) {
+        return 0;
+    }
+    core_task_sched_t* s = sched;
+    const uint64_t now = core_task_now_ns();
+    tq_refill_heap(s);
+
+    // Голодание: класс, который ждёт обслуживания дольше порога, идёт первым.
+    // Пустой класс считается только что обслуженным — отсчёт идёт с первой задачи
+    for (int c = CORE_SCHED_NORMAL; c < CORE_SCHED_CLASSES; ++c) {
+        if (core_task_queue_size(s->rings[c]) == 0) {
+            s->last_served_ns[c] = now;
+            continue;
+        }
+        if (s->heap_count > 0 && s->config.max_wait_ns[c] != 0 && now - s->last_served_ns[c] > s->config.max_wait_ns[c]) {
+            size_t n = tq_take_class(s, c, tasks, max, now);
+            if (n > 0) {
+                __atomic_fetch_add(&s->stats.starvation_boosts, 1, __ATOMIC_RELAXED);
+                return n;
+            }
+        }
+    }
+
+    // latency: строгий приоритет, ближайший срок первым
+    if (s->heap_count > 0) {
+        tq_meta_t metas[TQ_SCHED_CHUNK];
+        size_t n = 0;
+        while (n < max && n < TQ_SCHED_CHUNK && s->heap_count > 0) {
+            tq_heap_entry_t entry = tq_heap_pop(s);
+            tasks[n] = entry.task;
+            metas[n].enqueued_ns = entry.enqueued_ns;
+            metas[n].deadline_ns = entry.deadline == UINT64_MAX ? 0 : entry.deadline;
+            ++n;
+        }
+        tq_record(s, CORE_SCHED_LATENCY, metas, n, now);
+        s->last_served_ns[CORE_SCHED_LATENCY] = now;
+        return n;
+    }
+
+    // normal и batch: ход класса длится weight * TQ_DRR_QUANTUM задач; пустой класс
+    // отдаёт ход сразу, поэтому единственный непустой получает всё
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        int c = s->drr_class;
+        if (s->drr_credit == 0) {
+            uint32_t weight = s->config.weights[c] ? s->config.weights[c] : 1;
+            s->drr_credit = (uint64_t)weight * TQ_DRR_QUANTUM;
+        }
+        size_t limit = max < s->drr_credit ? max : (size_t)s->drr_credit;
+        size_t n = tq_take_class(s, c, tasks, limit, now);
+        if (n > 0) {
+            s->drr_credit -= n;
+        }
+        if (n == 0 || s->drr_credit == 0) {
+            s->drr_class = c == CORE_SCHED_NORMAL ? CORE_SCHED_BATCH : CORE_SCHED_NORMAL;
+            s->drr_credit = 0;
+        }
+        if (n > 0) {
+            return n;
+        }
+    }
+    return 0;
+}
+
+size_t core_task_sched_steal(core_task_sched_t* victim, core_task_t* tasks, size_t max) {
+    if (!victim || !tasks || max == 0) {
+        return 0;
+    }
+    tq_meta_t metas[TQ_SCHED_CHUNK];
+    for (int c = 0; c < CORE_SCHED_CLASSES; ++c) {
+        size_t n = tq_take(victim->rings[c], tasks, metas, max < TQ_SCHED_CHUNK ? max : TQ_SCHED_CHUNK, 1);
+        if (n > 0) {
+            tq_record(victim, c, metas, n, core_task_now_ns());
+            return n;
+        }
+    }
+    return 0;
+}
+
+size_t core_task_sched_steal_class(core_task_sched_t* victim, core_task_t* tasks, uint64_t* deadlines,
+                                   size_t max, int* sched_class) {
+    if (!victim || !tasks || max == 0 || !sched_class) {
+        return 0;
+    }
+    tq_meta_t metas[TQ_SCHED_CHUNK];
+    for (int c = 0; c < CORE_SCHED_CLASSES; ++c) {
+        size_t n = tq_take(victim->rings[c], tasks, metas, max < TQ_SCHED_CHUNK ? max : TQ_SCHED_CHUNK, 1);
+        if (n > 0) {
+            for (size_t i = 0; deadlines && i < n; ++i) deadlines[i] = metas[i].deadline_ns;
+            *sched_class = c;
+            return n;
+        }
+    }
+    return 0;
+}
+
+size_t core_task_sched_size(const core_task_sched_t* sched) {
+    if (!sched) {
+        return 0;
+    }
+    size_t total = __atomic_load_n(&sched->heap_count, __ATOMIC_RELAXED);
+    for (int c = 0; c < CORE_SCHED_CLASSES; ++c) total += core_task_queue_size(sched->rings[c]);
+    return total;
+}
+
+static size_t tq_sched_pending(const void* sched) {
+    return core_task_sched_size((const core_task_sched_t*)sched);
+}
+
+void core_task_sched_park(core_task_sched_t* sched, uint64_t timeout_ns) {
+    if (sched) {
+        tq_park_on(&sched->epoch, &sched->parked, tq_sched_pending, sched, timeout_ns);
+    }
+}
+
+void core_task_sched_wake(core_task_sched_t* sched) {
+    if (sched) {
+        tq_futex_wake(&sched->epoch);
+    }
+}
+
+void core_task_sched_stats(const core_task_sched_t* sched, core_sched_stats_t* stats, int accumulate) {
+    if (!sched || !stats) {
+        return;
+    }
+    if (!accumulate) {
+        memset(stats, 0, sizeof(*stats));
+    }
+    const core_sched_stats_t* st = &sched->stats;
+    for (int c = 0; c < CORE_SCHED_CLASSES; ++c) {
+        stats->dispatched[c] += __atomic_load_n(&st->dispatched[c], __ATOMIC_RELAXED);
+        stats->delay_sum_ns[c] += __atomic_load_n(&st->delay_sum_ns[c], __ATOMIC_RELAXED);
+        uint64_t max = __atomic_load_n(&st->delay_max_ns[c], __ATOMIC_RELAXED);
+        if (max > stats->delay_max_ns[c]) stats->delay_max_ns[c] = max;
+        for (int b = 0; b < CORE_SCHED_HIST_BUCKETS; ++b) {
+            stats->delay_hist[c][b] += __atomic_load_n(&st->delay_hist[c][b], __ATOMIC_RELAXED);
+        }
+    }
+    stats->deadline_misses += __atomic_load_n(&st->deadline_misses, __ATOMIC_RELAXED);
+    stats->starvation_boosts += __atomic_load_n(&st->starvation_boosts, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,619 @@
+// cpu_set_t с динамическим размером, sched_getcpu, pthread_*affinity_np
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "core/drivers/topology_ops.h"
+#include "core/threading/affinity.h"
+#include "core/error_handling/core_errors.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+// Режим mempolicy из <numaif.h>; заголовок libnuma не обязателен для сборки
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+
+#if defined(__linux__)
+
+// Чтение первой строки файла root/relative в buf; 0, если файла нет
+static int read_sysfs(const char* root, const char* relative, char* buf, size_t size) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", root, relative);
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return 0;
+    }
+    int ok = fgets(buf, (int)size, f) != NULL;
+    fclose(f);
+    return ok;
+}
+
+static int read_sysfs_int(const char* root, const char* relative, int fallback) {
+    char buf[64];
+    if (!read_sysfs(root, relative, buf, sizeof(buf))) {
+        return fallback;
+    }
+    char* end = NULL;
+    long value = strtol(buf, &end, 10);
+    return end == buf ? fallback : (int)value;
+}
+
+// Список CPU в формате sysfs ("0-3,8,10-11"). Для каждого номера вызывает visit;
+// возвращает наибольший номер или -1 для пустого списка
+static int parse_cpulist(const char* list, void (*visit)(void*, int), void* arg) {
+    int max_cpu = -1;
+    const char* p = list;
+    while (*p) {
+        char* end = NULL;
+        long first = strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for (long cpu = first; cpu <= last && cpu >= 0; ++cpu) {
+            if (visit) visit(arg, (int)cpu);
+            if (cpu > max_cpu) max_cpu = (int)cpu;
+        }
+        if (*p != ',') {
+            break;
+        }
+        ++p;
+    }
+    return max_cpu;
+}
+
+// Номер из имени записи каталога вида prefixN; -1, если имя другое
+static int entry_index(const char* name, const char* prefix) {
+    size_t len = strlen(prefix);
+    if (strncmp(name, prefix, len) != 0 || name[len] < '0' || name[len] > '9') {
+        return -1;
+    }
+    char* end = NULL;
+    long value = strtol(name + len, &end, 10);
+    return *end == '\0' ? (int)value : -1;
+}
+
+typedef struct {
+    signed char* present;  // present[cpu] — CPU в сети
+    int* node_of;          // node_of[cpu] — узел, -1 если не найден
+    int limit;             // размер массивов
+    int node;              // узел текущего cpulist
+} sysfs_scan_t;
+
+static void mark_present(void* arg, int cpu) {
+    sysfs_scan_t* scan = (sysfs_scan_t*)arg;
+    if (cpu < scan->limit) scan->present[cpu] = 1;
+}
+
+static void mark_node(void* arg, int cpu) {
+    sysfs_scan_t* scan = (sysfs_scan_t*)arg;
+    if (cpu < scan->limit) scan->node_of[cpu] = scan->node;
+}
+
+// Список CPU в сети: devices/system/cpu/online, иначе каталоги cpuN
+static int scan_online(const char* root, sysfs_scan_t* scan) {
+    char list[4096];
+    if (read_sysfs(root, "devices/system/cpu/online", list, sizeof(list))) {
+        int max_cpu = parse_cpulist(list, NULL, NULL);
+        if (max_cpu < 0) {
+            return CORE_ERR_NOTFOUND;
+        }
+        scan->limit = max_cpu + 1;
+        scan->present = (signed char*)calloc((size_t)scan->limit, 1);
+        if (!scan->present) {
+            return CORE_ERR_NOMEM;
+        }
+        parse_cpulist(list, mark_present, scan);
+        return CORE_SUCCESS;
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/devices/system/cpu", root);
+    for (int pass = 0; pass < 2; ++pass) {
+        DIR* dir = opendir(path);
+        if (!dir) {
+            return CORE_ERR_NOTFOUND;
+        }
+        int max_cpu = -1;
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL) {
+            int cpu = entry_index(entry->d_name, "cpu");
+            if (cpu < 0) continue;
+            if (pass == 0 && cpu > max_cpu) max_cpu = cpu;
+            if (pass == 1) mark_present(scan, cpu);
+        }
+        closedir(dir);
+        if (pass == 0) {
+            if (max_cpu < 0) {
+                return CORE_ERR_NOTFOUND;
+            }
+            scan->limit = max_cpu + 1;
+            scan->present = (signed char*)calloc((size_t)scan->limit, 1);
+            if (!scan->present) {
+                return CORE_ERR_NOMEM;
+            }
+        }
+    }
+    return CORE_SUCCESS;
+}
+
+// Узлы из devices/system/node/nodeN/cpulist; без каталога node все CPU на узле 0
+static void scan_nodes(const char* root, sysfs_scan_t* scan) {
+    for (int cpu = 0; cpu < scan->limit; ++cpu) scan->node_of[cpu] = -1;
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/devices/system/node", root);
+    DIR* dir = opendir(path);
+    if (!dir) {
+        return;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        int node = entry_index(entry->d_name, "node");
+        if (node < 0) continue;
+        char relative[128], list[4096];
+        snprintf(relative, sizeof(relative), "devices/system/node/node%d/cpulist", node);
+        if (!read_sysfs(root, relative, list, sizeof(list))) continue;
+        scan->node = node;
+        parse_cpulist(list, mark_node, scan);
+    }
+    closedir(dir);
+}
+
+#endif
+
+int core_topology_detect(const char* sysfs_root, core_topology_t* topology) {
+    if (!topology) {
+        return CORE_ERR_INVALID;
+    }
+    memset(topology, 0, sizeof(*topology));
+#if defined(__linux__)
+    const char* root = sysfs_root ? sysfs_root : "/sys";
+    sysfs_scan_t scan = {NULL, NULL, 0, 0};
+    int status = scan_online(root, &scan);
+    if (status != CORE_SUCCESS) {
+        return status;
+    }
+
+    size_t num_cpus = 0;
+    for (int cpu = 0; cpu < scan.limit; ++cpu) num_cpus += scan.present[cpu] != 0;
+    // Ключ физического ядра: package, die, core_id; без core_id — сам CPU
+    int* keys = (int*)malloc(num_cpus * 3 * sizeof(int));
+    scan.node_of = (int*)malloc((size_t)scan.limit * sizeof(int));
+    topology->cpus = (core_cpu_desc_t*)calloc(num_cpus, sizeof(core_cpu_desc_t));
+    if (!keys || !scan.node_of || !topology->cpus) {
+        free(keys);
+        free(scan.node_of);
+        free(scan.present);
+        core_topology_free(topology);
+        return CORE_ERR_NOMEM;
+    }
+    scan_nodes(root, &scan);
+
+    // Маска не короче маски ядра ОС, иначе sched_getaffinity вернёт EINVAL
+    int mask_cpus = scan.limit > CPU_SETSIZE ? scan.limit : CPU_SETSIZE;
+    cpu_set_t* allowed = NULL;
+    size_t allowed_size = CPU_ALLOC_SIZE(mask_cpus);
+    if (!sysfs_root) {
+        allowed = CPU_ALLOC(mask_cpus);
+        if (allowed && sched_getaffinity(0, allowed_size, allowed) != 0) {
+            CPU_FREE(allowed);
+            allowed = NULL;
+        }
+    }
+
+    size_t n = 0;
+    int max_node = 0, max_package = 0;
+    for (int cpu = 0; cpu < scan.limit; ++cpu) {
+        if (!scan.present[cpu]) continue;
+        char relative[128];
+        core_cpu_desc_t* desc = &topology->cpus[n];
+        desc->cpu = cpu;
+        snprintf(relative, sizeof(relative), "devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        desc->package = read_sysfs_int(root, relative, 0);
+        if (desc->package < 0) desc->package = 0;
+        snprintf(relative, sizeof(relative), "devices/system/cpu/cpu%d/topology/die_id", cpu);
+        int die = read_sysfs_int(root, relative, 0);
+        snprintf(relative, sizeof(relative), "devices/system/cpu/cpu%d/topology/core_id", cpu);
+        int core_id = read_sysfs_int(root, relative, -1);
+        keys[n * 3] = desc->package;
+        keys[n * 3 + 1] = core_id < 0 ? -1 - cpu : die;
+        keys[n * 3 + 2] = core_id < 0 ? 0 : core_id;
+
+        desc->node = scan.node_of[cpu] < 0 ? 0 : scan.node_of[cpu];
+        desc->allowed = allowed ? CPU_ISSET_S(cpu, allowed_size, allowed) != 0 : 1;
+        if (desc->node > max_node) max_node = desc->node;
+        if (desc->package > max_package) max_package = desc->package;
+
+        // Плотный индекс ядра по первому CPU с тем же ключом
+        desc->core = -1;
+        desc->smt_index = 0;
+        for (size_t j = 0; j < n; ++j) {
+            if (keys[j * 3] == keys[n * 3] && keys[j * 3 + 1] == keys[n * 3 + 1] &&
+                keys[j * 3 + 2] == keys[n * 3 + 2]) {
+                if (desc->core < 0) desc->core = topology->cpus[j].core;
+                ++desc->smt_index;
+            }
+        }
+        if (desc->core < 0) desc->core = (int)topology->num_cores++;
+        if ((size_t)desc->smt_index + 1 > topology->threads_per_core) {
+            topology->threads_per_core = (size_t)desc->smt_index + 1;
+        }
+        ++n;
+    }
+    topology->num_cpus = n;
+    topology->num_nodes = (size_t)max_node + 1;
+    topology->num_packages = (size_t)max_package + 1;
+
+    if (allowed) CPU_FREE(allowed);
+    free(keys);
+    free(scan.node_of);
+    free(scan.present);
+    return CORE_SUCCESS;
+#else
+    (void)sysfs_root;
+    return CORE_ERR_UNSUPPORTED;
+#endif
+}
+
+void core_topology_free(core_topology_t* topology) {
+    if (!topology) {
+        return;
+    }
+    free(topology->cpus);
+    memset(topology, 0, sizeof(*topology));
+}
+
+#if defined(__linux__)
+static core_topology_t system_topology;
+static int system_topology_status = CORE_ERR_NOTFOUND;
+
+static void detect_system_topology_once() {
+    system_topology_status = core_topology_detect(NULL, &system_topology);
+}
+#endif
+
+const core_topology_t* core_topology_system() {
+#if defined(__linux__)
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, detect_system_topology_once);
+    return system_topology_status == CORE_SUCCESS ? &system_topology : NULL;
+#else
+    return NULL;
+#endif
+}
+
+// Состояние планировщика: занятость физических ядер и логических CPU
+typedef struct {
+    const core_topology_t* topology;
+    int* core_users;      // потоков плана на физическом ядре
+    int* core_reserved;   // ядро отдано latency-critical потоку
+    int* core_node;
+    int* core_allowed;    // разрешённых CPU на ядре
+    int* cpu_users;       // потоков плана на логическом CPU (индекс в cpus)
+} place_state_t;
+
+static int free_cores_on_node(const place_state_t* s, int node) {
+    int count = 0;
+    for (size_t c = 0; c < s->topology->num_cores; ++c) {
+        count += s->core_node[c] == node && s->core_users[c] == 0 && s->core_allowed[c] > 0;
+    }
+    return count;
+}
+
+// Разрешённый CPU ядра с наименьшим числом потоков плана; без smt — первый
+// разрешённый, чтобы переподписка не занимала ещё один SMT-поток
+static size_t least_used_cpu(const place_state_t* s, int core, int smt) {
+    size_t best = s->topology->num_cpus;
+    for (size_t i = 0; i < s->topology->num_cpus; ++i) {
+        const core_cpu_desc_t* d = &s->topology->cpus[i];
+        if (d->core != core || !d->allowed) continue;
+        if (best == s->topology->num_cpus) best = i;
+        else if (smt && s->cpu_users[i] < s->cpu_users[best]) best = i;
+    }
+    return best;
+}
+
+// Свободное физическое ядро узла: индекс в cpus его первого разрешённого CPU
+static size_t find_free_core(const place_state_t* s, int node) {
+    for (size_t c = 0; c < s->topology->num_cores; ++c) {
+        if (s->core_node[c] == node && s->core_users[c] == 0 && s->core_allowed[c] > 0) {
+            return least_used_cpu(s, (int)c, 0);
+        }
+    }
+    return s->topology->num_cpus;
+}
+
+// Свободный SMT-поток на ядре узла, уже занятом не latency-critical потоком
+static size_t find_free_thread(const place_state_t* s, int node) {
+    for (size_t i = 0; i < s->topology->num_cpus; ++i) {
+        const core_cpu_desc_t* d = &s->topology->cpus[i];
+        if (d->node == node && d->allowed && s->cpu_users[i] == 0 && !s->core_reserved[d->core]) {
+            return i;
+        }
+    }
+    return s->topology->num_cpus;
+}
+
+// Наименее загруженное ядро (узла node или любого при node < 0), не отданные
+// latency-critical ядра предпочтительнее
+static size_t find_oversubscribed(const place_state_t* s, int node, int smt) {
+    int best = -1;
+    for (size_t c = 0; c < s->topology->num_cores; ++c) {
+        if (s->core_allowed[c] == 0 || (node >= 0 && s->core_node[c] != node)) continue;
+        if (best < 0 || s->core_reserved[c] < s->core_reserved[best] ||
+            (s->core_reserved[c] == s->core_reserved[best] && s->core_users[c] < s->core_users[best])) {
+            best = (int)c;
+        }
+    }
+    return best < 0 ? s->topology->num_cpus : least_used_cpu(s, best, smt);
+}
+
+static void place_one(place_state_t* s, const core_place_request_t* request, core_placement_t* placement) {
+    const core_topology_t* t = s->topology;
+    const int num_nodes = (int)t->num_nodes;
+    const int wanted = request->numa_node >= 0 && request->numa_node < num_nodes ? request->numa_node : -1;
+    const int smt = request->allow_smt && !request->latency_critical;
+
+    // Домашний узел: запрошенный, иначе с наибольшим числом свободных ядер
+    int home = wanted;
+    if (home < 0) {
+        int best_free = -1;
+        for (int node = 0; node < num_nodes; ++node) {
+            int free_cores = free_cores_on_node(s, node);
+            if (free_cores > best_free) {
+                best_free = free_cores;
+                home = node;
+            }
+        }
+    }
+
+    size_t chosen = find_free_core(s, home);
+    if (chosen == t->num_cpus && smt) chosen = find_free_thread(s, home);
+    // Чужой узел: с наибольшим числом свободных ядер, затем свободные SMT-потоки
+    if (chosen == t->num_cpus) {
+        int node = -1, best_free = 0;
+        for (int candidate = 0; candidate < num_nodes; ++candidate) {
+            int free_cores = candidate == home ? 0 : free_cores_on_node(s, candidate);
+            if (free_cores > best_free) {
+                best_free = free_cores;
+                node = candidate;
+            }
+        }
+        if (node >= 0) {
+            chosen = find_free_core(s, node);
+        } else if (smt) {
+            for (node = 0; node < num_nodes && chosen == t->num_cpus; ++node) {
+                if (node != home) chosen = find_free_thread(s, node);
+            }
+        }
+    }
+
+    int oversubscribed = 0;
+    if (chosen == t->num_cpus) {
+        chosen = find_oversubscribed(s, home, smt);
+        if (chosen == t->num_cpus) chosen = find_oversubscribed(s, -1, smt);
+        oversubscribed = 1;
+    }
+
+    const core_cpu_desc_t* d = &t->cpus[chosen];
+    s->cpu_users[chosen]++;
+    s->core_users[d->core]++;
+    if (request->latency_critical && !oversubscribed) s->core_reserved[d->core] = 1;
+    placement->cpu = d->cpu;
+    placement->core = d->core;
+    placement->node = d->node;
+    placement->fallback = oversubscribed || (wanted >= 0 && d->node != wanted) ||
+                          (request->numa_node >= num_nodes);
+}
+
+int core_topology_place(const core_topology_t* topology, const core_place_request_t* requests,
+                        size_t count, core_placement_t* placements) {
+    if (!topology || (count > 0 && (!requests || !placements))) {
+        return CORE_ERR_INVALID;
+    }
+    if (count == 0) {
+        return CORE_SUCCESS;
+    }
+
+    place_state_t s;
+    s.topology = topology;
+    size_t cores = topology->num_cores;
+    int* counters = (int*)calloc(cores * 4 + topology->num_cpus, sizeof(int));
+    if (!counters) {
+        return CORE_ERR_NOMEM;
+    }
+    s.core_users = counters;
+    s.core_reserved = counters + cores;
+    s.core_node = counters + cores * 2;
+    s.core_allowed = counters + cores * 3;
+    s.cpu_users = counters + cores * 4;
+    for (size_t i = 0; i < topology->num_cpus; ++i) {
+        const core_cpu_desc_t* d = &topology->cpus[i];
+        if (d->smt_index == 0) s.core_node[d->core] = d->node;
+        s.core_allowed[d->core] += d->allowed != 0;
+    }
+    int any_allowed = 0;
+    for (size_t c = 0; c < cores; ++c) any_allowed |= s.core_allowed[c] > 0;
+    if (!any_allowed) {
+        free(counters);
+        return CORE_ERR_NOTFOUND;
+    }
+
+    // Сначала latency-critical: им нужны целые ядра, пока они есть
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = 0; i < count; ++i) {
+            if ((requests[i].latency_critical != 0) == (pass == 0)) {
+                place_one(&s, &requests[i], &placements[i]);
+            }
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        placements[i].exclusive = s.core_users[placements[i].core] == 1;
+    }
+    free(counters);
+    return CORE_SUCCESS;
+}
+
+int core_topology_bind_current(const core_topology_t* topology, int cpu) {
+    if (cpu < 0) {
+        return CORE_ERR_INVALID;
+    }
+#if defined(__linux__)
+    cpu_set_t* set = CPU_ALLOC(cpu + 1);
+    if (!set) {
+        return CORE_ERR_NOMEM;
+    }
+    size_t set_size = CPU_ALLOC_SIZE(cpu + 1);
+    CPU_ZERO_S(set_size, set);
+    CPU_SET_S(cpu, set_size, set);
+    int rc = pthread_setaffinity_np(pthread_self(), set_size, set);
+    CPU_FREE(set);
+    if (rc != 0) {
+        return CORE_ERR_INVALID;
+    }
+
+#if defined(SYS_set_mempolicy)
+    // Узел CPU — предпочтительный для новых страниц потока; отказ (ядро без
+    // NUMA, узла нет в системе) не мешает привязке
+    int node = -1;
+    for (size_t i = 0; topology && i < topology->num_cpus; ++i) {
+        if (topology->cpus[i].cpu == cpu) node = topology->cpus[i].node;
+    }
+    if (node >= 0 && topology->num_nodes > 1) {
+        unsigned long mask[(1024 + 8 * sizeof(unsigned long) - 1) / (8 * sizeof(unsigned long))] = {0};
+        if ((size_t)node < 8 * sizeof(mask)) {
+            mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+            syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, 8 * sizeof(mask) + 1);
+        }
+    }
+#else
+    (void)topology;
+#endif
+    return CORE_SUCCESS;
+#else
+    (void)topology;
+    return CORE_ERR_UNSUPPORTED;
+#endif
+}
+
+void* core_topology_alloc_on_node(size_t size, int node) {
+    if (size == 0) {
+        return NULL;
+    }
+#if defined(__linux__)
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t length = (size + page - 1) / page * page;
+    void* ptr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+#if defined(SYS_mbind)
+    if (node >= 0 && node < 1024) {
+        unsigned long mask[1024 / (8 * sizeof(unsigned long))] = {0};
+        mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+        syscall(SYS_mbind, ptr, length, MPOL_PREFERRED, mask, 8 * sizeof(mask) + 1, 0);
+    }
+#else
+    (void)node;
+#endif
+    return ptr;
+#else
+    (void)node;
+    return malloc(size);
+#endif
+}
+
+void core_topology_free_on_node(void* ptr, size_t size) {
+    if (!ptr) {
+        return;
+    }
+#if defined(__linux__)
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    munmap(ptr, (size + page - 1) / page * page);
+#else
+    (void)size;
+    free(ptr);
+#endif
+}
+
+size_t core_topology_format_placement(const core_placement_t* placements, size_t count,
+                                      char* buffer, size_t buffer_size) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const core_placement_t* p = &placements[i];
+        char* dst = buffer && total < buffer_size ? buffer + total : NULL;
+        size_t room = dst ? buffer_size - total : 0;
+        int written = snprintf(dst, room, "worker %zu: cpu %d core %d node %d %s%s\n", i, p->cpu, p->core,
+                               p->node, p->exclusive ? "exclusive" : "shared", p->fallback ? " fallback" : "");
+        if (written > 0) total += (size_t)written;
+    }
+    if (buffer && buffer_size > 0 && total == 0) buffer[0] = '\0';
+    return total;
+}
+
+// NUMA и affinity API (threading/affinity.h) поверх системной топологии
+
+int core_set_thread_affinity(size_t cpu_id) {
+    return core_topology_bind_current(core_topology_system(), (int)cpu_id);
+}
+
+int core_get_thread_affinity(size_t* cpu_id) {
+    if (!cpu_id) {
+        return CORE_ERR_INVALID;
+    }
+#if defined(__linux__)
+    // Привязанный к одному CPU поток сообщает его, иначе — CPU, на котором он сейчас
+    const core_topology_t* topology = core_topology_system();
+    int limit = topology && topology->num_cpus ? topology->cpus[topology->num_cpus - 1].cpu + 1 : 0;
+    if (limit < CPU_SETSIZE) limit = CPU_SETSIZE;
+    cpu_set_t* set = CPU_ALLOC(limit);
+    size_t set_size = CPU_ALLOC_SIZE(limit);
+    if (set && pthread_getaffinity_np(pthread_self(), set_size, set) == 0 && CPU_COUNT_S(set_size, set) == 1) {
+        for (int cpu = 0; cpu < limit; ++cpu) {
+            if (CPU_ISSET_S(cpu, set_size, set)) {
+                *cpu_id = (size_t)cpu;
+                CPU_FREE(set);
+                return CORE_SUCCESS;
+            }
+        }
+    }
+    if (set) CPU_FREE(set);
+    int cpu = sched_getcpu();
+    if (cpu < 0) {
+        return CORE_ERR_INTERNAL;
+    }
+    *cpu_id = (size_t)cpu;
+    return CORE_SUCCESS;
+#else
+    return CORE_ERR_UNSUPPORTED;
+#endif
+}
+
+int core_numa_node_of_cpu(size_t cpu_id) {
+    const core_topology_t* topology = core_topology_system();
+    for (size_t i = 0; topology && i < topology->num_cpus; ++i) {
+        if ((size_t)topology->cpus[i].cpu == cpu_id) return topology->cpus[i].node;
+    }
+    return -1;
+}
+
+size_t core_num_numa_nodes() {
+    const core_topology_t* topology = core_topology_system();
+    return topology ? topology->num_nodes : 1;
+}
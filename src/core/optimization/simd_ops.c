@@ -1,57 +1,858 @@
 #include "core/optimization/simd_ops.h"
-#if defined(__AVX2__)
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE4_2__)
 #include <immintrin.h>
 #endif
 #if defined(__ARM_NEON)
 #include <arm_neon.h>
 #endif
+#include <math.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
+// Тонкий слой абстракции над набором инструкций: каждое ядро ниже написано
+// один раз в терминах vf_* (float), vi_* (int32) и vl_* (int64-аккумулятор).
+// Хвосты загружаются с заполнением значением fill, чтобы редукции получали
+// нейтральный элемент, а записываются только первые n элементов.
+
+#if defined(__AVX512F__)
+
+#define SIMD_ISA CORE_SIMD_ISA_AVX512
+#define SIMD_ISA_NAME "avx512"
+#define VF_WIDTH 16
+typedef __m512 vf_t;
+typedef __m512i vi_t;
+typedef __m512i vl_t;
+
+static inline __mmask16 simd_tail_mask(size_t n) { return (__mmask16)((1u << n) - 1u); }
+
+static inline vf_t vf_load(const float* p) { return _mm512_loadu_ps(p); }
+static inline vf_t vf_load_tail(const float* p, size_t n, float fill) {
+    return _mm512_mask_loadu_ps(_mm512_set1_ps(fill), simd_tail_mask(n), p);
+}
+static inline void vf_store(float* p, vf_t v) { _mm512_storeu_ps(p, v); }
+static inline void vf_store_tail(float* p, vf_t v, size_t n) { _mm512_mask_storeu_ps(p, simd_tail_mask(n), v); }
+static inline vf_t vf_set1(float x) { return _mm512_set1_ps(x); }
+static inline vf_t vf_add(vf_t a, vf_t b) { return _mm512_add_ps(a, b); }
+static inline vf_t vf_sub(vf_t a, vf_t b) { return _mm512_sub_ps(a, b); }
+static inline vf_t vf_mul(vf_t a, vf_t b) { return _mm512_mul_ps(a, b); }
+static inline vf_t vf_min(vf_t a, vf_t b) { return _mm512_min_ps(a, b); }
+static inline vf_t vf_max(vf_t a, vf_t b) { return _mm512_max_ps(a, b); }
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) { return _mm512_fmadd_ps(a, b, c); }
+static inline vf_t vf_abs(vf_t a) {
+    return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_set1_epi32(0x7FFFFFFF)));
+}
+static inline float vf_hsum(vf_t v) { return _mm512_reduce_add_ps(v); }
+static inline float vf_hmin(vf_t v) { return _mm512_reduce_min_ps(v); }
+static inline float vf_hmax(vf_t v) { return _mm512_reduce_max_ps(v); }
+static inline uint32_t vf_cmp(vf_t a, vf_t b, int op) {
+    switch (op) {
+        case CORE_CMP_EQ: return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+        case CORE_CMP_NE: return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ);
+        case CORE_CMP_LT: return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+        case CORE_CMP_LE: return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ);
+        case CORE_CMP_GT: return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ);
+        case CORE_CMP_GE: return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ);
+        default: return 0;
+    }
+}
+// Сдвиг на k элементов к старшим индексам с заполнением нулями
+static inline __m512i simd_shift_up_epi32(__m512i x, int k) {
+    const __m512i zero = _mm512_setzero_si512();
+    switch (k) {
+        case 1: return _mm512_alignr_epi32(x, zero, 15);
+        case 2: return _mm512_alignr_epi32(x, zero, 14);
+        case 4: return _mm512_alignr_epi32(x, zero, 12);
+        default: return _mm512_alignr_epi32(x, zero, 8);
+    }
+}
+static inline vf_t vf_scan(vf_t x) {
+    for (int k = 1; k < VF_WIDTH; k <<= 1) {
+        x = _mm512_add_ps(x, _mm512_castsi512_ps(simd_shift_up_epi32(_mm512_castps_si512(x), k)));
+    }
+    return x;
+}
+static inline vf_t vf_broadcast_last(vf_t v) { return _mm512_permutexvar_ps(_mm512_set1_epi32(15), v); }
+
+static inline vi_t vi_load(const int32_t* p) { return _mm512_loadu_si512((const void*)p); }
+static inline vi_t vi_load_tail(const int32_t* p, size_t n, int32_t fill) {
+    return _mm512_mask_loadu_epi32(_mm512_set1_epi32(fill), simd_tail_mask(n), p);
+}
+static inline void vi_store(int32_t* p, vi_t v) { _mm512_storeu_si512((void*)p, v); }
+static inline void vi_store_tail(int32_t* p, vi_t v, size_t n) { _mm512_mask_storeu_epi32(p, simd_tail_mask(n), v); }
+static inline vi_t vi_set1(int32_t x) { return _mm512_set1_epi32(x); }
+static inline vi_t vi_add(vi_t a, vi_t b) { return _mm512_add_epi32(a, b); }
+static inline vi_t vi_sub(vi_t a, vi_t b) { return _mm512_sub_epi32(a, b); }
+static inline vi_t vi_mul(vi_t a, vi_t b) { return _mm512_mullo_epi32(a, b); }
+static inline vi_t vi_min(vi_t a, vi_t b) { return _mm512_min_epi32(a, b); }
+static inline vi_t vi_max(vi_t a, vi_t b) { return _mm512_max_epi32(a, b); }
+static inline vi_t vi_abs(vi_t a) { return _mm512_abs_epi32(a); }
+static inline int32_t vi_hmin(vi_t v) { return _mm512_reduce_min_epi32(v); }
+static inline int32_t vi_hmax(vi_t v) { return _mm512_reduce_max_epi32(v); }
+static inline vi_t vi_scan(vi_t x) {
+    for (int k = 1; k < VF_WIDTH; k <<= 1) {
+        x = _mm512_add_epi32(x, simd_shift_up_epi32(x, k));
+    }
+    return x;
+}
+static inline vi_t vi_broadcast_last(vi_t v) { return _mm512_permutexvar_epi32(_mm512_set1_epi32(15), v); }
+
+static inline vl_t vl_zero() { return _mm512_setzero_si512(); }
+static inline vl_t vl_acc(vl_t acc, vi_t v) {
+    acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(v)));
+    return _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1)));
+}
+static inline int64_t vl_hsum(vl_t acc) { return _mm512_reduce_add_epi64(acc); }
+
+#elif defined(__AVX2__)
+
+#define SIMD_ISA CORE_SIMD_ISA_AVX2
+#define SIMD_ISA_NAME "avx2"
+#define VF_WIDTH 8
+typedef __m256 vf_t;
+typedef __m256i vi_t;
+typedef __m256i vl_t;
+
+// Окно из 8 единичных и 8 нулевых слов: маска хвоста длины n начинается с 8 - n
+static const int32_t simd_tail_table[16] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0
+};
+static inline __m256i simd_tail_mask(size_t n) {
+    return _mm256_loadu_si256((const __m256i*)&simd_tail_table[8 - n]);
+}
+
+static inline vf_t vf_load(const float* p) { return _mm256_loadu_ps(p); }
+static inline vf_t vf_load_tail(const float* p, size_t n, float fill) {
+    __m256i m = simd_tail_mask(n);
+    return _mm256_blendv_ps(_mm256_set1_ps(fill), _mm256_maskload_ps(p, m), _mm256_castsi256_ps(m));
+}
+static inline void vf_store(float* p, vf_t v) { _mm256_storeu_ps(p, v); }
+static inline void vf_store_tail(float* p, vf_t v, size_t n) { _mm256_maskstore_ps(p, simd_tail_mask(n), v); }
+static inline vf_t vf_set1(float x) { return _mm256_set1_ps(x); }
+static inline vf_t vf_add(vf_t a, vf_t b) { return _mm256_add_ps(a, b); }
+static inline vf_t vf_sub(vf_t a, vf_t b) { return _mm256_sub_ps(a, b); }
+static inline vf_t vf_mul(vf_t a, vf_t b) { return _mm256_mul_ps(a, b); }
+static inline vf_t vf_min(vf_t a, vf_t b) { return _mm256_min_ps(a, b); }
+static inline vf_t vf_max(vf_t a, vf_t b) { return _mm256_max_ps(a, b); }
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) {
+#if defined(__FMA__)
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+static inline vf_t vf_abs(vf_t a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+static inline __m128 simd_hreduce_ps(vf_t v, __m128 (*op)(__m128, __m128)) {
+    __m128 r = op(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    r = op(r, _mm_movehl_ps(r, r));
+    return op(r, _mm_shuffle_ps(r, r, 0x55));
+}
+static inline __m128 simd_add128(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+static inline __m128 simd_min128(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+static inline __m128 simd_max128(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+static inline float vf_hsum(vf_t v) { return _mm_cvtss_f32(simd_hreduce_ps(v, simd_add128)); }
+static inline float vf_hmin(vf_t v) { return _mm_cvtss_f32(simd_hreduce_ps(v, simd_min128)); }
+static inline float vf_hmax(vf_t v) { return _mm_cvtss_f32(simd_hreduce_ps(v, simd_max128)); }
+static inline uint32_t vf_cmp(vf_t a, vf_t b, int op) {
+    switch (op) {
+        case CORE_CMP_EQ: return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+        case CORE_CMP_NE: return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_NEQ_UQ));
+        case CORE_CMP_LT: return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+        case CORE_CMP_LE: return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ));
+        case CORE_CMP_GT: return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ));
+        case CORE_CMP_GE: return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ));
+        default: return 0;
+    }
+}
+// Сканирование внутри 128-битных половин, затем перенос старшего элемента
+// нижней половины в верхнюю
+static inline vf_t vf_scan(vf_t x) {
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+    __m256 carry = _mm256_permute_ps(x, 0xFF);
+    return _mm256_add_ps(x, _mm256_permute2f128_ps(carry, carry, 0x08));
+}
+static inline vf_t vf_broadcast_last(vf_t v) {
+    return _mm256_permute_ps(_mm256_permute2f128_ps(v, v, 0x11), 0xFF);
+}
+
+static inline vi_t vi_load(const int32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+static inline vi_t vi_load_tail(const int32_t* p, size_t n, int32_t fill) {
+    __m256i m = simd_tail_mask(n);
+    return _mm256_blendv_epi8(_mm256_set1_epi32(fill), _mm256_maskload_epi32(p, m), m);
+}
+static inline void vi_store(int32_t* p, vi_t v) { _mm256_storeu_si256((__m256i*)p, v); }
+static inline void vi_store_tail(int32_t* p, vi_t v, size_t n) { _mm256_maskstore_epi32(p, simd_tail_mask(n), v); }
+static inline vi_t vi_set1(int32_t x) { return _mm256_set1_epi32(x); }
+static inline vi_t vi_add(vi_t a, vi_t b) { return _mm256_add_epi32(a, b); }
+static inline vi_t vi_sub(vi_t a, vi_t b) { return _mm256_sub_epi32(a, b); }
+static inline vi_t vi_mul(vi_t a, vi_t b) { return _mm256_mullo_epi32(a, b); }
+static inline vi_t vi_min(vi_t a, vi_t b) { return _mm256_min_epi32(a, b); }
+static inline vi_t vi_max(vi_t a, vi_t b) { return _mm256_max_epi32(a, b); }
+static inline vi_t vi_abs(vi_t a) { return _mm256_abs_epi32(a); }
+static inline int32_t vi_hmin(vi_t v) {
+    __m128i r = _mm_min_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    r = _mm_min_epi32(r, _mm_shuffle_epi32(r, 0x4E));
+    return _mm_cvtsi128_si32(_mm_min_epi32(r, _mm_shuffle_epi32(r, 0xB1)));
+}
+static inline int32_t vi_hmax(vi_t v) {
+    __m128i r = _mm_max_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    r = _mm_max_epi32(r, _mm_shuffle_epi32(r, 0x4E));
+    return _mm_cvtsi128_si32(_mm_max_epi32(r, _mm_shuffle_epi32(r, 0xB1)));
+}
+static inline vi_t vi_scan(vi_t x) {
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+    __m256i carry = _mm256_shuffle_epi32(x, 0xFF);
+    return _mm256_add_epi32(x, _mm256_permute2x128_si256(carry, carry, 0x08));
+}
+static inline vi_t vi_broadcast_last(vi_t v) {
+    return _mm256_shuffle_epi32(_mm256_permute2x128_si256(v, v, 0x11), 0xFF);
+}
+
+static inline vl_t vl_zero() { return _mm256_setzero_si256(); }
+static inline vl_t vl_acc(vl_t acc, vi_t v) {
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+    return _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+}
+static inline int64_t vl_hsum(vl_t acc) {
+    __m128i r = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    return _mm_cvtsi128_si64(r) + _mm_extract_epi64(r, 1);
+}
+
+#elif defined(__SSE4_2__)
+
+#define SIMD_ISA CORE_SIMD_ISA_SSE42
+#define SIMD_ISA_NAME "sse4.2"
+#define VF_WIDTH 4
+#define SIMD_BUFFERED_TAIL 1
+typedef __m128 vf_t;
+typedef __m128i vi_t;
+typedef __m128i vl_t;
+
+static inline vf_t vf_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void vf_store(float* p, vf_t v) { _mm_storeu_ps(p, v); }
+static inline vf_t vf_set1(float x) { return _mm_set1_ps(x); }
+static inline vf_t vf_add(vf_t a, vf_t b) { return _mm_add_ps(a, b); }
+static inline vf_t vf_sub(vf_t a, vf_t b) { return _mm_sub_ps(a, b); }
+static inline vf_t vf_mul(vf_t a, vf_t b) { return _mm_mul_ps(a, b); }
+static inline vf_t vf_min(vf_t a, vf_t b) { return _mm_min_ps(a, b); }
+static inline vf_t vf_max(vf_t a, vf_t b) { return _mm_max_ps(a, b); }
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) {
+#if defined(__FMA__)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+static inline vf_t vf_abs(vf_t a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline float vf_hsum(vf_t v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(v, _mm_shuffle_ps(v, v, 0x55)));
+}
+static inline float vf_hmin(vf_t v) {
+    v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_min_ss(v, _mm_shuffle_ps(v, v, 0x55)));
+}
+static inline float vf_hmax(vf_t v) {
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_max_ss(v, _mm_shuffle_ps(v, v, 0x55)));
+}
+static inline uint32_t vf_cmp(vf_t a, vf_t b, int op) {
+    switch (op) {
+        case CORE_CMP_EQ: return (uint32_t)_mm_movemask_ps(_mm_cmpeq_ps(a, b));
+        case CORE_CMP_NE: return (uint32_t)_mm_movemask_ps(_mm_cmpneq_ps(a, b));
+        case CORE_CMP_LT: return (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(a, b));
+        case CORE_CMP_LE: return (uint32_t)_mm_movemask_ps(_mm_cmple_ps(a, b));
+        case CORE_CMP_GT: return (uint32_t)_mm_movemask_ps(_mm_cmpgt_ps(a, b));
+        case CORE_CMP_GE: return (uint32_t)_mm_movemask_ps(_mm_cmpge_ps(a, b));
+        default: return 0;
+    }
+}
+static inline vf_t vf_scan(vf_t x) {
+    x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)));
+    return _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)));
+}
+static inline vf_t vf_broadcast_last(vf_t v) { return _mm_shuffle_ps(v, v, 0xFF); }
+
+static inline vi_t vi_load(const int32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+static inline void vi_store(int32_t* p, vi_t v) { _mm_storeu_si128((__m128i*)p, v); }
+static inline vi_t vi_set1(int32_t x) { return _mm_set1_epi32(x); }
+static inline vi_t vi_add(vi_t a, vi_t b) { return _mm_add_epi32(a, b); }
+static inline vi_t vi_sub(vi_t a, vi_t b) { return _mm_sub_epi32(a, b); }
+static inline vi_t vi_mul(vi_t a, vi_t b) { return _mm_mullo_epi32(a, b); }
+static inline vi_t vi_min(vi_t a, vi_t b) { return _mm_min_epi32(a, b); }
+static inline vi_t vi_max(vi_t a, vi_t b) { return _mm_max_epi32(a, b); }
+static inline vi_t vi_abs(vi_t a) { return _mm_abs_epi32(a); }
+static inline int32_t vi_hmin(vi_t v) {
+    v = _mm_min_epi32(v, _mm_shuffle_epi32(v, 0x4E));
+    return _mm_cvtsi128_si32(_mm_min_epi32(v, _mm_shuffle_epi32(v, 0xB1)));
+}
+static inline int32_t vi_hmax(vi_t v) {
+    v = _mm_max_epi32(v, _mm_shuffle_epi32(v, 0x4E));
+    return _mm_cvtsi128_si32(_mm_max_epi32(v, _mm_shuffle_epi32(v, 0xB1)));
+}
+static inline vi_t vi_scan(vi_t x) {
+    x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+    return _mm_add_epi32(x, _mm_slli_si128(x, 8));
+}
+static inline vi_t vi_broadcast_last(vi_t v) { return _mm_shuffle_epi32(v, 0xFF); }
+
+static inline vl_t vl_zero() { return _mm_setzero_si128(); }
+static inline vl_t vl_acc(vl_t acc, vi_t v) {
+    acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(v));
+    return _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+}
+static inline int64_t vl_hsum(vl_t acc) { return _mm_cvtsi128_si64(acc) + _mm_extract_epi64(acc, 1); }
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+#define SIMD_ISA CORE_SIMD_ISA_NEON
+#define SIMD_ISA_NAME "neon"
+#define VF_WIDTH 4
+#define SIMD_BUFFERED_TAIL 1
+typedef float32x4_t vf_t;
+typedef int32x4_t vi_t;
+typedef int64x2_t vl_t;
+
+static inline vf_t vf_load(const float* p) { return vld1q_f32(p); }
+static inline void vf_store(float* p, vf_t v) { vst1q_f32(p, v); }
+static inline vf_t vf_set1(float x) { return vdupq_n_f32(x); }
+static inline vf_t vf_add(vf_t a, vf_t b) { return vaddq_f32(a, b); }
+static inline vf_t vf_sub(vf_t a, vf_t b) { return vsubq_f32(a, b); }
+static inline vf_t vf_mul(vf_t a, vf_t b) { return vmulq_f32(a, b); }
+static inline vf_t vf_min(vf_t a, vf_t b) { return vminq_f32(a, b); }
+static inline vf_t vf_max(vf_t a, vf_t b) { return vmaxq_f32(a, b); }
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) { return vfmaq_f32(c, a, b); }
+static inline vf_t vf_abs(vf_t a) { return vabsq_f32(a); }
+static inline float vf_hsum(vf_t v) { return vaddvq_f32(v); }
+static inline float vf_hmin(vf_t v) { return vminvq_f32(v); }
+static inline float vf_hmax(vf_t v) { return vmaxvq_f32(v); }
+static inline uint32_t simd_movemask_u32(uint32x4_t m) {
+    static const uint32_t bits[4] = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(m, vld1q_u32(bits)));
+}
+static inline uint32_t vf_cmp(vf_t a, vf_t b, int op) {
+    switch (op) {
+        case CORE_CMP_EQ: return simd_movemask_u32(vceqq_f32(a, b));
+        case CORE_CMP_NE: return simd_movemask_u32(vmvnq_u32(vceqq_f32(a, b)));
+        case CORE_CMP_LT: return simd_movemask_u32(vcltq_f32(a, b));
+        case CORE_CMP_LE: return simd_movemask_u32(vcleq_f32(a, b));
+        case CORE_CMP_GT: return simd_movemask_u32(vcgtq_f32(a, b));
+        case CORE_CMP_GE: return simd_movemask_u32(vcgeq_f32(a, b));
+        default: return 0;
+    }
+}
+static inline vf_t vf_scan(vf_t x) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    x = vaddq_f32(x, vextq_f32(zero, x, 3));
+    return vaddq_f32(x, vextq_f32(zero, x, 2));
+}
+static inline vf_t vf_broadcast_last(vf_t v) { return vdupq_laneq_f32(v, 3); }
+
+static inline vi_t vi_load(const int32_t* p) { return vld1q_s32(p); }
+static inline void vi_store(int32_t* p, vi_t v) { vst1q_s32(p, v); }
+static inline vi_t vi_set1(int32_t x) { return vdupq_n_s32(x); }
+static inline vi_t vi_add(vi_t a, vi_t b) { return vaddq_s32(a, b); }
+static inline vi_t vi_sub(vi_t a, vi_t b) { return vsubq_s32(a, b); }
+static inline vi_t vi_mul(vi_t a, vi_t b) { return vmulq_s32(a, b); }
+static inline vi_t vi_min(vi_t a, vi_t b) { return vminq_s32(a, b); }
+static inline vi_t vi_max(vi_t a, vi_t b) { return vmaxq_s32(a, b); }
+static inline vi_t vi_abs(vi_t a) { return vabsq_s32(a); }
+static inline int32_t vi_hmin(vi_t v) { return vminvq_s32(v); }
+static inline int32_t vi_hmax(vi_t v) { return vmaxvq_s32(v); }
+static inline vi_t vi_scan(vi_t x) {
+    const int32x4_t zero = vdupq_n_s32(0);
+    x = vaddq_s32(x, vextq_s32(zero, x, 3));
+    return vaddq_s32(x, vextq_s32(zero, x, 2));
+}
+static inline vi_t vi_broadcast_last(vi_t v) { return vdupq_laneq_s32(v, 3); }
+
+static inline vl_t vl_zero() { return vdupq_n_s64(0); }
+static inline vl_t vl_acc(vl_t acc, vi_t v) { return vpadalq_s32(acc, v); }
+static inline int64_t vl_hsum(vl_t acc) { return vaddvq_s64(acc); }
+
+#else
+
+#define SIMD_ISA CORE_SIMD_ISA_SCALAR
+#define SIMD_ISA_NAME "scalar"
+#define VF_WIDTH 1
+#define SIMD_BUFFERED_TAIL 1
+typedef float vf_t;
+typedef int32_t vi_t;
+typedef int64_t vl_t;
+
+// Целочисленная арифметика с переполнением по модулю 2^32, как в SIMD-ветках
+static inline int32_t simd_wrap_i32(uint32_t x) { return (int32_t)x; }
+
+static inline vf_t vf_load(const float* p) { return *p; }
+static inline void vf_store(float* p, vf_t v) { *p = v; }
+static inline vf_t vf_set1(float x) { return x; }
+static inline vf_t vf_add(vf_t a, vf_t b) { return a + b; }
+static inline vf_t vf_sub(vf_t a, vf_t b) { return a - b; }
+static inline vf_t vf_mul(vf_t a, vf_t b) { return a * b; }
+static inline vf_t vf_min(vf_t a, vf_t b) { return a < b ? a : b; }
+static inline vf_t vf_max(vf_t a, vf_t b) { return a > b ? a : b; }
+static inline vf_t vf_fma(vf_t a, vf_t b, vf_t c) { return a * b + c; }
+static inline vf_t vf_abs(vf_t a) { return fabsf(a); }
+static inline float vf_hsum(vf_t v) { return v; }
+static inline float vf_hmin(vf_t v) { return v; }
+static inline float vf_hmax(vf_t v) { return v; }
+static inline uint32_t vf_cmp(vf_t a, vf_t b, int op) {
+    switch (op) {
+        case CORE_CMP_EQ: return a == b;
+        case CORE_CMP_NE: return a != b;
+        case CORE_CMP_LT: return a < b;
+        case CORE_CMP_LE: return a <= b;
+        case CORE_CMP_GT: return a > b;
+        case CORE_CMP_GE: return a >= b;
+        default: return 0;
+    }
+}
+static inline vf_t vf_scan(vf_t x) { return x; }
+static inline vf_t vf_broadcast_last(vf_t v) { return v; }
+
+static inline vi_t vi_load(const int32_t* p) { return *p; }
+static inline void vi_store(int32_t* p, vi_t v) { *p = v; }
+static inline vi_t vi_set1(int32_t x) { return x; }
+static inline vi_t vi_add(vi_t a, vi_t b) { return simd_wrap_i32((uint32_t)a + (uint32_t)b); }
+static inline vi_t vi_sub(vi_t a, vi_t b) { return simd_wrap_i32((uint32_t)a - (uint32_t)b); }
+static inline vi_t vi_mul(vi_t a, vi_t b) { return simd_wrap_i32((uint32_t)a * (uint32_t)b); }
+static inline vi_t vi_min(vi_t a, vi_t b) { return a < b ? a : b; }
+static inline vi_t vi_max(vi_t a, vi_t b) { return a > b ? a : b; }
+static inline vi_t vi_abs(vi_t a) { return a < 0 ? simd_wrap_i32(0u - (uint32_t)a) : a; }
+static inline int32_t vi_hmin(vi_t v) { return v; }
+static inline int32_t vi_hmax(vi_t v) { return v; }
+static inline vi_t vi_scan(vi_t x) { return x; }
+static inline vi_t vi_broadcast_last(vi_t v) { return v; }
+
+static inline vl_t vl_zero() { return 0; }
+static inline vl_t vl_acc(vl_t acc, vi_t v) { return acc + v; }
+static inline int64_t vl_hsum(vl_t acc) { return acc; }
+
+#endif
+
+#if defined(SIMD_BUFFERED_TAIL)
+// Наборы без маскированных загрузок: хвост проходит через буфер на стеке
+static inline vf_t vf_load_tail(const float* p, size_t n, float fill) {
+    float buf[VF_WIDTH];
+    for (size_t i = 0; i < VF_WIDTH; ++i) buf[i] = i < n ? p[i] : fill;
+    return vf_load(buf);
+}
+static inline void vf_store_tail(float* p, vf_t v, size_t n) {
+    float buf[VF_WIDTH];
+    vf_store(buf, v);
+    memcpy(p, buf, n * sizeof(float));
+}
+static inline vi_t vi_load_tail(const int32_t* p, size_t n, int32_t fill) {
+    int32_t buf[VF_WIDTH];
+    for (size_t i = 0; i < VF_WIDTH; ++i) buf[i] = i < n ? p[i] : fill;
+    return vi_load(buf);
+}
+static inline void vi_store_tail(int32_t* p, vi_t v, size_t n) {
+    int32_t buf[VF_WIDTH];
+    vi_store(buf, v);
+    memcpy(p, buf, n * sizeof(int32_t));
+}
+#endif
+
+// Маска младших n бит группы сравнения (n < VF_WIDTH <= 16)
+static inline uint32_t simd_lane_bits(size_t n) { return (1u << n) - 1u; }
+
+int core_simd_isa() {
+    return SIMD_ISA;
+}
+
+const char* core_simd_isa_name() {
+    return SIMD_ISA_NAME;
+}
+
+size_t core_simd_width_f32() {
+    return VF_WIDTH;
+}
+
+// Поэлементные операции над float
 void core_vector_add_f32(float* dst, const float* src1, const float* src2, size_t n) {
-#if defined(__AVX2__)
     size_t i = 0;
-    for (; i + 8 <= n; i += 8) {
-        __m256 a = _mm256_loadu_ps(&src1[i]);
-        __m256 b = _mm256_loadu_ps(&src2[i]);
-        __m256 c = _mm256_add_ps(a, b);
-        _mm256_storeu_ps(&dst[i], c);
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vf_store(&dst[i], vf_add(vf_load(&src1[i]), vf_load(&src2[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vf_store_tail(&dst[i], vf_add(vf_load_tail(&src1[i], rem, 0.0f), vf_load_tail(&src2[i], rem, 0.0f)), rem);
     }
-    for (; i < n; ++i) dst[i] = src1[i] + src2[i];
-#elif defined(__ARM_NEON)
+}
+
+void core_vector_sub_f32(float* dst, const float* src1, const float* src2, size_t n) {
     size_t i = 0;
-    for (; i + 4 <= n; i += 4) {
-        float32x4_t a = vld1q_f32(&src1[i]);
-        float32x4_t b = vld1q_f32(&src2[i]);
-        float32x4_t c = vaddq_f32(a, b);
-        vst1q_f32(&dst[i], c);
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vf_store(&dst[i], vf_sub(vf_load(&src1[i]), vf_load(&src2[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vf_store_tail(&dst[i], vf_sub(vf_load_tail(&src1[i], rem, 0.0f), vf_load_tail(&src2[i], rem, 0.0f)), rem);
     }
-    for (; i < n; ++i) dst[i] = src1[i] + src2[i];
-#else
-    for (size_t i = 0; i < n; ++i) dst[i] = src1[i] + src2[i];
-#endif
 }
 
+void core_vector_mul_f32(float* dst, const float* src1, const float* src2, size_t n) {
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vf_store(&dst[i], vf_mul(vf_load(&src1[i]), vf_load(&src2[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vf_store_tail(&dst[i], vf_mul(vf_load_tail(&src1[i], rem, 0.0f), vf_load_tail(&src2[i], rem, 0.0f)), rem);
+    }
+}
+
+void core_vector_min_f32(float* dst, const float* src1, const float* src2, size_t n) {
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vf_store(&dst[i], vf_min(vf_load(&src1[i]), vf_load(&src2[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vf_store_tail(&dst[i], vf_min(vf_load_tail(&src1[i], rem, 0.0f), vf_load_tail(&src2[i], rem, 0.0f)), rem);
+    }
+}
+
+void core_vector_max_f32(float* dst, const float* src1, const float* src2, size_t n) {
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vf_store(&dst[i], vf_max(vf_load(&src1[i]), vf_load(&src2[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vf_store_tail(&dst[i], vf_max(vf_load_tail(&src1[i], rem, 0.0f), vf_load_tail(&src2[i], rem, 0.0f)), rem);
+    }
+}
+
+void core_vector_fma_f32(float* dst, const float* a, const float* b, const float* c, size_t n) {
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vf_store(&dst[i], vf_fma(vf_load(&a[i]), vf_load(&b[i]), vf_load(&c[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vf_store_tail(&dst[i], vf_fma(vf_load_tail(&a[i], rem, 0.0f), vf_load_tail(&b[i], rem, 0.0f),
+                                      vf_load_tail(&c[i], rem, 0.0f)), rem);
+    }
+}
+
+void core_vector_abs_f32(float* dst, const float* src, size_t n) {
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vf_store(&dst[i], vf_abs(vf_load(&src[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vf_store_tail(&dst[i], vf_abs(vf_load_tail(&src[i], rem, 0.0f)), rem);
+    }
+}
+
+// Поэлементные операции над int32 (переполнение по модулю 2^32)
 void core_vector_add_i32(int32_t* dst, const int32_t* src1, const int32_t* src2, size_t n) {
-#if defined(__AVX2__)
     size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vi_store(&dst[i], vi_add(vi_load(&src1[i]), vi_load(&src2[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vi_store_tail(&dst[i], vi_add(vi_load_tail(&src1[i], rem, 0), vi_load_tail(&src2[i], rem, 0)), rem);
+    }
+}
+
+void core_vector_sub_i32(int32_t* dst, const int32_t* src1, const int32_t* src2, size_t n) {
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vi_store(&dst[i], vi_sub(vi_load(&src1[i]), vi_load(&src2[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vi_store_tail(&dst[i], vi_sub(vi_load_tail(&src1[i], rem, 0), vi_load_tail(&src2[i], rem, 0)), rem);
+    }
+}
+
+void core_vector_mul_i32(int32_t* dst, const int32_t* src1, const int32_t* src2, size_t n) {
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vi_store(&dst[i], vi_mul(vi_load(&src1[i]), vi_load(&src2[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vi_store_tail(&dst[i], vi_mul(vi_load_tail(&src1[i], rem, 0), vi_load_tail(&src2[i], rem, 0)), rem);
+    }
+}
+
+void core_vector_min_i32(int32_t* dst, const int32_t* src1, const int32_t* src2, size_t n) {
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vi_store(&dst[i], vi_min(vi_load(&src1[i]), vi_load(&src2[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vi_store_tail(&dst[i], vi_min(vi_load_tail(&src1[i], rem, 0), vi_load_tail(&src2[i], rem, 0)), rem);
+    }
+}
+
+void core_vector_max_i32(int32_t* dst, const int32_t* src1, const int32_t* src2, size_t n) {
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vi_store(&dst[i], vi_max(vi_load(&src1[i]), vi_load(&src2[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vi_store_tail(&dst[i], vi_max(vi_load_tail(&src1[i], rem, 0), vi_load_tail(&src2[i], rem, 0)), rem);
+    }
+}
+
+void core_vector_abs_i32(int32_t* dst, const int32_t* src, size_t n) {
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vi_store(&dst[i], vi_abs(vi_load(&src[i])));
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vi_store_tail(&dst[i], vi_abs(vi_load_tail(&src[i], rem, 0)), rem);
+    }
+}
+
+// Редукции. Четыре независимых аккумулятора скрывают латентность сложения.
+float core_vector_sum_f32(const float* src, size_t n) {
+    vf_t acc0 = vf_set1(0.0f), acc1 = vf_set1(0.0f), acc2 = vf_set1(0.0f), acc3 = vf_set1(0.0f);
+    size_t i = 0;
+    for (; i + 4 * VF_WIDTH <= n; i += 4 * VF_WIDTH) {
+        acc0 = vf_add(acc0, vf_load(&src[i]));
+        acc1 = vf_add(acc1, vf_load(&src[i + VF_WIDTH]));
+        acc2 = vf_add(acc2, vf_load(&src[i + 2 * VF_WIDTH]));
+        acc3 = vf_add(acc3, vf_load(&src[i + 3 * VF_WIDTH]));
+    }
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        acc0 = vf_add(acc0, vf_load(&src[i]));
+    }
+    if (i < n) {
+        acc1 = vf_add(acc1, vf_load_tail(&src[i], n - i, 0.0f));
+    }
+    return vf_hsum(vf_add(vf_add(acc0, acc1), vf_add(acc2, acc3)));
+}
+
+float core_vector_reduce_min_f32(const float* src, size_t n) {
+    vf_t acc0 = vf_set1(INFINITY), acc1 = vf_set1(INFINITY);
+    size_t i = 0;
+    for (; i + 2 * VF_WIDTH <= n; i += 2 * VF_WIDTH) {
+        acc0 = vf_min(acc0, vf_load(&src[i]));
+        acc1 = vf_min(acc1, vf_load(&src[i + VF_WIDTH]));
+    }
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        acc0 = vf_min(acc0, vf_load(&src[i]));
+    }
+    if (i < n) {
+        acc1 = vf_min(acc1, vf_load_tail(&src[i], n - i, INFINITY));
+    }
+    return vf_hmin(vf_min(acc0, acc1));
+}
+
+float core_vector_reduce_max_f32(const float* src, size_t n) {
+    vf_t acc0 = vf_set1(-INFINITY), acc1 = vf_set1(-INFINITY);
+    size_t i = 0;
+    for (; i + 2 * VF_WIDTH <= n; i += 2 * VF_WIDTH) {
+        acc0 = vf_max(acc0, vf_load(&src[i]));
+        acc1 = vf_max(acc1, vf_load(&src[i + VF_WIDTH]));
+    }
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        acc0 = vf_max(acc0, vf_load(&src[i]));
+    }
+    if (i < n) {
+        acc1 = vf_max(acc1, vf_load_tail(&src[i], n - i, -INFINITY));
+    }
+    return vf_hmax(vf_max(acc0, acc1));
+}
+
+// argmax обрабатывает данные блоками, помещающимися в L1: векторный максимум
+// блока, и только если он улучшает текущий — скалярный поиск его первой позиции.
+#define CORE_SIMD_ARGMAX_BLOCK 512
+
+size_t core_vector_argmax_f32(const float* src, size_t n) {
+    float best = -INFINITY;
+    size_t best_idx = 0;
+    for (size_t start = 0; start < n; start += CORE_SIMD_ARGMAX_BLOCK) {
+        size_t len = n - start < CORE_SIMD_ARGMAX_BLOCK ? n - start : CORE_SIMD_ARGMAX_BLOCK;
+        float block_max = core_vector_reduce_max_f32(&src[start], len);
+        if (block_max > best) {
+            best = block_max;
+            for (size_t j = 0; j < len; ++j) {
+                if (src[start + j] == block_max) {
+                    best_idx = start + j;
+                    break;
+                }
+            }
+        }
+    }
+    return best_idx;
+}
+
+int64_t core_vector_sum_i32(const int32_t* src, size_t n) {
+    vl_t acc0 = vl_zero(), acc1 = vl_zero();
+    size_t i = 0;
+    for (; i + 2 * VF_WIDTH <= n; i += 2 * VF_WIDTH) {
+        acc0 = vl_acc(acc0, vi_load(&src[i]));
+        acc1 = vl_acc(acc1, vi_load(&src[i + VF_WIDTH]));
+    }
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        acc0 = vl_acc(acc0, vi_load(&src[i]));
+    }
+    if (i < n) {
+        acc1 = vl_acc(acc1, vi_load_tail(&src[i], n - i, 0));
+    }
+    return vl_hsum(acc0) + vl_hsum(acc1);
+}
+
+int32_t core_vector_reduce_min_i32(const int32_t* src, size_t n) {
+    vi_t acc = vi_set1(INT32_MAX);
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        acc = vi_min(acc, vi_load(&src[i]));
+    }
+    if (i < n) {
+        acc = vi_min(acc, vi_load_tail(&src[i], n - i, INT32_MAX));
+    }
+    return vi_hmin(acc);
+}
+
+int32_t core_vector_reduce_max_i32(const int32_t* src, size_t n) {
+    vi_t acc = vi_set1(INT32_MIN);
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        acc = vi_max(acc, vi_load(&src[i]));
+    }
+    if (i < n) {
+        acc = vi_max(acc, vi_load_tail(&src[i], n - i, INT32_MIN));
+    }
+    return vi_hmax(acc);
+}
+
+// Сравнения. VF_WIDTH делит 64, поэтому группа лейнов никогда не пересекает
+// границу слова маски.
+void core_vector_cmp_f32(uint64_t* mask, const float* src1, const float* src2, size_t n, int op) {
+    memset(mask, 0, ((n + 63) / 64) * sizeof(uint64_t));
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        uint64_t bits = vf_cmp(vf_load(&src1[i]), vf_load(&src2[i]), op);
+        mask[i / 64] |= bits << (i % 64);
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        uint64_t bits = vf_cmp(vf_load_tail(&src1[i], rem, 0.0f), vf_load_tail(&src2[i], rem, 0.0f), op) &
+                        simd_lane_bits(rem);
+        mask[i / 64] |= bits << (i % 64);
+    }
+}
+
+void core_vector_cmp_scalar_f32(uint64_t* mask, const float* src, float value, size_t n, int op) {
+    memset(mask, 0, ((n + 63) / 64) * sizeof(uint64_t));
+    const vf_t v = vf_set1(value);
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        uint64_t bits = vf_cmp(vf_load(&src[i]), v, op);
+        mask[i / 64] |= bits << (i % 64);
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        uint64_t bits = vf_cmp(vf_load_tail(&src[i], rem, 0.0f), v, op) & simd_lane_bits(rem);
+        mask[i / 64] |= bits << (i % 64);
+    }
+}
+
+size_t core_mask_popcount(const uint64_t* mask, size_t n) {
+    size_t count = 0;
+    size_t words = n / 64;
+    for (size_t w = 0; w < words; ++w) {
+        count += (size_t)__builtin_popcountll(mask[w]);
+    }
+    if (n % 64) {
+        count += (size_t)__builtin_popcountll(mask[words] & ((1ULL << (n % 64)) - 1));
+    }
+    return count;
+}
+
+// Gather/scatter: аппаратные инструкции есть только на x86 (scatter — только AVX-512)
+void core_vector_gather_f32(float* dst, const float* base, const int32_t* idx, size_t n) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    for (; i + 16 <= n; i += 16) {
+        __m512i vidx = _mm512_loadu_si512((const void*)&idx[i]);
+        _mm512_storeu_ps(&dst[i], _mm512_i32gather_ps(vidx, base, 4));
+    }
+    if (i < n) {
+        __mmask16 m = simd_tail_mask(n - i);
+        __m512i vidx = _mm512_maskz_loadu_epi32(m, &idx[i]);
+        __m512 v = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, vidx, base, 4);
+        _mm512_mask_storeu_ps(&dst[i], m, v);
+        i = n;
+    }
+#elif defined(__AVX2__)
     for (; i + 8 <= n; i += 8) {
-        __m256i a = _mm256_loadu_si256((__m256i*)&src1[i]);
-        __m256i b = _mm256_loadu_si256((__m256i*)&src2[i]);
-        __m256i c = _mm256_add_epi32(a, b);
-        _mm256_storeu_si256((__m256i*)&dst[i], c);
+        __m256i vidx = _mm256_loadu_si256((const __m256i*)&idx[i]);
+        _mm256_storeu_ps(&dst[i], _mm256_i32gather_ps(base, vidx, 4));
     }
-    for (; i < n; ++i) dst[i] = src1[i] + src2[i];
-#elif defined(__ARM_NEON)
+    if (i < n) {
+        __m256i m = simd_tail_mask(n - i);
+        __m256i vidx = _mm256_maskload_epi32(&idx[i], m);
+        __m256 v = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, vidx, _mm256_castsi256_ps(m), 4);
+        _mm256_maskstore_ps(&dst[i], m, v);
+        i = n;
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = base[idx[i]];
+    }
+}
+
+void core_vector_scatter_f32(float* base, const int32_t* idx, const float* src, size_t n) {
     size_t i = 0;
-    for (; i + 4 <= n; i += 4) {
-        int32x4_t a = vld1q_s32(&src1[i]);
-        int32x4_t b = vld1q_s32(&src2[i]);
-        int32x4_t c = vaddq_s32(a, b);
-        vst1q_s32(&dst[i], c);
+#if defined(__AVX512F__)
+    // vscatterdps пишет лейны по возрастанию, так что порядок совпадает со скалярным
+    for (; i + 16 <= n; i += 16) {
+        __m512i vidx = _mm512_loadu_si512((const void*)&idx[i]);
+        _mm512_i32scatter_ps(base, vidx, _mm512_loadu_ps(&src[i]), 4);
+    }
+    if (i < n) {
+        __mmask16 m = simd_tail_mask(n - i);
+        __m512i vidx = _mm512_maskz_loadu_epi32(m, &idx[i]);
+        _mm512_mask_i32scatter_ps(base, m, vidx, _mm512_maskz_loadu_ps(m, &src[i]), 4);
+        i = n;
     }
-    for (; i < n; ++i) dst[i] = src1[i] + src2[i];
-#else
-    for (size_t i = 0; i < n; ++i) dst[i] = src1[i] + src2[i];
 #endif
-} 
\ No newline at end of file
+    for (; i < n; ++i) {
+        base[idx[i]] = src[i];
+    }
+}
+
+// Префиксные суммы: сканирование внутри регистра плюс перенос между регистрами
+void core_vector_prefix_sum_f32(float* dst, const float* src, size_t n) {
+    vf_t carry = vf_set1(0.0f);
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vf_t v = vf_add(vf_scan(vf_load(&src[i])), carry);
+        vf_store(&dst[i], v);
+        carry = vf_broadcast_last(v);
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vf_store_tail(&dst[i], vf_add(vf_scan(vf_load_tail(&src[i], rem, 0.0f)), carry), rem);
+    }
+}
+
+void core_vector_prefix_sum_i32(int32_t* dst, const int32_t* src, size_t n) {
+    vi_t carry = vi_set1(0);
+    size_t i = 0;
+    for (; i + VF_WIDTH <= n; i += VF_WIDTH) {
+        vi_t v = vi_add(vi_scan(vi_load(&src[i])), carry);
+        vi_store(&dst[i], v);
+        carry = vi_broadcast_last(v);
+    }
+    if (i < n) {
+        size_t rem = n - i;
+        vi_store_tail(&dst[i], vi_add(vi_scan(vi_load_tail(&src[i], rem, 0)), carry), rem);
+    }
+}
@@ -1,17 +1,150 @@
 #include "load_balancer.h"
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <random>
 #include <thread>
+#include <utility>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <cerrno>
+#include <cstring>
 #include <openssl/sha.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "core/drivers/event_loop_ops.h"
+#include "core/drivers/task_queue_ops.h"
+#include "core/error_handling/core_errors.h"
 
 namespace core {
 namespace loadbalancer {
 
+namespace {
+
+std::atomic<uint64_t> next_instance_id{1};
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// xorshift64* per thread: selection must not contend on a shared generator
+uint64_t next_random() {
+    thread_local uint64_t state =
+        (std::hash<std::thread::id>{}(std::this_thread::get_id()) ^ 0x9E3779B97F4A7C15ull) | 1;
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1Dull;
+}
+
+// 64-bit FNV-1a with a murmur finalizer: cheap on short keys such as
+// addresses, and the finalizer spreads nearby inputs over the whole range
+uint64_t hash_key(const std::string& key, uint64_t seed) {
+    uint64_t hash = 0xCBF29CE484222325ull ^ seed;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 0x100000001B3ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+constexpr uint64_t kOffsetSeed = 0;
+constexpr uint64_t kSkipSeed = 0x9E3779B97F4A7C15ull;
+constexpr uint64_t kKeySeed = 0xD6E8FEB86659FD93ull;
+
+// Uniform index in [0, n) from the high 32 bits, without a division
+uint32_t random_index(uint64_t random, size_t n) {
+    return static_cast<uint32_t>(((random >> 32) * static_cast<uint64_t>(n)) >> 32);
+}
+
+// Uniform in [0, 1)
+double next_unit() {
+    return static_cast<double>(next_random() >> 11) * 0x1.0p-53;
+}
+
+} // namespace
+
+// Active health checks. All probe state belongs to the checker's loop
+// thread; other threads only post servers to track.
+class LoadBalancer::HealthChecker {
+public:
+    explicit HealthChecker(LoadBalancer& owner);
+    ~HealthChecker();
+
+    bool running() const { return loop_ != nullptr; }
+    void track(const std::shared_ptr<Server>& server);   // from any thread
+
+private:
+    struct Probe {
+        HealthChecker* checker{nullptr};
+        std::shared_ptr<Server> server;
+        sockaddr_storage addr{};
+        socklen_t addr_len{0};   // 0 until resolved
+        bool numeric{false};     // literal address: never resolved again
+        int fd{-1};
+        core_event_watch_t* watch{nullptr};
+        uint64_t timer_id{0};    // next probe while idle, timeout while connecting
+        bool timer_pending{false};
+        bool resolving{false};
+    };
+
+    struct Track {
+        HealthChecker* checker;
+        std::shared_ptr<Server> server;
+    };
+
+    // Host names are resolved on the loop's helper threads
+    struct Resolve {
+        HealthChecker* checker;
+        Server* key;
+        std::string host;
+        uint16_t port;
+        sockaddr_storage addr{};
+        socklen_t addr_len{0};
+    };
+
+    static void on_track(void* ctx);
+    static void on_timer(void* ctx);
+    static void on_event(void* ctx, uint32_t events);
+    static void on_resolve(void* ctx);
+    static void on_resolved(void* ctx);
+
+    void schedule(Probe& probe, int64_t delay_ns);
+    void start_probe(Probe& probe);
+    void finish_probe(Probe& probe, bool ok);
+    void close_probe(Probe& probe);
+
+    LoadBalancer& owner_;
+    core_event_loop_t* loop_{nullptr};
+    std::thread thread_;
+    bool stopping_{false};   // loop thread, or after it has exited
+    std::unordered_map<Server*, std::unique_ptr<Probe>> probes_;
+};
+
+LoadBalancer::Server::Server(const ServerConfig& config)
+    : config(config)
+    , maglev_offset_hash(hash_key(config.address, kOffsetSeed))
+    , maglev_skip_hash(hash_key(config.address, kSkipSeed))
+    , weight(config.weight)
+    , last_health_check_ns(now_ns()) {
+}
+
 LoadBalancer::LoadBalancer(Algorithm algorithm)
-    : algorithm_(algorithm) {
+    : algorithm_(algorithm)
+    , instance_id_(next_instance_id.fetch_add(1, std::memory_order_relaxed)) {
+    set_outlier_detection(OutlierDetectionConfig{});
+    std::lock_guard<std::mutex> lock(servers_mutex_);
+    publish_snapshot(true);
 }
 
 LoadBalancer::~LoadBalancer() {
@@ -19,181 +152,898 @@ LoadBalancer::~LoadBalancer() {
 }
 
 void LoadBalancer::add_server(const ServerConfig& config) {
-    std::lock_guard<std::mutex> lock(servers_mutex_);
-    Server server;
-    server.config = config;
-    server.stats.last_health_check = std::chrono::steady_clock::now();
-    servers_[config.address] = std::move(server);
+    std::shared_ptr<Server> added;
+    {
+        std::lock_guard<std::mutex> lock(servers_mutex_);
+        auto& server = servers_[config.address];
+        if (server) {
+            retire_server(*server);
+        }
+        server = std::make_shared<Server>(config);
+        added = server;
+        publish_snapshot(true);
+    }
+
+    std::lock_guard<std::mutex> lock(health_mutex_);
+    if (health_checker_) {
+        health_checker_->track(added);
+    }
 }
 
 void LoadBalancer::remove_server(const std::string& address) {
     std::lock_guard<std::mutex> lock(servers_mutex_);
-    servers_.erase(address);
+    if (auto it = servers_.find(address); it != servers_.end()) {
+        retire_server(*it->second);
+        servers_.erase(it);
+        publish_snapshot(true);
+    }
+}
+
+void LoadBalancer::retire_server(Server& server) {
+    // Responses still in flight may find the server through an older
+    // snapshot; the counter is already zero then and they change nothing
+    in_flight_.fetch_sub(server.active_connections.exchange(0, std::memory_order_relaxed),
+                         std::memory_order_relaxed);
 }
 
 void LoadBalancer::update_server_weight(const std::string& address, uint32_t weight) {
     std::lock_guard<std::mutex> lock(servers_mutex_);
     if (auto it = servers_.find(address); it != servers_.end()) {
-        it->second.config.weight = weight;
-        it->second.stats.weight = weight;
+        it->second->weight.store(weight, std::memory_order_relaxed);
+        publish_snapshot(true);
+    }
+}
+
+void LoadBalancer::publish_snapshot(bool rebuild_maglev) {
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->version = snapshot_version_.load(std::memory_order_relaxed) + 1;
+    snapshot->servers.reserve(servers_.size());
+    snapshot->is_routable.reserve(servers_.size());
+    for (const auto& [address, server] : servers_) {
+        auto slot = static_cast<uint32_t>(snapshot->servers.size());
+        snapshot->index.emplace(address, slot);
+        snapshot->servers.push_back(server);
+        bool routable = server->healthy.load(std::memory_order_relaxed) &&
+                        !server->ejected.load(std::memory_order_relaxed);
+        snapshot->is_routable.push_back(routable);
+        if (routable) {
+            snapshot->routable.push_back(slot);
+        }
+    }
+    for (uint32_t slot : snapshot->routable) {
+        snapshot->total_weight += snapshot->servers[slot]->weight.load(std::memory_order_relaxed);
+    }
+    build_alias_table(*snapshot);
+    if (algorithm_ == Algorithm::IP_HASH || algorithm_ == Algorithm::CONSISTENT_HASH) {
+        // Health and ejection leave servers_ and the weights alone, so the
+        // previous table still indexes the same servers and stays valid
+        // Only writers replace snapshot_, and they hold servers_mutex_
+        const auto& previous = snapshot_;
+        if (rebuild_maglev || !previous || !previous->maglev) {
+            build_maglev_table(*snapshot);
+        } else {
+            snapshot->maglev = previous->maglev;
+        }
+    }
+
+    const uint64_t version = snapshot->version;
+    std::shared_ptr<const Snapshot> retired;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        retired = std::exchange(snapshot_, std::move(snapshot));
+    }
+    // Released outside the lock; readers still on it hold their own reference
+    retired.reset();
+    snapshot_version_.store(version, std::memory_order_release);
+}
+
+const LoadBalancer::Snapshot& LoadBalancer::acquire_snapshot() const {
+    // A few balancers per thread; the entry stays valid until this thread's
+    // next acquire_snapshot, and a retired snapshot is freed once the last
+    // thread has moved past it.
+    struct CachedSnapshot {
+        uint64_t instance_id{0};
+        uint64_t version{0};
+        std::shared_ptr<const Snapshot> snapshot;
+    };
+    thread_local std::array<CachedSnapshot, 4> cache;
+    thread_local size_t next_victim = 0;
+
+    uint64_t version = snapshot_version_.load(std::memory_order_acquire);
+    CachedSnapshot* entry = nullptr;
+    for (auto& cached : cache) {
+        if (cached.instance_id == instance_id_) {
+            entry = &cached;
+            break;
+        }
+    }
+    if (!entry) {
+        entry = &cache[next_victim++ % cache.size()];
+        entry->instance_id = instance_id_;
+        entry->version = 0;
+    }
+
+    if (entry->version != version) {
+        // May already be newer than version; the entry records its own
+        std::shared_ptr<const Snapshot> current;
+        {
+            std::lock_guard<std::mutex> lock(snapshot_mutex_);
+            current = snapshot_;
+        }
+        entry->snapshot = std::move(current);
+        entry->version = entry->snapshot->version;
+    }
+    return *entry->snapshot;
+}
+
+void LoadBalancer::build_alias_table(Snapshot& snapshot) {
+    const size_t n = snapshot.routable.size();
+    snapshot.alias_threshold.assign(n, uint64_t{1} << 32);
+    snapshot.alias.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        snapshot.alias[i] = static_cast<uint32_t>(i);
+    }
+
+    double total = 0.0;
+    for (uint32_t slot : snapshot.routable) {
+        total += snapshot.servers[slot]->weight.load(std::memory_order_relaxed);
+    }
+    // All weights zero: fall back to uniform, which the identity table is
+    if (n == 0 || total == 0.0) {
+        return;
+    }
+
+    std::vector<double> scaled(n);
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (size_t i = 0; i < n; ++i) {
+        double weight = snapshot.servers[snapshot.routable[i]]->weight.load(std::memory_order_relaxed);
+        scaled[i] = weight * static_cast<double>(n) / total;
+        (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+    while (!small.empty() && !large.empty()) {
+        uint32_t s = small.back();
+        small.pop_back();
+        uint32_t l = large.back();
+        snapshot.alias_threshold[s] = static_cast<uint64_t>(scaled[s] * 4294967296.0);
+        snapshot.alias[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // Leftovers are 1.0 up to rounding and keep their own slot
+}
+
+void LoadBalancer::build_maglev_table(Snapshot& snapshot) {
+    const size_t n = snapshot.servers.size();
+    if (n == 0) {
+        snapshot.maglev.reset();
+        return;
+    }
+
+    static constexpr uint64_t kTableSizes[] = {2053, 16411, 65537, 262147, 1048583};
+    uint64_t size = kTableSizes[std::size(kTableSizes) - 1];
+    for (uint64_t candidate : kTableSizes) {
+        if (candidate >= n * 100) {
+            size = candidate;
+            break;
+        }
+    }
+
+    // Each server walks its own permutation of the table (offset + k * skip
+    // modulo a prime), claiming the next free slot on each of its turns.
+    // The seeds depend only on the address, so adding or removing one
+    // server moves few slots between the others.
+    std::vector<uint64_t> offset(n), skip(n), next(n, 0), weight(n), credit(n, 0);
+    uint64_t max_weight = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const Server& server = *snapshot.servers[i];
+        offset[i] = server.maglev_offset_hash % size;
+        skip[i] = server.maglev_skip_hash % (size - 1) + 1;
+        weight[i] = server.weight.load(std::memory_order_relaxed);
+        max_weight = std::max(max_weight, weight[i]);
+    }
+    if (max_weight == 0) {
+        std::fill(weight.begin(), weight.end(), 1);
+        max_weight = 1;
+    }
+
+    auto table = std::make_shared<std::vector<uint32_t>>(size, UINT32_MAX);
+    snapshot.maglev = table;
+    uint64_t filled = 0;
+    for (;;) {
+        for (size_t i = 0; i < n; ++i) {
+            // Weighted turns: the heaviest server claims a slot every round,
+            // the others in proportion to their weight
+            credit[i] += weight[i];
+            if (credit[i] < max_weight) {
+                continue;
+            }
+            credit[i] -= max_weight;
+
+            uint64_t slot;
+            do {
+                slot = (offset[i] + next[i] * skip[i]) % size;
+                ++next[i];
+            } while ((*table)[slot] != UINT32_MAX);
+            (*table)[slot] = static_cast<uint32_t>(i);
+            if (++filled == size) {
+                return;
+            }
+        }
     }
 }
 
 std::string LoadBalancer::get_next_server() {
-    std::lock_guard<std::mutex> lock(servers_mutex_);
-    if (servers_.empty()) {
+    const Snapshot& snapshot = acquire_snapshot();
+    if (snapshot.routable.empty()) {
+        return "";
+    }
+
+    Server* server = pick_keyless(snapshot);
+    for (int redraw = 0; redraw < kMaxRampRedraws && !admit(*server); ++redraw) {
+        server = pick_keyless(snapshot);
+    }
+    return select(server);
+}
+
+std::string LoadBalancer::get_next_server(const std::string& key) {
+    const Snapshot& snapshot = acquire_snapshot();
+    if (snapshot.routable.empty()) {
         return "";
     }
 
+    Server* server;
+    switch (algorithm_) {
+        case Algorithm::IP_HASH:
+            server = pick_ip_hash(snapshot, hash_key(key, kKeySeed));
+            break;
+        case Algorithm::CONSISTENT_HASH:
+            server = pick_consistent_hash(snapshot, hash_key(key, kKeySeed));
+            break;
+        default:
+            server = pick_keyless(snapshot);
+            break;
+    }
+    // A re-admitted server's keys go elsewhere until its ramp lets them back
+    for (int redraw = 0; redraw < kMaxRampRedraws && !admit(*server); ++redraw) {
+        server = pick_least_connections(snapshot);
+    }
+    return select(server);
+}
+
+std::string LoadBalancer::select(Server* server) {
+    server->active_connections.fetch_add(1, std::memory_order_relaxed);
+    in_flight_.fetch_add(1, std::memory_order_relaxed);
+    return server->config.address;
+}
+
+bool LoadBalancer::admit(Server& server) const {
+    int64_t since = server.readmitted_ns.load(std::memory_order_relaxed);
+    if (since == 0) {
+        return true;
+    }
+
+    // Gradual re-admission: the share of picks the server keeps grows
+    // linearly over the ramp; a rejected pick is redrawn
+    int64_t ramp = readmission_ramp_ns_.load(std::memory_order_relaxed);
+    int64_t elapsed = now_ns() - since;
+    if (elapsed >= ramp) {
+        server.readmitted_ns.compare_exchange_strong(since, 0, std::memory_order_relaxed);
+        return true;
+    }
+    double share = std::max(kMinRampShare, static_cast<double>(elapsed) / static_cast<double>(ramp));
+    return next_unit() < share;
+}
+
+LoadBalancer::Server* LoadBalancer::pick_keyless(const Snapshot& snapshot) {
     switch (algorithm_) {
-        case Algorithm::ROUND_ROBIN:
-            return get_next_server_round_robin();
         case Algorithm::LEAST_CONNECTIONS:
-            return get_next_server_least_connections();
+            return pick_least_connections(snapshot);
         case Algorithm::WEIGHTED_ROUND_ROBIN:
-            return get_next_server_weighted_round_robin();
+            return pick_weighted(snapshot);
         case Algorithm::LEAST_RESPONSE_TIME:
-            return get_next_server_least_response_time();
+            return pick_least_response_time(snapshot);
         default:
-            return get_next_server_round_robin();
-    }
-}
-
-std::string LoadBalancer::get_next_server_round_robin() {
-    if (servers_.empty()) return "";
-    
-    auto it = servers_.begin();
-    std::advance(it, current_server_index_++ % servers_.size());
-    it->second.stats.last_used = std::chrono::steady_clock::now();
-    return it->first;
-}
-
-std::string LoadBalancer::get_next_server_least_connections() {
-    if (servers_.empty()) return "";
-    
-    auto it = std::min_element(servers_.begin(), servers_.end(),
-        [](const auto& a, const auto& b) {
-            return a.second.stats.active_connections < b.second.stats.active_connections;
-        });
-    
-    it->second.stats.last_used = std::chrono::steady_clock::now();
-    return it->first;
-}
-
-std::string LoadBalancer::get_next_server_weighted_round_robin() {
-    if (servers_.empty()) return "";
-    
-    uint32_t total_weight = 0;
-    for (const auto& server : servers_) {
-        total_weight += server.second.stats.weight;
-    }
-    
-    static thread_local std::random_device rd;
-    static thread_local std::mt19937 gen(rd());
-    std::uniform_int_distribution<uint32_t> dis(0, total_weight - 1);
-    
-    uint32_t random = dis(gen);
-    uint32_t current_weight = 0;
-    
-    for (const auto& server : servers_) {
-        current_weight += server.second.stats.weight;
-        if (random < current_weight) {
-            server.second.stats.last_used = std::chrono::steady_clock::now();
-            return server.first;
-        }
-    }
-    
-    return servers_.begin()->first;
-}
-
-std::string LoadBalancer::get_next_server_least_response_time() {
-    if (servers_.empty()) return "";
-    
-    auto it = std::min_element(servers_.begin(), servers_.end(),
-        [](const auto& a, const auto& b) {
-            return a.second.stats.response_time_ms < b.second.stats.response_time_ms;
-        });
-    
-    it->second.stats.last_used = std::chrono::steady_clock::now();
-    return it->first;
+            return pick_round_robin(snapshot);
+    }
+}
+
+LoadBalancer::Server* LoadBalancer::pick_round_robin(const Snapshot& snapshot) {
+    size_t index = current_server_index_.fetch_add(1, std::memory_order_relaxed);
+    return snapshot.servers[snapshot.routable[index % snapshot.routable.size()]].get();
+}
+
+void LoadBalancer::pick_two(const Snapshot& snapshot, Server*& a, Server*& b) {
+    const size_t n = snapshot.routable.size();
+    uint64_t random = next_random();
+    uint32_t first = random_index(random, n);
+    a = snapshot.servers[snapshot.routable[first]].get();
+    if (n == 1) {
+        b = a;
+        return;
+    }
+    uint32_t second = random_index(random << 32, n - 1);
+    if (second >= first) {
+        ++second;
+    }
+    b = snapshot.servers[snapshot.routable[second]].get();
+}
+
+LoadBalancer::Server* LoadBalancer::pick_least_connections(const Snapshot& snapshot) {
+    // Power of two choices: the less busy of two random servers. Comparing
+    // two counters instead of scanning all keeps selection O(1), and the
+    // randomness stops concurrent callers from converging on one server.
+    Server* a;
+    Server* b;
+    pick_two(snapshot, a, b);
+    return b->active_connections.load(std::memory_order_relaxed) <
+           a->active_connections.load(std::memory_order_relaxed) ? b : a;
+}
+
+LoadBalancer::Server* LoadBalancer::pick_weighted(const Snapshot& snapshot) {
+    uint64_t random = next_random();
+    uint32_t slot = random_index(random, snapshot.routable.size());
+    uint64_t coin = random & 0xFFFFFFFFu;
+    if (coin >= snapshot.alias_threshold[slot]) {
+        slot = snapshot.alias[slot];
+    }
+    return snapshot.servers[snapshot.routable[slot]].get();
+}
+
+LoadBalancer::Server* LoadBalancer::pick_least_response_time(const Snapshot& snapshot) {
+    Server* a;
+    Server* b;
+    pick_two(snapshot, a, b);
+    return latency_cost(*b) < latency_cost(*a) ? b : a;
+}
+
+double LoadBalancer::latency_cost(const Server& server) {
+    // Expected wait behind the requests already in flight. A server with
+    // no latency sample yet competes on in-flight count alone.
+    double latency = server.response_time_ms.load(std::memory_order_relaxed);
+    double pending = static_cast<double>(server.active_connections.load(std::memory_order_relaxed) + 1);
+    return latency > 0.0 ? latency * pending : pending - 1.0;
+}
+
+LoadBalancer::Server* LoadBalancer::pick_ip_hash(const Snapshot& snapshot, uint64_t hash) {
+    // A key whose server is out of rotation moves on through the next table
+    // slots, and comes back when the server does
+    const auto& table = *snapshot.maglev;
+    const size_t start = random_index(hash, table.size());
+    for (size_t probe = 0; probe < kMaxHashProbes; ++probe) {
+        uint32_t slot = table[(start + probe) % table.size()];
+        if (snapshot.is_routable[slot]) {
+            return snapshot.servers[slot].get();
+        }
+    }
+    return pick_least_connections(snapshot);
+}
+
+LoadBalancer::Server* LoadBalancer::pick_consistent_hash(const Snapshot& snapshot, uint64_t hash) {
+    // Bounded loads: a server takes the key only while it is below its
+    // weighted share of all in-flight requests (this one included) plus the
+    // slack. Otherwise the key moves on through the next table slots, which
+    // are a key-specific sequence of other servers, so overflow from a hot
+    // key spreads out instead of landing on one neighbour.
+    const auto& table = *snapshot.maglev;
+    const double total = static_cast<double>(in_flight_.load(std::memory_order_relaxed) + 1);
+    const size_t start = random_index(hash, table.size());
+    for (size_t probe = 0; probe < kMaxHashProbes; ++probe) {
+        uint32_t slot = table[(start + probe) % table.size()];
+        if (!snapshot.is_routable[slot]) {
+            continue;
+        }
+        Server* server = snapshot.servers[slot].get();
+        double share = snapshot.total_weight
+            ? static_cast<double>(server->weight.load(std::memory_order_relaxed)) / snapshot.total_weight
+            : 1.0 / static_cast<double>(snapshot.routable.size());
+        auto capacity = static_cast<uint64_t>(std::ceil((1.0 + kHashLoadSlack) * total * share));
+        if (server->active_connections.load(std::memory_order_relaxed) < capacity) {
+            return server;
+        }
+    }
+    // Every probe was full or out of rotation: only possible while loads are
+    // changing under us or most servers are out
+    return pick_least_connections(snapshot);
 }
 
 void LoadBalancer::report_server_response(const std::string& address, bool success,
                                         std::chrono::milliseconds response_time) {
-    std::lock_guard<std::mutex> lock(servers_mutex_);
-    if (auto it = servers_.find(address); it != servers_.end()) {
-        update_server_stats(address, success, response_time);
+    const Snapshot& snapshot = acquire_snapshot();
+    if (auto it = snapshot.index.find(address); it != snapshot.index.end()) {
+        update_server_stats(*snapshot.servers[it->second], success, response_time);
     }
 }
 
-void LoadBalancer::update_server_stats(const std::string& address, bool success,
+void LoadBalancer::set_outlier_detection(const OutlierDetectionConfig& config) {
+    std::lock_guard<std::mutex> lock(servers_mutex_);
+    outlier_config_ = config;
+    consecutive_failure_limit_.store(config.consecutive_failures, std::memory_order_relaxed);
+    outlier_interval_ns_.store(std::chrono::nanoseconds(config.interval).count(), std::memory_order_relaxed);
+    readmission_ramp_ns_.store(std::chrono::nanoseconds(config.readmission_ramp).count(),
+                               std::memory_order_relaxed);
+    next_outlier_sweep_ns_.store(0, std::memory_order_relaxed);
+}
+
+void LoadBalancer::update_server_stats(Server& server, bool success,
                                      std::chrono::milliseconds response_time) {
-    auto& server = servers_[address];
-    server.stats.total_requests++;
-    if (!success) {
-        server.stats.failed_requests++;
+    // Responses without a matching selection must not wrap the counter
+    uint64_t active = server.active_connections.load(std::memory_order_relaxed);
+    while (active > 0 &&
+           !server.active_connections.compare_exchange_weak(active, active - 1, std::memory_order_relaxed)) {
+    }
+    if (active > 0) {
+        in_flight_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    server.total_requests.fetch_add(1, std::memory_order_relaxed);
+    server.interval_requests.fetch_add(1, std::memory_order_relaxed);
+    const int64_t now = now_ns();
+    record_latency(server, now, response_time);
+
+    // Passive health: real responses move the same streaks as the probes
+    record_health(server, success, true);
+
+    if (success) {
+        server.consecutive_failures.store(0, std::memory_order_relaxed);
+    } else {
+        server.failed_requests.fetch_add(1, std::memory_order_relaxed);
+        server.interval_failures.fetch_add(1, std::memory_order_relaxed);
+        uint32_t failures = server.consecutive_failures.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (failures >= consecutive_failure_limit_.load(std::memory_order_relaxed) &&
+            !server.ejected.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(servers_mutex_);
+            // Ignore a server removed or replaced since the snapshot was taken
+            auto it = servers_.find(server.config.address);
+            if (it != servers_.end() && it->second.get() == &server && !server.ejected.load(std::memory_order_relaxed)) {
+                eject_server(server, now);
+                publish_snapshot(false);
+            }
+        }
+    }
+
+    // Whichever report first sees the interval elapse runs the sweep
+    int64_t next_sweep = next_outlier_sweep_ns_.load(std::memory_order_relaxed);
+    if (now >= next_sweep &&
+        next_outlier_sweep_ns_.compare_exchange_strong(next_sweep, now + outlier_interval_ns_.load(std::memory_order_relaxed),
+                                                       std::memory_order_relaxed)) {
+        sweep_outliers(now);
     }
-    
-    // Exponential moving average for response time
-    const double alpha = 0.1;
-    server.stats.response_time_ms = alpha * response_time.count() +
-                                  (1 - alpha) * server.stats.response_time_ms;
 }
 
-void LoadBalancer::start_health_checks() {
-    if (health_checks_running_.exchange(true)) {
+void LoadBalancer::record_latency(Server& server, int64_t now, std::chrono::milliseconds response_time) {
+    // Peak-EWMA: a slower sample is taken as is, so a server that starts to
+    // stall loses traffic at once; faster samples pull the estimate down
+    // with a weight that grows with the time since the previous sample.
+    const double sample = static_cast<double>(response_time.count());
+    const int64_t last = server.latency_stamp_ns.exchange(now, std::memory_order_relaxed);
+    const double elapsed = static_cast<double>(std::max<int64_t>(now - last, 0));
+    const double keep = std::exp(-elapsed / static_cast<double>(kLatencyDecay.count()));
+
+    double prev = server.response_time_ms.load(std::memory_order_relaxed);
+    double next;
+    do {
+        next = sample > prev ? sample : prev * keep + sample * (1.0 - keep);
+    } while (!server.response_time_ms.compare_exchange_weak(prev, next, std::memory_order_relaxed));
+}
+
+void LoadBalancer::eject_server(Server& server, int64_t now) {
+    // Never eject more than max_ejection_percent of the servers: past that
+    // the problem is more likely upstream than in the servers themselves
+    size_t ejected = 0;
+    for (const auto& [address, other] : servers_) {
+        ejected += other->ejected.load(std::memory_order_relaxed);
+    }
+    if ((ejected + 1) * 100 > outlier_config_.max_ejection_percent * servers_.size()) {
         return;
     }
-    
-    std::thread([this]() {
-        while (health_checks_running_) {
-            std::lock_guard<std::mutex> lock(servers_mutex_);
-            for (auto& [address, server] : servers_) {
-                if (check_server_health(server)) {
-                    server.stats.is_healthy = true;
-                } else {
-                    server.stats.is_healthy = false;
-                    remove_unhealthy_server(address);
-                }
+
+    uint32_t count = std::min(server.ejection_count.load(std::memory_order_relaxed) + 1,
+                              std::max(outlier_config_.max_ejection_multiplier, 1u));
+    server.ejection_count.store(count, std::memory_order_relaxed);
+    server.ejected_until_ns.store(
+        now + std::chrono::nanoseconds(outlier_config_.base_ejection_time).count() * count,
+        std::memory_order_relaxed);
+    server.readmitted_ns.store(0, std::memory_order_relaxed);
+    server.consecutive_failures.store(0, std::memory_order_relaxed);
+    server.ejected.store(true, std::memory_order_relaxed);
+}
+
+void LoadBalancer::sweep_outliers(int64_t now) {
+    std::lock_guard<std::mutex> lock(servers_mutex_);
+    const int64_t base_ejection = std::chrono::nanoseconds(outlier_config_.base_ejection_time).count();
+    bool changed = false;
+
+    std::vector<std::pair<Server*, double>> rates;
+    for (const auto& [address, server] : servers_) {
+        uint64_t requests = server->interval_requests.exchange(0, std::memory_order_relaxed);
+        uint64_t failures = server->interval_failures.exchange(0, std::memory_order_relaxed);
+        int64_t until = server->ejected_until_ns.load(std::memory_order_relaxed);
+
+        if (server->ejected.load(std::memory_order_relaxed)) {
+            if (now >= until) {
+                server->ejected.store(false, std::memory_order_relaxed);
+                // Stamp 0 is reserved for "fully admitted"
+                server->readmitted_ns.store(std::max<int64_t>(now, 1), std::memory_order_relaxed);
+                changed = true;
             }
-            std::this_thread::sleep_for(std::chrono::seconds(5));
+            continue;
+        }
+
+        // A server that stays in for a whole base ejection time earns back
+        // one step of its ejection multiplier
+        uint32_t count = server->ejection_count.load(std::memory_order_relaxed);
+        if (count > 0 && now - until >= base_ejection) {
+            server->ejection_count.store(count - 1, std::memory_order_relaxed);
+            server->ejected_until_ns.store(now, std::memory_order_relaxed);
+        }
+
+        if (requests >= outlier_config_.success_rate_request_volume && requests > 0) {
+            rates.emplace_back(server.get(), 1.0 - static_cast<double>(failures) / static_cast<double>(requests));
+        }
+    }
+
+    if (rates.size() >= outlier_config_.success_rate_min_hosts && !rates.empty()) {
+        double mean = 0.0;
+        for (const auto& [server, rate] : rates) {
+            mean += rate;
+        }
+        mean /= static_cast<double>(rates.size());
+        double variance = 0.0;
+        for (const auto& [server, rate] : rates) {
+            variance += (rate - mean) * (rate - mean);
+        }
+        double threshold = mean - outlier_config_.success_rate_stdev_factor *
+                                  std::sqrt(variance / static_cast<double>(rates.size()));
+        for (const auto& [server, rate] : rates) {
+            if (rate < threshold) {
+                eject_server(*server, now);
+                changed |= server->ejected.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    if (changed) {
+        publish_snapshot(false);
+    }
+}
+
+namespace {
+
+bool parse_address(const std::string& host, uint16_t port, sockaddr_storage& addr, socklen_t& len) {
+    auto* v4 = reinterpret_cast<sockaddr_in*>(&addr);
+    if (inet_pton(AF_INET, host.c_str(), &v4->sin_addr) == 1) {
+        v4->sin_family = AF_INET;
+        v4->sin_port = htons(port);
+        len = sizeof(sockaddr_in);
+        return true;
+    }
+    auto* v6 = reinterpret_cast<sockaddr_in6*>(&addr);
+    if (inet_pton(AF_INET6, host.c_str(), &v6->sin6_addr) == 1) {
+        v6->sin6_family = AF_INET6;
+        v6->sin6_port = htons(port);
+        len = sizeof(sockaddr_in6);
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+LoadBalancer::HealthChecker::HealthChecker(LoadBalancer& owner)
+    : owner_(owner) {
+    if (core_event_loop_create(&loop_) != CORE_SUCCESS) {
+        loop_ = nullptr;
+        return;
+    }
+    thread_ = std::thread(core_event_loop_run, loop_);
+}
+
+LoadBalancer::HealthChecker::~HealthChecker() {
+    if (!loop_) {
+        return;
+    }
+    core_event_loop_stop(loop_);
+    thread_.join();
+
+    // The loop thread is gone: tear the probes down from here. Pending
+    // timers are dropped by destroy; posts still queued see stopping_.
+    stopping_ = true;
+    for (auto& [key, probe] : probes_) {
+        close_probe(*probe);
+    }
+    probes_.clear();
+    core_event_loop_destroy(loop_);
+}
+
+void LoadBalancer::HealthChecker::track(const std::shared_ptr<Server>& server) {
+    auto* request = new Track{this, server};
+    if (core_event_loop_post(loop_, &HealthChecker::on_track, request) != CORE_SUCCESS) {
+        delete request;
+    }
+}
+
+void LoadBalancer::HealthChecker::on_track(void* ctx) {
+    std::unique_ptr<Track> request(static_cast<Track*>(ctx));
+    HealthChecker& checker = *request->checker;
+    if (checker.stopping_ || checker.probes_.count(request->server.get())) {
+        return;
+    }
+
+    auto probe = std::make_unique<Probe>();
+    probe->checker = &checker;
+    probe->server = std::move(request->server);
+    const ServerConfig& config = probe->server->config;
+    probe->numeric = parse_address(config.address, config.port, probe->addr, probe->addr_len);
+
+    // First probes spread over one interval so servers added together do
+    // not stay in lockstep
+    int64_t interval = std::chrono::nanoseconds(config.health_check_interval).count();
+    Probe& ref = *probe;
+    checker.probes_.emplace(probe->server.get(), std::move(probe));
+    checker.schedule(ref, static_cast<int64_t>(next_unit() * static_cast<double>(interval)));
+}
+
+void LoadBalancer::HealthChecker::schedule(Probe& probe, int64_t delay_ns) {
+    uint64_t deadline = core_task_now_ns() + static_cast<uint64_t>(std::max<int64_t>(delay_ns, 0));
+    probe.timer_pending =
+        core_event_loop_add_timer(loop_, deadline, &HealthChecker::on_timer, &probe, &probe.timer_id) == CORE_SUCCESS;
+}
+
+void LoadBalancer::HealthChecker::on_timer(void* ctx) {
+    Probe& probe = *static_cast<Probe*>(ctx);
+    HealthChecker& checker = *probe.checker;
+    probe.timer_pending = false;
+
+    if (probe.fd >= 0) {
+        // Connect did not finish within the server's timeout
+        checker.finish_probe(probe, false);
+        return;
+    }
+    if (!checker.owner_.is_current(*probe.server)) {
+        // Removed or replaced: the replacement is tracked separately
+        checker.close_probe(probe);
+        checker.probes_.erase(probe.server.get());
+        return;
+    }
+    checker.start_probe(probe);
+}
+
+void LoadBalancer::HealthChecker::start_probe(Probe& probe) {
+    const ServerConfig& config = probe.server->config;
+    const int64_t interval = std::chrono::nanoseconds(config.health_check_interval).count();
+
+    if (probe.addr_len == 0) {
+        if (!probe.resolving) {
+            auto* request = new Resolve{this, probe.server.get(), config.address, config.port};
+            probe.resolving = core_event_loop_offload(loop_, &HealthChecker::on_resolve,
+                                                      &HealthChecker::on_resolved, request) == CORE_SUCCESS;
+            if (!probe.resolving) {
+                delete request;
+                schedule(probe, interval);
+            }
+        }
+        return;
+    }
+
+    probe.fd = socket(probe.addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (probe.fd < 0) {
+        // Out of descriptors here says nothing about the server
+        schedule(probe, interval);
+        return;
+    }
+    if (connect(probe.fd, reinterpret_cast<const sockaddr*>(&probe.addr), probe.addr_len) == 0) {
+        finish_probe(probe, true);
+        return;
+    }
+    if (errno != EINPROGRESS ||
+        core_event_loop_add_fd(loop_, probe.fd, &HealthChecker::on_event, &probe, &probe.watch) != CORE_SUCCESS) {
+        finish_probe(probe, false);
+        return;
+    }
+    schedule(probe, std::chrono::nanoseconds(config.timeout).count());
+}
+
+void LoadBalancer::HealthChecker::on_event(void* ctx, uint32_t events) {
+    Probe& probe = *static_cast<Probe*>(ctx);
+    if (probe.fd < 0 || !(events & (CORE_EV_WRITE | CORE_EV_ERROR))) {
+        return;
+    }
+    int error = 0;
+    socklen_t len = sizeof(error);
+    if (getsockopt(probe.fd, SOL_SOCKET, SO_ERROR, &error, &len) != 0) {
+        error = errno;
+    }
+    probe.checker->finish_probe(probe, error == 0);
+}
+
+void LoadBalancer::HealthChecker::on_resolve(void* ctx) {
+    auto& request = *static_cast<Resolve*>(ctx);
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    std::string port = std::to_string(request.port);
+    if (getaddrinfo(request.host.c_str(), port.c_str(), &hints, &result) == 0 && result) {
+        std::memcpy(&request.addr, result->ai_addr, result->ai_addrlen);
+        request.addr_len = static_cast<socklen_t>(result->ai_addrlen);
+    }
+    if (result) {
+        freeaddrinfo(result);
+    }
+}
+
+void LoadBalancer::HealthChecker::on_resolved(void* ctx) {
+    std::unique_ptr<Resolve> request(static_cast<Resolve*>(ctx));
+    HealthChecker& checker = *request->checker;
+    auto it = checker.probes_.find(request->key);
+    if (checker.stopping_ || it == checker.probes_.end()) {
+        return;
+    }
+
+    Probe& probe = *it->second;
+    probe.resolving = false;
+    if (request->addr_len == 0) {
+        checker.finish_probe(probe, false);
+        return;
+    }
+    probe.addr = request->addr;
+    probe.addr_len = request->addr_len;
+    checker.start_probe(probe);
+}
+
+void LoadBalancer::HealthChecker::finish_probe(Probe& probe, bool ok) {
+    close_probe(probe);
+    if (!ok && !probe.numeric) {
+        // Resolve again next time in case the name moved
+        probe.addr_len = 0;
+    }
+
+    probe.server->last_health_check_ns.store(now_ns(), std::memory_order_relaxed);
+    owner_.record_health(*probe.server, ok, false);
+
+    const double interval =
+        static_cast<double>(std::chrono::nanoseconds(probe.server->config.health_check_interval).count());
+    schedule(probe, static_cast<int64_t>(interval * (0.9 + 0.2 * next_unit())));
+}
+
+void LoadBalancer::HealthChecker::close_probe(Probe& probe) {
+    if (probe.timer_pending && !stopping_) {
+        core_event_loop_cancel_timer(loop_, probe.timer_id);
+    }
+    probe.timer_pending = false;
+    if (probe.watch) {
+        core_event_loop_remove_fd(loop_, probe.watch);
+        probe.watch = nullptr;
+    }
+    if (probe.fd >= 0) {
+        close(probe.fd);
+        probe.fd = -1;
+    }
+}
+
+void LoadBalancer::start_health_checks() {
+    std::lock_guard<std::mutex> lock(health_mutex_);
+    if (health_checker_) {
+        return;
+    }
+    auto checker = std::make_unique<HealthChecker>(*this);
+    if (!checker->running()) {
+        return;
+    }
+
+    std::vector<std::shared_ptr<Server>> servers;
+    {
+        std::lock_guard<std::mutex> servers_lock(servers_mutex_);
+        for (const auto& [address, server] : servers_) {
+            servers.push_back(server);
         }
-    }).detach();
+    }
+    for (const auto& server : servers) {
+        checker->track(server);
+    }
+    health_checker_ = std::move(checker);
+    health_checks_active_.store(true, std::memory_order_relaxed);
 }
 
 void LoadBalancer::stop_health_checks() {
-    health_checks_running_ = false;
+    std::unique_ptr<HealthChecker> checker;
+    {
+        std::lock_guard<std::mutex> lock(health_mutex_);
+        checker = std::move(health_checker_);
+        health_checks_active_.store(false, std::memory_order_relaxed);
+    }
+    if (!checker) {
+        return;
+    }
+    // Joins the loop thread outside the lock
+    checker.reset();
+
+    // Nothing would bring an unhealthy server back now: start from healthy,
+    // as a newly added server does
+    std::lock_guard<std::mutex> lock(servers_mutex_);
+    for (const auto& [address, server] : servers_) {
+        server->healthy.store(true, std::memory_order_relaxed);
+        server->health_failures.store(0, std::memory_order_relaxed);
+        server->health_successes.store(0, std::memory_order_relaxed);
+    }
+    publish_snapshot(false);
 }
 
-bool LoadBalancer::check_server_health(const Server& server) {
-    // Implement actual health check logic here
-    // This is a placeholder implementation
-    return true;
+void LoadBalancer::record_health(Server& server, bool ok, bool passive) {
+    if (ok) {
+        server.health_failures.store(0, std::memory_order_relaxed);
+        uint32_t successes = server.health_successes.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (successes >= kHealthyThreshold && !server.healthy.load(std::memory_order_relaxed)) {
+            set_server_health(server, true);
+        }
+    } else {
+        server.health_successes.store(0, std::memory_order_relaxed);
+        uint32_t failures = server.health_failures.fetch_add(1, std::memory_order_relaxed) + 1;
+        // Without probes nothing would re-admit a server that responses took
+        // out; outlier ejection, with its timed return, covers that case
+        if (passive && !health_checks_active_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (failures >= kUnhealthyThreshold && server.healthy.load(std::memory_order_relaxed)) {
+            set_server_health(server, false);
+        }
+    }
 }
 
-void LoadBalancer::remove_unhealthy_server(const std::string& address) {
-    servers_.erase(address);
+void LoadBalancer::set_server_health(Server& server, bool healthy) {
+    std::lock_guard<std::mutex> lock(servers_mutex_);
+    auto it = servers_.find(server.config.address);
+    // Only a change of routable set needs a new snapshot
+    if (it != servers_.end() && it->second.get() == &server &&
+        server.healthy.exchange(healthy, std::memory_order_relaxed) != healthy) {
+        publish_snapshot(false);
+    }
 }
 
-ServerStats LoadBalancer::get_server_stats(const std::string& address) const {
+bool LoadBalancer::is_current(const Server& server) const {
     std::lock_guard<std::mutex> lock(servers_mutex_);
-    if (auto it = servers_.find(address); it != servers_.end()) {
-        return it->second.stats;
+    auto it = servers_.find(server.config.address);
+    return it != servers_.end() && it->second.get() == &server;
+}
+
+ServerStats LoadBalancer::stats_of(const Server& server) {
+    ServerStats stats;
+    stats.active_connections = server.active_connections.load(std::memory_order_relaxed);
+    stats.total_requests = server.total_requests.load(std::memory_order_relaxed);
+    stats.failed_requests = server.failed_requests.load(std::memory_order_relaxed);
+    stats.last_health_check = std::chrono::steady_clock::time_point(
+        std::chrono::nanoseconds(server.last_health_check_ns.load(std::memory_order_relaxed)));
+    stats.response_time_ms = server.response_time_ms.load(std::memory_order_relaxed);
+    stats.is_healthy = server.healthy.load(std::memory_order_relaxed);
+    stats.is_ejected = server.ejected.load(std::memory_order_relaxed);
+    stats.ejection_count = server.ejection_count.load(std::memory_order_relaxed);
+    stats.weight = server.weight.load(std::memory_order_relaxed);
+    return stats;
+}
+
+ServerStats LoadBalancer::get_server_stats(const std::string& address) const {
+    const Snapshot& snapshot = acquire_snapshot();
+    if (auto it = snapshot.index.find(address); it != snapshot.index.end()) {
+        return stats_of(*snapshot.servers[it->second]);
     }
     return ServerStats{};
 }
 
 std::vector<std::pair<std::string, ServerStats>> LoadBalancer::get_all_stats() const {
-    std::lock_guard<std::mutex> lock(servers_mutex_);
+    const Snapshot& snapshot = acquire_snapshot();
     std::vector<std::pair<std::string, ServerStats>> result;
-    result.reserve(servers_.size());
-    
-    for (const auto& [address, server] : servers_) {
-        result.emplace_back(address, server.stats);
+    result.reserve(snapshot.servers.size());
+
+    for (const auto& server : snapshot.servers) {
+        result.emplace_back(server->config.address, stats_of(*server));
     }
-    
+
     return result;
 }
 
 } // namespace loadbalancer
-} // namespace core 
\ No newline at end of file
+} // namespace core
@@ -1,153 +1,298 @@
 #include "advanced_packet_processor.h"
+#include "core/drivers/packet_io_ops.h"
+#include "core/error_handling/core_errors.h"
+#ifdef USE_DPDK
 #include <rte_eal.h>
 #include <rte_ethdev.h>
 #include <rte_mbuf.h>
-#include <rte_ring.h>
 #include <rte_mempool.h>
-#include <rte_cycles.h>
-#include <rte_timer.h>
-#include <rte_cryptodev.h>
+#endif
 #include <openssl/ssl.h>
 #include <openssl/err.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <thread>
 #include <mutex>
 #include <queue>
 #include <functional>
 #include <stdexcept>
 #include <atomic>
+#include <unordered_map>
 
 namespace core {
 namespace network {
 
+namespace {
+
+constexpr size_t BURST_SIZE = 32;
+constexpr int IDLE_WAIT_MS = 100;   // how often an idle processing thread checks for stop
+constexpr uint16_t ETHER_TYPE_IPV4 = 0x0800;
+constexpr size_t ETHER_HEADER_LEN = 14;
+constexpr size_t IPV4_HEADER_LEN = 20;
+
+// AF_XDP or AF_PACKET through the core packet I/O driver. Frames are read in
+// place from memory shared with the kernel and go back to it on the next burst.
+class KernelPacketIo : public PacketIoBackend {
+public:
+    KernelPacketIo(const std::string& interface, int backend, size_t ring_size) {
+        core_packet_io_config_t config{};
+        config.frame_count = static_cast<uint32_t>(ring_size);
+        config.promiscuous = 1;
+        int result = core_packet_io_open(interface.c_str(), backend, &config, &io_);
+        if (result != CORE_SUCCESS) {
+            throw std::runtime_error("Failed to open packet I/O on " + interface + ": " + core_strerror(result));
+        }
+    }
+
+    ~KernelPacketIo() override {
+        core_packet_io_close(io_);
+    }
+
+    const char* name() const override {
+        if (core_packet_io_backend(io_) != CORE_PACKET_IO_AF_XDP) {
+            return "af_packet";
+        }
+        return core_packet_io_zero_copy(io_) ? "af_xdp (zero-copy)" : "af_xdp";
+    }
+
+    size_t receive_burst(PacketBuffer* packets, size_t max) override {
+        std::array<core_packet_t, BURST_SIZE> frames;
+        const size_t count = core_packet_io_rx_burst(io_, frames.data(), std::min(max, frames.size()));
+        for (size_t i = 0; i < count; ++i) {
+            packets[i].data = const_cast<void*>(frames[i].data);
+            packets[i].size = frames[i].len;
+        }
+        return count;
+    }
+
+    bool wait(int timeout_ms) override {
+        return core_packet_io_wait(io_, timeout_ms) > 0;
+    }
+
+private:
+    core_packet_io_t* io_{nullptr};
+};
+
+#ifdef USE_DPDK
+constexpr uint16_t RX_RING_SIZE = 1024;
+constexpr uint16_t TX_RING_SIZE = 1024;
+
+// Poll-mode DPDK port. The mbufs of a burst are freed on the next one.
+class DpdkPacketIo : public PacketIoBackend {
+public:
+    DpdkPacketIo(const std::string& interface, size_t ring_size) {
+        // Initialize DPDK EAL
+        int ret = rte_eal_init(0, nullptr);
+        if (ret < 0) {
+            throw std::runtime_error("Failed to initialize DPDK EAL");
+        }
+
+        // Create memory pool for mbufs
+        mbuf_pool_ = rte_pktmbuf_pool_create("mbuf_pool", ring_size,
+                                             0, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+                                             rte_socket_id());
+        if (!mbuf_pool_) {
+            rte_eal_cleanup();
+            throw std::runtime_error("Failed to create mbuf pool");
+        }
+
+        // Find port ID for the specified interface
+        if (rte_eth_dev_get_port_by_name(interface.c_str(), &port_id_) != 0) {
+            release();
+            throw std::runtime_error("Interface not found: " + interface);
+        }
+
+        struct rte_eth_conf port_conf;
+        memset(&port_conf, 0, sizeof(port_conf));
+
+        // Configure the Ethernet device with one RX and one TX queue
+        ret = rte_eth_dev_configure(port_id_, 1, 1, &port_conf);
+        if (ret == 0) {
+            ret = rte_eth_rx_queue_setup(port_id_, 0, RX_RING_SIZE,
+                                         rte_eth_dev_socket_id(port_id_), nullptr, mbuf_pool_);
+        }
+        if (ret == 0) {
+            ret = rte_eth_tx_queue_setup(port_id_, 0, TX_RING_SIZE,
+                                         rte_eth_dev_socket_id(port_id_), nullptr);
+        }
+        if (ret == 0) {
+            ret = rte_eth_dev_start(port_id_);
+        }
+        if (ret < 0) {
+            release();
+            throw std::runtime_error("Failed to start port " + std::to_string(port_id_));
+        }
+        started_ = true;
+
+        // Enable promiscuous mode
+        rte_eth_promiscuous_enable(port_id_);
+    }
+
+    ~DpdkPacketIo() override {
+        free_held();
+        release();
+    }
+
+    const char* name() const override {
+        return "dpdk";
+    }
+
+    size_t receive_burst(PacketBuffer* packets, size_t max) override {
+        free_held();
+        held_count_ = rte_eth_rx_burst(port_id_, 0, held_.data(),
+                                       static_cast<uint16_t>(std::min(max, held_.size())));
+        for (uint16_t i = 0; i < held_count_; ++i) {
+            packets[i].data = rte_pktmbuf_mtod(held_[i], void*);
+            packets[i].size = rte_pktmbuf_pkt_len(held_[i]);
+        }
+        return held_count_;
+    }
+
+    // Poll-mode driver: there is nothing to sleep on, the burst itself polls
+    bool wait(int) override {
+        return true;
+    }
+
+private:
+    void free_held() {
+        for (uint16_t i = 0; i < held_count_; ++i) {
+            rte_pktmbuf_free(held_[i]);
+        }
+        held_count_ = 0;
+    }
+
+    void release() {
+        if (started_) {
+            rte_eth_dev_stop(port_id_);
+        }
+        rte_mempool_free(mbuf_pool_);
+        rte_eal_cleanup();
+    }
+
+    struct rte_mempool* mbuf_pool_{nullptr};
+    uint16_t port_id_{0};
+    bool started_{false};
+    std::array<struct rte_mbuf*, BURST_SIZE> held_{};
+    uint16_t held_count_{0};
+};
+#endif
+
+} // namespace
+
+std::unique_ptr<PacketIoBackend> make_packet_io_backend(const std::string& interface,
+                                                        PacketIoKind kind, size_t ring_size) {
+    switch (kind) {
+    case PacketIoKind::AfXdp:
+        return std::make_unique<KernelPacketIo>(interface, CORE_PACKET_IO_AF_XDP, ring_size);
+    case PacketIoKind::AfPacket:
+        return std::make_unique<KernelPacketIo>(interface, CORE_PACKET_IO_AF_PACKET, ring_size);
+    case PacketIoKind::Dpdk:
+#ifdef USE_DPDK
+        return std::make_unique<DpdkPacketIo>(interface, ring_size);
+#else
+        throw std::runtime_error("DPDK support is not compiled in");
+#endif
+    case PacketIoKind::Auto:
+    default:
+        return std::make_unique<KernelPacketIo>(interface, CORE_PACKET_IO_AUTO, ring_size);
+    }
+}
+
 // AdvancedPacketProcessor Implementation
 struct AdvancedPacketProcessor::Impl {
-    struct rte_ring* packet_ring;
-    struct rte_mempool* mbuf_pool;
+    size_t ring_size{0};
+    std::unique_ptr<PacketIoBackend> backend;
     std::unordered_map<uint16_t, std::function<void(PacketBuffer&&)>> protocol_handlers;
     std::atomic<bool> rdma_enabled{false};
     std::atomic<bool> processing_active{false};
     std::thread processing_thread;
     std::mutex handler_mutex;
-    
-    // DPDK specific members
-    uint16_t port_id;
-    struct rte_eth_conf port_conf;
-    struct rte_eth_rxconf rx_conf;
-    struct rte_eth_txconf tx_conf;
-    
+
     // Statistics
     std::atomic<uint64_t> packets_processed{0};
     std::atomic<uint64_t> bytes_processed{0};
     std::atomic<uint64_t> errors{0};
+
+    // The one pipeline behind every backend: parse the Ethernet and IPv4
+    // headers and hand the frame to the handler registered for its ethertype
+    void dispatch(PacketBuffer* packets, size_t count);
 };
 
-AdvancedPacketProcessor::AdvancedPacketProcessor(size_t ring_size) 
+void AdvancedPacketProcessor::Impl::dispatch(PacketBuffer* packets, size_t count) {
+    std::lock_guard<std::mutex> lock(handler_mutex);
+    for (size_t i = 0; i < count; i++) {
+        PacketBuffer& buffer = packets[i];
+        const auto* bytes = static_cast<const uint8_t*>(buffer.data);
+        if (buffer.size < ETHER_HEADER_LEN) {
+            errors++;
+            continue;
+        }
+
+        // Extract protocol from Ethernet header
+        buffer.protocol = static_cast<uint16_t>(bytes[12] << 8 | bytes[13]);
+
+        // Extract source IP from IP header if present
+        buffer.source_ip = 0;
+        if (buffer.protocol == ETHER_TYPE_IPV4 && buffer.size >= ETHER_HEADER_LEN + IPV4_HEADER_LEN) {
+            const uint8_t* src = bytes + ETHER_HEADER_LEN + 12;
+            buffer.source_ip = static_cast<uint32_t>(src[0]) << 24 | static_cast<uint32_t>(src[1]) << 16 |
+                               static_cast<uint32_t>(src[2]) << 8 | src[3];
+        }
+
+        // Process packet
+        auto it = protocol_handlers.find(buffer.protocol);
+        if (it != protocol_handlers.end()) {
+            const size_t size = buffer.size;
+            it->second(std::move(buffer));
+            packets_processed++;
+            bytes_processed += size;
+        }
+    }
+}
+
+AdvancedPacketProcessor::AdvancedPacketProcessor(size_t ring_size)
     : impl_(std::make_unique<Impl>()) {
-    
-    // Initialize DPDK EAL
-    int ret = rte_eal_init(nullptr);
-    if (ret < 0) {
-        throw std::runtime_error("Failed to initialize DPDK EAL");
-    }
-    
-    // Create packet ring
-    impl_->packet_ring = rte_ring_create("packet_ring", ring_size,
-                                       rte_socket_id(), RING_F_SP_ENQ | RING_F_SC_DEQ);
-    if (!impl_->packet_ring) {
-        throw std::runtime_error("Failed to create packet ring");
-    }
-    
-    // Create memory pool for mbufs
-    impl_->mbuf_pool = rte_pktmbuf_pool_create("mbuf_pool", ring_size,
-                                             0, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
-                                             rte_socket_id());
-    if (!impl_->mbuf_pool) {
-        rte_ring_free(impl_->packet_ring);
-        throw std::runtime_error("Failed to create mbuf pool");
-    }
-    
-    // Initialize port configuration
-    memset(&impl_->port_conf, 0, sizeof(impl_->port_conf));
-    impl_->port_conf.rxmode.max_rx_pkt_len = RTE_ETHER_MAX_LEN;
-    impl_->port_conf.rxmode.split_hdr_size = 0;
-    
-    // Initialize RX configuration
-    memset(&impl_->rx_conf, 0, sizeof(impl_->rx_conf));
-    impl_->rx_conf.rx_thresh.pthresh = RX_PTHRESH;
-    impl_->rx_conf.rx_thresh.hthresh = RX_HTHRESH;
-    impl_->rx_conf.rx_thresh.wthresh = RX_WTHRESH;
-    
-    // Initialize TX configuration
-    memset(&impl_->tx_conf, 0, sizeof(impl_->tx_conf));
-    impl_->tx_conf.tx_thresh.pthresh = TX_PTHRESH;
-    impl_->tx_conf.tx_thresh.hthresh = TX_HTHRESH;
-    impl_->tx_conf.tx_thresh.wthresh = TX_WTHRESH;
+    impl_->ring_size = ring_size;
 }
 
 AdvancedPacketProcessor::~AdvancedPacketProcessor() {
     stop_processing();
-    
-    if (impl_->packet_ring) {
-        rte_ring_free(impl_->packet_ring);
-    }
-    
-    if (impl_->mbuf_pool) {
-        rte_mempool_free(impl_->mbuf_pool);
-    }
-    
-    rte_eal_cleanup();
 }
 
 void AdvancedPacketProcessor::process_packets() {
+    if (!impl_->backend) {
+        throw std::runtime_error("No packet I/O backend configured");
+    }
     if (impl_->processing_active.exchange(true)) {
         return;
     }
-    
+
     impl_->processing_thread = std::thread([this]() {
+        std::array<PacketBuffer, BURST_SIZE> burst;
         while (impl_->processing_active) {
             // Receive packets
-            struct rte_mbuf* pkts[BURST_SIZE];
-            const uint16_t nb_rx = rte_eth_rx_burst(impl_->port_id, 0, pkts, BURST_SIZE);
-            
+            if (!impl_->backend->wait(IDLE_WAIT_MS)) {
+                continue;
+            }
+            const size_t nb_rx = impl_->backend->receive_burst(burst.data(), burst.size());
             if (nb_rx == 0) {
                 continue;
             }
-            
+
             // Process received packets
-            for (uint16_t i = 0; i < nb_rx; i++) {
-                struct rte_mbuf* pkt = pkts[i];
-                
-                // Extract packet information
-                PacketBuffer buffer;
-                buffer.data = rte_pktmbuf_mtod(pkt, void*);
-                buffer.size = rte_pktmbuf_pkt_len(pkt);
-                
-                // Extract protocol from Ethernet header
-                struct rte_ether_hdr* eth_hdr = rte_pktmbuf_mtod(pkt, struct rte_ether_hdr*);
-                buffer.protocol = rte_be_to_cpu_16(eth_hdr->ether_type);
-                
-                // Extract source IP from IP header if present
-                if (buffer.protocol == RTE_ETHER_TYPE_IPV4) {
-                    struct rte_ipv4_hdr* ip_hdr = (struct rte_ipv4_hdr*)(eth_hdr + 1);
-                    buffer.source_ip = rte_be_to_cpu_32(ip_hdr->src_addr);
-                }
-                
-                // Process packet
-                std::lock_guard<std::mutex> lock(impl_->handler_mutex);
-                auto it = impl_->protocol_handlers.find(buffer.protocol);
-                if (it != impl_->protocol_handlers.end()) {
-                    it->second(std::move(buffer));
-                    impl_->packets_processed++;
-                    impl_->bytes_processed += buffer.size;
-                }
-                
-                // Free packet
-                rte_pktmbuf_free(pkt);
-            }
+            impl_->dispatch(burst.data(), nb_rx);
         }
     });
 }
 
+void AdvancedPacketProcessor::stop_processing() {
+    impl_->processing_active = false;
+    if (impl_->processing_thread.joinable()) {
+        impl_->processing_thread.join();
+    }
+}
+
 void AdvancedPacketProcessor::register_handler(uint16_t protocol,
                                             std::function<void(PacketBuffer&&)> handler) {
     std::lock_guard<std::mutex> lock(impl_->handler_mutex);
@@ -158,43 +303,23 @@ void AdvancedPacketProcessor::enable_rdma(bool enable) {
     impl_->rdma_enabled = enable;
 }
 
+void AdvancedPacketProcessor::configure_interface(const std::string& interface, PacketIoKind kind) {
+    set_backend(make_packet_io_backend(interface, kind, impl_->ring_size));
+}
+
 void AdvancedPacketProcessor::configure_dpdk(const std::string& interface) {
-    // Find port ID for the specified interface
-    impl_->port_id = rte_eth_dev_get_port_by_name(interface.c_str());
-    if (impl_->port_id == RTE_MAX_ETHPORTS) {
-        throw std::runtime_error("Interface not found: " + interface);
-    }
-    
-    // Configure the Ethernet device
-    int ret = rte_eth_dev_configure(impl_->port_id, 1, 1, &impl_->port_conf);
-    if (ret < 0) {
-        throw std::runtime_error("Failed to configure port " + std::to_string(impl_->port_id));
-    }
-    
-    // Set up RX queue
-    ret = rte_eth_rx_queue_setup(impl_->port_id, 0, RX_RING_SIZE,
-                                rte_eth_dev_socket_id(impl_->port_id),
-                                &impl_->rx_conf, impl_->mbuf_pool);
-    if (ret < 0) {
-        throw std::runtime_error("Failed to setup RX queue");
-    }
-    
-    // Set up TX queue
-    ret = rte_eth_tx_queue_setup(impl_->port_id, 0, TX_RING_SIZE,
-                                rte_eth_dev_socket_id(impl_->port_id),
-                                &impl_->tx_conf);
-    if (ret < 0) {
-        throw std::runtime_error("Failed to setup TX queue");
-    }
-    
-    // Start the Ethernet port
-    ret = rte_eth_dev_start(impl_->port_id);
-    if (ret < 0) {
-        throw std::runtime_error("Failed to start port " + std::to_string(impl_->port_id));
-    }
-    
-    // Enable promiscuous mode
-    rte_eth_promiscuous_enable(impl_->port_id);
+    configure_interface(interface, PacketIoKind::Dpdk);
+}
+
+void AdvancedPacketProcessor::set_backend(std::unique_ptr<PacketIoBackend> backend) {
+    if (impl_->processing_active) {
+        throw std::runtime_error("Cannot change the packet I/O backend while processing");
+    }
+    impl_->backend = std::move(backend);
+}
+
+const char* AdvancedPacketProcessor::backend_name() const {
+    return impl_->backend ? impl_->backend->name() : "none";
 }
 
 // QuantumSafeTunnel Implementation
@@ -0,0 +1,453 @@
+#include <gtest/gtest.h>
+#include "core/async/io.h"
+#include "core/async/task.h"
+#include "core/drivers/event_loop_ops.h"
+#include "core/drivers/task_queue_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace core::async;
+
+namespace {
+
+struct Loop {
+    core_event_loop_t* loop = nullptr;
+    Loop() { EXPECT_EQ(core_event_loop_create(&loop), CORE_SUCCESS); }
+    ~Loop() { core_event_loop_destroy(loop); }
+};
+
+// Исполнитель для проверок: свой поток с очередью сопрограмм
+class QueueExecutor {
+public:
+    QueueExecutor() : thread_([this] { run(); }) {}
+    ~QueueExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+    Executor executor() { return Executor{&QueueExecutor::post, this}; }
+    std::thread::id id() const { return thread_.get_id(); }
+
+private:
+    static void post(void* ctx, std::coroutine_handle<> handle) {
+        auto* self = static_cast<QueueExecutor*>(ctx);
+        {
+            std::lock_guard<std::mutex> lock(self->mutex_);
+            self->queue_.push_back(handle);
+        }
+        self->cv_.notify_one();
+    }
+    void run() {
+        ExecutorScope scope(executor());
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) return;
+            auto handle = queue_.front();
+            queue_.pop_front();
+            lock.unlock();
+            handle.resume();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::coroutine_handle<>> queue_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+task<int> add(int a, int b) { co_return a + b; }
+
+task<int> nested_sum(int depth) {
+    // Цепочка вложенных ожиданий: каждое завершение передаёт управление ожидающему
+    if (depth == 0) co_return 0;
+    int rest = co_await nested_sum(depth - 1);
+    co_return rest + co_await add(1, 0);
+}
+
+task<void> fail_after(Reactor& reactor, int ms) {
+    co_await sleep_for(reactor, std::chrono::milliseconds(ms));
+    throw std::runtime_error("boom");
+}
+
+task<int> value_after(Reactor& reactor, int ms, int value) {
+    co_await sleep_for(reactor, std::chrono::milliseconds(ms));
+    co_return value;
+}
+
+Socket listen_loopback(Reactor& reactor, sockaddr_in& addr) {
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    EXPECT_GE(fd, 0);
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    EXPECT_EQ(::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    EXPECT_EQ(::listen(fd, 1024), 0);
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    return Socket(reactor, fd);
+}
+
+task<void> echo(Socket conn) {
+    char buf[512];
+    for (;;) {
+        ssize_t n = co_await conn.read(buf, sizeof(buf));
+        if (n <= 0) co_return;
+        if (co_await conn.write_all(buf, static_cast<size_t>(n)) < 0) co_return;
+    }
+}
+
+task<void> serve(Reactor& reactor, Socket& listener, size_t connections) {
+    for (size_t i = 0; i < connections; ++i) {
+        ssize_t fd = co_await listener.accept();
+        if (fd < 0) throw std::runtime_error("accept failed");
+        spawn(echo(Socket(reactor, static_cast<int>(fd))));
+    }
+}
+
+task<std::string> request(Reactor& reactor, const sockaddr_in& addr, std::string message) {
+    Socket conn(reactor, ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0));
+    ssize_t rc = co_await conn.connect(reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+    if (rc != 0) throw std::runtime_error("connect failed: " + std::string(std::strerror(static_cast<int>(-rc))));
+    co_await conn.write_all(message.data(), message.size());
+    std::string reply;
+    char buf[512];
+    while (reply.size() < message.size()) {
+        ssize_t n = co_await conn.read(buf, sizeof(buf));
+        if (n <= 0) break;
+        reply.append(buf, static_cast<size_t>(n));
+    }
+    co_return reply;
+}
+
+}  // namespace
+
+TEST(EventLoopOpsTest, TimersFireInDeadlineOrderAndCancel) {
+    Loop l;
+    std::vector<int> fired;
+    struct Mark {
+        std::vector<int>* fired;
+        int id;
+    };
+    auto record = [](void* ctx) {
+        auto* m = static_cast<Mark*>(ctx);
+        m->fired->push_back(m->id);
+    };
+    Mark marks[4] = {{&fired, 0}, {&fired, 1}, {&fired, 2}, {&fired, 3}};
+    uint64_t now = core_task_now_ns();
+    uint64_t ids[4];
+    ASSERT_EQ(core_event_loop_add_timer(l.loop, now + 3000000, record, &marks[0], &ids[0]), CORE_SUCCESS);
+    ASSERT_EQ(core_event_loop_add_timer(l.loop, now + 1000000, record, &marks[1], &ids[1]), CORE_SUCCESS);
+    ASSERT_EQ(core_event_loop_add_timer(l.loop, now + 2000000, record, &marks[2], &ids[2]), CORE_SUCCESS);
+    ASSERT_EQ(core_event_loop_add_timer(l.loop, now + 1500000, record, &marks[3], &ids[3]), CORE_SUCCESS);
+    EXPECT_EQ(core_event_loop_cancel_timer(l.loop, ids[3]), CORE_SUCCESS);
+    EXPECT_EQ(core_event_loop_cancel_timer(l.loop, ids[3]), CORE_ERR_NOTFOUND);
+
+    // Цикл спит до ближайшего таймера, а не до общего таймаута
+    while (fired.size() < 3) core_event_loop_run_once(l.loop, 100000000);
+    EXPECT_GE(core_task_now_ns() - now, 3000000u);
+    EXPECT_EQ(fired, (std::vector<int>{1, 2, 0}));
+
+    // Слот сработавшего таймера переиспользуется с новым поколением
+    EXPECT_EQ(core_event_loop_cancel_timer(l.loop, ids[1]), CORE_ERR_NOTFOUND);
+    uint64_t reused;
+    ASSERT_EQ(core_event_loop_add_timer(l.loop, now, record, &marks[3], &reused), CORE_SUCCESS);
+    EXPECT_NE(reused, ids[0]);
+    EXPECT_NE(reused, ids[1]);
+    EXPECT_NE(reused, ids[2]);
+    EXPECT_EQ(core_event_loop_cancel_timer(l.loop, ids[1]), CORE_ERR_NOTFOUND);
+    core_event_loop_run_once(l.loop, 0);
+    EXPECT_EQ(fired.back(), 3);
+}
+
+TEST(EventLoopOpsTest, PostsFromManyThreadsAndOffloadCompletions) {
+    Loop l;
+    struct Ctx {
+        core_event_loop_t* loop;
+        std::atomic<int> posted{0};
+        std::atomic<int> offloaded{0};
+        std::atomic<int> done_in_loop{0};
+        std::thread::id loop_thread;
+    } ctx{l.loop, {0}, {0}, {0}, {}};
+
+    std::thread runner([&] {
+        ctx.loop_thread = std::this_thread::get_id();
+        core_event_loop_run(l.loop);
+    });
+
+    constexpr int kThreads = 4, kPosts = 2000, kJobs = 64;
+    std::vector<std::thread> posters;
+    for (int t = 0; t < kThreads; ++t) {
+        posters.emplace_back([&] {
+            for (int i = 0; i < kPosts; ++i) {
+                ASSERT_EQ(core_event_loop_post(l.loop, [](void* p) {
+                    static_cast<Ctx*>(p)->posted.fetch_add(1, std::memory_order_relaxed);
+                }, &ctx), CORE_SUCCESS);
+            }
+        });
+    }
+    for (int i = 0; i < kJobs; ++i) {
+        ASSERT_EQ(core_event_loop_offload(l.loop, [](void* p) {
+            auto* c = static_cast<Ctx*>(p);
+            EXPECT_FALSE(core_event_loop_in_loop_thread(c->loop));
+            c->offloaded.fetch_add(1);
+        }, [](void* p) {
+            auto* c = static_cast<Ctx*>(p);
+            if (core_event_loop_in_loop_thread(c->loop)) c->done_in_loop.fetch_add(1);
+        }, &ctx), CORE_SUCCESS);
+    }
+    for (auto& t : posters) t.join();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((ctx.posted.load() < kThreads * kPosts || ctx.done_in_loop.load() < kJobs) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    core_event_loop_stop(l.loop);
+    runner.join();
+    EXPECT_EQ(ctx.posted.load(), kThreads * kPosts);
+    EXPECT_EQ(ctx.offloaded.load(), kJobs);
+    EXPECT_EQ(ctx.done_in_loop.load(), kJobs);
+    EXPECT_FALSE(core_event_loop_in_loop_thread(l.loop));
+}
+
+namespace {
+
+void expect_edge_triggered_readiness(core_event_loop_t* loop) {
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds), 0);
+    struct Seen {
+        int reads = 0;
+        uint32_t last = 0;
+    } seen;
+    core_event_watch_t* watch = nullptr;
+    ASSERT_EQ(core_event_loop_add_fd(loop, fds[0], [](void* ctx, uint32_t events) {
+        auto* s = static_cast<Seen*>(ctx);
+        s->last = events;
+        if (events & CORE_EV_READ) ++s->reads;
+    }, &seen, &watch), CORE_SUCCESS);
+
+    core_event_loop_run_once(loop, 10000000);   // начальная готовность на запись
+    EXPECT_TRUE(seen.last & CORE_EV_WRITE);
+    EXPECT_EQ(seen.reads, 0);
+
+    ASSERT_EQ(::write(fds[1], "x", 1), 1);
+    core_event_loop_run_once(loop, 100000000);
+    EXPECT_EQ(seen.reads, 1);
+    // По фронту: непрочитанные данные не будят цикл повторно
+    core_event_loop_run_once(loop, 0);
+    EXPECT_EQ(seen.reads, 1);
+
+    ::close(fds[1]);
+    core_event_loop_run_once(loop, 100000000);
+    EXPECT_TRUE(seen.last & CORE_EV_ERROR);
+
+    core_event_loop_remove_fd(loop, watch);
+    int reads = seen.reads;
+    core_event_loop_run_once(loop, 0);
+    EXPECT_EQ(seen.reads, reads);
+    ::close(fds[0]);
+}
+
+}  // namespace
+
+TEST(EventLoopOpsTest, EdgeTriggeredReadinessAndRemoval) {
+    Loop l;
+    expect_edge_triggered_readiness(l.loop);
+}
+
+TEST(EventLoopOpsTest, IoUringBackendMatchesEpoll) {
+    core_event_loop_t* loop = nullptr;
+    int rc = core_event_loop_create_with(CORE_EV_BACKEND_IO_URING, &loop);
+    if (rc == CORE_ERR_UNSUPPORTED) {
+        GTEST_SKIP() << "io_uring недоступен";
+    }
+    ASSERT_EQ(rc, CORE_SUCCESS);
+    EXPECT_EQ(core_event_loop_backend(loop), CORE_EV_BACKEND_IO_URING);
+    expect_edge_triggered_readiness(loop);
+
+    // Подписки, снятые из другого потока, пока цикл ждёт
+    std::atomic<int> events{0};
+    std::thread runner([&] { core_event_loop_run(loop); });
+    std::vector<int> pairs;
+    for (int i = 0; i < 64; ++i) {
+        int fds[2];
+        ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds), 0);
+        core_event_watch_t* watch = nullptr;
+        ASSERT_EQ(core_event_loop_add_fd(loop, fds[0], [](void* ctx, uint32_t) {
+            static_cast<std::atomic<int>*>(ctx)->fetch_add(1);
+        }, &events, &watch), CORE_SUCCESS);
+        ASSERT_EQ(::write(fds[1], "x", 1), 1);
+        core_event_loop_remove_fd(loop, watch);
+        pairs.push_back(fds[0]);
+        pairs.push_back(fds[1]);
+    }
+    core_event_loop_stop(loop);
+    runner.join();
+    for (int fd : pairs) ::close(fd);
+    core_event_loop_destroy(loop);
+
+    core_event_loop_t* bad = nullptr;
+    EXPECT_EQ(core_event_loop_create_with(7, &bad), CORE_ERR_INVALID);
+}
+
+TEST(AsyncTaskTest, ChainsWhenAllAndWhenAny) {
+    EXPECT_EQ(sync_wait(add(2, 3)), 5);
+    EXPECT_EQ(sync_wait(nested_sum(1000)), 1000);
+
+    Reactor reactor;
+    reactor.start();
+
+    auto [a, unit, b] = sync_wait(when_all(value_after(reactor, 2, 7),
+                                           [](Reactor& r) -> task<void> {
+                                               co_await sleep_for(r, std::chrono::milliseconds(1));
+                                           }(reactor),
+                                           add(1, 1)));
+    EXPECT_EQ(a, 7);
+    EXPECT_EQ(b, 2);
+    (void)unit;
+
+    std::vector<task<int>> many;
+    for (int i = 0; i < 100; ++i) many.push_back(value_after(reactor, i % 5, i));
+    auto values = sync_wait(when_all(std::move(many)));
+    ASSERT_EQ(values.size(), 100u);
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(values[i], i);
+
+    // Исключение пробрасывается только после завершения всех задач
+    auto start = std::chrono::steady_clock::now();
+    std::vector<task<void>> failing;
+    failing.push_back(fail_after(reactor, 1));
+    failing.push_back([](Reactor& r) -> task<void> {
+        co_await sleep_for(r, std::chrono::milliseconds(20));
+    }(reactor));
+    EXPECT_THROW(sync_wait(when_all(std::move(failing))), std::runtime_error);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+
+    std::vector<task<int>> race;
+    race.push_back(value_after(reactor, 200, 1));
+    race.push_back(value_after(reactor, 2, 2));
+    race.push_back(value_after(reactor, 100, 3));
+    start = std::chrono::steady_clock::now();
+    auto winner = sync_wait(when_any(std::move(race)));
+    EXPECT_EQ(winner.index, 1u);
+    EXPECT_EQ(winner.value, 2);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+
+    // Проигравшие доигрывают сами: реактор останавливается после них
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    reactor.stop();
+}
+
+namespace {
+
+void expect_echo_on(Reactor& reactor) {
+    reactor.start();
+    sockaddr_in addr;
+    Socket listener = listen_loopback(reactor, addr);
+
+    constexpr size_t kConnections = 256;
+    std::vector<task<std::string>> clients;
+    for (size_t i = 0; i < kConnections; ++i) {
+        clients.push_back(request(reactor, addr, "message #" + std::to_string(i) + std::string(i % 7 * 300, 'x')));
+    }
+    auto replies = sync_wait([](Reactor& r, Socket& l, std::vector<task<std::string>> c)
+                                 -> task<std::vector<std::string>> {
+        auto [unit, replies] = co_await when_all(serve(r, l, kConnections), when_all(std::move(c)));
+        (void)unit;
+        co_return std::move(replies);
+    }(reactor, listener, std::move(clients)));
+
+    ASSERT_EQ(replies.size(), kConnections);
+    for (size_t i = 0; i < kConnections; ++i) {
+        EXPECT_EQ(replies[i], "message #" + std::to_string(i) + std::string(i % 7 * 300, 'x'));
+    }
+
+    // Соединение с закрытым портом возвращает ошибку, а не зависает
+    sockaddr_in closed = addr;
+    listener.close();
+    EXPECT_THROW(sync_wait(request(reactor, closed, "x")), std::runtime_error);
+    reactor.stop();
+}
+
+}  // namespace
+
+TEST(AsyncIoTest, EchoServesManyConnectionsOnOneReactor) {
+    Reactor reactor;
+    expect_echo_on(reactor);
+}
+
+TEST(AsyncIoTest, EchoOnIoUringReactor) {
+    core_event_loop_t* probe = nullptr;
+    if (core_event_loop_create_with(CORE_EV_BACKEND_IO_URING, &probe) != CORE_SUCCESS) {
+        GTEST_SKIP() << "io_uring недоступен";
+    }
+    core_event_loop_destroy(probe);
+    Reactor reactor(CORE_EV_BACKEND_IO_URING);
+    expect_echo_on(reactor);
+}
+
+TEST(AsyncIoTest, FileIoAndTimersResumeOnAwaitingExecutor) {
+    Reactor reactor;
+    reactor.start();
+    QueueExecutor worker;
+
+    char path[] = "/tmp/async_io_testXXXXXX";
+    int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ::unlink(path);
+
+    struct Observed {
+        std::thread::id after_write, after_read, after_sleep;
+        ssize_t written = 0, read = 0;
+        std::string data;
+        std::chrono::nanoseconds slept{0};
+    } seen;
+
+    sync_wait([](Reactor& r, Executor e, int fd, Observed& seen) -> task<void> {
+        co_await schedule(e);
+        const char text[] = "coroutine file io";
+        seen.written = co_await write_file(r, fd, text, sizeof(text) - 1, 0);
+        seen.after_write = std::this_thread::get_id();
+        char buf[64] = {};
+        seen.read = co_await read_file(r, fd, buf, sizeof(buf), 0);
+        seen.after_read = std::this_thread::get_id();
+        seen.data.assign(buf, seen.read > 0 ? static_cast<size_t>(seen.read) : 0);
+        auto start = std::chrono::steady_clock::now();
+        co_await sleep_for(r, std::chrono::milliseconds(3));
+        seen.slept = std::chrono::steady_clock::now() - start;
+        seen.after_sleep = std::this_thread::get_id();
+    }(reactor, worker.executor(), fd, seen));
+
+    EXPECT_EQ(seen.written, 17);
+    EXPECT_EQ(seen.read, 17);
+    EXPECT_EQ(seen.data, "coroutine file io");
+    EXPECT_EQ(seen.after_write, worker.id());
+    EXPECT_EQ(seen.after_read, worker.id());
+    EXPECT_EQ(seen.after_sleep, worker.id());
+    EXPECT_GE(seen.slept, std::chrono::milliseconds(3));
+
+    char buf[4];
+    EXPECT_EQ(sync_wait([](Reactor& r, char* buf) -> task<ssize_t> {
+        co_return co_await read_file(r, -1, buf, 4, 0);
+    }(reactor, buf)), -EBADF);
+    ::close(fd);
+    reactor.stop();
+}
@@ -0,0 +1,327 @@
+#include <gtest/gtest.h>
+#include "compute/compute_manager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class ComputeManagerParallelTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        savedThreads = manager.getThreadCount();
+        savedBatch = manager.getBatchSize();
+        manager.setThreadCount(4);
+        manager.setBatchSize(16);
+    }
+
+    void TearDown() override {
+        manager.setThreadCount(savedThreads);
+        manager.setBatchSize(savedBatch);
+    }
+
+    compute::ComputeManager& manager = compute::ComputeManager::getInstance();
+    size_t savedThreads = 0;
+    size_t savedBatch = 0;
+};
+
+TEST_F(ComputeManagerParallelTest, ForRangeVisitsEveryIndexOnce) {
+    for (size_t count : {1u, 15u, 16u, 17u, 1000u, 100003u}) {
+        for (size_t grain : {0u, 1u, 7u, 4096u, 1u << 30}) {
+            std::vector<std::atomic<int>> hits(count + 10);
+            bool completed = manager.parallelForRange(10, count + 10, [&](size_t b, size_t e) {
+                ASSERT_LT(b, e);
+                if (grain != 0) {
+                    ASSERT_LE(e - b, grain);
+                }
+                for (size_t i = b; i < e; ++i) hits[i]++;
+            }, grain);
+            EXPECT_TRUE(completed);
+            for (size_t i = 0; i < hits.size(); ++i) {
+                ASSERT_EQ(hits[i].load(), i < 10 ? 0 : 1) << "count=" << count << " grain=" << grain;
+            }
+        }
+    }
+    EXPECT_TRUE(manager.parallelForRange(5, 5, [](size_t, size_t) { FAIL(); }));
+}
+
+TEST_F(ComputeManagerParallelTest, ReduceMatchesSerial) {
+    std::vector<int64_t> data(200001);
+    std::iota(data.begin(), data.end(), -1000);
+    const int64_t expected = std::accumulate(data.begin(), data.end(), int64_t{0});
+
+    for (size_t grain : {0u, 1u, 333u, 1u << 20}) {
+        int64_t sum = manager.parallelReduceRange(0, data.size(), int64_t{0},
+            [&](size_t b, size_t e, int64_t acc) {
+                for (size_t i = b; i < e; ++i) acc += data[i];
+                return acc;
+            },
+            [](int64_t a, int64_t b) { return a + b; }, grain);
+        EXPECT_EQ(sum, expected) << "grain=" << grain;
+    }
+
+    int64_t maximum = manager.parallelReduceRange(0, data.size(), INT64_MIN,
+        [&](size_t b, size_t e, int64_t acc) {
+            return std::max(acc, *std::max_element(data.begin() + b, data.begin() + e));
+        },
+        [](int64_t a, int64_t b) { return std::max(a, b); });
+    EXPECT_EQ(maximum, data.back());
+    EXPECT_EQ(manager.parallelReduceRange(3, 3, 42, [](size_t, size_t, int acc) { return acc; },
+                                          [](int a, int b) { return a + b; }), 42);
+}
+
+TEST_F(ComputeManagerParallelTest, ElementwiseForAndReduce) {
+    std::vector<int> data(5000, 1);
+    manager.parallelFor(data.data(), data.size(), [](int& v) { v *= 3; });
+    EXPECT_TRUE(std::all_of(data.begin(), data.end(), [](int v) { return v == 3; }));
+    EXPECT_EQ(manager.parallelReduce(data.data(), data.size(), [](int a, int b) { return a + b; }, 7), 15007);
+    EXPECT_EQ(manager.parallelReduce(data.data(), 0, [](int a, int b) { return a + b; }, 7), 7);
+}
+
+TEST_F(ComputeManagerParallelTest, NestedCallsComplete) {
+    std::vector<std::atomic<int>> hits(64 * 500);
+    manager.parallelForRange(0, 64, [&](size_t ob, size_t oe) {
+        for (size_t outer = ob; outer < oe; ++outer) {
+            int64_t inner = manager.parallelReduceRange(0, 500, int64_t{0},
+                [&](size_t b, size_t e, int64_t acc) {
+                    for (size_t i = b; i < e; ++i) {
+                        hits[outer * 500 + i]++;
+                        acc += 1;
+                    }
+                    return acc;
+                },
+                [](int64_t a, int64_t b) { return a + b; }, 10);
+            ASSERT_EQ(inner, 500);
+        }
+    }, 1);
+    for (auto& h : hits) ASSERT_EQ(h.load(), 1);
+}
+
+TEST_F(ComputeManagerParallelTest, CancellationStopsNewChunks) {
+    compute::CancellationToken token;
+    std::atomic<size_t> chunks{0};
+    bool completed = manager.parallelForRange(0, 100000, [&](size_t, size_t) {
+        if (++chunks == 3) token.cancel();
+    }, 10, &token);
+    EXPECT_FALSE(completed);
+    EXPECT_TRUE(token.isCancelled());
+    // Каждый поток мог начать не больше одного куска после отмены
+    EXPECT_LE(chunks.load(), 3 + manager.getThreadCount());
+
+    chunks = 0;
+    EXPECT_FALSE(manager.parallelForRange(0, 1000, [&](size_t, size_t) { chunks++; }, 1, &token));
+    EXPECT_EQ(chunks.load(), 0u);
+
+    token.reset();
+    EXPECT_TRUE(manager.parallelForRange(0, 1000, [&](size_t, size_t) { chunks++; }, 1, &token));
+    EXPECT_EQ(chunks.load(), 1000u);
+}
+
+TEST_F(ComputeManagerParallelTest, ExceptionPropagatesToCaller) {
+    std::atomic<size_t> processed{0};
+    EXPECT_THROW(manager.parallelForRange(0, 10000, [&](size_t b, size_t) {
+        if (b == 500) throw std::runtime_error("chunk failed");
+        processed++;
+    }, 1), std::runtime_error);
+    EXPECT_LT(processed.load(), 10000u);
+
+    // Пул остаётся рабочим
+    std::atomic<size_t> after{0};
+    EXPECT_TRUE(manager.parallelForRange(0, 100, [&](size_t b, size_t e) { after += e - b; }, 1));
+    EXPECT_EQ(after.load(), 100u);
+}
+
+TEST_F(ComputeManagerParallelTest, ThreadCountBoundsParticipants) {
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    auto collect = [&](size_t, size_t) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    };
+
+    manager.setThreadCount(1);
+    manager.parallelForRange(0, 256, collect, 1);
+    ASSERT_EQ(threads.size(), 1u);
+    EXPECT_EQ(*threads.begin(), std::this_thread::get_id());
+
+    threads.clear();
+    manager.setThreadCount(3);
+    manager.parallelForRange(0, 256, collect, 1);
+    EXPECT_GE(threads.size(), 1u);
+    EXPECT_LE(threads.size(), 3u);
+}
+
+TEST_F(ComputeManagerParallelTest, StatsAggregateAcrossThreads) {
+    std::vector<float> a(64, 1.0f), b(64, 2.0f), out(64);
+    manager.resetStats();
+    EXPECT_EQ(manager.getStats().totalOperations, 0u);
+
+    constexpr size_t kThreads = 4, kCalls = 1000;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            std::vector<float> local(64);
+            for (size_t i = 0; i < kCalls; ++i) {
+                manager.add(local.data(), a.data(), b.data(), local.size());
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    manager.divide(out.data(), a.data(), b.data(), 8);
+    manager.parallelForRange(0, 100, [](size_t, size_t) {}, 10);
+
+    auto stats = manager.getStats();
+#ifdef COMPUTE_DISABLE_STATS
+    EXPECT_EQ(stats.totalOperations, 0u);
+#else
+    EXPECT_EQ(stats.totalOperations, kThreads * kCalls * 64 + 8);
+    EXPECT_EQ(stats.simdOperations, kThreads * kCalls * 64);
+    EXPECT_EQ(stats.scalarOperations, 8u);
+    EXPECT_EQ(stats.parallelOperations, 1u);
+    uint64_t perThread = 0;
+    for (uint64_t ops : stats.threadUtilization) perThread += ops;
+    EXPECT_EQ(perThread, stats.totalOperations);
+
+    // Слоты завершившихся потоков переиспользуются, накопленное не теряется
+    std::thread([&] { manager.add(out.data(), a.data(), b.data(), out.size()); }).join();
+    EXPECT_EQ(manager.getStats().totalOperations, stats.totalOperations + 64);
+#endif
+    EXPECT_LE(stats.startTime, std::chrono::steady_clock::now());
+
+    manager.resetStats();
+    EXPECT_EQ(manager.getStats().totalOperations, 0u);
+    EXPECT_EQ(manager.getStats().parallelOperations, 0u);
+}
+
+template<typename T>
+static void expectTypedKernelsWrap(compute::ComputeManager& manager) {
+    const size_t n = 1003;
+    std::vector<T> a(n), b(n), out(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = static_cast<T>(i * 2654435761u + 17);
+        b[i] = static_cast<T>(i * 40503u + 3);
+    }
+    using U = std::make_unsigned_t<T>;
+    U sum = 0, dot = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum = static_cast<U>(sum + static_cast<U>(a[i]));
+        dot = static_cast<U>(dot + static_cast<U>(a[i]) * static_cast<U>(b[i]));
+    }
+
+    manager.add(out.data(), a.data(), b.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(out[i], static_cast<T>(static_cast<U>(a[i]) + static_cast<U>(b[i]))) << i;
+    }
+    manager.multiply(out.data(), a.data(), b.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(out[i], static_cast<T>(static_cast<U>(a[i]) * static_cast<U>(b[i]))) << i;
+    }
+    EXPECT_EQ(manager.sum(a.data(), n), static_cast<T>(sum));
+    EXPECT_EQ(manager.template dotProduct<T>(a.data(), b.data(), n), static_cast<T>(dot));
+}
+
+TEST_F(ComputeManagerParallelTest, TypedIntegerKernelsWrapLikeScalar) {
+    expectTypedKernelsWrap<int8_t>(manager);
+    expectTypedKernelsWrap<uint8_t>(manager);
+    expectTypedKernelsWrap<int16_t>(manager);
+    expectTypedKernelsWrap<uint16_t>(manager);
+    expectTypedKernelsWrap<int32_t>(manager);
+    expectTypedKernelsWrap<uint32_t>(manager);
+    expectTypedKernelsWrap<int64_t>(manager);
+    expectTypedKernelsWrap<uint64_t>(manager);
+}
+
+TEST_F(ComputeManagerParallelTest, QuantizedOverloads) {
+    const size_t n = 777, k = 5;
+    std::vector<float> x(n), restored(n);
+    for (size_t i = 0; i < n; ++i) x[i] = std::sin(static_cast<float>(i)) * 3.0f;
+
+    const float scale = 3.0f / 127.0f;
+    std::vector<int8_t> q(n);
+    manager.quantize(q.data(), x.data(), n, scale);
+    manager.dequantize(restored.data(), q.data(), n, scale);
+    for (size_t i = 0; i < n; ++i) ASSERT_NEAR(restored[i], x[i], scale * 0.5f + 1e-6f) << i;
+
+    // int8 накапливается в int32 без переполнения
+    int32_t dot = 0;
+    for (size_t i = 0; i < n; ++i) dot += q[i] * q[i];
+    EXPECT_EQ(manager.dotProduct(q.data(), q.data(), n), dot);
+
+    std::vector<int32_t> conv(n - k + 1);
+    manager.convolution(conv.data(), q.data(), q.data() + 100, n, k);
+    for (size_t i = 0; i < conv.size(); ++i) {
+        int32_t ref = 0;
+        for (size_t j = 0; j < k; ++j) ref += q[i + j] * q[100 + j];
+        ASSERT_EQ(conv[i], ref) << i;
+    }
+
+    // bfloat16: 8 бит мантиссы, сравниваем с точностью до относительной ошибки округления
+    std::vector<core_bf16_t> h(n);
+    manager.convert(h.data(), x.data(), n);
+    manager.convert(restored.data(), h.data(), n);
+    double refDot = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_NEAR(restored[i], x[i], std::fabs(x[i]) / 256.0f) << i;
+        refDot += static_cast<double>(restored[i]) * restored[i];
+    }
+    EXPECT_NEAR(manager.dotProduct(h.data(), h.data(), n), refDot, 1e-4 * refDot);
+
+    std::vector<float> fconv(n - k + 1);
+    manager.convolution(fconv.data(), h.data(), h.data() + 100, n, k);
+    for (size_t i = 0; i < fconv.size(); ++i) {
+        double ref = 0.0;
+        for (size_t j = 0; j < k; ++j) ref += static_cast<double>(restored[i + j]) * restored[100 + j];
+        ASSERT_NEAR(fconv[i], ref, 1e-4 * (std::fabs(ref) + 1.0)) << i;
+    }
+}
+
+TEST_F(ComputeManagerParallelTest, ConvolutionEngine) {
+    std::vector<float> src(5000), kernel(301);
+    for (size_t i = 0; i < src.size(); ++i) src[i] = std::sin(0.01f * static_cast<float>(i * i % 997));
+    for (size_t j = 0; j < kernel.size(); ++j) kernel[j] = std::cos(0.1f * static_cast<float>(j));
+
+    // Прежний интерфейс: для float — движок свёрток, выход тот же
+    for (size_t k : {1u, 5u, 301u}) {
+        std::vector<float> out(src.size() - k + 2, 42.0f);
+        manager.convolution(out.data(), src.data(), kernel.data(), src.size(), k);
+        for (size_t i = 0; i + 1 < out.size(); ++i) {
+            double ref = 0.0;
+            for (size_t j = 0; j < k; ++j) ref += double(src[i + j]) * kernel[j];
+            ASSERT_NEAR(out[i], ref, 1e-3) << "k=" << k << " i=" << i;
+        }
+        EXPECT_EQ(out.back(), 42.0f);
+    }
+
+    // Ядро длиннее входа больше не уходит в переполнение счётчика цикла
+    std::vector<double> small(4, 1.0), big(5, 1.0), none(1, 7.0);
+    manager.convolution(none.data(), small.data(), big.data(), small.size(), big.size());
+    EXPECT_EQ(none[0], 7.0);
+    manager.convolution(none.data(), big.data(), small.data(), big.size(), small.size());
+    EXPECT_EQ(none[0], 4.0);
+
+    // Многоканальная свёртка совпадает с суммой одноканальных
+    const size_t w = 40, h = 30, in = 3, outCh = 2;
+    std::vector<float> image(in * w * h), kernels(outCh * in * 9);
+    for (size_t i = 0; i < image.size(); ++i) image[i] = static_cast<float>(i % 13) - 6.0f;
+    for (size_t i = 0; i < kernels.size(); ++i) kernels[i] = static_cast<float>(i % 5) - 2.0f;
+    std::vector<float> multi(outCh * (w - 2) * (h - 2)), single((w - 2) * (h - 2));
+    ASSERT_TRUE(manager.convolutionMultiChannel(multi.data(), image.data(), in, outCh, w, h, kernels.data(), 3, 3,
+                                                CORE_CONV_WINOGRAD));
+    for (size_t o = 0; o < outCh; ++o) {
+        std::vector<float> sum(single.size(), 0.0f);
+        for (size_t i = 0; i < in; ++i) {
+            ASSERT_TRUE(manager.convolution2D(single.data(), image.data() + i * w * h, w, h,
+                                              kernels.data() + (o * in + i) * 9, 3, 3, CORE_CONV_DIRECT));
+            for (size_t p = 0; p < sum.size(); ++p) sum[p] += single[p];
+        }
+        for (size_t p = 0; p < sum.size(); ++p) ASSERT_NEAR(multi[o * sum.size() + p], sum[p], 1e-3f) << p;
+    }
+    EXPECT_FALSE(manager.convolution2D(single.data(), image.data(), w, h, kernels.data(), 5, 5, CORE_CONV_WINOGRAD));
+    EXPECT_FALSE(manager.convolutionBatch(single.data(), image.data(), 2, 3, kernels.data(), 4));
+}
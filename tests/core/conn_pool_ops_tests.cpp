@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include "core/drivers/conn_pool_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t kMs = 1000000ull;
+
+// Слушающий сокет на 127.0.0.1 со случайным портом; соединения завершают
+// рукопожатие в очереди accept и без вызова accept
+struct Listener {
+    int fd = -1;
+    uint16_t port = 0;
+    Listener() {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        EXPECT_EQ(bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        EXPECT_EQ(listen(fd, 64), 0);
+        socklen_t len = sizeof(addr);
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        port = ntohs(addr.sin_port);
+    }
+    ~Listener() { close(fd); }
+};
+
+struct Pool {
+    core_conn_pool_t* pool = nullptr;
+    explicit Pool(const core_conn_pool_config_t& config) {
+        EXPECT_EQ(core_conn_pool_create(&config, &pool), CORE_SUCCESS);
+    }
+    ~Pool() { core_conn_pool_destroy(pool); }
+    core_conn_pool_stats_t stats() const {
+        core_conn_pool_stats_t s{};
+        core_conn_pool_stats(pool, &s);
+        return s;
+    }
+};
+
+core_conn_pool_config_t config_with(uint32_t max_per_host, uint64_t idle_timeout_ns = 0) {
+    core_conn_pool_config_t config;
+    core_conn_pool_default_config(&config);
+    config.max_per_host = max_per_host;
+    if (idle_timeout_ns) config.idle_timeout_ns = idle_timeout_ns;
+    return config;
+}
+
+}  // namespace
+
+TEST(ConnPoolOpsTest, ReleasedConnectionIsReused) {
+    Listener server;
+    Pool pool(config_with(8));
+
+    core_pooled_conn_t* conn = nullptr;
+    ASSERT_EQ(core_conn_pool_acquire(pool.pool, "127.0.0.1", server.port, 0, &conn), CORE_SUCCESS);
+    EXPECT_EQ(core_pooled_conn_reused(conn), 0);
+    const int fd = core_pooled_conn_fd(conn);
+    core_conn_pool_release(pool.pool, conn, 1);
+
+    // Тот же поток получает то же соединение из своего кэша
+    ASSERT_EQ(core_conn_pool_acquire(pool.pool, "127.0.0.1", server.port, 0, &conn), CORE_SUCCESS);
+    EXPECT_EQ(core_pooled_conn_reused(conn), 1);
+    EXPECT_EQ(core_pooled_conn_fd(conn), fd);
+
+    // Отказ от повторного использования закрывает соединение
+    core_conn_pool_release(pool.pool, conn, 0);
+    ASSERT_EQ(core_conn_pool_acquire(pool.pool, "127.0.0.1", server.port, 0, &conn), CORE_SUCCESS);
+    EXPECT_EQ(core_pooled_conn_reused(conn), 0);
+
+    // Соединение, возвращённое другим потоком, доступно через общий поиск
+    std::thread([&] { core_conn_pool_release(pool.pool, conn, 1); }).join();
+    core_conn_pool_stats_t s = pool.stats();
+    EXPECT_EQ(s.connects, 2u);
+    EXPECT_EQ(s.reuses, 1u);
+    EXPECT_EQ(s.open, 1u);
+    EXPECT_EQ(s.idle, 1u);
+
+    // ...и уходит в повторное использование раньше нового соединения
+    ASSERT_EQ(core_conn_pool_acquire(pool.pool, "127.0.0.1", server.port, 0, &conn), CORE_SUCCESS);
+    EXPECT_EQ(core_pooled_conn_reused(conn), 1);
+    EXPECT_EQ(pool.stats().connects, 2u);
+    core_conn_pool_release(pool.pool, conn, 1);
+
+    core_pooled_conn_t* bad = nullptr;
+    EXPECT_EQ(core_conn_pool_acquire(pool.pool, nullptr, server.port, 0, &bad), CORE_ERR_INVALID);
+    EXPECT_EQ(core_conn_pool_acquire(pool.pool, "no-such-host.invalid", 80, 0, &bad), CORE_ERR_NOTFOUND);
+}
+
+TEST(ConnPoolOpsTest, PerHostLimitWaitsForRelease) {
+    Listener server;
+    Pool pool(config_with(2));
+
+    core_pooled_conn_t* a = nullptr;
+    core_pooled_conn_t* b = nullptr;
+    core_pooled_conn_t* c = nullptr;
+    ASSERT_EQ(core_conn_pool_acquire(pool.pool, "127.0.0.1", server.port, 0, &a), CORE_SUCCESS);
+    ASSERT_EQ(core_conn_pool_acquire(pool.pool, "127.0.0.1", server.port, 0, &b), CORE_SUCCESS);
+    EXPECT_EQ(core_conn_pool_acquire(pool.pool, "127.0.0.1", server.port, 50 * kMs, &c), CORE_ERR_NOMEM);
+
+    // Освобождённое другим потоком (в его кэш) забирается ожидающим
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        core_conn_pool_release(pool.pool, a, 1);
+    });
+    ASSERT_EQ(core_conn_pool_acquire(pool.pool, "127.0.0.1", server.port, 5000 * kMs, &c), CORE_SUCCESS);
+    releaser.join();
+    EXPECT_EQ(core_pooled_conn_reused(c), 1);
+    EXPECT_EQ(pool.stats().connects, 2u);
+
+    core_conn_pool_release(pool.pool, b, 1);
+    core_conn_pool_release(pool.pool, c, 1);
+}
+
+TEST(ConnPoolOpsTest, CheckoutDropsConnectionClosedByPeer) {
+    Listener server;
+    Pool pool(config_with(4));
+
+    core_pooled_conn_t* conn = nullptr;
+    ASSERT_EQ(core_conn_pool_acquire(pool.pool, "127.0.0.1", server.port, 0, &conn), CORE_SUCCESS);
+    int peer = accept(server.fd, nullptr, nullptr);
+    ASSERT_GE(peer, 0);
+    core_conn_pool_release(pool.pool, conn, 1);
+    close(peer);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    ASSERT_EQ(core_conn_pool_acquire(pool.pool, "127.0.0.1", server.port, 0, &conn), CORE_SUCCESS);
+    EXPECT_EQ(core_pooled_conn_reused(conn), 0);
+    core_conn_pool_stats_t s = pool.stats();
+    EXPECT_EQ(s.validation_failures, 1u);
+    EXPECT_EQ(s.connects, 2u);
+    EXPECT_EQ(s.open, 1u);
+    core_conn_pool_release(pool.pool, conn, 1);
+}
+
+TEST(ConnPoolOpsTest, ReapClosesIdleConnections) {
+    Listener server;
+    Pool pool(config_with(8, 30 * kMs));
+
+    std::vector<core_pooled_conn_t*> conns(6);
+    for (auto& conn : conns) {
+        ASSERT_EQ(core_conn_pool_acquire(pool.pool, "127.0.0.1", server.port, 0, &conn), CORE_SUCCESS);
+    }
+    // Часть — в кэш потока, остальные — в общий список
+    for (auto* conn : conns) core_conn_pool_release(pool.pool, conn, 1);
+    EXPECT_EQ(pool.stats().idle, 6u);
+    EXPECT_EQ(core_conn_pool_reap(pool.pool), 0u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(core_conn_pool_reap(pool.pool), 6u);
+    core_conn_pool_stats_t s = pool.stats();
+    EXPECT_EQ(s.open, 0u);
+    EXPECT_EQ(s.idle, 0u);
+    EXPECT_EQ(s.reaped, 6u);
+}
+
+TEST(ConnPoolOpsTest, ConcurrentCheckoutRespectsLimit) {
+    Listener server;
+    constexpr uint32_t kLimit = 3;
+    Pool pool(config_with(kLimit));
+
+    constexpr int kThreads = 8;
+    constexpr int kRounds = 2000;
+    std::atomic<int> in_use{0};
+    std::atomic<int> max_in_use{0};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < kRounds; ++i) {
+                core_pooled_conn_t* conn = nullptr;
+                if (core_conn_pool_acquire(pool.pool, "127.0.0.1", server.port, 10000 * kMs, &conn) !=
+                    CORE_SUCCESS) {
+                    failures.fetch_add(1);
+                    continue;
+                }
+                int now = in_use.fetch_add(1) + 1;
+                int seen = max_in_use.load();
+                while (now > seen && !max_in_use.compare_exchange_weak(seen, now)) {}
+                in_use.fetch_sub(1);
+                core_conn_pool_release(pool.pool, conn, 1);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_LE(max_in_use.load(), static_cast<int>(kLimit));
+    core_conn_pool_stats_t s = pool.stats();
+    EXPECT_LE(s.connects, kLimit);
+    EXPECT_EQ(s.reuses + s.connects, static_cast<uint64_t>(kThreads) * kRounds);
+    EXPECT_EQ(s.open, s.idle);
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include "core/drivers/conv_ops.h"
+#include "core/drivers/parallel_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+const int kAlgorithms[] = {CORE_CONV_AUTO, CORE_CONV_DIRECT, CORE_CONV_WINOGRAD, CORE_CONV_FFT};
+
+std::vector<float> random_signal(size_t n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+    std::vector<float> v(n);
+    for (auto& x : v) x = dis(gen);
+    return v;
+}
+
+// Эталон в double: out[o][y][x] = sum_i sum_r sum_c in[i][y + r][x + c] * k[o][i][r][c].
+// abs — сумма модулей слагаемых, по ней считается допуск
+struct Reference {
+    std::vector<double> out, abs;
+    double scale = 0.0;
+};
+
+Reference reference(const float* in, size_t in_stride, size_t in_plane, size_t width, size_t height,
+                    size_t in_channels, const float* kernels, size_t kw, size_t kh, size_t out_channels) {
+    size_t ow = width - kw + 1, oh = height - kh + 1;
+    Reference ref;
+    ref.out.assign(out_channels * ow * oh, 0.0);
+    ref.abs.assign(out_channels * ow * oh, 0.0);
+    for (size_t o = 0; o < out_channels; ++o) {
+        for (size_t y = 0; y < oh; ++y) {
+            for (size_t x = 0; x < ow; ++x) {
+                double acc = 0.0, abs = 0.0;
+                for (size_t i = 0; i < in_channels; ++i) {
+                    for (size_t r = 0; r < kh; ++r) {
+                        for (size_t c = 0; c < kw; ++c) {
+                            double p = double(in[i * in_plane + (y + r) * in_stride + x + c]) *
+                                       kernels[((o * in_channels + i) * kh + r) * kw + c];
+                            acc += p;
+                            abs += std::fabs(p);
+                        }
+                    }
+                }
+                size_t idx = (o * oh + y) * ow + x;
+                ref.out[idx] = acc;
+                ref.abs[idx] = abs;
+                ref.scale = std::max(ref.scale, abs);
+            }
+        }
+    }
+    return ref;
+}
+
+// Прямой алгоритм ошибается в пределах округления суммы модулей, БПФ — в пределах
+// округления относительно наибольшего выхода
+double tolerance(const Reference& ref, size_t idx) {
+    return 1e-5 * ref.abs[idx] + 2e-5 * ref.scale + 1e-6;
+}
+
+// Исполнитель на восемь "потоков", выполняющий задачи последовательно в обратном
+// порядке: проверяет разбиение на задачи независимо от числа ядер машины
+void reverse_parallel_for(void*, size_t num_tasks, void (*task)(void*, size_t), void* arg) {
+    for (size_t i = num_tasks; i-- > 0;) task(arg, i);
+}
+
+const core_executor_t kReverseExecutor = {reverse_parallel_for, nullptr, 8};
+
+bool supported(int algorithm, size_t kw, size_t kh) {
+    return algorithm != CORE_CONV_WINOGRAD || (kw == 3 && kh == 3);
+}
+
+}  // namespace
+
+TEST(ConvOpsTest, Conv1dMatchesReference) {
+    const std::pair<size_t, size_t> shapes[] = {{1, 1}, {10, 3}, {64, 64}, {100, 17}, {1000, 1},
+                                                {4099, 257}, {777, 700}, {20000, 31}};
+    for (auto [n, k] : shapes) {
+        auto in = random_signal(n, 1), kernel = random_signal(k, 2);
+        Reference ref = reference(in.data(), n, 0, n, 1, 1, kernel.data(), k, 1, 1);
+        for (int algorithm : kAlgorithms) {
+            if (!supported(algorithm, k, 1)) continue;
+            std::vector<float> out(n - k + 2, 123.0f);
+            ASSERT_EQ(core_conv1d_f32(in.data(), n, kernel.data(), k, out.data(), algorithm, nullptr), CORE_SUCCESS);
+            for (size_t i = 0; i + 1 < out.size(); ++i) {
+                ASSERT_NEAR(out[i], ref.out[i], tolerance(ref, i))
+                    << "n=" << n << " k=" << k << " algorithm=" << algorithm << " i=" << i;
+            }
+            EXPECT_EQ(out.back(), 123.0f) << "wrote past the output, n=" << n << " algorithm=" << algorithm;
+        }
+    }
+}
+
+TEST(ConvOpsTest, Conv1dBatchUsesDistances) {
+    const size_t count = 5, n = 3000, k = 129, in_dist = n + 7, out_dist = n + 3;
+    auto in = random_signal(count * in_dist, 3), kernel = random_signal(k, 4);
+    for (int algorithm : {CORE_CONV_DIRECT, CORE_CONV_FFT}) {
+        std::vector<float> out(count * out_dist, 5.0f);
+        ASSERT_EQ(core_conv1d_f32_batch(count, in.data(), in_dist, n, kernel.data(), k, out.data(), out_dist,
+                                        algorithm, core_default_executor()), CORE_SUCCESS);
+        for (size_t t = 0; t < count; ++t) {
+            Reference ref = reference(in.data() + t * in_dist, n, 0, n, 1, 1, kernel.data(), k, 1, 1);
+            for (size_t i = 0; i < n - k + 1; ++i) {
+                ASSERT_NEAR(out[t * out_dist + i], ref.out[i], tolerance(ref, i)) << "t=" << t << " i=" << i;
+            }
+            for (size_t i = n - k + 1; i < out_dist; ++i) ASSERT_EQ(out[t * out_dist + i], 5.0f);
+        }
+    }
+}
+
+TEST(ConvOpsTest, Conv2dMatchesReference) {
+    struct Shape { size_t w, h, kw, kh; };
+    const Shape shapes[] = {{3, 3, 3, 3}, {4, 5, 3, 3}, {37, 29, 3, 3}, {70, 41, 3, 3},
+                            {40, 33, 5, 7}, {65, 64, 31, 17}, {16, 16, 16, 1}};
+    for (const Shape& s : shapes) {
+        const size_t in_stride = s.w + 5, out_w = s.w - s.kw + 1, out_h = s.h - s.kh + 1, out_stride = out_w + 2;
+        auto in = random_signal(in_stride * s.h, 5), kernel = random_signal(s.kw * s.kh, 6);
+        Reference ref = reference(in.data(), in_stride, 0, s.w, s.h, 1, kernel.data(), s.kw, s.kh, 1);
+        for (int algorithm : kAlgorithms) {
+            std::vector<float> out(out_stride * out_h, -9.0f);
+            int status = core_conv2d_f32(in.data(), in_stride, s.w, s.h, kernel.data(), s.kw, s.kh,
+                                         out.data(), out_stride, algorithm, core_default_executor());
+            if (!supported(algorithm, s.kw, s.kh)) {
+                EXPECT_EQ(status, CORE_ERR_INVALID);
+                continue;
+            }
+            ASSERT_EQ(status, CORE_SUCCESS);
+            for (size_t y = 0; y < out_h; ++y) {
+                for (size_t x = 0; x < out_stride; ++x) {
+                    float v = out[y * out_stride + x];
+                    if (x >= out_w) {
+                        ASSERT_EQ(v, -9.0f);
+                        continue;
+                    }
+                    ASSERT_NEAR(v, ref.out[y * out_w + x], tolerance(ref, y * out_w + x))
+                        << s.w << "x" << s.h << " kernel " << s.kw << "x" << s.kh
+                        << " algorithm=" << algorithm << " at " << x << "," << y;
+                }
+            }
+        }
+    }
+}
+
+TEST(ConvOpsTest, MultiChannelSumsOverInputs) {
+    struct Shape { size_t w, h, kw, kh, in, out; };
+    const Shape shapes[] = {{19, 14, 3, 3, 3, 4}, {34, 9, 3, 3, 16, 8}, {23, 20, 5, 4, 2, 3}, {8, 8, 1, 1, 5, 2}};
+    for (const Shape& s : shapes) {
+        const size_t out_w = s.w - s.kw + 1, out_h = s.h - s.kh + 1;
+        auto in = random_signal(s.in * s.w * s.h, 7), kernels = random_signal(s.out * s.in * s.kw * s.kh, 8);
+        Reference ref = reference(in.data(), s.w, s.w * s.h, s.w, s.h, s.in, kernels.data(), s.kw, s.kh, s.out);
+        for (int algorithm : kAlgorithms) {
+            if (!supported(algorithm, s.kw, s.kh)) continue;
+            std::vector<float> out(s.out * out_w * out_h);
+            ASSERT_EQ(core_conv2d_f32_multi(in.data(), s.in, s.w, s.h, kernels.data(), s.kw, s.kh,
+                                            out.data(), s.out, algorithm, core_default_executor()), CORE_SUCCESS);
+            for (size_t i = 0; i < out.size(); ++i) {
+                ASSERT_NEAR(out[i], ref.out[i], tolerance(ref, i))
+                    << "channels " << s.in << "->" << s.out << " algorithm=" << algorithm << " i=" << i;
+            }
+        }
+    }
+}
+
+TEST(ConvOpsTest, ParallelMatchesSerial) {
+    const size_t w = 301, h = 157, in_channels = 4, out_channels = 6;
+    auto in = random_signal(in_channels * w * h, 9), kernels = random_signal(out_channels * in_channels * 9, 10);
+    for (int algorithm : {CORE_CONV_DIRECT, CORE_CONV_WINOGRAD, CORE_CONV_FFT}) {
+        std::vector<float> serial(out_channels * (w - 2) * (h - 2)), parallel(serial.size());
+        ASSERT_EQ(core_conv2d_f32_multi(in.data(), in_channels, w, h, kernels.data(), 3, 3,
+                                        serial.data(), out_channels, algorithm, nullptr), CORE_SUCCESS);
+        ASSERT_EQ(core_conv2d_f32_multi(in.data(), in_channels, w, h, kernels.data(), 3, 3,
+                                        parallel.data(), out_channels, algorithm, &kReverseExecutor),
+                  CORE_SUCCESS);
+        // Разбиение на задачи не меняет порядок суммирования внутри выхода
+        EXPECT_EQ(serial, parallel) << "algorithm=" << algorithm;
+    }
+}
+
+TEST(ConvOpsTest, CostModelAndErrors) {
+    EXPECT_EQ(core_conv_select(100000, 1, 3, 1, 1, 1), CORE_CONV_DIRECT);
+    EXPECT_EQ(core_conv_select(100000, 1, 2049, 1, 1, 1), CORE_CONV_FFT);
+    EXPECT_EQ(core_conv_select(512, 512, 63, 63, 1, 1), CORE_CONV_FFT);
+    EXPECT_EQ(core_conv_select(56, 56, 3, 3, 64, 64), CORE_CONV_WINOGRAD);
+    EXPECT_EQ(core_conv_select(56, 56, 5, 5, 1, 1), CORE_CONV_DIRECT);
+
+    std::vector<float> in(16, 1.0f), kernel(17, 1.0f), out(16);
+    EXPECT_EQ(core_conv1d_f32(in.data(), 16, kernel.data(), 17, out.data(), CORE_CONV_AUTO, nullptr), CORE_ERR_INVALID);
+    EXPECT_EQ(core_conv1d_f32(in.data(), 16, kernel.data(), 0, out.data(), CORE_CONV_AUTO, nullptr), CORE_ERR_INVALID);
+    EXPECT_EQ(core_conv1d_f32(nullptr, 16, kernel.data(), 3, out.data(), CORE_CONV_AUTO, nullptr), CORE_ERR_INVALID);
+    EXPECT_EQ(core_conv1d_f32(in.data(), 16, kernel.data(), 3, out.data(), 42, nullptr), CORE_ERR_INVALID);
+    EXPECT_EQ(core_conv2d_f32(in.data(), 4, 4, 4, kernel.data(), 3, 3, out.data(), 1, CORE_CONV_DIRECT, nullptr),
+              CORE_ERR_INVALID);
+    EXPECT_EQ(core_conv1d_f32_batch(0, nullptr, 0, 0, nullptr, 0, nullptr, 0, CORE_CONV_AUTO, nullptr), CORE_SUCCESS);
+
+    // Ядро во весь вход — один выход, скалярное произведение
+    ASSERT_EQ(core_conv1d_f32(in.data(), 16, kernel.data(), 16, out.data(), CORE_CONV_FFT, nullptr), CORE_SUCCESS);
+    EXPECT_NEAR(out[0], 16.0f, 1e-4f);
+}
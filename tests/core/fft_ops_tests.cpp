@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include "core/drivers/fft_ops.h"
+#include "core/drivers/compute_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Эталонные ДПФ и ДКП-II в double за O(n^2)
+std::vector<std::complex<double>> reference_dft(const std::vector<float>& interleaved, bool inverse) {
+    size_t n = interleaved.size() / 2;
+    std::vector<std::complex<double>> out(n);
+    double sign = inverse ? 1.0 : -1.0;
+    for (size_t k = 0; k < n; ++k) {
+        std::complex<double> sum = 0.0;
+        for (size_t j = 0; j < n; ++j) {
+            double angle = sign * 2.0 * M_PI * static_cast<double>((j * k) % n) / static_cast<double>(n);
+            sum += std::complex<double>(interleaved[2 * j], interleaved[2 * j + 1]) *
+                   std::complex<double>(std::cos(angle), std::sin(angle));
+        }
+        out[k] = inverse ? sum / static_cast<double>(n) : sum;
+    }
+    return out;
+}
+
+std::vector<double> reference_dct2(const std::vector<float>& x) {
+    size_t n = x.size();
+    std::vector<double> out(n);
+    for (size_t k = 0; k < n; ++k) {
+        double sum = 0.0;
+        for (size_t j = 0; j < n; ++j) sum += x[j] * std::cos(M_PI * k * (2.0 * j + 1.0) / (2.0 * n));
+        out[k] = sum;
+    }
+    return out;
+}
+
+} // namespace
+
+class FFTOpsTest : public ::testing::Test {
+protected:
+    std::vector<float> random_floats(size_t n) {
+        std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+        std::vector<float> v(n);
+        for (auto& x : v) x = dis(gen);
+        return v;
+    }
+
+    // Погрешность float-БПФ растёт как O(log n) относительно масштаба данных:
+    // tolerance — для величин порядка входа, spectrum_tolerance — для бинов порядка sqrt(n)
+    static double tolerance(size_t n) { return 1e-6 * (std::log2(n + 1.0) + 2.0); }
+    static double spectrum_tolerance(size_t n) { return tolerance(n) * std::sqrt(static_cast<double>(n)) * 2.0; }
+
+    std::mt19937 gen{11};
+};
+
+// Длины со всеми радиксами, их смесью и простыми множителями (Блюстейн)
+static const size_t kLengths[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 12, 15, 16, 17, 20, 25, 30, 32, 45, 60,
+                                  64, 97, 100, 120, 128, 243, 256, 360, 500, 625, 1000, 1024, 2310, 4096};
+
+TEST_F(FFTOpsTest, ComplexMatchesReferenceDFT) {
+    for (size_t n : kLengths) {
+        auto plan = core_fft_plan_create(CORE_FFT_C2C, n);
+        ASSERT_NE(plan, nullptr) << n;
+        EXPECT_EQ(core_fft_plan_length(plan), n);
+        auto x = random_floats(2 * n);
+        for (int dir : {CORE_FFT_FORWARD, CORE_FFT_INVERSE}) {
+            std::vector<float> out(2 * n + 8, 777.0f);
+            ASSERT_EQ(core_fft_c2c(plan, x.data(), out.data(), dir), CORE_SUCCESS);
+            auto ref = reference_dft(x, dir == CORE_FFT_INVERSE);
+            double tol = dir == CORE_FFT_INVERSE ? tolerance(n) : spectrum_tolerance(n);
+            for (size_t k = 0; k < n; ++k) {
+                ASSERT_NEAR(out[2 * k], ref[k].real(), tol) << "n=" << n << " k=" << k;
+                ASSERT_NEAR(out[2 * k + 1], ref[k].imag(), tol) << "n=" << n << " k=" << k;
+            }
+            for (size_t i = 2 * n; i < out.size(); ++i) ASSERT_EQ(out[i], 777.0f) << "write past end, n=" << n;
+        }
+        core_fft_plan_destroy(plan);
+    }
+}
+
+TEST_F(FFTOpsTest, InPlaceRoundTrip) {
+    for (size_t n : kLengths) {
+        auto plan = core_fft_plan_cached(CORE_FFT_C2C, n);
+        ASSERT_NE(plan, nullptr);
+        EXPECT_EQ(plan, core_fft_plan_cached(CORE_FFT_C2C, n));
+        auto x = random_floats(2 * n);
+        auto y = x;
+        ASSERT_EQ(core_fft_c2c(plan, y.data(), y.data(), CORE_FFT_FORWARD), CORE_SUCCESS);
+        ASSERT_EQ(core_fft_c2c(plan, y.data(), y.data(), CORE_FFT_INVERSE), CORE_SUCCESS);
+        for (size_t i = 0; i < 2 * n; ++i) ASSERT_NEAR(y[i], x[i], tolerance(n)) << "n=" << n;
+    }
+}
+
+TEST_F(FFTOpsTest, RealToComplexMatchesComplexTransform) {
+    for (size_t n : kLengths) {
+        auto plan = core_fft_plan_create(CORE_FFT_R2C, n);
+        ASSERT_NE(plan, nullptr);
+        auto x = random_floats(n);
+        std::vector<float> as_complex(2 * n, 0.0f);
+        for (size_t j = 0; j < n; ++j) as_complex[2 * j] = x[j];
+        auto ref = reference_dft(as_complex, false);
+
+        size_t bins = n / 2 + 1;
+        std::vector<float> spec(2 * bins + 4, 777.0f);
+        ASSERT_EQ(core_fft_r2c(plan, x.data(), spec.data()), CORE_SUCCESS);
+        for (size_t k = 0; k < bins; ++k) {
+            ASSERT_NEAR(spec[2 * k], ref[k].real(), spectrum_tolerance(n)) << "n=" << n << " k=" << k;
+            ASSERT_NEAR(spec[2 * k + 1], ref[k].imag(), spectrum_tolerance(n)) << "n=" << n << " k=" << k;
+        }
+        for (size_t i = 2 * bins; i < spec.size(); ++i) ASSERT_EQ(spec[i], 777.0f);
+
+        std::vector<float> back(n + 4, 777.0f);
+        ASSERT_EQ(core_fft_c2r(plan, spec.data(), back.data()), CORE_SUCCESS);
+        for (size_t j = 0; j < n; ++j) ASSERT_NEAR(back[j], x[j], tolerance(n)) << "n=" << n;
+        for (size_t i = n; i < back.size(); ++i) ASSERT_EQ(back[i], 777.0f);
+        core_fft_plan_destroy(plan);
+    }
+}
+
+TEST_F(FFTOpsTest, DCTMatchesReferenceAndInverts) {
+    for (size_t n : kLengths) {
+        auto plan = core_fft_plan_create(CORE_FFT_DCT, n);
+        ASSERT_NE(plan, nullptr);
+        auto x = random_floats(n);
+        auto ref = reference_dct2(x);
+        std::vector<float> y(n), back(n);
+        ASSERT_EQ(core_fft_dct(plan, x.data(), y.data(), CORE_FFT_FORWARD), CORE_SUCCESS);
+        for (size_t k = 0; k < n; ++k) ASSERT_NEAR(y[k], ref[k], spectrum_tolerance(n)) << "n=" << n << " k=" << k;
+        ASSERT_EQ(core_fft_dct(plan, y.data(), back.data(), CORE_FFT_INVERSE), CORE_SUCCESS);
+        for (size_t j = 0; j < n; ++j) ASSERT_NEAR(back[j], x[j], tolerance(n)) << "n=" << n;
+        core_fft_plan_destroy(plan);
+    }
+}
+
+TEST_F(FFTOpsTest, BatchedTransformsMatchSingle) {
+    const size_t n = 60, count = 5, dist = 2 * n + 6;
+    auto plan = core_fft_plan_cached(CORE_FFT_C2C, n);
+    auto in = random_floats(count * dist);
+    std::vector<float> batched(count * dist), single(2 * n);
+    ASSERT_EQ(core_fft_c2c_batch(plan, count, in.data(), dist, batched.data(), dist, CORE_FFT_FORWARD), CORE_SUCCESS);
+    for (size_t t = 0; t < count; ++t) {
+        core_fft_c2c(plan, in.data() + t * dist, single.data(), CORE_FFT_FORWARD);
+        for (size_t i = 0; i < 2 * n; ++i) ASSERT_EQ(batched[t * dist + i], single[i]);
+    }
+
+    auto rplan = core_fft_plan_cached(CORE_FFT_R2C, n);
+    auto signals = random_floats(count * n);
+    std::vector<float> spectra(count * (n + 2)), restored(count * n);
+    ASSERT_EQ(core_fft_r2c_batch(rplan, count, signals.data(), n, spectra.data(), n + 2), CORE_SUCCESS);
+    ASSERT_EQ(core_fft_c2r_batch(rplan, count, spectra.data(), n + 2, restored.data(), n), CORE_SUCCESS);
+    for (size_t i = 0; i < signals.size(); ++i) ASSERT_NEAR(restored[i], signals[i], tolerance(n));
+
+    auto dplan = core_fft_plan_cached(CORE_FFT_DCT, n);
+    std::vector<float> coeffs(count * n);
+    ASSERT_EQ(core_fft_dct_batch(dplan, count, signals.data(), n, coeffs.data(), n, CORE_FFT_FORWARD), CORE_SUCCESS);
+    ASSERT_EQ(core_fft_dct_batch(dplan, count, coeffs.data(), n, restored.data(), n, CORE_FFT_INVERSE), CORE_SUCCESS);
+    for (size_t i = 0; i < signals.size(); ++i) ASSERT_NEAR(restored[i], signals[i], tolerance(n));
+}
+
+TEST_F(FFTOpsTest, RejectsInvalidArguments) {
+    EXPECT_EQ(core_fft_plan_create(CORE_FFT_C2C, 0), nullptr);
+    EXPECT_EQ(core_fft_plan_create(42, 16), nullptr);
+    auto plan = core_fft_plan_cached(CORE_FFT_R2C, 16);
+    std::vector<float> buf(64);
+    EXPECT_EQ(core_fft_c2c(plan, buf.data(), buf.data(), CORE_FFT_FORWARD), CORE_ERR_INVALID);
+    EXPECT_EQ(core_fft_c2c(nullptr, buf.data(), buf.data(), CORE_FFT_FORWARD), CORE_ERR_INVALID);
+    EXPECT_EQ(core_fft_dct(core_fft_plan_cached(CORE_FFT_DCT, 16), buf.data(), buf.data(), 7), CORE_ERR_INVALID);
+}
+
+TEST_F(FFTOpsTest, ComputeOpsWrappers) {
+    const size_t n = 48;
+    auto x = random_floats(2 * n);
+    std::vector<float> spec(2 * n), back(2 * n);
+    core_compute_fft(x.data(), spec.data(), n);
+    auto ref = reference_dft(x, false);
+    for (size_t k = 0; k < n; ++k) ASSERT_NEAR(spec[2 * k], ref[k].real(), 1e-4);
+    core_compute_ifft(spec.data(), back.data(), n);
+    for (size_t i = 0; i < 2 * n; ++i) ASSERT_NEAR(back[i], x[i], 1e-5);
+
+    auto r = random_floats(n);
+    std::vector<float> c(n), rr(n);
+    core_compute_dct(r.data(), c.data(), n);
+    core_compute_idct(c.data(), rr.data(), n);
+    for (size_t i = 0; i < n; ++i) ASSERT_NEAR(rr[i], r[i], 1e-5);
+}
@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include "core/drivers/filter_ops.h"
+#include "core/drivers/parallel_ops.h"
+#include "core/drivers/compute_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Эталоны в double с повтором краёв, за O(r^2) на пиксель
+struct Image {
+    size_t width, height, stride;
+    std::vector<float> data;
+    float at(long x, long y) const {
+        x = std::clamp<long>(x, 0, static_cast<long>(width) - 1);
+        y = std::clamp<long>(y, 0, static_cast<long>(height) - 1);
+        return data[static_cast<size_t>(y) * stride + static_cast<size_t>(x)];
+    }
+};
+
+std::vector<double> reference_gaussian(const Image& img, float sigma) {
+    long r = static_cast<long>(std::ceil(3.0f * sigma));
+    std::vector<double> w(r + 1);
+    double sum = 0.0;
+    for (long k = 0; k <= r; ++k) {
+        w[k] = std::exp(-double(k * k) / (2.0 * sigma * sigma));
+        sum += k ? 2.0 * w[k] : w[k];
+    }
+    std::vector<double> out(img.width * img.height);
+    for (long y = 0; y < long(img.height); ++y) {
+        for (long x = 0; x < long(img.width); ++x) {
+            double acc = 0.0;
+            for (long dy = -r; dy <= r; ++dy) {
+                for (long dx = -r; dx <= r; ++dx) {
+                    acc += w[std::abs(dy)] * w[std::abs(dx)] * img.at(x + dx, y + dy);
+                }
+            }
+            out[y * img.width + x] = acc / (sum * sum);
+        }
+    }
+    return out;
+}
+
+std::vector<double> reference_bilateral(const Image& img, float sigma_space, float sigma_color) {
+    long r = static_cast<long>(std::ceil(2.0f * sigma_space));
+    std::vector<double> out(img.width * img.height);
+    for (long y = 0; y < long(img.height); ++y) {
+        for (long x = 0; x < long(img.width); ++x) {
+            double c = img.at(x, y), num = 0.0, den = 0.0;
+            for (long dy = -r; dy <= r; ++dy) {
+                for (long dx = -r; dx <= r; ++dx) {
+                    if (dy * dy + dx * dx > r * r) continue;
+                    double v = img.at(x + dx, y + dy), d = std::fabs(v - c);
+                    if (d >= 4.0 * sigma_color) continue;
+                    double wgt = std::exp(-double(dy * dy + dx * dx) / (2.0 * sigma_space * sigma_space)) *
+                                 std::exp(-d * d / (2.0 * sigma_color * sigma_color));
+                    num += wgt * v;
+                    den += wgt;
+                }
+            }
+            out[y * img.width + x] = num / den;
+        }
+    }
+    return out;
+}
+
+std::vector<float> reference_median(const Image& img, size_t k) {
+    long r = static_cast<long>(k / 2);
+    std::vector<float> out(img.width * img.height), window;
+    for (long y = 0; y < long(img.height); ++y) {
+        for (long x = 0; x < long(img.width); ++x) {
+            window.clear();
+            for (long dy = -r; dy <= r; ++dy) {
+                for (long dx = -r; dx <= r; ++dx) window.push_back(img.at(x + dx, y + dy));
+            }
+            std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+            out[y * img.width + x] = window[window.size() / 2];
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+class FilterOpsTest : public ::testing::Test {
+protected:
+    Image random_image(size_t width, size_t height, size_t padding = 0) {
+        std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+        Image img{width, height, width + padding, std::vector<float>((width + padding) * height)};
+        for (auto& v : img.data) v = dis(gen);
+        return img;
+    }
+
+    // Результат с шагом строки out_stride; проверяет, что промежутки между строками не тронуты
+    template<typename Filter>
+    std::vector<float> run(const Image& img, size_t out_padding, Filter filter) {
+        size_t out_stride = img.width + out_padding;
+        std::vector<float> out(out_stride * img.height, -7.0f);
+        EXPECT_EQ(filter(out.data(), out_stride), CORE_SUCCESS);
+        std::vector<float> packed(img.width * img.height);
+        for (size_t y = 0; y < img.height; ++y) {
+            for (size_t x = 0; x < out_stride; ++x) {
+                if (x < img.width) {
+                    packed[y * img.width + x] = out[y * out_stride + x];
+                } else {
+                    EXPECT_EQ(out[y * out_stride + x], -7.0f) << "wrote into row padding";
+                }
+            }
+        }
+        return packed;
+    }
+
+    std::mt19937 gen{5};
+};
+
+// Размеры меньше тайла, не кратные вектору и шире одного тайла
+static const size_t kSizes[][2] = {{1, 1}, {3, 2}, {17, 9}, {64, 33}, {300, 21}, {517, 40}};
+
+TEST_F(FilterOpsTest, GaussianMatchesReference) {
+    for (auto& s : kSizes) {
+        for (float sigma : {0.6f, 1.5f, 4.0f}) {
+            Image img = random_image(s[0], s[1], 3);
+            auto got = run(img, 5, [&](float* out, size_t stride) {
+                return core_filter_gaussian(img.data.data(), img.stride, out, stride, img.width, img.height,
+                                            sigma, core_default_executor());
+            });
+            auto ref = reference_gaussian(img, sigma);
+            for (size_t i = 0; i < ref.size(); ++i) {
+                ASSERT_NEAR(got[i], ref[i], 2e-5) << s[0] << "x" << s[1] << " sigma=" << sigma << " i=" << i;
+            }
+        }
+    }
+}
+
+TEST_F(FilterOpsTest, BilateralMatchesReference) {
+    for (auto& s : kSizes) {
+        Image img = random_image(s[0], s[1]);
+        auto got = run(img, 0, [&](float* out, size_t stride) {
+            return core_filter_bilateral(img.data.data(), img.stride, out, stride, img.width, img.height,
+                                         1.5f, 0.2f, core_default_executor());
+        });
+        auto ref = reference_bilateral(img, 1.5f, 0.2f);
+        // Шаг таблицы яркостных весов — 4*sigma/4095
+        for (size_t i = 0; i < ref.size(); ++i) ASSERT_NEAR(got[i], ref[i], 2e-3) << "i=" << i;
+    }
+}
+
+TEST_F(FilterOpsTest, SmallMedianIsExact) {
+    for (auto& s : kSizes) {
+        for (size_t k : {3u, 5u, 7u}) {
+            Image img = random_image(s[0], s[1], 1);
+            auto got = run(img, 2, [&](float* out, size_t stride) {
+                return core_filter_median(img.data.data(), img.stride, out, stride, img.width, img.height, k,
+                                          core_default_executor());
+            });
+            ASSERT_EQ(got, reference_median(img, k)) << s[0] << "x" << s[1] << " k=" << k;
+        }
+    }
+}
+
+TEST_F(FilterOpsTest, LargeMedianWithinQuantization) {
+    for (auto& s : kSizes) {
+        for (size_t k : {9u, 15u}) {
+            Image img = random_image(s[0], s[1]);
+            auto got = run(img, 0, [&](float* out, size_t stride) {
+                return core_filter_median(img.data.data(), img.stride, out, stride, img.width, img.height, k,
+                                          core_default_executor());
+            });
+            auto ref = reference_median(img, k);
+            auto [lo, hi] = std::minmax_element(img.data.begin(), img.data.end());
+            double tol = (*hi - *lo) / 510.0 + 1e-6;
+            for (size_t i = 0; i < ref.size(); ++i) ASSERT_NEAR(got[i], ref[i], tol) << "k=" << k << " i=" << i;
+        }
+    }
+
+    // Постоянное изображение — без деления на нулевой диапазон
+    std::vector<float> flat(40 * 30, 3.25f), out(flat.size());
+    ASSERT_EQ(core_filter_median(flat.data(), 40, out.data(), 40, 40, 30, 11, nullptr), CORE_SUCCESS);
+    for (float v : out) ASSERT_EQ(v, 3.25f);
+}
+
+TEST_F(FilterOpsTest, ParallelMatchesSerial) {
+    Image img = random_image(700, 301);
+    std::vector<float> serial(img.data.size()), parallel(img.data.size());
+    core_executor_t threads = {
+        [](void*, size_t n, void (*task)(void*, size_t), void* arg) {
+            std::vector<std::thread> pool;
+            std::atomic<size_t> next{0};
+            for (int t = 0; t < 4; ++t) {
+                pool.emplace_back([&] { for (size_t i = next++; i < n; i = next++) task(arg, i); });
+            }
+            for (auto& t : pool) t.join();
+        },
+        nullptr, 4};
+
+    core_filter_gaussian(img.data.data(), 700, serial.data(), 700, 700, 301, 2.0f, nullptr);
+    core_filter_gaussian(img.data.data(), 700, parallel.data(), 700, 700, 301, 2.0f, &threads);
+    EXPECT_EQ(serial, parallel);
+    core_filter_median(img.data.data(), 700, serial.data(), 700, 700, 301, 21, nullptr);
+    core_filter_median(img.data.data(), 700, parallel.data(), 700, 700, 301, 21, &threads);
+    EXPECT_EQ(serial, parallel);
+}
+
+TEST_F(FilterOpsTest, DefaultExecutorRunsEveryTaskOnceAndNests) {
+    const core_executor_t* ex = core_default_executor();
+    ASSERT_NE(ex, nullptr);
+    EXPECT_GE(ex->num_threads, 1u);
+
+    std::vector<std::atomic<int>> hits(1000);
+    struct Ctx { std::vector<std::atomic<int>>* hits; const core_executor_t* ex; } ctx{&hits, ex};
+    core_parallel_for(ex, 10, [](void* arg, size_t outer) {
+        auto* c = static_cast<Ctx*>(arg);
+        struct Inner { std::vector<std::atomic<int>>* hits; size_t outer; } inner{c->hits, outer};
+        core_parallel_for(c->ex, 100, [](void* a, size_t i) {
+            auto* in = static_cast<Inner*>(a);
+            (*in->hits)[in->outer * 100 + i]++;
+        }, &inner);
+    }, &ctx);
+    for (auto& h : hits) ASSERT_EQ(h.load(), 1);
+}
+
+TEST_F(FilterOpsTest, RejectsInvalidArguments) {
+    std::vector<float> buf(16);
+    EXPECT_EQ(core_filter_gaussian(buf.data(), 2, buf.data(), 4, 4, 4, 1.0f, nullptr), CORE_ERR_INVALID);
+    EXPECT_EQ(core_filter_median(nullptr, 4, buf.data(), 4, 4, 4, 3, nullptr), CORE_ERR_INVALID);
+    EXPECT_EQ(core_filter_median(buf.data(), 4, buf.data(), 4, 4, 4, 300, nullptr), CORE_ERR_INVALID);
+    EXPECT_EQ(core_filter_bilateral(buf.data(), 4, buf.data(), 4, 0, 0, 1.0f, 1.0f, nullptr), CORE_SUCCESS);
+}
+
+TEST_F(FilterOpsTest, ComputeOpsWrappers) {
+    Image img = random_image(123, 45);
+    std::vector<float> out(img.data.size()), direct(img.data.size());
+    core_compute_gaussian_blur(img.data.data(), out.data(), 123, 45, 1.2f);
+    core_filter_gaussian(img.data.data(), 123, direct.data(), 123, 123, 45, 1.2f, nullptr);
+    EXPECT_EQ(out, direct);
+    core_compute_bilateral_filter(img.data.data(), out.data(), 123, 45, 2.0f, 0.1f);
+    core_filter_bilateral(img.data.data(), 123, direct.data(), 123, 123, 45, 2.0f, 0.1f, nullptr);
+    EXPECT_EQ(out, direct);
+    core_compute_median_filter(img.data.data(), out.data(), 123, 45, 5);
+    EXPECT_EQ(out, reference_median(img, 5));
+}
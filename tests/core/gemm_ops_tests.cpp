@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "core/drivers/gemm_ops.h"
+#include "core/drivers/compute_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Эталон: тройной цикл в double
+template<typename T>
+std::vector<double> reference_gemm(bool ta, bool tb, size_t m, size_t n, size_t k, double alpha,
+                                   const std::vector<T>& a, size_t lda, const std::vector<T>& b, size_t ldb,
+                                   double beta, const std::vector<T>& c, size_t ldc) {
+    std::vector<double> out(m * ldc);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            double sum = 0.0;
+            for (size_t p = 0; p < k; ++p) {
+                double av = ta ? a[p * lda + i] : a[i * lda + p];
+                double bv = tb ? b[j * ldb + p] : b[p * ldb + j];
+                sum += av * bv;
+            }
+            out[i * ldc + j] = alpha * sum + beta * c[i * ldc + j];
+        }
+    }
+    return out;
+}
+
+// Исполнитель на std::thread: задачи разбираются потоками через атомарный счётчик
+void thread_parallel_for(void* ctx, size_t num_tasks, void (*task)(void*, size_t), void* arg) {
+    size_t threads = *static_cast<size_t*>(ctx);
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (size_t i = next++; i < num_tasks; i = next++) task(arg, i);
+        });
+    }
+    for (auto& w : workers) w.join();
+}
+
+} // namespace
+
+class GemmOpsTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        core_gemm_set_blocking(nullptr);
+    }
+
+    template<typename T>
+    std::vector<T> random_matrix(size_t count) {
+        std::uniform_real_distribution<double> dis(-1.0, 1.0);
+        std::vector<T> v(count);
+        for (auto& x : v) x = static_cast<T>(dis(gen));
+        return v;
+    }
+
+    template<typename T, typename Gemm>
+    void check(Gemm gemm, bool ta, bool tb, size_t m, size_t n, size_t k, double alpha, double beta,
+               const core_gemm_executor_t* executor, double tol) {
+        size_t lda = (ta ? m : k) + 3, ldb = (tb ? k : n) + 1, ldc = n + 2;
+        auto a = random_matrix<T>((ta ? k : m) * lda);
+        auto b = random_matrix<T>((tb ? n : k) * ldb);
+        auto c = random_matrix<T>(m * ldc);
+        auto expected = reference_gemm(ta, tb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        auto padding_before = c;
+
+        ASSERT_EQ(gemm(ta ? CORE_GEMM_TRANS : CORE_GEMM_NO_TRANS, tb ? CORE_GEMM_TRANS : CORE_GEMM_NO_TRANS,
+                       m, n, k, static_cast<T>(alpha), a.data(), lda, b.data(), ldb,
+                       static_cast<T>(beta), c.data(), ldc, executor), CORE_SUCCESS);
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < ldc; ++j) {
+                if (j < n) {
+                    ASSERT_NEAR(c[i * ldc + j], expected[i * ldc + j], tol * (k + 1))
+                        << "m=" << m << " n=" << n << " k=" << k << " at " << i << "," << j;
+                } else {
+                    ASSERT_EQ(c[i * ldc + j], padding_before[i * ldc + j]) << "wrote into row padding";
+                }
+            }
+        }
+    }
+
+    std::mt19937 gen{7};
+};
+
+TEST_F(GemmOpsTest, BlockingDerivedFromCacheConfig) {
+    core_gemm_blocking_t blk;
+    core_gemm_get_blocking(sizeof(float), &blk);
+    EXPECT_GT(blk.mr, 0u);
+    EXPECT_GT(blk.nr, 0u);
+    EXPECT_EQ(blk.mc % blk.mr, 0u);
+    EXPECT_EQ(blk.nc % blk.nr, 0u);
+    EXPECT_GE(blk.kc, 64u);
+}
+
+TEST_F(GemmOpsTest, Float32MatchesReferenceAllTransposes) {
+    const size_t sizes[][3] = {{1, 1, 1}, {5, 7, 3}, {6, 16, 8}, {13, 29, 17}, {64, 48, 100}, {37, 70, 129}};
+    for (auto& s : sizes) {
+        for (int ta = 0; ta < 2; ++ta) {
+            for (int tb = 0; tb < 2; ++tb) {
+                check<float>(core_gemm_f32, ta, tb, s[0], s[1], s[2], 1.0, 0.0, nullptr, 1e-5);
+                check<float>(core_gemm_f32, ta, tb, s[0], s[1], s[2], -0.5, 2.0, nullptr, 1e-5);
+            }
+        }
+    }
+}
+
+TEST_F(GemmOpsTest, Float64MatchesReference) {
+    for (int ta = 0; ta < 2; ++ta) {
+        for (int tb = 0; tb < 2; ++tb) {
+            check<double>(core_gemm_f64, ta, tb, 23, 41, 67, 1.5, 0.25, nullptr, 1e-12);
+        }
+    }
+}
+
+TEST_F(GemmOpsTest, SmallBlockingExercisesEveryLoopLevel) {
+    core_gemm_blocking_t blk = {};
+    blk.mc = 12;
+    blk.kc = 16;
+    blk.nc = 40;
+    core_gemm_set_blocking(&blk);
+    check<float>(core_gemm_f32, false, false, 50, 90, 70, 1.0, 1.0, nullptr, 1e-5);
+    check<double>(core_gemm_f64, true, true, 50, 90, 70, 1.0, 1.0, nullptr, 1e-12);
+}
+
+TEST_F(GemmOpsTest, ParallelExecutorMatchesReference) {
+    size_t threads = 4;
+    core_gemm_executor_t executor{thread_parallel_for, &threads, threads};
+    check<float>(core_gemm_f32, false, false, 200, 150, 90, 1.0, 0.0, &executor, 1e-5);
+    check<float>(core_gemm_f32, true, false, 7, 300, 40, 1.0, 0.0, &executor, 1e-5);
+
+    core_gemm_blocking_t blk = {};
+    blk.mc = 24;
+    blk.kc = 32;
+    core_gemm_set_blocking(&blk);
+    check<double>(core_gemm_f64, false, true, 130, 77, 100, 2.0, -1.0, &executor, 1e-12);
+}
+
+TEST_F(GemmOpsTest, RejectsInvalidStrides) {
+    std::vector<float> a(16), b(16), c(16);
+    EXPECT_EQ(core_gemm_f32(CORE_GEMM_NO_TRANS, CORE_GEMM_NO_TRANS, 4, 4, 4, 1.0f, a.data(), 3,
+                            b.data(), 4, 0.0f, c.data(), 4, nullptr), CORE_ERR_INVALID);
+    EXPECT_EQ(core_gemm_f32(CORE_GEMM_NO_TRANS, CORE_GEMM_NO_TRANS, 0, 4, 4, 1.0f, a.data(), 4,
+                            b.data(), 4, 0.0f, c.data(), 4, nullptr), CORE_SUCCESS);
+}
+
+TEST_F(GemmOpsTest, ComputeMatrixMulHandlesRaggedColumns) {
+    size_t rows = 9, inner = 11, cols = 13;
+    auto a = random_matrix<float>(rows * inner);
+    auto b = random_matrix<float>(inner * cols);
+    std::vector<float> result(rows * cols + 8, 99.0f);
+    ASSERT_EQ(core_compute_matrix_mul(a.data(), b.data(), result.data(), rows, inner, cols), CORE_SUCCESS);
+
+    std::vector<float> zero(rows * cols);
+    auto expected = reference_gemm(false, false, rows, cols, inner, 1.0, a, inner, b, cols, 0.0, zero, cols);
+    for (size_t i = 0; i < rows * cols; ++i) ASSERT_NEAR(result[i], expected[i], 1e-4);
+    for (size_t i = rows * cols; i < result.size(); ++i) ASSERT_EQ(result[i], 99.0f);
+}
@@ -4,6 +4,10 @@
 #include "core/drivers/memory_ops.h"
 #include "core/drivers/thread_ops.h"
 
+#include <set>
+#include <thread>
+#include <vector>
+
 using namespace core;
 
 class LoadBalancerTest : public ::testing::Test {
@@ -17,6 +21,21 @@ protected:
         balancer.reset();
     }
 
+    // Compute engine whose workers hold submitted tasks until resumed, so
+    // routed tasks keep their depth slots for the rest of the test
+    std::unique_ptr<MultiCoreEngine> start_paused_engine(size_t cores) {
+        std::vector<MultiCoreEngine::CoreConfig> configs;
+        for (size_t core = 0; core < cores; core++) {
+            configs.push_back({core, static_cast<size_t>(-1), true, 0, 0, false, false, false});
+        }
+        auto engine = std::make_unique<MultiCoreEngine>(configs);
+        engine->initialize();
+        engine->start();
+        engine->pause();
+        balancer->set_compute_engine(engine.get());
+        return engine;
+    }
+
     std::unique_ptr<LoadBalancer> balancer;
 };
 
@@ -204,6 +223,156 @@ TEST_F(LoadBalancerTest, DynamicScaling) {
     EXPECT_LT(balancer->get_core_count(), balancer->get_max_core_count());
 }
 
+// Test concurrent submission and cancellation
+TEST_F(LoadBalancerTest, ConcurrentSubmissionIds) {
+    constexpr size_t kCores = 4;
+    constexpr int kThreads = 8;
+    constexpr int kTasksPerThread = 500;
+    auto engine = start_paused_engine(kCores);
+    for (size_t core = 0; core < kCores; core++) {
+        balancer->update_core_metrics(core, LoadBalancer::CoreMetrics{
+            LoadBalancer::TaskMetrics{0.1, 0.1, 0.1, 0, 0},
+            std::chrono::steady_clock::now(),
+            true
+        });
+    }
+
+    std::vector<std::vector<size_t>> ids(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kTasksPerThread; i++) {
+                Task task;
+                task.type = TaskType::COMPUTE;
+                task.priority = TaskPriority::LOW;
+                task.data = "Concurrent task " + std::to_string(t) + "/" + std::to_string(i);
+                size_t task_id = balancer->submit_task(task);
+                ids[t].push_back(task_id);
+                // Cancelling every other task must not make a later ID collide
+                if (i % 2 == 0) {
+                    balancer->cancel_task(task_id);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::set<size_t> unique;
+    for (int t = 0; t < kThreads; t++) {
+        for (int i = 0; i < kTasksPerThread; i++) {
+            EXPECT_TRUE(unique.insert(ids[t][i]).second) << "duplicate task id " << ids[t][i];
+            if (i % 2 == 0) {
+                EXPECT_EQ(balancer->get_task_status(ids[t][i]), TaskStatus::CANCELLED);
+            } else {
+                EXPECT_NE(balancer->get_task_status(ids[t][i]), TaskStatus::UNKNOWN);
+            }
+        }
+    }
+    EXPECT_EQ(balancer->get_task_status(0), TaskStatus::UNKNOWN);
+
+    // Finished tasks leave the registry; their status stays readable for a while
+    engine->resume();
+    engine.reset();
+    const size_t last_id = ids[kThreads - 1][kTasksPerThread - 1];
+    EXPECT_EQ(balancer->get_task_core(last_id), static_cast<size_t>(-1));
+    EXPECT_EQ(balancer->get_task_status(last_id), TaskStatus::COMPLETED);
+}
+
+// Test two-choice routing over live queue depth
+TEST_F(LoadBalancerTest, TwoChoiceRoutingSpreadsLoad) {
+    constexpr size_t kCores = 8;
+    constexpr size_t kHotCore = 3;
+    constexpr size_t kDownCore = 5;
+    auto engine = start_paused_engine(kCores);
+    for (size_t core = 0; core < kCores; core++) {
+        double usage = core == kHotCore ? 0.95 : 0.1;
+        balancer->update_core_metrics(core, LoadBalancer::CoreMetrics{
+            LoadBalancer::TaskMetrics{usage, usage, usage, 0, 0},
+            std::chrono::steady_clock::now(),
+            core != kDownCore
+        });
+    }
+
+    constexpr int kThreads = 4;
+    constexpr int kTasksPerThread = 200;
+    std::vector<std::vector<size_t>> ids(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kTasksPerThread; i++) {
+                Task task;
+                task.type = TaskType::COMPUTE;
+                task.priority = TaskPriority::LOW;
+                task.data = "Routed task " + std::to_string(t) + "/" + std::to_string(i);
+                ids[t].push_back(balancer->submit_task(task));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<size_t> per_core(kCores, 0);
+    for (const auto& thread_ids : ids) {
+        for (size_t task_id : thread_ids) {
+            per_core[balancer->get_task_core(task_id)]++;
+        }
+    }
+
+    // Nothing goes to the unhealthy core, the hot core takes noticeably
+    // less, and no idle core is left behind while another fills up
+    const double even = double(kThreads * kTasksPerThread) / (kCores - 1);
+    EXPECT_EQ(per_core[kDownCore], 0u);
+    for (size_t core = 0; core < kCores; core++) {
+        if (core == kDownCore || core == kHotCore) {
+            continue;
+        }
+        EXPECT_LT(per_core[kHotCore], per_core[core]);
+        EXPECT_GT(per_core[core], even * 0.75);
+        EXPECT_LT(per_core[core], even * 1.5);
+    }
+
+    // Completed tasks free their slots: new work goes to the drained core
+    for (const auto& thread_ids : ids) {
+        for (size_t task_id : thread_ids) {
+            if (balancer->get_task_core(task_id) == 0) {
+                balancer->complete_task(task_id, TaskStatus::COMPLETED);
+            }
+        }
+    }
+    size_t to_drained = 0;
+    for (int i = 0; i < 20; i++) {
+        Task task;
+        task.type = TaskType::COMPUTE;
+        task.priority = TaskPriority::LOW;
+        task.data = "Refill task " + std::to_string(i);
+        to_drained += balancer->get_task_core(balancer->submit_task(task)) == 0;
+    }
+    EXPECT_GT(to_drained, 0u);
+}
+
+// Test that compute tasks nothing will run do not stay pending
+TEST_F(LoadBalancerTest, UndispatchedComputeTaskFails) {
+    balancer->update_core_metrics(0, LoadBalancer::CoreMetrics{
+        LoadBalancer::TaskMetrics{0.1, 0.1, 0.1, 0, 0},
+        std::chrono::steady_clock::now(),
+        true
+    });
+
+    Task task;
+    task.type = TaskType::COMPUTE;
+    task.priority = TaskPriority::LOW;
+    task.data = "No engine";
+    size_t task_id = balancer->submit_task(task);
+    EXPECT_EQ(balancer->get_task_status(task_id), TaskStatus::FAILED);
+
+    // Its slot was given back, so completing it again changes nothing
+    balancer->complete_task(task_id, TaskStatus::COMPLETED);
+    EXPECT_EQ(balancer->get_task_status(task_id), TaskStatus::FAILED);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
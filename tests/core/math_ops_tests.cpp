@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include "core/drivers/math_ops.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+using VectorFn = void (*)(float*, const float*, size_t);
+using ScalarFn = float (*)(float);
+
+// Ошибка в единицах последнего разряда float относительно точного значения ref
+double ulp_error(float got, double ref) {
+    if (std::isnan(ref)) return std::isnan(got) ? 0.0 : INFINITY;
+    if (std::isinf(ref)) return got == static_cast<float>(ref) ? 0.0 : INFINITY;
+    double ulp = std::fabs(ref) < FLT_MIN ? std::ldexp(1.0, -149) : std::ldexp(1.0, std::ilogb(ref) - 23);
+    // Точный результат за пределами float: правильное округление — inf
+    if (std::fabs(ref) > FLT_MAX) return std::isinf(got) && (got > 0) == (ref > 0) ? 0.0 : INFINITY;
+    return std::fabs(static_cast<double>(got) - ref) / ulp;
+}
+
+float from_bits(uint32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+} // namespace
+
+class MathOpsTest : public ::testing::Test {
+protected:
+    // Равномерная сетка по [lo, hi] плюс столько же случайных точек
+    std::vector<float> sweep(float lo, float hi, size_t n = 1 << 19) {
+        std::vector<float> x(2 * n);
+        std::uniform_real_distribution<float> dis(lo, hi);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = lo + (hi - lo) * static_cast<float>(i) / static_cast<float>(n - 1);
+            x[n + i] = dis(gen);
+        }
+        return x;
+    }
+
+    // Положительные конечные float с равномерно распределённым битовым представлением
+    std::vector<float> positive_bits(size_t n = 1 << 20) {
+        std::uniform_int_distribution<uint32_t> dis(1, 0x7F7FFFFFu);
+        std::vector<float> x(n);
+        for (auto& v : x) v = from_bits(dis(gen));
+        return x;
+    }
+
+    // Максимальная ошибка в ULP; заодно сверяет скалярный вариант с векторным
+    template<typename Ref>
+    double max_ulp(VectorFn vec, ScalarFn scalar, const std::vector<float>& x, Ref ref) {
+        std::vector<float> y(x.size());
+        vec(y.data(), x.data(), x.size());
+        double worst = 0.0;
+        for (size_t i = 0; i < x.size(); ++i) {
+            double err = ulp_error(y[i], ref(static_cast<double>(x[i])));
+            EXPECT_LE(err, 1e6) << "x=" << x[i] << " got=" << y[i];
+            if (err > 1e6) return err;
+            worst = std::max(worst, err);
+            if (i % 97 == 0) {
+                float s = scalar(x[i]);
+                EXPECT_TRUE(s == y[i] || (std::isnan(s) && std::isnan(y[i]))) << "x=" << x[i];
+            }
+        }
+        return worst;
+    }
+
+    std::mt19937 gen{11};
+};
+
+TEST_F(MathOpsTest, SinCosWithinBound) {
+    for (auto range : {3.2f, 100.0f, 8192.0f}) {
+        auto x = sweep(-range, range);
+        EXPECT_LE(max_ulp(core_vector_sin, core_fast_sin, x, [](double v) { return std::sin(v); }), 2.5) << range;
+        EXPECT_LE(max_ulp(core_vector_cos, core_fast_cos, x, [](double v) { return std::cos(v); }), 2.5) << range;
+    }
+    // Малые аргументы: sin(x) = x
+    auto tiny = sweep(-1e-4f, 1e-4f);
+    EXPECT_LE(max_ulp(core_vector_sin, core_fast_sin, tiny, [](double v) { return std::sin(v); }), 1.0);
+}
+
+TEST_F(MathOpsTest, ExpWithinBound) {
+    auto x = sweep(-104.0f, 88.7f);
+    EXPECT_LE(max_ulp(core_vector_exp, core_fast_exp, x, [](double v) { return std::exp(v); }), 1.5);
+    x = sweep(-1.0f, 1.0f);
+    EXPECT_LE(max_ulp(core_vector_exp, core_fast_exp, x, [](double v) { return std::exp(v); }), 1.5);
+}
+
+TEST_F(MathOpsTest, LogWithinBound) {
+    auto x = positive_bits();
+    EXPECT_LE(max_ulp(core_vector_log, core_fast_log, x, [](double v) { return std::log(v); }), 1.0);
+    x = sweep(0.5f, 2.0f);
+    EXPECT_LE(max_ulp(core_vector_log, core_fast_log, x, [](double v) { return std::log(v); }), 1.0);
+}
+
+TEST_F(MathOpsTest, TanhAndSigmoidWithinBound) {
+    for (auto range : {1.0f, 12.0f}) {
+        auto x = sweep(-range, range);
+        EXPECT_LE(max_ulp(core_vector_tanh, core_fast_tanh, x, [](double v) { return std::tanh(v); }), 2.0);
+    }
+    for (auto range : {4.0f, 110.0f}) {
+        auto x = sweep(-range, range);
+        EXPECT_LE(max_ulp(core_vector_sigmoid, core_fast_sigmoid, x,
+                          [](double v) { return 1.0 / (1.0 + std::exp(-v)); }), 3.0);
+    }
+}
+
+TEST_F(MathOpsTest, SqrtAndRsqrtWithinBound) {
+    auto x = positive_bits();
+    // sqrt правильно округлён
+    EXPECT_LE(max_ulp(core_vector_sqrt, core_fast_sqrt, x, [](double v) { return std::sqrt(v); }), 0.5);
+    EXPECT_LE(max_ulp(core_vector_rsqrt, core_fast_rsqrt, x, [](double v) { return 1.0 / std::sqrt(v); }), 3.5);
+}
+
+TEST_F(MathOpsTest, SpecialValues) {
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float denorm = from_bits(0x00000100u);
+
+    EXPECT_EQ(core_fast_exp(-inf), 0.0f);
+    EXPECT_EQ(core_fast_exp(inf), inf);
+    EXPECT_EQ(core_fast_exp(100.0f), inf);
+    EXPECT_EQ(core_fast_exp(0.0f), 1.0f);
+    EXPECT_LE(ulp_error(core_fast_exp(-100.0f), std::exp(-100.0)), 1.5);
+    EXPECT_TRUE(std::isnan(core_fast_exp(nan)));
+
+    EXPECT_EQ(core_fast_log(0.0f), -inf);
+    EXPECT_EQ(core_fast_log(inf), inf);
+    EXPECT_EQ(core_fast_log(1.0f), 0.0f);
+    EXPECT_TRUE(std::isnan(core_fast_log(-1.0f)));
+    EXPECT_TRUE(std::isnan(core_fast_log(nan)));
+    EXPECT_LE(ulp_error(core_fast_log(denorm), std::log(static_cast<double>(denorm))), 1.0);
+
+    EXPECT_EQ(core_fast_tanh(inf), 1.0f);
+    EXPECT_EQ(core_fast_tanh(-inf), -1.0f);
+    EXPECT_EQ(core_fast_tanh(0.0f), 0.0f);
+    EXPECT_TRUE(std::isnan(core_fast_tanh(nan)));
+
+    EXPECT_EQ(core_fast_sigmoid(inf), 1.0f);
+    EXPECT_EQ(core_fast_sigmoid(-inf), 0.0f);
+    EXPECT_EQ(core_fast_sigmoid(0.0f), 0.5f);
+    EXPECT_LE(ulp_error(core_fast_sigmoid(-100.0f), 1.0 / (1.0 + std::exp(100.0))), 3.0);
+    EXPECT_TRUE(std::isnan(core_fast_sigmoid(nan)));
+
+    EXPECT_TRUE(std::isnan(core_fast_sin(inf)));
+    EXPECT_TRUE(std::isnan(core_fast_cos(nan)));
+    EXPECT_EQ(core_fast_sin(0.0f), 0.0f);
+    EXPECT_EQ(core_fast_cos(0.0f), 1.0f);
+
+    EXPECT_EQ(core_fast_rsqrt(0.0f), inf);
+    EXPECT_EQ(core_fast_rsqrt(inf), 0.0f);
+    EXPECT_TRUE(std::isnan(core_fast_rsqrt(-4.0f)));
+}
+
+TEST_F(MathOpsTest, TailsAndInPlace) {
+    const VectorFn fns[] = {core_vector_sin, core_vector_cos, core_vector_sqrt, core_vector_rsqrt,
+                            core_vector_exp, core_vector_log, core_vector_tanh, core_vector_sigmoid};
+    auto x = sweep(0.1f, 5.0f, 64);
+    for (VectorFn fn : fns) {
+        std::vector<float> full(x.size());
+        fn(full.data(), x.data(), x.size());
+        for (size_t n = 0; n <= 37; ++n) {
+            std::vector<float> y(n + 4, -7.0f);
+            fn(y.data(), x.data(), n);
+            for (size_t i = 0; i < n; ++i) ASSERT_EQ(y[i], full[i]) << "n=" << n << " i=" << i;
+            for (size_t i = n; i < y.size(); ++i) ASSERT_EQ(y[i], -7.0f) << "wrote past n=" << n;
+
+            std::vector<float> in_place(x.begin(), x.begin() + n);
+            fn(in_place.data(), in_place.data(), n);
+            for (size_t i = 0; i < n; ++i) ASSERT_EQ(in_place[i], full[i]) << "in place n=" << n;
+        }
+    }
+}
+
+TEST_F(MathOpsTest, Matrix4x4) {
+    float a[16], b[16], ref[16], out[16], t[16];
+    for (int i = 0; i < 16; ++i) {
+        a[i] = static_cast<float>(i) * 0.5f - 3.0f;
+        b[i] = static_cast<float>(i * i % 7) - 2.0f;
+    }
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            ref[i * 4 + j] = 0.0f;
+            for (int k = 0; k < 4; ++k) ref[i * 4 + j] += a[i * 4 + k] * b[k * 4 + j];
+        }
+    }
+    core_matrix_multiply_4x4(out, a, b);
+    for (int i = 0; i < 16; ++i) EXPECT_FLOAT_EQ(out[i], ref[i]);
+    // Результат поверх сомножителя
+    std::memcpy(out, b, sizeof(b));
+    core_matrix_multiply_4x4(out, a, out);
+    for (int i = 0; i < 16; ++i) EXPECT_FLOAT_EQ(out[i], ref[i]);
+
+    core_matrix_transpose_4x4(t, a);
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) EXPECT_EQ(t[i * 4 + j], a[j * 4 + i]);
+    }
+}
@@ -0,0 +1,310 @@
+#include <gtest/gtest.h>
+#include "core/drivers/event_loop_ops.h"
+#include "core/drivers/net_conn_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <errno.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Цикл в своём потоке
+struct RunningLoop {
+    core_event_loop_t* loop = nullptr;
+    std::thread runner;
+    explicit RunningLoop(core_event_loop_t* l) : loop(l) {
+        runner = std::thread([this] { core_event_loop_run(loop); });
+    }
+    ~RunningLoop() {
+        core_event_loop_stop(loop);
+        runner.join();
+        core_event_loop_destroy(loop);
+    }
+};
+
+// Тело теста на каждом доступном механизме ожидания
+void for_each_backend(const std::function<void(core_event_loop_t*)>& body) {
+    for (int backend : {CORE_EV_BACKEND_EPOLL, CORE_EV_BACKEND_IO_URING}) {
+        core_event_loop_t* loop = nullptr;
+        int rc = core_event_loop_create_with(backend, &loop);
+        if (rc == CORE_ERR_UNSUPPORTED && backend != CORE_EV_BACKEND_EPOLL) {
+            continue;
+        }
+        ASSERT_EQ(rc, CORE_SUCCESS);
+        SCOPED_TRACE(backend == CORE_EV_BACKEND_EPOLL ? "epoll" : "io_uring");
+        body(loop);
+    }
+}
+
+template <typename Pred>
+bool wait_for(Pred pred, int timeout_ms = 5000) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+struct Events {
+    std::mutex mutex;
+    std::string data;
+    std::atomic<int> drains{0};
+    std::atomic<int> closes{0};
+    std::atomic<int> error{-1};
+};
+
+core_net_handlers_t recording_handlers() {
+    core_net_handlers_t handlers{};
+    handlers.on_data = [](void* ctx, const void* data, size_t size) {
+        auto* ev = static_cast<Events*>(ctx);
+        std::lock_guard<std::mutex> lock(ev->mutex);
+        ev->data.append(static_cast<const char*>(data), size);
+    };
+    handlers.on_drain = [](void* ctx) { static_cast<Events*>(ctx)->drains.fetch_add(1); };
+    handlers.on_close = [](void* ctx, int error) {
+        auto* ev = static_cast<Events*>(ctx);
+        ev->error.store(error);
+        ev->closes.fetch_add(1);
+    };
+    return handlers;
+}
+
+}  // namespace
+
+TEST(NetConnOpsTest, BackpressureStopsAtHighWatermarkAndDrains) {
+    for_each_backend([](core_event_loop_t* l) {
+        RunningLoop loop(l);
+        int fds[2];
+        ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        Events ev;
+        core_net_handlers_t handlers = recording_handlers();
+        core_net_conn_config_t config{};
+        config.high_watermark = 256 << 10;
+        config.low_watermark = 32 << 10;
+        core_net_conn_t* conn = nullptr;
+        ASSERT_EQ(core_net_conn_open(loop.loop, fds[0], &config, &handlers, &ev, &conn), CORE_SUCCESS);
+
+        // Вторая сторона не читает: сначала заполняется сокет, затем очередь
+        std::string chunk(16 << 10, '\0');
+        uint8_t next = 0;
+        size_t accepted = 0;
+        int rc = CORE_SUCCESS;
+        while ((rc = core_net_conn_send(conn, chunk.data(), chunk.size())) == CORE_SUCCESS) {
+            accepted += chunk.size();
+            for (char& c : chunk) c = static_cast<char>(next++);
+            ASSERT_LT(accepted, 64u << 20);
+        }
+        EXPECT_EQ(rc, CORE_ERR_NOMEM);
+        EXPECT_GE(core_net_conn_queued(conn), config.high_watermark);
+        EXPECT_EQ(ev.drains.load(), 0);
+
+        // Вычитывание опускает очередь ниже low_watermark — приходит on_drain
+        std::string received;
+        std::thread reader([&] {
+            char buf[64 << 10];
+            while (received.size() < accepted) {
+                ssize_t n = ::read(fds[1], buf, sizeof(buf));
+                if (n <= 0) break;
+                received.append(buf, static_cast<size_t>(n));
+            }
+        });
+        EXPECT_TRUE(wait_for([&] { return ev.drains.load() == 1; }));
+        reader.join();
+        ASSERT_EQ(received.size(), accepted);
+        // Порядок байтов сохранён между прямой записью и очередью
+        uint8_t expect = 0;
+        bool ordered = true;
+        for (size_t i = chunk.size(); i < received.size(); ++i) {
+            ordered = ordered && static_cast<uint8_t>(received[i]) == expect++;
+        }
+        EXPECT_TRUE(ordered);
+        EXPECT_EQ(core_net_conn_queued(conn), 0u);
+
+        core_net_conn_close(conn, 1);
+        EXPECT_TRUE(wait_for([&] { return ev.closes.load() == 1; }));
+        EXPECT_EQ(ev.error.load(), 0);
+        ::close(fds[0]);
+        ::close(fds[1]);
+    });
+}
+
+TEST(NetConnOpsTest, PeerCloseDeliversAllDataFirst) {
+    for_each_backend([](core_event_loop_t* l) {
+        RunningLoop loop(l);
+        int fds[2];
+        ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        Events ev;
+        core_net_handlers_t handlers = recording_handlers();
+        core_net_conn_config_t config{};
+        config.read_budget = 4096;   // дочитывание по частям через очередь цикла
+        core_net_conn_t* conn = nullptr;
+
+        // Данные и закрытие уже ждут в сокете к моменту подписки
+        std::string payload(200 << 10, '\0');
+        for (size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<char>(i * 7);
+        std::thread writer([&] {
+            size_t off = 0;
+            while (off < payload.size()) {
+                ssize_t n = ::write(fds[1], payload.data() + off, payload.size() - off);
+                if (n <= 0) break;
+                off += static_cast<size_t>(n);
+            }
+            ::shutdown(fds[1], SHUT_WR);
+        });
+        ASSERT_EQ(core_net_conn_open(loop.loop, fds[0], &config, &handlers, &ev, &conn), CORE_SUCCESS);
+        writer.join();
+
+        EXPECT_TRUE(wait_for([&] { return ev.closes.load() == 1; }));
+        EXPECT_EQ(ev.error.load(), 0);
+        {
+            std::lock_guard<std::mutex> lock(ev.mutex);
+            EXPECT_TRUE(ev.data == payload);
+        }
+        EXPECT_EQ(core_net_conn_send(conn, "x", 1), CORE_ERR_NOTFOUND);
+        core_net_conn_close(conn, 1);
+        EXPECT_EQ(ev.closes.load(), 1);
+
+        // Ошибка записи закрывает соединение с её errno
+        int pair[2];
+        ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+        ASSERT_EQ(::shutdown(pair[1], SHUT_RD), 0);
+        Events broken;
+        ASSERT_EQ(core_net_conn_open(loop.loop, pair[0], nullptr, &handlers, &broken, &conn), CORE_SUCCESS);
+        EXPECT_EQ(core_net_conn_send(conn, "x", 1), CORE_ERR_INTERNAL);
+        EXPECT_TRUE(wait_for([&] { return broken.closes.load() == 1; }));
+        EXPECT_EQ(broken.error.load(), EPIPE);
+        EXPECT_EQ(core_net_conn_send(conn, "x", 1), CORE_ERR_NOTFOUND);
+        core_net_conn_close(conn, 0);
+        ::close(pair[1]);
+        ::close(pair[0]);
+        ::close(fds[0]);
+        ::close(fds[1]);
+    });
+}
+
+TEST(NetConnOpsTest, OneLoopServesThousandsOfConnections) {
+    rlimit limit{};
+    getrlimit(RLIMIT_NOFILE, &limit);
+    const size_t count = std::min<size_t>(4000, (limit.rlim_cur - 64) / 2);
+
+    for_each_backend([count](core_event_loop_t* l) {
+        RunningLoop loop(l);
+        // Эхо из on_data прямо в потоке цикла
+        struct Echo {
+            core_net_conn_t* conn = nullptr;
+            std::atomic<size_t>* closed = nullptr;
+        };
+        core_net_handlers_t handlers{};
+        handlers.on_data = [](void* ctx, const void* data, size_t size) {
+            EXPECT_EQ(core_net_conn_send(static_cast<Echo*>(ctx)->conn, data, size), CORE_SUCCESS);
+        };
+        handlers.on_close = [](void* ctx, int) { static_cast<Echo*>(ctx)->closed->fetch_add(1); };
+
+        std::atomic<size_t> closed{0};
+        std::vector<Echo> echoes(count);
+        std::vector<int> clients(count);
+        std::vector<int> servers(count);
+        for (size_t i = 0; i < count; ++i) {
+            int fds[2];
+            ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+            servers[i] = fds[0];
+            clients[i] = fds[1];
+            echoes[i].closed = &closed;
+            ASSERT_EQ(core_net_conn_open(loop.loop, fds[0], nullptr, &handlers, &echoes[i], &echoes[i].conn),
+                      CORE_SUCCESS);
+        }
+        // Записанные conn — в поток цикла до первых данных
+        std::atomic<bool> published{false};
+        ASSERT_EQ(core_event_loop_post(loop.loop, [](void* ctx) {
+            static_cast<std::atomic<bool>*>(ctx)->store(true);
+        }, &published), CORE_SUCCESS);
+        ASSERT_TRUE(wait_for([&] { return published.load(); }));
+        for (size_t i = 0; i < count; ++i) {
+            const std::string msg = "ping " + std::to_string(i);
+            ASSERT_EQ(::write(clients[i], msg.data(), msg.size()), static_cast<ssize_t>(msg.size()));
+        }
+        size_t matched = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const std::string msg = "ping " + std::to_string(i);
+            std::string got;
+            char buf[64];
+            while (got.size() < msg.size()) {
+                ssize_t n = ::read(clients[i], buf, sizeof(buf));
+                if (n <= 0) break;
+                got.append(buf, static_cast<size_t>(n));
+            }
+            matched += got == msg;
+        }
+        EXPECT_EQ(matched, count);
+
+        for (auto& echo : echoes) core_net_conn_close(echo.conn, 0);
+        EXPECT_TRUE(wait_for([&] { return closed.load() == count; }));
+        for (size_t i = 0; i < count; ++i) {
+            ::close(servers[i]);
+            ::close(clients[i]);
+        }
+    });
+}
+
+TEST(NetConnOpsTest, SharedPayloadFansOutToManyConnections) {
+    for_each_backend([](core_event_loop_t* l) {
+        RunningLoop loop(l);
+        constexpr size_t kConns = 32;
+        std::string data(512 << 10, '\0');
+        for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(i * 31 + 7);
+        core_net_payload_t* payload = nullptr;
+        ASSERT_EQ(core_net_payload_create(data.data(), data.size(), &payload), CORE_SUCCESS);
+        EXPECT_EQ(core_net_payload_size(payload), data.size());
+        EXPECT_EQ(std::memcmp(core_net_payload_data(payload), data.data(), data.size()), 0);
+
+        std::vector<Events> events(kConns);
+        std::vector<core_net_conn_t*> conns(kConns);
+        std::vector<int> peers(kConns);
+        std::vector<int> locals(kConns);
+        core_net_handlers_t handlers = recording_handlers();
+        for (size_t i = 0; i < kConns; ++i) {
+            int fds[2];
+            ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+            locals[i] = fds[0];
+            peers[i] = fds[1];
+            ASSERT_EQ(core_net_conn_open(loop.loop, fds[0], nullptr, &handlers, &events[i], &conns[i]), CORE_SUCCESS);
+            // Сокет не вмещает буфер целиком: остаток встаёт в очередь ссылкой
+            ASSERT_EQ(core_net_conn_send_payload(conns[i], payload), CORE_SUCCESS);
+            EXPECT_GT(core_net_conn_queued(conns[i]), 0u);
+        }
+        // Очереди держат буфер и после того, как его отпустил создатель
+        core_net_payload_release(payload);
+
+        for (size_t i = 0; i < kConns; ++i) {
+            std::string got;
+            char buf[64 << 10];
+            while (got.size() < data.size()) {
+                ssize_t n = ::read(peers[i], buf, sizeof(buf));
+                if (n <= 0) break;
+                got.append(buf, static_cast<size_t>(n));
+            }
+            EXPECT_TRUE(got == data);
+        }
+        for (size_t i = 0; i < kConns; ++i) core_net_conn_close(conns[i], 1);
+        EXPECT_TRUE(wait_for([&] {
+            return std::all_of(events.begin(), events.end(), [](const Events& ev) { return ev.closes.load() == 1; });
+        }));
+        for (size_t i = 0; i < kConns; ++i) {
+            ::close(locals[i]);
+            ::close(peers[i]);
+        }
+    });
+}
@@ -220,6 +220,16 @@ TEST_F(NetworkManagerTest, ConnectionOptimization) {
     manager->disconnect(conn_id);
 }
 
+// Test that the data handler cannot change under running reactors
+TEST_F(NetworkManagerTest, DataHandlerSetOnlyWhileStopped) {
+    auto handler = [](size_t, size_t, const void*, size_t) {};
+    EXPECT_THROW(manager->set_data_handler(handler), std::runtime_error);
+
+    manager->stop();
+    EXPECT_NO_THROW(manager->set_data_handler(handler));
+    manager->start();
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
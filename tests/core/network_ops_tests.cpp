@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include "core/drivers/network_ops.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// UDP-сокет на 127.0.0.1 со случайным портом
+struct UdpSocket {
+    int fd = -1;
+    sockaddr_in addr{};
+    UdpSocket() {
+        fd = socket(AF_INET, SOCK_DGRAM, 0);
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        EXPECT_EQ(bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        socklen_t len = sizeof(addr);
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        struct timeval tv = {2, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+    ~UdpSocket() { close(fd); }
+};
+
+core_dgram_t dgram_to(const UdpSocket& dest, void* buf, size_t len) {
+    core_dgram_t msg{};
+    msg.buf = buf;
+    msg.len = len;
+    std::memcpy(&msg.addr, &dest.addr, sizeof(dest.addr));
+    msg.addrlen = sizeof(dest.addr);
+    return msg;
+}
+
+// Принимает count датаграмм пачками; сокет с таймаутом приёма
+std::vector<std::string> receive_all(const UdpSocket& sock, size_t count, size_t buf_size,
+                                     std::vector<core_dgram_t>* meta = nullptr) {
+    std::vector<std::string> bufs(count, std::string(buf_size, '\0'));
+    std::vector<core_dgram_t> msgs(count);
+    std::vector<std::string> out;
+    size_t done = 0;
+    while (done < count) {
+        for (size_t i = done; i < count; ++i) {
+            msgs[i] = core_dgram_t{};
+            msgs[i].buf = bufs[i].data();
+            msgs[i].len = buf_size;
+        }
+        int n = core_socket_recvmmsg(sock.fd, msgs.data() + done, count - done, 0);
+        if (n <= 0) break;
+        for (int i = 0; i < n; ++i) {
+            out.emplace_back(bufs[done + i].data(), msgs[done + i].received);
+            if (meta) meta->push_back(msgs[done + i]);
+        }
+        done += static_cast<size_t>(n);
+    }
+    return out;
+}
+
+}  // namespace
+
+TEST(NetworkOpsTest, BatchedDatagramsRoundTrip) {
+    UdpSocket sender;
+    UdpSocket receiver;
+
+    // Больше CORE_SOCKET_BATCH_MAX — уходит несколькими вызовами
+    constexpr size_t kCount = 150;
+    std::vector<std::string> payloads;
+    std::vector<core_dgram_t> msgs;
+    for (size_t i = 0; i < kCount; ++i) payloads.push_back("datagram " + std::to_string(i));
+    for (auto& p : payloads) msgs.push_back(dgram_to(receiver, p.data(), p.size()));
+    ASSERT_EQ(core_socket_sendmmsg(sender.fd, msgs.data(), msgs.size(), 0), static_cast<int>(kCount));
+
+    std::vector<core_dgram_t> meta;
+    auto got = receive_all(receiver, kCount, 64, &meta);
+    ASSERT_EQ(got.size(), kCount);
+    for (size_t i = 0; i < kCount; ++i) {
+        EXPECT_EQ(got[i], payloads[i]);
+        const auto* from = reinterpret_cast<const sockaddr_in*>(&meta[i].addr);
+        EXPECT_EQ(meta[i].addrlen, sizeof(sockaddr_in));
+        EXPECT_EQ(from->sin_port, sender.addr.sin_port);
+        EXPECT_EQ(meta[i].segment_size, 0);
+    }
+
+    // Без ожидания на пустом сокете
+    char buf[16];
+    core_dgram_t empty{};
+    empty.buf = buf;
+    empty.len = sizeof(buf);
+    EXPECT_EQ(core_socket_recvmmsg(receiver.fd, &empty, 1, MSG_DONTWAIT), -1);
+    EXPECT_TRUE(errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+TEST(NetworkOpsTest, GsoSplitsAndGroCoalesces) {
+    UdpSocket sender;
+    UdpSocket receiver;
+    if (core_socket_gso_supported(sender.fd) != 0) {
+        GTEST_SKIP() << "UDP GSO недоступен";
+    }
+
+    // Один буфер — 10 датаграмм по 1000 байт и хвост
+    constexpr size_t kSegment = 1000;
+    std::string payload(10 * kSegment + 300, '\0');
+    for (size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<char>(i / kSegment + 'a');
+    core_dgram_t msg = dgram_to(receiver, payload.data(), payload.size());
+    msg.segment_size = kSegment;
+    ASSERT_EQ(core_socket_sendmmsg(sender.fd, &msg, 1, 0), 1);
+
+    auto got = receive_all(receiver, 11, 2048);
+    ASSERT_EQ(got.size(), 11u);
+    for (size_t i = 0; i < 10; ++i) EXPECT_EQ(got[i], payload.substr(i * kSegment, kSegment));
+    EXPECT_EQ(got[10].size(), 300u);
+
+    // С GRO склеенный буфер доходит одним сообщением
+    if (core_socket_enable_gro(receiver.fd) != 0) {
+        GTEST_SKIP() << "UDP GRO недоступен";
+    }
+    ASSERT_EQ(core_socket_sendmmsg(sender.fd, &msg, 1, 0), 1);
+    std::vector<core_dgram_t> meta;
+    got = receive_all(receiver, 1, 64 << 10, &meta);
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_EQ(got[0], payload);
+    EXPECT_EQ(meta[0].segment_size, kSegment);
+}
+
+TEST(NetworkOpsTest, ZerocopySendCompletesAfterPeerReads) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    ASSERT_EQ(listen(listener, 1), 0);
+    socklen_t len = sizeof(addr);
+    getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len);
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    int peer = accept(listener, nullptr, nullptr);
+    ASSERT_GE(peer, 0);
+
+    core_zerocopy_t zc;
+    if (core_zerocopy_init(&zc, client) != 0) {
+        close(peer);
+        close(client);
+        close(listener);
+        GTEST_SKIP() << "MSG_ZEROCOPY недоступен";
+    }
+
+    // Короткая отправка копируется и сразу завершена
+    uint32_t small_id = 0;
+    ASSERT_EQ(core_zerocopy_send(&zc, "ping", 4, 0, &small_id), 4);
+    EXPECT_TRUE(core_zerocopy_done(&zc, small_id));
+
+    constexpr size_t kChunk = 64 << 10;
+    constexpr int kSends = 8;
+    std::vector<char> buffer(kChunk * kSends, 'z');
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < kSends; ++i) {
+        uint32_t id = 0;
+        ASSERT_EQ(core_zerocopy_send(&zc, buffer.data() + i * kChunk, kChunk, 0, &id),
+                  static_cast<ssize_t>(kChunk));
+        ids.push_back(id);
+    }
+    EXPECT_EQ(ids.front(), 0u);
+    EXPECT_EQ(ids.back(), static_cast<uint32_t>(kSends - 1));
+
+    // На loopback страницы отпускаются, когда получатель прочитал данные
+    size_t total = 4 + kChunk * kSends;
+    std::vector<char> sink(256 << 10);
+    size_t read_bytes = 0;
+    while (read_bytes < total) {
+        ssize_t n = read(peer, sink.data(), sink.size());
+        ASSERT_GT(n, 0);
+        read_bytes += static_cast<size_t>(n);
+    }
+
+    int completed = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!core_zerocopy_done(&zc, ids.back()) && std::chrono::steady_clock::now() < deadline) {
+        int n = core_zerocopy_reap(&zc);
+        ASSERT_GE(n, 0);
+        completed += n;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (uint32_t id : ids) EXPECT_TRUE(core_zerocopy_done(&zc, id));
+    EXPECT_EQ(completed, kSends);
+    EXPECT_EQ(zc.base, static_cast<uint32_t>(kSends));
+    EXPECT_FALSE(core_zerocopy_done(&zc, kSends));
+
+    close(peer);
+    close(client);
+    close(listener);
+}
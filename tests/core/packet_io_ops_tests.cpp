@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include "core/drivers/packet_io_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint16_t kTestEtherType = 0x88B5;   // для локальных экспериментов
+constexpr size_t kFrameSize = 128;
+
+// Пара veth в своём сетевом пространстве имён: тесту нужен только root,
+// хостовые интерфейсы не трогаются, а пространство исчезает вместе с парой
+class PacketIoTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (geteuid() != 0) {
+            GTEST_SKIP() << "нужен root для veth и packet-сокетов";
+        }
+        host_ns_ = open("/proc/self/ns/net", O_RDONLY | O_CLOEXEC);
+        if (host_ns_ < 0 || unshare(CLONE_NEWNET) != 0) {
+            GTEST_SKIP() << "нет отдельного сетевого пространства имён";
+        }
+        if (std::system("ip link add pio0 type veth peer name pio1 && "
+                        "ip link set pio0 up && ip link set pio1 up") != 0) {
+            GTEST_SKIP() << "не удалось создать пару veth";
+        }
+        // Пока на обоих концах нет несущей, кадры теряются
+        for (int i = 0; i < 100 && !(link_up("pio0") && link_up("pio1")); ++i) usleep(10000);
+        sender_ = raw_socket("pio0");
+    }
+
+    void TearDown() override {
+        if (sender_ >= 0) close(sender_);
+        if (host_ns_ >= 0) {
+            setns(host_ns_, CLONE_NEWNET);
+            close(host_ns_);
+        }
+    }
+
+    static bool link_up(const char* name) {
+        std::string path = std::string("/sys/class/net/") + name + "/operstate";
+        FILE* f = std::fopen(path.c_str(), "r");
+        if (!f) return false;
+        char state[16] = {};
+        bool up = std::fgets(state, sizeof(state), f) && std::strncmp(state, "up", 2) == 0;
+        std::fclose(f);
+        return up;
+    }
+
+    static int raw_socket(const char* ifname) {
+        int fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+        sockaddr_ll addr{};
+        addr.sll_family = AF_PACKET;
+        addr.sll_protocol = htons(ETH_P_ALL);
+        addr.sll_ifindex = static_cast<int>(if_nametoindex(ifname));
+        EXPECT_EQ(bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        // Свои отправленные кадры не нужны: читаем только пришедшие от pio1
+        int ignore = 1;
+        setsockopt(fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &ignore, sizeof(ignore));
+        timeval tv = {2, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        return fd;
+    }
+
+    // Широковещательный кадр с номером в начале данных
+    static std::vector<uint8_t> make_frame(uint32_t seq) {
+        std::vector<uint8_t> frame(kFrameSize, 0);
+        std::memset(frame.data(), 0xff, 6);
+        const uint8_t src[6] = {0x02, 0, 0, 0, 0, 0x01};
+        std::memcpy(frame.data() + 6, src, 6);
+        frame[12] = kTestEtherType >> 8;
+        frame[13] = kTestEtherType & 0xff;
+        std::memcpy(frame.data() + 14, &seq, sizeof(seq));
+        for (size_t i = 18; i < kFrameSize; ++i) frame[i] = static_cast<uint8_t>(seq + i);
+        return frame;
+    }
+
+    // Номер кадра или -1 для посторонних (IPv6 ND и т. п.)
+    static int64_t frame_seq(const void* data, size_t len) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        if (len < 18 || bytes[12] != (kTestEtherType >> 8) || bytes[13] != (kTestEtherType & 0xff)) {
+            return -1;
+        }
+        uint32_t seq;
+        std::memcpy(&seq, bytes + 14, sizeof(seq));
+        EXPECT_EQ(len, kFrameSize);
+        EXPECT_EQ(std::memcmp(bytes, make_frame(seq).data(), kFrameSize), 0);
+        return seq;
+    }
+
+    void send_frames(uint32_t first, uint32_t count) {
+        for (uint32_t seq = first; seq < first + count; ++seq) {
+            auto frame = make_frame(seq);
+            ASSERT_EQ(send(sender_, frame.data(), frame.size(), 0), static_cast<ssize_t>(frame.size()));
+        }
+    }
+
+    // Принимает count своих кадров пачками; номера должны идти подряд
+    void receive_frames(core_packet_io_t* io, uint32_t first, uint32_t count) {
+        core_packet_t pkts[32];
+        uint32_t expected = first;
+        while (expected < first + count) {
+            ASSERT_EQ(core_packet_io_wait(io, 2000), 1) << "ждали кадр " << expected;
+            size_t n = core_packet_io_rx_burst(io, pkts, 32);
+            for (size_t i = 0; i < n; ++i) {
+                int64_t seq = frame_seq(pkts[i].data, pkts[i].len);
+                if (seq < 0) continue;
+                ASSERT_EQ(seq, expected);
+                ++expected;
+            }
+        }
+    }
+
+    int host_ns_ = -1;
+    int sender_ = -1;
+};
+
+}  // namespace
+
+TEST_F(PacketIoTest, AfPacketRingRecyclesBlocks) {
+    // 1024 кадра по 2 КиБ — 32 блока; через кольцо проходит больше его размера
+    core_packet_io_config_t config{};
+    config.frame_count = 1024;
+    core_packet_io_t* io = nullptr;
+    ASSERT_EQ(core_packet_io_open("pio1", CORE_PACKET_IO_AF_PACKET, &config, &io), CORE_SUCCESS);
+    EXPECT_EQ(core_packet_io_backend(io), CORE_PACKET_IO_AF_PACKET);
+    EXPECT_EQ(core_packet_io_zero_copy(io), 0);
+    EXPECT_GE(core_packet_io_fd(io), 0);
+
+    EXPECT_EQ(core_packet_io_wait(io, 0), 0);
+    constexpr uint32_t kBatch = 50;
+    constexpr uint32_t kBatches = 240;
+    for (uint32_t b = 0; b < kBatches; ++b) {
+        send_frames(b * kBatch, kBatch);
+        receive_frames(io, b * kBatch, kBatch);
+    }
+
+    core_packet_io_stats_t stats;
+    core_packet_io_stats(io, &stats);
+    EXPECT_GE(stats.rx_packets, kBatch * kBatches);
+    EXPECT_EQ(stats.rx_dropped, 0u);
+
+    // Отправка уходит на другой конец пары
+    auto frame = make_frame(7);
+    ASSERT_EQ(core_packet_io_send(io, frame.data(), frame.size()), CORE_SUCCESS);
+    std::vector<uint8_t> buf(2048);
+    ssize_t n;
+    do {
+        n = recv(sender_, buf.data(), buf.size(), 0);
+        ASSERT_GT(n, 0);
+    } while (frame_seq(buf.data(), static_cast<size_t>(n)) < 0);
+    EXPECT_EQ(frame_seq(buf.data(), static_cast<size_t>(n)), 7);
+    core_packet_io_stats(io, &stats);
+    EXPECT_EQ(stats.tx_packets, 1u);
+
+    core_packet_io_close(io);
+}
+
+TEST_F(PacketIoTest, AfXdpReceivesAndSendsThroughUmem) {
+    // 128 кадров UMEM: 64 на приём — кадры должны возвращаться в fill
+    core_packet_io_config_t config{};
+    config.frame_count = 128;
+    core_packet_io_t* io = nullptr;
+    int result = core_packet_io_open("pio1", CORE_PACKET_IO_AF_XDP, &config, &io);
+    if (result == CORE_ERR_UNSUPPORTED) {
+        GTEST_SKIP() << "AF_XDP недоступен";
+    }
+    ASSERT_EQ(result, CORE_SUCCESS);
+    EXPECT_EQ(core_packet_io_backend(io), CORE_PACKET_IO_AF_XDP);
+
+    constexpr uint32_t kBatch = 32;
+    for (uint32_t b = 0; b < 40; ++b) {
+        send_frames(b * kBatch, kBatch);
+        receive_frames(io, b * kBatch, kBatch);
+    }
+
+    // Отправка из UMEM: кадров отправки 64, занятые освобождаются по completion
+    for (uint32_t seq = 0; seq < 200; ++seq) {
+        auto frame = make_frame(seq);
+        int sent;
+        while ((sent = core_packet_io_send(io, frame.data(), frame.size())) == CORE_ERR_NOMEM) usleep(100);
+        ASSERT_EQ(sent, CORE_SUCCESS);
+        std::vector<uint8_t> buf(2048);
+        ssize_t n;
+        do {
+            n = recv(sender_, buf.data(), buf.size(), 0);
+            ASSERT_GT(n, 0);
+        } while (frame_seq(buf.data(), static_cast<size_t>(n)) < 0);
+        ASSERT_EQ(frame_seq(buf.data(), static_cast<size_t>(n)), seq);
+    }
+    std::vector<uint8_t> jumbo(4096);
+    EXPECT_EQ(core_packet_io_send(io, jumbo.data(), jumbo.size()), CORE_ERR_INVALID);
+
+    core_packet_io_stats_t stats;
+    core_packet_io_stats(io, &stats);
+    EXPECT_GE(stats.rx_packets, 40u * kBatch);
+    EXPECT_EQ(stats.tx_packets, 200u);
+
+    core_packet_io_close(io);
+}
+
+TEST_F(PacketIoTest, AutoFallsBackToAfPacket) {
+    EXPECT_EQ(core_packet_io_open("pio-missing", CORE_PACKET_IO_AUTO, nullptr, nullptr), CORE_ERR_INVALID);
+    core_packet_io_t* io = nullptr;
+    EXPECT_EQ(core_packet_io_open("pio-missing", CORE_PACKET_IO_AUTO, nullptr, &io), CORE_ERR_NOTFOUND);
+
+    core_packet_io_config_t config{};
+    config.frame_count = 256;
+    config.promiscuous = 1;
+    core_packet_io_t* first = nullptr;
+    ASSERT_EQ(core_packet_io_open("pio1", CORE_PACKET_IO_AUTO, &config, &first), CORE_SUCCESS);
+    if (core_packet_io_backend(first) != CORE_PACKET_IO_AF_XDP) {
+        core_packet_io_close(first);
+        GTEST_SKIP() << "AF_XDP недоступен, выбран AF_PACKET";
+    }
+
+    // Интерфейс уже занят XDP-программой первого — второй уходит на AF_PACKET
+    core_packet_io_t* second = nullptr;
+    ASSERT_EQ(core_packet_io_open("pio1", CORE_PACKET_IO_AUTO, &config, &second), CORE_SUCCESS);
+    EXPECT_EQ(core_packet_io_backend(second), CORE_PACKET_IO_AF_PACKET);
+    EXPECT_EQ(core_packet_io_open("pio1", CORE_PACKET_IO_AF_XDP, &config, &io), CORE_ERR_UNSUPPORTED);
+
+    // Кадры забирает AF_XDP раньше стека ядра; после его закрытия — AF_PACKET
+    send_frames(0, 16);
+    receive_frames(first, 0, 16);
+    core_packet_io_close(first);
+    send_frames(16, 16);
+    receive_frames(second, 16, 16);
+    core_packet_io_close(second);
+}
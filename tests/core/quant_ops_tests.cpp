@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include "core/drivers/quant_ops.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+uint32_t float_bits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+float bits_float(uint32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// Эталон: отбрасываемые 16 бит больше половины или ровно половина при нечётной
+// сохраняемой части — округление вверх по модулю (перенос в порядок даёт inf)
+uint16_t reference_bf16(float f) {
+    uint32_t bits = float_bits(f);
+    if (std::isnan(f)) return static_cast<uint16_t>((bits >> 16) | 0x40);
+    uint32_t kept = bits >> 16, dropped = bits & 0xFFFFu;
+    if (dropped > 0x8000u || (dropped == 0x8000u && (kept & 1u))) ++kept;
+    return static_cast<uint16_t>(kept);
+}
+
+float bf16_value(core_bf16_t x) { return bits_float(static_cast<uint32_t>(x.bits) << 16); }
+
+} // namespace
+
+class QuantOpsTest : public ::testing::Test {
+protected:
+    template<typename T>
+    std::vector<T> random_ints(size_t n, int64_t lo = std::numeric_limits<T>::min(),
+                               int64_t hi = std::numeric_limits<T>::max()) {
+        std::uniform_int_distribution<int64_t> dis(lo, hi);
+        std::vector<T> v(n);
+        for (auto& x : v) x = static_cast<T>(dis(gen));
+        return v;
+    }
+
+    std::vector<float> random_floats(size_t n, float lo, float hi) {
+        std::uniform_real_distribution<float> dis(lo, hi);
+        std::vector<float> v(n);
+        for (auto& x : v) x = dis(gen);
+        return v;
+    }
+
+    template<typename T, typename Fn, typename Ref>
+    void check_elementwise(Fn fn, Ref ref) {
+        for (size_t n : {0u, 1u, 7u, 8u, 31u, 32u, 63u, 64u, 65u, 130u, 1000u}) {
+            auto a = random_ints<T>(n), b = random_ints<T>(n);
+            if (n > 2) {
+                a[0] = std::numeric_limits<T>::min();
+                b[0] = std::numeric_limits<T>::min();
+                a[1] = std::numeric_limits<T>::max();
+                b[1] = std::numeric_limits<T>::max();
+            }
+            std::vector<T> out(n + 3, T(77));
+            fn(out.data(), a.data(), b.data(), n);
+            for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], ref(a[i], b[i])) << "n=" << n << " i=" << i;
+            for (size_t i = n; i < out.size(); ++i) ASSERT_EQ(out[i], T(77)) << "wrote past n=" << n;
+        }
+    }
+
+    std::mt19937_64 gen{5};
+};
+
+TEST_F(QuantOpsTest, ElementwiseWrapsLikeScalar) {
+    auto add = [](auto a, auto b) {
+        using T = decltype(a);
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<U>(static_cast<U>(a) + static_cast<U>(b)));
+    };
+    auto mul = [](auto a, auto b) {
+        using T = decltype(a);
+        using U = std::make_unsigned_t<T>;
+        using W = std::conditional_t<(sizeof(T) < 4), uint32_t, U>;
+        return static_cast<T>(static_cast<U>(static_cast<W>(static_cast<U>(a)) * static_cast<W>(static_cast<U>(b))));
+    };
+    check_elementwise<int8_t>(core_vector_add_i8, add);
+    check_elementwise<int16_t>(core_vector_add_i16, add);
+    check_elementwise<int64_t>(core_vector_add_i64, add);
+    check_elementwise<int8_t>(core_vector_mul_i8, mul);
+    check_elementwise<int16_t>(core_vector_mul_i16, mul);
+    check_elementwise<int64_t>(core_vector_mul_i64, mul);
+}
+
+TEST_F(QuantOpsTest, SumsAndDotsAreExact) {
+    for (size_t n : {0u, 1u, 15u, 16u, 64u, 100u, 4097u, 131071u}) {
+        auto a8 = random_ints<int8_t>(n), b8 = random_ints<int8_t>(n);
+        auto s16 = random_ints<int16_t>(n);
+        auto a16 = random_ints<int16_t>(n, -32767, 32767), b16 = random_ints<int16_t>(n, -32767, 32767);
+        auto a64 = random_ints<int64_t>(n), b64 = random_ints<int64_t>(n);
+        int64_t sum8 = 0, sum16 = 0, dot8 = 0, dot16 = 0;
+        uint64_t sum64 = 0, dot64 = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum8 += a8[i];
+            sum16 += s16[i];
+            sum64 += static_cast<uint64_t>(a64[i]);
+            dot8 += static_cast<int32_t>(a8[i]) * b8[i];
+            dot16 += static_cast<int32_t>(a16[i]) * b16[i];
+            dot64 += static_cast<uint64_t>(a64[i]) * static_cast<uint64_t>(b64[i]);
+        }
+        EXPECT_EQ(core_vector_sum_i8(a8.data(), n), sum8) << n;
+        EXPECT_EQ(core_vector_sum_i16(s16.data(), n), sum16) << n;
+        EXPECT_EQ(static_cast<uint64_t>(core_vector_sum_i64(a64.data(), n)), sum64) << n;
+        EXPECT_EQ(core_vector_dot_i8(a8.data(), b8.data(), n), dot8) << n;
+        EXPECT_EQ(core_vector_dot_i16(a16.data(), b16.data(), n), dot16) << n;
+        EXPECT_EQ(static_cast<uint64_t>(core_vector_dot_i64(a64.data(), b64.data(), n)), dot64) << n;
+    }
+    // Крайний случай int8: все (-128) * (-128)
+    std::vector<int8_t> minimum(131071, -128);
+    EXPECT_EQ(core_vector_dot_i8(minimum.data(), minimum.data(), minimum.size()), 131071 * 16384);
+    EXPECT_EQ(core_vector_sum_i8(minimum.data(), minimum.size()), -128 * 131071);
+}
+
+TEST_F(QuantOpsTest, QuantizeRoundsAndSaturates) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+    std::vector<float> special = {0.5f, 1.5f, 2.5f, -0.5f, -1.5f, 126.5f, 127.4f, 200.0f, -1e9f, inf, -inf, nan, -0.0f};
+    const std::vector<int8_t> expected = {0, 2, 2, 0, -2, 126, 127, 127, -127, 127, -127, 0, 0};
+    for (size_t copies : {1u, 5u}) {
+        // Повторы проводят особые значения через векторный путь
+        std::vector<float> src;
+        for (size_t c = 0; c < copies; ++c) src.insert(src.end(), special.begin(), special.end());
+        std::vector<int8_t> q(src.size());
+        core_vector_quantize_i8(q.data(), src.data(), src.size(), 1.0f);
+        for (size_t i = 0; i < q.size(); ++i) ASSERT_EQ(q[i], expected[i % expected.size()]) << "i=" << i;
+    }
+
+    auto x = random_floats(1003, -3.0f, 3.0f);
+    const float scale = 3.0f / 127.0f;
+    std::vector<int8_t> q(x.size());
+    std::vector<float> back(x.size());
+    core_vector_quantize_i8(q.data(), x.data(), x.size(), scale);
+    core_vector_dequantize_i8(back.data(), q.data(), q.size(), scale);
+    for (size_t i = 0; i < x.size(); ++i) {
+        ASSERT_EQ(q[i], static_cast<int8_t>(std::nearbyint(x[i] * (1.0f / scale)))) << "i=" << i;
+        ASSERT_EQ(back[i], static_cast<float>(q[i]) * scale);
+        ASSERT_LE(std::fabs(back[i] - x[i]), 0.5f * scale * 1.0001f);
+    }
+}
+
+TEST_F(QuantOpsTest, ConvolveInt8MatchesReference) {
+    for (size_t kernel_size : {1u, 2u, 3u, 4u, 5u, 8u, 11u, 32u}) {
+        for (size_t src_size : {kernel_size, kernel_size + 1, kernel_size + 7, size_t{40}, size_t{257}}) {
+            if (src_size < kernel_size) continue;
+            auto src = random_ints<int8_t>(src_size), kernel = random_ints<int8_t>(kernel_size);
+            const size_t out_size = src_size - kernel_size + 1;
+            std::vector<int32_t> out(out_size + 2, 99);
+            core_convolve_i8(out.data(), src.data(), src.size(), kernel.data(), kernel.size());
+            for (size_t i = 0; i < out_size; ++i) {
+                int32_t ref = 0;
+                for (size_t j = 0; j < kernel_size; ++j) ref += static_cast<int32_t>(src[i + j]) * kernel[j];
+                ASSERT_EQ(out[i], ref) << "k=" << kernel_size << " n=" << src_size << " i=" << i;
+            }
+            ASSERT_EQ(out[out_size], 99);
+        }
+    }
+    int32_t untouched = 5;
+    int8_t one = 1;
+    core_convolve_i8(&untouched, &one, 1, nullptr, 0);
+    std::vector<int8_t> big(3, 1);
+    core_convolve_i8(&untouched, &one, 1, big.data(), big.size());
+    EXPECT_EQ(untouched, 5);
+}
+
+TEST_F(QuantOpsTest, Bf16ConversionRoundsToNearestEven) {
+    std::uniform_int_distribution<uint32_t> bits(0, 0xFFFFFFFFu);
+    std::vector<float> src(1 << 18);
+    for (auto& x : src) x = bits_float(bits(gen));
+    // Точные середины, переполнение, денормализованные, нули и бесконечности
+    const float specials[] = {bits_float(0x3F808000u), bits_float(0x3F818000u), bits_float(0x7F7FFFFFu),
+                              bits_float(0x7F7F8000u), bits_float(0x00018000u), bits_float(0x80008001u),
+                              0.0f, -0.0f, INFINITY, -INFINITY, bits_float(0x7F800001u)};
+    for (size_t i = 0; i < sizeof(specials) / sizeof(specials[0]); ++i) src[i * 7] = specials[i];
+
+    std::vector<core_bf16_t> bf(src.size());
+    core_vector_f32_to_bf16(bf.data(), src.data(), src.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+        ASSERT_EQ(bf[i].bits, reference_bf16(src[i])) << std::hex << float_bits(src[i]);
+    }
+
+    std::vector<float> back(src.size());
+    core_vector_bf16_to_f32(back.data(), bf.data(), bf.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+        ASSERT_EQ(float_bits(back[i]), static_cast<uint32_t>(bf[i].bits) << 16);
+    }
+}
+
+TEST_F(QuantOpsTest, Bf16DotAndConvolution) {
+    for (size_t n : {0u, 1u, 31u, 32u, 33u, 1000u}) {
+        auto a = random_floats(n, -1.0f, 1.0f), b = random_floats(n, -1.0f, 1.0f);
+        std::vector<core_bf16_t> ba(n), bb(n);
+        core_vector_f32_to_bf16(ba.data(), a.data(), n);
+        core_vector_f32_to_bf16(bb.data(), b.data(), n);
+        double ref = 0.0;
+        for (size_t i = 0; i < n; ++i) ref += static_cast<double>(bf16_value(ba[i])) * bf16_value(bb[i]);
+        EXPECT_NEAR(core_vector_dot_bf16(ba.data(), bb.data(), n), ref, 1e-5 * (1.0 + static_cast<double>(n)));
+    }
+
+    for (size_t kernel_size : {1u, 3u, 9u}) {
+        const size_t src_size = 211;
+        auto src = random_floats(src_size, -1.0f, 1.0f), kernel = random_floats(kernel_size, -1.0f, 1.0f);
+        std::vector<core_bf16_t> bsrc(src_size), bkernel(kernel_size);
+        core_vector_f32_to_bf16(bsrc.data(), src.data(), src_size);
+        core_vector_f32_to_bf16(bkernel.data(), kernel.data(), kernel_size);
+        std::vector<float> out(src_size - kernel_size + 1);
+        core_convolve_bf16(out.data(), bsrc.data(), src_size, bkernel.data(), kernel_size);
+        for (size_t i = 0; i < out.size(); ++i) {
+            double ref = 0.0;
+            for (size_t j = 0; j < kernel_size; ++j) {
+                ref += static_cast<double>(bf16_value(bsrc[i + j])) * bf16_value(bkernel[j]);
+            }
+            ASSERT_NEAR(out[i], ref, 1e-5) << "k=" << kernel_size << " i=" << i;
+        }
+    }
+}
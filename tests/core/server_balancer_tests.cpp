@@ -0,0 +1,653 @@
+#include <gtest/gtest.h>
+#include "load_balancer/load_balancer.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace core::loadbalancer;
+
+namespace {
+
+ServerConfig backend(const std::string& address, uint32_t weight = 1) {
+    ServerConfig config;
+    config.address = address;
+    config.port = 8080;
+    config.weight = weight;
+    return config;
+}
+
+std::string name(int i) {
+    return "10.0.0." + std::to_string(i);
+}
+
+// Заместитель сервера на петлевом адресе. Ядро завершает рукопожатие само,
+// accept не нужен. Зависший сервер — очередь listen(0), занятая одним
+// соединением: следующие SYN отбрасываются и connect не завершается.
+class StandIn {
+public:
+    explicit StandIn(const std::string& address) : address_(address) {}
+    ~StandIn() { stop(); }
+
+    void start(bool hanging = false) {
+        listener_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int one = 1;
+        setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port_);
+        inet_pton(AF_INET, address_.c_str(), &addr.sin_addr);
+        ASSERT_EQ(bind(listener_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        ASSERT_EQ(listen(listener_, hanging ? 0 : 64), 0);
+        socklen_t len = sizeof(addr);
+        getsockname(listener_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        if (hanging) {
+            filler_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            ASSERT_EQ(connect(filler_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        }
+    }
+
+    // Порт остаётся за заместителем: connect получает отказ
+    void stop() {
+        if (filler_ >= 0) {
+            close(filler_);
+            filler_ = -1;
+        }
+        if (listener_ >= 0) {
+            close(listener_);
+            listener_ = -1;
+        }
+    }
+
+    ServerConfig config(std::chrono::milliseconds interval, std::chrono::milliseconds timeout) const {
+        ServerConfig config = backend(address_);
+        config.port = port_;
+        config.health_check_interval = interval;
+        config.timeout = timeout;
+        return config;
+    }
+
+    const std::string& address() const { return address_; }
+
+private:
+    std::string address_;
+    uint16_t port_ = 0;
+    int listener_ = -1;
+    int filler_ = -1;
+};
+
+template <typename Predicate>
+bool wait_for(Predicate predicate, std::chrono::milliseconds limit = std::chrono::milliseconds(3000)) {
+    auto deadline = std::chrono::steady_clock::now() + limit;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+} // namespace
+
+// Круговой обход: каждый сервер ровно раз за круг
+TEST(ServerBalancerTest, RoundRobinVisitsEveryServerEvenly) {
+    LoadBalancer balancer(Algorithm::ROUND_ROBIN);
+    EXPECT_EQ(balancer.get_next_server(), "");
+    for (int i = 0; i < 5; i++) {
+        balancer.add_server(backend(name(i)));
+    }
+
+    std::map<std::string, int> hits;
+    for (int i = 0; i < 500; i++) {
+        hits[balancer.get_next_server()]++;
+    }
+    ASSERT_EQ(hits.size(), 5u);
+    for (const auto& [address, count] : hits) {
+        EXPECT_EQ(count, 100) << address;
+        EXPECT_EQ(balancer.get_server_stats(address).active_connections, 100u);
+    }
+
+    // Удалённый сервер сразу пропадает из выбора
+    balancer.remove_server(name(0));
+    for (int i = 0; i < 100; i++) {
+        EXPECT_NE(balancer.get_next_server(), name(0));
+    }
+}
+
+// Таблица псевдонимов: доли выбора пропорциональны весам
+TEST(ServerBalancerTest, WeightedSelectionFollowsWeights) {
+    LoadBalancer balancer(Algorithm::WEIGHTED_ROUND_ROBIN);
+    balancer.add_server(backend("a", 1));
+    balancer.add_server(backend("b", 3));
+    balancer.add_server(backend("c", 6));
+    balancer.add_server(backend("zero", 0));
+
+    constexpr int kPicks = 100000;
+    std::map<std::string, int> hits;
+    for (int i = 0; i < kPicks; i++) {
+        hits[balancer.get_next_server()]++;
+    }
+    EXPECT_EQ(hits["zero"], 0);
+    EXPECT_NEAR(hits["a"], kPicks * 0.1, kPicks * 0.01);
+    EXPECT_NEAR(hits["b"], kPicks * 0.3, kPicks * 0.01);
+    EXPECT_NEAR(hits["c"], kPicks * 0.6, kPicks * 0.01);
+
+    // Новый вес действует после публикации нового снимка
+    balancer.update_server_weight("a", 6);
+    hits.clear();
+    for (int i = 0; i < kPicks; i++) {
+        hits[balancer.get_next_server()]++;
+    }
+    EXPECT_NEAR(hits["a"], kPicks * 0.4, kPicks * 0.01);
+    EXPECT_NEAR(hits["c"], kPicks * 0.4, kPicks * 0.01);
+    EXPECT_EQ(balancer.get_server_stats("a").weight, 6u);
+}
+
+// Два случайных кандидата: запросы уходят от загруженного сервера, а
+// незавершённые запросы выравниваются по всем серверам
+TEST(ServerBalancerTest, LeastConnectionsAvoidsBusyServers) {
+    LoadBalancer balancer(Algorithm::LEAST_CONNECTIONS);
+    constexpr int kServers = 1000;
+    for (int i = 0; i < kServers; i++) {
+        balancer.add_server(backend(name(i)));
+    }
+
+    // Незавершённые запросы без ответа копятся на выбранных серверах
+    for (int i = 0; i < kServers * 20; i++) {
+        ASSERT_FALSE(balancer.get_next_server().empty());
+    }
+    uint64_t max_active = 0;
+    uint64_t min_active = UINT64_MAX;
+    for (const auto& [address, stats] : balancer.get_all_stats()) {
+        max_active = std::max(max_active, stats.active_connections);
+        min_active = std::min(min_active, stats.active_connections);
+    }
+    // Случайный выбор дал бы разброс в несколько десятков; у двух
+    // кандидатов он растёт лишь как log log n
+    EXPECT_LE(max_active - min_active, 12u);
+
+    // Ответ освобождает слот, но не уводит счётчик ниже нуля
+    balancer.report_server_response(name(0), true, std::chrono::milliseconds(5));
+    auto stats = balancer.get_server_stats(name(0));
+    EXPECT_EQ(stats.total_requests, 1u);
+    for (int i = 0; i < 100; i++) {
+        balancer.report_server_response(name(0), false, std::chrono::milliseconds(5));
+    }
+    stats = balancer.get_server_stats(name(0));
+    EXPECT_EQ(stats.active_connections, 0u);
+    EXPECT_EQ(stats.failed_requests, 100u);
+}
+
+// Выбор идёт параллельно с добавлением и удалением серверов: читатели
+// видят только целые снимки, постоянные серверы всегда доступны
+TEST(ServerBalancerTest, SelectionRunsConcurrentlyWithUpdates) {
+    for (Algorithm algorithm : {Algorithm::ROUND_ROBIN, Algorithm::LEAST_CONNECTIONS,
+                                Algorithm::WEIGHTED_ROUND_ROBIN, Algorithm::LEAST_RESPONSE_TIME,
+                                Algorithm::IP_HASH, Algorithm::CONSISTENT_HASH}) {
+        LoadBalancer balancer(algorithm);
+        balancer.add_server(backend("stable-0", 2));
+        balancer.add_server(backend("stable-1", 2));
+
+        std::atomic<bool> done{false};
+        std::atomic<int> empty{0};
+        std::atomic<int> picks{0};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; t++) {
+            readers.emplace_back([&] {
+                while (!done.load()) {
+                    std::string address = balancer.get_next_server("client-" + std::to_string(picks % 64));
+                    if (address.empty()) {
+                        empty++;
+                        continue;
+                    }
+                    picks++;
+                    balancer.report_server_response(address, true, std::chrono::milliseconds(1));
+                }
+            });
+        }
+
+        while (picks.load() == 0) {
+            std::this_thread::yield();
+        }
+        for (int round = 0; round < 200; round++) {
+            std::string address = "churn-" + std::to_string(round % 8);
+            balancer.add_server(backend(address, 1 + round % 3));
+            balancer.update_server_weight(address, 1 + round % 5);
+            if (round % 2) {
+                balancer.remove_server(address);
+            }
+        }
+        done = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        EXPECT_EQ(empty.load(), 0);
+        EXPECT_GT(picks.load(), 0);
+        EXPECT_EQ(balancer.get_server_stats("stable-0").weight, 2u);
+    }
+}
+
+// Таблица Maglev: ключ всегда попадает на один сервер, доли равны, а при
+// удалении сервера переезжают почти только его ключи
+TEST(ServerBalancerTest, IpHashKeepsAffinityAcrossMembershipChanges) {
+    LoadBalancer balancer(Algorithm::IP_HASH);
+    constexpr int kServers = 10;
+    constexpr int kKeys = 20000;
+    for (int i = 0; i < kServers; i++) {
+        balancer.add_server(backend(name(i)));
+    }
+
+    auto route = [&](int key) {
+        std::string client = "192.168." + std::to_string(key / 256) + "." + std::to_string(key % 256);
+        std::string address = balancer.get_next_server(client);
+        balancer.report_server_response(address, true, std::chrono::milliseconds(1));
+        return address;
+    };
+
+    std::vector<std::string> before(kKeys);
+    std::map<std::string, int> share;
+    for (int key = 0; key < kKeys; key++) {
+        before[key] = route(key);
+        share[before[key]]++;
+        ASSERT_EQ(route(key), before[key]);
+    }
+    ASSERT_EQ(share.size(), size_t(kServers));
+    for (const auto& [address, count] : share) {
+        EXPECT_NEAR(count, kKeys / kServers, kKeys / kServers * 0.1) << address;
+    }
+
+    balancer.remove_server(name(3));
+    int moved = 0;
+    for (int key = 0; key < kKeys; key++) {
+        std::string after = route(key);
+        EXPECT_NE(after, name(3));
+        if (before[key] != name(3) && after != before[key]) {
+            moved++;
+        }
+    }
+    EXPECT_LT(moved, kKeys / 50);
+
+    // Вернувшийся сервер получает обратно свои ключи
+    balancer.add_server(backend(name(3)));
+    int restored = 0;
+    for (int key = 0; key < kKeys; key++) {
+        restored += route(key) == before[key];
+    }
+    EXPECT_GT(restored, kKeys * 98 / 100);
+
+    // Без ключа хеш-алгоритм работает как круговой обход
+    std::map<std::string, int> keyless;
+    for (int i = 0; i < kServers * 10; i++) {
+        keyless[balancer.get_next_server()]++;
+    }
+    EXPECT_EQ(keyless.size(), size_t(kServers));
+}
+
+// Веса задают число слотов сервера в таблице
+TEST(ServerBalancerTest, IpHashFollowsWeights) {
+    LoadBalancer balancer(Algorithm::IP_HASH);
+    balancer.add_server(backend("light", 1));
+    balancer.add_server(backend("heavy", 3));
+
+    constexpr int kKeys = 40000;
+    int heavy = 0;
+    for (int key = 0; key < kKeys; key++) {
+        std::string address = balancer.get_next_server("key-" + std::to_string(key));
+        heavy += address == "heavy";
+        balancer.report_server_response(address, true, std::chrono::milliseconds(1));
+    }
+    EXPECT_NEAR(heavy, kKeys * 0.75, kKeys * 0.02);
+
+    balancer.update_server_weight("light", 3);
+    heavy = 0;
+    for (int key = 0; key < kKeys; key++) {
+        std::string address = balancer.get_next_server("key-" + std::to_string(key));
+        heavy += address == "heavy";
+        balancer.report_server_response(address, true, std::chrono::milliseconds(1));
+    }
+    EXPECT_NEAR(heavy, kKeys * 0.5, kKeys * 0.02);
+}
+
+// Исключение не перестраивает таблицу: ключи остальных серверов не
+// двигаются, ключи исключённого расходятся по соседям и потом возвращаются
+TEST(ServerBalancerTest, IpHashKeepsTableAcrossEjection) {
+    LoadBalancer balancer(Algorithm::IP_HASH);
+    OutlierDetectionConfig config;
+    config.consecutive_failures = 3;
+    config.interval = std::chrono::milliseconds(10);
+    config.base_ejection_time = std::chrono::milliseconds(50);
+    config.success_rate_request_volume = 1u << 30;
+    config.readmission_ramp = std::chrono::milliseconds(0);
+    balancer.set_outlier_detection(config);
+    constexpr int kServers = 10;
+    constexpr int kKeys = 5000;
+    for (int i = 0; i < kServers; i++) {
+        balancer.add_server(backend(name(i)));
+    }
+
+    auto route = [&](int key) {
+        std::string address = balancer.get_next_server("client-" + std::to_string(key));
+        balancer.report_server_response(address, true, std::chrono::milliseconds(1));
+        return address;
+    };
+    std::vector<std::string> before(kKeys);
+    for (int key = 0; key < kKeys; key++) {
+        before[key] = route(key);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        balancer.report_server_response(name(3), false, std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(balancer.get_server_stats(name(3)).is_ejected);
+    std::set<std::string> spread;
+    for (int key = 0; key < kKeys; key++) {
+        std::string after = route(key);
+        ASSERT_NE(after, name(3));
+        if (before[key] == name(3)) {
+            spread.insert(after);
+        } else {
+            ASSERT_EQ(after, before[key]);
+        }
+    }
+    EXPECT_GT(spread.size(), 3u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    balancer.report_server_response(name(0), true, std::chrono::milliseconds(1));
+    ASSERT_FALSE(balancer.get_server_stats(name(3)).is_ejected);
+    for (int key = 0; key < kKeys; key++) {
+        ASSERT_EQ(route(key), before[key]);
+    }
+}
+
+// Ограниченная нагрузка: горячий ключ заполняет свой сервер до предела
+// и переливается на другие, а обычные ключи остаются на своих серверах
+TEST(ServerBalancerTest, ConsistentHashBoundsHotKeyLoad) {
+    LoadBalancer balancer(Algorithm::CONSISTENT_HASH);
+    constexpr int kServers = 4;
+    for (int i = 0; i < kServers; i++) {
+        balancer.add_server(backend(name(i)));
+    }
+
+    std::string home = balancer.get_next_server("hot");
+    balancer.report_server_response(home, true, std::chrono::milliseconds(1));
+    EXPECT_EQ(balancer.get_next_server("hot"), home);
+    balancer.report_server_response(home, true, std::chrono::milliseconds(1));
+
+    // Запросы без ответов: все они остаются незавершёнными
+    constexpr int kRequests = 1000;
+    std::map<std::string, int> hits;
+    for (int i = 0; i < kRequests; i++) {
+        hits[balancer.get_next_server("hot")]++;
+    }
+    const int capacity = static_cast<int>(std::ceil(1.25 * kRequests / kServers));
+    EXPECT_GT(hits.size(), 1u);
+    EXPECT_GE(hits[home], capacity - 1);
+    for (const auto& [address, count] : hits) {
+        EXPECT_LE(count, capacity) << address;
+    }
+
+    // Когда нагрузка ушла, ключ возвращается домой
+    for (const auto& [address, count] : hits) {
+        for (int i = 0; i < count; i++) {
+            balancer.report_server_response(address, true, std::chrono::milliseconds(1));
+        }
+    }
+    EXPECT_EQ(balancer.get_next_server("hot"), home);
+}
+
+// Peak-EWMA: медленный сервер и сервер с всплеском задержки сразу теряют
+// трафик, незавершённые запросы тоже увеличивают стоимость
+TEST(ServerBalancerTest, PeakEwmaSteersAwayFromSlowServers) {
+    LoadBalancer balancer(Algorithm::LEAST_RESPONSE_TIME);
+    for (const char* address : {"fast-0", "fast-1", "slow"}) {
+        balancer.add_server(backend(address));
+    }
+
+    auto latency = [](const std::string& address) {
+        return std::chrono::milliseconds(address == "slow" ? 50 : 5);
+    };
+    std::map<std::string, int> hits;
+    for (int i = 0; i < 3000; i++) {
+        std::string address = balancer.get_next_server();
+        if (i >= 2000) {
+            hits[address]++;
+        }
+        balancer.report_server_response(address, true, latency(address));
+    }
+    EXPECT_LT(hits["slow"], 50);
+    EXPECT_NEAR(balancer.get_server_stats("slow").response_time_ms, 50.0, 1.0);
+
+    // Одна медленная выборка поднимает оценку сразу, а не на долю alpha
+    balancer.report_server_response("fast-0", true, std::chrono::milliseconds(200));
+    EXPECT_DOUBLE_EQ(balancer.get_server_stats("fast-0").response_time_ms, 200.0);
+    hits.clear();
+    for (int i = 0; i < 1000; i++) {
+        std::string address = balancer.get_next_server();
+        hits[address]++;
+        balancer.report_server_response(address, true, latency(address));
+    }
+    EXPECT_LT(hits["fast-0"], 50);
+    EXPECT_GT(hits["fast-1"], 600);
+
+    // Незавершённые запросы: при равной задержке выбор уходит к свободному
+    LoadBalancer pending(Algorithm::LEAST_RESPONSE_TIME);
+    pending.add_server(backend("a"));
+    pending.add_server(backend("b"));
+    pending.report_server_response("a", true, std::chrono::milliseconds(10));
+    pending.report_server_response("b", true, std::chrono::milliseconds(10));
+    for (int i = 0; i < 100; i++) {
+        pending.get_next_server();
+    }
+    auto a = pending.get_server_stats("a").active_connections;
+    auto b = pending.get_server_stats("b").active_connections;
+    EXPECT_LE(std::max(a, b) - std::min(a, b), 1u);
+}
+
+// Подряд идущие отказы: сервер исключается, после срока возвращается с
+// постепенно растущей долей трафика; исключить можно не больше половины
+TEST(ServerBalancerTest, ConsecutiveFailuresEjectAndRampBack) {
+    LoadBalancer balancer(Algorithm::ROUND_ROBIN);
+    OutlierDetectionConfig config;
+    config.consecutive_failures = 3;
+    config.interval = std::chrono::milliseconds(10);
+    config.base_ejection_time = std::chrono::milliseconds(100);
+    config.readmission_ramp = std::chrono::milliseconds(400);
+    balancer.set_outlier_detection(config);
+    for (int i = 0; i < 4; i++) {
+        balancer.add_server(backend(name(i)));
+    }
+
+    for (int i = 0; i < 3; i++) {
+        balancer.report_server_response(name(0), false, std::chrono::milliseconds(1));
+    }
+    auto stats = balancer.get_server_stats(name(0));
+    EXPECT_TRUE(stats.is_ejected);
+    EXPECT_EQ(stats.ejection_count, 1u);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_NE(balancer.get_next_server(), name(0));
+    }
+
+    // Второй сервер ещё можно исключить, третий уже нет
+    for (int server = 1; server <= 2; server++) {
+        for (int i = 0; i < 3; i++) {
+            balancer.report_server_response(name(server), false, std::chrono::milliseconds(1));
+        }
+    }
+    EXPECT_TRUE(balancer.get_server_stats(name(1)).is_ejected);
+    EXPECT_FALSE(balancer.get_server_stats(name(2)).is_ejected);
+
+    // Срок вышел: следующий отчёт запускает проверку и возвращает серверы
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    balancer.report_server_response(name(3), true, std::chrono::milliseconds(1));
+    EXPECT_FALSE(balancer.get_server_stats(name(0)).is_ejected);
+
+    std::map<std::string, int> hits;
+    for (int i = 0; i < 400; i++) {
+        hits[balancer.get_next_server()]++;
+    }
+    EXPECT_GT(hits[name(0)], 0);
+    EXPECT_LT(hits[name(0)], 60);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(450));
+    hits.clear();
+    for (int i = 0; i < 400; i++) {
+        hits[balancer.get_next_server()]++;
+    }
+    EXPECT_EQ(hits[name(0)], 100);
+}
+
+// Доля успехов: сервер, заметно уступающий остальным, исключается
+TEST(ServerBalancerTest, SuccessRateOutlierIsEjected) {
+    LoadBalancer balancer(Algorithm::ROUND_ROBIN);
+    OutlierDetectionConfig config;
+    config.consecutive_failures = 1000;
+    config.interval = std::chrono::milliseconds(100);
+    config.success_rate_request_volume = 50;
+    balancer.set_outlier_detection(config);
+    constexpr int kServers = 8;
+    for (int i = 0; i < kServers; i++) {
+        balancer.add_server(backend(name(i)));
+    }
+
+    // Первый отчёт открывает интервал
+    balancer.report_server_response(name(1), true, std::chrono::milliseconds(1));
+    for (int i = 0; i < 200; i++) {
+        for (int server = 0; server < kServers; server++) {
+            bool success = server == 0 ? i % 3 != 0 : i % 100 != 0;
+            balancer.report_server_response(name(server), success, std::chrono::milliseconds(1));
+        }
+    }
+    EXPECT_FALSE(balancer.get_server_stats(name(0)).is_ejected);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    balancer.report_server_response(name(1), true, std::chrono::milliseconds(1));
+    EXPECT_TRUE(balancer.get_server_stats(name(0)).is_ejected);
+    for (int server = 1; server < kServers; server++) {
+        EXPECT_FALSE(balancer.get_server_stats(name(server)).is_ejected);
+    }
+}
+
+// Активные проверки: упавший заместитель выходит из ротации, поднятый
+// снова возвращается
+TEST(ServerBalancerTest, HealthChecksFollowLoopbackServers) {
+    StandIn up("127.0.0.1");
+    StandIn flaky("127.0.0.2");
+    up.start();
+    flaky.start();
+
+    LoadBalancer balancer(Algorithm::ROUND_ROBIN);
+    const auto interval = std::chrono::milliseconds(20);
+    const auto timeout = std::chrono::milliseconds(500);
+    balancer.add_server(up.config(interval, timeout));
+    balancer.add_server(flaky.config(interval, timeout));
+    balancer.start_health_checks();
+
+    auto checked = balancer.get_server_stats(up.address()).last_health_check;
+    ASSERT_TRUE(wait_for([&] { return balancer.get_server_stats(up.address()).last_health_check > checked; }));
+    EXPECT_TRUE(balancer.get_server_stats(flaky.address()).is_healthy);
+
+    flaky.stop();
+    ASSERT_TRUE(wait_for([&] { return !balancer.get_server_stats(flaky.address()).is_healthy; }));
+    EXPECT_TRUE(balancer.get_server_stats(up.address()).is_healthy);
+    for (int i = 0; i < 20; i++) {
+        EXPECT_EQ(balancer.get_next_server(), up.address());
+    }
+
+    flaky.start();
+    ASSERT_TRUE(wait_for([&] { return balancer.get_server_stats(flaky.address()).is_healthy; }));
+
+    // Сервер, добавленный во время проверок, тоже проверяется
+    StandIn late("127.0.0.3");
+    late.start();
+    balancer.add_server(late.config(interval, timeout));
+    checked = balancer.get_server_stats(late.address()).last_health_check;
+    EXPECT_TRUE(wait_for([&] { return balancer.get_server_stats(late.address()).last_health_check > checked; }));
+
+    balancer.stop_health_checks();
+    balancer.remove_server(late.address());
+}
+
+// Зависший сервер ждёт своего тайм-аута, не задерживая проверки остальных
+TEST(ServerBalancerTest, HangingServerDoesNotDelayOtherChecks) {
+    StandIn fast("127.0.0.4");
+    StandIn hanging("127.0.0.5");
+    fast.start();
+    hanging.start(true);
+
+    LoadBalancer balancer(Algorithm::ROUND_ROBIN);
+    balancer.add_server(fast.config(std::chrono::milliseconds(10), std::chrono::milliseconds(500)));
+    balancer.add_server(hanging.config(std::chrono::milliseconds(10), std::chrono::milliseconds(150)));
+    balancer.start_health_checks();
+
+    // За время трёх тайм-аутов зависшего быстрый проверен много раз
+    auto started = std::chrono::steady_clock::now();
+    int fresh = 0;
+    while (balancer.get_server_stats(hanging.address()).is_healthy &&
+           std::chrono::steady_clock::now() - started < std::chrono::seconds(3)) {
+        auto age = std::chrono::steady_clock::now() - balancer.get_server_stats(fast.address()).last_health_check;
+        fresh += age < std::chrono::milliseconds(100);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    EXPECT_FALSE(balancer.get_server_stats(hanging.address()).is_healthy);
+    EXPECT_GE(elapsed, std::chrono::milliseconds(300));
+    EXPECT_GT(fresh, 10);
+    EXPECT_TRUE(balancer.get_server_stats(fast.address()).is_healthy);
+}
+
+// Пассивное здоровье: ответы двигают те же серии, что и проверки
+TEST(ServerBalancerTest, ReportedResponsesDriveHealth) {
+    StandIn a("127.0.0.6");
+    StandIn b("127.0.0.7");
+    a.start();
+    b.start();
+    // Интервал в час: в ходе теста активные проверки не вмешиваются
+    const auto interval = std::chrono::hours(1);
+    LoadBalancer balancer(Algorithm::ROUND_ROBIN);
+    balancer.add_server(a.config(interval, std::chrono::milliseconds(500)));
+    balancer.add_server(b.config(interval, std::chrono::milliseconds(500)));
+
+    // Без активных проверок серия отказов здоровье не меняет: вернуть
+    // сервер было бы некому
+    for (int i = 0; i < 3; i++) {
+        balancer.report_server_response(a.address(), false, std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(balancer.get_server_stats(a.address()).is_healthy);
+    balancer.report_server_response(a.address(), true, std::chrono::milliseconds(1));
+
+    balancer.start_health_checks();
+    balancer.report_server_response(a.address(), false, std::chrono::milliseconds(1));
+    balancer.report_server_response(a.address(), false, std::chrono::milliseconds(1));
+    EXPECT_TRUE(balancer.get_server_stats(a.address()).is_healthy);
+    balancer.report_server_response(a.address(), false, std::chrono::milliseconds(1));
+    EXPECT_FALSE(balancer.get_server_stats(a.address()).is_healthy);
+    EXPECT_FALSE(balancer.get_server_stats(a.address()).is_ejected);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(balancer.get_next_server(), b.address());
+    }
+
+    // Успех обрывает серию отказов; двух подряд достаточно для возврата
+    balancer.report_server_response(a.address(), true, std::chrono::milliseconds(1));
+    EXPECT_FALSE(balancer.get_server_stats(a.address()).is_healthy);
+    balancer.report_server_response(a.address(), true, std::chrono::milliseconds(1));
+    EXPECT_TRUE(balancer.get_server_stats(a.address()).is_healthy);
+
+    // После остановки проверок все серверы снова в ротации
+    for (int i = 0; i < 3; i++) {
+        balancer.report_server_response(a.address(), false, std::chrono::milliseconds(1));
+    }
+    EXPECT_FALSE(balancer.get_server_stats(a.address()).is_healthy);
+    balancer.stop_health_checks();
+    EXPECT_TRUE(balancer.get_server_stats(a.address()).is_healthy);
+}
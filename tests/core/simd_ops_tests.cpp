@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+#include "core/optimization/simd_ops.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Свойства SIMD-ядер проверяются против скалярных эталонов на всех длинах
+// от 0 до нескольких ширин регистра, чтобы покрыть маскированные хвосты.
+
+class SIMDOpsTest : public ::testing::Test {
+protected:
+    static constexpr size_t kMaxLen = 133;
+
+    std::vector<float> random_floats(size_t n, float lo = -100.0f, float hi = 100.0f) {
+        std::uniform_real_distribution<float> dis(lo, hi);
+        std::vector<float> v(n);
+        for (auto& x : v) x = dis(gen);
+        return v;
+    }
+
+    std::vector<int32_t> random_ints(size_t n, int32_t lo = -100000, int32_t hi = 100000) {
+        std::uniform_int_distribution<int32_t> dis(lo, hi);
+        std::vector<int32_t> v(n);
+        for (auto& x : v) x = dis(gen);
+        return v;
+    }
+
+    // Буфер с охранными элементами за концом: ядро не должно их трогать
+    static std::vector<float> guarded(size_t n) {
+        return std::vector<float>(n + 16, 12345.0f);
+    }
+
+    static void expect_guard_intact(const std::vector<float>& v, size_t n) {
+        for (size_t i = n; i < v.size(); ++i) {
+            ASSERT_EQ(v[i], 12345.0f) << "write past end at " << i;
+        }
+    }
+
+    std::mt19937 gen{42};
+};
+
+TEST_F(SIMDOpsTest, ReportsISA) {
+    EXPECT_NE(core_simd_isa_name(), nullptr);
+    EXPECT_GE(core_simd_width_f32(), 1u);
+    EXPECT_EQ(64 % core_simd_width_f32(), 0u);
+}
+
+TEST_F(SIMDOpsTest, ElementwiseFloatMatchesScalar) {
+    for (size_t n = 0; n <= kMaxLen; ++n) {
+        auto a = random_floats(n), b = random_floats(n), c = random_floats(n);
+        auto out = guarded(n);
+
+        core_vector_add_f32(out.data(), a.data(), b.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], a[i] + b[i]);
+        expect_guard_intact(out, n);
+
+        core_vector_sub_f32(out.data(), a.data(), b.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], a[i] - b[i]);
+
+        core_vector_mul_f32(out.data(), a.data(), b.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], a[i] * b[i]);
+
+        core_vector_min_f32(out.data(), a.data(), b.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], std::min(a[i], b[i]));
+
+        core_vector_max_f32(out.data(), a.data(), b.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], std::max(a[i], b[i]));
+
+        core_vector_fma_f32(out.data(), a.data(), b.data(), c.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_NEAR(out[i], a[i] * b[i] + c[i], 1e-2f);
+
+        core_vector_abs_f32(out.data(), a.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], std::fabs(a[i]));
+        expect_guard_intact(out, n);
+    }
+}
+
+TEST_F(SIMDOpsTest, ElementwiseIntMatchesScalar) {
+    for (size_t n = 0; n <= kMaxLen; ++n) {
+        auto a = random_ints(n), b = random_ints(n);
+        std::vector<int32_t> out(n + 16, 7);
+
+        core_vector_add_i32(out.data(), a.data(), b.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], a[i] + b[i]);
+
+        core_vector_sub_i32(out.data(), a.data(), b.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], a[i] - b[i]);
+
+        core_vector_mul_i32(out.data(), a.data(), b.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(out[i], static_cast<int32_t>(static_cast<uint32_t>(a[i]) * static_cast<uint32_t>(b[i])));
+        }
+
+        core_vector_min_i32(out.data(), a.data(), b.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], std::min(a[i], b[i]));
+
+        core_vector_max_i32(out.data(), a.data(), b.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], std::max(a[i], b[i]));
+
+        core_vector_abs_i32(out.data(), a.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], std::abs(a[i]));
+
+        for (size_t i = n; i < out.size(); ++i) ASSERT_EQ(out[i], 7);
+    }
+}
+
+TEST_F(SIMDOpsTest, ReductionsMatchScalar) {
+    EXPECT_EQ(core_vector_sum_f32(nullptr, 0), 0.0f);
+    EXPECT_EQ(core_vector_reduce_min_f32(nullptr, 0), std::numeric_limits<float>::infinity());
+    EXPECT_EQ(core_vector_reduce_max_f32(nullptr, 0), -std::numeric_limits<float>::infinity());
+    EXPECT_EQ(core_vector_argmax_f32(nullptr, 0), 0u);
+
+    for (size_t n = 1; n <= kMaxLen; ++n) {
+        auto a = random_floats(n);
+        double ref_sum = 0.0;
+        for (float x : a) ref_sum += x;
+        ASSERT_NEAR(core_vector_sum_f32(a.data(), n), ref_sum, 1e-3 * n);
+        ASSERT_EQ(core_vector_reduce_min_f32(a.data(), n), *std::min_element(a.begin(), a.end()));
+        ASSERT_EQ(core_vector_reduce_max_f32(a.data(), n), *std::max_element(a.begin(), a.end()));
+        ASSERT_EQ(core_vector_argmax_f32(a.data(), n),
+                  static_cast<size_t>(std::max_element(a.begin(), a.end()) - a.begin()));
+
+        auto v = random_ints(n, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max());
+        int64_t ref = 0;
+        for (int32_t x : v) ref += x;
+        ASSERT_EQ(core_vector_sum_i32(v.data(), n), ref);
+        ASSERT_EQ(core_vector_reduce_min_i32(v.data(), n), *std::min_element(v.begin(), v.end()));
+        ASSERT_EQ(core_vector_reduce_max_i32(v.data(), n), *std::max_element(v.begin(), v.end()));
+    }
+}
+
+TEST_F(SIMDOpsTest, ArgmaxReturnsFirstOccurrenceAcrossBlocks) {
+    std::vector<float> a(5000, 1.0f);
+    a[777] = 9.0f;
+    a[4100] = 9.0f;
+    EXPECT_EQ(core_vector_argmax_f32(a.data(), a.size()), 777u);
+    a[4999] = 10.0f;
+    EXPECT_EQ(core_vector_argmax_f32(a.data(), a.size()), 4999u);
+}
+
+TEST_F(SIMDOpsTest, ComparisonsProduceBitmasks) {
+    const int ops[] = {CORE_CMP_EQ, CORE_CMP_NE, CORE_CMP_LT, CORE_CMP_LE, CORE_CMP_GT, CORE_CMP_GE};
+    auto pred = [](int op, float x, float y) {
+        switch (op) {
+            case CORE_CMP_EQ: return x == y;
+            case CORE_CMP_NE: return x != y;
+            case CORE_CMP_LT: return x < y;
+            case CORE_CMP_LE: return x <= y;
+            case CORE_CMP_GT: return x > y;
+            default: return x >= y;
+        }
+    };
+
+    for (size_t n = 0; n <= kMaxLen; ++n) {
+        auto a = random_floats(n, -4.0f, 4.0f), b = random_floats(n, -4.0f, 4.0f);
+        for (size_t i = 0; i < n; i += 3) a[i] = std::round(a[i]), b[i] = a[i];
+        std::vector<uint64_t> mask((n + 63) / 64 + 1, ~0ULL);
+
+        for (int op : ops) {
+            core_vector_cmp_f32(mask.data(), a.data(), b.data(), n, op);
+            size_t expected_count = 0;
+            for (size_t i = 0; i < n; ++i) {
+                bool bit = (mask[i / 64] >> (i % 64)) & 1;
+                ASSERT_EQ(bit, pred(op, a[i], b[i])) << "n=" << n << " i=" << i << " op=" << op;
+                expected_count += bit;
+            }
+            if (n % 64) {
+                ASSERT_EQ(mask[n / 64] >> (n % 64), 0u);
+            }
+            ASSERT_EQ(core_mask_popcount(mask.data(), n), expected_count);
+
+            core_vector_cmp_scalar_f32(mask.data(), a.data(), 0.5f, n, op);
+            for (size_t i = 0; i < n; ++i) {
+                ASSERT_EQ(static_cast<bool>((mask[i / 64] >> (i % 64)) & 1), pred(op, a[i], 0.5f));
+            }
+        }
+    }
+}
+
+TEST_F(SIMDOpsTest, GatherScatterMatchScalar) {
+    auto base = random_floats(1000);
+    for (size_t n = 0; n <= kMaxLen; ++n) {
+        auto idx = random_ints(n, 0, 999);
+        auto out = guarded(n);
+        core_vector_gather_f32(out.data(), base.data(), idx.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], base[idx[i]]);
+        expect_guard_intact(out, n);
+
+        auto src = random_floats(n);
+        std::vector<float> ref(base), got(base);
+        for (size_t i = 0; i < n; ++i) ref[idx[i]] = src[i];
+        core_vector_scatter_f32(got.data(), idx.data(), src.data(), n);
+        ASSERT_EQ(got, ref);
+    }
+}
+
+TEST_F(SIMDOpsTest, PrefixSumsMatchScalar) {
+    for (size_t n = 0; n <= kMaxLen; ++n) {
+        auto a = random_floats(n, 0.0f, 1.0f);
+        auto out = guarded(n);
+        core_vector_prefix_sum_f32(out.data(), a.data(), n);
+        double acc = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            acc += a[i];
+            ASSERT_NEAR(out[i], acc, 1e-4 * (i + 1));
+        }
+        expect_guard_intact(out, n);
+
+        auto v = random_ints(n);
+        std::vector<int32_t> got(n);
+        core_vector_prefix_sum_i32(got.data(), v.data(), n);
+        int32_t iacc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            iacc += v[i];
+            ASSERT_EQ(got[i], iacc);
+        }
+    }
+}
@@ -0,0 +1,321 @@
+#include <gtest/gtest.h>
+#include "core/drivers/task_queue_ops.h"
+#include "core/drivers/topology_ops.h"
+#include "core/error_handling/core_errors.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Задача-метка: arg кодирует номер, run отмечает выполнение
+std::vector<std::atomic<int>>* g_hits = nullptr;
+
+void hit(void* arg) {
+    (*g_hits)[reinterpret_cast<uintptr_t>(arg)].fetch_add(1, std::memory_order_relaxed);
+}
+
+core_task_t tagged(uintptr_t id) {
+    return core_task_t{hit, reinterpret_cast<void*>(id)};
+}
+
+struct Queue {
+    core_task_queue_t* q = nullptr;
+    explicit Queue(size_t capacity) {
+        EXPECT_EQ(core_task_queue_create(capacity, CORE_PLACE_ANY_NODE, &q), CORE_SUCCESS);
+    }
+    ~Queue() { core_task_queue_destroy(q); }
+};
+
+}  // namespace
+
+TEST(TaskQueueOpsTest, FifoBatchesAndCapacity) {
+    Queue queue(5);  // округляется до 8
+    for (uintptr_t i = 0; i < 8; ++i) ASSERT_EQ(core_task_queue_push(queue.q, tagged(i)), CORE_SUCCESS);
+    EXPECT_EQ(core_task_queue_push(queue.q, tagged(8)), CORE_ERR_NOMEM);
+    EXPECT_EQ(core_task_queue_size(queue.q), 8u);
+
+    core_task_t out[8];
+    ASSERT_EQ(core_task_queue_pop_batch(queue.q, out, 3), 3u);
+    for (uintptr_t i = 0; i < 3; ++i) EXPECT_EQ(reinterpret_cast<uintptr_t>(out[i].arg), i);
+
+    // Кража берёт половину оставшегося с головы
+    ASSERT_EQ(core_task_queue_steal(queue.q, out, 8), 3u);
+    for (uintptr_t i = 0; i < 3; ++i) EXPECT_EQ(reinterpret_cast<uintptr_t>(out[i].arg), 3 + i);
+
+    // Освободившиеся ячейки снова доступны: кольцо прошло полный круг
+    for (uintptr_t i = 8; i < 14; ++i) ASSERT_EQ(core_task_queue_push(queue.q, tagged(i)), CORE_SUCCESS);
+    ASSERT_EQ(core_task_queue_pop_batch(queue.q, out, 8), 8u);
+    for (uintptr_t i = 0; i < 8; ++i) EXPECT_EQ(reinterpret_cast<uintptr_t>(out[i].arg), 6 + i);
+    EXPECT_EQ(core_task_queue_pop_batch(queue.q, out, 8), 0u);
+    EXPECT_EQ(core_task_queue_steal(queue.q, out, 8), 0u);
+    EXPECT_EQ(core_task_queue_size(queue.q), 0u);
+
+    core_task_queue_t* bad = nullptr;
+    EXPECT_EQ(core_task_queue_create(0, CORE_PLACE_ANY_NODE, &bad), CORE_ERR_INVALID);
+    EXPECT_EQ(core_task_queue_push(queue.q, core_task_t{nullptr, nullptr}), CORE_ERR_INVALID);
+}
+
+// Несколько производителей, владелец и воры: каждая задача выполняется ровно один раз
+TEST(TaskQueueOpsTest, ConcurrentProducersOwnerAndThieves) {
+    const size_t producers = 4, per_producer = 50000, thieves = 2;
+    const size_t total = producers * per_producer;
+    std::vector<std::atomic<int>> hits(total);
+    g_hits = &hits;
+    Queue queue(256);
+    std::atomic<size_t> done{0};
+    std::atomic<bool> producing{true};
+
+    auto consume = [&](bool steal) {
+        core_task_t batch[32];
+        while (done.load() < total) {
+            size_t n = steal ? core_task_queue_steal(queue.q, batch, 32) : core_task_queue_pop_batch(queue.q, batch, 32);
+            for (size_t i = 0; i < n; ++i) batch[i].run(batch[i].arg);
+            done.fetch_add(n);
+            if (n == 0) {
+                if (!steal && producing.load()) core_task_queue_park(queue.q, 1000000);
+                else std::this_thread::yield();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.emplace_back(consume, false);
+    for (size_t t = 0; t < thieves; ++t) threads.emplace_back(consume, true);
+    std::vector<std::thread> writers;
+    for (size_t p = 0; p < producers; ++p) {
+        writers.emplace_back([&, p] {
+            for (size_t i = 0; i < per_producer; ++i) {
+                // Переполнение не блокирует производителя — он повторяет позже
+                while (core_task_queue_push(queue.q, tagged(p * per_producer + i)) != CORE_SUCCESS) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& w : writers) w.join();
+    producing = false;
+    core_task_queue_wake(queue.q);
+    for (auto& t : threads) t.join();
+
+    for (size_t i = 0; i < total; ++i) ASSERT_EQ(hits[i].load(), 1) << "task " << i;
+    g_hits = nullptr;
+}
+
+TEST(TaskQueueOpsTest, ParkWakesOnPushAndTimesOut) {
+    std::vector<std::atomic<int>> hits(1);
+    g_hits = &hits;
+    Queue queue(16);
+
+    // Непустая очередь не даёт уснуть
+    ASSERT_EQ(core_task_queue_push(queue.q, tagged(0)), CORE_SUCCESS);
+    auto start = std::chrono::steady_clock::now();
+    core_task_queue_park(queue.q, 5000000000ull);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    core_task_t out[1];
+    ASSERT_EQ(core_task_queue_pop_batch(queue.q, out, 1), 1u);
+
+    // Таймаут
+    start = std::chrono::steady_clock::now();
+    core_task_queue_park(queue.q, 20000000ull);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(15));
+
+    // Постановка будит спящего владельца задолго до таймаута
+    std::atomic<bool> woke{false};
+    std::thread owner([&] {
+        while (core_task_queue_size(queue.q) == 0) core_task_queue_park(queue.q, 10000000000ull);
+        woke = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    start = std::chrono::steady_clock::now();
+    ASSERT_EQ(core_task_queue_push(queue.q, tagged(0)), CORE_SUCCESS);
+    owner.join();
+    EXPECT_TRUE(woke.load());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    g_hits = nullptr;
+}
+
+namespace {
+
+struct Sched {
+    core_task_sched_t* s = nullptr;
+    explicit Sched(const core_sched_config_t* config, size_t capacity = 1024) {
+        EXPECT_EQ(core_task_sched_create(config, capacity, CORE_PLACE_ANY_NODE, &s), CORE_SUCCESS);
+    }
+    ~Sched() { core_task_sched_destroy(s); }
+
+    // Номера задач одного вызова next
+    std::vector<uintptr_t> next(size_t max = 64) {
+        core_task_t tasks[64];
+        size_t n = core_task_sched_next(s, tasks, max);
+        std::vector<uintptr_t> ids;
+        for (size_t i = 0; i < n; ++i) ids.push_back(reinterpret_cast<uintptr_t>(tasks[i].arg));
+        return ids;
+    }
+};
+
+void noop(void*) {}
+
+core_task_t id_task(uintptr_t id) {
+    return core_task_t{noop, reinterpret_cast<void*>(id)};
+}
+
+}  // namespace
+
+TEST(TaskSchedTest, StrictPriorityThenEarliestDeadline) {
+    Sched sched(nullptr);
+    const uint64_t base = core_task_now_ns() + 1000000000ull;
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_BATCH, id_task(100), 0), CORE_SUCCESS);
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_NORMAL, id_task(200), 0), CORE_SUCCESS);
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_LATENCY, id_task(1), 0), CORE_SUCCESS);
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_LATENCY, id_task(30), base + 30), CORE_SUCCESS);
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_LATENCY, id_task(10), base + 10), CORE_SUCCESS);
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_LATENCY, id_task(20), base + 20), CORE_SUCCESS);
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_LATENCY, id_task(2), 0), CORE_SUCCESS);
+    EXPECT_EQ(core_task_sched_size(sched.s), 7u);
+
+    // Срочные по сроку, затем без срока в порядке постановки; классы не смешиваются
+    EXPECT_EQ(sched.next(), (std::vector<uintptr_t>{10, 20, 30, 1, 2}));
+    EXPECT_EQ(sched.next(), (std::vector<uintptr_t>{200}));
+    EXPECT_EQ(sched.next(), (std::vector<uintptr_t>{100}));
+    EXPECT_TRUE(sched.next().empty());
+
+    EXPECT_EQ(core_task_sched_push(sched.s, 3, id_task(0), 0), CORE_ERR_INVALID);
+    EXPECT_EQ(core_task_sched_push(sched.s, CORE_SCHED_NORMAL, core_task_t{nullptr, nullptr}, 0), CORE_ERR_INVALID);
+}
+
+TEST(TaskSchedTest, NormalAndBatchShareByWeight) {
+    core_sched_config_t config;
+    core_sched_default_config(&config);
+    config.weights[CORE_SCHED_NORMAL] = 3;
+    config.weights[CORE_SCHED_BATCH] = 1;
+    Sched sched(&config);
+    for (uintptr_t i = 0; i < 400; ++i) {
+        ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_NORMAL, id_task(i), 0), CORE_SUCCESS);
+        ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_BATCH, id_task(1000 + i), 0), CORE_SUCCESS);
+    }
+    size_t normal = 0, batch = 0;
+    while (normal + batch < 320) {
+        for (uintptr_t id : sched.next()) (id < 1000 ? normal : batch)++;
+    }
+    EXPECT_EQ(normal, 240u);
+    EXPECT_EQ(batch, 80u);
+
+    // Когда normal кончается, batch забирает всё
+    size_t rest = 0;
+    for (auto ids = sched.next(); !ids.empty(); ids = sched.next()) rest += ids.size();
+    EXPECT_EQ(rest, 480u);
+}
+
+TEST(TaskSchedTest, StarvedClassOvertakesLatency) {
+    core_sched_config_t config;
+    core_sched_default_config(&config);
+    config.max_wait_ns[CORE_SCHED_NORMAL] = 2000000;  // 2 мс
+    config.max_wait_ns[CORE_SCHED_BATCH] = 0;         // без защиты
+    auto start = std::chrono::steady_clock::now();
+    Sched sched(&config);
+
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_NORMAL, id_task(500), 0), CORE_SUCCESS);
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_BATCH, id_task(900), 0), CORE_SUCCESS);
+    bool normal_served = false;
+    // Поток срочных задач не кончается, но normal всё равно получает ход
+    for (uintptr_t i = 0; !normal_served && std::chrono::steady_clock::now() - start < std::chrono::seconds(2); ++i) {
+        ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_LATENCY, id_task(10000 + i), 0), CORE_SUCCESS);
+        for (uintptr_t id : sched.next(1)) {
+            EXPECT_NE(id, 900u) << "batch has no starvation protection here";
+            normal_served |= id == 500;
+        }
+    }
+    EXPECT_TRUE(normal_served);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(2));
+
+    core_sched_stats_t stats;
+    core_task_sched_stats(sched.s, &stats, 0);
+    EXPECT_EQ(stats.starvation_boosts, 1u);
+    EXPECT_EQ(stats.dispatched[CORE_SCHED_NORMAL], 1u);
+    EXPECT_EQ(stats.dispatched[CORE_SCHED_BATCH], 0u);
+}
+
+TEST(TaskSchedTest, DelayHistogramsAndDeadlineMisses) {
+    Sched sched(nullptr);
+    const uint64_t now = core_task_now_ns();
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_LATENCY, id_task(1), now - 1), CORE_SUCCESS);  // уже просрочена
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_LATENCY, id_task(2), now + 60000000000ull), CORE_SUCCESS);
+    for (uintptr_t i = 0; i < 5; ++i) {
+        ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_BATCH, id_task(10 + i), 0), CORE_SUCCESS);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    while (!sched.next().empty()) {
+    }
+
+    core_sched_stats_t stats;
+    core_task_sched_stats(sched.s, &stats, 0);
+    EXPECT_EQ(stats.deadline_misses, 1u);
+    const uint64_t expected[CORE_SCHED_CLASSES] = {2, 0, 5};
+    for (int c = 0; c < CORE_SCHED_CLASSES; ++c) {
+        uint64_t in_hist = 0;
+        for (int b = 0; b < CORE_SCHED_HIST_BUCKETS; ++b) in_hist += stats.delay_hist[c][b];
+        EXPECT_EQ(stats.dispatched[c], expected[c]);
+        EXPECT_EQ(in_hist, expected[c]);
+    }
+    // 5 мс ожидания попадают в корзину [2^22, 2^23) нс или выше
+    EXPECT_GE(stats.delay_max_ns[CORE_SCHED_BATCH], 5000000u);
+    uint64_t slow = 0;
+    for (int b = 23; b < CORE_SCHED_HIST_BUCKETS; ++b) slow += stats.delay_hist[CORE_SCHED_BATCH][b];
+    EXPECT_EQ(slow, 5u);
+    EXPECT_GE(stats.delay_sum_ns[CORE_SCHED_BATCH], 5u * 5000000u);
+
+    // Накопление по нескольким планировщикам
+    core_task_sched_stats(sched.s, &stats, 1);
+    EXPECT_EQ(stats.dispatched[CORE_SCHED_BATCH], 10u);
+}
+
+TEST(TaskSchedTest, StealAndParkAcrossClasses) {
+    Sched sched(nullptr);
+    for (uintptr_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_BATCH, id_task(100 + i), 0), CORE_SUCCESS);
+        ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_LATENCY, id_task(i), 0), CORE_SUCCESS);
+    }
+    // Вор берёт сначала срочные, половину кольца
+    core_task_t out[8];
+    ASSERT_EQ(core_task_sched_steal(sched.s, out, 8), 2u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(out[0].arg), 0u);
+    EXPECT_EQ(core_task_sched_size(sched.s), 6u);
+
+    // Перенос сохраняет класс и сроки и не считается выдачей
+    const uint64_t deadline = core_task_now_ns() + 1000000000ull;
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_LATENCY, id_task(50), deadline), CORE_SUCCESS);
+    uint64_t deadlines[8];
+    int sched_class = -1;
+    ASSERT_EQ(core_task_sched_steal_class(sched.s, out, deadlines, 8, &sched_class), 2u);
+    EXPECT_EQ(sched_class, CORE_SCHED_LATENCY);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(out[0].arg), 2u);
+    EXPECT_EQ(deadlines[0], 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(out[1].arg), 3u);
+    ASSERT_EQ(core_task_sched_steal_class(sched.s, out, deadlines, 8, &sched_class), 1u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(out[0].arg), 50u);
+    EXPECT_EQ(deadlines[0], deadline);
+    ASSERT_EQ(core_task_sched_steal_class(sched.s, out, nullptr, 8, &sched_class), 2u);
+    EXPECT_EQ(sched_class, CORE_SCHED_BATCH);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(out[0].arg), 100u);
+    core_sched_stats_t stats;
+    core_task_sched_stats(sched.s, &stats, 0);
+    EXPECT_EQ(stats.dispatched[CORE_SCHED_LATENCY], 2u);
+    EXPECT_EQ(stats.dispatched[CORE_SCHED_BATCH], 0u);
+    EXPECT_EQ(core_task_sched_size(sched.s), 2u);
+
+    // Пустой планировщик спит до постановки в любой класс
+    while (!sched.next().empty()) {
+    }
+    EXPECT_EQ(core_task_sched_size(sched.s), 0u);
+    std::thread owner([&] {
+        while (core_task_sched_size(sched.s) == 0) core_task_sched_park(sched.s, 10000000000ull);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(core_task_sched_push(sched.s, CORE_SCHED_BATCH, id_task(7), 0), CORE_SUCCESS);
+    owner.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
@@ -0,0 +1,286 @@
+#include <gtest/gtest.h>
+#include "core/drivers/topology_ops.h"
+#include "core/threading/affinity.h"
+#include "core/error_handling/core_errors.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Поддельное дерево sysfs во временном каталоге: тесты не зависят от машины
+class FakeSysfs {
+public:
+    FakeSysfs() {
+        std::string pattern = (fs::temp_directory_path() / "topology_XXXXXX").string();
+        root_ = mkdtemp(pattern.data()) ? pattern : std::string();
+    }
+    ~FakeSysfs() {
+        std::error_code ec;
+        if (!root_.empty()) fs::remove_all(root_, ec);
+    }
+
+    const char* root() const { return root_.c_str(); }
+
+    void write(const std::string& relative, const std::string& content) {
+        fs::path path = fs::path(root_) / relative;
+        fs::create_directories(path.parent_path());
+        std::ofstream(path) << content << "\n";
+    }
+
+    // cpu -> (package, core_id); узлы задаются отдельно
+    void cpu(int cpu, int package, int core_id) {
+        std::string dir = "devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        write(dir + "physical_package_id", std::to_string(package));
+        write(dir + "core_id", std::to_string(core_id));
+    }
+
+    // Два узла по четыре ядра с двумя SMT-потоками, нумерация как у Linux:
+    // CPU 0-7 — первые потоки ядер, 8-15 — их соседи
+    void two_nodes_smt() {
+        write("devices/system/cpu/online", "0-15");
+        for (int core = 0; core < 8; ++core) {
+            cpu(core, core / 4, core % 4);
+            cpu(core + 8, core / 4, core % 4);
+        }
+        write("devices/system/node/node0/cpulist", "0-3,8-11");
+        write("devices/system/node/node1/cpulist", "4-7,12-15");
+        write("devices/system/node/possible", "0-1");
+    }
+
+private:
+    std::string root_;
+};
+
+struct Topology {
+    core_topology_t t{};
+    ~Topology() { core_topology_free(&t); }
+};
+
+const core_cpu_desc_t* find_cpu(const core_topology_t& t, int cpu) {
+    for (size_t i = 0; i < t.num_cpus; ++i) {
+        if (t.cpus[i].cpu == cpu) return &t.cpus[i];
+    }
+    return nullptr;
+}
+
+std::vector<core_placement_t> place(const core_topology_t& t, const std::vector<core_place_request_t>& requests) {
+    std::vector<core_placement_t> placements(requests.size());
+    EXPECT_EQ(core_topology_place(&t, requests.data(), requests.size(), placements.data()), CORE_SUCCESS);
+    return placements;
+}
+
+}  // namespace
+
+TEST(TopologyOpsTest, DetectsCoresSiblingsAndNodes) {
+    FakeSysfs sysfs;
+    sysfs.two_nodes_smt();
+    Topology topo;
+    ASSERT_EQ(core_topology_detect(sysfs.root(), &topo.t), CORE_SUCCESS);
+
+    EXPECT_EQ(topo.t.num_cpus, 16u);
+    EXPECT_EQ(topo.t.num_cores, 8u);
+    EXPECT_EQ(topo.t.num_packages, 2u);
+    EXPECT_EQ(topo.t.num_nodes, 2u);
+    EXPECT_EQ(topo.t.threads_per_core, 2u);
+    for (int cpu = 0; cpu < 8; ++cpu) {
+        const core_cpu_desc_t* first = find_cpu(topo.t, cpu);
+        const core_cpu_desc_t* sibling = find_cpu(topo.t, cpu + 8);
+        ASSERT_TRUE(first && sibling);
+        EXPECT_EQ(first->core, sibling->core) << "cpu " << cpu;
+        EXPECT_EQ(first->smt_index, 0);
+        EXPECT_EQ(sibling->smt_index, 1);
+        EXPECT_EQ(first->node, cpu < 4 ? 0 : 1);
+        EXPECT_EQ(sibling->node, first->node);
+        EXPECT_TRUE(first->allowed);
+    }
+    // Одинаковый core_id в разных пакетах — разные физические ядра
+    EXPECT_NE(find_cpu(topo.t, 0)->core, find_cpu(topo.t, 4)->core);
+}
+
+TEST(TopologyOpsTest, DegradesWithoutTopologyOrNodes) {
+    FakeSysfs sysfs;
+    sysfs.write("devices/system/cpu/online", "0-2,5,7-8");
+    Topology topo;
+    ASSERT_EQ(core_topology_detect(sysfs.root(), &topo.t), CORE_SUCCESS);
+    ASSERT_EQ(topo.t.num_cpus, 6u);
+    EXPECT_EQ(topo.t.num_cores, 6u);
+    EXPECT_EQ(topo.t.num_nodes, 1u);
+    EXPECT_EQ(topo.t.threads_per_core, 1u);
+    const int expected[] = {0, 1, 2, 5, 7, 8};
+    for (size_t i = 0; i < topo.t.num_cpus; ++i) {
+        EXPECT_EQ(topo.t.cpus[i].cpu, expected[i]);
+        EXPECT_EQ(topo.t.cpus[i].node, 0);
+    }
+
+    // Без файла online CPU берутся из каталогов cpuN
+    FakeSysfs dirs;
+    dirs.cpu(0, 0, 0);
+    dirs.cpu(1, 0, 0);
+    dirs.cpu(3, 0, 1);
+    Topology from_dirs;
+    ASSERT_EQ(core_topology_detect(dirs.root(), &from_dirs.t), CORE_SUCCESS);
+    EXPECT_EQ(from_dirs.t.num_cpus, 3u);
+    EXPECT_EQ(from_dirs.t.num_cores, 2u);
+
+    FakeSysfs empty;
+    Topology none;
+    EXPECT_EQ(core_topology_detect(empty.root(), &none.t), CORE_ERR_NOTFOUND);
+    EXPECT_EQ(core_topology_detect(nullptr, nullptr), CORE_ERR_INVALID);
+}
+
+TEST(TopologyOpsTest, LatencyCriticalGetWholeCoresOnTheirNode) {
+    FakeSysfs sysfs;
+    sysfs.two_nodes_smt();
+    Topology topo;
+    ASSERT_EQ(core_topology_detect(sysfs.root(), &topo.t), CORE_SUCCESS);
+
+    // Обычные потоки с SMT идут первыми в списке, но latency-critical
+    // размещаются раньше и получают свои ядра целиком
+    std::vector<core_place_request_t> requests;
+    for (int i = 0; i < 6; ++i) requests.push_back({0, 0, 1});
+    for (int i = 0; i < 3; ++i) requests.push_back({0, 1, 0});
+    auto placements = place(topo.t, requests);
+
+    std::set<int> critical_cores;
+    for (size_t i = 6; i < 9; ++i) {
+        EXPECT_EQ(placements[i].node, 0);
+        EXPECT_TRUE(placements[i].exclusive) << "worker " << i;
+        EXPECT_FALSE(placements[i].fallback);
+        critical_cores.insert(placements[i].core);
+    }
+    EXPECT_EQ(critical_cores.size(), 3u);
+
+    // На узле 0 остаётся одно ядро (2 SMT-потока): первые два обычных потока
+    // занимают его, остальные уходят на свободные ядра узла 1
+    std::set<int> cpus;
+    for (size_t i = 0; i < 6; ++i) {
+        EXPECT_EQ(critical_cores.count(placements[i].core), 0u) << "worker " << i << " shares a critical core";
+        EXPECT_TRUE(cpus.insert(placements[i].cpu).second) << "cpu reused";
+    }
+    EXPECT_EQ(placements[0].node, 0);
+    EXPECT_EQ(placements[1].node, 0);
+    EXPECT_EQ(placements[0].core, placements[1].core);
+    EXPECT_FALSE(placements[0].exclusive);
+    for (size_t i = 2; i < 6; ++i) {
+        EXPECT_EQ(placements[i].node, 1);
+        EXPECT_TRUE(placements[i].fallback);
+        EXPECT_TRUE(placements[i].exclusive);
+    }
+}
+
+TEST(TopologyOpsTest, SpreadsAcrossNodesAndPhysicalCoresFirst) {
+    FakeSysfs sysfs;
+    sysfs.two_nodes_smt();
+    Topology topo;
+    ASSERT_EQ(core_topology_detect(sysfs.root(), &topo.t), CORE_SUCCESS);
+
+    // Восемь потоков без узла: по одному на физическое ядро, поровну по узлам
+    std::vector<core_place_request_t> requests(8, core_place_request_t{CORE_PLACE_ANY_NODE, 0, 1});
+    auto placements = place(topo.t, requests);
+    std::set<int> cores;
+    int per_node[2] = {0, 0};
+    for (const auto& p : placements) {
+        EXPECT_TRUE(cores.insert(p.core).second);
+        EXPECT_LT(p.cpu, 8) << "SMT sibling used while physical cores were free";
+        EXPECT_TRUE(p.exclusive);
+        EXPECT_FALSE(p.fallback);
+        per_node[p.node]++;
+    }
+    EXPECT_EQ(per_node[0], 4);
+    EXPECT_EQ(per_node[1], 4);
+    EXPECT_EQ(placements[0].node, 0);
+    EXPECT_EQ(placements[1].node, 1);
+
+    // Без allow_smt лишние потоки переподписывают ядра, а не занимают соседей
+    std::vector<core_place_request_t> no_smt(10, core_place_request_t{CORE_PLACE_ANY_NODE, 0, 0});
+    auto over = place(topo.t, no_smt);
+    for (size_t i = 0; i < 8; ++i) EXPECT_FALSE(over[i].fallback);
+    for (size_t i = 8; i < 10; ++i) {
+        EXPECT_TRUE(over[i].fallback);
+        EXPECT_LT(over[i].cpu, 8);
+        EXPECT_FALSE(over[i].exclusive);
+    }
+}
+
+TEST(TopologyOpsTest, OversubscriptionAvoidsCriticalCores) {
+    FakeSysfs sysfs;
+    sysfs.write("devices/system/cpu/online", "0-1");
+    sysfs.cpu(0, 0, 0);
+    sysfs.cpu(1, 0, 1);
+    Topology topo;
+    ASSERT_EQ(core_topology_detect(sysfs.root(), &topo.t), CORE_SUCCESS);
+
+    std::vector<core_place_request_t> requests = {{0, 0, 1}, {0, 0, 1}, {0, 1, 0}, {5, 0, 0}};
+    auto placements = place(topo.t, requests);
+    const int critical_cpu = placements[2].cpu;
+    EXPECT_FALSE(placements[2].fallback);
+    EXPECT_TRUE(placements[2].exclusive);
+    for (size_t i : {0, 1, 3}) {
+        EXPECT_NE(placements[i].cpu, critical_cpu) << "worker " << i;
+    }
+    EXPECT_TRUE(placements[1].fallback);
+    EXPECT_TRUE(placements[3].fallback);  // узла 5 нет
+
+    std::vector<core_placement_t> out(1);
+    EXPECT_EQ(core_topology_place(&topo.t, nullptr, 1, out.data()), CORE_ERR_INVALID);
+    EXPECT_EQ(core_topology_place(&topo.t, nullptr, 0, nullptr), CORE_SUCCESS);
+}
+
+TEST(TopologyOpsTest, FormatsPlacementReport) {
+    core_placement_t placements[2] = {{2, 1, 0, 1, 0}, {9, 1, 1, 0, 1}};
+    const char* expected =
+        "worker 0: cpu 2 core 1 node 0 exclusive\n"
+        "worker 1: cpu 9 core 1 node 1 shared fallback\n";
+    size_t length = core_topology_format_placement(placements, 2, nullptr, 0);
+    ASSERT_EQ(length, std::strlen(expected));
+    std::string report(length, '\0');
+    core_topology_format_placement(placements, 2, report.data(), report.size() + 1);
+    EXPECT_EQ(report, expected);
+
+    char small[16];
+    EXPECT_EQ(core_topology_format_placement(placements, 2, small, sizeof(small)), length);
+    EXPECT_EQ(std::strlen(small), sizeof(small) - 1);
+}
+
+// Настоящая машина: любой Linux с хотя бы одним разрешённым CPU
+TEST(TopologyOpsTest, BindsOnThisMachine) {
+    const core_topology_t* topology = core_topology_system();
+    if (!topology) GTEST_SKIP() << "sysfs unavailable";
+    ASSERT_GT(topology->num_cpus, 0u);
+    EXPECT_LE(topology->num_cores, topology->num_cpus);
+    EXPECT_EQ(core_num_numa_nodes(), topology->num_nodes);
+
+    core_place_request_t request{CORE_PLACE_ANY_NODE, 1, 0};
+    core_placement_t placement;
+    ASSERT_EQ(core_topology_place(topology, &request, 1, &placement), CORE_SUCCESS);
+    EXPECT_EQ(core_numa_node_of_cpu(placement.cpu), placement.node);
+
+    int bind_status = -1;
+    size_t bound_cpu = 0;
+    bool memory_ok = false;
+    std::thread worker([&] {
+        bind_status = core_topology_bind_current(topology, placement.cpu);
+        core_get_thread_affinity(&bound_cpu);
+        const size_t size = 3 * 4096 + 17;
+        auto* memory = static_cast<unsigned char*>(core_topology_alloc_on_node(size, placement.node));
+        if (memory) {
+            std::memset(memory, 0xA5, size);
+            memory_ok = memory[size - 1] == 0xA5;
+            core_topology_free_on_node(memory, size);
+        }
+    });
+    worker.join();
+    ASSERT_EQ(bind_status, CORE_SUCCESS);
+    EXPECT_EQ(bound_cpu, static_cast<size_t>(placement.cpu));
+    EXPECT_TRUE(memory_ok);
+    EXPECT_EQ(core_topology_bind_current(topology, -1), CORE_ERR_INVALID);
+}
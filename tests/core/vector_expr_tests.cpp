@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "compute/compute_manager.h"
+#include "compute/vector_expr.h"
+
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace compute::expr;
+
+class VectorExprTest : public ::testing::Test {
+protected:
+    template<typename T>
+    std::vector<T> random(size_t n) {
+        std::uniform_real_distribution<double> dis(-2.0, 2.0);
+        std::vector<T> v(n);
+        for (auto& x : v) x = static_cast<T>(dis(gen));
+        return v;
+    }
+
+    std::mt19937 gen{7};
+};
+
+TEST_F(VectorExprTest, ElementwiseMatchesScalarLoop) {
+    for (size_t n : {0u, 1u, 3u, 15u, 16u, 17u, 33u, 1000u}) {
+        auto a = random<float>(n), b = random<float>(n), c = random<float>(n);
+        std::vector<float> out(n + 4, -7.0f);
+        evaluate(out.data(), max(vec(a) - vec(b) * 2.0f, 0.5f) / (abs(vec(c)) + 1.0f));
+        for (size_t i = 0; i < n; ++i) {
+            float ref = std::max(a[i] - b[i] * 2.0f, 0.5f) / (std::fabs(c[i]) + 1.0f);
+            ASSERT_FLOAT_EQ(out[i], ref) << "n=" << n << " i=" << i;
+        }
+        for (size_t i = n; i < out.size(); ++i) ASSERT_EQ(out[i], -7.0f) << "wrote past n=" << n;
+    }
+}
+
+TEST_F(VectorExprTest, FusedMultiplyAddIsPositionIndependent) {
+    // Результат a * b + c не должен зависеть от того, попал элемент в пакет или в хвост
+    auto a = random<float>(37), b = random<float>(37), c = random<float>(37);
+    std::vector<float> full(37);
+    evaluate(full.data(), vec(a) * vec(b) + vec(c));
+    for (size_t offset = 1; offset < 20; ++offset) {
+        std::vector<float> shifted(37 - offset);
+        auto e = vec(a.data() + offset, 37 - offset) * vec(b.data() + offset, 37 - offset) +
+                 vec(c.data() + offset, 37 - offset);
+        evaluate(shifted.data(), e);
+        for (size_t i = 0; i < shifted.size(); ++i) ASSERT_EQ(shifted[i], full[i + offset]);
+    }
+    for (size_t i = 0; i < 37; ++i) EXPECT_NEAR(full[i], a[i] * b[i] + c[i], 1e-6f);
+}
+
+TEST_F(VectorExprTest, ReductionsMatchReference) {
+    for (size_t n : {1u, 7u, 31u, 32u, 100003u}) {
+        auto a = random<double>(n), b = random<double>(n), c = random<double>(n);
+        double ref = 0.0, refDot = 0.0, lo = INFINITY, hi = -INFINITY;
+        for (size_t i = 0; i < n; ++i) {
+            ref += a[i] * b[i] + c[i];
+            refDot += a[i] * b[i];
+            lo = std::min(lo, a[i] - c[i]);
+            hi = std::max(hi, a[i] - c[i]);
+        }
+        EXPECT_NEAR(sum(vec(a) * vec(b) + vec(c)), ref, 1e-9 * static_cast<double>(n));
+        EXPECT_NEAR(dot(vec(a), vec(b)), refDot, 1e-9 * static_cast<double>(n));
+        EXPECT_EQ(reduceMin(vec(a) - vec(c)), lo);
+        EXPECT_EQ(reduceMax(vec(a) - vec(c)), hi);
+    }
+    std::vector<float> empty;
+    EXPECT_EQ(sum(vec(empty) * 2.0f), 0.0f);
+    EXPECT_EQ(reduceMin(vec(empty)), INFINITY);
+}
+
+TEST_F(VectorExprTest, IntegerExpressions) {
+    std::vector<int32_t> a(101), b(101);
+    std::iota(a.begin(), a.end(), -50);
+    std::iota(b.begin(), b.end(), 3);
+    std::vector<int32_t> out(101);
+    evaluate(out.data(), -(vec(a) * vec(b)) + 4);
+    for (size_t i = 0; i < a.size(); ++i) ASSERT_EQ(out[i], -(a[i] * b[i]) + 4);
+    EXPECT_EQ(sum(abs(vec(a))), 2550);
+}
+
+TEST_F(VectorExprTest, InPlaceAndSizeMismatch) {
+    auto a = random<float>(50), b = random<float>(50);
+    auto expected = a;
+    for (size_t i = 0; i < a.size(); ++i) expected[i] = (a[i] + b[i]) * a[i];
+    evaluate(a.data(), (vec(a) + vec(b)) * vec(a));
+    for (size_t i = 0; i < a.size(); ++i) ASSERT_FLOAT_EQ(a[i], expected[i]);
+
+    std::vector<float> shorter(49);
+    EXPECT_THROW(vec(a) + vec(shorter), std::invalid_argument);
+    EXPECT_THROW(sum(vec(a) * 2.0f + vec(shorter)), std::invalid_argument);
+}
+
+TEST_F(VectorExprTest, ComputeManagerParallelEvaluation) {
+    auto& manager = compute::ComputeManager::getInstance();
+    const size_t savedThreads = manager.getThreadCount();
+    manager.setThreadCount(4);
+
+    const size_t n = 250001;
+    auto a = random<float>(n), b = random<float>(n), c = random<float>(n);
+    std::vector<float> serial(n), parallel(n);
+    auto e = vec(a) * vec(b) + vec(c);
+    evaluate(serial.data(), e);
+    manager.evaluate(parallel.data(), e);
+    EXPECT_EQ(serial, parallel);
+
+    double ref = 0.0;
+    for (size_t i = 0; i < n; ++i) ref += static_cast<double>(serial[i]);
+    EXPECT_NEAR(manager.sum(e), ref, 1e-3 * std::sqrt(static_cast<double>(n)));
+    EXPECT_EQ(manager.sum(vec(a.data(), 0) + 1.0f), 0.0f);
+
+    manager.setThreadCount(savedThreads);
+}
@@ -0,0 +1,366 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "compute/compute_manager.h"
+#include "core/drivers/conv_ops.h"
+#include "core/drivers/gemm_ops.h"
+#include "core/drivers/fft_ops.h"
+#include "core/drivers/filter_ops.h"
+#include "core/drivers/math_ops.h"
+#include "core/drivers/quant_ops.h"
+#include "core/optimization/simd_ops.h"
+
+// Бенчмарки вычислительных ядер: сравнение с прежними реализациями.
+// Результаты выводятся в stdout; проверки только на корректность.
+
+class ComputeBenchmark : public ::testing::Test {
+protected:
+    template<typename F>
+    static double best_seconds(int repeats, F&& f) {
+        double best = 1e30;
+        for (int r = 0; r < repeats; ++r) {
+            auto start = std::chrono::high_resolution_clock::now();
+            f();
+            auto end = std::chrono::high_resolution_clock::now();
+            best = std::min(best, std::chrono::duration<double>(end - start).count());
+        }
+        return best;
+    }
+
+    static std::vector<float> random_vector(size_t n) {
+        std::mt19937 gen(123);
+        std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+        std::vector<float> v(n);
+        for (auto& x : v) x = dis(gen);
+        return v;
+    }
+};
+
+namespace {
+
+// Прежняя реализация core_compute_matrix_mul / ComputeManager::matrixMultiply
+void naive_matrix_mul(const float* a, const float* b, float* c, size_t m, size_t k, size_t n) {
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            float sum = 0.0f;
+            for (size_t p = 0; p < k; ++p) sum += a[i * k + p] * b[p * n + j];
+            c[i * n + j] = sum;
+        }
+    }
+}
+
+void thread_parallel_for(void* ctx, size_t num_tasks, void (*task)(void*, size_t), void* arg) {
+    size_t threads = *static_cast<size_t*>(ctx);
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (size_t i = next++; i < num_tasks; i = next++) task(arg, i);
+        });
+    }
+    for (auto& w : workers) w.join();
+}
+
+} // namespace
+
+TEST_F(ComputeBenchmark, GemmGflops) {
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    core_gemm_executor_t executor{thread_parallel_for, &threads, threads};
+
+    for (size_t n : {128, 256, 512, 1024}) {
+        auto a = random_vector(n * n), b = random_vector(n * n);
+        std::vector<float> c_naive(n * n), c_serial(n * n), c_parallel(n * n);
+        const double flops = 2.0 * n * n * n;
+
+        double t_naive = best_seconds(n <= 512 ? 3 : 1, [&] {
+            naive_matrix_mul(a.data(), b.data(), c_naive.data(), n, n, n);
+        });
+        double t_serial = best_seconds(3, [&] {
+            core_gemm_f32(CORE_GEMM_NO_TRANS, CORE_GEMM_NO_TRANS, n, n, n, 1.0f, a.data(), n,
+                          b.data(), n, 0.0f, c_serial.data(), n, nullptr);
+        });
+        double t_parallel = best_seconds(3, [&] {
+            core_gemm_f32(CORE_GEMM_NO_TRANS, CORE_GEMM_NO_TRANS, n, n, n, 1.0f, a.data(), n,
+                          b.data(), n, 0.0f, c_parallel.data(), n, &executor);
+        });
+
+        std::cout << "GEMM " << n << "x" << n << ": naive " << flops / t_naive * 1e-9
+                  << " GFLOPS, blocked " << flops / t_serial * 1e-9
+                  << " GFLOPS, blocked x" << threads << " " << flops / t_parallel * 1e-9
+                  << " GFLOPS" << std::endl;
+
+        for (size_t i = 0; i < n * n; i += 97) {
+            EXPECT_NEAR(c_serial[i], c_naive[i], 1e-3f * n);
+            EXPECT_NEAR(c_parallel[i], c_naive[i], 1e-3f * n);
+        }
+    }
+}
+
+TEST_F(ComputeBenchmark, FftThroughput) {
+    // Пакет из 64 вещественных сигналов телеметрии на длину; 5*n*log2(n)/2 — оценка
+    // флопов вещественного БПФ
+    const size_t count = 64;
+    for (size_t n : {256, 1000, 1024, 4096, 1 << 16}) {
+        auto plan = core_fft_plan_create(CORE_FFT_R2C, n);
+        ASSERT_NE(plan, nullptr);
+        auto signals = random_vector(count * n);
+        std::vector<float> spectra(count * (n + 2)), restored(count * n);
+
+        double t_fwd = best_seconds(5, [&] {
+            core_fft_r2c_batch(plan, count, signals.data(), n, spectra.data(), n + 2);
+        });
+        double t_inv = best_seconds(5, [&] {
+            core_fft_c2r_batch(plan, count, spectra.data(), n + 2, restored.data(), n);
+        });
+        const double flops = count * 2.5 * n * std::log2(static_cast<double>(n));
+        std::cout << "R2C n=" << n << ": forward " << flops / t_fwd * 1e-9 << " GFLOPS, "
+                  << t_fwd / count * 1e6 << " us/transform; inverse " << flops / t_inv * 1e-9
+                  << " GFLOPS" << std::endl;
+
+        for (size_t i = 0; i < signals.size(); i += 101) EXPECT_NEAR(restored[i], signals[i], 1e-4f);
+        core_fft_plan_destroy(plan);
+    }
+}
+
+TEST_F(ComputeBenchmark, FilterMegapixels) {
+    const size_t width = 1920, height = 1080;
+    const double mpix = width * height * 1e-6;
+    auto image = random_vector(width * height);
+    std::vector<float> out(width * height);
+    const core_executor_t* pool = core_default_executor();
+
+    auto report = [&](const char* name, auto&& filter) {
+        double t_serial = best_seconds(3, [&] { filter(nullptr); });
+        double t_pool = best_seconds(3, [&] { filter(pool); });
+        std::cout << name << " 1080p: " << mpix / t_serial << " MP/s, x" << pool->num_threads << " "
+                  << mpix / t_pool << " MP/s" << std::endl;
+    };
+
+    report("gaussian sigma=2", [&](const core_executor_t* ex) {
+        core_filter_gaussian(image.data(), width, out.data(), width, width, height, 2.0f, ex);
+    });
+    report("bilateral sigma_s=2", [&](const core_executor_t* ex) {
+        core_filter_bilateral(image.data(), width, out.data(), width, width, height, 2.0f, 0.1f, ex);
+    });
+    report("median 3x3", [&](const core_executor_t* ex) {
+        core_filter_median(image.data(), width, out.data(), width, width, height, 3, ex);
+    });
+    report("median 7x7", [&](const core_executor_t* ex) {
+        core_filter_median(image.data(), width, out.data(), width, width, height, 7, ex);
+    });
+    report("median 21x21", [&](const core_executor_t* ex) {
+        core_filter_median(image.data(), width, out.data(), width, width, height, 21, ex);
+    });
+}
+
+TEST_F(ComputeBenchmark, MathThroughput) {
+    const size_t n = 1 << 20;
+    auto x = random_vector(n);
+    std::vector<float> positive(n), out(n);
+    for (size_t i = 0; i < n; ++i) positive[i] = std::fabs(x[i]) * 100.0f + 1e-3f;
+
+    auto report = [&](const char* name, const std::vector<float>& in, void (*vec)(float*, const float*, size_t),
+                      float (*libm)(float)) {
+        double t_libm = best_seconds(3, [&] {
+            for (size_t i = 0; i < n; ++i) out[i] = libm(in[i]);
+        });
+        double t_vec = best_seconds(5, [&] { vec(out.data(), in.data(), n); });
+        std::cout << name << ": libm " << n / t_libm * 1e-6 << " Melem/s, vector " << n / t_vec * 1e-6
+                  << " Melem/s (x" << t_libm / t_vec << ")" << std::endl;
+    };
+
+    report("sin", x, core_vector_sin, [](float v) { return std::sin(v); });
+    report("cos", x, core_vector_cos, [](float v) { return std::cos(v); });
+    report("exp", x, core_vector_exp, [](float v) { return std::exp(v); });
+    report("log", positive, core_vector_log, [](float v) { return std::log(v); });
+    report("tanh", x, core_vector_tanh, [](float v) { return std::tanh(v); });
+    report("sigmoid", x, core_vector_sigmoid, [](float v) { return 1.0f / (1.0f + std::exp(-v)); });
+    report("rsqrt", positive, core_vector_rsqrt, [](float v) { return 1.0f / std::sqrt(v); });
+}
+
+TEST_F(ComputeBenchmark, ParallelScaling) {
+    auto& manager = compute::ComputeManager::getInstance();
+    const size_t savedThreads = manager.getThreadCount();
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts;
+    for (size_t t = 1; t < cores; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(cores);
+
+    const size_t n = 1 << 24, taps = 33;
+    auto a = random_vector(n), b = random_vector(n), kernel = random_vector(taps);
+    std::vector<float> conv(n - taps + 1);
+    const double gb = n * sizeof(float) * 1e-9;
+
+    double base[3] = {0.0, 0.0, 0.0};
+    for (size_t threads : threadCounts) {
+        manager.setThreadCount(threads);
+        float sum = 0.0f, dot = 0.0f;
+        double t_sum = best_seconds(5, [&] {
+            sum = manager.parallelReduceRange(0, n, 0.0f, [&](size_t lo, size_t hi, float acc) {
+                return acc + core_vector_sum_f32(a.data() + lo, hi - lo);
+            }, std::plus<float>());
+        });
+        double t_dot = best_seconds(5, [&] {
+            dot = manager.parallelReduceRange(0, n, 0.0f, [&](size_t lo, size_t hi, float acc) {
+                return acc + manager.dotProduct(a.data() + lo, b.data() + lo, hi - lo);
+            }, std::plus<float>());
+        });
+        // Явная гранула: выходной кусок и его окно входа остаются в L2 на все отводы
+        double t_conv = best_seconds(3, [&] {
+            manager.parallelForRange(0, conv.size(), [&](size_t lo, size_t hi) {
+                std::fill(conv.begin() + lo, conv.begin() + hi, 0.0f);
+                for (size_t j = 0; j < taps; ++j) {
+                    const float w = kernel[j];
+                    for (size_t i = lo; i < hi; ++i) conv[i] += a[i + j] * w;
+                }
+            }, 16384);
+        });
+        if (threads == 1) {
+            base[0] = t_sum;
+            base[1] = t_dot;
+            base[2] = t_conv;
+        }
+        std::cout << "threads=" << threads << ": sum " << gb / t_sum << " GB/s (x" << base[0] / t_sum
+                  << "), dot " << 2 * gb / t_dot << " GB/s (x" << base[1] / t_dot << "), conv" << taps << " "
+                  << n * taps * 2e-9 / t_conv << " GFLOPS (x" << base[2] / t_conv << ")" << std::endl;
+        EXPECT_TRUE(std::isfinite(sum) && std::isfinite(dot));
+    }
+    manager.setThreadCount(savedThreads);
+}
+
+TEST_F(ComputeBenchmark, FusedExpressions) {
+    using namespace compute::expr;
+    auto& manager = compute::ComputeManager::getInstance();
+    const size_t n = 1 << 22;
+    auto a = random_vector(n), b = random_vector(n), c = random_vector(n);
+    std::vector<float> tmp(n), out(n);
+    // Через volatile, иначе компилятор выбрасывает повторы чистого выражения
+    const float* volatile pa = a.data();
+    const float* volatile pb = b.data();
+    const float* volatile pc = c.data();
+
+    // sum(a * b + c): три прохода с временным массивом против одного
+    volatile float chained = 0.0f, fused = 0.0f;
+    double t_chained = best_seconds(5, [&] {
+        manager.multiply(tmp.data(), a.data(), b.data(), n);
+        manager.add(tmp.data(), tmp.data(), c.data(), n);
+        chained = manager.sum(tmp.data(), n);
+    });
+    double t_fused = best_seconds(5, [&] { fused = sum(vec(pa, n) * vec(pb, n) + vec(pc, n)); });
+    double t_parallel = best_seconds(5, [&] { fused = manager.sum(vec(pa, n) * vec(pb, n) + vec(pc, n)); });
+
+    // out = max(a - b, 0) * c
+    double t_map_chained = best_seconds(5, [&] {
+        manager.subtract(out.data(), a.data(), b.data(), n);
+        for (size_t i = 0; i < n; ++i) out[i] = std::max(out[i], 0.0f);
+        manager.multiply(out.data(), out.data(), c.data(), n);
+    });
+    double t_map_fused = best_seconds(5, [&] { evaluate(out.data(), max(vec(pa, n) - vec(pb, n), 0.0f) * vec(pc, n)); });
+
+    std::cout << "sum(a*b+c): chained " << t_chained * 1e3 << " ms, fused " << t_fused * 1e3
+              << " ms (x" << t_chained / t_fused << "), fused parallel " << t_parallel * 1e3 << " ms" << std::endl;
+    std::cout << "max(a-b,0)*c: chained " << t_map_chained * 1e3 << " ms, fused " << t_map_fused * 1e3
+              << " ms (x" << t_map_chained / t_map_fused << ")" << std::endl;
+    EXPECT_NEAR(chained, fused, 1e-3f * std::fabs(static_cast<float>(chained)) + 1.0f);
+}
+
+TEST_F(ComputeBenchmark, SmallKernelCallOverhead) {
+    auto& manager = compute::ComputeManager::getInstance();
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    const size_t calls = 1 << 20, n = 64;
+    manager.resetStats();
+
+    // Малые ядра из нескольких потоков: счётчики статистики не должны делить кэш-линии
+    for (size_t threads : {size_t{1}, cores}) {
+        std::vector<std::thread> workers;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                auto a = random_vector(n), b = random_vector(n);
+                std::vector<float> out(n);
+                for (size_t i = 0; i < calls; ++i) manager.add(out.data(), a.data(), b.data(), n);
+            });
+        }
+        for (auto& w : workers) w.join();
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        std::cout << "threads=" << threads << ": add(" << n << ") " << seconds * 1e9 / calls << " ns/call" << std::endl;
+    }
+    // Каждый вызов add учитывает n элементов; ни одно обновление не теряется
+#ifndef COMPUTE_DISABLE_STATS
+    EXPECT_EQ(manager.getStats().totalOperations, calls * n * (1 + cores));
+#else
+    EXPECT_EQ(manager.getStats().totalOperations, 0u);
+#endif
+}
+
+TEST_F(ComputeBenchmark, QuantizedDot) {
+    auto& manager = compute::ComputeManager::getInstance();
+    const size_t n = 1 << 16;
+    auto x = random_vector(n), y = random_vector(n);
+    std::vector<int8_t> qx(n), qy(n);
+    std::vector<core_bf16_t> hx(n), hy(n);
+    core_vector_quantize_i8(qx.data(), x.data(), n, 1.0f / 127.0f);
+    core_vector_quantize_i8(qy.data(), y.data(), n, 1.0f / 127.0f);
+    core_vector_f32_to_bf16(hx.data(), x.data(), n);
+    core_vector_f32_to_bf16(hy.data(), y.data(), n);
+
+    // Данные в L2: сравниваем пропускную способность ядер, а не памяти
+    const int reps = 200;
+    volatile float f32 = 0.0f, bf16 = 0.0f;
+    volatile int32_t i8 = 0;
+    double t_f32 = best_seconds(5, [&] { for (int r = 0; r < reps; ++r) f32 = manager.dotProduct(x.data(), y.data(), n); });
+    double t_i8 = best_seconds(5, [&] { for (int r = 0; r < reps; ++r) i8 = core_vector_dot_i8(qx.data(), qy.data(), n); });
+    double t_bf16 = best_seconds(5, [&] { for (int r = 0; r < reps; ++r) bf16 = core_vector_dot_bf16(hx.data(), hy.data(), n); });
+
+    auto gops = [&](double t) { return 2.0 * n * reps / t * 1e-9; };
+    std::cout << "dot " << n << ": f32 " << gops(t_f32) << " GOPS, int8 " << gops(t_i8)
+              << " GOPS (x" << t_f32 / t_i8 << "), bf16 " << gops(t_bf16) << " GOPS (x"
+              << t_f32 / t_bf16 << ")" << std::endl;
+    EXPECT_NEAR(i8 / (127.0f * 127.0f), f32, 0.01f * std::sqrt(static_cast<float>(n)) + 1.0f);
+    EXPECT_NEAR(bf16, f32, 0.02f * std::fabs(static_cast<float>(f32)) + 1.0f);
+}
+
+TEST_F(ComputeBenchmark, ConvolutionAlgorithms) {
+    struct Shape { const char* name; size_t w, h, kw, kh, in, out; };
+    const Shape shapes[] = {
+        {"1d k=7", 1 << 20, 1, 7, 1, 1, 1},
+        {"1d k=63", 1 << 18, 1, 63, 1, 1, 1},
+        {"1d k=255", 1 << 18, 1, 255, 1, 1, 1},
+        {"1d k=2047", 1 << 18, 1, 2047, 1, 1, 1},
+        {"2d 3x3", 1024, 1024, 3, 3, 1, 1},
+        {"2d 3x3 16->16", 128, 128, 3, 3, 16, 16},
+        {"2d 3x3 64->64", 58, 58, 3, 3, 64, 64},
+        {"2d 15x15", 512, 512, 15, 15, 1, 1},
+        {"2d 63x63", 512, 512, 63, 63, 1, 1},
+    };
+    const char* names[] = {"auto", "direct", "winograd", "fft"};
+    for (const Shape& s : shapes) {
+        auto in = random_vector(s.in * s.w * s.h), kernels = random_vector(s.out * s.in * s.kw * s.kh);
+        std::vector<float> out(s.out * (s.w - s.kw + 1) * (s.h - s.kh + 1));
+        std::cout << s.name << ":";
+        double best = 1e30;
+        int fastest = 0;
+        for (int algorithm : {CORE_CONV_DIRECT, CORE_CONV_WINOGRAD, CORE_CONV_FFT}) {
+            if (algorithm == CORE_CONV_WINOGRAD && (s.kw != 3 || s.kh != 3)) continue;
+            double t = best_seconds(3, [&] {
+                ASSERT_EQ(core_conv2d_f32_multi(in.data(), s.in, s.w, s.h, kernels.data(), s.kw, s.kh,
+                                                out.data(), s.out, algorithm, nullptr), 0);
+            });
+            std::cout << " " << names[algorithm] << " " << t * 1e3 << " ms";
+            if (t < best) {
+                best = t;
+                fastest = algorithm;
+            }
+        }
+        int selected = core_conv_select(s.w, s.h, s.kw, s.kh, s.in, s.out);
+        std::cout << "; selected " << names[selected] << ", fastest " << names[fastest] << std::endl;
+    }
+}